@@ -55,9 +55,17 @@ TaskCollection BurgersDriver::MakeTaskCollection(BlockList_t &blocks, const int
   TaskCollection tc;
   TaskID none(0);
 
-  const Real beta = integrator->beta[stage - 1];
-  const Real dt = integrator->dt;
+  // Methods in 2N form update base in place and keep du in a container of its own,
+  // while the 2S methods go through a container per stage
+  using parthenon::LowStorageIntegrator;
+  const bool two_n = (integrator->storage == LowStorageIntegrator::Storage::two_n);
+  const Real beta = (two_n ? 0.0 : integrator->beta[stage - 1]);
+  // dt is read when the tasks execute (rather than when they are added) so that the
+  // task collection can be cached and replayed in later cycles
+  const Real &dt = integrator->dt;
   const auto &stage_name = integrator->stage_name;
+  const std::string stage_in = (two_n ? "base" : stage_name[stage - 1]);
+  const std::string stage_out = (two_n ? "base" : stage_name[stage]);
 
   // first make other useful containers
   if (stage == 1) {
@@ -66,8 +74,12 @@ TaskCollection BurgersDriver::MakeTaskCollection(BlockList_t &blocks, const int
       // first make other useful containers
       auto &base = pmb->meshblock_data.Get();
       pmb->meshblock_data.Add("dUdt", base);
-      for (int s = 1; s < integrator->nstages; s++)
-        pmb->meshblock_data.Add(stage_name[s], base);
+      if (two_n) {
+        pmb->meshblock_data.Add("dU", base);
+      } else {
+        for (int s = 1; s < integrator->nstages; s++)
+          pmb->meshblock_data.Add(stage_name[s], base);
+      }
     }
   }
 
@@ -79,36 +91,45 @@ TaskCollection BurgersDriver::MakeTaskCollection(BlockList_t &blocks, const int
   for (int i = 0; i < num_partitions; i++) {
     auto &tl = single_tasklist_per_pack_region2[i];
     auto &mbase = pmesh->mesh_data.GetOrAdd("base", i);
-    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
-    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_in, i);
+    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_out, i);
     auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
 
     const auto any = parthenon::BoundaryType::any;
 
     auto start_bnd = tl.AddTask(none, parthenon::StartReceiveBoundBufs<any>, mc1);
-    auto start_flx_recv = tl.AddTask(none, parthenon::StartReceiveFluxCorrections, mc0);
 
     // this is the main task where most of the real work is done
     auto flx = tl.AddTask(none, burgers_package::CalculateFluxes, mc0.get());
 
-    auto send_flx = tl.AddTask(flx, parthenon::LoadAndSendFluxCorrections, mc0);
-    auto recv_flx = tl.AddTask(start_flx_recv, parthenon::ReceiveFluxCorrections, mc0);
-    auto set_flx = tl.AddTask(recv_flx, parthenon::SetFluxCorrections, mc0);
+    auto set_flx = parthenon::AddFluxCorrectionTasks(flx, tl, mc0);
 
     // compute the divergence of fluxes of conserved variables
     auto flux_div =
         tl.AddTask(set_flx, FluxDivergence<MeshData<Real>>, mc0.get(), mdudt.get());
 
-    auto avg_data = tl.AddTask(flux_div, AverageIndependentData<MeshData<Real>>,
-                               mc0.get(), mbase.get(), beta);
-    // apply du/dt to all independent fields in the container
-    auto update = tl.AddTask(avg_data, UpdateIndependentData<MeshData<Real>>, mc0.get(),
-                             mdudt.get(), beta * dt, mc1.get());
+    TaskID update;
+    if (two_n) {
+      auto &mdu = pmesh->mesh_data.GetOrAdd("dU", i);
+      update = tl.AddTask(flux_div, [=, &dt, pint = integrator.get()]() {
+        return Update2NIndependent<MeshData<Real>>(mc0.get(), mdu.get(), mdudt.get(),
+                                                   pint, dt, stage);
+      });
+    } else {
+      auto avg_data = tl.AddTask(flux_div, AverageIndependentData<MeshData<Real>>,
+                                 mc0.get(), mbase.get(), beta);
+      // apply du/dt to all independent fields in the container
+      update = tl.AddTask(avg_data, [=, &dt]() {
+        return UpdateIndependentData<MeshData<Real>>(mc0.get(), mdudt.get(), beta * dt,
+                                                     mc1.get());
+      });
+    }
 
     // do boundary exchange
     const auto local = parthenon::BoundaryType::local;
     const auto nonlocal = parthenon::BoundaryType::nonlocal;
-    auto send = tl.AddTask(update, parthenon::SendBoundBufs<nonlocal>, mc1);
+    auto send = tl.AddTask(TaskQualifier::priority, update,
+                           parthenon::SendBoundBufs<nonlocal>, mc1);
 
     auto send_local = tl.AddTask(update, parthenon::SendBoundBufs<local>, mc1);
     auto recv_local = tl.AddTask(update, parthenon::ReceiveBoundBufs<local>, mc1);
@@ -131,7 +152,7 @@ TaskCollection BurgersDriver::MakeTaskCollection(BlockList_t &blocks, const int
   for (int i = 0; i < blocks.size(); i++) {
     auto &pmb = blocks[i];
     auto &tl = async_region2[i];
-    auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
+    auto &sc1 = pmb->meshblock_data.Get(stage_out);
 
     // set physical boundaries
     auto set_bc = tl.AddTask(none, parthenon::ApplyBoundaryConditions, sc1);
@@ -23,6 +23,8 @@
 #include "kokkos_abstraction.hpp"
 #include "parthenon/package.hpp"
 #include "reconstruct/dc_inline.hpp"
+#include "reconstruct/ppm_inline.hpp"
+#include "reconstruct/wenoz_inline.hpp"
 #include "utils/error_checking.hpp"
 
 #include "burgers_package.hpp"
@@ -48,11 +50,15 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
 
   std::string recon_string = pin->GetOrAddString("burgers", "recon", "weno5");
   recon::ReconType recon_type;
-  if (recon_string == "weno5") {
-    recon_type = recon::ReconType::WENO5;
+  if (recon_string == "weno5" || recon_string == "weno5z" || recon_string == "ppm") {
+    // weno5z and ppm use the kernels of the reconstruct library
+    recon_type = (recon_string == "weno5")    ? recon::ReconType::WENO5
+                 : (recon_string == "weno5z") ? recon::ReconType::WENO5Z
+                                              : recon::ReconType::PPM;
     int nghost = pin->GetInteger("parthenon/mesh", "nghost");
-    PARTHENON_REQUIRE_THROWS(nghost >= 4, "weno5 reconstruction requires 4 or more ghost "
-                                          "cells.  Set <parthenon/mesh>/nghost = 4");
+    PARTHENON_REQUIRE_THROWS(nghost >= 4, recon_string +
+                                              " reconstruction requires 4 or more ghost "
+                                              "cells.  Set <parthenon/mesh>/nghost = 4");
   } else if (recon_string == "linear") {
     recon_type = recon::ReconType::Linear;
     int nghost = pin->GetInteger("parthenon/mesh", "nghost");
@@ -62,7 +68,8 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   } else {
     std::string msg =
         recon_string +
-        " is an invalid option for <burgers>/recon.  Valid options are weno5 and linear.";
+        " is an invalid option for <burgers>/recon.  Valid options are weno5, weno5z, "
+        "ppm and linear.";
     PARTHENON_THROW(msg);
   }
   pkg->AddParam("recon_type", recon_type);
@@ -123,17 +130,22 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   auto HstSum = parthenon::UserHistoryOperation::sum;
   using parthenon::HistoryOutputVar;
   parthenon::HstVar_list hst_vars = {};
-  int i_octant = 0;
-  for (auto &octant : octants) {
-    auto ReduceMass = [=](MeshData<Real> *md) {
-      return MassHistory(md, octant.xmin[0], octant.xmax[0], octant.xmin[1],
-                         octant.xmax[1], octant.xmin[2], octant.xmax[2]);
-    };
-    hst_vars.emplace_back(HstSum, ReduceMass, "MS Mass " + std::to_string(i_octant));
-    i_octant++;
+  // the masses of all octants are computed by a single reduction
+  std::vector<std::string> mass_labels;
+  for (int i_octant = 0; i_octant < octants.size(); ++i_octant) {
+    mass_labels.push_back("MS Mass " + std::to_string(i_octant));
   }
+  auto ReduceMass = [=](MeshData<Real> *md) { return MassHistory(md, octants); };
+  parthenon::HstVec_list hst_vecs = {
+      parthenon::HistoryOutputVec(HstSum, ReduceMass, mass_labels)};
   hst_vars.emplace_back(HstSum, MeshCountHistory, "Meshblock count");
   pkg->AddParam(parthenon::hist_param_key, hst_vars);
+  pkg->AddParam(parthenon::hist_vec_param_key, hst_vecs);
+  // the extrema of U1 are accumulated by the timestep estimate, which reads U anyway
+  auto diag = std::make_shared<parthenon::InlineDiagnostics>();
+  pkg->AddParam("max_u1", diag->AddMax("max U1"));
+  pkg->AddParam("min_u1", diag->AddMin("min U1"));
+  pkg->AddParam(parthenon::inline_diag_param_key, diag);
 
   pkg->EstimateTimestepMesh = EstimateTimestepMesh;
   pkg->FillDerivedMesh = CalculateDerived;
@@ -177,6 +189,11 @@ Real EstimateTimestepMesh(MeshData<Real> *md) {
 
   auto &params = pm->packages.Get("burgers_package")->AllParams();
   const auto &cfl = params.Get<Real>("cfl");
+  auto acc = params.Get<std::shared_ptr<parthenon::InlineDiagnostics>>(
+                       parthenon::inline_diag_param_key)
+                 ->GetAccumulator();
+  const auto max_u1 = params.Get<parthenon::InlineStat>("max_u1");
+  const auto min_u1 = params.Get<parthenon::InlineStat>("min_u1");
 
   std::vector<std::string> vars({"U"});
   auto &v = md->PackVariables(vars);
@@ -188,6 +205,8 @@ Real EstimateTimestepMesh(MeshData<Real> *md) {
       md->NumBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &ldt) {
         auto &coords = v.GetCoords(b);
+        acc.Max(max_u1, v(b, 0, k, j, i));
+        acc.Min(min_u1, v(b, 0, k, j, i));
         ldt = std::min(
             ldt,
             1.0 /
@@ -242,13 +261,25 @@ TaskStatus CalculateFluxes(MeshData<Real> *md) {
         bool yrec = (k >= kb.s && k <= kb.e) && (ndim > 1);
         bool zrec = (j >= jb.s && j <= jb.e) && (ndim > 2);
 
-        if (recon_type == recon::ReconType::WENO5) {
+        if (recon_type != recon::ReconType::Linear) {
           auto recon_loop = [&](const int s, const int e, Real *m2, Real *m1, Real *c,
                                 Real *p1, Real *p2, Real *l, Real *r) {
-            parthenon::par_for_inner(
-                DEFAULT_INNER_LOOP_PATTERN, member, s, e, [=](const int i) {
-                  recon::WENO5Z(m2[i], m1[i], c[i], p1[i], p2[i], l[i], r[i]);
-                });
+            if (recon_type == recon::ReconType::WENO5) {
+              parthenon::par_for_inner(
+                  DEFAULT_INNER_LOOP_PATTERN, member, s, e, [=](const int i) {
+                    recon::WENO5Z(m2[i], m1[i], c[i], p1[i], p2[i], l[i], r[i]);
+                  });
+            } else if (recon_type == recon::ReconType::WENO5Z) {
+              parthenon::par_for_inner(
+                  DEFAULT_INNER_LOOP_PATTERN, member, s, e, [=](const int i) {
+                    parthenon::WENO5Z(m2[i], m1[i], c[i], p1[i], p2[i], r[i], l[i]);
+                  });
+            } else {
+              parthenon::par_for_inner(
+                  DEFAULT_INNER_LOOP_PATTERN, member, s, e, [=](const int i) {
+                    parthenon::PPM(m2[i], m1[i], c[i], p1[i], p2[i], r[i], l[i]);
+                  });
+            }
           };
 
           for (int n = iu_lo; n <= iu_hi; n++) {
@@ -404,8 +435,7 @@ TaskStatus CalculateFluxes(MeshData<Real> *md) {
   return TaskStatus::complete;
 }
 
-Real MassHistory(MeshData<Real> *md, const Real x1min, const Real x1max, const Real x2min,
-                 const Real x2max, const Real x3min, const Real x3max) {
+std::vector<Real> MassHistory(MeshData<Real> *md, const std::vector<Region> &regions) {
   const auto ib = md->GetBoundsI(IndexDomain::interior);
   const auto jb = md->GetBoundsJ(IndexDomain::interior);
   const auto kb = md->GetBoundsK(IndexDomain::interior);
@@ -417,26 +447,41 @@ Real MassHistory(MeshData<Real> *md, const Real x1min, const Real x1max, const R
   std::vector<std::string> vars = {"U"};
   const auto pack = md->PackVariables(vars);
 
-  Real result = 0.0;
+  PARTHENON_REQUIRE_THROWS(regions.size() <= RegionMasses::max_regions,
+                           "Too many regions for MassHistory");
+  const int nregions = regions.size();
+  RegionBounds bounds;
+  for (int r = 0; r < nregions; ++r) {
+    for (int d = 0; d < 3; ++d) {
+      bounds.xmin[r][d] = regions[r].xmin[d];
+      bounds.xmax[r][d] = regions[r].xmax[d];
+    }
+  }
+
+  RegionMasses result;
   parthenon::par_reduce(
       parthenon::LoopPatternMDRange(), "MassHistory", DevExecSpace(), 0,
       pack.GetDim(5) - 1, 0, pack.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int v, const int k, const int j, const int i,
-                    Real &lresult) {
+                    RegionMasses &lresult) {
         const auto &coords = pack.GetCoords(b);
         const Real vol = coords.CellVolume(k, j, i);
         const Real weight = vol / (mesh_vol + 1e-20);
-        const Real x1 = coords.Xc<X1DIR>(k, j, i);
-        const Real x2 = coords.Xc<X2DIR>(k, j, i);
-        const Real x3 = coords.Xc<X3DIR>(k, j, i);
-        // Inclusive bounds are appropriate here because cell-centered
-        // coordinates are passed in, not edges.
-        const Real mask = (x1min <= x1) && (x1 <= x1max) && (x2min <= x2) &&
-                          (x2 <= x2max) && (x3min <= x3) && (x3 <= x3max);
-        lresult += mask * pack(b, v, k, j, i) * pack(b, v, k, j, i) * weight;
+        const Real x[3] = {coords.Xc<X1DIR>(k, j, i), coords.Xc<X2DIR>(k, j, i),
+                           coords.Xc<X3DIR>(k, j, i)};
+        const Real mass = pack(b, v, k, j, i) * pack(b, v, k, j, i) * weight;
+        for (int r = 0; r < nregions; ++r) {
+          // Inclusive bounds are appropriate here because cell-centered
+          // coordinates are passed in, not edges.
+          bool mask = true;
+          for (int d = 0; d < 3; ++d) {
+            mask = mask && (bounds.xmin[r][d] <= x[d]) && (x[d] <= bounds.xmax[r][d]);
+          }
+          lresult.mass[r] += mask * mass;
+        }
       },
-      Kokkos::Sum<Real>(result));
-  return result;
+      Kokkos::Sum<RegionMasses>(result));
+  return std::vector<Real>(result.mass, result.mass + nregions);
 }
 
 Real MeshCountHistory(MeshData<Real> *md) { return md->NumBlocks(); }
@@ -14,7 +14,9 @@
 #define BENCHMARKS_BURGERS_BURGERS_PACKAGE_HPP_
 
 #include <algorithm>
+#include <array>
 #include <memory>
+#include <vector>
 
 #include <parthenon/package.hpp>
 
@@ -25,8 +27,6 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin);
 void CalculateDerived(MeshData<Real> *md);
 Real EstimateTimestepMesh(MeshData<Real> *md);
 TaskStatus CalculateFluxes(MeshData<Real> *md);
-Real MassHistory(MeshData<Real> *md, const Real x1min, const Real x1max, const Real x2min,
-                 const Real x2max, const Real x3min, const Real x3max);
 Real MeshCountHistory(MeshData<Real> *md);
 
 // compute the hll flux for Burgers' equation
@@ -50,6 +50,39 @@ struct Region {
   std::array<Real, 3> xmin, xmax;
 };
 
+// The masses in up to max_regions regions, which MassHistory reduces at once
+struct RegionMasses {
+  static constexpr int max_regions = 8;
+  Real mass[max_regions];
+  KOKKOS_INLINE_FUNCTION RegionMasses() {
+    for (int r = 0; r < max_regions; ++r) {
+      mass[r] = 0.0;
+    }
+  }
+  KOKKOS_INLINE_FUNCTION RegionMasses &operator+=(const RegionMasses &other) {
+    for (int r = 0; r < max_regions; ++r) {
+      mass[r] += other.mass[r];
+    }
+    return *this;
+  }
+};
+
+// Region in a form that can be captured by kernels
+struct RegionBounds {
+  Real xmin[RegionMasses::max_regions][3], xmax[RegionMasses::max_regions][3];
+};
+
+std::vector<Real> MassHistory(MeshData<Real> *md, const std::vector<Region> &regions);
+
 } // namespace burgers_package
 
+namespace Kokkos {
+template <>
+struct reduction_identity<burgers_package::RegionMasses> {
+  KOKKOS_FORCEINLINE_FUNCTION static burgers_package::RegionMasses sum() {
+    return burgers_package::RegionMasses();
+  }
+};
+} // namespace Kokkos
+
 #endif // BENCHMARKS_BURGERS_BURGERS_PACKAGE_HPP_
@@ -0,0 +1,151 @@
+#!/usr/bin/env python
+# ========================================================================================
+# (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+#
+# This program was produced under U.S. Government contract 89233218CNA000001 for Los
+# Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+# for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+# in the program are reserved by Triad National Security, LLC, and the U.S. Department
+# of Energy/National Nuclear Security Administration. The Government is granted for
+# itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+# license in this material to reproduce, prepare derivative works, distribute copies to
+# the public, perform publicly and display publicly, and to permit others to do so.
+# ========================================================================================
+
+import itertools
+import json
+import os
+import shlex
+import subprocess
+import sys
+from argparse import ArgumentParser
+
+parser = ArgumentParser(
+    prog="scaling_study.py",
+    description="Sweep Parthenon-VIBE over ranks, block sizes, pack sizes and "
+    "refinement levels, and collect the per-phase timings of all runs in one json file",
+)
+parser.add_argument(
+    "preset", type=str, help="json file describing the sweep, see the scaling folder"
+)
+parser.add_argument(
+    "--exe",
+    action="append",
+    default=[],
+    metavar="LABEL=PATH",
+    help="burgers-benchmark executable to run, labeled e.g. by its backend. "
+    "May be given several times. Default: default=./burgers-benchmark",
+)
+parser.add_argument(
+    "--input",
+    type=str,
+    default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "burgers.pin"),
+    help="Input deck the preset's parameters are applied to",
+)
+parser.add_argument(
+    "--launcher",
+    type=str,
+    default="mpirun -n {ranks}",
+    help="Command prefix to launch a run, {ranks} is replaced by the number of ranks",
+)
+parser.add_argument(
+    "--rundir", type=str, default="scaling_runs", help="Directory the runs are made in"
+)
+parser.add_argument(
+    "-o", "--output", type=str, default="scaling.json", help="Combined report"
+)
+parser.add_argument(
+    "--dry-run", action="store_true", help="Only print the commands of the runs"
+)
+
+
+def as_list(val):
+    return val if isinstance(val, list) else [val]
+
+
+def mesh_size(preset, ranks):
+    """Base mesh of a run. Weak scaling doubles the mesh in x1, x2, x3 in turn for every
+    doubling of the ranks with respect to the first entry of ranks"""
+    mesh = list(preset["mesh"])
+    if preset.get("mode", "strong") == "weak":
+        factor, doublings = ranks // preset["ranks"][0], 0
+        if factor * preset["ranks"][0] != ranks or factor & (factor - 1):
+            sys.exit("weak scaling needs ranks that are powers of two times the first")
+        while factor > 1:
+            mesh[doublings % 3] *= 2
+            factor //= 2
+            doublings += 1
+    return mesh
+
+
+def runs(preset):
+    for ranks, block, pack_size, numlevel in itertools.product(
+        as_list(preset["ranks"]),
+        as_list(preset.get("meshblock", 16)),
+        as_list(preset.get("pack_size", -1)),
+        as_list(preset.get("numlevel", 1)),
+    ):
+        mesh = mesh_size(preset, ranks)
+        if any(n % block for n in mesh):
+            print(f"skipping {block}^3 blocks, they don't divide the {mesh} mesh")
+            continue
+        yield dict(
+            ranks=ranks,
+            mesh=mesh,
+            meshblock=block,
+            pack_size=pack_size,
+            numlevel=numlevel,
+        )
+
+
+def arguments(preset, run, report):
+    args = [f"parthenon/mesh/nx{d + 1}={n}" for d, n in enumerate(run["mesh"])]
+    args += [f"parthenon/meshblock/nx{d + 1}={run['meshblock']}" for d in range(3)]
+    args += [
+        f"parthenon/mesh/pack_size={run['pack_size']}",
+        f"parthenon/mesh/numlevel={run['numlevel']}",
+        f"parthenon/mesh/refinement={'adaptive' if run['numlevel'] > 1 else 'none'}",
+        f"parthenon/time/nlim={preset.get('nlim', 50)}",
+        f"parthenon/time/perf_cycle_offset={preset.get('perf_cycle_offset', 5)}",
+        f"parthenon/driver/phase_report={report}",
+    ]
+    return args + as_list(preset.get("parameters", []))
+
+
+if __name__ == "__main__":
+    args = parser.parse_args()
+    with open(args.preset) as f:
+        preset = json.load(f)
+    exes = [e.split("=", 1) for e in (args.exe or ["default=./burgers-benchmark"])]
+
+    results = []
+    for (label, exe), run in itertools.product(exes, list(runs(preset))):
+        name = "{}_r{}_b{}_p{}_l{}".format(
+            label, run["ranks"], run["meshblock"], run["pack_size"], run["numlevel"]
+        )
+        rundir = os.path.join(args.rundir, name)
+        cmd = shlex.split(args.launcher.format(ranks=run["ranks"]))
+        cmd += [os.path.abspath(exe), "-i", os.path.abspath(args.input)]
+        cmd += arguments(preset, run, "phase_report.json")
+        print(" ".join(cmd), flush=True)
+        if args.dry_run:
+            continue
+        os.makedirs(rundir, exist_ok=True)
+        with open(os.path.join(rundir, "stdout.txt"), "w") as log:
+            status = subprocess.run(
+                cmd, cwd=rundir, stdout=log, stderr=subprocess.STDOUT
+            )
+        run["backend"] = label
+        if status.returncode != 0:
+            print(f"  failed, see {os.path.join(rundir, 'stdout.txt')}")
+            run["failed"] = True
+        else:
+            with open(os.path.join(rundir, "phase_report.json")) as f:
+                run["report"] = json.load(f)
+            zcps = run["report"]["zone_cycles_per_wsec"]
+            print(f"  zone-cycles/wsec = {zcps:.3e}")
+        results.append(run)
+
+    if not args.dry_run:
+        with open(args.output, "w") as f:
+            json.dump(dict(preset=preset, runs=results), f, indent=2)
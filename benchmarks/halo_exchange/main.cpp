@@ -0,0 +1,214 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+// Halo exchange mini-app: sets up a mesh with a configurable number of FillGhost and
+// sparse fields and does nothing but exchange their ghost zones (and flux corrections,
+// on meshes with refinement), reporting the achieved bandwidth, the boundary buffer rate
+// and percentiles of the time per exchange.  See README.md.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "bvals/comms/bnd_info.hpp"
+#include "bvals/comms/bvals_in_one.hpp"
+#include "globals.hpp"
+#include "interface/metadata.hpp"
+#include "interface/state_descriptor.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/meshblock.hpp"
+#include "parameter_input.hpp"
+#include "parthenon_manager.hpp"
+#include "parthenon_mpi.hpp"
+#include "tasks/tasks.hpp"
+#include "utils/loop_utils.hpp"
+
+namespace halo_exchange {
+using parthenon::Mesh;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::MetadataFlag;
+using parthenon::Packages_t;
+using parthenon::ParameterInput;
+using parthenon::Real;
+
+parthenon::Packages_t ProcessPackages(std::unique_ptr<ParameterInput> &pin) {
+  auto pkg = std::make_shared<parthenon::StateDescriptor>("halo_exchange");
+  const int num_vars = pin->GetOrAddInteger("halo_exchange", "num_vars", 4);
+  const int num_sparse = pin->GetOrAddInteger("halo_exchange", "num_sparse", 0);
+  const int num_components = pin->GetOrAddInteger("halo_exchange", "num_components", 1);
+  pin->GetOrAddReal("halo_exchange", "sparse_fraction", 0.5);
+
+  std::vector<MetadataFlag> flags{Metadata::Cell, Metadata::Independent,
+                                  Metadata::FillGhost, Metadata::WithFluxes};
+  const std::vector<int> shape{num_components};
+  for (int n = 0; n < num_vars; ++n) {
+    pkg->AddField("dense_" + std::to_string(n), Metadata(flags, shape));
+  }
+  if (num_sparse > 0) {
+    flags.push_back(Metadata::Sparse);
+    std::vector<int> ids(num_sparse);
+    std::iota(ids.begin(), ids.end(), 0);
+    pkg->AddSparsePool("sparse", Metadata(flags, shape), ids);
+  }
+
+  Packages_t packages;
+  packages.Add(pkg);
+  return packages;
+}
+
+// Allocates the sparse fields on about sparse_fraction of the blocks and fills all
+// fields with non-zero values, so every boundary carries data
+void ProblemGenerator(MeshBlock *pmb, ParameterInput *pin) {
+  const int num_sparse = pin->GetInteger("halo_exchange", "num_sparse");
+  const Real sparse_fraction = pin->GetReal("halo_exchange", "sparse_fraction");
+  for (int id = 0; id < num_sparse; ++id) {
+    if ((pmb->gid * 37 + id * 11) % 100 < 100 * sparse_fraction) {
+      pmb->AllocSparseID("sparse", id);
+    }
+  }
+
+  const auto ib = pmb->cellbounds.GetBoundsI(parthenon::IndexDomain::entire);
+  const auto jb = pmb->cellbounds.GetBoundsJ(parthenon::IndexDomain::entire);
+  const auto kb = pmb->cellbounds.GetBoundsK(parthenon::IndexDomain::entire);
+  const Real val = 1.0 + pmb->gid;
+  for (auto &v : pmb->meshblock_data.Get()->GetVariableVector()) {
+    if (!v->IsAllocated()) continue;
+    auto data = v->data.Get<4>();
+    const int ncomp = data.GetDim(4);
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, 0, ncomp - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int c, const int k, const int j, const int i) {
+          data(c, k, j, i) = val + c;
+        });
+  }
+}
+
+// The number and total size of the boundary buffers this rank sends in one exchange
+void CountBuffers(Mesh *pmesh, std::int64_t &nbufs, std::int64_t &nbytes) {
+  nbufs = 0;
+  nbytes = 0;
+  for (int i = 0; i < pmesh->DefaultNumPartitions(); ++i) {
+    auto &md = pmesh->mesh_data.GetOrAdd("base", i);
+    parthenon::ForEachBoundary<parthenon::BoundaryType::any>(
+        md, [&](auto pmb, auto /*rc*/, auto &nb, const auto v) {
+          if (!v->IsAllocated()) return;
+          nbufs++;
+          nbytes += parthenon::GetBufferSize(pmb, nb, v) * sizeof(Real);
+        });
+  }
+}
+
+// One exchange of the ghost zones of all fields, with the flux corrections first
+parthenon::TaskCollection MakeExchange(Mesh *pmesh, const bool flux_correction) {
+  using parthenon::TaskID;
+  parthenon::TaskCollection tc;
+  const int num_partitions = pmesh->DefaultNumPartitions();
+  auto &region = tc.AddRegion(num_partitions);
+  for (int i = 0; i < num_partitions; ++i) {
+    auto &tl = region[i];
+    auto &md = pmesh->mesh_data.GetOrAdd("base", i);
+    TaskID dep(0);
+    if (flux_correction) dep = parthenon::AddFluxCorrectionTasks(dep, tl, md);
+    parthenon::AddBoundaryExchangeTasks(dep, tl, md, pmesh->multilevel);
+  }
+  return tc;
+}
+
+Real Percentile(const std::vector<Real> &sorted, const Real p) {
+  const int n = sorted.size();
+  return sorted[std::min(n - 1, static_cast<int>(p * n))];
+}
+
+void Run(ParameterInput *pin, Mesh *pmesh) {
+  const int num_warmup = pin->GetOrAddInteger("halo_exchange", "num_warmup", 10);
+  const int num_exchanges = pin->GetOrAddInteger("halo_exchange", "num_exchanges", 100);
+  const bool flux_correction =
+      pin->GetOrAddBoolean("halo_exchange", "flux_correction", true);
+  PARTHENON_REQUIRE_THROWS(num_exchanges > 0, "num_exchanges must be positive");
+
+  // sparse fields may get allocated on more blocks during the warm up, by receiving
+  // non-zero ghost zones
+  for (int n = 0; n < num_warmup; ++n) {
+    MakeExchange(pmesh, flux_correction).Execute();
+  }
+  Kokkos::fence();
+
+  std::vector<Real> times(num_exchanges);
+  for (int n = 0; n < num_exchanges; ++n) {
+    auto tc = MakeExchange(pmesh, flux_correction);
+#ifdef MPI_PARALLEL
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    Kokkos::Timer timer;
+    tc.Execute();
+    Kokkos::fence();
+    times[n] = timer.seconds();
+  }
+
+  std::int64_t counts[2];
+  CountBuffers(pmesh, counts[0], counts[1]);
+#ifdef MPI_PARALLEL
+  // an exchange takes as long as on the slowest rank
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, times.data(), num_exchanges,
+                                    MPI_PARTHENON_REAL, MPI_MAX, MPI_COMM_WORLD));
+  PARTHENON_MPI_CHECK(
+      MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD));
+#endif
+  if (parthenon::Globals::my_rank != 0) return;
+
+  std::sort(times.begin(), times.end());
+  const Real median = Percentile(times, 0.5);
+  std::printf("Halo exchange of %d blocks on %d ranks, %d exchanges\n",
+              pmesh->nbtotal, parthenon::Globals::nranks, num_exchanges);
+  std::printf("  boundary buffers per exchange: %lld (%.3f MB)\n",
+              static_cast<long long>(counts[0]), counts[1] / 1.0e6);
+  std::printf("  time per exchange [ms]: min %.4f median %.4f p90 %.4f p99 %.4f "
+              "max %.4f\n",
+              1e3 * times.front(), 1e3 * median, 1e3 * Percentile(times, 0.9),
+              1e3 * Percentile(times, 0.99), 1e3 * times.back());
+  std::printf("  bandwidth (median): %.3f GB/s\n", counts[1] / median / 1.0e9);
+  std::printf("  buffer rate (median): %.3e buffers/s\n", counts[0] / median);
+}
+
+} // namespace halo_exchange
+
+int main(int argc, char *argv[]) {
+  using parthenon::ParthenonManager;
+  using parthenon::ParthenonStatus;
+  ParthenonManager pman;
+
+  pman.app_input->ProcessPackages = halo_exchange::ProcessPackages;
+  pman.app_input->ProblemGenerator = halo_exchange::ProblemGenerator;
+
+  auto manager_status = pman.ParthenonInitEnv(argc, argv);
+  if (manager_status == ParthenonStatus::complete) {
+    pman.ParthenonFinalize();
+    return 0;
+  }
+  if (manager_status == ParthenonStatus::error) {
+    pman.ParthenonFinalize();
+    return 1;
+  }
+
+  pman.ParthenonInitPackagesAndMesh();
+  halo_exchange::Run(pman.pinput.get(), pman.pmesh.get());
+  pman.ParthenonFinalize();
+
+  return 0;
+}
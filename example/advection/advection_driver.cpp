@@ -11,6 +11,7 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "mesh/meshblock_pack.hpp"
 #include "parthenon/driver.hpp"
 #include "prolong_restrict/prolong_restrict.hpp"
+#include "utils/hash.hpp"
 
 using namespace parthenon::driver::prelude;
 
@@ -36,7 +38,8 @@ namespace advection_example {
 // function.                                       *//
 // *************************************************//
 AdvectionDriver::AdvectionDriver(ParameterInput *pin, ApplicationInput *app_in, Mesh *pm)
-    : MultiStageDriver(pin, app_in, pm) {
+    : MultiStageDriver(pin, app_in, pm),
+      kernel_graphs_(pin->GetOrAddBoolean("Advection", "kernel_graphs", false)) {
   // fail if these are not specified in the input file
   pin->CheckRequired("parthenon/mesh", "ix1_bc");
   pin->CheckRequired("parthenon/mesh", "ox1_bc");
@@ -58,9 +61,15 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
   TaskCollection tc;
   TaskID none(0);
 
-  const Real beta = integrator->beta[stage - 1];
+  // Methods in 2N form update base in place and keep du in a container of its own,
+  // while the 2S methods go through a container per stage
+  using parthenon::LowStorageIntegrator;
+  const bool two_n = (integrator->storage == LowStorageIntegrator::Storage::two_n);
+  const Real beta = (two_n ? 0.0 : integrator->beta[stage - 1]);
   const Real dt = integrator->dt;
   const auto &stage_name = integrator->stage_name;
+  const std::string stage_in = (two_n ? "base" : stage_name[stage - 1]);
+  const std::string stage_out = (two_n ? "base" : stage_name[stage]);
 
   // first make other useful containers
   if (stage == 1) {
@@ -69,25 +78,41 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
       // first make other useful containers
       auto &base = pmb->meshblock_data.Get();
       pmb->meshblock_data.Add("dUdt", base);
-      for (int s = 1; s < integrator->nstages; s++)
-        pmb->meshblock_data.Add(stage_name[s], base);
+      if (two_n) {
+        pmb->meshblock_data.Add("dU", base);
+      } else {
+        for (int s = 1; s < integrator->nstages; s++)
+          pmb->meshblock_data.Add(stage_name[s], base);
+      }
     }
   }
 
   const int num_partitions = pmesh->DefaultNumPartitions();
+  // look the stages up once instead of by label for every partition
+  auto &mesh_data = pmesh->mesh_data;
+  const auto base_stage = mesh_data.GetStageHandle("base");
+  const auto in_stage = mesh_data.GetStageHandle(stage_in);
+  const auto out_stage = mesh_data.GetStageHandle(stage_out);
+  const auto dudt_stage = mesh_data.GetStageHandle("dUdt");
+  const auto du_stage = mesh_data.GetStageHandle("dU");
+  const std::size_t num_graphs = num_partitions * integrator->nstages;
+  if (kernel_graphs_ && graphs_.size() != num_graphs) {
+    graphs_.clear();
+    for (std::size_t n = 0; n < num_graphs; ++n)
+      graphs_.push_back(std::make_unique<parthenon::KernelGraph>());
+  }
 
   // note that task within this region that contains one tasklist per pack
   // could still be executed in parallel
   TaskRegion &single_tasklist_per_pack_region2 = tc.AddRegion(num_partitions);
   for (int i = 0; i < num_partitions; i++) {
     auto &tl = single_tasklist_per_pack_region2[i];
-    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
-    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+    auto &mc0 = mesh_data.GetOrAdd(in_stage, i);
+    auto &mc1 = mesh_data.GetOrAdd(out_stage, i);
 
     const auto any = parthenon::BoundaryType::any;
 
     tl.AddTask(none, parthenon::StartReceiveBoundBufs<any>, mc1);
-    tl.AddTask(none, parthenon::StartReceiveFluxCorrections, mc0);
   }
 
   // Number of task lists that can be executed independently and thus *may*
@@ -103,15 +128,18 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
     auto &tl = async_region1[i];
 
     // pull out the container we'll use to get fluxes and/or compute RHSs
-    auto &sc0 = pmb->meshblock_data.Get(stage_name[stage - 1]);
+    auto &sc0 = pmb->meshblock_data.Get(stage_in);
     // pull out a container we'll use to store dU/dt.
     // This is just -flux_divergence in this example
     auto &dudt = pmb->meshblock_data.Get("dUdt");
     // pull out the container that will hold the updated state
     // effectively, sc1 = sc0 + dudt*dt
-    auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
+    auto &sc1 = pmb->meshblock_data.Get(stage_out);
 
     auto advect_flux = tl.AddTask(none, advection_package::CalculateFluxes, sc0);
+    // the fluxes are the bulk of the work on a block, unlike the lists of the
+    // partitions below that also wait for messages
+    if (pmesh->AutomaticLoadBalancing()) tl.SetCostMeter(pmb->MakeCostMeter());
   }
 
   // note that task within this region that contains one tasklist per pack
@@ -119,24 +147,52 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
   TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
   for (int i = 0; i < num_partitions; i++) {
     auto &tl = single_tasklist_per_pack_region[i];
-    auto &mbase = pmesh->mesh_data.GetOrAdd("base", i);
-    auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
-    auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
-    auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
-
-    auto send_flx = tl.AddTask(none, parthenon::LoadAndSendFluxCorrections, mc0);
-    auto recv_flx = tl.AddTask(none, parthenon::ReceiveFluxCorrections, mc0);
-    auto set_flx = tl.AddTask(recv_flx, parthenon::SetFluxCorrections, mc0);
-
-    // compute the divergence of fluxes of conserved variables
-    auto flux_div =
-        tl.AddTask(set_flx, FluxDivergence<MeshData<Real>>, mc0.get(), mdudt.get());
-
-    auto avg_data = tl.AddTask(flux_div, AverageIndependentData<MeshData<Real>>,
-                               mc0.get(), mbase.get(), beta);
-    // apply du/dt to all independent fields in the container
-    auto update = tl.AddTask(avg_data, UpdateIndependentData<MeshData<Real>>, mc0.get(),
-                             mdudt.get(), beta * dt, mc1.get());
+    auto &mbase = mesh_data.GetOrAdd(base_stage, i);
+    auto &mc0 = mesh_data.GetOrAdd(in_stage, i);
+    auto &mc1 = mesh_data.GetOrAdd(out_stage, i);
+    auto &mdudt = mesh_data.GetOrAdd(dudt_stage, i);
+
+    auto set_flx = parthenon::AddFluxCorrectionTasks(none, tl, mc0);
+
+    TaskID update;
+    if (kernel_graphs_) {
+      // The flux divergence and the update only launch kernels on the execution space
+      // of the partition, so after the first two cycles with the same mesh and dt they
+      // are replayed from a graph.  The packs they use are cached by then.
+      auto *graph = graphs_[(stage - 1) * num_partitions + i].get();
+      const std::uint64_t key = parthenon::impl::hash_combine(
+          parthenon::impl::hash_combine(pmesh->remesh_count, dt), beta);
+      auto mdu = two_n ? mesh_data.GetOrAdd(du_stage, i) : nullptr;
+      const auto *pint = integrator.get();
+      update = tl.AddTask(set_flx, [=]() {
+        graph->Launch(mc0->GetExecSpace(), key, [&]() {
+          FluxDivergence(mc0.get(), mdudt.get());
+          if (two_n) {
+            Update2NIndependent(mc0.get(), mdu.get(), mdudt.get(), pint, dt, stage);
+          } else {
+            AverageIndependentData(mc0.get(), mbase.get(), beta);
+            UpdateIndependentData(mc0.get(), mdudt.get(), beta * dt, mc1.get());
+          }
+        });
+        return TaskStatus::complete;
+      });
+    } else {
+      // compute the divergence of fluxes of conserved variables
+      auto flux_div =
+          tl.AddTask(set_flx, FluxDivergence<MeshData<Real>>, mc0.get(), mdudt.get());
+
+      if (two_n) {
+        auto &mdu = mesh_data.GetOrAdd(du_stage, i);
+        update = tl.AddTask(flux_div, Update2NIndependent<MeshData<Real>>, mc0.get(),
+                            mdu.get(), mdudt.get(), integrator.get(), dt, stage);
+      } else {
+        auto avg_data = tl.AddTask(flux_div, AverageIndependentData<MeshData<Real>>,
+                                   mc0.get(), mbase.get(), beta);
+        // apply du/dt to all independent fields in the container
+        update = tl.AddTask(avg_data, UpdateIndependentData<MeshData<Real>>, mc0.get(),
+                            mdudt.get(), beta * dt, mc1.get());
+      }
+    }
 
     // do boundary exchange
     parthenon::AddBoundaryExchangeTasks(update, tl, mc1, pmesh->multilevel);
@@ -147,7 +203,7 @@ TaskCollection AdvectionDriver::MakeTaskCollection(BlockList_t &blocks, const in
   for (int i = 0; i < blocks.size(); i++) {
     auto &pmb = blocks[i];
     auto &tl = async_region2[i];
-    auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
+    auto &sc1 = pmb->meshblock_data.Get(stage_out);
 
     // set physical boundaries
     auto set_bc = tl.AddTask(none, parthenon::ApplyBoundaryConditions, sc1);
@@ -20,6 +20,8 @@
 #include <parthenon/driver.hpp>
 #include <parthenon/package.hpp>
 
+#include "utils/kernel_graph.hpp"
+
 namespace advection_example {
 using namespace parthenon::driver::prelude;
 
@@ -34,6 +36,13 @@ class AdvectionDriver : public MultiStageDriver {
   //       DriverUtils::ConstructAndExecuteTaskLists (driver.hpp)
   //         AdvectionDriver::MakeTaskCollection (advection_driver.cpp)
   TaskCollection MakeTaskCollection(BlockList_t &blocks, int stage);
+
+ private:
+  // whether the kernels of the update of a partition in a stage are replayed from a
+  // graph, see Advection/kernel_graphs
+  const bool kernel_graphs_;
+  // the graphs of all partitions in stage 1, then stage 2, and so on
+  std::vector<std::unique_ptr<parthenon::KernelGraph>> graphs_;
 };
 
 void ProblemGenerator(MeshBlock *pmb, parthenon::ParameterInput *pin);
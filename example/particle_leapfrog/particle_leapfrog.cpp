@@ -62,6 +62,10 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   Real cfl = pin->GetOrAddReal("Particles", "cfl", 0.3);
   pkg->AddParam<>("cfl", cfl);
 
+  // exchange the particles of all blocks of a rank at once, see SendSwarmAggregated
+  bool aggregated_comm = pin->GetOrAddBoolean("Particles", "aggregated_comm", false);
+  pkg->AddParam<>("aggregated_comm", aggregated_comm);
+
   std::string swarm_name = "my_particles";
   Metadata swarm_metadata({Metadata::Provides, Metadata::None, Metadata::Independent});
   pkg->AddSwarm(swarm_name, swarm_metadata);
@@ -275,6 +279,10 @@ TaskCollection ParticleDriver::MakeParticlesUpdateTaskCollection() const {
 
   auto num_task_lists_executed_independently = blocks.size();
 
+  auto pkg = pmesh->packages.Get("particles_package");
+  const bool aggregated_comm = pkg->Param<bool>("aggregated_comm");
+  const std::string swarm_name = "my_particles";
+
   TaskRegion &sync_region0 = tc.AddRegion(1);
   {
     for (int i = 0; i < blocks.size(); i++) {
@@ -296,12 +304,21 @@ TaskCollection ParticleDriver::MakeParticlesUpdateTaskCollection() const {
     auto transport_particles =
         tl.AddTask(none, TransportParticles, pmb.get(), &integrator);
 
+    if (aggregated_comm) continue;
     auto send = tl.AddTask(transport_particles, &SwarmContainer::Send, sc.get(),
                            BoundaryCommSubset::all);
     auto receive =
         tl.AddTask(send, &SwarmContainer::Receive, sc.get(), BoundaryCommSubset::all);
   }
 
+  if (aggregated_comm) {
+    TaskRegion &sync_region1 = tc.AddRegion(1);
+    auto &tl = sync_region1[0];
+    auto md = pmesh->mesh_data.Get().get();
+    auto send = tl.AddTask(none, SendSwarmAggregated, md, swarm_name);
+    auto receive = tl.AddTask(send, ReceiveSwarmAggregated, md, swarm_name);
+  }
+
   return tc;
 }
 
@@ -408,6 +408,9 @@ TaskCollection ParticleDriver::MakeTaskCollection(BlockList_t &blocks, int stage
   TaskCollection tc;
   TaskID none(0);
 
+  PARTHENON_REQUIRE_THROWS(
+      integrator->storage == parthenon::LowStorageIntegrator::Storage::two_s,
+      "Only integrators in 2S form are supported");
   const Real beta = integrator->beta[stage - 1];
   const Real dt = integrator->dt;
   const auto &stage_name = integrator->stage_name;
@@ -45,8 +45,6 @@ void ProblemGenerator(MeshBlock *pmb, ParameterInput *pin) {
   // Don't do anything for now
 }
 
-enum class DepositionMethod { per_particle, per_cell };
-
 // *************************************************//
 // define the "physics" package particles_package, *//
 // which includes defining various functions that  *//
@@ -76,13 +74,25 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   std::string deposition_method =
       pin->GetOrAddString("Particles", "deposition_method", "per_particle");
   if (deposition_method == "per_particle") {
-    pkg->AddParam<>("deposition_method", DepositionMethod::per_particle);
+    pkg->AddParam<>("deposition_method", DepositionStrategy::atomic);
   } else if (deposition_method == "per_cell") {
-    pkg->AddParam<>("deposition_method", DepositionMethod::per_cell);
+    pkg->AddParam<>("deposition_method", DepositionStrategy::sorted);
   } else {
     PARTHENON_THROW("deposition method not recognized");
   }
 
+  std::string deposition_shape =
+      pin->GetOrAddString("Particles", "deposition_shape", "NGP");
+  if (deposition_shape == "NGP") {
+    pkg->AddParam<>("deposition_shape", DepositionShape::NGP);
+  } else if (deposition_shape == "CIC") {
+    pkg->AddParam<>("deposition_shape", DepositionShape::CIC);
+  } else if (deposition_shape == "TSC") {
+    pkg->AddParam<>("deposition_shape", DepositionShape::TSC);
+  } else {
+    PARTHENON_THROW("deposition shape not recognized");
+  }
+
   bool orbiting_particles =
       pin->GetOrAddBoolean("Particles", "orbiting_particles", false);
   pkg->AddParam<>("orbiting_particles", orbiting_particles);
@@ -161,8 +171,8 @@ TaskStatus DestroySomeParticles(MeshBlock *pmb) {
 
 TaskStatus SortParticlesIfUsingPerCellDeposition(MeshBlock *pmb) {
   auto pkg = pmb->packages.Get("particles_package");
-  const auto deposition_method = pkg->Param<DepositionMethod>("deposition_method");
-  if (deposition_method == DepositionMethod::per_cell) {
+  const auto deposition_method = pkg->Param<DepositionStrategy>("deposition_method");
+  if (deposition_method == DepositionStrategy::sorted) {
     auto swarm = pmb->swarm_data.Get()->Get("my_particles");
     swarm->SortParticlesByCell();
   }
@@ -176,66 +186,12 @@ TaskStatus DepositParticles(MeshBlock *pmb) {
   auto swarm = pmb->swarm_data.Get()->Get("my_particles");
 
   auto pkg = pmb->packages.Get("particles_package");
-  const auto deposition_method = pkg->Param<DepositionMethod>("deposition_method");
-
-  // Meshblock geometry
-  const IndexRange &ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
-  const IndexRange &jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
-  const IndexRange &kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
-  const Real &dx_i = pmb->coords.Dxf<1>(pmb->cellbounds.is(IndexDomain::interior));
-  const Real &dx_j = pmb->coords.Dxf<2>(pmb->cellbounds.js(IndexDomain::interior));
-  const Real &dx_k = pmb->coords.Dxf<3>(pmb->cellbounds.ks(IndexDomain::interior));
-  const Real &minx_i = pmb->coords.Xf<1>(ib.s);
-  const Real &minx_j = pmb->coords.Xf<2>(jb.s);
-  const Real &minx_k = pmb->coords.Xf<3>(kb.s);
-
-  const auto &x = swarm->Get<Real>("x").Get();
-  const auto &y = swarm->Get<Real>("y").Get();
-  const auto &z = swarm->Get<Real>("z").Get();
-  const auto &weight = swarm->Get<Real>("weight").Get();
-  auto swarm_d = swarm->GetDeviceContext();
+  const auto deposition_method = pkg->Param<DepositionStrategy>("deposition_method");
+  const auto deposition_shape = pkg->Param<DepositionShape>("deposition_shape");
 
   auto &particle_dep = pmb->meshblock_data.Get()->Get("particle_deposition").data;
-  const int ndim = pmb->pmy_mesh->ndim;
-
-  if (deposition_method == DepositionMethod::per_particle) {
-    // Reset particle count
-    pmb->par_for(
-        PARTHENON_AUTO_LABEL, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int k, const int j, const int i) {
-          particle_dep(k, j, i) = 0.;
-        });
-
-    pmb->par_for(
-        PARTHENON_AUTO_LABEL, 0, swarm->GetMaxActiveIndex(), KOKKOS_LAMBDA(const int n) {
-          if (swarm_d.IsActive(n)) {
-            int i = static_cast<int>(std::floor((x(n) - minx_i) / dx_i) + ib.s);
-            int j = 0;
-            if (ndim > 1) {
-              j = static_cast<int>(std::floor((y(n) - minx_j) / dx_j) + jb.s);
-            }
-            int k = 0;
-            if (ndim > 2) {
-              k = static_cast<int>(std::floor((z(n) - minx_k) / dx_k) + kb.s);
-            }
-
-            if (i >= ib.s && i <= ib.e && j >= jb.s && j <= jb.e && k >= kb.s &&
-                k <= kb.e) {
-              Kokkos::atomic_add(&particle_dep(k, j, i), weight(n));
-            }
-          }
-        });
-  } else if (deposition_method == DepositionMethod::per_cell) {
-    pmb->par_for(
-        PARTHENON_AUTO_LABEL, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int k, const int j, const int i) {
-          particle_dep(k, j, i) = 0.;
-          for (int n = 0; n < swarm_d.GetParticleCountPerCell(k, j, i); n++) {
-            const int idx = swarm_d.GetFullIndex(k, j, i, n);
-            particle_dep(k, j, i) += weight(idx);
-          }
-        });
-  }
+  parthenon::DepositParticles(swarm.get(), "weight", particle_dep, deposition_shape,
+                              deposition_method);
 
   return TaskStatus::complete;
 }
@@ -67,6 +67,10 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   pkg->AddParam<>("use_jacobi", use_jacobi);
   bool use_stencil = pin->GetOrAddBoolean("poisson", "use_stencil", true);
   pkg->AddParam<>("use_stencil", use_stencil);
+  // the stencil above with offsets and weights known at compile time
+  bool use_static_stencil = pin->GetOrAddBoolean("poisson", "use_static_stencil", false);
+  pkg->AddParam<>("use_static_stencil", use_static_stencil && use_stencil);
+  pkg->AddParam<>("stencil_scale", use_jacobi ? 1.0 : 1.0 / (2.0 * ndim));
   if (use_stencil) {
     std::vector<Real> wgts;
     if (use_jacobi) {
@@ -129,7 +133,7 @@ TaskStatus SetMatrixElements(T *u) {
   const int ndim = v.GetNdim();
   const Real w0 = -2.0 * ndim;
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, v.GetDim(5) - 1,
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, u->GetExecSpace(), 0, v.GetDim(5) - 1,
       kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
         for (int n = isp_lo; n <= isp_hi; n++) {
@@ -169,7 +173,7 @@ TaskStatus SumMass(T *u, Real *reduce_sum) {
 
   Real total;
   parthenon::par_reduce(
-      parthenon::loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, DevExecSpace(), 0,
+      parthenon::loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, u->GetExecSpace(), 0,
       v.GetDim(5) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &sum) {
         sum += v(b, irho, k, j, i) * std::pow(dx, ndim);
@@ -195,7 +199,7 @@ TaskStatus SumDeltaPhi(T *du, Real *reduce_sum) {
 
   Real total;
   parthenon::par_reduce(
-      parthenon::loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, DevExecSpace(), 0,
+      parthenon::loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, du->GetExecSpace(), 0,
       dv.GetDim(5) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &sum) {
         sum += std::pow(dv(b, iphi, k, j, i), 2);
@@ -205,6 +209,21 @@ TaskStatus SumDeltaPhi(T *du, Real *reduce_sum) {
   *reduce_sum += total;
   return TaskStatus::complete;
 }
+template <typename Stencil_t, typename PackType>
+void StencilJacobi(const DevExecSpace &exec_space, const Stencil_t &stencil,
+                   const PackType &v, const PackType &dv, const int irho, const int iphi,
+                   const int idphi, const Real dV, const IndexRange &ib,
+                   const IndexRange &jb, const IndexRange &kb) {
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, exec_space, 0, v.GetDim(5) - 1,
+      kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+        const Real rhs = dV * v(b, irho, k, j, i);
+        const Real phi_new = stencil.Jacobi(v, iphi, b, k, j, i, rhs);
+        dv(b, idphi, k, j, i) = phi_new - v(b, iphi, k, j, i);
+      });
+}
+
 template <typename T>
 TaskStatus UpdatePhi(T *u, T *du) {
   using Stencil_t = parthenon::solvers::Stencil<Real>;
@@ -238,27 +257,34 @@ TaskStatus UpdatePhi(T *u, T *du) {
                              "UpdatePhi requires that DX be equal in all directions.");
   }
   const Real dV = std::pow(dx, ndim);
+  const auto &exec_space = u->GetExecSpace();
 
   // Demonstrate the usage of the Stencil and SparseMatrixAccessor classes
   // which here represent the sparse matrix corresponding to a simple
   // second order finite difference discretization of the Poisson eq.
   StateDescriptor *pkg = pm->packages.Get("poisson_package").get();
-  if (isp_hi < 0) { // there is no sparse matrix, so we must be using the stencil
+  if (pkg->Param<bool>("use_static_stencil")) {
+    using parthenon::solvers::LaplacianStencil;
+    using parthenon::solvers::StaticStencil;
+    const Real scale = pkg->Param<Real>("stencil_scale");
+    if (ndim == 1) {
+      StencilJacobi(exec_space, StaticStencil<LaplacianStencil<1>>(scale), v, dv, irho,
+                    iphi, idphi, dV, ib, jb, kb);
+    } else if (ndim == 2) {
+      StencilJacobi(exec_space, StaticStencil<LaplacianStencil<2>>(scale), v, dv, irho,
+                    iphi, idphi, dV, ib, jb, kb);
+    } else {
+      StencilJacobi(exec_space, StaticStencil<LaplacianStencil<3>>(scale), v, dv, irho,
+                    iphi, idphi, dV, ib, jb, kb);
+    }
+  } else if (isp_hi < 0) { // there is no sparse matrix, so we must be using the stencil
     const auto &stencil = pkg->Param<Stencil_t>("stencil");
-    parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, v.GetDim(5) - 1,
-        kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
-          const Real rhs = dV * v(b, irho, k, j, i);
-          const Real phi_new = stencil.Jacobi(v, iphi, b, k, j, i, rhs);
-          dv(b, idphi, k, j, i) = phi_new - v(b, iphi, k, j, i);
-        });
-
+    StencilJacobi(exec_space, stencil, v, dv, irho, iphi, idphi, dV, ib, jb, kb);
   } else {
     const auto &sp_accessor =
         pkg->Param<parthenon::solvers::SparseMatrixAccessor>("sparse_accessor");
     parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, v.GetDim(5) - 1,
+        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, exec_space, 0, v.GetDim(5) - 1,
         kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
           const Real rhs = dV * v(b, irho, k, j, i);
@@ -269,7 +295,7 @@ TaskStatus UpdatePhi(T *u, T *du) {
   }
 
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, dv.GetDim(5) - 1,
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, exec_space, 0, dv.GetDim(5) - 1,
       kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
         v(b, iphi, k, j, i) += dv(b, idphi, k, j, i);
@@ -297,7 +323,7 @@ TaskStatus CheckConvergence(T *u, T *du) {
 
   Real max_err;
   parthenon::par_reduce(
-      parthenon::loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, DevExecSpace(), 0,
+      parthenon::loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, u->GetExecSpace(), 0,
       v.GetDim(5) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &eps) {
         Real reps = std::abs(dv(b, idphi, k, j, i) / v(b, iphi, k, j, i));
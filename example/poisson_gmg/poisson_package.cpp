@@ -104,6 +104,9 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   bool precondition = pin->GetOrAddBoolean("poisson", "precondition", true);
   pkg->AddParam<>("precondition", precondition);
 
+  bool pipelined = pin->GetOrAddBoolean("poisson", "pipelined", false);
+  pkg->AddParam<>("pipelined", pipelined);
+
   int precondition_vcycles = pin->GetOrAddInteger("poisson", "precondition_vcycles", 1);
   pkg->AddParam<>("precondition_vcycles", precondition_vcycles);
 
@@ -137,8 +140,15 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   parthenon::solvers::MGParams mg_params;
   mg_params.max_iters = max_poisson_iterations;
   mg_params.residual_tolerance = res_tol;
+  mg_params.convergence_check_interval =
+      pin->GetOrAddInteger("poisson", "convergence_check_interval", 1);
   mg_params.do_FAS = do_FAS;
   mg_params.smoother = smoother_method;
+  mg_params.chebyshev_degree = pin->GetOrAddInteger("poisson", "chebyshev_degree", 3);
+  mg_params.coarsest_iterations =
+      pin->GetOrAddInteger("poisson", "coarsest_iterations", 1);
+  const bool telemetry = pin->GetOrAddBoolean("poisson", "telemetry", false);
+  mg_params.telemetry = telemetry;
   parthenon::solvers::MGSolver<u, rhs, PoissonEquation> mg_solver(pkg.get(), mg_params,
                                                                   eq);
   pkg->AddParam<>("MGsolver", mg_solver, parthenon::Params::Mutability::Mutable);
@@ -147,11 +157,38 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin) {
   bicgstab_params.max_iters = max_poisson_iterations;
   bicgstab_params.residual_tolerance = res_tol;
   bicgstab_params.precondition = precondition;
+  bicgstab_params.pipelined = pipelined;
+  bicgstab_params.telemetry = telemetry;
+  if (pin->GetOrAddBoolean("poisson", "float32_preconditioner_comms", false)) {
+    bicgstab_params.mg_params.comm_encoding = parthenon::CommEncoding::float32;
+  }
   parthenon::solvers::BiCGSTABSolver<u, rhs, PoissonEquation> bicg_solver(
       pkg.get(), bicgstab_params, eq);
   pkg->AddParam<>("MGBiCGSTABsolver", bicg_solver,
                   parthenon::Params::Mutability::Mutable);
 
+  // Iterations, convergence rate and time per v-cycle phase of the last solve, the
+  // slowest rank's for the times
+  if (telemetry) {
+    parthenon::HstVec_list hst_vecs;
+    hst_vecs.emplace_back(
+        parthenon::UserHistoryOperation::max,
+        [](MeshData<Real> *md) {
+          using namespace parthenon::solvers;
+          auto pkg = md->GetParentPointer()->packages.Get("poisson_package");
+          if (pkg->Param<std::string>("solver") == "BiCGSTAB") {
+            const auto &solver = pkg->Param<BiCGSTABSolver<u, rhs, PoissonEquation>>(
+                "MGBiCGSTABsolver");
+            return solver.GetTelemetry().HistoryValues();
+          }
+          const auto &solver =
+              pkg->Param<MGSolver<u, rhs, PoissonEquation>>("MGsolver");
+          return solver.GetTelemetry().HistoryValues();
+        },
+        parthenon::solvers::SolverTelemetry::HistoryLabels("solver"));
+    pkg->AddParam<>(parthenon::hist_vec_param_key, hst_vecs);
+  }
+
   using namespace parthenon::refinement_ops;
   auto mD = Metadata(
       {Metadata::Independent, Metadata::OneCopy, Metadata::Face, Metadata::GMGRestrict});
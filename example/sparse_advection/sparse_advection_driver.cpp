@@ -103,13 +103,9 @@ TaskCollection SparseAdvectionDriver::MakeTaskCollection(BlockList_t &blocks,
     auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
 
     const auto any = parthenon::BoundaryType::any;
-    auto start_flxcor = tl.AddTask(none, parthenon::StartReceiveFluxCorrections, mc0);
     auto start_bound = tl.AddTask(none, parthenon::StartReceiveBoundBufs<any>, mc1);
 
-    auto send_flxcor =
-        tl.AddTask(start_flxcor, parthenon::LoadAndSendFluxCorrections, mc0);
-    auto recv_flxcor = tl.AddTask(start_flxcor, parthenon::ReceiveFluxCorrections, mc0);
-    auto set_flxcor = tl.AddTask(recv_flxcor, parthenon::SetFluxCorrections, mc0);
+    auto set_flxcor = parthenon::AddFluxCorrectionTasks(none, tl, mc0);
 
     // compute the divergence of fluxes of conserved variables
     auto flux_div =
@@ -112,6 +112,9 @@ TaskCollection StochasticSubgridDriver::MakeTaskCollection(BlockList_t &blocks,
 
   // update and boundary communication tasks
   {
+    PARTHENON_REQUIRE_THROWS(
+        integrator->storage == parthenon::LowStorageIntegrator::Storage::two_s,
+        "Only integrators in 2S form are supported");
     const Real beta = integrator->beta[stage - 1];
     const Real dt = integrator->dt;
     const int num_partitions = pmesh->DefaultNumPartitions();
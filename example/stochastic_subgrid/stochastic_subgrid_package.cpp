@@ -266,11 +266,9 @@ TaskStatus ComputeNumIter(std::shared_ptr<MeshData<Real>> &md, Packages_t &packa
       parthenon::DevExecSpace(), 0, pack.GetDim(5) - 1, 0, pack.GetDim(4) - 1, kb.s, kb.e,
       jb.s, jb.e, ib.s, ib.e, KOKKOS_LAMBDA(int b, int v, int k, int j, int i) {
         auto rng = pool.get_state();
-        double rand1 = rng.drand();
-        double rand2 = rng.drand();
+        int num_iter = N_min + alias.Sample(rng);
         pool.free_state(rng);
 
-        int num_iter = N_min + alias.Sample(rand1, rand2);
         pack(b, v, k, j, i) = num_iter;
       });
 
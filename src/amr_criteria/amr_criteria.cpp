@@ -13,14 +13,86 @@
 #include "amr_criteria/amr_criteria.hpp"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "amr_criteria/refinement_package.hpp"
+#include "interface/make_pack_descriptor.hpp"
+#include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
+#include "interface/sparse_pack.hpp"
 #include "interface/variable.hpp"
+#include "kokkos_abstraction.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 
 namespace parthenon {
+namespace {
+// Evaluate a criterion on all blocks of md with one team per block, which reduces the
+// indicator over the cells of its block.  Like the block by block version, blocks on
+// which the field is not allocated get AmrTag::same.
+template <typename Indicator>
+void TagBlocks(const AMRCriteria &crit, MeshData<Real> *md, const ParArray1D<int> &levels,
+               ParArray1D<AmrTag> &delta_levels, const Indicator &indicator) {
+  PARTHENON_INSTRUMENT
+  const int nblocks = md->NumBlocks();
+  if (nblocks == 0) return;
+  auto *rc = md->GetBlockData(0).get();
+  const bool has_field = rc->HasVariable(crit.field);
+  auto desc = MakePackDescriptor(md->GetMeshPointer()->resolved_packages.get(),
+                                 std::vector<std::string>{crit.field});
+  // keep all blocks, so that indices into the pack match indices into md
+  auto pack = desc.GetPack(md, {}, false);
+  PackIdx pidx(0);
+  int comp = 0;
+  if (has_field) {
+    pidx = desc.GetMap()[crit.field];
+    const auto &var = rc->Get(crit.field);
+    comp = (crit.comp6 * var.GetDim(5) + crit.comp5) * var.GetDim(4) + crit.comp4;
+  }
+
+  const auto bnds = crit.GetBounds(rc);
+  const int ndim = 1 + (bnds.je > bnds.js) + (bnds.ke > bnds.ks);
+  const int is = bnds.is, js = bnds.js, ks = bnds.ks;
+  const int ni = bnds.ie + 1 - bnds.is;
+  const int nji = (bnds.je + 1 - bnds.js) * ni;
+  const int nkji = (bnds.ke + 1 - bnds.ks) * nji;
+  const Real refine_criteria = crit.refine_criteria;
+  const Real derefine_criteria = crit.derefine_criteria;
+  const int max_level = crit.max_level;
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL,
+      Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), nblocks, Kokkos::AUTO),
+      KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
+        const int b = team_member.league_rank();
+        AmrTag tag = AmrTag::same;
+        if (has_field && pack.GetUpperBound(b, pidx) >= 0) {
+          const auto &q = pack(b, pack.GetLowerBound(b, pidx) + comp);
+          Real maxd = 0.0;
+          Kokkos::parallel_reduce(
+              Kokkos::TeamThreadRange<>(team_member, nkji),
+              [&](const int m, Real &lmax) {
+                const int k = ks + m / nji;
+                const int j = js + (m % nji) / ni;
+                const int i = is + m % ni;
+                const Real d = indicator(q, ndim, k, j, i);
+                lmax = (d > lmax ? d : lmax);
+              },
+              Kokkos::Max<Real, DevMemSpace>(maxd));
+          if (maxd > refine_criteria) {
+            tag = AmrTag::refine;
+          } else if (maxd < derefine_criteria) {
+            tag = AmrTag::derefine;
+          }
+        }
+        // don't refine if we're at the max level
+        if (tag == AmrTag::refine && levels(b) >= max_level) tag = AmrTag::same;
+        Kokkos::single(Kokkos::PerTeam(team_member), [&]() {
+          if (tag > delta_levels(b)) delta_levels(b) = tag;
+        });
+      });
+}
+} // namespace
 
 AMRCriteria::AMRCriteria(ParameterInput *pin, std::string &block_name)
     : comp6(0), comp5(0), comp4(0) {
@@ -93,6 +165,11 @@ AmrTag AMRFirstDerivative::operator()(const MeshBlockData<Real> *rc) const {
   return Refinement::FirstDerivative(bnds, q, refine_criteria, derefine_criteria);
 }
 
+void AMRFirstDerivative::operator()(MeshData<Real> *md, const ParArray1D<int> &levels,
+                                    ParArray1D<AmrTag> &delta_levels) const {
+  TagBlocks(*this, md, levels, delta_levels, Refinement::FirstDerivativeIndicator());
+}
+
 AmrTag AMRSecondDerivative::operator()(const MeshBlockData<Real> *rc) const {
   if (!rc->HasVariable(field) || !rc->IsAllocated(field)) {
     return AmrTag::same;
@@ -103,4 +180,9 @@ AmrTag AMRSecondDerivative::operator()(const MeshBlockData<Real> *rc) const {
   return Refinement::SecondDerivative(bnds, q, refine_criteria, derefine_criteria);
 }
 
+void AMRSecondDerivative::operator()(MeshData<Real> *md, const ParArray1D<int> &levels,
+                                     ParArray1D<AmrTag> &delta_levels) const {
+  TagBlocks(*this, md, levels, delta_levels, Refinement::SecondDerivativeIndicator());
+}
+
 } // namespace parthenon
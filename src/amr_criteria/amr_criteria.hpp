@@ -18,12 +18,15 @@
 
 #include "defs.hpp"
 #include "mesh/domain.hpp"
+#include "parthenon_arrays.hpp"
 
 namespace parthenon {
 
 class ParameterInput;
 template <class>
 class MeshBlockData;
+template <class>
+class MeshData;
 
 struct AMRBounds {
   AMRBounds(const IndexRange &ib, const IndexRange &jb, const IndexRange &kb)
@@ -36,6 +39,11 @@ struct AMRCriteria {
   AMRCriteria(ParameterInput *pin, std::string &block_name);
   virtual ~AMRCriteria() {}
   virtual AmrTag operator()(const MeshBlockData<Real> *rc) const = 0;
+  // Evaluate the criterion on all blocks of md in a single kernel and raise
+  // delta_levels(b) to the tag of block b if that is larger, levels(b) is the
+  // refinement level of block b
+  virtual void operator()(MeshData<Real> *md, const ParArray1D<int> &levels,
+                          ParArray1D<AmrTag> &delta_levels) const = 0;
   std::string field;
   Real refine_criteria, derefine_criteria;
   int max_level;
@@ -49,12 +57,16 @@ struct AMRFirstDerivative : public AMRCriteria {
   AMRFirstDerivative(ParameterInput *pin, std::string &block_name)
       : AMRCriteria(pin, block_name) {}
   AmrTag operator()(const MeshBlockData<Real> *rc) const override;
+  void operator()(MeshData<Real> *md, const ParArray1D<int> &levels,
+                  ParArray1D<AmrTag> &delta_levels) const override;
 };
 
 struct AMRSecondDerivative : public AMRCriteria {
   AMRSecondDerivative(ParameterInput *pin, std::string &block_name)
       : AMRCriteria(pin, block_name) {}
   AmrTag operator()(const MeshBlockData<Real> *rc) const override;
+  void operator()(MeshData<Real> *md, const ParArray1D<int> &levels,
+                  ParArray1D<AmrTag> &delta_levels) const override;
 };
 
 } // namespace parthenon
@@ -17,6 +17,7 @@
 #include <exception>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "amr_criteria/amr_criteria.hpp"
 #include "interface/mesh_data.hpp"
@@ -89,6 +90,49 @@ AmrTag CheckAllRefinement(MeshBlockData<Real> *rc) {
   return delta_level;
 }
 
+ParArray1D<AmrTag>::HostMirror CheckAllRefinement(MeshData<Real> *md) {
+  // Same as the MeshBlockData version above, but the criteria registered with the
+  // packages and packages with a CheckRefinementMesh function raise the tags of all
+  // blocks on the device, while CheckRefinementBlock functions are still called block
+  // by block.
+  PARTHENON_INSTRUMENT
+  const int nblocks = md->NumBlocks();
+  ParArray1D<AmrTag> delta_levels("delta_levels", nblocks);
+  auto delta_levels_h = delta_levels.GetHostMirror();
+  ParArray1D<int> levels("levels", nblocks);
+  auto levels_h = levels.GetHostMirror();
+  for (int b = 0; b < nblocks; b++) {
+    delta_levels_h(b) = AmrTag::derefine;
+    levels_h(b) = md->GetBlockData(b)->GetBlockPointer()->loc.level();
+  }
+  Kokkos::deep_copy(delta_levels, delta_levels_h);
+  Kokkos::deep_copy(levels, levels_h);
+  if (nblocks == 0) return delta_levels_h;
+
+  // the tags of the block by block checks, which are combined with the device tags
+  std::vector<AmrTag> block_levels(nblocks, AmrTag::derefine);
+  auto &packages = md->GetBlockData(0)->GetBlockPointer()->packages;
+  for (auto &pkg : packages.AllPackages()) {
+    auto &desc = pkg.second;
+    if (desc->CheckRefinementMesh != nullptr) {
+      desc->CheckRefinement(md, delta_levels);
+    } else if (desc->CheckRefinementBlock != nullptr) {
+      for (int b = 0; b < nblocks; b++) {
+        block_levels[b] =
+            std::max(block_levels[b], desc->CheckRefinement(md->GetBlockData(b).get()));
+      }
+    }
+    for (auto &amr : desc->amr_criteria) {
+      (*amr)(md, levels, delta_levels);
+    }
+  }
+  Kokkos::deep_copy(delta_levels_h, delta_levels);
+  for (int b = 0; b < nblocks; b++) {
+    delta_levels_h(b) = std::max(delta_levels_h(b), block_levels[b]);
+  }
+  return delta_levels_h;
+}
+
 AmrTag FirstDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
                        const Real refine_criteria, const Real derefine_criteria) {
   PARTHENON_INSTRUMENT
@@ -98,18 +142,8 @@ AmrTag FirstDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
       loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, DevExecSpace(), bnds.ks, bnds.ke,
       bnds.js, bnds.je, bnds.is, bnds.ie,
       KOKKOS_LAMBDA(int k, int j, int i, Real &maxd) {
-        Real scale = std::abs(q(k, j, i));
-        Real d =
-            0.5 * std::abs((q(k, j, i + 1) - q(k, j, i - 1))) / (scale + TINY_NUMBER);
+        Real d = FirstDerivativeIndicator()(q, ndim, k, j, i);
         maxd = (d > maxd ? d : maxd);
-        if (ndim > 1) {
-          d = 0.5 * std::abs((q(k, j + 1, i) - q(k, j - 1, i))) / (scale + TINY_NUMBER);
-          maxd = (d > maxd ? d : maxd);
-        }
-        if (ndim > 2) {
-          d = 0.5 * std::abs((q(k + 1, j, i) - q(k - 1, j, i))) / (scale + TINY_NUMBER);
-          maxd = (d > maxd ? d : maxd);
-        }
       },
       Kokkos::Max<Real>(maxd));
 
@@ -127,20 +161,8 @@ AmrTag SecondDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
       loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, DevExecSpace(), bnds.ks, bnds.ke,
       bnds.js, bnds.je, bnds.is, bnds.ie,
       KOKKOS_LAMBDA(int k, int j, int i, Real &maxd) {
-        Real aqt = std::abs(q(k, j, i)) + TINY_NUMBER;
-        Real qavg = 0.5 * (q(k, j, i + 1) + q(k, j, i - 1));
-        Real d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+        Real d = SecondDerivativeIndicator()(q, ndim, k, j, i);
         maxd = (d > maxd ? d : maxd);
-        if (ndim > 1) {
-          qavg = 0.5 * (q(k, j + 1, i) + q(k, j - 1, i));
-          d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
-          maxd = (d > maxd ? d : maxd);
-        }
-        if (ndim > 2) {
-          qavg = 0.5 * (q(k + 1, j, i) + q(k - 1, j, i));
-          d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
-          maxd = (d > maxd ? d : maxd);
-        }
       },
       Kokkos::Max<Real>(maxd));
 
@@ -157,16 +179,21 @@ void SetRefinement_(MeshBlockData<Real> *rc) {
 template <>
 TaskStatus Tag(MeshBlockData<Real> *rc) {
   PARTHENON_INSTRUMENT
+  Kokkos::Timer timer;
   SetRefinement_(rc);
+  rc->GetBlockPointer()->pmy_mesh->remesh_times.tag += timer.seconds();
   return TaskStatus::complete;
 }
 
 template <>
 TaskStatus Tag(MeshData<Real> *rc) {
   PARTHENON_INSTRUMENT
+  Kokkos::Timer timer;
+  auto delta_levels = CheckAllRefinement(rc);
   for (int i = 0; i < rc->NumBlocks(); i++) {
-    SetRefinement_(rc->GetBlockData(i).get());
+    rc->GetBlockData(i)->GetBlockPointer()->pmr->SetRefinement(delta_levels(i));
   }
+  rc->GetMeshPointer()->remesh_times.tag += timer.seconds();
   return TaskStatus::complete;
 }
 
@@ -14,6 +14,7 @@
 #ifndef AMR_CRITERIA_REFINEMENT_PACKAGE_HPP_
 #define AMR_CRITERIA_REFINEMENT_PACKAGE_HPP_
 
+#include <cmath>
 #include <memory>
 #include <string>
 
@@ -38,6 +39,49 @@ template <typename T>
 TaskStatus Tag(T *rc);
 
 AmrTag CheckAllRefinement(MeshBlockData<Real> *rc);
+// The tags of all blocks of md, evaluated with one kernel per criterion and copied to
+// the host once
+ParArray1D<AmrTag>::HostMirror CheckAllRefinement(MeshData<Real> *md);
+
+// The quantities the predefined criteria compare to their tolerances, at cell (k, j, i)
+struct FirstDerivativeIndicator {
+  template <typename View>
+  KOKKOS_INLINE_FUNCTION Real operator()(const View &q, const int ndim, const int k,
+                                         const int j, const int i) const {
+    Real scale = std::abs(q(k, j, i));
+    Real maxd = 0.5 * std::abs((q(k, j, i + 1) - q(k, j, i - 1))) / (scale + TINY_NUMBER);
+    if (ndim > 1) {
+      Real d = 0.5 * std::abs((q(k, j + 1, i) - q(k, j - 1, i))) / (scale + TINY_NUMBER);
+      maxd = (d > maxd ? d : maxd);
+    }
+    if (ndim > 2) {
+      Real d = 0.5 * std::abs((q(k + 1, j, i) - q(k - 1, j, i))) / (scale + TINY_NUMBER);
+      maxd = (d > maxd ? d : maxd);
+    }
+    return maxd;
+  }
+};
+
+struct SecondDerivativeIndicator {
+  template <typename View>
+  KOKKOS_INLINE_FUNCTION Real operator()(const View &q, const int ndim, const int k,
+                                         const int j, const int i) const {
+    Real aqt = std::abs(q(k, j, i)) + TINY_NUMBER;
+    Real qavg = 0.5 * (q(k, j, i + 1) + q(k, j, i - 1));
+    Real maxd = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+    if (ndim > 1) {
+      qavg = 0.5 * (q(k, j + 1, i) + q(k, j - 1, i));
+      Real d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+      maxd = (d > maxd ? d : maxd);
+    }
+    if (ndim > 2) {
+      qavg = 0.5 * (q(k + 1, j, i) + q(k - 1, j, i));
+      Real d = std::abs(qavg - q(k, j, i)) / (std::abs(qavg) + aqt);
+      maxd = (d > maxd ? d : maxd);
+    }
+    return maxd;
+  }
+};
 
 AmrTag FirstDerivative(const AMRBounds &bnds, const ParArray3D<Real> &q,
                        const Real refine_criteria, const Real derefine_criteria);
@@ -51,6 +51,10 @@ struct ApplicationInput {
 
   std::function<void(Mesh *, ParameterInput *, SimTime &)> UserWorkAfterLoop = nullptr;
   std::function<void(Mesh *, ParameterInput *, SimTime &)> UserWorkBeforeLoop = nullptr;
+  // Assign the blocks (ordered by gid) to ranks given their costs, replacing the
+  // partitioner selected in <parthenon/loadbalancing>, see load_balancing.rst
+  std::function<void(std::vector<double> const &, std::vector<int> &)> AssignBlocks =
+      nullptr;
   BValFunc boundary_conditions[BOUNDARY_NFACES] = {nullptr};
   SBValFunc swarm_boundary_conditions[BOUNDARY_NFACES] = {nullptr};
 
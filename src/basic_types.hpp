@@ -50,6 +50,8 @@ enum class TaskStatus { complete, incomplete, iterate };
 enum class AmrTag : int { derefine = -1, same = 0, refine = 1 };
 enum class RefinementOp_t { Prolongation, Restriction, None };
 enum class CellLevel : int { coarse = -1, same = 0, fine = 1 };
+// Encoding of boundary buffers sent across ranks, see bvals/comms/comm_encoding.hpp
+enum class CommEncoding { none, quantized, float32, bfloat16 };
 // JMM: Not clear this is the best place for this but it minimizes
 // circular dependency nonsense.
 constexpr int NUM_BNDRY_TYPES = 10;
@@ -201,6 +203,12 @@ struct SimTime {
   Real start_time, time, tlim, dt;
   // current cycle number, maximum number of cycles, cycles between diagnostic output
   int ncycle, nlim, ncycle_out, ncycle_out_mesh;
+  // smallest timestep allowed by the blocks of each refinement level, counted from the
+  // root level, over all ranks
+  std::vector<Real> dt_level;
+  // timestep for the next cycle proposed by an error controlled step, which replaces the
+  // growth limit of the previous timestep if positive
+  Real dt_proposed = 0.0;
 
   bool KeepGoing() { return ((time < tlim) && (nlim < 0 || ncycle < nlim)); }
 };
@@ -26,11 +26,6 @@
 
 namespace parthenon {
 
-namespace boundary_cond_impl {
-bool DoPhysicalBoundary_(const BoundaryFlag flag, const BoundaryFace face,
-                         const int ndim);
-} // namespace boundary_cond_impl
-
 TaskStatus ApplyBoundaryConditionsOnCoarseOrFine(std::shared_ptr<MeshBlockData<Real>> &rc,
                                                  bool coarse) {
   PARTHENON_INSTRUMENT
@@ -38,6 +33,8 @@ TaskStatus ApplyBoundaryConditionsOnCoarseOrFine(std::shared_ptr<MeshBlockData<R
   MeshBlock *pmb = rc->GetBlockPointer();
   Mesh *pmesh = pmb->pmy_mesh;
   const int ndim = pmesh->ndim;
+  // with coarse buffers on demand, there is nothing to fill on the coarse level
+  if (coarse && !pmb->HasCoarseBuffers()) return TaskStatus::complete;
 
   for (int i = 0; i < BOUNDARY_NFACES; i++) {
     if (DoPhysicalBoundary_(pmb->boundary_flag[i], static_cast<BoundaryFace>(i), ndim)) {
@@ -54,15 +51,48 @@ TaskStatus ApplyBoundaryConditionsOnCoarseOrFine(std::shared_ptr<MeshBlockData<R
 }
 
 TaskStatus ApplyBoundaryConditionsMD(std::shared_ptr<MeshData<Real>> &pmd) {
-  for (int b = 0; b < pmd->NumBlocks(); ++b)
-    ApplyBoundaryConditions(pmd->GetBlockData(b));
-  return TaskStatus::complete;
+  return ApplyBoundaryConditionsOnCoarseOrFineMD(pmd, false);
 }
 
+// Faces with a MeshData version of their boundary condition are done for all blocks at
+// once, the others block by block.  Since the faces are still gone through in order and
+// user boundary functions follow the boundary condition of their face, every block sees
+// the same sequence of operations as in ApplyBoundaryConditionsOnCoarseOrFine.
 TaskStatus ApplyBoundaryConditionsOnCoarseOrFineMD(std::shared_ptr<MeshData<Real>> &pmd,
                                                    bool coarse) {
-  for (int b = 0; b < pmd->NumBlocks(); ++b)
-    ApplyBoundaryConditionsOnCoarseOrFine(pmd->GetBlockData(b), coarse);
+  PARTHENON_INSTRUMENT
+  using namespace boundary_cond_impl;
+  Mesh *pmesh = pmd->GetMeshPointer();
+  const int ndim = pmesh->ndim;
+  // The MeshData versions of the boundary conditions fill the coarse buffers of all
+  // blocks, so fall back to block by block if some blocks don't have them
+  bool all_coarse = true;
+  for (int b = 0; coarse && b < pmd->NumBlocks(); ++b) {
+    MeshBlock *pmb = pmd->GetBlockData(b)->GetBlockPointer();
+    all_coarse = all_coarse && pmb->HasCoarseBuffers();
+  }
+
+  for (int i = 0; i < BOUNDARY_NFACES; i++) {
+    const bool batched = static_cast<bool>(pmesh->MeshBndryFnctnMD[i]) && all_coarse;
+    if (batched) pmesh->MeshBndryFnctnMD[i](pmd, coarse);
+    if (batched && pmesh->UserBoundaryFunctions[i].empty()) continue;
+    for (int b = 0; b < pmd->NumBlocks(); ++b) {
+      auto &rc = pmd->GetBlockData(b);
+      MeshBlock *pmb = rc->GetBlockPointer();
+      if (!DoPhysicalBoundary_(pmb->boundary_flag[i], static_cast<BoundaryFace>(i), ndim))
+        continue;
+      if (coarse && !pmb->HasCoarseBuffers()) continue;
+      if (!batched) {
+        PARTHENON_DEBUG_REQUIRE(pmesh->MeshBndryFnctn[i] != nullptr,
+                                "boundary function must not be null");
+        pmesh->MeshBndryFnctn[i](rc, coarse);
+      }
+      for (auto &bnd_func : pmesh->UserBoundaryFunctions[i]) {
+        bnd_func(rc, coarse);
+      }
+    }
+  }
+
   return TaskStatus::complete;
 }
 
@@ -116,6 +146,54 @@ void ReflectOuterX3(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse) {
   GenericBC<X3DIR, BCSide::Outer, BCType::Reflect, variable_names::any>(rc, coarse);
 }
 
+void OutflowInnerX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X1DIR, BCSide::Inner, BCType::Outflow, variable_names::any>(md, coarse);
+}
+
+void OutflowOuterX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X1DIR, BCSide::Outer, BCType::Outflow, variable_names::any>(md, coarse);
+}
+
+void OutflowInnerX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X2DIR, BCSide::Inner, BCType::Outflow, variable_names::any>(md, coarse);
+}
+
+void OutflowOuterX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X2DIR, BCSide::Outer, BCType::Outflow, variable_names::any>(md, coarse);
+}
+
+void OutflowInnerX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X3DIR, BCSide::Inner, BCType::Outflow, variable_names::any>(md, coarse);
+}
+
+void OutflowOuterX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X3DIR, BCSide::Outer, BCType::Outflow, variable_names::any>(md, coarse);
+}
+
+void ReflectInnerX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X1DIR, BCSide::Inner, BCType::Reflect, variable_names::any>(md, coarse);
+}
+
+void ReflectOuterX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X1DIR, BCSide::Outer, BCType::Reflect, variable_names::any>(md, coarse);
+}
+
+void ReflectInnerX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X2DIR, BCSide::Inner, BCType::Reflect, variable_names::any>(md, coarse);
+}
+
+void ReflectOuterX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X2DIR, BCSide::Outer, BCType::Reflect, variable_names::any>(md, coarse);
+}
+
+void ReflectInnerX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X3DIR, BCSide::Inner, BCType::Reflect, variable_names::any>(md, coarse);
+}
+
+void ReflectOuterX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse) {
+  GenericBCMD<X3DIR, BCSide::Outer, BCType::Reflect, variable_names::any>(md, coarse);
+}
+
 } // namespace BoundaryFunction
 
 namespace boundary_cond_impl {
@@ -28,6 +28,9 @@ namespace parthenon {
 // Physical boundary conditions
 
 using BValFunc = std::function<void(std::shared_ptr<MeshBlockData<Real>> &, bool)>;
+// applies a boundary condition to all blocks of a MeshData that have a physical boundary
+// on the face it is enrolled for
+using MDBValFunc = std::function<void(std::shared_ptr<MeshData<Real>> &, bool)>;
 using SBValFunc = std::function<
     std::unique_ptr<ParticleBound, DeviceDeleter<parthenon::DevMemSpace>>()>;
 
@@ -58,6 +61,19 @@ void ReflectOuterX2(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse);
 void ReflectInnerX3(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse);
 void ReflectOuterX3(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse);
 
+void OutflowInnerX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void OutflowOuterX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void OutflowInnerX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void OutflowOuterX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void OutflowInnerX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void OutflowOuterX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void ReflectInnerX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void ReflectOuterX1MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void ReflectInnerX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void ReflectOuterX2MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void ReflectInnerX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+void ReflectOuterX3MD(std::shared_ptr<MeshData<Real>> &md, bool coarse);
+
 } // namespace BoundaryFunction
 } // namespace parthenon
 
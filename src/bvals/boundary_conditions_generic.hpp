@@ -14,14 +14,18 @@
 #ifndef BVALS_BOUNDARY_CONDITIONS_GENERIC_HPP_
 #define BVALS_BOUNDARY_CONDITIONS_GENERIC_HPP_
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "basic_types.hpp"
+#include "bvals/bvals_interfaces.hpp"
 #include "interface/make_pack_descriptor.hpp"
+#include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
 #include "interface/sparse_pack.hpp"
 #include "mesh/domain.hpp"
@@ -29,23 +33,117 @@
 #include "mesh/meshblock.hpp"
 
 namespace parthenon {
+namespace boundary_cond_impl {
+bool DoPhysicalBoundary_(const BoundaryFlag flag, const BoundaryFace face,
+                         const int ndim);
+} // namespace boundary_cond_impl
+
 namespace BoundaryFunction {
 
 enum class BCSide { Inner, Outer };
 enum class BCType { Outflow, Reflect, ConstantDeriv, Fixed, FixedFace };
 
+namespace impl {
+// Sets the ghost zone (k, j, i) of the variable l on the block b of the pack q, where ref
+// is the index of the last interior zone along DIR
+template <CoordinateDirection DIR, BCSide SIDE, BCType TYPE, class pack_t>
+KOKKOS_FORCEINLINE_FUNCTION void GenericBCZone(const pack_t &q, const int b,
+                                               const TopologicalElement el, const int l,
+                                               const int k, const int j, const int i,
+                                               const int ref, const Real val) {
+  constexpr bool X1 = (DIR == X1DIR);
+  constexpr bool X2 = (DIR == X2DIR);
+  constexpr bool X3 = (DIR == X3DIR);
+  constexpr bool INNER = (SIDE == BCSide::Inner);
+
+  // used for reflections
+  const int offset = 2 * ref + (INNER ? -1 : 1);
+
+  // used for derivatives
+  const int offsetin = INNER;
+  const int offsetout = !INNER;
+  if (TYPE == BCType::Reflect) {
+    const bool reflect = (q(b, el, l).vector_component == DIR);
+    q(b, el, l, k, j, i) =
+        (reflect ? -1.0 : 1.0) *
+        q(b, el, l, X3 ? offset - k : k, X2 ? offset - j : j, X1 ? offset - i : i);
+  } else if (TYPE == BCType::FixedFace) {
+    q(b, el, l, k, j, i) = 2.0 * val - q(b, el, l, X3 ? offset - k : k,
+                                         X2 ? offset - j : j, X1 ? offset - i : i);
+  } else if (TYPE == BCType::ConstantDeriv) {
+    Real dq = q(b, el, l, X3 ? ref + offsetin : k, X2 ? ref + offsetin : j,
+                X1 ? ref + offsetin : i) -
+              q(b, el, l, X3 ? ref - offsetout : k, X2 ? ref - offsetout : j,
+                X1 ? ref - offsetout : i);
+    Real delta = 0.0;
+    if (X1) {
+      delta = i - ref;
+    } else if (X2) {
+      delta = j - ref;
+    } else {
+      delta = k - ref;
+    }
+    q(b, el, l, k, j, i) =
+        q(b, el, l, X3 ? ref : k, X2 ? ref : j, X1 ? ref : i) + delta * dq;
+  } else if (TYPE == BCType::Fixed) {
+    q(b, el, l, k, j, i) = val;
+  } else {
+    q(b, el, l, k, j, i) = q(b, el, l, X3 ? ref : k, X2 ? ref : j, X1 ? ref : i);
+  }
+}
+
+template <CoordinateDirection DIR, BCSide SIDE>
+constexpr IndexDomain GhostDomain() {
+  constexpr bool X1 = (DIR == X1DIR);
+  constexpr bool X2 = (DIR == X2DIR);
+  return SIDE == BCSide::Inner
+             ? (X1 ? IndexDomain::inner_x1
+                   : (X2 ? IndexDomain::inner_x2 : IndexDomain::inner_x3))
+             : (X1 ? IndexDomain::outer_x1
+                   : (X2 ? IndexDomain::outer_x2 : IndexDomain::outer_x3));
+}
+
+template <CoordinateDirection DIR, BCSide SIDE>
+int ReferenceIndex(const IndexShape &bounds, const TopologicalElement el) {
+  const auto &range = DIR == X1DIR ? bounds.GetBoundsI(IndexDomain::interior, el)
+                                   : (DIR == X2DIR
+                                          ? bounds.GetBoundsJ(IndexDomain::interior, el)
+                                          : bounds.GetBoundsK(IndexDomain::interior, el));
+  return SIDE == BCSide::Inner ? range.s : range.e;
+}
+
+// The indices into pmd of the blocks that have a physical boundary on face, on the
+// device.  The list is kept in pmd and only copied to the device again when it changes.
+inline const ParArray1D<int> &PhysicalBoundaryBlocks(MeshData<Real> *pmd,
+                                                     const BoundaryFace face,
+                                                     int &nblocks) {
+  const int ndim = pmd->GetMeshPointer()->ndim;
+  std::vector<int> blocks;
+  for (int b = 0; b < pmd->NumBlocks(); ++b) {
+    const auto flag = pmd->GetBlockData(b)->GetBlockPointer()->boundary_flag[face];
+    if (boundary_cond_impl::DoPhysicalBoundary_(flag, face, ndim)) blocks.push_back(b);
+  }
+  nblocks = blocks.size();
+  auto &cache = pmd->GetPhysicalBoundaryBlocks(face);
+  if (blocks != cache.host) {
+    cache.host = std::move(blocks);
+    cache.device = ParArray1D<int>("physical boundary blocks", cache.host.size());
+    auto device_h = Kokkos::create_mirror_view(cache.device);
+    for (int n = 0; n < nblocks; ++n) {
+      device_h(n) = cache.host[n];
+    }
+    Kokkos::deep_copy(cache.device, device_h);
+  }
+  return cache.device;
+}
+} // namespace impl
+
 template <CoordinateDirection DIR, BCSide SIDE, BCType TYPE, class... var_ts>
 void GenericBC(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse,
                TopologicalElement el, Real val) {
   // make sure DIR is X[123]DIR so we don't have to check again
   static_assert(DIR == X1DIR || DIR == X2DIR || DIR == X3DIR, "DIR must be X[123]DIR");
 
-  // convenient shorthands
-  constexpr bool X1 = (DIR == X1DIR);
-  constexpr bool X2 = (DIR == X2DIR);
-  constexpr bool X3 = (DIR == X3DIR);
-  constexpr bool INNER = (SIDE == BCSide::Inner);
-
   std::vector<MetadataFlag> flags{Metadata::FillGhost};
   if (GetTopologicalType(el) == TopologicalType::Cell) flags.push_back(Metadata::Cell);
   if (GetTopologicalType(el) == TopologicalType::Face) flags.push_back(Metadata::Face);
@@ -65,59 +163,12 @@ void GenericBC(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse,
 
   MeshBlock *pmb = rc->GetBlockPointer();
   const auto &bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
+  const int ref = impl::ReferenceIndex<DIR, SIDE>(bounds, el);
 
-  const auto &range = X1 ? bounds.GetBoundsI(IndexDomain::interior, el)
-                         : (X2 ? bounds.GetBoundsJ(IndexDomain::interior, el)
-                               : bounds.GetBoundsK(IndexDomain::interior, el));
-  const int ref = INNER ? range.s : range.e;
-
-  std::string label = (TYPE == BCType::Reflect ? "Reflect" : "Outflow");
-  label += (INNER ? "Inner" : "Outer");
-  label += "X" + std::to_string(DIR);
-
-  constexpr IndexDomain domain =
-      INNER ? (X1 ? IndexDomain::inner_x1
-                  : (X2 ? IndexDomain::inner_x2 : IndexDomain::inner_x3))
-            : (X1 ? IndexDomain::outer_x1
-                  : (X2 ? IndexDomain::outer_x2 : IndexDomain::outer_x3));
-
-  // used for reflections
-  const int offset = 2 * ref + (INNER ? -1 : 1);
-
-  // used for derivatives
-  const int offsetin = INNER;
-  const int offsetout = !INNER;
   pmb->par_for_bndry(
-      PARTHENON_AUTO_LABEL, nb, domain, el, coarse,
+      PARTHENON_AUTO_LABEL, nb, impl::GhostDomain<DIR, SIDE>(), el, coarse,
       KOKKOS_LAMBDA(const int &l, const int &k, const int &j, const int &i) {
-        if (TYPE == BCType::Reflect) {
-          const bool reflect = (q(b, el, l).vector_component == DIR);
-          q(b, el, l, k, j, i) =
-              (reflect ? -1.0 : 1.0) *
-              q(b, el, l, X3 ? offset - k : k, X2 ? offset - j : j, X1 ? offset - i : i);
-        } else if (TYPE == BCType::FixedFace) {
-          q(b, el, l, k, j, i) = 2.0 * val - q(b, el, l, X3 ? offset - k : k,
-                                               X2 ? offset - j : j, X1 ? offset - i : i);
-        } else if (TYPE == BCType::ConstantDeriv) {
-          Real dq = q(b, el, l, X3 ? ref + offsetin : k, X2 ? ref + offsetin : j,
-                      X1 ? ref + offsetin : i) -
-                    q(b, el, l, X3 ? ref - offsetout : k, X2 ? ref - offsetout : j,
-                      X1 ? ref - offsetout : i);
-          Real delta = 0.0;
-          if (X1) {
-            delta = i - ref;
-          } else if (X2) {
-            delta = j - ref;
-          } else {
-            delta = k - ref;
-          }
-          q(b, el, l, k, j, i) =
-              q(b, el, l, X3 ? ref : k, X2 ? ref : j, X1 ? ref : i) + delta * dq;
-        } else if (TYPE == BCType::Fixed) {
-          q(b, el, l, k, j, i) = val;
-        } else {
-          q(b, el, l, k, j, i) = q(b, el, l, X3 ? ref : k, X2 ? ref : j, X1 ? ref : i);
-        }
+        impl::GenericBCZone<DIR, SIDE, TYPE>(q, b, el, l, k, j, i, ref, val);
       });
 }
 
@@ -128,6 +179,62 @@ void GenericBC(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse, Real val =
     GenericBC<DIR, SIDE, TYPE, var_ts...>(rc, coarse, el, val);
 }
 
+// Same as GenericBC, but for all blocks of pmd that have a physical boundary on the face
+// given by DIR and SIDE at once, i.e., with a single kernel instead of one per block
+template <CoordinateDirection DIR, BCSide SIDE, BCType TYPE, class... var_ts>
+void GenericBCMD(std::shared_ptr<MeshData<Real>> &pmd, bool coarse, TopologicalElement el,
+                 Real val) {
+  static_assert(DIR == X1DIR || DIR == X2DIR || DIR == X3DIR, "DIR must be X[123]DIR");
+  const BoundaryFace face =
+      SIDE == BCSide::Inner ? GetInnerBoundaryFace(DIR) : GetOuterBoundaryFace(DIR);
+  int nbc;
+  const auto bc_blocks = impl::PhysicalBoundaryBlocks(pmd.get(), face, nbc);
+  if (nbc == 0) return;
+
+  std::vector<MetadataFlag> flags{Metadata::FillGhost};
+  if (GetTopologicalType(el) == TopologicalType::Cell) flags.push_back(Metadata::Cell);
+  if (GetTopologicalType(el) == TopologicalType::Face) flags.push_back(Metadata::Face);
+  if (GetTopologicalType(el) == TopologicalType::Edge) flags.push_back(Metadata::Edge);
+  if (GetTopologicalType(el) == TopologicalType::Node) flags.push_back(Metadata::Node);
+
+  std::set<PDOpt> opts;
+  if (coarse) opts = {PDOpt::Coarse};
+  auto desc = MakePackDescriptor<var_ts...>(
+      pmd->GetMeshPointer()->resolved_packages.get(), flags, opts);
+  auto q = desc.GetPack(pmd.get());
+  // the number of variables can differ from block to block for sparse variables
+  int nvar = 0;
+  for (const int b : pmd->GetPhysicalBoundaryBlocks(face).host) {
+    nvar = std::max(nvar, q.GetUpperBoundHost(b) - q.GetLowerBoundHost(b) + 1);
+  }
+  if (nvar == 0) return;
+
+  MeshBlock *pmb = pmd->GetBlockData(0)->GetBlockPointer();
+  const auto &bounds = coarse ? pmb->c_cellbounds : pmb->cellbounds;
+  const int ref = impl::ReferenceIndex<DIR, SIDE>(bounds, el);
+  constexpr IndexDomain domain = impl::GhostDomain<DIR, SIDE>();
+  const auto ib = bounds.GetBoundsI(domain, el);
+  const auto jb = bounds.GetBoundsJ(domain, el);
+  const auto kb = bounds.GetBoundsK(domain, el);
+
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, pmd->GetExecSpace(), 0, nbc - 1, 0,
+      nvar - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int n, const int v, const int k, const int j, const int i) {
+        const int b = bc_blocks(n);
+        const int l = q.GetLowerBound(b) + v;
+        if (l > q.GetUpperBound(b)) return;
+        impl::GenericBCZone<DIR, SIDE, TYPE>(q, b, el, l, k, j, i, ref, val);
+      });
+}
+
+template <CoordinateDirection DIR, BCSide SIDE, BCType TYPE, class... var_ts>
+void GenericBCMD(std::shared_ptr<MeshData<Real>> &pmd, bool coarse, Real val = 0.0) {
+  using TE = TopologicalElement;
+  for (auto el : {TE::CC, TE::F1, TE::F2, TE::F3, TE::E1, TE::E2, TE::E3, TE::NN})
+    GenericBCMD<DIR, SIDE, TYPE, var_ts...>(pmd, coarse, el, val);
+}
+
 } // namespace BoundaryFunction
 } // namespace parthenon
 
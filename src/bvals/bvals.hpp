@@ -82,6 +82,8 @@ class BoundaryBase {
   void
   SearchAndSetNeighbors(Mesh *mesh, MeshBlockTree &tree, int *ranklist, int *nslist,
                         const std::unordered_set<LogicalLocation> &newly_refined = {});
+  void
+  SetNeighborOwnership(const std::unordered_set<LogicalLocation> &newly_refined = {});
 
  protected:
   // 1D refined or unrefined=2
@@ -93,9 +95,6 @@ class BoundaryBase {
   RegionSize block_size_;
   ParArrayND<Real> sarea_[2];
 
-  void
-  SetNeighborOwnership(const std::unordered_set<LogicalLocation> &newly_refined = {});
-
  private:
   // calculate 3x shared static data members when constructing only the 1st class instance
   // int maxneighbor_=BufferID() computes ni[] and then calls bufid[]=CreateBufferID()
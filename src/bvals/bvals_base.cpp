@@ -665,10 +665,11 @@ void BoundaryBase::SearchAndSetNeighbors(
 void BoundaryBase::SetNeighborOwnership(
     const std::unordered_set<LogicalLocation> &newly_refined) {
   // Set neighbor block ownership
-  std::unordered_set<LogicalLocation> allowed_neighbors;
+  PossibleNeighbors_t allowed_neighbors;
   allowed_neighbors.insert(loc); // Insert the location of this block
   for (int n = 0; n < nneighbor; ++n)
     allowed_neighbors.insert(neighbor[n].loc);
+  allowed_neighbors.Unique();
   // Although the neighbor blocks abut more blocks than are contained in this
   // list, the unaccounted for blocks cannot impact the ownership of elements
   // that are shared with *this
@@ -311,6 +311,8 @@ class BoundarySwarm : public BoundaryCommunication {
   void ClearBoundary(BoundaryCommSubset phase) final{};
   void Receive(BoundaryCommSubset phase);
   void Send(BoundaryCommSubset phase);
+  // Deliver the send buffers for neighbors on this rank only, by device copies
+  void SendToSameRank();
 
   BoundaryData<> bd_var_;
   std::weak_ptr<MeshBlock> pmy_block;
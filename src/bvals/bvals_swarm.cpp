@@ -90,36 +90,44 @@ void BoundarySwarm::Send(BoundaryCommSubset phase) {
   std::shared_ptr<MeshBlock> pmb = GetBlockPointer();
   // Fence to make sure buffers are loaded before sending
   pmb->exec_space.fence();
+#ifdef MPI_PARALLEL
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     NeighborBlock &nb = pmb->pbval->neighbor[n];
     if (nb.snb.rank != Globals::my_rank) {
-#ifdef MPI_PARALLEL
       PARTHENON_REQUIRE(bd_var_.req_send[nb.bufid] == MPI_REQUEST_NULL,
                         "Trying to create a new send before previous send completes!");
       PARTHENON_MPI_CHECK(MPI_Isend(bd_var_.send[nb.bufid].data(), send_size[nb.bufid],
                                     MPI_PARTHENON_REAL, nb.snb.rank, send_tag[nb.bufid],
                                     swarm_comm, &(bd_var_.req_send[nb.bufid])));
+    }
+  }
 #endif // MPI_PARALLEL
-    } else {
-      MeshBlock &target_block = *pmy_mesh_->FindMeshBlock(nb.snb.gid);
-      std::shared_ptr<BoundarySwarm> ptarget_bswarm =
-          target_block.pbswarm->bswarms[bswarm_index];
-      if (send_size[nb.bufid] > 0) {
-        // Ensure target buffer is large enough
-        if (bd_var_.send[nb.bufid].extent(0) >
-            ptarget_bswarm->bd_var_.recv[nb.targetid].extent(0)) {
-          ptarget_bswarm->bd_var_.recv[nb.targetid] =
-              BufArray1D<Real>("Buffer", (bd_var_.send[nb.bufid].extent(0)));
-        }
+  SendToSameRank();
+}
 
-        target_block.deep_copy(ptarget_bswarm->bd_var_.recv[nb.targetid],
-                               bd_var_.send[nb.bufid]);
-        ptarget_bswarm->recv_size[nb.targetid] = send_size[nb.bufid];
-        ptarget_bswarm->bd_var_.flag[nb.targetid] = BoundaryStatus::arrived;
-      } else {
-        ptarget_bswarm->recv_size[nb.targetid] = 0;
-        ptarget_bswarm->bd_var_.flag[nb.targetid] = BoundaryStatus::completed;
+void BoundarySwarm::SendToSameRank() {
+  std::shared_ptr<MeshBlock> pmb = GetBlockPointer();
+  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+    NeighborBlock &nb = pmb->pbval->neighbor[n];
+    if (nb.snb.rank != Globals::my_rank) continue;
+    MeshBlock &target_block = *pmy_mesh_->FindMeshBlock(nb.snb.gid);
+    std::shared_ptr<BoundarySwarm> ptarget_bswarm =
+        target_block.pbswarm->bswarms[bswarm_index];
+    if (send_size[nb.bufid] > 0) {
+      // Ensure target buffer is large enough
+      if (bd_var_.send[nb.bufid].extent(0) >
+          ptarget_bswarm->bd_var_.recv[nb.targetid].extent(0)) {
+        ptarget_bswarm->bd_var_.recv[nb.targetid] =
+            BufArray1D<Real>("Buffer", (bd_var_.send[nb.bufid].extent(0)));
       }
+
+      target_block.deep_copy(ptarget_bswarm->bd_var_.recv[nb.targetid],
+                             bd_var_.send[nb.bufid]);
+      ptarget_bswarm->recv_size[nb.targetid] = send_size[nb.bufid];
+      ptarget_bswarm->bd_var_.flag[nb.targetid] = BoundaryStatus::arrived;
+    } else {
+      ptarget_bswarm->recv_size[nb.targetid] = 0;
+      ptarget_bswarm->bd_var_.flag[nb.targetid] = BoundaryStatus::completed;
     }
   }
 }
@@ -24,6 +24,7 @@
 #include "basic_types.hpp"
 #include "bvals/bvals_interfaces.hpp"
 #include "bvals/comms/bnd_info.hpp"
+#include "bvals/comms/comm_encoding.hpp"
 #include "config.hpp"
 #include "globals.hpp"
 #include "interface/state_descriptor.hpp"
@@ -77,9 +78,19 @@ void ProResCache_t::RegisterRegionHost(int region, ProResInfo pri, Variable<Real
   }
 }
 
+int GetCommGhostWidth(MeshBlock *pmb, const std::shared_ptr<Variable<Real>> &v) {
+  const int width = v->metadata().GetGhostWidth();
+  const auto *pmesh = pmb->pmy_mesh;
+  if (width == 0 || pmesh->multilevel || pmesh->multigrid) return Globals::nghost;
+  return std::min(width, Globals::nghost);
+}
+
+// ghost_width is the number of ghost layers exchanged across boundaries to same level
+// neighbors, see GetCommGhostWidth
 SpatiallyMaskedIndexer6D CalcIndices(const NeighborBlock &nb, MeshBlock *pmb,
                                      TopologicalElement el, IndexRangeType ir_type,
-                                     bool prores, std::array<int, 3> tensor_shape) {
+                                     bool prores, std::array<int, 3> tensor_shape,
+                                     const int ghost_width = Globals::nghost) {
   const auto &ni = nb.ni;
   const auto &loc = pmb->loc;
   auto shape = pmb->cellbounds;
@@ -116,10 +127,9 @@ SpatiallyMaskedIndexer6D CalcIndices(const NeighborBlock &nb, MeshBlock *pmb,
                                 TopologicalOffsetK(el)};
   std::array<int, 3> block_offset = {ni.ox1, ni.ox2, ni.ox3};
 
-  int interior_offset =
-      ir_type == IndexRangeType::BoundaryInteriorSend ? Globals::nghost : 0;
-  int exterior_offset =
-      ir_type == IndexRangeType::BoundaryExteriorRecv ? Globals::nghost : 0;
+  const int nghost = nb.loc.level() == loc.level() ? ghost_width : Globals::nghost;
+  int interior_offset = ir_type == IndexRangeType::BoundaryInteriorSend ? nghost : 0;
+  int exterior_offset = ir_type == IndexRangeType::BoundaryExteriorRecv ? nghost : 0;
   if (prores) {
     // The coarse ghosts cover twice as much volume as the fine ghosts, so when working in
     // the exterior (i.e. ghosts) we must only go over the coarse ghosts that have
@@ -214,12 +224,37 @@ int GetBufferSize(MeshBlock *pmb, const NeighborBlock &nb,
   const int isize = cb.ie(in) - cb.is(in) + 2;
   const int jsize = cb.je(in) - cb.js(in) + 2;
   const int ksize = cb.ke(in) - cb.ks(in) + 2;
-  return (nb.ni.ox1 == 0 ? isize : Globals::nghost + 1) *
-         (nb.ni.ox2 == 0 ? jsize : Globals::nghost + 1) *
-         (nb.ni.ox3 == 0 ? ksize : Globals::nghost + 1) * v->GetDim(6) * v->GetDim(5) *
+  const int nghost = GetCommGhostWidth(pmb, v);
+  return (nb.ni.ox1 == 0 ? isize : nghost + 1) * (nb.ni.ox2 == 0 ? jsize : nghost + 1) *
+         (nb.ni.ox3 == 0 ? ksize : nghost + 1) * v->GetDim(6) * v->GetDim(5) *
          v->GetDim(4) * topo_comp;
 }
 
+namespace {
+// Boundaries to other ranks of variables with Metadata::CompressedCommunication are
+// encoded, provided that actually makes the message smaller. Sender and receiver
+// come to the same conclusion since their buffers have the same layout.
+void SetEncoding(BndInfo &out, const NeighborBlock &nb,
+                 const std::shared_ptr<Variable<Real>> &v) {
+  if (nb.snb.rank == Globals::my_rank) return;
+  const auto &m = v->metadata();
+  if (m.GetCommEncoding() == CommEncoding::none) return;
+  int nvals = 0;
+  int nrows = 0;
+  for (int iel = 0; iel < out.ntopological_elements; ++iel) {
+    auto &idxer = out.idxer[iel];
+    const int Ni = idxer.template EndIdx<5>() - idxer.template StartIdx<5>() + 1;
+    nvals += idxer.size();
+    nrows += idxer.size() / Ni;
+  }
+  out.encoding = comm_encoding::Effective(m.GetCommEncoding(), nvals, nrows);
+  if (out.encoding == CommEncoding::none) return;
+  out.error_bound = m.GetCommErrorBound();
+  out.nrows = nrows;
+  out.message_size = comm_encoding::EncodedSize(out.encoding, nvals, nrows);
+}
+} // namespace
+
 BndInfo BndInfo::GetSendBndInfo(MeshBlock *pmb, const NeighborBlock &nb,
                                 std::shared_ptr<Variable<Real>> v,
                                 CommBuffer<buf_pool_t<Real>::owner_t> *buf) {
@@ -243,8 +278,10 @@ BndInfo BndInfo::GetSendBndInfo(MeshBlock *pmb, const NeighborBlock &nb,
     idx_range_type = IndexRangeType::InteriorSend;
   for (auto el : elements) {
     int idx = static_cast<int>(el) % 3;
-    out.idxer[idx] = CalcIndices(nb, pmb, el, idx_range_type, false, {Nt, Nu, Nv});
+    out.idxer[idx] = CalcIndices(nb, pmb, el, idx_range_type, false, {Nt, Nu, Nv},
+                                 GetCommGhostWidth(pmb, v));
   }
+  SetEncoding(out, nb, v);
   if (nb.snb.level < mylevel) {
     out.var = v->coarse_s.Get();
   } else {
@@ -282,8 +319,10 @@ BndInfo BndInfo::GetSetBndInfo(MeshBlock *pmb, const NeighborBlock &nb,
     idx_range_type = IndexRangeType::InteriorRecv;
   for (auto el : elements) {
     int idx = static_cast<int>(el) % 3;
-    out.idxer[idx] = CalcIndices(nb, pmb, el, idx_range_type, false, {Nt, Nu, Nv});
+    out.idxer[idx] = CalcIndices(nb, pmb, el, idx_range_type, false, {Nt, Nu, Nv},
+                                 GetCommGhostWidth(pmb, v));
   }
+  SetEncoding(out, nb, v);
   if (nb.snb.level < mylevel) {
     out.var = v->coarse_s.Get();
   } else {
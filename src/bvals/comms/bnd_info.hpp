@@ -53,9 +53,52 @@ struct BndInfo {
   ParArrayND<Real, VariableState> var; // data variable used for comms
   Coordinates_t coords;
 
+  // Boundary that is copied directly from the interior of the sending block (src_var
+  // indexed by src_idxer) into the ghost zones of the receiving block instead of going
+  // through buf, see IsZeroCopyBoundary
+  bool zero_copy = false;
+  SpatiallyMaskedIndexer6D src_idxer[3];
+  ParArrayND<Real, VariableState> src_var;
+
+  // Encoding of the values in buf for boundaries across ranks (see comm_encoding.hpp),
+  // the number of rows (runs of cells in the i direction) in the buffer and the number
+  // of elements of buf that are sent, -1 for all
+  CommEncoding encoding = CommEncoding::none;
+  Real error_bound = 0.0;
+  int nrows = 0;
+  int message_size = -1;
+
   BndInfo() = default;
   BndInfo(const BndInfo &) = default;
 
+  // The rows (runs of cells in the i direction) of the topological elements, e.g., the
+  // three faces of a Metadata::Face variable, are stored one element after the other in
+  // buf.  The kernels loop over the rows of all elements at once, so the threads of a
+  // team are not idle while the rows of a small element are handled, and FindRow maps
+  // row r of all of them to its element iel, the row idx within it, and the offset of
+  // the element in buf.
+  KOKKOS_INLINE_FUNCTION int RowLength(const int iel) const {
+    return idxer[iel].template EndIdx<5>() - idxer[iel].template StartIdx<5>() + 1;
+  }
+  KOKKOS_INLINE_FUNCTION int NumRows() const {
+    int n = 0;
+    for (int iel = 0; iel < ntopological_elements; ++iel) {
+      if (idxer[iel].size() > 0) n += idxer[iel].size() / RowLength(iel);
+    }
+    return n;
+  }
+  KOKKOS_INLINE_FUNCTION void FindRow(const int r, int &iel, int &idx,
+                                      int &offset) const {
+    idx = r;
+    offset = 0;
+    for (iel = 0; iel < ntopological_elements - 1; ++iel) {
+      const int n = idxer[iel].size() > 0 ? idxer[iel].size() / RowLength(iel) : 0;
+      if (idx < n) return;
+      idx -= n;
+      offset += idxer[iel].size();
+    }
+  }
+
   // These are are used to generate the BndInfo struct for various
   // kinds of boundary types and operations.
   static BndInfo GetSendBndInfo(MeshBlock *pmb, const NeighborBlock &nb,
@@ -107,6 +150,11 @@ struct ProResInfo {
 
 int GetBufferSize(MeshBlock *pmb, const NeighborBlock &nb,
                   std::shared_ptr<Variable<Real>> v);
+// Number of ghost layers of v that are exchanged between blocks, i.e., its
+// Metadata::GetGhostWidth (capped at Globals::nghost) on meshes without refinement.
+// Prolongation and restriction rely on all ghost layers, so multilevel meshes always
+// exchange Globals::nghost of them.
+int GetCommGhostWidth(MeshBlock *pmb, const std::shared_ptr<Variable<Real>> &v);
 
 using BndInfoArr_t = ParArray1D<BndInfo>;
 using BndInfoArrHost_t = typename BndInfoArr_t::HostMirror;
@@ -120,6 +168,8 @@ struct ProResCache_t {
   std::vector<std::size_t> buffer_subset_sizes;
   ParArray2D<std::size_t> buffer_subsets{};
   ParArray2D<std::size_t>::host_mirror_type buffer_subsets_h{};
+  // Execution space instance the prolongation/restriction kernels are launched on
+  DevExecSpace exec_space = DevExecSpace();
 
   void clear() {
     prores_info = ProResInfoArr_t{};
@@ -159,6 +209,8 @@ struct BvarsSubCache_t {
 
   std::vector<std::size_t> idx_vec;
   std::vector<CommBuffer<buf_pool_t<Real>::owner_t> *> buf_vec;
+  // scratch space for receiving all of buf_vec at once
+  CommReceiveBatch recv_batch;
   ParArray1D<bool> sending_non_zero_flags;
   // Cache both host and device buffer info. Reduces mallocs, and
   // also means the bounds values are available on host if needed.
@@ -166,6 +218,15 @@ struct BvarsSubCache_t {
 
   BndInfoArr_t bnd_info{};
   BndInfoArr_t::host_mirror_type bnd_info_h{};
+
+  // Execution space instance the packing/unpacking kernels of these boundaries are
+  // launched on. Before buffers are handed to (or returned from) MPI only this
+  // instance is fenced, so unrelated work on other instances is not waited for.
+  DevExecSpace exec_space = DevExecSpace();
+  // True if the MeshData on this rank launch their kernels on more than one instance
+  // (see Mesh::GetExecSpace), in which case buffers that stay on this rank also have to
+  // wait for the fence, since their other end may be processed on another instance
+  bool concurrent_instances = false;
 };
 
 struct BvarsCache_t {
@@ -16,19 +16,23 @@
 //========================================================================================
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream> // debug
 #include <memory>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "bnd_info.hpp"
 #include "bvals/boundary_conditions.hpp"
 #include "bvals_in_one.hpp"
 #include "bvals_utils.hpp"
+#include "comm_encoding.hpp"
 #include "config.hpp"
 #include "globals.hpp"
 #include "interface/variable.hpp"
+#include "interface/variable_pool.hpp"
 #include "kokkos_abstraction.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/mesh_refinement.hpp"
@@ -38,6 +42,7 @@
 #include "tasks/tasks.hpp"
 #include "utils/error_checking.hpp"
 #include "utils/loop_utils.hpp"
+#include "utils/phase_times.hpp"
 
 namespace parthenon {
 
@@ -47,6 +52,7 @@ using namespace loops::shorthands;
 template <BoundaryType bound_type>
 TaskStatus SendBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
 
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(bound_type, true);
@@ -67,8 +73,14 @@ TaskStatus SendBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
 
   if (rebuild) {
     if constexpr (bound_type == BoundaryType::gmg_restrict_send) {
-      RebuildBufferCache<bound_type, true>(md, nbound, BndInfo::GetSendBndInfo,
-                                           ProResInfo::GetInteriorRestrict);
+      // The coarse data of variables with Metadata::GMGUserRestrict has been filled
+      // before sending, e.g., by a kernel that computes and restricts a residual
+      RebuildBufferCache<bound_type, true>(
+          md, nbound, BndInfo::GetSendBndInfo,
+          [](MeshBlock *pmb, const NeighborBlock &nb, std::shared_ptr<Variable<Real>> v) {
+            if (v->IsSet(Metadata::GMGUserRestrict)) return ProResInfo();
+            return ProResInfo::GetInteriorRestrict(pmb, nb, v);
+          });
     } else if constexpr (bound_type == BoundaryType::gmg_prolongate_send) {
       RebuildBufferCache<bound_type, true>(md, nbound, BndInfo::GetSendBndInfo,
                                            ProResInfo::GetNull);
@@ -77,11 +89,30 @@ TaskStatus SendBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
                                            ProResInfo::GetSend);
     }
   }
-  // Restrict
+  // Restrict, unless the restriction can be done by the teams of the packing kernel
+  // right before they load their buffer, which saves the launches of Restrict
   auto pmb = md->GetBlockData(0)->GetBlockPointer();
   StateDescriptor *resolved_packages = pmb->resolved_packages.get();
-  refinement::Restrict(resolved_packages, cache.prores_cache, pmb->cellbounds,
-                       pmb->c_cellbounds);
+  constexpr bool ghost_exchange = bound_type == BoundaryType::any ||
+                                   bound_type == BoundaryType::local ||
+                                   bound_type == BoundaryType::nonlocal;
+  const bool fuse_restriction =
+      ghost_exchange && Globals::comm_config.fuse_restriction &&
+      refinement::RestrictsByAverage(resolved_packages, cache.prores_cache);
+  if (!fuse_restriction)
+    refinement::Restrict(resolved_packages, cache.prores_cache, pmb->cellbounds,
+                         pmb->c_cellbounds);
+  auto &prores_info = cache.prores_cache.prores_info;
+  const int ndim = pmb->cellbounds.ncellsk(IndexDomain::entire) > 1   ? 3
+                   : pmb->cellbounds.ncellsj(IndexDomain::entire) > 1 ? 2
+                                                                      : 1;
+  const IndexDomain interior = IndexDomain::interior;
+  const auto ckb = pmb->c_cellbounds.GetBoundsK(interior);
+  const auto cjb = pmb->c_cellbounds.GetBoundsJ(interior);
+  const auto cib = pmb->c_cellbounds.GetBoundsI(interior);
+  const auto kb = pmb->cellbounds.GetBoundsK(interior);
+  const auto jb = pmb->cellbounds.GetBoundsJ(interior);
+  const auto ib = pmb->cellbounds.GetBoundsI(interior);
 
   // Load buffer data
   auto &bnd_info = cache.bnd_info;
@@ -91,61 +122,90 @@ TaskStatus SendBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
 
   Kokkos::parallel_for(
       PARTHENON_AUTO_LABEL,
-      Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), nbound, Kokkos::AUTO),
+      Kokkos::TeamPolicy<>(cache.exec_space, nbound, Kokkos::AUTO),
       KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
         const int b = team_member.league_rank();
 
+        // The coarse cells restricted for buffer b are exactly the ones it loads
+        if (fuse_restriction && refinement::loops::DoRefinementOp(
+                                    prores_info(b), RefinementOp_t::Restriction)) {
+          refinement::loops::TeamProlongationRestriction<refinement_ops::RestrictAverage>(
+              ndim, team_member, b, prores_info, ckb, cjb, cib, kb, jb, ib);
+          team_member.team_barrier();
+        }
+
         if (!bnd_info(b).allocated) {
           Kokkos::single(Kokkos::PerTeam(team_member),
                          [&]() { sending_nonzero_flags(b) = false; });
           return;
         }
+        // copied directly into the receiving block in SetBounds
+        if (bnd_info(b).zero_copy) {
+          Kokkos::single(Kokkos::PerTeam(team_member),
+                         [&]() { sending_nonzero_flags(b) = true; });
+          return;
+        }
         Real threshold = bnd_info(b).var.allocation_threshold;
-        bool non_zero[3]{false, false, false};
-        int idx_offset = 0;
-        for (int iel = 0; iel < bnd_info(b).ntopological_elements; ++iel) {
-          auto &idxer = bnd_info(b).idxer[iel];
-          const int Ni = idxer.template EndIdx<5>() - idxer.template StartIdx<5>() + 1;
-          Kokkos::parallel_reduce(
-              Kokkos::TeamThreadRange<>(team_member, idxer.size() / Ni),
-              [&](const int idx, bool &lnon_zero) {
-                const auto [t, u, v, k, j, i] = idxer(idx * Ni);
-                Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
-                Real *buf = &bnd_info(b).buf(idx * Ni + idx_offset);
-
+        const CommEncoding encoding = bnd_info(b).encoding;
+        bool non_zero = false;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange<>(team_member, bnd_info(b).NumRows()),
+            [&](const int row, bool &lnon_zero) {
+              int iel, idx, offset;
+              bnd_info(b).FindRow(row, iel, idx, offset);
+              const int Ni = bnd_info(b).RowLength(iel);
+              const auto [t, u, v, k, j, i] = bnd_info(b).idxer[iel](idx * Ni);
+              Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
+              if (encoding == CommEncoding::none) {
+                Real *buf = &bnd_info(b).buf(idx * Ni + offset);
                 Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
                                      [&](int m) { buf[m] = var[m]; });
-
-                bool mnon_zero = false;
-                Kokkos::parallel_reduce(
-                    Kokkos::ThreadVectorRange<>(team_member, Ni),
-                    [&](int m, bool &llnon_zero) {
-                      llnon_zero = llnon_zero || (std::abs(buf[m]) >= threshold);
-                    },
-                    Kokkos::LOr<bool, parthenon::DevMemSpace>(mnon_zero));
-
-                lnon_zero = lnon_zero || mnon_zero;
-              },
-              Kokkos::LOr<bool, parthenon::DevMemSpace>(non_zero[iel]));
-          idx_offset += idxer.size();
-        }
-        Kokkos::single(Kokkos::PerTeam(team_member), [&]() {
-          sending_nonzero_flags(b) = non_zero[0] || non_zero[1] || non_zero[2];
-        });
+              } else {
+                comm_encoding::EncodeRow(team_member, encoding, bnd_info(b).error_bound,
+                                         var, &bnd_info(b).buf(0), bnd_info(b).nrows, row,
+                                         idx * Ni + offset, Ni);
+              }
+
+              bool mnon_zero = false;
+              Kokkos::parallel_reduce(
+                  Kokkos::ThreadVectorRange<>(team_member, Ni),
+                  [&](int m, bool &llnon_zero) {
+                    llnon_zero = llnon_zero || (std::abs(var[m]) >= threshold);
+                  },
+                  Kokkos::LOr<bool, parthenon::DevMemSpace>(mnon_zero));
+
+              lnon_zero = lnon_zero || mnon_zero;
+            },
+            Kokkos::LOr<bool, parthenon::DevMemSpace>(non_zero));
+        Kokkos::single(Kokkos::PerTeam(team_member),
+                       [&]() { sending_nonzero_flags(b) = non_zero; });
       });
 
   // Send buffers
-  if (Globals::sparse_config.enabled)
-    Kokkos::deep_copy(sending_nonzero_flags_h, sending_nonzero_flags);
+  if (Globals::sparse_config.enabled) {
+    Kokkos::deep_copy(cache.exec_space, sending_nonzero_flags_h, sending_nonzero_flags);
+    cache.exec_space.fence();
+  }
+  bool fence = cache.concurrent_instances;
 #ifdef MPI_PARALLEL
-  if (bound_type == BoundaryType::any || bound_type == BoundaryType::nonlocal)
-    Kokkos::fence();
+  fence =
+      fence || bound_type == BoundaryType::any || bound_type == BoundaryType::nonlocal;
+  // copy the messages of all buffers staged in host memory at once before the fence
+  if (Globals::comm_config.host_staging) {
+    for (std::size_t ibuf = 0; ibuf < cache.buf_vec.size(); ++ibuf) {
+      if (sending_nonzero_flags_h(ibuf) || !Globals::sparse_config.enabled)
+        cache.buf_vec[ibuf]->StageForSend(cache.exec_space,
+                                          cache.bnd_info_h(ibuf).message_size);
+    }
+    fence = true;
+  }
 #endif
+  if (fence) cache.exec_space.fence();
 
-  for (int ibuf = 0; ibuf < cache.buf_vec.size(); ++ibuf) {
+  for (std::size_t ibuf = 0; ibuf < cache.buf_vec.size(); ++ibuf) {
     auto &buf = *cache.buf_vec[ibuf];
     if (sending_nonzero_flags_h(ibuf) || !Globals::sparse_config.enabled)
-      buf.Send();
+      buf.Send(cache.bnd_info_h(ibuf).message_size);
     else
       buf.SendNull();
   }
@@ -165,6 +225,7 @@ SendBoundBufs<BoundaryType::gmg_prolongate_send>(std::shared_ptr<MeshData<Real>>
 template <BoundaryType bound_type>
 TaskStatus StartReceiveBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(bound_type, false);
   if (cache.buf_vec.size() == 0)
@@ -191,6 +252,7 @@ template TaskStatus StartReceiveBoundBufs<BoundaryType::gmg_prolongate_recv>(
 template <BoundaryType bound_type>
 TaskStatus ReceiveBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
 
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(bound_type, false);
@@ -198,13 +260,14 @@ TaskStatus ReceiveBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
     InitializeBufferCache<bound_type>(md, &(pmesh->boundary_comm_map), &cache, ReceiveKey,
                                       false);
 
-  bool all_received = true;
-  std::for_each(
-      std::begin(cache.buf_vec), std::end(cache.buf_vec),
-      [&all_received](auto pbuf) { all_received = pbuf->TryReceive() && all_received; });
+  const bool all_received = CommBuffer<buf_pool_t<Real>::owner_t>::TryReceiveAll(
+      cache.buf_vec, &cache.recv_batch);
 
   int ibound = 0;
   if (Globals::sparse_config.enabled) {
+    // Collect the variables to allocate over the whole partition first, so that the
+    // memory of all of them can be taken from the pool (if any) and zeroed in one batch
+    std::vector<std::pair<MeshBlock *, sp_cv_t>> to_allocate;
     ForEachBoundary<bound_type>(
         md, [&](auto pmb, sp_mbd_t rc, nb_t &nb, const sp_cv_t v) {
           const std::size_t ibuf = cache.idx_vec[ibound];
@@ -214,12 +277,20 @@ TaskStatus ReceiveBoundBufs(std::shared_ptr<MeshData<Real>> &md) {
           // (the state could also be BufferState::received_null, which corresponds to no
           // data)
           if (buf.GetState() == BufferState::received && !v->IsAllocated()) {
-            constexpr bool flag_uninitialized = true;
-            constexpr bool only_control = true;
-            pmb->AllocateSparse(v->label(), only_control, flag_uninitialized);
+            to_allocate.emplace_back(pmb, v);
           }
           ++ibound;
         });
+    if (to_allocate.size() > 0) {
+      VariableMemoryPool<Real>::Batch batch(pmesh->variable_pool);
+      for (auto &[pmb, v] : to_allocate) {
+        // the same variable shows up once for each of its boundaries
+        if (v->IsAllocated()) continue;
+        constexpr bool flag_uninitialized = true;
+        constexpr bool only_control = true;
+        pmb->AllocateSparse(v->label(), only_control, flag_uninitialized);
+      }
+    }
   }
   if (all_received) return TaskStatus::complete;
   return TaskStatus::incomplete;
@@ -239,6 +310,7 @@ ReceiveBoundBufs<BoundaryType::gmg_prolongate_recv>(std::shared_ptr<MeshData<Rea
 template <BoundaryType bound_type>
 TaskStatus SetBounds(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
 
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(bound_type, false);
@@ -257,57 +329,72 @@ TaskStatus SetBounds(std::shared_ptr<MeshData<Real>> &md) {
                                             ProResInfo::GetSet);
     }
   }
+  // messages received in host memory are copied to their buffers ahead of the kernel
+  if (Globals::comm_config.host_staging) {
+    for (auto *pbuf : cache.buf_vec)
+      pbuf->Unstage(cache.exec_space);
+  }
   // const Real threshold = Globals::sparse_config.allocation_threshold;
   auto &bnd_info = cache.bnd_info;
   Kokkos::parallel_for(
       PARTHENON_AUTO_LABEL,
-      Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), nbound, Kokkos::AUTO),
+      Kokkos::TeamPolicy<>(cache.exec_space, nbound, Kokkos::AUTO),
       KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
         const int b = team_member.league_rank();
-        int idx_offset = 0;
-        for (int iel = 0; iel < bnd_info(b).ntopological_elements; ++iel) {
-          auto &idxer = bnd_info(b).idxer[iel];
-          const int Ni = idxer.template EndIdx<5>() - idxer.template StartIdx<5>() + 1;
-          if (bnd_info(b).buf_allocated && bnd_info(b).allocated) {
-            Kokkos::parallel_for(
-                Kokkos::TeamThreadRange<>(team_member, idxer.size() / Ni),
-                [&](const int idx) {
-                  const auto [t, u, v, k, j, i] = idxer(idx * Ni);
-                  Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
-                  Real *buf = &bnd_info(b).buf(idx * Ni + idx_offset);
-                  // Have to do this because of some weird issue about structure bindings
-                  // being captured
-                  const int kk = k;
-                  const int jj = j;
-                  const int ii = i;
-                  Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
-                                       [&](int m) {
-                                         if (idxer.IsActive(kk, jj, ii + m))
-                                           var[m] = buf[m];
-                                       });
-                });
-          } else if (bnd_info(b).allocated) {
-            const Real default_val = bnd_info(b).var.sparse_default_val;
-            Kokkos::parallel_for(
-                Kokkos::TeamThreadRange<>(team_member, idxer.size() / Ni),
-                [&](const int idx) {
-                  const auto [t, u, v, k, j, i] = idxer(idx * Ni);
-                  Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
-                  const int kk = k;
-                  const int jj = j;
-                  const int ii = i;
-                  Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
-                                       [&](int m) {
-                                         if (idxer.IsActive(kk, jj, ii + m))
-                                           var[m] = default_val;
-                                       });
-                });
-          }
-          idx_offset += idxer.size();
-        }
+        const CommEncoding encoding = bnd_info(b).encoding;
+        const int nrows = bnd_info(b).nrows;
+        if (!bnd_info(b).allocated) return;
+        // the same for all rows of the boundary, so the threads of a team do not diverge
+        const bool buf_allocated = bnd_info(b).buf_allocated;
+        const bool zero_copy = bnd_info(b).zero_copy;
+        const Real default_val = bnd_info(b).var.sparse_default_val;
+        const Real *msg = buf_allocated ? &bnd_info(b).buf(0) : nullptr;
+        Kokkos::parallel_for(
+            Kokkos::TeamThreadRange<>(team_member, bnd_info(b).NumRows()),
+            [&](const int row) {
+              int iel, idx, offset;
+              bnd_info(b).FindRow(row, iel, idx, offset);
+              auto &idxer = bnd_info(b).idxer[iel];
+              const int Ni = bnd_info(b).RowLength(iel);
+              const auto [t, u, v, k, j, i] = idxer(idx * Ni);
+              Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
+              // Have to do this because of some weird issue about structure bindings
+              // being captured
+              const int kk = k;
+              const int jj = j;
+              const int ii = i;
+              const int e0 = idx * Ni + offset;
+              if (buf_allocated && encoding != CommEncoding::none) {
+                Kokkos::parallel_for(
+                    Kokkos::ThreadVectorRange<>(team_member, Ni), [&](int m) {
+                      if (idxer.IsActive(kk, jj, ii + m))
+                        var[m] = comm_encoding::Decode(encoding, msg, nrows, row, e0 + m);
+                    });
+              } else if (buf_allocated) {
+                const Real *buf = msg + e0;
+                if (zero_copy) {
+                  const auto [st, su, sv, sk, sj, si] =
+                      bnd_info(b).src_idxer[iel](idx * Ni);
+                  buf = &bnd_info(b).src_var(iel, st, su, sv, sk, sj, si);
+                }
+                Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
+                                     [&](int m) {
+                                       if (idxer.IsActive(kk, jj, ii + m))
+                                         var[m] = buf[m];
+                                     });
+              } else {
+                Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
+                                     [&](int m) {
+                                       if (idxer.IsActive(kk, jj, ii + m))
+                                         var[m] = default_val;
+                                     });
+              }
+            });
       });
 #ifdef MPI_PARALLEL
-  Kokkos::fence();
+  cache.exec_space.fence();
+#else
+  if (cache.concurrent_instances) cache.exec_space.fence();
 #endif
   std::for_each(std::begin(cache.buf_vec), std::end(cache.buf_vec),
                 [](auto pbuf) { pbuf->Stale(); });
@@ -402,7 +489,8 @@ TaskID AddBoundaryExchangeTasks(TaskID dependency, TaskList &tl,
 
   // auto out = (pro_local | pro);
 
-  auto send = tl.AddTask(dependency, SendBoundBufs<bounds>, md);
+  // sends are on the critical path of other ranks, so get them out first
+  auto send = tl.AddTask(TaskQualifier::priority, dependency, SendBoundBufs<bounds>, md);
   auto recv = tl.AddTask(dependency, ReceiveBoundBufs<bounds>, md);
   auto set = tl.AddTask(recv, SetBounds<bounds>, md);
 
@@ -422,4 +510,23 @@ AddBoundaryExchangeTasks<BoundaryType::any>(TaskID, TaskList &,
 template TaskID
 AddBoundaryExchangeTasks<BoundaryType::gmg_same>(TaskID, TaskList &,
                                                  std::shared_ptr<MeshData<Real>> &, bool);
+
+template <BoundaryType bounds>
+TaskID AddBoundaryExchangeTasks(TaskID dependency, TaskList &tl,
+                                std::shared_ptr<MeshData<Real>> &md, bool multilevel,
+                                const std::vector<std::string> &fields) {
+  const auto &config = Globals::comm_config;
+  PARTHENON_REQUIRE_THROWS(!config.coalesce_messages && !config.neighborhood_comm &&
+                               !config.shared_memory_comm && !config.rma_comm,
+                           "Exchanging a subset of the variables requires individual "
+                           "boundary messages.");
+  return AddBoundaryExchangeTasks<bounds>(dependency, tl, md->GetSubset(fields),
+                                          multilevel);
+}
+template TaskID AddBoundaryExchangeTasks<BoundaryType::any>(
+    TaskID, TaskList &, std::shared_ptr<MeshData<Real>> &, bool,
+    const std::vector<std::string> &);
+template TaskID AddBoundaryExchangeTasks<BoundaryType::gmg_same>(
+    TaskID, TaskList &, std::shared_ptr<MeshData<Real>> &, bool,
+    const std::vector<std::string> &);
 } // namespace parthenon
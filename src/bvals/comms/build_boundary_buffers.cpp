@@ -33,6 +33,7 @@
 #include "mesh/meshblock.hpp"
 #include "utils/error_checking.hpp"
 #include "utils/loop_utils.hpp"
+#include "utils/nan_payload_tag.hpp"
 
 namespace parthenon {
 
@@ -40,6 +41,19 @@ using namespace loops;
 using namespace loops::shorthands;
 
 namespace {
+// Buffers are taken from pools of size classes rather than of exact sizes, so that the
+// slightly different buffer sizes that come and go with remeshing share (and reuse)
+// the same memory.  The classes are the multiples of a quarter of the largest power of
+// two not larger than the size, so at most a fifth of an object goes unused.
+int BufferSizeClass(const int size) {
+  int pow2 = 1;
+  while (2 * pow2 <= size) {
+    pow2 *= 2;
+  }
+  const int quarter = std::max(pow2 / 4, 1);
+  return (size + quarter - 1) / quarter * quarter;
+}
+
 template <BoundaryType BTYPE>
 void BuildBoundaryBufferSubset(std::shared_ptr<MeshData<Real>> &md,
                                Mesh::comm_buf_map_t &buf_map) {
@@ -48,20 +62,24 @@ void BuildBoundaryBufferSubset(std::shared_ptr<MeshData<Real>> &md,
     // Calculate the required size of the buffer for this boundary
     int buf_size = GetBufferSize(pmb, nb, v);
 
-    // Add a buffer pool if one does not exist for this size
-    if (pmesh->pool_map.count(buf_size) == 0) {
-      pmesh->pool_map.emplace(std::make_pair(
-          buf_size, buf_pool_t<Real>([buf_size](buf_pool_t<Real> *pool) {
-            using buf_t = buf_pool_t<Real>::base_t;
-            // TODO(LFR): Make nbuf a user settable parameter
-            const int nbuf = 200;
-            buf_t chunk("pool buffer", buf_size * nbuf);
-            for (int i = 1; i < nbuf; ++i) {
-              pool->AddFreeObjectToPool(
-                  buf_t(chunk, std::make_pair(i * buf_size, (i + 1) * buf_size)));
-            }
-            return buf_t(chunk, std::make_pair(0, buf_size));
-          })));
+    // Add a buffer pool if one does not exist for this size class
+    const int size_class = BufferSizeClass(buf_size);
+    if (pmesh->pool_map.count(size_class) == 0) {
+      pmesh->pool_map.try_emplace(size_class, [size_class](buf_pool_t<Real> *pool) {
+        using buf_t = buf_pool_t<Real>::base_t;
+        // TODO(LFR): Make nbuf a user settable parameter
+        const int nbuf = 200;
+        // buffers are always filled before they are read, by the kernels loading them or
+        // by MPI
+        buf_t chunk(Kokkos::view_alloc(Kokkos::WithoutInitializing, "pool buffer"),
+                    size_class * nbuf);
+        FillUninitialized(chunk);
+        for (int i = 1; i < nbuf; ++i) {
+          pool->AddFreeObjectToPool(
+              buf_t(chunk, std::make_pair(i * size_class, (i + 1) * size_class)));
+        }
+        return buf_t(chunk, std::make_pair(0, size_class));
+      });
     }
 
     const int receiver_rank = nb.snb.rank;
@@ -70,7 +88,7 @@ void BuildBoundaryBufferSubset(std::shared_ptr<MeshData<Real>> &md,
     int tag = 0;
 #ifdef MPI_PARALLEL
     // Get a bi-directional mpi tag for this pair of blocks
-    tag = pmesh->tag_map.GetTag(pmb, nb);
+    tag = pmesh->tag_map.GetTag(pmb, nb, pmesh->GetMPICommSlot(v->label()));
     auto comm_label = v->label();
     if constexpr (BTYPE == BoundaryType::flxcor_send ||
                   BTYPE == BoundaryType::flxcor_recv)
@@ -83,27 +101,46 @@ void BuildBoundaryBufferSubset(std::shared_ptr<MeshData<Real>> &md,
 #endif
 
     bool use_sparse_buffers = v->IsSet(Metadata::Sparse);
-    auto get_resource_method = [pmesh, buf_size]() {
-      return buf_pool_t<Real>::owner_t(pmesh->pool_map.at(buf_size).Get());
+    auto get_resource_method = [pmesh, buf_size, size_class]() {
+      buf_pool_t<Real>::owner_t buf(pmesh->pool_map.at(size_class).Get());
+      // the buffer only covers the first buf_size elements of the object, the pool
+      // keeps track of (and takes back) the whole object
+      static_cast<buf_pool_t<Real>::weak_t &>(buf) =
+          buf_pool_t<Real>::base_t(buf, std::make_pair(0, buf_size));
+      return buf;
     };
+    // Buffers of sparse variables are freed and reallocated, so they would have to
+    // reinitialize their persistent requests all the time
+    const bool use_persistent_requests =
+        Globals::comm_config.persistent_requests && !use_sparse_buffers;
+    const bool host_staging =
+        Globals::comm_config.host_staging && sender_rank != receiver_rank;
 
     // Build send buffer (unless this is a receiving flux boundary)
     if constexpr (IsSender(BTYPE)) {
       auto s_key = SendKey(pmb, nb, v);
-      if (buf_map.count(s_key) == 0)
+      if (buf_map.count(s_key) == 0) {
         buf_map[s_key] = CommBuffer<buf_pool_t<Real>::owner_t>(
             tag, sender_rank, receiver_rank, comm, get_resource_method,
             use_sparse_buffers);
+        if (use_persistent_requests) buf_map[s_key].UsePersistentRequests();
+        if (host_staging) buf_map[s_key].UseHostStaging();
+        buf_map[s_key].CountAs(BTYPE);
+      }
     }
 
     // Also build the non-local receive buffers here
     if constexpr (IsReceiver(BTYPE)) {
       if (sender_rank != receiver_rank) {
         auto r_key = ReceiveKey(pmb, nb, v);
-        if (buf_map.count(r_key) == 0)
+        if (buf_map.count(r_key) == 0) {
           buf_map[r_key] = CommBuffer<buf_pool_t<Real>::owner_t>(
               tag, receiver_rank, sender_rank, comm, get_resource_method,
               use_sparse_buffers);
+          if (use_persistent_requests) buf_map[r_key].UsePersistentRequests();
+          if (host_staging) buf_map[r_key].UseHostStaging();
+          buf_map[r_key].CountAs(BTYPE);
+        }
       }
     }
   });
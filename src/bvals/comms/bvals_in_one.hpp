@@ -75,9 +75,31 @@ TaskStatus SetFluxCorrections(std::shared_ptr<MeshData<Real>> &md);
 template <BoundaryType bounds = BoundaryType::any>
 TaskID AddBoundaryExchangeTasks(TaskID dependency, TaskList &tl,
                                 std::shared_ptr<MeshData<Real>> &md, bool multilevel);
+// Only exchanges the variables of md in fields, e.g., those a stage will read, on the
+// shallow copy MeshData::GetSubset(fields) with its own buffer caches.  Since the other
+// variables are not sent, this can't be combined with the grouped messages of the
+// <parthenon/comms> options (coalesce_messages etc.).
+template <BoundaryType bounds = BoundaryType::any>
+TaskID AddBoundaryExchangeTasks(TaskID dependency, TaskList &tl,
+                                std::shared_ptr<MeshData<Real>> &md, bool multilevel,
+                                const std::vector<std::string> &fields);
+
+// Adds the flux correction tasks of md to a task list, starting the sends once
+// dependency is complete, and returns the task after which the fluxes are corrected.
+// Partitions without level jumps (see MeshData::HasLevelJumps) get no tasks at all and
+// dependency is returned.
+TaskID AddFluxCorrectionTasks(TaskID dependency, TaskList &tl,
+                              std::shared_ptr<MeshData<Real>> &md);
 
 // These tasks should not be called in down stream code
 TaskStatus BuildBoundaryBuffers(std::shared_ptr<MeshData<Real>> &md);
+// Once BuildBoundaryBuffers has been called for all MeshData, group the non-local
+// boundary buffers into shared memory messages with the ranks on the same node (see
+// shared_memory_comm.hpp), and the remaining ones into one message per rank pair,
+// which is sent (see coalesced_comm.hpp), put into an RMA window (see rma_comm.hpp) or
+// exchanged with all ranks by one neighborhood collective (see neighborhood_comm.hpp),
+// as requested
+void CoalesceBoundaryBuffers(Mesh *pmesh);
 TaskStatus BuildGMGBoundaryBuffers(std::shared_ptr<MeshData<Real>> &md);
 
 } // namespace parthenon
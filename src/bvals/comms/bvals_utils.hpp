@@ -22,11 +22,14 @@
 #include <random>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "bvals/comms/bnd_info.hpp"
 #include "bvals/comms/bvals_in_one.hpp"
+#include "bvals/comms/coalesced_comm.hpp"
+#include "globals.hpp"
 #include "interface/variable.hpp"
 #include "mesh/domain.hpp"
 #include "mesh/mesh.hpp"
@@ -67,6 +70,16 @@ ReceiveKey(const MeshBlock *pmb, const NeighborBlock &nb,
 // simple tests, this did not have a big impact on performance but I think it is useful to
 // leave the machinery here since it doesn't seem to have a big overhead associated with
 // it (LFR).
+//
+// The order is selected by Globals::comm_config.buffer_order:
+//   random:  shuffled differently in every run, which frighteningly seems to run faster
+//            in some cases
+//   natural: the ForEachBoundary order, i.e. all boundaries of a variable on a block
+//            are next to each other
+//   rank:    by the rank on the other end, then by key, which orders the sends and the
+//            receives of a pair of ranks identically
+//   morton:  by the Morton number of the local block, then in the natural order
+// All but random are reproducible.
 template <BoundaryType bound_type, class COMM_MAP, class F>
 void InitializeBufferCache(std::shared_ptr<MeshData<Real>> &md, COMM_MAP *comm_map,
                            BvarsSubCache_t *pcache, F KeyFunc, bool initialize_flags) {
@@ -76,6 +89,9 @@ void InitializeBufferCache(std::shared_ptr<MeshData<Real>> &md, COMM_MAP *comm_m
 
   using key_t = std::tuple<int, int, std::string, int>;
   std::vector<std::tuple<int, int, key_t>> key_order;
+  // rank on the other end and location of the local block of each boundary
+  std::vector<int> other_rank;
+  std::vector<LogicalLocation> block_loc;
 
   int boundary_idx = 0;
   ForEachBoundary<bound_type>(md, [&](auto pmb, sp_mbd_t rc, nb_t &nb, const sp_cv_t v) {
@@ -86,18 +102,35 @@ void InitializeBufferCache(std::shared_ptr<MeshData<Real>> &md, COMM_MAP *comm_m
     // tuple) and geometric element index (fourth element of the key tuple)
     int recvr_idx = 27 * std::get<1>(key) + std::get<3>(key);
     key_order.push_back({recvr_idx, boundary_idx, key});
+    other_rank.push_back(nb.snb.rank);
+    block_loc.push_back(pmb->loc);
     ++boundary_idx;
   });
 
-  // If desired, sort the keys and boundary indices by receiver_idx
-  // std::sort(key_order.begin(), key_order.end(),
-  //          [](auto a, auto b) { return std::get<0>(a) < std::get<0>(b); });
-
-  // Or, what the hell, you could put them in random order if you want, which
-  // frighteningly seems to run faster in some cases
-  std::random_device rd;
-  std::mt19937 g(rd());
-  std::shuffle(key_order.begin(), key_order.end(), g);
+  switch (Globals::comm_config.buffer_order) {
+  case Globals::BufferOrder::random: {
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::shuffle(key_order.begin(), key_order.end(), g);
+    break;
+  }
+  case Globals::BufferOrder::natural:
+    break;
+  case Globals::BufferOrder::rank:
+    std::sort(key_order.begin(), key_order.end(), [&](const auto &a, const auto &b) {
+      const int ra = other_rank[std::get<1>(a)];
+      const int rb = other_rank[std::get<1>(b)];
+      if (ra != rb) return ra < rb;
+      return std::get<2>(a) < std::get<2>(b);
+    });
+    break;
+  case Globals::BufferOrder::morton:
+    std::stable_sort(key_order.begin(), key_order.end(),
+                     [&](const auto &a, const auto &b) {
+                       return block_loc[std::get<1>(a)] < block_loc[std::get<1>(b)];
+                     });
+    break;
+  }
 
   int buff_idx = 0;
   pcache->buf_vec.clear();
@@ -108,6 +141,17 @@ void InitializeBufferCache(std::shared_ptr<MeshData<Real>> &md, COMM_MAP *comm_m
   });
 
   const int nbound = pcache->buf_vec.size();
+  const bool grouped = std::any_of(pcache->buf_vec.begin(), pcache->buf_vec.end(),
+                                   [](const auto *buf) { return buf->InGroup(); });
+  if (grouped) {
+    auto pmb = md->GetBlockData(0)->GetBlockPointer();
+    const int nvars = md->GetBlockData(0)->GetVariableVector().size();
+    const int nbase_vars = pmb->meshblock_data.Get()->GetVariableVector().size();
+    PARTHENON_REQUIRE(ExchangeCoversGroupMembers(bound_type, nvars, nbase_vars),
+                      "Coalesced boundary messages only support the ghost zone and flux "
+                      "correction exchanges of all variables, any other exchange would "
+                      "hang waiting for the members it doesn't send.");
+  }
   if (initialize_flags && nbound > 0) {
     if (nbound != pcache->sending_non_zero_flags.size()) {
       pcache->sending_non_zero_flags = ParArray1D<bool>("sending_nonzero_flags", nbound);
@@ -182,6 +226,55 @@ inline auto CheckReceiveBufferCacheForRebuild(std::shared_ptr<MeshData<Real>> md
   return std::make_tuple(rebuild, nbound);
 }
 
+// With Globals::comm_config.zero_copy_local, the ghost exchange of a dense variable
+// between two blocks of the same level that are both in md skips the intermediate
+// buffer. SendBoundBufs does not pack such a boundary and only marks its buffer as sent,
+// and SetBounds copies straight from the interior of the sending block into the ghost
+// zones. Requiring both blocks to be in md, and hence on the same task list, ensures the
+// sender does not update its interior before the receiver has copied from it. md_gids
+// maps the gids of the blocks in md to their index in md (see ZeroCopyBlockIndices).
+inline bool IsZeroCopyBoundary(const std::unordered_map<int, int> &md_gids,
+                               const MeshBlock *pmb, const NeighborBlock &nb,
+                               const std::shared_ptr<Variable<Real>> &v) {
+  return nb.snb.rank == Globals::my_rank && nb.snb.level == pmb->loc.level() &&
+         !v->IsSet(Metadata::Sparse) && md_gids.count(nb.snb.gid) > 0;
+}
+
+// The gids of the blocks in md mapped to their index in md, empty if zero copy local
+// boundaries are not enabled
+inline std::unordered_map<int, int>
+ZeroCopyBlockIndices(const std::shared_ptr<MeshData<Real>> &md) {
+  std::unordered_map<int, int> md_gids;
+  if (!Globals::comm_config.zero_copy_local) return md_gids;
+  for (int b = 0; b < md->NumBlocks(); ++b) {
+    md_gids[md->GetBlockData(b)->GetBlockPointer()->gid] = b;
+  }
+  return md_gids;
+}
+
+// Point the receiving zero copy boundary info at the interior of the sending block
+inline void SetZeroCopySource(const std::shared_ptr<MeshData<Real>> &md,
+                              const std::unordered_map<int, int> &md_gids,
+                              const MeshBlock *pmb, const NeighborBlock &nb,
+                              const std::shared_ptr<Variable<Real>> &v,
+                              CommBuffer<buf_pool_t<Real>::owner_t> *buf, BndInfo *info) {
+  auto &src_rc = md->GetBlockData(md_gids.at(nb.snb.gid));
+  MeshBlock *src_pmb = src_rc->GetBlockPointer();
+  for (auto &src_nb : src_pmb->neighbors) {
+    if (src_nb.snb.gid == pmb->gid && src_nb.ni.ox1 == -nb.ni.ox1 &&
+        src_nb.ni.ox2 == -nb.ni.ox2 && src_nb.ni.ox3 == -nb.ni.ox3) {
+      auto src =
+          BndInfo::GetSendBndInfo(src_pmb, src_nb, src_rc->GetVarPtr(v->label()), buf);
+      info->zero_copy = true;
+      info->src_var = src.var;
+      for (int i = 0; i < 3; ++i)
+        info->src_idxer[i] = src.idxer[i];
+      return;
+    }
+  }
+  PARTHENON_FAIL("Could not find the sending side of a zero copy boundary.");
+}
+
 using F_BND_INFO = std::function<BndInfo(MeshBlock *pmb, const NeighborBlock &nb,
                                          std::shared_ptr<Variable<Real>> v,
                                          CommBuffer<buf_pool_t<Real>::owner_t> *buf)>;
@@ -198,6 +291,9 @@ inline void RebuildBufferCache(std::shared_ptr<MeshData<Real>> md, int nbound,
   BvarsSubCache_t &cache = md->GetBvarsCache().GetSubCache(BOUND_TYPE, SENDER);
   cache.bnd_info = BndInfoArr_t("bnd_info", nbound);
   cache.bnd_info_h = Kokkos::create_mirror_view(cache.bnd_info);
+  cache.exec_space = md->GetExecSpace();
+  cache.prores_cache.exec_space = md->GetExecSpace();
+  cache.concurrent_instances = md->GetParentPointer()->NumExecSpaces() > 1;
 
   // prolongation/restriction sub-sets
   // TODO(JMM): Right now I exclude fluxcorrection boundaries but if
@@ -210,11 +306,26 @@ inline void RebuildBufferCache(std::shared_ptr<MeshData<Real>> md, int nbound,
     cache.prores_cache.Initialize(nbound, pkg);
   }
 
+  constexpr bool ghost_exchange =
+      BOUND_TYPE == BoundaryType::any || BOUND_TYPE == BoundaryType::local;
+  std::unordered_map<int, int> md_gids;
+  if constexpr (ghost_exchange) md_gids = ZeroCopyBlockIndices(md);
+
   int ibound = 0;
   ForEachBoundary<BOUND_TYPE>(md, [&](auto pmb, sp_mbd_t rc, nb_t &nb, const sp_cv_t v) {
     // bnd_info
     const std::size_t ibuf = cache.idx_vec[ibound];
     cache.bnd_info_h(ibuf) = BndInfoCreator(pmb, nb, v, cache.buf_vec[ibuf]);
+    if constexpr (ghost_exchange) {
+      if (IsZeroCopyBoundary(md_gids, pmb, nb, v)) {
+        if constexpr (SENDER) {
+          cache.bnd_info_h(ibuf).zero_copy = true;
+        } else {
+          SetZeroCopySource(md, md_gids, pmb, nb, v, cache.buf_vec[ibuf],
+                            &cache.bnd_info_h(ibuf));
+        }
+      }
+    }
 
     // subsets ordering is same as in cache.bnd_info
     // RefinementFunctions_t owns all relevant functionality, so
@@ -0,0 +1,372 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2023 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "bvals/comms/bnd_info.hpp"
+#include "bvals/comms/bvals_in_one.hpp"
+#include "bvals/comms/bvals_utils.hpp"
+#include "bvals/comms/coalesced_comm.hpp"
+#include "bvals/comms/neighborhood_comm.hpp"
+#include "bvals/comms/rma_comm.hpp"
+#include "bvals/comms/shared_memory_comm.hpp"
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/error_checking.hpp"
+#include "utils/loop_utils.hpp"
+
+namespace parthenon {
+
+CoalescedBoundaryMessage::CoalescedBoundaryMessage(
+    int other_rank, int tag, bool sender, mpi_comm_t comm,
+    const std::vector<std::pair<buf_t *, int>> &members)
+    : other_rank_(other_rank), tag_(tag), sender_(sender), comm_(comm),
+      compact_(Globals::comm_config.compact_messages),
+      segments_("coalesced segments", members.size()) {
+#ifdef MPI_PARALLEL
+  request_ = MPI_REQUEST_NULL;
+#endif
+  segments_h_ = Kokkos::create_mirror_view(segments_);
+  // the flags (or the bitmask) go first
+  const int nmask = (members.size() + mask_bits - 1) / mask_bits;
+  if (compact_) mask_h_ = Kokkos::View<Real *, HostMemSpace>("coalesced mask", nmask);
+  offsets_.push_back(compact_ ? nmask : members.size());
+  for (auto &[buf, size] : members) {
+    members_.push_back(buf);
+    sizes_.push_back(size);
+    offsets_.push_back(offsets_.back() + size);
+  }
+  message_ = BufArray1D<Real>("coalesced message", Size());
+  if (Globals::comm_config.host_staging) {
+    staged_message_ = Kokkos::View<Real *, HostPinnedMemSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "host staged coalesced message"),
+        Size());
+  }
+}
+
+Real *CoalescedBoundaryMessage::MessageData() {
+  return staged_message_.size() > 0 ? staged_message_.data() : message_.data();
+}
+
+CoalescedBoundaryMessage::~CoalescedBoundaryMessage() {
+#ifdef MPI_PARALLEL
+  int flag;
+  PARTHENON_MPI_CHECK(MPI_Test(&request_, &flag, MPI_STATUS_IGNORE));
+  if (!flag) {
+    if (!sender_) PARTHENON_MPI_CHECK(MPI_Cancel(&request_));
+    PARTHENON_MPI_CHECK(MPI_Wait(&request_, MPI_STATUS_IGNORE));
+  }
+#endif
+}
+
+void CoalescedBoundaryMessage::CopySegments(bool pack) {
+  const int nmembers = NumMembers();
+  // members fence the instances of their MeshData before they are sent, and the
+  // fence below comes before they are read (see BvarsSubCache_t)
+  auto exec_space = DevExecSpace();
+  Kokkos::deep_copy(exec_space, segments_, segments_h_);
+  auto segments = segments_;
+  auto message = message_;
+  // compact messages start with the bitmask, which is set on the host
+  const bool flags = pack && !compact_;
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL,
+      Kokkos::TeamPolicy<>(exec_space, nmembers, Kokkos::AUTO),
+      KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
+        const int b = team_member.league_rank();
+        const Segment &seg = segments(b);
+        if (flags) {
+          Kokkos::single(Kokkos::PerTeam(team_member),
+                         [&]() { message(b) = (seg.data == nullptr ? 0.0 : 1.0); });
+        }
+        if (seg.data == nullptr) return;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, seg.size),
+                             [&](const int i) {
+                               if (pack) {
+                                 message(seg.offset + i) = seg.data[i];
+                               } else {
+                                 seg.data[i] = message(seg.offset + i);
+                               }
+                             });
+      });
+  exec_space.fence();
+}
+
+void CoalescedBoundaryMessage::Send(int member) {
+  PARTHENON_DEBUG_REQUIRE(sender_, "Sending from a coalesced receive message.");
+  if (++nready_ < NumMembers()) return;
+#ifdef MPI_PARALLEL
+  for (int b = 0; b < NumMembers(); ++b) {
+    auto *buf = members_[b];
+    const bool null = (buf->GetState() == BufferState::sending_null);
+    PARTHENON_DEBUG_REQUIRE(null || buf->buffer().size() == sizes_[b],
+                            "Buffer size does not match coalesced message layout.");
+    segments_h_(b) = {null ? nullptr : buf->buffer().data(), offsets_[b], sizes_[b]};
+  }
+  int size = Size();
+  if (compact_) {
+    for (int w = 0; w < mask_h_.size(); ++w) {
+      mask_h_(w) = 0;
+    }
+    for (int b = 0; b < NumMembers(); ++b) {
+      if (segments_h_(b).data != nullptr)
+        mask_h_(b / mask_bits) += static_cast<Real>(std::uint32_t(1) << (b % mask_bits));
+    }
+    size = CompactSegments();
+  }
+  // the previous message may still be read by MPI
+  PARTHENON_MPI_CHECK(MPI_Wait(&request_, MPI_STATUS_IGNORE));
+  if (compact_) {
+    Kokkos::deep_copy(Kokkos::subview(message_, std::make_pair(0, offsets_[0])),
+                      mask_h_);
+  }
+  CopySegments(true);
+  if (staged_message_.size() > 0) {
+    const auto range = std::make_pair(0, size);
+    Kokkos::deep_copy(Kokkos::subview(staged_message_, range),
+                      Kokkos::subview(message_, range));
+  }
+  PARTHENON_MPI_CHECK(MPI_Isend(MessageData(), size, MPITypeMap<Real>::type(),
+                                other_rank_, tag_, comm_, &request_));
+#endif
+  nready_ = 0;
+}
+
+bool CoalescedBoundaryMessage::SendComplete() {
+  // members that are already sent have to wait for the others
+  if (nready_ > 0) return false;
+#ifdef MPI_PARALLEL
+  int flag;
+  PARTHENON_MPI_CHECK(MPI_Test(&request_, &flag, MPI_STATUS_IGNORE));
+  if (!flag) return false;
+#endif
+  for (auto *buf : members_) {
+    buf->SetState(BufferState::stale);
+  }
+  return true;
+}
+
+void CoalescedBoundaryMessage::TryStartReceive() {
+  if (posted_) return;
+  // don't overwrite data that has not been used yet
+  for (auto *buf : members_) {
+    if (buf->GetState() != BufferState::stale) return;
+  }
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Irecv(MessageData(), Size(), MPITypeMap<Real>::type(),
+                                other_rank_, tag_, comm_, &request_));
+#endif
+  posted_ = true;
+}
+
+bool CoalescedBoundaryMessage::TryReceive() {
+  TryStartReceive();
+  if (!posted_) return false;
+#ifdef MPI_PARALLEL
+  int flag;
+  // see CommBuffer::TryReceive for why the MPI_Iprobe is here
+  PARTHENON_MPI_CHECK(
+      MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE));
+  MPI_Status status;
+  PARTHENON_MPI_CHECK(MPI_Test(&request_, &flag, &status));
+  if (!flag) return false;
+  int size;
+  PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPITypeMap<Real>::type(), &size));
+#else
+  const int size = Size();
+#endif
+  posted_ = false;
+  if (staged_message_.size() > 0) {
+    const auto range = std::make_pair(0, size);
+    Kokkos::deep_copy(Kokkos::subview(message_, range),
+                      Kokkos::subview(staged_message_, range));
+  }
+
+  const int nmembers = NumMembers();
+  auto flags = Kokkos::create_mirror_view_and_copy(
+      HostMemSpace(), Kokkos::subview(message_, std::make_pair(0, offsets_[0])));
+  for (int b = 0; b < nmembers; ++b) {
+    auto *buf = members_[b];
+    bool present;
+    if (compact_) {
+      const auto word = static_cast<std::uint32_t>(flags(b / mask_bits));
+      present = (word >> (b % mask_bits)) & 1;
+    } else {
+      present = (flags(b) != 0.0);
+    }
+    if (present) {
+      buf->Allocate();
+      buf->SetState(BufferState::received);
+      segments_h_(b) = {buf->buffer().data(), offsets_[b], sizes_[b]};
+    } else {
+      if (buf->GetCommType() == BuffCommType::sparse_receiver) buf->Free();
+      buf->SetState(BufferState::received_null);
+      segments_h_(b) = {nullptr, offsets_[b], 0};
+    }
+  }
+  if (compact_) {
+    PARTHENON_REQUIRE(CompactSegments() == size,
+                      "Compact message size does not match its bitmask.");
+  }
+  CopySegments(false);
+  return true;
+}
+
+int CoalescedBoundaryMessage::CompactSegments() {
+  int offset = offsets_[0];
+  for (int b = 0; b < NumMembers(); ++b) {
+    segments_h_(b).offset = offset;
+    if (segments_h_(b).data != nullptr) offset += sizes_[b];
+  }
+  return offset;
+}
+
+bool ExchangeCoversGroupMembers(BoundaryType bound_type, int nvars, int nbase_vars) {
+  // the local buffers of BoundaryType::any are never grouped
+  const bool grouped_type =
+      bound_type == BoundaryType::any || bound_type == BoundaryType::nonlocal ||
+      bound_type == BoundaryType::flxcor_send || bound_type == BoundaryType::flxcor_recv;
+  return grouped_type && nvars == nbase_vars;
+}
+
+void CoalesceBoundaryBuffers(Mesh *pmesh) {
+#ifdef MPI_PARALLEL
+  using namespace loops;
+  using namespace loops::shorthands;
+  if (!Globals::comm_config.coalesce_messages &&
+      !Globals::comm_config.neighborhood_comm &&
+      !Globals::comm_config.shared_memory_comm && !Globals::comm_config.rma_comm)
+    return;
+
+  // all non-local channels of the "any" boundary exchange and of the flux correction
+  // exchange, per other rank
+  using channel_t = std::pair<Mesh::channel_key_t, int>;
+  using channels_t = std::map<int, std::vector<channel_t>>;
+  channels_t send_channels, recv_channels, flxcor_send_channels, flxcor_recv_channels;
+  const int num_partitions = pmesh->DefaultNumPartitions();
+  for (int i = 0; i < num_partitions; i++) {
+    auto &md = pmesh->mesh_data.GetOrAdd("base", i);
+    ForEachBoundary<BoundaryType::nonlocal>(
+        md, [&](auto pmb, sp_mbd_t /*rc*/, nb_t &nb, const sp_cv_t v) {
+          const int size = GetBufferSize(pmb, nb, v);
+          send_channels[nb.snb.rank].push_back({SendKey(pmb, nb, v), size});
+          recv_channels[nb.snb.rank].push_back({ReceiveKey(pmb, nb, v), size});
+        });
+    ForEachBoundary<BoundaryType::flxcor_send>(
+        md, [&](auto pmb, sp_mbd_t /*rc*/, nb_t &nb, const sp_cv_t v) {
+          if (nb.snb.rank == Globals::my_rank) return;
+          flxcor_send_channels[nb.snb.rank].push_back(
+              {SendKey(pmb, nb, v), GetBufferSize(pmb, nb, v)});
+        });
+    ForEachBoundary<BoundaryType::flxcor_recv>(
+        md, [&](auto pmb, sp_mbd_t /*rc*/, nb_t &nb, const sp_cv_t v) {
+          if (nb.snb.rank == Globals::my_rank) return;
+          flxcor_recv_channels[nb.snb.rank].push_back(
+              {ReceiveKey(pmb, nb, v), GetBufferSize(pmb, nb, v)});
+        });
+  }
+
+  // the buffers exchanged with each rank, in channel key order
+  using members_t = NeighborhoodBoundaryExchange::members_t;
+  auto get_members = [](channels_t &channels, Mesh::comm_buf_map_t &buf_map) {
+    members_t members;
+    for (auto &[rank, chans] : channels) {
+      std::sort(chans.begin(), chans.end(),
+                [](const auto &a, const auto &b) { return a.first < b.first; });
+      auto &rank_members = members[rank];
+      for (auto &[key, size] : chans) {
+        rank_members.push_back({&(buf_map.at(key)), size});
+      }
+    }
+    return members;
+  };
+
+  auto send_members = get_members(send_channels, pmesh->boundary_comm_map);
+  auto recv_members = get_members(recv_channels, pmesh->boundary_comm_map);
+  auto flxcor_send_members =
+      get_members(flxcor_send_channels, pmesh->boundary_comm_flxcor_map);
+  auto flxcor_recv_members =
+      get_members(flxcor_recv_channels, pmesh->boundary_comm_flxcor_map);
+
+  // the previous windows have to be freed at the same point on all ranks
+  pmesh->shared_memory_window.reset();
+  pmesh->rma_window.reset();
+  if (Globals::comm_config.shared_memory_comm) {
+    // on-node ranks are taken out of the members, which leaves the off-node ranks to
+    // the messages below
+    pmesh->shared_memory_window =
+        ShareOnNodeMessages({{&send_members, &recv_members},
+                             {&flxcor_send_members, &flxcor_recv_members}});
+  }
+
+  if (Globals::comm_config.rma_comm) {
+    pmesh->rma_window = ExposeInRMAWindow(
+        pmesh->GetMPIComm(Mesh::coalesced_comm_label),
+        {{&send_members, &recv_members}, {&flxcor_send_members, &flxcor_recv_members}});
+    return;
+  }
+
+  if (Globals::comm_config.neighborhood_comm) {
+    // one exchange with all ranks per direction, collective over the ranks that take
+    // part in it
+    auto build = [&](const members_t &send, const members_t &recv) {
+      const bool member = !send.empty() || !recv.empty();
+      MPI_Comm comm;
+      PARTHENON_MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, member ? 0 : MPI_UNDEFINED,
+                                         Globals::my_rank, &comm));
+      if (!member) return;
+      auto exchange = std::make_shared<NeighborhoodBoundaryExchange>(comm, send, recv);
+      PARTHENON_MPI_CHECK(MPI_Comm_free(&comm));
+      int b = 0;
+      for (const auto *members : {&send, &recv}) {
+        for (auto &[rank, rank_members] : *members) {
+          for (auto &[buf, size] : rank_members) {
+            buf->SetGroup(exchange, b++);
+          }
+        }
+      }
+    };
+    build(send_members, recv_members);
+    build(flxcor_send_members, flxcor_recv_members);
+    return;
+  }
+  if (!Globals::comm_config.coalesce_messages) return;
+
+  mpi_comm_t comm = pmesh->GetMPIComm(Mesh::coalesced_comm_label);
+  auto build = [&](members_t &all_members, int tag, bool sender) {
+    for (auto &[rank, members] : all_members) {
+      auto message =
+          std::make_shared<CoalescedBoundaryMessage>(rank, tag, sender, comm, members);
+      for (int b = 0; b < static_cast<int>(members.size()); ++b) {
+        members[b].first->SetGroup(message, b);
+      }
+    }
+  };
+  build(send_members, 0, true);
+  build(recv_members, 0, false);
+  build(flxcor_send_members, 1, true);
+  build(flxcor_recv_members, 1, false);
+#endif
+}
+
+} // namespace parthenon
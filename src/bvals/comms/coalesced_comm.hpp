@@ -0,0 +1,115 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2023 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#ifndef BVALS_COMMS_COALESCED_COMM_HPP_
+#define BVALS_COMMS_COALESCED_COMM_HPP_
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/communication_buffer.hpp"
+#include "utils/object_pool.hpp"
+
+namespace parthenon {
+
+class Mesh;
+
+// All boundary buffers exchanged between this rank and one other rank in one direction,
+// sent as a single MPI message.  The members are ordered by their channel key, which
+// is the same on both ranks, so the message layout
+//   [ one flag per member (0 for a null buffer) | member 0 | member 1 | ... ]
+// with each member at a fixed offset given by its full buffer size, is known to both
+// sides without any further communication.  The message is sent once every member has
+// been sent, and a new receive is only posted once every member has been staled again.
+// The ghost zone and flux correction exchanges between the same ranks are separate
+// messages, told apart by their tag.
+//
+// With Globals::comm_config.compact_messages, the message instead starts with a bitmask
+// of the members that are not null, packed into Reals, and only those members follow,
+// back to back in member order.  Both sides compute the offsets from the bitmask, so
+// null members of unallocated sparse variables take no space in the message at all.
+class CoalescedBoundaryMessage : public CommBufferGroup {
+ public:
+  using buf_t = CommBuffer<buf_pool_t<Real>::owner_t>;
+
+  // members are pairs of buffers and their full sizes, in channel key order
+  CoalescedBoundaryMessage(int other_rank, int tag, bool sender, mpi_comm_t comm,
+                           const std::vector<std::pair<buf_t *, int>> &members);
+  ~CoalescedBoundaryMessage();
+
+  void Send(int member) override;
+  bool SendComplete() override;
+  void TryStartReceive() override;
+  bool TryReceive() override;
+
+  int NumMembers() const { return members_.size(); }
+  // largest size of the message, including the flags, i.e., with all members present
+  int Size() const { return offsets_.back(); }
+
+ private:
+  struct Segment {
+    Real *data;
+    int offset;
+    int size;
+  };
+  // copy between the members and the message in one kernel, in the direction given
+  // (true for packing into the message)
+  void CopySegments(bool pack);
+  // the message sent and received by MPI, i.e., the host staged copy of the message if
+  // Globals::comm_config.host_staging is set
+  Real *MessageData();
+  // for compact messages, place the members that are not null back to back after the
+  // bitmask and return the size of the message
+  int CompactSegments();
+
+  // number of members per word of the bitmask of compact messages, such that the words
+  // are exactly representable as Real
+  static constexpr int mask_bits = std::min(32, std::numeric_limits<Real>::digits);
+
+  int other_rank_;
+  int tag_;
+  bool sender_;
+  mpi_comm_t comm_;
+  std::vector<buf_t *> members_;
+  std::vector<int> sizes_, offsets_;
+  int nready_ = 0;
+  bool posted_ = false;
+  bool compact_;
+  // the bitmask of compact messages, or the flags otherwise
+  Kokkos::View<Real *, HostMemSpace> mask_h_;
+  BufArray1D<Real> message_;
+  Kokkos::View<Real *, HostPinnedMemSpace> staged_message_;
+  Kokkos::View<Segment *, DevMemSpace> segments_;
+  typename Kokkos::View<Segment *, DevMemSpace>::HostMirror segments_h_;
+  mpi_request_t request_;
+};
+
+// A grouped message only goes out once all of its members have been sent, so an
+// exchange that uses the buffers of a group has to send every member of it, or the
+// receiving rank waits forever.  Groups are built for the nonlocal ghost zone and the
+// flux correction exchanges of the base MeshData, so these are covered for MeshData
+// whose blocks have the same nvars variables as in base, nbase_vars, but neither other
+// boundary types nor subsets of the variables are.
+bool ExchangeCoversGroupMembers(BoundaryType bound_type, int nvars, int nbase_vars);
+
+} // namespace parthenon
+
+#endif // BVALS_COMMS_COALESCED_COMM_HPP_
@@ -0,0 +1,135 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef BVALS_COMMS_COMM_ENCODING_HPP_
+#define BVALS_COMMS_COMM_ENCODING_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+namespace comm_encoding {
+
+// Encodings of boundary buffers that are sent across ranks in fewer bytes than the Real
+// values they carry (see Metadata::SetCommEncoding).  Values are packed row by row,
+// where a row is a contiguous run of cells in the i direction.
+//
+// CommEncoding::quantized is a block floating point format.  The message starts with one
+// Real scale per row, followed by the values of all rows as 32 bit integer multiples of
+// the scale of their row.  The scale of a row is the larger of twice the error bound and
+// the largest magnitude in the row divided by 2^31 - 1, so every value is reproduced to
+// within the error bound or to 2^-32 of the largest magnitude in its row, whichever is
+// larger.
+//
+// CommEncoding::float32 and CommEncoding::bfloat16 store the values of all rows as
+// single precision floats, or as the upper 16 bits of them (rounded to nearest even),
+// i.e., with 24 or 8 significant bits and the exponent range of single precision.
+
+// Number of Reals a message of nvals values in nrows rows takes up
+KOKKOS_INLINE_FUNCTION int EncodedSize(const CommEncoding encoding, const int nvals,
+                                       const int nrows) {
+  const auto bytes_to_reals = [](const int nbytes) {
+    return static_cast<int>((nbytes + sizeof(Real) - 1) / sizeof(Real));
+  };
+  if (encoding == CommEncoding::quantized)
+    return nrows + bytes_to_reals(nvals * sizeof(std::int32_t));
+  if (encoding == CommEncoding::float32) return bytes_to_reals(nvals * sizeof(float));
+  if (encoding == CommEncoding::bfloat16)
+    return bytes_to_reals(nvals * sizeof(std::uint16_t));
+  return nvals;
+}
+
+// An encoding only pays off if the message gets smaller, e.g. quantized and float32
+// need Real to be wider than 32 bits
+inline CommEncoding Effective(const CommEncoding encoding, const int nvals,
+                              const int nrows) {
+  if (encoding == CommEncoding::none) return encoding;
+  if (EncodedSize(encoding, nvals, nrows) >= nvals) return CommEncoding::none;
+  return encoding;
+}
+
+KOKKOS_INLINE_FUNCTION std::uint16_t ToBFloat16(const float val) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  // keep NaNs NaN, the rounding below could turn them into infinities
+  if ((bits & 0x7fffffffu) > 0x7f800000u) return (bits >> 16) | 0x0040u;
+  bits += 0x7fffu + ((bits >> 16) & 1u);
+  return bits >> 16;
+}
+
+KOKKOS_INLINE_FUNCTION float FromBFloat16(const std::uint16_t val) {
+  const std::uint32_t bits = static_cast<std::uint32_t>(val) << 16;
+  float out;
+  std::memcpy(&out, &bits, sizeof(out));
+  return out;
+}
+
+KOKKOS_INLINE_FUNCTION std::int32_t *Quanta(Real *msg, const int nrows) {
+  return reinterpret_cast<std::int32_t *>(msg + nrows);
+}
+KOKKOS_INLINE_FUNCTION const std::int32_t *Quanta(const Real *msg, const int nrows) {
+  return reinterpret_cast<const std::int32_t *>(msg + nrows);
+}
+
+// Encode the Ni values of row, which start at element e0 of the message, from within a
+// team
+template <class Team>
+KOKKOS_INLINE_FUNCTION void
+EncodeRow(const Team &team_member, const CommEncoding encoding, const Real error_bound,
+          const Real *var, Real *msg, const int nrows, const int row, const int e0,
+          const int Ni) {
+  if (encoding == CommEncoding::quantized) {
+    Real row_max = 0.0;
+    Kokkos::parallel_reduce(
+        Kokkos::ThreadVectorRange<>(team_member, Ni),
+        [&](int m, Real &lmax) { lmax = Kokkos::max(lmax, Kokkos::abs(var[m])); },
+        Kokkos::Max<Real, DevMemSpace>(row_max));
+    const Real scale = Kokkos::max(2.0 * error_bound, row_max / 2147483647.0);
+    const Real inv_scale = scale > 0.0 ? 1.0 / scale : 0.0;
+    std::int32_t *quanta = Quanta(msg, nrows);
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni), [&](int m) {
+      quanta[e0 + m] = static_cast<std::int32_t>(Kokkos::round(var[m] * inv_scale));
+    });
+    Kokkos::single(Kokkos::PerThread(team_member), [&]() { msg[row] = scale; });
+  } else if (encoding == CommEncoding::float32) {
+    float *vals = reinterpret_cast<float *>(msg);
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
+                         [&](int m) { vals[e0 + m] = static_cast<float>(var[m]); });
+  } else if (encoding == CommEncoding::bfloat16) {
+    std::uint16_t *vals = reinterpret_cast<std::uint16_t *>(msg);
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni), [&](int m) {
+      vals[e0 + m] = ToBFloat16(static_cast<float>(var[m]));
+    });
+  } else {
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
+                         [&](int m) { msg[e0 + m] = var[m]; });
+  }
+}
+
+// The value of element e, in row, of the message
+KOKKOS_INLINE_FUNCTION Real Decode(const CommEncoding encoding, const Real *msg,
+                                   const int nrows, const int row, const int e) {
+  if (encoding == CommEncoding::quantized) return msg[row] * Quanta(msg, nrows)[e];
+  if (encoding == CommEncoding::float32) return reinterpret_cast<const float *>(msg)[e];
+  if (encoding == CommEncoding::bfloat16)
+    return FromBFloat16(reinterpret_cast<const std::uint16_t *>(msg)[e]);
+  return msg[e];
+}
+
+} // namespace comm_encoding
+} // namespace parthenon
+
+#endif // BVALS_COMMS_COMM_ENCODING_HPP_
@@ -33,13 +33,16 @@
 #include "mesh/mesh_refinement.hpp"
 #include "mesh/meshblock.hpp"
 #include "prolong_restrict/prolong_restrict.hpp"
+#include "tasks/tasks.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/phase_times.hpp"
 
 namespace parthenon {
 using namespace impl;
 
 TaskStatus LoadAndSendFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
 
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(BoundaryType::flxcor_send, true);
@@ -68,7 +71,7 @@ TaskStatus LoadAndSendFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_REQUIRE(bnd_info.size() == nbound, "Need same size for boundary info");
   Kokkos::parallel_for(
       PARTHENON_AUTO_LABEL,
-      Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), nbound, Kokkos::AUTO),
+      Kokkos::TeamPolicy<>(cache.exec_space, nbound, Kokkos::AUTO),
       KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
         auto &binfo = bnd_info(team_member.league_rank());
         if (!binfo.allocated) return;
@@ -109,7 +112,14 @@ TaskStatus LoadAndSendFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
             });
       });
 #ifdef MPI_PARALLEL
-  Kokkos::fence();
+  // copy the messages of all buffers staged in host memory at once before the fence
+  if (Globals::comm_config.host_staging) {
+    for (auto &buf : cache.buf_vec)
+      buf->StageForSend(cache.exec_space);
+  }
+  cache.exec_space.fence();
+#else
+  if (cache.concurrent_instances) cache.exec_space.fence();
 #endif
   // Calling Send will send null if the underlying buffer is unallocated
   for (auto &buf : cache.buf_vec)
@@ -119,6 +129,7 @@ TaskStatus LoadAndSendFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
 
 TaskStatus StartReceiveFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(BoundaryType::flxcor_recv, false);
   if (cache.buf_vec.size() == 0)
@@ -133,6 +144,7 @@ TaskStatus StartReceiveFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
 
 TaskStatus ReceiveFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
 
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(BoundaryType::flxcor_recv, false);
@@ -140,10 +152,8 @@ TaskStatus ReceiveFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
     InitializeBufferCache<BoundaryType::flxcor_recv>(
         md, &(pmesh->boundary_comm_flxcor_map), &cache, ReceiveKey, false);
 
-  bool all_received = true;
-  std::for_each(
-      std::begin(cache.buf_vec), std::end(cache.buf_vec),
-      [&all_received](auto pbuf) { all_received = pbuf->TryReceive() && all_received; });
+  const bool all_received = CommBuffer<buf_pool_t<Real>::owner_t>::TryReceiveAll(
+      cache.buf_vec, &cache.recv_batch);
 
   if (all_received) return TaskStatus::complete;
   return TaskStatus::incomplete;
@@ -151,6 +161,7 @@ TaskStatus ReceiveFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
 
 TaskStatus SetFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
   PARTHENON_INSTRUMENT
+  PhaseTimes::Scope comm_time(PhaseTimes::Phase::communication);
 
   Mesh *pmesh = md->GetMeshPointer();
   auto &cache = md->GetBvarsCache().GetSubCache(BoundaryType::flxcor_recv, false);
@@ -161,10 +172,15 @@ TaskStatus SetFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
     RebuildBufferCache<BoundaryType::flxcor_recv, false>(
         md, nbound, BndInfo::GetSetCCFluxCor, ProResInfo::GetSend);
 
+  // messages received in host memory are copied to their buffers ahead of the kernel
+  if (Globals::comm_config.host_staging) {
+    for (auto *pbuf : cache.buf_vec)
+      pbuf->Unstage(cache.exec_space);
+  }
   auto &bnd_info = cache.bnd_info;
   Kokkos::parallel_for(
       PARTHENON_AUTO_LABEL,
-      Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), nbound, Kokkos::AUTO),
+      Kokkos::TeamPolicy<>(cache.exec_space, nbound, Kokkos::AUTO),
       KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
         const int b = team_member.league_rank();
         if (!bnd_info(b).allocated) return;
@@ -177,7 +193,9 @@ TaskStatus SetFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
                              });
       });
 #ifdef MPI_PARALLEL
-  Kokkos::fence();
+  cache.exec_space.fence();
+#else
+  if (cache.concurrent_instances) cache.exec_space.fence();
 #endif
   std::for_each(std::begin(cache.buf_vec), std::end(cache.buf_vec),
                 [](auto pbuf) { pbuf->Stale(); });
@@ -185,4 +203,15 @@ TaskStatus SetFluxCorrections(std::shared_ptr<MeshData<Real>> &md) {
   return TaskStatus::complete;
 }
 
+TaskID AddFluxCorrectionTasks(TaskID dependency, TaskList &tl,
+                              std::shared_ptr<MeshData<Real>> &md) {
+  if (!md->HasLevelJumps()) return dependency;
+  TaskID none(0);
+  auto start_recv = tl.AddTask(none, StartReceiveFluxCorrections, md);
+  // sends are on the critical path of other ranks, so get them out first
+  tl.AddTask(TaskQualifier::priority, dependency, LoadAndSendFluxCorrections, md);
+  auto recv = tl.AddTask(start_recv, ReceiveFluxCorrections, md);
+  return tl.AddTask(recv | dependency, SetFluxCorrections, md);
+}
+
 } // namespace parthenon
@@ -0,0 +1,230 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "bvals/comms/neighborhood_comm.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/error_checking.hpp"
+#include "utils/instrument.hpp"
+
+namespace parthenon {
+
+void NeighborhoodBoundaryExchange::Side::Build(const members_t &all_members) {
+  int pos = 0;
+  for (auto &[rank, rank_members] : all_members) {
+    ranks.push_back(rank);
+    displs.push_back(pos);
+    first.push_back(members.size());
+    // the flags go first
+    const int flag0 = pos;
+    pos += rank_members.size();
+    for (auto &[buf, size] : rank_members) {
+      flags.push_back(flag0 + members.size() - first.back());
+      members.push_back(buf);
+      sizes.push_back(size);
+      offsets.push_back(pos);
+      pos += size;
+    }
+    counts.push_back(pos - displs.back());
+  }
+  first.push_back(members.size());
+  message = BufArray1D<Real>("neighborhood message", pos);
+  if (Globals::comm_config.host_staging) {
+    staged_message = Kokkos::View<Real *, HostPinnedMemSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "staged neighborhood message"),
+        pos);
+  }
+  segments =
+      Kokkos::View<Segment *, DevMemSpace>("neighborhood segments", members.size());
+  segments_h = Kokkos::create_mirror_view(segments);
+}
+
+NeighborhoodBoundaryExchange::NeighborhoodBoundaryExchange(mpi_comm_t comm,
+                                                           const members_t &send,
+                                                           const members_t &recv) {
+  send_.Build(send);
+  recv_.Build(recv);
+#ifdef MPI_PARALLEL
+  request_ = MPI_REQUEST_NULL;
+  // the neighbors are given by their ranks in MPI_COMM_WORLD
+  MPI_Group world_group, group;
+  PARTHENON_MPI_CHECK(MPI_Comm_group(MPI_COMM_WORLD, &world_group));
+  PARTHENON_MPI_CHECK(MPI_Comm_group(comm, &group));
+  auto translate = [&](const std::vector<int> &ranks) {
+    std::vector<int> out(ranks.size());
+    PARTHENON_MPI_CHECK(MPI_Group_translate_ranks(world_group, ranks.size(), ranks.data(),
+                                                  group, out.data()));
+    return out;
+  };
+  const auto sources = translate(recv_.ranks);
+  const auto destinations = translate(send_.ranks);
+  PARTHENON_MPI_CHECK(MPI_Group_free(&world_group));
+  PARTHENON_MPI_CHECK(MPI_Group_free(&group));
+  // no reordering, so that the neighbors stay in the order of the message blocks
+  PARTHENON_MPI_CHECK(MPI_Dist_graph_create_adjacent(
+      comm, sources.size(), sources.data(), MPI_UNWEIGHTED, destinations.size(),
+      destinations.data(), MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &comm_));
+#endif
+}
+
+NeighborhoodBoundaryExchange::~NeighborhoodBoundaryExchange() {
+#ifdef MPI_PARALLEL
+  // collectives can't be cancelled
+  if (started_) PARTHENON_MPI_CHECK(MPI_Wait(&request_, MPI_STATUS_IGNORE));
+  PARTHENON_MPI_CHECK(MPI_Comm_free(&comm_));
+#endif
+}
+
+void NeighborhoodBoundaryExchange::CopySegments(Side &side, bool pack) {
+  const int nmembers = side.members.size();
+  if (nmembers == 0) return;
+  auto exec_space = DevExecSpace();
+  Kokkos::deep_copy(exec_space, side.segments, side.segments_h);
+  auto segments = side.segments;
+  auto message = side.message;
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, Kokkos::TeamPolicy<>(exec_space, nmembers, Kokkos::AUTO),
+      KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
+        const Segment &seg = segments(team_member.league_rank());
+        if (pack) {
+          Kokkos::single(Kokkos::PerTeam(team_member), [&]() {
+            message(seg.flag) = (seg.data == nullptr ? 0.0 : 1.0);
+          });
+        }
+        if (seg.data == nullptr) return;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, seg.size),
+                             [&](const int i) {
+                               if (pack) {
+                                 message(seg.offset + i) = seg.data[i];
+                               } else {
+                                 seg.data[i] = message(seg.offset + i);
+                               }
+                             });
+      });
+  exec_space.fence();
+}
+
+void NeighborhoodBoundaryExchange::Start() {
+  for (int b = 0; b < NumSendMembers(); ++b) {
+    auto *buf = send_.members[b];
+    const bool null = (buf->GetState() == BufferState::sending_null);
+    PARTHENON_DEBUG_REQUIRE(null || buf->buffer().size() == send_.sizes[b],
+                            "Buffer size does not match neighborhood message layout.");
+    send_.segments_h(b) = {null ? nullptr : buf->buffer().data(), send_.flags[b],
+                           send_.offsets[b], send_.sizes[b]};
+  }
+  CopySegments(send_, true);
+  if (send_.staged_message.size() > 0) {
+    Kokkos::deep_copy(send_.staged_message, send_.message);
+  }
+#ifdef MPI_PARALLEL
+  const auto type = MPITypeMap<Real>::type();
+  PARTHENON_MPI_CHECK(MPI_Ineighbor_alltoallv(
+      send_.MessageData(), send_.counts.data(), send_.displs.data(), type,
+      recv_.MessageData(), recv_.counts.data(), recv_.displs.data(), type, comm_,
+      &request_));
+#endif
+  started_ = true;
+  nready_ = 0;
+}
+
+bool NeighborhoodBoundaryExchange::Complete(bool wait) {
+  if (!started_) return true;
+#ifdef MPI_PARALLEL
+  if (wait) {
+    PARTHENON_MPI_CHECK(MPI_Wait(&request_, MPI_STATUS_IGNORE));
+  } else {
+    int flag;
+    // see CommBuffer::TryReceive for why the MPI_Iprobe is here
+    PARTHENON_MPI_CHECK(MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag,
+                                   MPI_STATUS_IGNORE));
+    PARTHENON_MPI_CHECK(MPI_Test(&request_, &flag, MPI_STATUS_IGNORE));
+    if (!flag) return false;
+  }
+#endif
+  started_ = false;
+  if (NumReceiveMembers() == 0) return true;
+  if (recv_.staged_message.size() > 0) {
+    Kokkos::deep_copy(recv_.message, recv_.staged_message);
+  }
+
+  for (int n = 0; n < recv_.ranks.size(); ++n) {
+    const int nmembers = recv_.first[n + 1] - recv_.first[n];
+    auto flags = Kokkos::create_mirror_view_and_copy(
+        HostMemSpace(),
+        Kokkos::subview(recv_.message,
+                        std::make_pair(recv_.displs[n], recv_.displs[n] + nmembers)));
+    for (int m = 0; m < nmembers; ++m) {
+      const int b = recv_.first[n] + m;
+      auto *buf = recv_.members[b];
+      if (flags(m) != 0.0) {
+        buf->Allocate();
+        buf->SetState(BufferState::received);
+        recv_.segments_h(b) = {buf->buffer().data(), recv_.flags[b], recv_.offsets[b],
+                               recv_.sizes[b]};
+      } else {
+        if (buf->GetCommType() == BuffCommType::sparse_receiver) buf->Free();
+        buf->SetState(BufferState::received_null);
+        recv_.segments_h(b) = {nullptr, recv_.flags[b], recv_.offsets[b], 0};
+      }
+    }
+  }
+  CopySegments(recv_, false);
+  return true;
+}
+
+void NeighborhoodBoundaryExchange::Send(int member) {
+  PARTHENON_DEBUG_REQUIRE(member < NumSendMembers(),
+                          "Sending a receive member of a neighborhood exchange.");
+  if (++nready_ < NumSendMembers()) return;
+  // the messages of the previous exchange are reused, so it has to be done
+  if (started_) Complete(true);
+  Start();
+}
+
+bool NeighborhoodBoundaryExchange::SendComplete() {
+  // members that are already sent have to wait for the others
+  if (nready_ > 0) return false;
+  if (!Complete(false)) return false;
+  for (auto *buf : send_.members) {
+    buf->SetState(BufferState::stale);
+  }
+  return true;
+}
+
+void NeighborhoodBoundaryExchange::TryStartReceive() {
+  // ranks that send start the exchange when sending
+  if (started_ || NumSendMembers() > 0) return;
+  // don't overwrite data that has not been used yet
+  for (auto *buf : recv_.members) {
+    if (buf->GetState() != BufferState::stale) return;
+  }
+  Start();
+}
+
+bool NeighborhoodBoundaryExchange::TryReceive() {
+  TryStartReceive();
+  if (!started_) return false;
+  return Complete(false);
+}
+
+} // namespace parthenon
@@ -0,0 +1,110 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#ifndef BVALS_COMMS_NEIGHBORHOOD_COMM_HPP_
+#define BVALS_COMMS_NEIGHBORHOOD_COMM_HPP_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/communication_buffer.hpp"
+#include "utils/object_pool.hpp"
+
+namespace parthenon {
+
+// All non-local boundary buffers of one exchange (ghost zones or flux corrections) of
+// this rank, exchanged with all other ranks at once by a single MPI_Ineighbor_alltoallv
+// on a distributed graph communicator with the ranks this rank sends to and receives
+// from as neighbors.  The block of the message exchanged with a neighbor has the same
+// layout as a CoalescedBoundaryMessage, i.e.,
+//   [ one flag per member (0 for a null buffer) | member 0 | member 1 | ... ]
+// with the members in channel key order.  The exchange is started once every send
+// member has been sent (or, on ranks that only receive, once every receive member has
+// been staled), and it has to be started in the same order on all ranks of the graph,
+// which is why the ghost zone and flux correction exchanges get separate communicators.
+class NeighborhoodBoundaryExchange : public CommBufferGroup {
+ public:
+  using buf_t = CommBuffer<buf_pool_t<Real>::owner_t>;
+  // pairs of buffers and their full sizes per other rank, in channel key order
+  using members_t = std::map<int, std::vector<std::pair<buf_t *, int>>>;
+
+  // Collective over comm, which has to contain all the ranks in send and recv and no
+  // ranks without members.  The send members are numbered first, followed by the
+  // receive members.
+  NeighborhoodBoundaryExchange(mpi_comm_t comm, const members_t &send,
+                               const members_t &recv);
+  ~NeighborhoodBoundaryExchange();
+
+  NeighborhoodBoundaryExchange(const NeighborhoodBoundaryExchange &) = delete;
+  NeighborhoodBoundaryExchange &operator=(const NeighborhoodBoundaryExchange &) = delete;
+
+  void Send(int member) override;
+  bool SendComplete() override;
+  void TryStartReceive() override;
+  bool TryReceive() override;
+
+  int NumSendMembers() const { return send_.members.size(); }
+  int NumReceiveMembers() const { return recv_.members.size(); }
+
+ private:
+  struct Segment {
+    Real *data;
+    int flag;
+    int offset;
+    int size;
+  };
+  // one direction of the exchange
+  struct Side {
+    std::vector<buf_t *> members;
+    // full sizes and positions of the flags and data of the members in the message
+    std::vector<int> sizes, flags, offsets;
+    // per neighbor, in the order of the neighbors of the graph, with the members
+    // exchanged with neighbor n starting at first[n]
+    std::vector<int> ranks, counts, displs, first;
+    BufArray1D<Real> message;
+    Kokkos::View<Real *, HostPinnedMemSpace> staged_message;
+    Kokkos::View<Segment *, DevMemSpace> segments;
+    typename Kokkos::View<Segment *, DevMemSpace>::HostMirror segments_h;
+
+    void Build(const members_t &members);
+    // the message handed to MPI
+    Real *MessageData() {
+      return staged_message.size() > 0 ? staged_message.data() : message.data();
+    }
+  };
+
+  // copy between the members and the message of side in one kernel, in the direction
+  // given (true for packing into the message)
+  static void CopySegments(Side &side, bool pack);
+  void Start();
+  // Tests (or waits for) the exchange in flight and unpacks the received members,
+  // returns true once this is done
+  bool Complete(bool wait);
+
+  mpi_comm_t comm_;
+  Side send_, recv_;
+  int nready_ = 0;
+  bool started_ = false;
+  mpi_request_t request_;
+};
+
+} // namespace parthenon
+
+#endif // BVALS_COMMS_NEIGHBORHOOD_COMM_HPP_
@@ -0,0 +1,296 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "bvals/comms/rma_comm.hpp"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/error_checking.hpp"
+#include "utils/instrument.hpp"
+
+namespace parthenon {
+
+RMAWindow::RMAWindow(std::size_t bytes) {
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(
+      MPI_Win_allocate(bytes, 1, MPI_INFO_NULL, MPI_COMM_WORLD, &base_, &win_));
+  PARTHENON_MPI_CHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, win_));
+#endif
+}
+
+RMAWindow::~RMAWindow() {
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Win_unlock_all(win_));
+  PARTHENON_MPI_CHECK(MPI_Win_free(&win_));
+#endif
+}
+
+void RMAWindow::Sync() const {
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Win_sync(win_));
+#endif
+}
+
+void RMAWindow::Put(const void *data, std::size_t bytes, int rank,
+                    std::int64_t offset) {
+  // MPI counts are ints
+  PARTHENON_REQUIRE(bytes <= std::numeric_limits<int>::max(),
+                    "RMA messages must be smaller than 2 GiB.");
+#ifdef MPI_PARALLEL
+  const int count = static_cast<int>(bytes);
+  PARTHENON_MPI_CHECK(
+      MPI_Put(data, count, MPI_BYTE, rank, offset, count, MPI_BYTE, win_));
+#endif
+  puts_pending_ = true;
+}
+
+void RMAWindow::Notify(const std::int64_t *value, int rank, std::int64_t offset) {
+  notifications_.push_back({value, rank, offset});
+}
+
+void RMAWindow::Flush() {
+#ifdef MPI_PARALLEL
+  if (puts_pending_) PARTHENON_MPI_CHECK(MPI_Win_flush_all(win_));
+  for (const auto &n : notifications_) {
+    PARTHENON_MPI_CHECK(MPI_Put(n.value, sizeof(std::int64_t), MPI_BYTE, n.rank,
+                                n.offset, sizeof(std::int64_t), MPI_BYTE, win_));
+  }
+  if (!notifications_.empty()) PARTHENON_MPI_CHECK(MPI_Win_flush_all(win_));
+#endif
+  puts_pending_ = false;
+  notifications_.clear();
+}
+
+std::size_t RMABoundaryMessage::AreaSize(
+    const std::vector<std::pair<buf_t *, int>> &members, bool sender) {
+  if (sender) return sizeof(counter_t);
+  std::size_t n = members.size();
+  for (auto &[buf, size] : members) {
+    n += size;
+  }
+  // keep the counter of the next area aligned
+  const std::size_t bytes = sizeof(counter_t) + n * sizeof(Real);
+  return (bytes + sizeof(counter_t) - 1) / sizeof(counter_t) * sizeof(counter_t);
+}
+
+RMABoundaryMessage::RMABoundaryMessage(
+    RMAWindow *window, int other_rank, bool sender, char *local,
+    const std::vector<std::pair<buf_t *, int>> &members)
+    : window_(window), other_rank_(other_rank), sender_(sender), local_(local),
+      segments_("RMA segments", members.size()) {
+  segments_h_ = Kokkos::create_mirror_view(segments_);
+  // the flags go first
+  offsets_.push_back(members.size());
+  for (auto &[buf, size] : members) {
+    members_.push_back(buf);
+    sizes_.push_back(size);
+    offsets_.push_back(offsets_.back() + size);
+  }
+  message_ = BufArray1D<Real>("RMA message", Size());
+  if (sender_ && Globals::comm_config.host_staging) {
+    staged_message_ = Kokkos::View<Real *, HostPinnedMemSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "host staged RMA message"),
+        Size());
+  }
+}
+
+Real *RMABoundaryMessage::MessageData() {
+  return staged_message_.size() > 0 ? staged_message_.data() : message_.data();
+}
+
+void RMABoundaryMessage::CopySegments(bool pack) {
+  const int nmembers = NumMembers();
+  // members fence the instances of their MeshData before they are sent, and the
+  // fence below comes before they are read (see BvarsSubCache_t)
+  auto exec_space = DevExecSpace();
+  Kokkos::deep_copy(exec_space, segments_, segments_h_);
+  auto segments = segments_;
+  auto message = message_;
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, Kokkos::TeamPolicy<>(exec_space, nmembers, Kokkos::AUTO),
+      KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
+        const int b = team_member.league_rank();
+        const Segment &seg = segments(b);
+        if (pack) {
+          Kokkos::single(Kokkos::PerTeam(team_member),
+                         [&]() { message(b) = (seg.data == nullptr ? 0.0 : 1.0); });
+        }
+        if (seg.data == nullptr) return;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, seg.size),
+                             [&](const int i) {
+                               if (pack) {
+                                 message(seg.offset + i) = seg.data[i];
+                               } else {
+                                 seg.data[i] = message(seg.offset + i);
+                               }
+                             });
+      });
+  exec_space.fence();
+}
+
+void RMABoundaryMessage::Send(int member) {
+  PARTHENON_DEBUG_REQUIRE(sender_, "Sending from an RMA receive message.");
+  if (++nready_ < NumMembers()) return;
+  // the previous message has to be read before it is overwritten, which SendComplete
+  // usually has made sure of already, and it can only be read once it is announced
+  window_->Flush();
+  window_->Sync();
+  while (LocalCounter() < count_) {
+    window_->Sync();
+  }
+  for (int b = 0; b < NumMembers(); ++b) {
+    auto *buf = members_[b];
+    const bool null = (buf->GetState() == BufferState::sending_null);
+    PARTHENON_DEBUG_REQUIRE(null || buf->buffer().size() == sizes_[b],
+                            "Buffer size does not match RMA message layout.");
+    segments_h_(b) = {null ? nullptr : buf->buffer().data(), offsets_[b], sizes_[b]};
+  }
+  CopySegments(true);
+  if (staged_message_.size() > 0) Kokkos::deep_copy(staged_message_, message_);
+  // the message has arrived before the counter announcing it is put, which happens in
+  // the next flush of the window, together with the messages sent to other ranks
+  window_->Put(MessageData(), Size() * sizeof(Real), other_rank_,
+               remote_offset_ + sizeof(counter_t));
+  notification_ = ++count_;
+  window_->Notify(&notification_, other_rank_, remote_offset_);
+  nready_ = 0;
+}
+
+bool RMABoundaryMessage::SendComplete() {
+  // members that are already sent have to wait for the others
+  if (nready_ > 0) return false;
+#ifdef MPI_PARALLEL
+  int flag;
+  // see CommBuffer::TryReceive for why the MPI_Iprobe is here
+  PARTHENON_MPI_CHECK(
+      MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE));
+#endif
+  window_->Flush();
+  window_->Sync();
+  if (LocalCounter() < count_) return false;
+  for (auto *buf : members_) {
+    buf->SetState(BufferState::stale);
+  }
+  return true;
+}
+
+bool RMABoundaryMessage::TryReceive() {
+  PARTHENON_DEBUG_REQUIRE(!sender_, "Receiving into an RMA send message.");
+#ifdef MPI_PARALLEL
+  int flag;
+  // see CommBuffer::TryReceive for why the MPI_Iprobe is here
+  PARTHENON_MPI_CHECK(
+      MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE));
+#endif
+  window_->Sync();
+  if (LocalCounter() <= count_) return false;
+  // don't overwrite data that has not been used yet
+  for (auto *buf : members_) {
+    if (buf->GetState() != BufferState::stale) return false;
+  }
+  // the message in the window, which is host memory
+  using unmanaged_t = Kokkos::MemoryTraits<Kokkos::Unmanaged>;
+  Kokkos::View<Real *, LayoutWrapper, HostMemSpace, unmanaged_t> received(
+      reinterpret_cast<Real *>(local_ + sizeof(counter_t)), Size());
+  for (int b = 0; b < NumMembers(); ++b) {
+    auto *buf = members_[b];
+    if (received(b) != 0.0) {
+      buf->Allocate();
+      buf->SetState(BufferState::received);
+      segments_h_(b) = {buf->buffer().data(), offsets_[b], sizes_[b]};
+    } else {
+      if (buf->GetCommType() == BuffCommType::sparse_receiver) buf->Free();
+      buf->SetState(BufferState::received_null);
+      segments_h_(b) = {nullptr, offsets_[b], 0};
+    }
+  }
+  Kokkos::deep_copy(message_, received);
+  CopySegments(false);
+  // the sender may only overwrite the message once it has been read
+  notification_ = ++count_;
+  window_->Notify(&notification_, other_rank_, remote_offset_);
+  window_->Flush();
+  return true;
+}
+
+std::shared_ptr<RMAWindow>
+ExposeInRMAWindow(mpi_comm_t comm, const std::vector<rma_exchange_t> &exchanges) {
+#ifdef MPI_PARALLEL
+  using counter_t = RMABoundaryMessage::counter_t;
+  // the memory exposed by each message, in the order of the exchanges with the sends
+  // of an exchange before its receives
+  struct Exposed {
+    int exchange, rank;
+    bool sender;
+    std::vector<std::pair<RMABoundaryMessage::buf_t *, int>> *members;
+    counter_t offset, remote_offset;
+  };
+  std::vector<Exposed> exposed;
+  std::size_t bytes = 0;
+  for (int e = 0; e < exchanges.size(); ++e) {
+    for (const bool sender : {true, false}) {
+      auto *all_members = sender ? exchanges[e].first : exchanges[e].second;
+      for (auto &[rank, members] : *all_members) {
+        exposed.push_back({e, rank, sender, &members, static_cast<counter_t>(bytes), 0});
+        bytes += RMABoundaryMessage::AreaSize(members, sender);
+      }
+    }
+  }
+  auto window = std::make_shared<RMAWindow>(bytes);
+  std::memset(window->Base(), 0, bytes);
+
+  // Each side tells the other side where its memory is.  A send message and the
+  // matching receive message on the other rank are told apart from the receive message
+  // and the matching send message between the same ranks by their tag.
+  std::vector<mpi_request_t> requests(2 * exposed.size());
+  for (int m = 0; m < exposed.size(); ++m) {
+    auto &ex = exposed[m];
+    const int send_tag = 2 * ex.exchange + (ex.sender ? 0 : 1);
+    const int recv_tag = 2 * ex.exchange + (ex.sender ? 1 : 0);
+    PARTHENON_MPI_CHECK(MPI_Isend(&ex.offset, 1, MPI_INT64_T, ex.rank, send_tag, comm,
+                                  &requests[2 * m]));
+    PARTHENON_MPI_CHECK(MPI_Irecv(&ex.remote_offset, 1, MPI_INT64_T, ex.rank, recv_tag,
+                                  comm, &requests[2 * m + 1]));
+  }
+  PARTHENON_MPI_CHECK(
+      MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+
+  for (auto &ex : exposed) {
+    auto message = std::make_shared<RMABoundaryMessage>(
+        window.get(), ex.rank, ex.sender, window->Base() + ex.offset, *ex.members);
+    message->SetRemoteOffset(ex.remote_offset);
+    for (int b = 0; b < ex.members->size(); ++b) {
+      (*ex.members)[b].first->SetGroup(message, b);
+    }
+  }
+  for (auto &[send, recv] : exchanges) {
+    send->clear();
+    recv->clear();
+  }
+  return window;
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace parthenon
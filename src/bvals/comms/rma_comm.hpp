@@ -0,0 +1,158 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#ifndef BVALS_COMMS_RMA_COMM_HPP_
+#define BVALS_COMMS_RMA_COMM_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/communication_buffer.hpp"
+#include "utils/object_pool.hpp"
+
+namespace parthenon {
+
+// An MPI RMA window over MPI_COMM_WORLD, in passive target mode for its whole lifetime
+class RMAWindow {
+ public:
+  // Collective over MPI_COMM_WORLD
+  explicit RMAWindow(std::size_t bytes);
+  ~RMAWindow();
+
+  RMAWindow(const RMAWindow &) = delete;
+  RMAWindow &operator=(const RMAWindow &) = delete;
+
+  // the memory this rank exposes
+  char *Base() const { return base_; }
+  // memory barrier between remote writes into the memory of this rank and reading it
+  void Sync() const;
+  // Starts writing bytes from data to offset in the memory of rank.  The data has
+  // arrived after the next Flush, and data must not change before then.
+  void Put(const void *data, std::size_t bytes, int rank, std::int64_t offset);
+  // Puts the counter at value to offset in the memory of rank once everything put
+  // before has arrived, i.e., in the next Flush.  value must not change before then.
+  void Notify(const std::int64_t *value, int rank, std::int64_t offset);
+  // Completes all puts and then all notifications, with one flush of the window each,
+  // so that the puts issued since the last Flush overlap
+  void Flush();
+
+ private:
+  struct Notification {
+    const std::int64_t *value;
+    int rank;
+    std::int64_t offset;
+  };
+#ifdef MPI_PARALLEL
+  MPI_Win win_;
+#endif
+  char *base_ = nullptr;
+  bool puts_pending_ = false;
+  std::vector<Notification> notifications_;
+};
+
+// All boundary buffers exchanged between this rank and one other rank in one direction,
+// put by the sender into the window memory of the receiver with one-sided
+// communication, followed by a notification, rather than matched with a receive. The
+// receiver exposes an area for the message starting with a counter of the messages
+// written into it, followed by a message with the same layout as a
+// CoalescedBoundaryMessage, i.e.,
+//   [ one flag per member (0 for a null buffer) | member 0 | member 1 | ... ]
+// with the members in channel key order, and the sender exposes a counter of the
+// messages read by the receiver.  The sender puts a message once every member has been
+// sent and the receiver has read the previous one, and then increments the counter of
+// the receiver.  The receiver reads the message once its counter has advanced and every
+// member has been staled again, and then increments the counter of the sender.
+class RMABoundaryMessage : public CommBufferGroup {
+ public:
+  using buf_t = CommBuffer<buf_pool_t<Real>::owner_t>;
+  using counter_t = std::int64_t;
+  // pairs of buffers and their full sizes per other rank, in channel key order
+  using members_t = std::map<int, std::vector<std::pair<buf_t *, int>>>;
+
+  // local points to the zeroed memory this side exposes in window, which has to be
+  // AreaSize(members, sender) bytes large.  The window has to outlive the message.
+  RMABoundaryMessage(RMAWindow *window, int other_rank, bool sender, char *local,
+                     const std::vector<std::pair<buf_t *, int>> &members);
+
+  // size in bytes of the memory exposed by one side of a message with these members
+  static std::size_t AreaSize(const std::vector<std::pair<buf_t *, int>> &members,
+                              bool sender);
+  // offset of the memory exposed by the other side in its window
+  void SetRemoteOffset(counter_t offset) { remote_offset_ = offset; }
+
+  void Send(int member) override;
+  bool SendComplete() override;
+  void TryStartReceive() override {}
+  bool TryReceive() override;
+
+  int NumMembers() const { return members_.size(); }
+  // total size of the message, including the flags
+  int Size() const { return offsets_.back(); }
+
+ private:
+  struct Segment {
+    Real *data;
+    int offset;
+    int size;
+  };
+  // copy between the members and the message in one kernel, in the direction given
+  // (true for packing into the message)
+  void CopySegments(bool pack);
+  // the counter exposed by this side
+  volatile counter_t &LocalCounter() const {
+    return *reinterpret_cast<volatile counter_t *>(local_);
+  }
+  // the message put into the window, i.e., the host staged copy of the message if
+  // Globals::comm_config.host_staging is set
+  Real *MessageData();
+
+  RMAWindow *window_;
+  int other_rank_;
+  bool sender_;
+  char *local_;
+  counter_t remote_offset_ = 0;
+  std::vector<buf_t *> members_;
+  std::vector<int> sizes_, offsets_;
+  int nready_ = 0;
+  // number of messages written or read by this side, and the copy of it that is put
+  // into the window of the other side
+  counter_t count_ = 0, notification_ = 0;
+  BufArray1D<Real> message_;
+  Kokkos::View<Real *, HostPinnedMemSpace> staged_message_;
+  Kokkos::View<Segment *, DevMemSpace> segments_;
+  typename Kokkos::View<Segment *, DevMemSpace>::HostMirror segments_h_;
+};
+
+// Makes all buffers in send and recv (the ranks this rank exchanges buffers with)
+// members of RMABoundaryMessages in one RMA window, which is returned, and empties
+// them.  The ghost zone and flux correction exchanges are given as separate pairs of
+// sends and receives, and the offsets of the messages in the window are exchanged on
+// comm.  Collective over MPI_COMM_WORLD, and so is freeing the window, which is why the
+// messages don't own it.
+using rma_exchange_t =
+    std::pair<RMABoundaryMessage::members_t *, RMABoundaryMessage::members_t *>;
+std::shared_ptr<RMAWindow>
+ExposeInRMAWindow(mpi_comm_t comm, const std::vector<rma_exchange_t> &exchanges);
+
+} // namespace parthenon
+
+#endif // BVALS_COMMS_RMA_COMM_HPP_
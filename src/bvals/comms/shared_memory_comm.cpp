@@ -0,0 +1,263 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "bvals/comms/shared_memory_comm.hpp"
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/error_checking.hpp"
+#include "utils/instrument.hpp"
+
+namespace parthenon {
+
+SharedMemoryWindow::SharedMemoryWindow(mpi_comm_t node_comm, std::size_t bytes) {
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(
+      MPI_Win_allocate_shared(bytes, 1, MPI_INFO_NULL, node_comm, &base_, &win_));
+  // MPI_Win_sync needs a passive target epoch, which lasts as long as the window
+  PARTHENON_MPI_CHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, win_));
+#endif
+}
+
+SharedMemoryWindow::~SharedMemoryWindow() {
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Win_unlock_all(win_));
+  PARTHENON_MPI_CHECK(MPI_Win_free(&win_));
+#endif
+}
+
+char *SharedMemoryWindow::Segment(int node_rank) const {
+#ifdef MPI_PARALLEL
+  MPI_Aint size;
+  int disp_unit;
+  char *segment;
+  PARTHENON_MPI_CHECK(MPI_Win_shared_query(win_, node_rank, &size, &disp_unit, &segment));
+  return segment;
+#else
+  return base_;
+#endif
+}
+
+void SharedMemoryWindow::Sync() const {
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Win_sync(win_));
+#endif
+}
+
+std::size_t SharedMemoryBoundaryMessage::AreaSize(
+    const std::vector<std::pair<buf_t *, int>> &members) {
+  std::size_t n = members.size();
+  for (auto &[buf, size] : members) {
+    n += size;
+  }
+  // keep the counters of the next area aligned
+  const std::size_t bytes = 2 * sizeof(counter_t) + n * sizeof(Real);
+  return (bytes + sizeof(counter_t) - 1) / sizeof(counter_t) * sizeof(counter_t);
+}
+
+SharedMemoryBoundaryMessage::SharedMemoryBoundaryMessage(
+    SharedMemoryWindow *window, char *area, bool sender,
+    const std::vector<std::pair<buf_t *, int>> &members)
+    : window_(window), area_(area),
+      message_(reinterpret_cast<Real *>(area + 2 * sizeof(counter_t))), sender_(sender),
+      segments_(members.size()) {
+  // the flags go first
+  offsets_.push_back(members.size());
+  for (auto &[buf, size] : members) {
+    members_.push_back(buf);
+    sizes_.push_back(size);
+    offsets_.push_back(offsets_.back() + size);
+  }
+}
+
+void SharedMemoryBoundaryMessage::CopySegments(bool pack) {
+  using exec_space_t = Kokkos::DefaultHostExecutionSpace;
+  using policy_t = Kokkos::TeamPolicy<exec_space_t>;
+  const int nmembers = NumMembers();
+  // members fence the instances of their MeshData before they are sent, and the
+  // fence below comes before they are read (see BvarsSubCache_t)
+  Kokkos::View<const Segment *, HostMemSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+      segments(segments_.data(), nmembers);
+  Real *message = message_;
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, policy_t(exec_space_t(), nmembers, Kokkos::AUTO),
+      [=](const policy_t::member_type &team_member) {
+        const int b = team_member.league_rank();
+        const Segment &seg = segments(b);
+        if (pack) {
+          Kokkos::single(Kokkos::PerTeam(team_member),
+                         [&]() { message[b] = (seg.data == nullptr ? 0.0 : 1.0); });
+        }
+        if (seg.data == nullptr) return;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, seg.size),
+                             [&](const int i) {
+                               if (pack) {
+                                 message[seg.offset + i] = seg.data[i];
+                               } else {
+                                 seg.data[i] = message[seg.offset + i];
+                               }
+                             });
+      });
+  exec_space_t().fence();
+}
+
+void SharedMemoryBoundaryMessage::Send(int member) {
+  PARTHENON_DEBUG_REQUIRE(sender_, "Sending from a shared memory receive message.");
+  if (++nready_ < NumMembers()) return;
+  // the previous message has to be read before it is overwritten, which SendComplete
+  // usually has made sure of already
+  while (Read() < count_) {
+    window_->Sync();
+  }
+  for (int b = 0; b < NumMembers(); ++b) {
+    auto *buf = members_[b];
+    const bool null = (buf->GetState() == BufferState::sending_null);
+    PARTHENON_DEBUG_REQUIRE(null || buf->buffer().size() == sizes_[b],
+                            "Buffer size does not match shared memory message layout.");
+    segments_[b] = {null ? nullptr : buf->buffer().data(), offsets_[b], sizes_[b]};
+  }
+  CopySegments(true);
+  // the message has to be visible before the counter announcing it
+  window_->Sync();
+  Written() = ++count_;
+  window_->Sync();
+  nready_ = 0;
+}
+
+bool SharedMemoryBoundaryMessage::SendComplete() {
+  // members that are already sent have to wait for the others
+  if (nready_ > 0) return false;
+  window_->Sync();
+  if (Read() < count_) return false;
+  for (auto *buf : members_) {
+    buf->SetState(BufferState::stale);
+  }
+  return true;
+}
+
+bool SharedMemoryBoundaryMessage::TryReceive() {
+  PARTHENON_DEBUG_REQUIRE(!sender_, "Receiving into a shared memory send message.");
+  window_->Sync();
+  if (Written() <= count_) return false;
+  // don't overwrite data that has not been used yet
+  for (auto *buf : members_) {
+    if (buf->GetState() != BufferState::stale) return false;
+  }
+  // the message is only read after the counter announcing it
+  window_->Sync();
+  for (int b = 0; b < NumMembers(); ++b) {
+    auto *buf = members_[b];
+    if (message_[b] != 0.0) {
+      buf->Allocate();
+      buf->SetState(BufferState::received);
+      segments_[b] = {buf->buffer().data(), offsets_[b], sizes_[b]};
+    } else {
+      if (buf->GetCommType() == BuffCommType::sparse_receiver) buf->Free();
+      buf->SetState(BufferState::received_null);
+      segments_[b] = {nullptr, offsets_[b], 0};
+    }
+  }
+  CopySegments(false);
+  // and the sender may only overwrite it once it has been read
+  window_->Sync();
+  Read() = ++count_;
+  window_->Sync();
+  return true;
+}
+
+std::shared_ptr<SharedMemoryWindow>
+ShareOnNodeMessages(const std::vector<shared_exchange_t> &exchanges) {
+#ifdef MPI_PARALLEL
+  using counter_t = SharedMemoryBoundaryMessage::counter_t;
+  MPI_Comm node_comm;
+  PARTHENON_MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED,
+                                          Globals::my_rank, MPI_INFO_NULL, &node_comm));
+  int node_rank, node_size;
+  PARTHENON_MPI_CHECK(MPI_Comm_rank(node_comm, &node_rank));
+  PARTHENON_MPI_CHECK(MPI_Comm_size(node_comm, &node_size));
+  std::vector<int> world_ranks(node_size);
+  PARTHENON_MPI_CHECK(MPI_Allgather(&Globals::my_rank, 1, MPI_INT, world_ranks.data(), 1,
+                                    MPI_INT, node_comm));
+  std::map<int, int> node_ranks;
+  for (int r = 0; r < node_size; ++r) {
+    node_ranks[world_ranks[r]] = r;
+  }
+
+  // The segment of a rank starts with a table of the offsets of the areas of the
+  // messages it receives, per exchange and sending rank, which is how the senders find
+  // their areas, followed by the areas themselves
+  const int nexchanges = exchanges.size();
+  std::vector<counter_t> table(nexchanges * node_size, 0);
+  std::size_t bytes = table.size() * sizeof(counter_t);
+  for (int e = 0; e < nexchanges; ++e) {
+    for (auto &[rank, members] : *exchanges[e].second) {
+      const auto it = node_ranks.find(rank);
+      if (it == node_ranks.end()) continue;
+      table[e * node_size + it->second] = bytes;
+      bytes += SharedMemoryBoundaryMessage::AreaSize(members);
+    }
+  }
+  auto window = std::make_shared<SharedMemoryWindow>(node_comm, bytes);
+  char *segment = window->Segment(node_rank);
+  std::memcpy(segment, table.data(), table.size() * sizeof(counter_t));
+  std::memset(segment + table.size() * sizeof(counter_t), 0,
+              bytes - table.size() * sizeof(counter_t));
+  window->Sync();
+  PARTHENON_MPI_CHECK(MPI_Barrier(node_comm));
+  window->Sync();
+
+  auto share = [&](SharedMemoryBoundaryMessage::members_t &all_members, bool sender,
+                   int e) {
+    for (auto it = all_members.begin(); it != all_members.end();) {
+      const auto node_rank_it = node_ranks.find(it->first);
+      if (node_rank_it == node_ranks.end()) {
+        ++it;
+        continue;
+      }
+      // the area is in the segment of the receiver
+      const int receiver = sender ? node_rank_it->second : node_rank;
+      const int sending_rank = sender ? node_rank : node_rank_it->second;
+      char *receiver_segment = window->Segment(receiver);
+      const counter_t offset =
+          reinterpret_cast<counter_t *>(receiver_segment)[e * node_size + sending_rank];
+      auto &members = it->second;
+      auto message = std::make_shared<SharedMemoryBoundaryMessage>(
+          window.get(), receiver_segment + offset, sender, members);
+      for (int b = 0; b < static_cast<int>(members.size()); ++b) {
+        members[b].first->SetGroup(message, b);
+      }
+      it = all_members.erase(it);
+    }
+  };
+  for (int e = 0; e < nexchanges; ++e) {
+    share(*exchanges[e].first, true, e);
+    share(*exchanges[e].second, false, e);
+  }
+  PARTHENON_MPI_CHECK(MPI_Comm_free(&node_comm));
+  return window;
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace parthenon
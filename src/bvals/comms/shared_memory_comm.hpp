@@ -0,0 +1,135 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#ifndef BVALS_COMMS_SHARED_MEMORY_COMM_HPP_
+#define BVALS_COMMS_SHARED_MEMORY_COMM_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/communication_buffer.hpp"
+#include "utils/object_pool.hpp"
+
+namespace parthenon {
+
+// An MPI-3 shared memory window over the ranks of one node.  Every rank owns one
+// segment of it, which all other ranks of the node can address directly.
+class SharedMemoryWindow {
+ public:
+  // Collective over node_comm, which has to be a shared memory communicator (see
+  // MPI_Comm_split_type)
+  SharedMemoryWindow(mpi_comm_t node_comm, std::size_t bytes);
+  ~SharedMemoryWindow();
+
+  SharedMemoryWindow(const SharedMemoryWindow &) = delete;
+  SharedMemoryWindow &operator=(const SharedMemoryWindow &) = delete;
+
+  // the segment of the rank with rank node_rank in node_comm
+  char *Segment(int node_rank) const;
+  // memory barrier for the window, between writing data and the flag announcing it
+  void Sync() const;
+
+ private:
+#ifdef MPI_PARALLEL
+  MPI_Win win_;
+#endif
+  char *base_ = nullptr;
+};
+
+// All boundary buffers exchanged between this rank and another rank on the same node in
+// one direction, written by the sender directly into an area of the shared memory
+// segment of the receiver instead of going through MPI.  The area starts with two
+// counters, the number of messages written by the sender and the number of messages
+// read by the receiver, followed by a message with the same layout as a
+// CoalescedBoundaryMessage, i.e.,
+//   [ one flag per member (0 for a null buffer) | member 0 | member 1 | ... ]
+// with the members in channel key order.  The sender writes a message once every member
+// has been sent and the receiver has read the previous one, and the receiver reads it
+// once every member has been staled again.  Both sides only spin on the counters, so
+// this requires the members to be accessible from the host.
+class SharedMemoryBoundaryMessage : public CommBufferGroup {
+ public:
+  using buf_t = CommBuffer<buf_pool_t<Real>::owner_t>;
+  using counter_t = std::int64_t;
+  // pairs of buffers and their full sizes per other rank, in channel key order
+  using members_t = std::map<int, std::vector<std::pair<buf_t *, int>>>;
+
+  // area points to the area of the message in the segment of the receiver, which has
+  // to be AreaSize(members) bytes large and start with zeroed counters.  The window has
+  // to outlive the message.
+  SharedMemoryBoundaryMessage(SharedMemoryWindow *window, char *area,
+                              bool sender,
+                              const std::vector<std::pair<buf_t *, int>> &members);
+
+  // size in bytes of the area of a message with these members
+  static std::size_t AreaSize(const std::vector<std::pair<buf_t *, int>> &members);
+
+  void Send(int member) override;
+  bool SendComplete() override;
+  void TryStartReceive() override {}
+  bool TryReceive() override;
+
+  int NumMembers() const { return members_.size(); }
+
+ private:
+  struct Segment {
+    Real *data;
+    int offset;
+    int size;
+  };
+  // copy between the members and the message in one host kernel, in the direction
+  // given (true for packing into the message)
+  void CopySegments(bool pack);
+
+  volatile counter_t &Written() const {
+    return reinterpret_cast<volatile counter_t *>(area_)[0];
+  }
+  volatile counter_t &Read() const {
+    return reinterpret_cast<volatile counter_t *>(area_)[1];
+  }
+
+  SharedMemoryWindow *window_;
+  char *area_;
+  Real *message_;
+  bool sender_;
+  std::vector<buf_t *> members_;
+  std::vector<int> sizes_, offsets_;
+  std::vector<Segment> segments_;
+  int nready_ = 0;
+  // number of messages written or read by this side
+  counter_t count_ = 0;
+};
+
+// Takes all on-node ranks out of send and recv (which only have to contain the ranks
+// that this rank exchanges buffers with) and makes their buffers members of
+// SharedMemoryBoundaryMessages in one shared memory window, which is returned.  The ghost
+// zone and flux correction exchanges are given as separate pairs of sends and receives.
+// Collective over MPI_COMM_WORLD, and so is freeing the window, which is why the
+// messages don't own it.
+using shared_exchange_t = std::pair<SharedMemoryBoundaryMessage::members_t *,
+                                    SharedMemoryBoundaryMessage::members_t *>;
+std::shared_ptr<SharedMemoryWindow>
+ShareOnNodeMessages(const std::vector<shared_exchange_t> &exchanges);
+
+} // namespace parthenon
+
+#endif // BVALS_COMMS_SHARED_MEMORY_COMM_HPP_
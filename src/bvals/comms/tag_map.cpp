@@ -16,6 +16,14 @@
 //========================================================================================
 
 #include "tag_map.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
 #include "bnd_info.hpp"
 #include "bvals_utils.hpp"
 #include "utils/loop_utils.hpp"
@@ -35,12 +43,23 @@ TagMap::rank_pair_t TagMap::MakeChannelPair(const MeshBlock *pmb,
 }
 template <BoundaryType BOUND>
 void TagMap::AddMeshDataToMap(std::shared_ptr<MeshData<Real>> &md) {
+  // The channel does not depend on the variable, so only the first variable of a block
+  // has to be recorded for each of its neighbors
+  const MeshBlock *last_pmb = nullptr;
+  std::unordered_set<const NeighborBlock *> added;
   ForEachBoundary<BOUND>(md, [&](auto pmb, sp_mbd_t rc, nb_t &nb, const sp_cv_t v) {
+    if (pmb != last_pmb) {
+      last_pmb = pmb;
+      added.clear();
+    }
+    if (!added.insert(&nb).second) return;
     const int other_rank = nb.snb.rank;
-    if (map_.count(other_rank) < 1) map_[other_rank] = rank_pair_map_t();
-    auto &pair_map = map_[other_rank];
-    // Add channel key with an invalid tag
-    pair_map[MakeChannelPair(pmb, nb)] = -1;
+    const auto pair = MakeChannelPair(pmb, nb);
+    // Duplicates (from other MeshData containing the same channel) are removed when the
+    // map is resolved
+    channels_[other_rank].push_back(pair);
+    const int orientation = (1 + nb.ni.ox1) + 3 * (1 + nb.ni.ox2 + 3 * (1 + nb.ni.ox3));
+    local_.push_back({pmb->gid, nb.snb.gid, orientation, other_rank, pair, -1});
   });
 }
 template void
@@ -65,22 +84,66 @@ void TagMap::ResolveMap() {
     PARTHENON_FAIL("MPI error, cannot query largest supported MPI tag value.");
   }
 #endif
-  for (auto it = map_.begin(); it != map_.end(); ++it) {
-    auto &pair_map = it->second;
-    int idx = 0;
-    std::for_each(pair_map.begin(), pair_map.end(),
-                  [&idx](auto &pair) { pair.second = idx++; });
+  for (auto &[other_rank, pairs] : channels_) {
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end(),
+                            [](const rank_pair_t &a, const rank_pair_t &b) {
+                              return a.first == b.first && a.second == b.second;
+                            }),
+                pairs.end());
 #ifdef MPI_PARALLEL
-    if (idx > (*reinterpret_cast<int *>(max_tag)) && it->first != Globals::my_rank)
+    if (static_cast<std::int64_t>(pairs.size()) * nslots_ >
+            (*reinterpret_cast<int *>(max_tag)) &&
+        other_rank != Globals::my_rank)
       PARTHENON_FAIL("Number of tags exceeds the maximum allowed by this MPI version.");
 #endif
   }
+
+  auto key = [](const LocalChannel &c) {
+    return std::make_tuple(c.gid, c.nb_gid, c.orientation);
+  };
+  std::sort(local_.begin(), local_.end(),
+            [&](const LocalChannel &a, const LocalChannel &b) {
+              return key(a) < key(b);
+            });
+  local_.erase(std::unique(local_.begin(), local_.end(),
+                           [&](const LocalChannel &a, const LocalChannel &b) {
+                             return key(a) == key(b);
+                           }),
+               local_.end());
+  for (auto &c : local_) {
+    const auto &pairs = channels_[c.other_rank];
+    const int idx = std::lower_bound(pairs.begin(), pairs.end(), c.pair) - pairs.begin();
+    c.tag = idx * nslots_;
+  }
+
+  offsets_.clear();
+  if (local_.empty()) return;
+  gid_offset_ = local_.front().gid;
+  offsets_.assign(local_.back().gid - gid_offset_ + 2, 0);
+  for (const auto &c : local_) {
+    offsets_[c.gid - gid_offset_ + 1]++;
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
 }
 
-int TagMap::GetTag(const MeshBlock *pmb, const NeighborBlock &nb) {
-  const int other_rank = nb.snb.rank;
-  auto &pair_map = map_[other_rank];
-  return pair_map[MakeChannelPair(pmb, nb)];
+int TagMap::GetTag(const MeshBlock *pmb, const NeighborBlock &nb, const int slot) {
+  const int orientation = (1 + nb.ni.ox1) + 3 * (1 + nb.ni.ox2 + 3 * (1 + nb.ni.ox3));
+  const int b = pmb->gid - gid_offset_;
+  PARTHENON_DEBUG_REQUIRE(b >= 0 && b + 1 < static_cast<int>(offsets_.size()),
+                          "Block has no channels in the resolved TagMap.");
+  // A block has at most a few dozen channels, which are sorted by neighbor
+  const auto begin = local_.begin() + offsets_[b];
+  const auto end = local_.begin() + offsets_[b + 1];
+  const auto it = std::lower_bound(
+      begin, end, std::make_pair(nb.snb.gid, orientation),
+      [](const LocalChannel &c, const std::pair<int, int> &k) {
+        return std::make_pair(c.nb_gid, c.orientation) < k;
+      });
+  PARTHENON_DEBUG_REQUIRE(it != end && it->nb_gid == nb.snb.gid &&
+                              it->orientation == orientation,
+                          "Channel was not added to the TagMap before it was resolved.");
+  return it->tag + slot;
 }
 
 } // namespace parthenon
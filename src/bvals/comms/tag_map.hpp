@@ -18,9 +18,9 @@
 #ifndef BVALS_COMMS_TAG_MAP_HPP_
 #define BVALS_COMMS_TAG_MAP_HPP_
 
-#include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "basic_types.hpp"
 
@@ -78,13 +78,28 @@ class NeighborBlock;
 class TagMap {
   // Unique keys defined by a two-way communication channel
   using rank_pair_t = UnorderedPair<BlockGeometricElementId>;
-  // Map between a communication channel key and a unique MPI tag
-  using rank_pair_map_t = std::map<rank_pair_t, int>;
-  // Map of maps where the key corresponds to the MPI rank of the
-  // other process
-  using tag_map_t = std::unordered_map<int, rank_pair_map_t>;
 
-  tag_map_t map_;
+  // A channel as seen from one of the local blocks it connects, together with the rank
+  // of the other block.  Once the map is resolved, tag holds the first of the nslots
+  // tags of the channel.
+  struct LocalChannel {
+    int gid, nb_gid, orientation;
+    int other_rank;
+    rank_pair_t pair;
+    int tag;
+  };
+
+  // Channel keys, per rank of the other process, sorted and made unique by ResolveMap so
+  // that the position of a key is its (rank consistent) index
+  std::unordered_map<int, std::vector<rank_pair_t>> channels_;
+  // All channels of the local blocks, sorted by (gid, nb_gid, orientation), and the
+  // offsets of the channels of each block into it, i.e., the channels of block gid are
+  // [offsets_[gid - gid_offset_], offsets_[gid - gid_offset_ + 1])
+  std::vector<LocalChannel> local_;
+  std::vector<int> offsets_;
+  int gid_offset_ = 0;
+  // number of fields sharing a communicator, see Mesh::SetupMPIComms
+  int nslots_ = 1;
 
   // Given the two blocks (one described by the MeshBlock and the other described by the
   // firsts NeighborBlock information) return an ordered pair of BlockGeometricElementIds
@@ -93,21 +108,31 @@ class TagMap {
   rank_pair_t MakeChannelPair(const MeshBlock *pmb, const NeighborBlock &nb);
 
  public:
-  void clear() { map_.clear(); }
+  void clear() {
+    channels_.clear();
+    local_.clear();
+    offsets_.clear();
+    gid_offset_ = 0;
+  }
+
+  // Every channel gets nslots consecutive tags, one for each of the fields that share a
+  // communicator.  Has to be set before the map is resolved.
+  void SetNumSlots(const int nslots) { nslots_ = nslots; }
 
   // Inserts all of the communication channels known about by MeshData md into the map
   template <BoundaryType BOUND>
   void AddMeshDataToMap(std::shared_ptr<MeshData<Real>> &md);
 
   // Once all MeshData objects have inserted their known channels into the map, we can
-  // iterate through a map for a given rank pair (which is already ordered by key because
-  // of the properties of st::map) and assign each key a unique tag. By construction, this
-  // tag is consistent across all ranks.
+  // sort the channels for a given rank pair and assign each key a unique tag given by
+  // its position. By construction, this tag is consistent across all ranks.  The tags
+  // are then stored in a flat table of the channels of the local blocks, so that they
+  // don't have to be looked up again every time the buffers are rebuilt.
   void ResolveMap();
 
   // After the map has been resolved, get the tag for a particular MeshBlock NeighborBlock
-  // pair
-  int GetTag(const MeshBlock *pmb, const NeighborBlock &nb);
+  // pair, and the field in the given slot of its communicator
+  int GetTag(const MeshBlock *pmb, const NeighborBlock &nb, const int slot = 0);
 };
 } // namespace parthenon
 
@@ -15,6 +15,7 @@
 
 #include "config.hpp"
 
+#include "tabulated_cartesian.hpp"
 #include "uniform_cartesian.hpp"
 
 namespace parthenon {
@@ -0,0 +1,374 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef COORDINATES_TABULATED_CARTESIAN_HPP_
+#define COORDINATES_TABULATED_CARTESIAN_HPP_
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <string>
+
+#include "basic_types.hpp"
+#include "defs.hpp"
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parameter_input.hpp"
+
+namespace parthenon {
+
+// Cartesian coordinates whose cell faces are given by a mapping of the uniform grid
+// UniformCartesian would use, evaluated once per block and stored in tables rather than
+// in every kernel.  The mapping is the geometric stretching of the <parthenon/mesh>
+// input block, i.e., each cell of the root grid is xrat times wider than its left
+// neighbor, and finer levels split the cells of coarser ones, so the faces of
+// neighboring blocks on any level coincide.  With xrat = 1 the coordinates are the
+// same as those of UniformCartesian.
+//
+// The tables of all three directions share one device allocation (and a host mirror
+// for use outside of kernels), which the object only refers to by a pointer, so
+// fetching the coordinates of a block from a pack is a single load of a small struct.
+// For every direction the table holds, in this order, the positions of faces, the
+// positions of cell centers, the widths of cells and the distances between
+// neighboring cell centers, each with one extra cell on both ends beyond the ghost
+// zones.  Areas and volumes are products of cell widths and are not tabulated.
+//
+// The accessors without indices (e.g. Dxc<dir>() and GetXmin()) give the uniform
+// logical grid the tables are built from, for code that requires uniform coordinates.
+class TabulatedCartesian {
+ public:
+  TabulatedCartesian() = default;
+  TabulatedCartesian(const RegionSize &rs, ParameterInput *pin) {
+    for (auto &dir : {X1DIR, X2DIR, X3DIR}) {
+      const int d = dir - 1;
+      dx_[d] = (rs.xmax(dir) - rs.xmin(dir)) / rs.nx(dir);
+      istart_[d] = (!rs.symmetry(dir) ? Globals::nghost : 0);
+      xmin_[d] = rs.xmin(dir) - istart_[d] * dx_[d];
+      ncells_[d] = rs.nx(dir) + 2 * istart_[d];
+      if (pin != nullptr) {
+        const std::string n = std::to_string(dir);
+        map_x0_[d] = pin->GetReal("parthenon/mesh", "x" + n + "min");
+        map_len_[d] = pin->GetReal("parthenon/mesh", "x" + n + "max") - map_x0_[d];
+        map_nx_[d] = pin->GetInteger("parthenon/mesh", "nx" + n);
+        map_rat_[d] = pin->GetOrAddReal("parthenon/mesh", "x" + n + "rat", 1.0);
+      } else {
+        map_x0_[d] = rs.xmin(dir);
+        map_len_[d] = rs.xmax(dir) - rs.xmin(dir);
+        map_nx_[d] = rs.nx(dir);
+        map_rat_[d] = rs.xrat(dir);
+      }
+      if (rs.symmetry(dir)) map_rat_[d] = 1.0;
+    }
+    BuildTables_();
+  }
+  TabulatedCartesian(const TabulatedCartesian &src, int coarsen)
+      : istart_(src.istart_), map_x0_(src.map_x0_), map_len_(src.map_len_),
+        map_rat_(src.map_rat_), map_nx_(src.map_nx_) {
+    dx_ = src.dx_;
+    xmin_ = src.xmin_;
+    for (int d = 0; d < 3; ++d) {
+      const int c = (d == 0 || istart_[d] > 0) ? coarsen : 1;
+      xmin_[d] += istart_[d] * dx_[d] * (1 - c);
+      dx_[d] *= c;
+      ncells_[d] = (src.ncells_[d] - 2 * istart_[d]) / c + 2 * istart_[d];
+    }
+    BuildTables_();
+  }
+
+  //----------------------------------------
+  // Dxc: Distance between cell centers
+  //----------------------------------------
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Dxc() const {
+    assert(dir > 0 && dir < 4);
+    return dx_[dir - 1];
+  }
+  KOKKOS_FORCEINLINE_FUNCTION Real DxcFA(const int dir) const {
+    assert(dir > 0 && dir < 4);
+    return dx_[dir - 1];
+  }
+  // distance between the centers of cell idx - 1 and cell idx
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Dxc(const int idx) const {
+    assert(dir > 0 && dir < 4);
+    return Table_(dir, dxc_table, idx);
+  }
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Dxc(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Dxc<dir>(Index_<dir>(k, j, i));
+  }
+  KOKKOS_FORCEINLINE_FUNCTION Real DxcFA(const int dir, const int k, const int j,
+                                         const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Table_(dir, dxc_table, IndexFA_(dir, k, j, i));
+  }
+
+  //----------------------------------------
+  // Dxf: Distance between cell faces
+  //----------------------------------------
+  template <int dir, int face>
+  KOKKOS_FORCEINLINE_FUNCTION Real Dxf(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4 && face > 0 && face < 4);
+    return CellWidth<face>(k, j, i);
+  }
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Dxf(const int idx) const {
+    assert(dir > 0 && dir < 4);
+    return Table_(dir, dx_table, idx);
+  }
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Dxf(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    return CellWidth<dir>(k, j, i);
+  }
+
+  //----------------------------------------
+  // Xc: Positions at cell centers
+  //----------------------------------------
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Xc(const int idx) const {
+    assert(dir > 0 && dir < 4);
+    return Table_(dir, xc_table, idx);
+  }
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Xc(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Xc<dir>(Index_<dir>(k, j, i));
+  }
+
+  //----------------------------------------
+  // Xf: Positions on Faces
+  //----------------------------------------
+  template <int dir, int face>
+  KOKKOS_FORCEINLINE_FUNCTION Real Xf(const int idx) const {
+    assert(dir > 0 && dir < 4 && face > 0 && face < 4);
+    // Return position in direction "dir" along index "idx" on face "face"
+    if constexpr (dir == face) {
+      return Xf<dir>(idx);
+    } else {
+      return Xc<dir>(idx);
+    }
+  }
+  template <int dir, int face>
+  KOKKOS_FORCEINLINE_FUNCTION Real Xf(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Xf<dir, face>(Index_<dir>(k, j, i));
+  }
+
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Xf(const int idx) const {
+    assert(dir > 0 && dir < 4);
+    // Return position in direction "dir" along index "idx" on face "dir"
+    return Table_(dir, xf_table, idx);
+  }
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real Xf(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Xf<dir>(Index_<dir>(k, j, i));
+  }
+
+  template <int dir, TopologicalElement el>
+  KOKKOS_FORCEINLINE_FUNCTION Real X(const int idx) const {
+    if constexpr ((dir == X1DIR && TopologicalOffsetI(el)) ||
+                  (dir == X2DIR && TopologicalOffsetJ(el)) ||
+                  (dir == X3DIR && TopologicalOffsetK(el))) {
+      return Xf<dir>(idx); // idx - 1/2
+    } else {
+      return Xc<dir>(idx); // idx
+    }
+    return 0; // This should never be reached, but w/o it some compilers generate warnings
+  }
+
+  template <int dir, TopologicalElement el>
+  KOKKOS_FORCEINLINE_FUNCTION Real X(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    return X<dir, el>(Index_<dir>(k, j, i));
+  }
+
+  //----------------------------------------
+  // CellWidth: Width of cells at cell centers
+  //----------------------------------------
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real CellWidth(const int k, const int j,
+                                             const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Table_(dir, dx_table, Index_<dir>(k, j, i));
+  }
+  KOKKOS_FORCEINLINE_FUNCTION Real CellWidthFA(const int dir, const int k, const int j,
+                                               const int i) const {
+    assert(dir > 0 && dir < 4);
+    return Table_(dir, dx_table, IndexFA_(dir, k, j, i));
+  }
+
+  //----------------------------------------
+  // EdgeLength: Length of cell edges
+  //----------------------------------------
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real EdgeLength(const int k, const int j,
+                                              const int i) const {
+    assert(dir > 0 && dir < 4);
+    return CellWidth<dir>(k, j, i);
+  }
+  KOKKOS_FORCEINLINE_FUNCTION Real EdgeLengthFA(const int dir, const int k, const int j,
+                                                const int i) const {
+    return CellWidthFA(dir, k, j, i);
+  }
+
+  //----------------------------------------
+  // FaceArea: Area of cell areas
+  //----------------------------------------
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION Real FaceArea(const int k, const int j, const int i) const {
+    assert(dir > 0 && dir < 4);
+    if constexpr (dir == X1DIR) {
+      return CellWidth<X2DIR>(k, j, i) * CellWidth<X3DIR>(k, j, i);
+    } else if constexpr (dir == X2DIR) {
+      return CellWidth<X1DIR>(k, j, i) * CellWidth<X3DIR>(k, j, i);
+    } else {
+      return CellWidth<X1DIR>(k, j, i) * CellWidth<X2DIR>(k, j, i);
+    }
+  }
+  KOKKOS_FORCEINLINE_FUNCTION Real FaceAreaFA(const int dir, const int k, const int j,
+                                              const int i) const {
+    assert(dir > 0 && dir < 4);
+    if (dir == X1DIR) return FaceArea<X1DIR>(k, j, i);
+    if (dir == X2DIR) return FaceArea<X2DIR>(k, j, i);
+    return FaceArea<X3DIR>(k, j, i);
+  }
+
+  //----------------------------------------
+  // CellVolume
+  //----------------------------------------
+  KOKKOS_FORCEINLINE_FUNCTION Real CellVolume(const int k, const int j,
+                                              const int i) const {
+    return CellWidth<X1DIR>(k, j, i) * CellWidth<X2DIR>(k, j, i) *
+           CellWidth<X3DIR>(k, j, i);
+  }
+
+  //----------------------------------------
+  // Generalized volume
+  //----------------------------------------
+  template <TopologicalElement el>
+  KOKKOS_FORCEINLINE_FUNCTION Real Volume(const int k, const int j, const int i) const {
+    using TE = TopologicalElement;
+    if constexpr (el == TE::CC) {
+      return CellVolume(k, j, i);
+    } else if constexpr (el == TE::F1) {
+      return FaceArea<X1DIR>(k, j, i);
+    } else if constexpr (el == TE::F2) {
+      return FaceArea<X2DIR>(k, j, i);
+    } else if constexpr (el == TE::F3) {
+      return FaceArea<X3DIR>(k, j, i);
+    } else if constexpr (el == TE::E1) {
+      return CellWidth<X1DIR>(k, j, i);
+    } else if constexpr (el == TE::E2) {
+      return CellWidth<X2DIR>(k, j, i);
+    } else if constexpr (el == TE::E3) {
+      return CellWidth<X3DIR>(k, j, i);
+    } else if constexpr (el == TE::NN) {
+      return 1.0;
+    }
+    PARTHENON_FAIL("If you reach this point, someone has added a new value to the the "
+                   "TopologicalElement enum.");
+    return 0.0;
+  }
+
+  const std::array<Real, 3> &GetXmin() const { return xmin_; }
+  const std::array<int, 3> &GetStartIndex() const { return istart_; }
+  const char *Name() const { return name_; }
+
+ private:
+  // tables in each direction, in the order they are stored
+  enum Table { xf_table, xc_table, dx_table, dxc_table, ntables };
+  // extra cells tabulated on both ends
+  static constexpr int pad_ = 1;
+
+  std::array<int, 3> istart_, ncells_;
+  std::array<Real, 3> xmin_, dx_;
+  // the mapping, see Map_
+  std::array<Real, 3> map_x0_, map_len_, map_rat_;
+  std::array<int, 3> map_nx_;
+  // start of the tables of each direction
+  std::array<int, 3> offset_;
+  ParArray1D<Real> tables_;
+  typename ParArray1D<Real>::HostMirror tables_h_;
+  const Real *tables_d_ptr_ = nullptr, *tables_h_ptr_ = nullptr;
+  constexpr static const char *name_ = "TabulatedCartesian";
+
+  // every table of direction d has this many entries, cell tables only use the first
+  // ncells + 2 pad_
+  KOKKOS_FORCEINLINE_FUNCTION int TableSize_(const int d) const {
+    return ncells_[d] + 2 * pad_ + 1;
+  }
+
+  KOKKOS_FORCEINLINE_FUNCTION Real Table_(const int dir, const Table table,
+                                          const int idx) const {
+    const int d = dir - 1;
+    const int n = offset_[d] + table * TableSize_(d) + idx + pad_;
+    KOKKOS_IF_ON_DEVICE((return tables_d_ptr_[n];))
+    KOKKOS_IF_ON_HOST((return tables_h_ptr_[n];))
+  }
+
+  template <int dir>
+  KOKKOS_FORCEINLINE_FUNCTION static int Index_(const int k, const int j, const int i) {
+    if constexpr (dir == X1DIR) {
+      return i;
+    } else if constexpr (dir == X2DIR) {
+      return j;
+    } else {
+      return k;
+    }
+  }
+  KOKKOS_FORCEINLINE_FUNCTION static int IndexFA_(const int dir, const int k, const int j,
+                                                  const int i) {
+    return dir == X1DIR ? i : (dir == X2DIR ? j : k);
+  }
+
+  // stretched position of the position u on the uniform logical grid of direction d
+  Real Map_(const int d, const Real u) const {
+    if (map_rat_[d] == 1.0) return u;
+    const Real r_n = std::pow(map_rat_[d], map_nx_[d]);
+    const Real s = map_nx_[d] * (u - map_x0_[d]) / map_len_[d];
+    return map_x0_[d] + map_len_[d] * (std::pow(map_rat_[d], s) - 1.0) / (r_n - 1.0);
+  }
+
+  void BuildTables_() {
+    int size = 0;
+    for (int d = 0; d < 3; ++d) {
+      offset_[d] = size;
+      size += ntables * TableSize_(d);
+    }
+    tables_ = ParArray1D<Real>("TabulatedCartesian tables", size);
+    tables_h_ = Kokkos::create_mirror_view(tables_);
+    for (int d = 0; d < 3; ++d) {
+      auto entry = [&](const Table table, const int idx) -> Real & {
+        return tables_h_(offset_[d] + table * TableSize_(d) + idx + pad_);
+      };
+      const auto xf = [&](const int idx) { return Map_(d, xmin_[d] + idx * dx_[d]); };
+      const auto xc = [&](const int idx) { return 0.5 * (xf(idx) + xf(idx + 1)); };
+      for (int idx = -pad_; idx <= ncells_[d] + pad_; ++idx) {
+        entry(xf_table, idx) = xf(idx);
+        entry(xc_table, idx) = xc(idx);
+        entry(dx_table, idx) = xf(idx + 1) - xf(idx);
+        entry(dxc_table, idx) = xc(idx) - xc(idx - 1);
+      }
+    }
+    Kokkos::deep_copy(tables_, tables_h_);
+    tables_d_ptr_ = tables_.data();
+    tables_h_ptr_ = tables_h_.data();
+  }
+};
+
+} // namespace parthenon
+
+#endif // COORDINATES_TABULATED_CARTESIAN_HPP_
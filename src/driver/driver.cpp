@@ -12,26 +12,76 @@
 //========================================================================================
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
 
 #include "driver/driver.hpp"
 
 #include "bvals/comms/bvals_in_one.hpp"
 #include "globals.hpp"
 #include "interface/update.hpp"
+#include "mesh/memory_report.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/meshblock.hpp"
+#include "outputs/inline_diagnostics.hpp"
 #include "outputs/outputs.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_mpi.hpp"
+#include "tasks/task_timeline.hpp"
+#include "utils/comm_counters.hpp"
+#include "utils/phase_times.hpp"
 #include "utils/utils.hpp"
 
 namespace parthenon {
 using SignalHandler::OutputSignal;
 
+namespace {
+// traffic between two readings of CommCounters, summed into boundary, flux correction,
+// geometric multigrid and block migration traffic
+constexpr std::array<const char *, 4> traffic_groups{"bvals", "flxcor", "gmg",
+                                                     "migration"};
+std::array<CommCounters::Counts, 4>
+GroupTraffic(const std::vector<CommCounters::Counts> &now,
+             const std::vector<CommCounters::Counts> &prev) {
+  std::array<CommCounters::Counts, 4> traffic;
+  for (int kind = 0; kind < CommCounters::nkinds; ++kind) {
+    const auto type = static_cast<BoundaryType>(kind);
+    int group = 3;
+    if (kind < CommCounters::migration) {
+      group = 2;
+      if (type == BoundaryType::local || type == BoundaryType::nonlocal ||
+          type == BoundaryType::any)
+        group = 0;
+      if (type == BoundaryType::flxcor_send || type == BoundaryType::flxcor_recv)
+        group = 1;
+    }
+    traffic[group] += now[kind] - prev[kind];
+  }
+  return traffic;
+}
+
+// the high-water mark of the host memory this process has used
+double HostPeakBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  // in kilobytes
+  return 1024.0 * usage.ru_maxrss;
+#endif
+}
+} // namespace
+
 // Declare class static variables
 Kokkos::Timer Driver::timer_main;
 Kokkos::Timer Driver::timer_cycle;
@@ -82,8 +132,31 @@ DriverStatus EvolutionDriver::Execute() {
   OutputSignal signal = OutputSignal::none;
   pouts->MakeOutputs(pmesh, pinput, &tm, signal);
   pmesh->mbcnt = 0;
+  StartPhaseReportWindow();
+  phase_times_prev = PhaseTimes::AllSeconds();
+  phase_times_cycle = tm.ncycle;
+  comm_counts_prev = CommCounters::GetAll();
+  comm_counts_csv_prev = comm_counts_prev;
+  comm_counts_csv_cycle = tm.ncycle;
+  telemetry_phase_prev = phase_times_prev;
+  telemetry_comm_prev = comm_counts_prev;
+  telemetry_cycle = tm.ncycle;
+  telemetry_timer.reset();
   int perf_cycle_offset =
       pinput->GetOrAddInteger("parthenon/time", "perf_cycle_offset", 0);
+  // optionally record a timeline of all tasks executed in a window of cycles
+  const bool task_timeline =
+      pinput->GetOrAddBoolean("parthenon/driver", "task_timeline", false);
+  const int timeline_start =
+      pinput->GetOrAddInteger("parthenon/driver", "task_timeline_start_cycle", 0);
+  const int timeline_ncycles =
+      pinput->GetOrAddInteger("parthenon/driver", "task_timeline_ncycles", 1);
+  auto WriteTaskTimeline = [&]() {
+    if (!TaskTimeline::Recording()) return;
+    TaskTimeline::SetRecording(false);
+    TaskTimeline::Write("task_timeline." + std::to_string(Globals::my_rank) + ".json");
+    TaskTimeline::Clear();
+  };
 
   // Output a text file of all parameters at this point
   // Defaults must be set across all ranks
@@ -92,16 +165,37 @@ DriverStatus EvolutionDriver::Execute() {
   { // Main t < tmax loop region
     PARTHENON_INSTRUMENT
     while (tm.KeepGoing()) {
+      FinishGlobalTimeStep();
+      ReducePhaseTimes();
       if (Globals::my_rank == 0) OutputCycleDiagnostics();
+      OutputMemoryReport();
+      OutputCommCounts();
+      OutputTelemetry();
 
       pmesh->PreStepUserWorkInLoop(pmesh, pinput, tm);
       pmesh->PreStepUserDiagnosticsInLoop(pmesh, pinput, tm);
 
-      TaskListStatus status = Step();
+      // the inline diagnostics hold the values of the current cycle
+      for (const auto &pkg : pmesh->packages.AllPackages()) {
+        const auto &params = pkg.second->AllParams();
+        if (params.hasKey(inline_diag_param_key)) {
+          params.Get<std::shared_ptr<InlineDiagnostics>>(inline_diag_param_key)->Reset();
+        }
+      }
+
+      if (task_timeline && tm.ncycle == timeline_start) TaskTimeline::SetRecording(true);
+      TaskListStatus status;
+      Kokkos::Timer step_timer;
+      {
+        PhaseTimes::Scope step_time(PhaseTimes::Phase::step);
+        status = Step();
+      }
+      const bool repartitioned = pmesh->TunePackSize(step_timer.seconds());
       if (status != TaskListStatus::complete) {
         std::cerr << "Step failed to complete all tasks." << std::endl;
         return DriverStatus::failed;
       }
+      if (tm.ncycle + 1 == timeline_start + timeline_ncycles) WriteTaskTimeline();
 
       pmesh->PostStepUserWorkInLoop(pmesh, pinput, tm);
       pmesh->PostStepUserDiagnosticsInLoop(pmesh, pinput, tm);
@@ -109,13 +203,23 @@ DriverStatus EvolutionDriver::Execute() {
       tm.ncycle++;
       tm.time += tm.dt;
       pmesh->mbcnt += pmesh->nbtotal;
+      telemetry_block_cycles += pmesh->nbtotal;
       pmesh->step_since_lb++;
 
       timer_LBandAMR.reset();
-      pmesh->LoadBalancingAndAdaptiveMeshRefinement(pinput, app_input);
-      if (pmesh->modified) InitializeBlockTimeStepsAndBoundaries();
+      pmesh->LoadBalancingAndAdaptiveMeshRefinement(pinput, app_input, true);
+      if (pmesh->modified || repartitioned) {
+        Kokkos::Timer timer;
+        InitializeBlockTimeStepsAndBoundaries();
+        pmesh->remesh_times.buffers += timer.seconds();
+      }
       time_LBandAMR += timer_LBandAMR.seconds();
-      SetGlobalTimeStep();
+      PhaseTimes::Add(PhaseTimes::Phase::amr, timer_LBandAMR.seconds());
+      if (overlap_dt_reduction) {
+        StartGlobalTimeStep();
+      } else {
+        SetGlobalTimeStep();
+      }
 
       // check for signals
       signal = SignalHandler::CheckSignalFlags();
@@ -127,27 +231,38 @@ DriverStatus EvolutionDriver::Execute() {
       // skip the final (last) output at the end of the simulation time as it happens
       // later
       if (tm.KeepGoing()) {
+        PhaseTimes::Scope output_time(PhaseTimes::Phase::output);
         pouts->MakeOutputs(pmesh, pinput, &tm, signal);
       }
 
       if (tm.ncycle == perf_cycle_offset) {
         pmesh->mbcnt = 0;
         timer_main.reset();
+        StartPhaseReportWindow();
       }
     } // END OF MAIN INTEGRATION LOOP
       // ======================================================
   }   // Main t < tmax loop region
+  FinishGlobalTimeStep();
+  SignalHandler::FinishSignalCheck();
 
+  WriteTaskTimeline();
   pmesh->UserWorkAfterLoop(pmesh, pinput, tm);
 
   DriverStatus status = DriverStatus::complete;
 
-  pouts->MakeOutputs(pmesh, pinput, &tm, OutputSignal::final);
+  {
+    PhaseTimes::Scope output_time(PhaseTimes::Phase::output);
+    pouts->MakeOutputs(pmesh, pinput, &tm, OutputSignal::final);
+  }
   PostExecute(status);
   return status;
 }
 
 void EvolutionDriver::PostExecute(DriverStatus status) {
+  ReducePhaseTimes();
+  WritePhaseReport();
+  if (telemetry) telemetry->Wait();
   // Print diagnostic messages related to the end of the simulation
   if (Globals::my_rank == 0) {
     OutputCycleDiagnostics();
@@ -192,6 +307,56 @@ void EvolutionDriver::InitializeBlockTimeStepsAndBoundaries() {
       BuildGMGBoundaryBuffers(mdg);
     }
   }
+  CoalesceBoundaryBuffers(pmesh);
+}
+
+void EvolutionDriver::InitializeTaskScheduling() {
+  TaskBackoffPolicy backoff;
+  backoff.threshold = pinput->GetOrAddInteger("parthenon/tasks", "backoff_threshold",
+                                              backoff.threshold);
+  backoff.initial_delay = pinput->GetOrAddReal("parthenon/tasks", "backoff_initial_delay",
+                                               backoff.initial_delay);
+  backoff.max_delay =
+      pinput->GetOrAddReal("parthenon/tasks", "backoff_max_delay", backoff.max_delay);
+  backoff.max_polls_per_sweep = pinput->GetOrAddInteger(
+      "parthenon/tasks", "max_polls_per_sweep", backoff.max_polls_per_sweep);
+  PARTHENON_REQUIRE_THROWS(backoff.max_polls_per_sweep > 0,
+                           "parthenon/tasks/max_polls_per_sweep must be positive");
+  TaskRegion::SetBackoffPolicy(backoff);
+  report_incomplete_polls =
+      pinput->GetOrAddBoolean("parthenon/tasks", "report_incomplete_polls", false);
+  report_remesh_times =
+      pinput->GetOrAddBoolean("parthenon/time", "report_remesh_times", false);
+  phase_report = pinput->GetOrAddString("parthenon/driver", "phase_report", "");
+  report_phase_times =
+      pinput->GetOrAddBoolean("parthenon/time", "report_phase_times", false);
+  overlap_dt_reduction =
+      pinput->GetOrAddBoolean("parthenon/time", "overlap_dt_reduction", false);
+  const bool overlap_signal_check =
+      pinput->GetOrAddBoolean("parthenon/time", "overlap_signal_check", false);
+  const Real output_now_interval =
+      pinput->GetOrAddReal("parthenon/time", "output_now_interval", 0.0);
+  PARTHENON_REQUIRE_THROWS(output_now_interval >= 0.0,
+                           "parthenon/time/output_now_interval must not be negative");
+  SignalHandler::SetCheckOptions(overlap_signal_check, output_now_interval);
+  ncycle_out_memory = pinput->GetOrAddInteger("parthenon/time", "ncycle_out_memory", 0);
+  PARTHENON_REQUIRE_THROWS(ncycle_out_memory >= 0,
+                           "parthenon/time/ncycle_out_memory must not be negative");
+  report_comm_counts =
+      pinput->GetOrAddBoolean("parthenon/time", "report_comm_counts", false);
+  ncycle_out_comm = pinput->GetOrAddInteger("parthenon/time", "ncycle_out_comm", 0);
+  PARTHENON_REQUIRE_THROWS(ncycle_out_comm >= 0,
+                           "parthenon/time/ncycle_out_comm must not be negative");
+  telemetry_file = pinput->GetOrAddString("parthenon/driver", "telemetry", "");
+  ncycle_out_telemetry =
+      pinput->GetOrAddInteger("parthenon/time", "ncycle_out_telemetry", 1);
+  PARTHENON_REQUIRE_THROWS(ncycle_out_telemetry > 0,
+                           "parthenon/time/ncycle_out_telemetry must be positive");
+  if (!telemetry_file.empty() && Globals::my_rank == 0) {
+    telemetry = std::make_unique<TelemetryWriter>(telemetry_file);
+  }
+  // don't report the remeshing done while initializing the mesh
+  remesh_times_prev = pmesh->remesh_times;
 }
 
 //----------------------------------------------------------------------------------------
@@ -199,21 +364,50 @@ void EvolutionDriver::InitializeBlockTimeStepsAndBoundaries() {
 // \brief function that loops over all MeshBlocks and find new timestep
 
 void EvolutionDriver::SetGlobalTimeStep() {
-  // don't allow dt to grow by more than 2x
-  // consider making this configurable in the input
-  if (tm.dt < 0.1 * std::numeric_limits<Real>::max()) {
-    tm.dt *= 2.0;
-  }
+  StartGlobalTimeStep();
+  FinishGlobalTimeStep();
+}
+
+void EvolutionDriver::StartGlobalTimeStep() {
+  PhaseTimes::Scope timestep_time(PhaseTimes::Phase::timestep);
   Real big = std::numeric_limits<Real>::max();
+  // reduce the timesteps per level, so that drivers can tell how much finer levels hold
+  // back coarser ones, in a single reduction
+  const int root_level = pmesh->GetRootLevel();
+  tm.dt_level.assign(pmesh->GetMaxLevel() - root_level + 1, big);
   for (auto const &pmb : pmesh->block_list) {
-    tm.dt = std::min(tm.dt, pmb->NewDt());
+    const int level =
+        std::min<int>(pmb->loc.level() - root_level, tm.dt_level.size() - 1);
+    tm.dt_level[level] = std::min(tm.dt_level[level], pmb->NewDt());
     pmb->SetAllowedDt(big);
   }
 
 #ifdef MPI_PARALLEL
-  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &tm.dt, 1, MPI_PARTHENON_REAL, MPI_MIN,
-                                    MPI_COMM_WORLD));
+  PARTHENON_MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, tm.dt_level.data(),
+                                     tm.dt_level.size(), MPI_PARTHENON_REAL, MPI_MIN,
+                                     MPI_COMM_WORLD, &dt_request));
 #endif
+  dt_pending = true;
+}
+
+void EvolutionDriver::FinishGlobalTimeStep() {
+  if (!dt_pending) return;
+  dt_pending = false;
+  PhaseTimes::Scope timestep_time(PhaseTimes::Phase::timestep);
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Wait(&dt_request, MPI_STATUS_IGNORE));
+#endif
+  if (tm.dt_proposed > 0.0) {
+    tm.dt = tm.dt_proposed;
+    tm.dt_proposed = 0.0;
+  } else if (tm.dt < 0.1 * std::numeric_limits<Real>::max()) {
+    // don't allow dt to grow by more than 2x
+    // consider making this configurable in the input
+    tm.dt *= 2.0;
+  }
+  for (const Real dt : tm.dt_level) {
+    tm.dt = std::min(tm.dt, dt);
+  }
 
   if (tm.time < tm.tlim &&
       (tm.tlim - tm.time) < tm.dt) // timestep would take us past desired endpoint
@@ -240,6 +434,188 @@ void EvolutionDriver::DumpInputParameters() {
   }
 }
 
+void EvolutionDriver::StartPhaseReportWindow() {
+  phase_report_start = PhaseTimes::AllSeconds();
+  phase_report_cycle = tm.ncycle;
+  phase_report_remesh = pmesh->remesh_times;
+}
+
+void EvolutionDriver::ReducePhaseTimes() {
+  if (!report_phase_times || tm.ncycle_out == 0 || tm.ncycle % tm.ncycle_out != 0) {
+    return;
+  }
+  // the mean time per cycle since the last output, on each rank
+  const auto seconds = PhaseTimes::AllSeconds();
+  const int ncycles = tm.ncycle - phase_times_cycle;
+  std::vector<double> per_cycle(seconds.size(), 0.0);
+  for (int p = 0; p < seconds.size(); ++p) {
+    if (ncycles > 0) per_cycle[p] = (seconds[p] - phase_times_prev[p]) / ncycles;
+  }
+  phase_times_prev = seconds;
+  phase_times_cycle = tm.ncycle;
+  phase_times_stats = PhaseTimes::ReduceOverRanks(per_cycle);
+}
+
+void EvolutionDriver::WritePhaseReport() {
+  if (phase_report.empty()) return;
+  // the phases, and the breakdown of the remeshing, since the start of the measurement
+  const auto &now = pmesh->remesh_times;
+  const auto &prev = phase_report_remesh;
+  std::vector<std::pair<std::string, double>> times;
+  const auto seconds = PhaseTimes::AllSeconds();
+  for (int p = 0; p < static_cast<int>(PhaseTimes::Phase::count); ++p) {
+    times.emplace_back(PhaseTimes::Name(static_cast<PhaseTimes::Phase>(p)),
+                       seconds[p] - phase_report_start[p]);
+  }
+  times.emplace_back("amr_tag", now.tag - prev.tag);
+  times.emplace_back("amr_tree", now.tree - prev.tree);
+  times.emplace_back("amr_costs", now.costs - prev.costs);
+  times.emplace_back("amr_redistribute", now.redistribute - prev.redistribute);
+  times.emplace_back("amr_initialize", now.initialize - prev.initialize);
+  times.emplace_back("amr_buffers", now.buffers - prev.buffers);
+
+  const int ntimes = times.size();
+  std::vector<double> vals;
+  for (const auto &time : times) {
+    vals.push_back(time.second);
+  }
+  const auto stats = PhaseTimes::ReduceOverRanks(vals);
+  if (Globals::my_rank != 0) return;
+
+  const std::uint64_t zonecycles =
+      pmesh->mbcnt * static_cast<std::uint64_t>(pmesh->GetNumberOfMeshBlockCells());
+  const double wtime = timer_main.seconds();
+  std::ofstream out(phase_report);
+  out << std::setprecision(6);
+  out << "{\"ranks\": " << Globals::nranks << ", \"backend\": \""
+      << DevExecSpace::name() << "\", \"cycles\": " << tm.ncycle - phase_report_cycle
+      << ", \"meshblocks\": " << pmesh->nbtotal
+      << ", \"meshblock_cells\": " << pmesh->GetNumberOfMeshBlockCells()
+      << ", \"pack_size\": " << pmesh->DefaultPackSize()
+      << ", \"zone_cycles\": " << zonecycles << ", \"walltime\": " << wtime
+      << ", \"zone_cycles_per_wsec\": " << static_cast<double>(zonecycles) / wtime
+      << ",\n\"phases\": {";
+  for (int n = 0; n < ntimes; ++n) {
+    out << (n > 0 ? ",\n" : "\n") << "  \"" << times[n].first << "\": {\"min\": "
+        << stats.min[n] << ", \"max\": " << stats.max[n]
+        << ", \"mean\": " << stats.mean[n] << "}";
+  }
+  out << "\n}}\n";
+}
+
+void EvolutionDriver::OutputMemoryReport() {
+  if (ncycle_out_memory == 0 || tm.ncycle % ncycle_out_memory != 0) return;
+  std::ofstream os("memory_report." + std::to_string(Globals::my_rank) + ".txt",
+                   std::ios::app);
+  os << "# cycle=" << tm.ncycle << " time=" << tm.time
+     << " blocks=" << pmesh->block_list.size() << "\n";
+  MemoryReport::Gather(pmesh).Write(os);
+}
+
+void EvolutionDriver::OutputCommCounts() {
+  if (ncycle_out_comm == 0 || tm.ncycle % ncycle_out_comm != 0) return;
+  const std::string filename = "comm_counts." + std::to_string(Globals::my_rank) + ".csv";
+  const bool new_file = !std::ifstream(filename).good();
+  std::ofstream os(filename, std::ios::app);
+  if (new_file) {
+    os << "cycle,ncycles,kind,send_msgs,send_bytes,send_null,recv_msgs,recv_bytes,"
+          "recv_null\n";
+  }
+  const auto now = CommCounters::GetAll();
+  for (int kind = 0; kind < CommCounters::nkinds; ++kind) {
+    const auto c = now[kind] - comm_counts_csv_prev[kind];
+    os << tm.ncycle << "," << tm.ncycle - comm_counts_csv_cycle << ","
+       << CommCounters::Name(kind) << "," << c.send_msgs << "," << c.send_bytes << ","
+       << c.send_null << "," << c.recv_msgs << "," << c.recv_bytes << "," << c.recv_null
+       << "\n";
+  }
+  comm_counts_csv_prev = now;
+  comm_counts_csv_cycle = tm.ncycle;
+}
+
+void EvolutionDriver::OutputTelemetry() {
+  if (telemetry_file.empty() || tm.ncycle % ncycle_out_telemetry != 0 ||
+      tm.ncycle == telemetry_cycle) {
+    return;
+  }
+  const int ncycles = tm.ncycle - telemetry_cycle;
+  const double wsec = telemetry_timer.seconds();
+  constexpr int nphases = static_cast<int>(PhaseTimes::Phase::count);
+
+  // the values of this rank, all reduced at once: the time per cycle of each phase, the
+  // device memory now and at its highest, the host high-water mark, the bytes and
+  // messages sent by group of traffic and the number of blocks
+  std::vector<double> vals;
+  const auto seconds = PhaseTimes::AllSeconds();
+  for (int p = 0; p < nphases; ++p) {
+    vals.push_back(ncycles > 0 ? (seconds[p] - telemetry_phase_prev[p]) / ncycles : 0.0);
+  }
+  const auto memory = MemoryReport::Gather(pmesh);
+  const double device_bytes =
+      memory.total.Total() + memory.comm_buffers + memory.variable_pool;
+  telemetry_device_peak = std::max(telemetry_device_peak, device_bytes);
+  vals.push_back(device_bytes);
+  vals.push_back(telemetry_device_peak);
+  vals.push_back(HostPeakBytes());
+  const auto now = CommCounters::GetAll();
+  const auto traffic = GroupTraffic(now, telemetry_comm_prev);
+  for (const auto &counts : traffic) {
+    vals.push_back(counts.send_bytes);
+    vals.push_back(counts.send_msgs);
+  }
+  vals.push_back(pmesh->block_list.size());
+  const auto stats = PhaseTimes::ReduceOverRanks(vals);
+
+  const std::uint64_t zonecycles =
+      telemetry_block_cycles *
+      static_cast<std::uint64_t>(pmesh->GetNumberOfMeshBlockCells());
+  telemetry_phase_prev = seconds;
+  telemetry_comm_prev = now;
+  telemetry_cycle = tm.ncycle;
+  telemetry_block_cycles = 0;
+  telemetry_timer.reset();
+  if (Globals::my_rank != 0) return;
+
+  // the ratio of the maximum over ranks to the mean, 1 if perfectly balanced
+  auto imbalance = [&](const int n) {
+    return stats.mean[n] > 0.0 ? stats.max[n] / stats.mean[n] : 1.0;
+  };
+  std::vector<double> blocks_per_level;
+  for (const auto &loc : pmesh->GetLocList()) {
+    const int level = loc.level() - pmesh->GetRootLevel();
+    if (level >= blocks_per_level.size()) blocks_per_level.resize(level + 1, 0.0);
+    blocks_per_level[level] += 1.0;
+  }
+
+  TelemetryWriter::Record record{
+      {"cycle", {static_cast<double>(tm.ncycle)}},
+      {"time", {tm.time}},
+      {"dt", {tm.dt}},
+      {"ncycles", {static_cast<double>(ncycles)}},
+      {"wsec", {wsec}},
+      {"zone_cycles_per_wsec", {wsec > 0.0 ? zonecycles / wsec : 0.0}},
+      {"meshblocks", {static_cast<double>(pmesh->nbtotal)}},
+      {"blocks_per_level", blocks_per_level}};
+  for (int p = 0; p < nphases; ++p) {
+    const std::string name = PhaseTimes::Name(static_cast<PhaseTimes::Phase>(p));
+    record.push_back({"wsec_" + name + "_mean", {stats.mean[p]}});
+    record.push_back({"wsec_" + name + "_max", {stats.max[p]}});
+  }
+  int n = nphases;
+  record.push_back({"device_bytes_max", {stats.max[n++]}});
+  record.push_back({"device_bytes_peak", {stats.max[n++]}});
+  record.push_back({"host_bytes_peak", {stats.max[n++]}});
+  // summed over ranks
+  for (const std::string group : traffic_groups) {
+    record.push_back({"sent_bytes_" + group, {Globals::nranks * stats.mean[n++]}});
+    record.push_back({"sent_msgs_" + group, {Globals::nranks * stats.mean[n++]}});
+  }
+  record.push_back({"imbalance_blocks", {imbalance(n)}});
+  record.push_back(
+      {"imbalance_step", {imbalance(static_cast<int>(PhaseTimes::Phase::step))}});
+  telemetry->Write(record);
+}
+
 void EvolutionDriver::OutputCycleDiagnostics() {
   const int dt_precision = std::numeric_limits<Real>::max_digits10 - 1;
   if (tm.ncycle_out != 0) {
@@ -262,6 +638,54 @@ void EvolutionDriver::OutputCycleDiagnostics() {
         std::cout << " zone-cycles/wsec="
                   << static_cast<double>(zonecycles) / (time_cycle_step + time_LBandAMR)
                   << " wsec_AMR=" << time_LBandAMR;
+        // breakdown of the remeshing time on this rank since the last output
+        if (report_remesh_times) {
+          const auto &now = pmesh->remesh_times;
+          const auto &prev = remesh_times_prev;
+          std::cout << " wsec_tag=" << now.tag - prev.tag
+                    << " wsec_tree=" << now.tree - prev.tree
+                    << " wsec_costs=" << now.costs - prev.costs
+                    << " wsec_redistribute=" << now.redistribute - prev.redistribute
+                    << " wsec_init=" << now.initialize - prev.initialize
+                    << " wsec_buffers=" << now.buffers - prev.buffers
+                    << " check_interval=" << pmesh->GetRefinementCheckInterval();
+          remesh_times_prev = now;
+        }
+      }
+
+      // time per cycle spent in each phase since the last output, over all ranks
+      if (report_phase_times) {
+        const auto &stats = phase_times_stats;
+        for (int p = 0; p < stats.mean.size(); ++p) {
+          std::cout << " wsec_" << PhaseTimes::Name(static_cast<PhaseTimes::Phase>(p))
+                    << "[min/avg/max]=" << stats.min[p] << "/" << stats.mean[p] << "/"
+                    << stats.max[p];
+        }
+      }
+
+      // messages rank 0 sent to other ranks since the last output, by kind of traffic
+      if (report_comm_counts) {
+        const auto now = CommCounters::GetAll();
+        const auto sent = GroupTraffic(now, comm_counts_prev);
+        std::cout << " MB_sent[bvals/flxcor/gmg/migration]=";
+        for (int group = 0; group < 4; ++group) {
+          std::cout << (group > 0 ? "/" : "") << sent[group].send_bytes / 1.0e6;
+        }
+        std::cout << " msgs_sent=";
+        for (int group = 0; group < 4; ++group) {
+          std::cout << (group > 0 ? "/" : "") << sent[group].send_msgs;
+        }
+        std::cout << " null_msgs_sent=";
+        for (int group = 0; group < 4; ++group) {
+          std::cout << (group > 0 ? "/" : "") << sent[group].send_null;
+        }
+        comm_counts_prev = now;
+      }
+
+      // tasks on this rank that returned incomplete since the last output
+      if (report_incomplete_polls) {
+        std::cout << " incomplete_polls=" << TaskRegion::NumIncompletePolls();
+        TaskRegion::ResetIncompletePolls();
       }
 
       // insert more diagnostics here
@@ -14,6 +14,7 @@
 #ifndef DRIVER_DRIVER_HPP_
 #define DRIVER_DRIVER_HPP_
 
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <memory>
@@ -27,7 +28,11 @@
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
 #include "parameter_input.hpp"
+#include "parthenon_mpi.hpp"
 #include "tasks/tasks.hpp"
+#include "utils/comm_counters.hpp"
+#include "utils/phase_times.hpp"
+#include "utils/telemetry.hpp"
 
 namespace parthenon {
 
@@ -77,10 +82,31 @@ class EvolutionDriver : public Driver {
         pinput->GetOrAddInteger("parthenon/time", "ncycle_out_mesh", 0);
     tm = SimTime(start_time, tstop, nmax, ncycle, nout, nout_mesh, dt);
     pouts = std::make_unique<Outputs>(pmesh, pinput, &tm);
+    InitializeTaskScheduling();
   }
   DriverStatus Execute() override;
   void SetGlobalTimeStep();
+  // SetGlobalTimeStep split in two, so that work can be done while the timestep is
+  // being reduced over all ranks. tm.dt must not be used between the two calls.
+  void StartGlobalTimeStep();
+  void FinishGlobalTimeStep();
   void OutputCycleDiagnostics();
+  // append the MemoryReport of this rank to memory_report.<rank>.txt, every
+  // <parthenon/time>/ncycle_out_memory cycles
+  void OutputMemoryReport();
+  // append the messages and bytes this rank sent and received since the last dump, by
+  // kind of traffic (see CommCounters), to comm_counts.<rank>.csv every
+  // <parthenon/time>/ncycle_out_comm cycles
+  void OutputCommCounts();
+  // write the time spent in the phases of the run (see PhaseTimes) since the end of
+  // perf_cycle_offset, reduced over all ranks, to the json file
+  // <parthenon/driver>/phase_report
+  void WritePhaseReport();
+  // append the performance of the cycles since the last record (zone-cycles/s, phase
+  // times, memory, blocks per level, traffic, imbalance), reduced over all ranks, as a
+  // record to the file <parthenon/driver>/telemetry every
+  // <parthenon/time>/ncycle_out_telemetry cycles.  Must be called by all ranks.
+  void OutputTelemetry();
   void DumpInputParameters();
 
   virtual TaskListStatus Step() = 0;
@@ -91,20 +117,102 @@ class EvolutionDriver : public Driver {
 
  private:
   void InitializeBlockTimeStepsAndBoundaries();
+  void InitializeTaskScheduling();
+  bool report_incomplete_polls = false;
+  // add the breakdown of Mesh::remesh_times to the cycle diagnostics
+  bool report_remesh_times = false;
+  Mesh::RemeshTimes remesh_times_prev;
+  void StartPhaseReportWindow();
+  std::string phase_report;
+  int phase_report_cycle = 0;
+  std::vector<double> phase_report_start;
+  Mesh::RemeshTimes phase_report_remesh;
+  // add the time per cycle spent in each phase (see PhaseTimes) since the last output,
+  // reduced over all ranks by ReducePhaseTimes, to the cycle diagnostics
+  void ReducePhaseTimes();
+  bool report_phase_times = false;
+  int phase_times_cycle = 0;
+  std::vector<double> phase_times_prev =
+      std::vector<double>(static_cast<int>(PhaseTimes::Phase::count), 0.0);
+  PhaseTimes::RankStats phase_times_stats;
+  int ncycle_out_memory = 0;
+  // add the traffic of rank 0 since the last output to the cycle diagnostics
+  bool report_comm_counts = false;
+  std::vector<CommCounters::Counts> comm_counts_prev;
+  int ncycle_out_comm = 0;
+  int comm_counts_csv_cycle = 0;
+  std::vector<CommCounters::Counts> comm_counts_csv_prev;
+  // only on rank 0
+  std::unique_ptr<TelemetryWriter> telemetry;
+  std::string telemetry_file;
+  int ncycle_out_telemetry = 1;
+  int telemetry_cycle = 0;
+  std::uint64_t telemetry_block_cycles = 0;
+  double telemetry_device_peak = 0.0;
+  Kokkos::Timer telemetry_timer;
+  std::vector<double> telemetry_phase_prev;
+  std::vector<CommCounters::Counts> telemetry_comm_prev;
+  // finish the timestep reduction of a cycle at the start of the next one
+  bool overlap_dt_reduction = false;
+  bool dt_pending = false;
+#ifdef MPI_PARALLEL
+  MPI_Request dt_request = MPI_REQUEST_NULL;
+#endif
+};
+
+// Keeps the TaskCollections built by a driver around, keyed by an integer (typically
+// the stage), so that they can simply be executed again in later cycles instead of
+// being rebuilt.  Any argument that changes from cycle to cycle (e.g. dt) must then be
+// read when the task executes, e.g. by passing it to AddTask via std::cref, and the
+// cache must be cleared whenever the mesh changes, see ClearIfRemeshed.
+class TaskCollectionCache {
+ public:
+  template <typename Builder>
+  TaskCollection &GetOrBuild(const int key, Builder &&build) {
+    auto it = collections.find(key);
+    if (it == collections.end()) {
+      it = collections.emplace(key, std::make_unique<TaskCollection>(build())).first;
+    }
+    return *(it->second);
+  }
+  bool Contains(const int key) const { return collections.count(key) > 0; }
+  void Clear() { collections.clear(); }
+  // Clear the cache if the blocks or partitions of the mesh changed since the last call,
+  // i.e., if Mesh::remesh_count did, which also covers new pack sizes chosen by
+  // Mesh::TunePackSize that don't set Mesh::modified
+  void ClearIfRemeshed(const std::uint64_t remesh_count) {
+    if (remesh_count != last_remesh_count) Clear();
+    last_remesh_count = remesh_count;
+  }
+  std::size_t size() const { return collections.size(); }
+
+ private:
+  std::map<int, std::unique_ptr<TaskCollection>> collections;
+  std::uint64_t last_remesh_count = 0;
 };
 
 namespace DriverUtils {
 
 template <typename T, class... Args>
-TaskListStatus ConstructAndExecuteBlockTasks(T *driver, Args... args) {
+TaskCollection ConstructBlockTaskCollection(T *driver, Args... args) {
   int nmb = driver->pmesh->GetNumMeshBlocksThisRank(Globals::my_rank);
   TaskCollection tc;
   TaskRegion &tr = tc.AddRegion(nmb);
 
+  // the list of each block measures the cost of the block for automatic load balancing
+  const bool measure = driver->pmesh->AutomaticLoadBalancing();
   int i = 0;
   for (auto &pmb : driver->pmesh->block_list) {
-    tr[i++] = driver->MakeTaskList(pmb.get(), std::forward<Args>(args)...);
+    tr[i] = driver->MakeTaskList(pmb.get(), std::forward<Args>(args)...);
+    if (measure) tr[i].SetCostMeter(pmb->MakeCostMeter());
+    i++;
   }
+  return tc;
+}
+
+template <typename T, class... Args>
+TaskListStatus ConstructAndExecuteBlockTasks(T *driver, Args... args) {
+  TaskCollection tc = ConstructBlockTaskCollection(driver, std::forward<Args>(args)...);
   TaskListStatus status = tc.Execute();
   return status;
 }
@@ -117,6 +225,25 @@ TaskListStatus ConstructAndExecuteTaskLists(T *driver, Args... args) {
   return status;
 }
 
+// Advances an ensemble of independent simulations, e.g., a parameter sweep of small
+// problems run in one process, where each driver has its own Mesh.  The task
+// collections of all members are executed together (see TaskCollection::Execute), so
+// the kernels and messages of one member can be issued while another is waiting.
+template <typename T, class... Args>
+TaskListStatus ConstructAndExecuteEnsembleTaskLists(const std::vector<T *> &drivers,
+                                                    Args... args) {
+  std::vector<TaskCollection> tcs;
+  tcs.reserve(drivers.size());
+  for (auto driver : drivers) {
+    tcs.push_back(driver->MakeTaskCollection(driver->pmesh->block_list, args...));
+  }
+  std::vector<TaskCollection *> ptcs;
+  for (auto &tc : tcs) {
+    ptcs.push_back(&tc);
+  }
+  return TaskCollection::Execute(ptcs);
+}
+
 } // namespace DriverUtils
 
 } // namespace parthenon
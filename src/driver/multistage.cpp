@@ -12,10 +12,35 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 
+#include <string>
+#include <vector>
+
 #include "driver/multistage.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/meshblock_data.hpp"
+#include "interface/metadata.hpp"
+#include "interface/update.hpp"
+#include "mesh/meshblock.hpp"
 
 namespace parthenon {
 
+namespace DriverUtils {
+void CopyIndependentVariables(Mesh *pmesh, const std::string &from,
+                              const std::string &to) {
+  PARTHENON_INSTRUMENT
+  for (auto &pmb : pmesh->block_list) {
+    pmb->meshblock_data.Add(to, pmb->meshblock_data.Get(from));
+  }
+  const auto flags = std::vector<MetadataFlag>({Metadata::Independent});
+  const int num_partitions = pmesh->DefaultNumPartitions();
+  for (int i = 0; i < num_partitions; i++) {
+    auto &in = pmesh->mesh_data.GetOrAdd(from, i);
+    auto &out = pmesh->mesh_data.GetOrAdd(to, i);
+    Update::CopyData(flags, in.get(), out.get());
+  }
+}
+} // namespace DriverUtils
+
 template class MultiStageDriverGeneric<StagedIntegrator>;
 template class MultiStageBlockTaskDriverGeneric<StagedIntegrator>;
 template class MultiStageDriverGeneric<LowStorageIntegrator>;
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "application_input.hpp"
@@ -27,17 +28,36 @@
 
 namespace parthenon {
 
+namespace DriverUtils {
+// copy the Independent variables of the MeshBlockData with label from to the one with
+// label to, which is added to every block if it doesn't exist yet
+void CopyIndependentVariables(Mesh *pmesh, const std::string &from,
+                              const std::string &to);
+} // namespace DriverUtils
+
 template <typename Integrator = LowStorageIntegrator>
 class MultiStageDriverGeneric : public EvolutionDriver {
  public:
   MultiStageDriverGeneric(ParameterInput *pin, ApplicationInput *app_in, Mesh *pm)
-      : EvolutionDriver(pin, app_in, pm), integrator(std::make_unique<Integrator>(pin)) {}
+      : EvolutionDriver(pin, app_in, pm), integrator(std::make_unique<Integrator>(pin)),
+        cache_task_collections(
+            pin->GetOrAddBoolean("parthenon/driver", "cache_task_collections", false)) {}
   // An application driver that derives from this class must define this
   // function, which defines the application specific list of tasks and
   // the dependencies that must be executed.
   virtual TaskCollection MakeTaskCollection(BlockList_t &blocks, int stage) = 0;
   virtual TaskListStatus Step() {
     PARTHENON_INSTRUMENT
+    // the graphs hold on to MeshData objects which do not survive remeshing
+    task_collections.ClearIfRemeshed(pmesh->remesh_count);
+    if constexpr (std::is_same_v<Integrator, ButcherIntegrator>) {
+      if (integrator->adaptive) return ErrorControlledStep_();
+    }
+    return ExecuteStages_();
+  }
+
+ protected:
+  TaskListStatus ExecuteStages_() {
     using DriverUtils::ConstructAndExecuteTaskLists;
     TaskListStatus status;
     integrator->dt = tm.dt;
@@ -46,14 +66,59 @@ class MultiStageDriverGeneric : public EvolutionDriver {
       // on only the immediately preceding stage to contain
       // reasonable data
       pmesh->SetAllVariablesToInitialized();
-      status = ConstructAndExecuteTaskLists<>(this, stage);
+      if (cache_task_collections) {
+        auto &tc = task_collections.GetOrBuild(
+            stage, [&]() { return MakeTaskCollection(pmesh->block_list, stage); });
+        status = tc.Execute();
+      } else {
+        status = ConstructAndExecuteTaskLists<>(this, stage);
+      }
       if (status != TaskListStatus::complete) break;
     }
     return status;
   }
 
- protected:
+  // Steps with tm.dt and, while the error norm of the step is larger than one, restores
+  // the Independent variables of the start of the step and tries again with a smaller
+  // tm.dt. The task lists must call Update::EstimateButcherError after the last stage.
+  // A template, so that it only exists for integrators with error control.
+  template <typename I = Integrator>
+  TaskListStatus ErrorControlledStep_() {
+    I *pint = integrator.get();
+    DriverUtils::CopyIndependentVariables(pmesh, "base", error_control_saved);
+    for (int attempt = 0;; ++attempt) {
+      // negative until an error estimate is recorded, see AccumulateError
+      pint->error = -1.0;
+      const TaskListStatus status = ExecuteStages_();
+      if (status != TaskListStatus::complete) return status;
+      Real err = pint->error;
+#ifdef MPI_PARALLEL
+      PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &err, 1, MPI_PARTHENON_REAL,
+                                        MPI_MAX, MPI_COMM_WORLD));
+#endif
+      PARTHENON_REQUIRE_THROWS(err >= 0.0,
+                               "adaptive time stepping requires the task lists to call "
+                               "Update::EstimateButcherError after the last stage");
+      if (err <= 1.0) {
+        tm.dt_proposed = pint->ProposeDt(err, tm.dt);
+        return status;
+      }
+      PARTHENON_REQUIRE_THROWS(attempt < pint->max_rejections,
+                               "Step rejected more than parthenon/time/max_rejections "
+                               "times");
+      DriverUtils::CopyIndependentVariables(pmesh, error_control_saved, "base");
+      tm.dt = pint->ProposeDt(err, tm.dt);
+    }
+  }
+
   std::unique_ptr<Integrator> integrator;
+  // If true, the TaskCollection of each stage is built once and replayed in every cycle
+  // until the mesh changes.  MakeTaskCollection must then not capture anything by
+  // value that changes from cycle to cycle.
+  const bool cache_task_collections;
+  TaskCollectionCache task_collections;
+  // holds the state at the start of error controlled steps
+  const std::string error_control_saved = "error_control_saved";
 };
 using MultiStageDriver = MultiStageDriverGeneric<LowStorageIntegrator>;
 
@@ -67,12 +132,20 @@ class MultiStageBlockTaskDriverGeneric : public MultiStageDriverGeneric<Integrat
   virtual TaskListStatus Step() {
     PARTHENON_INSTRUMENT
     using DriverUtils::ConstructAndExecuteBlockTasks;
+    using DriverUtils::ConstructBlockTaskCollection;
     TaskListStatus status;
     Integrator *integrator = (this->integrator).get();
     SimTime tm = this->tm;
     integrator->dt = tm.dt;
+    this->task_collections.ClearIfRemeshed(this->pmesh->remesh_count);
     for (int stage = 1; stage <= integrator->nstages; stage++) {
-      status = ConstructAndExecuteBlockTasks<>(this, stage);
+      if (this->cache_task_collections) {
+        auto &tc = this->task_collections.GetOrBuild(
+            stage, [&]() { return ConstructBlockTaskCollection<>(this, stage); });
+        status = tc.Execute();
+      } else {
+        status = ConstructAndExecuteBlockTasks<>(this, stage);
+      }
       if (status != TaskListStatus::complete) break;
     }
     return status;
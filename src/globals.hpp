@@ -35,9 +35,42 @@ struct SparseConfig {
   int deallocation_count = 5;
 };
 
+// Order of the boundary buffers in the caches of a MeshData, which is the order in
+// which they are packed, sent and received (see InitializeBufferCache)
+enum class BufferOrder { random, natural, rank, morton };
+
+struct CommConfig {
+  // send all boundary buffers exchanged with a rank in a single message
+  bool coalesce_messages = false;
+  // start coalesced messages with a bitmask of the members that are not null and leave
+  // out the null members
+  bool compact_messages = false;
+  // exchange the messages with all ranks by one neighborhood collective per exchange
+  bool neighborhood_comm = false;
+  // write the messages between ranks on the same node into an MPI-3 shared memory window
+  // rather than sending them, for buffers that are accessible from the host
+  bool shared_memory_comm = false;
+  // put the messages into an MPI RMA window of the receiver rather than sending them
+  bool rma_comm = false;
+  // reuse persistent MPI requests for the boundary buffers of dense variables
+  bool persistent_requests = false;
+  BufferOrder buffer_order = BufferOrder::random;
+  // restrict the coarse cells of a boundary in the kernel packing its buffer
+  bool fuse_restriction = false;
+  // copy same level ghost zones within a MeshData without going through a buffer
+  bool zero_copy_local = false;
+  // send and receive messages through pinned host memory, for MPI that can't access
+  // device memory
+  bool host_staging = false;
+  // number of fields that share a communicator, with their tags offset by their position
+  // in it (at most 32, the number of tags CreateAMRMPITag leaves for it)
+  int fields_per_comm = 1;
+};
+
 extern int my_rank, nranks, nghost;
 
 extern SparseConfig sparse_config;
+extern CommConfig comm_config;
 
 extern Real receive_boundary_buffer_timeout;
 extern Real current_task_runtime_sec;
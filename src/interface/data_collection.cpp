@@ -11,12 +11,19 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "interface/data_collection.hpp"
 #include "interface/mesh_data.hpp"
 #include "interface/meshblock_data.hpp"
 #include "mesh/mesh.hpp"
+#include "mesh/meshblock.hpp"
+#include "utils/hilbert_curve.hpp"
 #include "utils/partition_stl_containers.hpp"
 
 namespace parthenon {
@@ -24,7 +31,8 @@ namespace parthenon {
 template <typename T>
 std::shared_ptr<T> &
 DataCollection<T>::Add(const std::string &name, const std::shared_ptr<T> &src,
-                       const std::vector<std::string> &field_names, const bool shallow) {
+                       const std::vector<std::string> &field_names, const bool shallow,
+                       const bool copy_on_write) {
   auto it = containers_.find(name);
   if (it != containers_.end()) {
     if (!(it->second)->Contains(field_names)) {
@@ -35,7 +43,7 @@ DataCollection<T>::Add(const std::string &name, const std::shared_ptr<T> &src,
   }
 
   auto c = std::make_shared<T>(name);
-  c->Initialize(src.get(), field_names, shallow);
+  c->Initialize(src.get(), field_names, shallow, copy_on_write);
 
   Set(name, c);
 
@@ -53,6 +61,39 @@ std::shared_ptr<T> &DataCollection<T>::AddShallow(const std::string &label,
                                                   const std::vector<std::string> &flags) {
   return Add(label, src, flags, true);
 }
+template <typename T>
+std::shared_ptr<T> &
+DataCollection<T>::AddCopyOnWrite(const std::string &label, const std::shared_ptr<T> &src,
+                                  const std::vector<std::string> &flags) {
+  return Add(label, src, flags, false, true);
+}
+
+namespace {
+// The blocks of block_list sorted by the Hilbert index of their lower corner on the
+// finest level.  Since leaves don't overlap and every block covers a contiguous range
+// of the curve, this sorts them along the curve.
+BlockList_t HilbertOrdered(Mesh *pmesh, const BlockList_t &block_list) {
+  const int nbits = pmesh->GetCurrentLevel();
+  std::vector<std::pair<std::uint64_t, int>> keys;
+  keys.reserve(block_list.size());
+  for (int b = 0; b < static_cast<int>(block_list.size()); ++b) {
+    const auto &loc = block_list[b]->loc;
+    const int shift = nbits - loc.level();
+    keys.emplace_back(HilbertIndex(pmesh->ndim, nbits,
+                                   {static_cast<std::uint64_t>(loc.lx1()) << shift,
+                                    static_cast<std::uint64_t>(loc.lx2()) << shift,
+                                    static_cast<std::uint64_t>(loc.lx3()) << shift}),
+                      b);
+  }
+  std::sort(keys.begin(), keys.end());
+  BlockList_t ordered;
+  ordered.reserve(block_list.size());
+  for (const auto &key : keys) {
+    ordered.push_back(block_list[key.second]);
+  }
+  return ordered;
+}
+} // namespace
 
 std::shared_ptr<MeshData<Real>> &
 GetOrAdd_impl(Mesh *pmy_mesh_,
@@ -65,7 +106,10 @@ GetOrAdd_impl(Mesh *pmy_mesh_,
   if (it == containers_.end()) {
     // TODO(someone) add caching of partitions to Mesh at some point
     const int pack_size = pmy_mesh_->DefaultPackSize();
-    auto partitions = partition::ToSizeN(block_list, pack_size);
+    BlockList_t ordered;
+    if (pmy_mesh_->HilbertPartitions()) ordered = HilbertOrdered(pmy_mesh_, block_list);
+    auto partitions = partition::ToSizeN(
+        pmy_mesh_->HilbertPartitions() ? ordered : block_list, pack_size);
     // Account for possibly empty block_list
     if (partitions.size() == 0) partitions = std::vector<BlockList_t>(1);
     for (auto i = 0; i < partitions.size(); i++) {
@@ -73,6 +117,7 @@ GetOrAdd_impl(Mesh *pmy_mesh_,
       if (gmg_level >= 0) md_label = md_label + "_gmg-" + std::to_string(gmg_level);
       containers_[md_label] = std::make_shared<MeshData<Real>>(mbd_label);
       containers_[md_label]->Set(partitions[i], pmy_mesh_);
+      containers_[md_label]->SetExecSpace(pmy_mesh_->GetExecSpace(i));
       if (gmg_level >= 0) {
         int min_gmg_logical_level = pmy_mesh_->GetGMGMinLogicalLevel();
         containers_[md_label]->grid = GridIdentifier{GridType::two_level_composite,
@@ -101,6 +146,24 @@ DataCollection<MeshData<Real>>::GetOrAdd(int gmg_level, const std::string &mbd_l
                        mbd_label, partition_id, gmg_level);
 }
 
+template <>
+std::shared_ptr<MeshData<Real>> &
+DataCollection<MeshData<Real>>::GetOrAdd(const StageHandle &stage,
+                                         const std::size_t partition_id) {
+  PARTHENON_DEBUG_REQUIRE(stage.idx < stage_handles_.size(), "Invalid stage handle");
+  auto &entry = stage_handles_[stage.idx];
+  if (partition_id >= entry.partitions.size()) {
+    entry.partitions.resize(partition_id + 1, nullptr);
+  }
+  auto &cached = entry.partitions[partition_id];
+  if (cached == nullptr) {
+    const int id = static_cast<int>(partition_id);
+    cached = entry.gmg_level >= 0 ? &GetOrAdd(entry.gmg_level, entry.label, id)
+                                  : &GetOrAdd(entry.label, id);
+  }
+  return *cached;
+}
+
 template class DataCollection<MeshData<Real>>;
 template class DataCollection<MeshBlockData<Real>>;
 
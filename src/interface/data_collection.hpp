@@ -13,6 +13,8 @@
 #ifndef INTERFACE_DATA_COLLECTION_HPP_
 #define INTERFACE_DATA_COLLECTION_HPP_
 
+#include <cstddef>
+#include <limits>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -30,7 +32,7 @@ class Mesh;
 ///
 /// T must implement:
 ///   bool Contains(std::vector<std::string>)
-///   Initialize(T*, std::vector<std::string>, bool)
+///   Initialize(T*, std::vector<std::string>, bool, bool)
 /// TODO: implement a concept
 template <typename T>
 class DataCollection {
@@ -43,11 +45,19 @@ class DataCollection {
   void SetMeshPointer(Mesh *pmesh) { pmy_mesh_ = pmesh; }
 
   std::shared_ptr<T> &Add(const std::string &label, const std::shared_ptr<T> &src,
-                          const std::vector<std::string> &flags, const bool shallow);
+                          const std::vector<std::string> &flags, const bool shallow,
+                          const bool copy_on_write = false);
   std::shared_ptr<T> &Add(const std::string &label, const std::shared_ptr<T> &src,
                           const std::vector<std::string> &flags = {});
   std::shared_ptr<T> &AddShallow(const std::string &label, const std::shared_ptr<T> &src,
                                  const std::vector<std::string> &flags = {});
+  // Like Add, but the variables of the new container share the storage of src until
+  // they (or their counterparts in src) are made writable, see
+  // MeshBlockData::MakeWritable, so variables that are never written in a stage don't
+  // take up memory
+  std::shared_ptr<T> &AddCopyOnWrite(const std::string &label,
+                                     const std::shared_ptr<T> &src,
+                                     const std::vector<std::string> &flags = {});
   std::shared_ptr<T> &Add(const std::string &label) {
     // error check for duplicate names
     auto it = containers_.find(label);
@@ -77,7 +87,29 @@ class DataCollection {
   std::shared_ptr<T> &GetOrAdd(int gmg_level, const std::string &mbd_label,
                                const int &partition_id);
 
+  // A handle resolves the label (and multigrid level) of a stage once, so that getting
+  // one of its partitions, e.g., for every task list in every stage, indexes an array
+  // instead of building a key and searching for it.  Handles stay valid for the lifetime
+  // of the collection.
+  struct StageHandle {
+    static constexpr std::size_t invalid = std::numeric_limits<std::size_t>::max();
+    std::size_t idx = invalid;
+  };
+  StageHandle GetStageHandle(const std::string &mbd_label, const int gmg_level = -1) {
+    for (std::size_t i = 0; i < stage_handles_.size(); ++i) {
+      const auto &entry = stage_handles_[i];
+      if (entry.label == mbd_label && entry.gmg_level == gmg_level) return StageHandle{i};
+    }
+    stage_handles_.push_back({mbd_label, gmg_level, {}});
+    return StageHandle{stage_handles_.size() - 1};
+  }
+  std::shared_ptr<T> &GetOrAdd(const StageHandle &stage, const std::size_t partition_id);
+
   void PurgeNonBase() {
+    // the cached partitions point into containers_
+    for (auto &stage : stage_handles_) {
+      stage.partitions.clear();
+    }
     auto c = containers_.begin();
     while (c != containers_.end()) {
       if (c->first != "base") {
@@ -89,8 +121,16 @@ class DataCollection {
   }
 
  private:
+  struct StageEntry {
+    std::string label;
+    int gmg_level;
+    // by partition, the entry of containers_ it was found in or nullptr
+    std::vector<std::shared_ptr<T> *> partitions;
+  };
+
   Mesh *pmy_mesh_;
   std::map<std::string, std::shared_ptr<T>> containers_;
+  std::vector<StageEntry> stage_handles_;
 };
 
 } // namespace parthenon
@@ -23,6 +23,8 @@
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -70,11 +72,23 @@ inline auto MakePackDescriptor(StateDescriptor *psd,
                                const std::set<PDOpt> &options = {}) {
   static_assert(sizeof...(Ts) > 0, "Must have at least one variable type for type pack");
 
-  std::vector<std::string> vars{Ts::name()...};
-  std::vector<bool> use_regex{Ts::regex()...};
-
-  return typename SparsePack<Ts...>::Descriptor(static_cast<impl::PackDescriptor>(
-      MakePackDescriptor(psd, vars, use_regex, flags, options)));
+  using desc_t = typename SparsePack<Ts...>::Descriptor;
+  int opts = 0;
+  for (const auto &opt : options) {
+    opts |= 1 << static_cast<int>(opt);
+  }
+  const StateDescriptor::PackDescriptorKey key{std::type_index(typeid(desc_t)), flags,
+                                               opts};
+  auto &cache = psd->PackDescriptorCache();
+  auto itr = cache.find(key);
+  if (itr == cache.end()) {
+    std::vector<std::string> vars{Ts::name()...};
+    std::vector<bool> use_regex{Ts::regex()...};
+    auto desc = std::make_shared<desc_t>(static_cast<impl::PackDescriptor>(
+        MakePackDescriptor(psd, vars, use_regex, flags, options)));
+    itr = cache.emplace(key, desc).first;
+  }
+  return *std::static_pointer_cast<desc_t>(itr->second);
 }
 
 inline auto MakePackDescriptor(StateDescriptor *psd, const std::vector<std::string> &vars,
@@ -12,29 +12,56 @@
 //========================================================================================
 #include "mesh_data.hpp"
 
+#include <cstdlib>
+#include <vector>
+
 #include "mesh/mesh.hpp"
+#include "mesh/meshblock.hpp"
+#include "tasks/tasks.hpp"
 
 namespace parthenon {
 
 template <typename T>
 void MeshData<T>::Initialize(const MeshData<T> *src,
-                             const std::vector<std::string> &names, const bool shallow) {
+                             const std::vector<std::string> &names, const bool shallow,
+                             const bool copy_on_write) {
   if (src == nullptr) {
     PARTHENON_THROW("src points at null");
   }
   pmy_mesh_ = src->GetParentPointer();
+  exec_space_ = src->GetExecSpace();
+  ndim_ = src->GetNDim();
+  grid = src->grid;
   const int nblocks = src->NumBlocks();
+  sparse_pack_cache_.clear();
   block_data_.resize(nblocks);
   for (int i = 0; i < nblocks; i++) {
-    block_data_[i] = pmy_mesh_->block_list[i]->meshblock_data.Add(
-        stage_name_, src->GetBlockData(i), names, shallow);
+    // the blocks of src, which are only those of the whole mesh for its first partition
+    auto &src_data = src->GetBlockData(i);
+    block_data_[i] = src_data->GetBlockPointer()->meshblock_data.Add(
+        stage_name_, src_data, names, shallow, copy_on_write);
+  }
+}
+
+template <typename T>
+std::shared_ptr<MeshData<T>> &
+MeshData<T>::GetSubset(const std::vector<std::string> &names) {
+  auto it = subsets_.find(names);
+  if (it != subsets_.end()) return it->second;
+  std::string label = stage_name_ + "::subset";
+  for (const auto &name : names) {
+    label += "::" + name;
   }
+  auto subset = std::make_shared<MeshData<T>>(label);
+  subset->Initialize(this, names, true);
+  return subsets_[names] = subset;
 }
 
 template <typename T>
 void MeshData<T>::Set(BlockList_t blocks, Mesh *pmesh, int ndim) {
   const int nblocks = blocks.size();
   ndim_ = ndim;
+  sparse_pack_cache_.clear();
   block_data_.resize(nblocks);
   SetMeshPointer(pmesh);
   for (int i = 0; i < nblocks; i++) {
@@ -51,6 +78,68 @@ void MeshData<T>::Set(BlockList_t blocks, Mesh *pmesh) {
   Set(blocks, pmesh, ndim);
 }
 
+template <typename T>
+bool MeshData<T>::HasLevelJumps() const {
+  if (pmy_mesh_ != nullptr && !pmy_mesh_->multilevel) return false;
+  for (const auto &pbd : block_data_) {
+    const auto *pmb = pbd->GetBlockPointer();
+    for (const auto &nb : pmb->neighbors) {
+      if (nb.snb.level == pmb->loc.level()) continue;
+      // only faces have fluxes to correct
+      if (std::abs(nb.ni.ox1) + std::abs(nb.ni.ox2) + std::abs(nb.ni.ox3) == 1)
+        return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void MeshData<T>::StartTimeMeasurement() {
+  if (pmy_mesh_ == nullptr || !pmy_mesh_->AutomaticLoadBalancing()) return;
+  // don't charge this MeshData for its work that is still in flight
+  exec_space_.fence();
+  lb_timer_.reset();
+}
+
+template <typename T>
+void MeshData<T>::StopTimeMeasurement() {
+  if (pmy_mesh_ == nullptr || !pmy_mesh_->AutomaticLoadBalancing()) return;
+  exec_space_.fence();
+  AddMeasuredCost(lb_timer_.seconds());
+}
+
+template <typename T>
+std::shared_ptr<TaskCostMeter> MeshData<T>::MakeCostMeter() {
+  class MeshDataCostMeter : public TaskCostMeter {
+   public:
+    explicit MeshDataCostMeter(MeshData<T> *md) : md_(md) {}
+    void Finish() override { md_->GetExecSpace().fence(); }
+    void Add(double seconds) override { md_->AddMeasuredCost(seconds); }
+
+   private:
+    MeshData<T> *md_;
+  };
+  return std::make_shared<MeshDataCostMeter>(this);
+}
+
+template <typename T>
+void MeshData<T>::AddMeasuredCost(const double elapsed) {
+  if (pmy_mesh_ == nullptr || !pmy_mesh_->AutomaticLoadBalancing()) return;
+  std::vector<double> weights(NumBlocks(), 0.0);
+  double total_weight = 0.0;
+  for (int b = 0; b < NumBlocks(); ++b) {
+    for (const auto &v : block_data_[b]->GetVariableVector()) {
+      if (v->IsAllocated()) weights[b] += v->data.size();
+    }
+    total_weight += weights[b];
+  }
+  for (int b = 0; b < NumBlocks(); ++b) {
+    const double share = total_weight > 0.0 ? weights[b] / total_weight
+                                            : 1.0 / static_cast<double>(NumBlocks());
+    block_data_[b]->GetBlockPointer()->AddMeasuredCost(share * elapsed);
+  }
+}
+
 template class MeshData<Real>;
 
 } // namespace parthenon
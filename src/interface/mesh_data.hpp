@@ -14,6 +14,8 @@
 #define INTERFACE_MESH_DATA_HPP_
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <memory>
@@ -25,6 +27,7 @@
 #include "bvals/comms/bnd_info.hpp"
 #include "interface/sparse_pack_base.hpp"
 #include "interface/variable_pack.hpp"
+#include "kokkos_abstraction.hpp"
 #include "mesh/domain.hpp"
 #include "mesh/meshblock.hpp"
 #include "mesh/meshblock_pack.hpp"
@@ -39,6 +42,7 @@ namespace parthenon {
 class Mesh;
 template <typename T>
 class MeshBlockData;
+class TaskCostMeter;
 
 template <typename T>
 using BlockDataList_t = std::vector<std::shared_ptr<MeshBlockData<T>>>;
@@ -139,11 +143,17 @@ const MeshBlockPack<P> &PackOnMesh(M &map, BlockDataList_t<Real> &block_data_,
     // we don't have a cached pack, need to make a new one
     make_new_pack = true;
   } else {
-    // we have a cached pack, check allocation status
-    if (alloc_status_collection != itr->second.alloc_status) {
-      // allocation statuses differ, need to make a new pack and remove outdated one
-      make_new_pack = true;
-      map.erase(itr);
+    // we have a cached pack, check allocation status unless nothing has been
+    // (de)allocated since it was last checked
+    const auto epoch = AllocationEpoch();
+    if (itr->second.alloc_epoch != epoch) {
+      if (alloc_status_collection != itr->second.alloc_status) {
+        // allocation statuses differ, need to make a new pack and remove outdated one
+        make_new_pack = true;
+        map.erase(itr);
+      } else {
+        itr->second.alloc_epoch = epoch;
+      }
     }
   }
 
@@ -166,6 +176,7 @@ const MeshBlockPack<P> &PackOnMesh(M &map, BlockDataList_t<Real> &block_data_,
 
     typename M::mapped_type new_item;
     new_item.alloc_status = alloc_status_collection;
+    new_item.alloc_epoch = AllocationEpoch();
     new_item.map = pack_idx_map;
     new_item.pack = MeshBlockPack<P>(packs, dims);
 
@@ -210,6 +221,24 @@ class MeshData {
     pmy_mesh_ = other->GetMeshPointer();
   }
 
+  // Execution space instance kernels operating on this MeshData should be launched on,
+  // see Mesh::GetExecSpace.  Kernels of different partitions may run concurrently, so
+  // work that reads the results of another partition has to fence its instance first.
+  const DevExecSpace &GetExecSpace() const { return exec_space_; }
+
+  // Changes whenever the data of a variable of one of the blocks (or of one of those in
+  // include_block) is allocated, deallocated or moved, see MeshBlock::AllocationEpoch
+  std::uint64_t AllocationEpoch(const std::vector<bool> &include_block = {}) const {
+    std::uint64_t epoch = 0;
+    for (std::size_t b = 0; b < block_data_.size(); ++b) {
+      if (include_block.empty() || include_block[b]) {
+        epoch += block_data_[b]->AllocationEpoch();
+      }
+    }
+    return epoch;
+  }
+  void SetExecSpace(const DevExecSpace &exec_space) { exec_space_ = exec_space; }
+
   void SetAllowedDt(const Real dt) const {
     for (const auto &pbd : block_data_) {
       pbd->SetAllowedDt(std::min(dt, pbd->GetBlockPointer()->NewDt()));
@@ -249,7 +278,19 @@ class MeshData {
   void Set(BlockList_t blocks, Mesh *pmesh, int ndim);
   void Set(BlockList_t blocks, Mesh *pmesh);
   void Initialize(const MeshData<T> *src, const std::vector<std::string> &names,
-                  const bool shallow);
+                  const bool shallow, const bool copy_on_write = false);
+  // A shallow copy of this MeshData with only the variables in names, created the first
+  // time it is asked for.  It has its own caches, e.g., for exchanging the ghost zones
+  // of only some variables in a stage (see AddBoundaryExchangeTasks).
+  std::shared_ptr<MeshData<T>> &GetSubset(const std::vector<std::string> &names);
+
+  // see MeshBlockData::MakeWritable
+  template <class... Args>
+  void MakeWritable(Args &&...args) {
+    for (const auto &pbd : block_data_) {
+      pbd->MakeWritable(std::forward<Args>(args)...);
+    }
+  }
 
   const std::shared_ptr<MeshBlockData<T>> &GetBlockData(int n) const {
     assert(n >= 0 && n < block_data_.size());
@@ -404,17 +445,60 @@ class MeshData {
     return PackVariablesImpl(nullptr, coarse);
   }
 
+  // see MeshBlockData::EvictVariables
+  int EvictVariables() {
+    int n = 0;
+    for (const auto &pbd : block_data_) {
+      n += pbd->EvictVariables();
+    }
+    return n;
+  }
+  int RestoreVariables() {
+    int n = 0;
+    for (const auto &pbd : block_data_) {
+      n += pbd->RestoreVariables();
+    }
+    return n;
+  }
+
   void ClearCaches() {
     sparse_pack_cache_.clear();
     block_data_.clear();
     varPackMap_.clear();
     varFluxPackMap_.clear();
     bvars_cache_.clear();
+    bc_blocks_ = {};
+    subsets_.clear();
+  }
+
+  // Only the boundary buffer caches, e.g., after the buffers were rebuilt for blocks that
+  // are all still part of this MeshData
+  void ClearBoundaryCaches() {
+    bvars_cache_.clear();
+    for (auto &[names, subset] : subsets_) {
+      subset->ClearBoundaryCaches();
+    }
   }
 
   int GetNDim() const { return ndim_; }
   int NumBlocks() const { return block_data_.size(); }
 
+  // Whether any block shares a face with a block on a different level, i.e., whether
+  // there are flux corrections to send or receive.  This is always false on uniform
+  // meshes and cheap enough to be called whenever the task lists are built.
+  bool HasLevelJumps() const;
+
+  // Time the work done on this MeshData between the two calls for automatic load
+  // balancing. The time is split among the blocks in proportion to the number of
+  // allocated elements of their variables. Both calls fence the execution space of this
+  // MeshData, and they do nothing unless automatic load balancing is enabled.
+  void StartTimeMeasurement();
+  void StopTimeMeasurement();
+  // A meter that charges the time of the tasks of a TaskList to the blocks of this
+  // MeshData in the same way, after waiting for their kernels on its execution space,
+  // see TaskList::SetCostMeter.  The MeshData must outlive the executions of the list.
+  std::shared_ptr<TaskCostMeter> MakeCostMeter();
+
   bool operator==(MeshData<T> &cmp) const {
     const int nblocks = block_data_.size();
     const int nblocks_cmp = cmp.NumBlocks();
@@ -435,11 +519,25 @@ class MeshData {
 
   SparsePackCache &GetSparsePackCache() { return sparse_pack_cache_; }
 
+  // blocks with a physical boundary on a face, as used by BoundaryFunction::GenericBCMD
+  struct PhysicalBoundaryBlocks {
+    std::vector<int> host;
+    ParArray1D<int> device;
+  };
+  PhysicalBoundaryBlocks &GetPhysicalBoundaryBlocks(const BoundaryFace face) {
+    return bc_blocks_[face];
+  }
+
  private:
+  // split a measured cost among the blocks, see StopTimeMeasurement
+  void AddMeasuredCost(double seconds);
+
   int ndim_;
+  Kokkos::Timer lb_timer_;
   Mesh *pmy_mesh_;
   BlockDataList_t<T> block_data_;
   std::string stage_name_;
+  DevExecSpace exec_space_ = DevExecSpace();
 
   // caches for packs
   MapToMeshBlockVarPack<T> varPackMap_;
@@ -447,6 +545,8 @@ class MeshData {
   SparsePackCache sparse_pack_cache_;
   // caches for boundary information
   BvarsCache_t bvars_cache_;
+  std::array<PhysicalBoundaryBlocks, BOUNDARY_NFACES> bc_blocks_;
+  std::map<std::vector<std::string>, std::shared_ptr<MeshData<T>>> subsets_;
 };
 
 template <typename T, typename... Args>
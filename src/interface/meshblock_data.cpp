@@ -18,6 +18,7 @@
 #include <memory>
 #include <set>
 #include <sstream>
+#include <type_traits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -46,13 +47,19 @@ void MeshBlockData<T>::Initialize(
   varMap_.clear();
   varUidMap_.clear();
   flagsToVars_.clear();
+  flag_query_cache_.clear();
   varPackMap_.clear();
   coarseVarPackMap_.clear();
   varFluxPackMap_.clear();
+  sparse_pack_cache_.clear();
+  slab_ = Kokkos::View<T *, DevMemSpace>();
+  slab_chunk_.reset();
 
+  const bool slab = pmb->pmy_mesh != nullptr && pmb->pmy_mesh->slab_allocation;
   for (auto const &q : resolved_packages->AllFields()) {
-    AddField(q.first.base_name, q.second, q.first.sparse_id);
+    AddField(q.first.base_name, q.second, q.first.sparse_id, !slab);
   }
+  if (slab) AllocateSlab_();
 
   Metadata::FlagCollection flags({Metadata::Sparse, Metadata::ForceAllocOnNewBlocks});
   auto vars = GetVariablesByFlag(flags);
@@ -70,30 +77,127 @@ void MeshBlockData<T>::Initialize(
 /// @param sparse_id the sparse id of the variable
 template <typename T>
 void MeshBlockData<T>::AddField(const std::string &base_name, const Metadata &metadata,
-                                int sparse_id) {
+                                int sparse_id, bool allocate) {
   auto pvar = std::make_shared<Variable<T>>(base_name, metadata, sparse_id, pmy_block);
   Add(pvar);
+  // evictable variables need their own allocation (rather than a part of the slab) to
+  // be freed when evicted
+  allocate = allocate || metadata.IsSet(Metadata::Evictable);
 
-  if (!Globals::sparse_config.enabled || !pvar->IsSparse()) {
+  if (allocate && (!Globals::sparse_config.enabled || !pvar->IsSparse())) {
     pvar->Allocate(pmy_block);
   }
 }
 
+template <typename T>
+void MeshBlockData<T>::AllocateSlab_() {
+  // keep the start of every variable aligned like a separate allocation would be
+  constexpr std::size_t align = std::max<std::size_t>(1, 128 / sizeof(T));
+  // with slab_padding, arrays whose size is a multiple of the 4 KiB period of the L1
+  // cache sets get an extra cache line, so the same element of consecutive variables
+  // (or blocks, with mesh wide storage) does not map to the same cache set
+  constexpr std::size_t period = std::max<std::size_t>(1, 4096 / sizeof(T));
+  auto pmb = GetBlockPointer();
+  const bool padding = pmb->pmy_mesh->slab_padding;
+  auto padded = [=](const std::size_t n) {
+    const std::size_t aligned = (n + align - 1) / align * align;
+    return aligned + ((padding && aligned % period == 0) ? align : 0);
+  };
+  std::vector<std::shared_ptr<Variable<T>>> vars;
+  std::vector<std::size_t> offsets;
+  std::size_t size = 0;
+  for (auto &v : varVector_) {
+    if (v->IsAllocated() || (Globals::sparse_config.enabled && v->IsSparse())) continue;
+    std::size_t n = 1;
+    for (int d = 1; d <= MAX_VARIABLE_DIMENSION; d++) {
+      n *= v->GetDim(d);
+    }
+    vars.push_back(v);
+    offsets.push_back(size);
+    size += padded(n);
+  }
+  if (size == 0) return;
+  size = padded(size);
+
+  using chunk_t = Kokkos::View<T *, DevMemSpace>;
+  std::shared_ptr<chunk_t> chunk;
+  if constexpr (std::is_same_v<T, Real>) {
+    if (pmb->pmy_mesh->variable_pool) chunk = pmb->pmy_mesh->variable_pool->Get(size);
+  }
+  if (!chunk) chunk = std::make_shared<chunk_t>("MeshBlockData::slab", size);
+  slab_ = *chunk;
+  slab_chunk_ = chunk;
+
+  for (std::size_t i = 0; i < vars.size(); i++) {
+    vars[i]->AllocateDataAt(pmb.get(), chunk, chunk->data() + offsets[i]);
+    vars[i]->AllocateFluxesAndCoarse(pmy_block);
+  }
+}
+
+template <typename T>
+int MeshBlockData<T>::EvictVariables() {
+  auto pmb = GetBlockPointer();
+  int n = 0;
+  const Metadata::FlagCollection flags(Metadata::Evictable);
+  for (auto &v : GetVariablesByFlag(flags).vars()) {
+    const std::int64_t bytes = v->Evict();
+    if (bytes > 0) {
+      pmb->LogMemUsage(-bytes);
+      n++;
+    }
+  }
+  return n;
+}
+
+template <typename T>
+int MeshBlockData<T>::RestoreVariables() {
+  auto pmb = GetBlockPointer();
+  int n = 0;
+  const Metadata::FlagCollection flags(Metadata::Evictable);
+  for (auto &v : GetVariablesByFlag(flags).vars()) {
+    if (v->IsEvicted()) {
+      v->Restore(pmb);
+      n++;
+    }
+  }
+  return n;
+}
+
+template <typename T>
+void MeshBlockData<T>::MoveSlab(
+    const std::shared_ptr<Kokkos::View<T *, DevMemSpace>> &chunk, std::size_t offset) {
+  PARTHENON_REQUIRE_THROWS(slab_chunk_ != nullptr, "Block has no slab to move");
+  auto dest = Kokkos::subview(*chunk, std::make_pair(offset, offset + slab_.size()));
+  Kokkos::deep_copy(dest, slab_);
+  for (auto &v : varVector_) {
+    if (v->IsAllocated() && v->data_chunk_ == slab_chunk_) {
+      v->RebindData(chunk, dest.data() + (v->data.data() - slab_.data()));
+    }
+  }
+  slab_ = dest;
+  slab_chunk_ = chunk;
+  ClearCaches();
+}
+
 // TODO(JMM): Move to unique IDs at some point
 template <typename T>
 void MeshBlockData<T>::Initialize(const MeshBlockData<T> *src,
                                   const std::vector<std::string> &names,
-                                  const bool shallow_copy) {
+                                  const bool shallow_copy, const bool copy_on_write) {
   assert(src != nullptr);
   SetBlockPointer(src);
   resolved_packages_ = src->resolved_packages_;
   is_shallow_ = shallow_copy;
+  sparse_pack_cache_.clear();
 
+  auto pmb = pmy_block.lock();
+  const bool cow = copy_on_write && !(pmb && pmb->pmy_mesh != nullptr &&
+                                      pmb->pmy_mesh->slab_allocation);
   auto add_var = [=](auto var) {
     if (shallow_copy || var->IsSet(Metadata::OneCopy)) {
       Add(var);
     } else {
-      Add(var->AllocateCopy(pmy_block));
+      Add(var->AllocateCopy(pmy_block, cow));
     }
   };
 
@@ -118,6 +222,31 @@ void MeshBlockData<T>::Initialize(const MeshBlockData<T> *src,
   }
 }
 
+template <typename T>
+void MeshBlockData<T>::MakeWritable(const std::vector<std::string> &names) {
+  if (!AnySharesData_()) return;
+  MakeWritable_(names.empty() ? GetAllVariables() : GetVariablesByName(names));
+}
+
+template <typename T>
+void MeshBlockData<T>::MakeWritable(const std::vector<MetadataFlag> &flags) {
+  MakeWritable(Metadata::FlagCollection(flags));
+}
+
+template <typename T>
+void MeshBlockData<T>::MakeWritable(const Metadata::FlagCollection &flags) {
+  if (!AnySharesData_()) return;
+  MakeWritable_(GetVariablesByFlag(flags));
+}
+
+template <typename T>
+void MeshBlockData<T>::MakeWritable_(const VarList &vars) {
+  auto pmb = GetBlockPointer();
+  for (const auto &v : vars.vars()) {
+    v->MakeWritable(pmb);
+  }
+}
+
 /// Queries related to variable packs
 /// This is a helper function that queries the cache for the given pack.
 /// The strings are the keys and the lists are the values.
@@ -139,12 +268,18 @@ const VariableFluxPack<T> &MeshBlockData<T>::PackListedVariablesAndFluxes(
     // we don't have a cached pack, need to make a new one
     make_new_pack = true;
   } else {
-    // we have a cached pack, check allocation status
-    if ((var_list.alloc_status() != itr->second.alloc_status) ||
-        (flux_list.alloc_status() != itr->second.flux_alloc_status)) {
-      // allocation statuses differ, need to make a new pack and remove outdated one
-      make_new_pack = true;
-      varFluxPackMap_.erase(itr);
+    // we have a cached pack, check allocation status unless nothing has been
+    // (de)allocated since it was last checked
+    const auto epoch = AllocationEpoch();
+    if (itr->second.alloc_epoch != epoch) {
+      if ((var_list.alloc_status() != itr->second.alloc_status) ||
+          (flux_list.alloc_status() != itr->second.flux_alloc_status)) {
+        // allocation statuses differ, need to make a new pack and remove outdated one
+        make_new_pack = true;
+        varFluxPackMap_.erase(itr);
+      } else {
+        itr->second.alloc_epoch = epoch;
+      }
     }
   }
 
@@ -152,6 +287,7 @@ const VariableFluxPack<T> &MeshBlockData<T>::PackListedVariablesAndFluxes(
     FluxPackIndxPair<T> new_item;
     new_item.alloc_status = var_list.alloc_status();
     new_item.flux_alloc_status = flux_list.alloc_status();
+    new_item.alloc_epoch = AllocationEpoch();
     new_item.pack = MakeFluxPack(var_list, flux_list, &new_item.map);
     new_item.pack.coords = GetParentPointer()->coords_device;
     itr = varFluxPackMap_.insert({keys, new_item}).first;
@@ -192,17 +328,24 @@ MeshBlockData<T>::PackListedVariables(const VarList &var_list, bool coarse,
     // we don't have a cached pack, need to make a new one
     make_new_pack = true;
   } else {
-    // we have a cached pack, check allocation status
-    if (var_list.alloc_status() != itr->second.alloc_status) {
-      // allocation statuses differ, need to make a new pack and remove outdated one
-      make_new_pack = true;
-      packmap.erase(itr);
+    // we have a cached pack, check allocation status unless nothing has been
+    // (de)allocated since it was last checked
+    const auto epoch = AllocationEpoch();
+    if (itr->second.alloc_epoch != epoch) {
+      if (var_list.alloc_status() != itr->second.alloc_status) {
+        // allocation statuses differ, need to make a new pack and remove outdated one
+        make_new_pack = true;
+        packmap.erase(itr);
+      } else {
+        itr->second.alloc_epoch = epoch;
+      }
     }
   }
 
   if (make_new_pack) {
     PackIndxPair<T> new_item;
     new_item.alloc_status = var_list.alloc_status();
+    new_item.alloc_epoch = AllocationEpoch();
     new_item.pack = MakePack<T>(var_list, coarse, &new_item.map);
     new_item.pack.coords = GetParentPointer()->coords_device;
 
@@ -323,6 +466,9 @@ MeshBlockData<T>::GetVariablesByName(const std::vector<std::string> &names,
 // case, this is linear in number of variables. However, on average,
 // the number of vars with a desired flag will be much smaller than
 // all vars. So average performance is much better than linear.
+//
+// The same flags are queried over and over again, so the matching
+// variables are memoized and the search only runs the first time.
 template <typename T>
 typename MeshBlockData<T>::VarList
 MeshBlockData<T>::GetVariablesByFlag(const Metadata::FlagCollection &flags,
@@ -332,9 +478,15 @@ MeshBlockData<T>::GetVariablesByFlag(const Metadata::FlagCollection &flags,
   typename MeshBlockData<T>::VarList var_list;
   std::unordered_set<int> sparse_ids_set(sparse_ids.begin(), sparse_ids.end());
 
-  auto vars = MetadataUtils::GetByFlag<VariableSet<T>>(flags, varMap_, flagsToVars_);
+  auto itr = flag_query_cache_.find(flags);
+  if (itr == flag_query_cache_.end()) {
+    auto vars = MetadataUtils::GetByFlag<VariableSet<T>>(flags, varMap_, flagsToVars_);
+    itr = flag_query_cache_
+              .emplace(flags, std::vector<VarPtr<T>>(vars.begin(), vars.end()))
+              .first;
+  }
 
-  for (auto &v : vars) {
+  for (const auto &v : itr->second) {
     var_list.Add(v, sparse_ids_set);
   }
 
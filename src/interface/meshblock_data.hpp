@@ -13,10 +13,13 @@
 #ifndef INTERFACE_MESHBLOCK_DATA_HPP_
 #define INTERFACE_MESHBLOCK_DATA_HPP_
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -77,6 +80,10 @@ class MeshBlockData {
   MeshBlock *GetParentPointer() const { return GetBlockPointer(); }
   void SetAllowedDt(const Real dt) const { GetBlockPointer()->SetAllowedDt(dt); }
   Mesh *GetMeshPointer() const { return GetBlockPointer()->pmy_mesh; }
+  // execution space instance for kernels on this data, see MeshData::GetExecSpace
+  const DevExecSpace &GetExecSpace() const { return GetBlockPointer()->exec_space; }
+  // see MeshBlock::AllocationEpoch
+  std::uint64_t AllocationEpoch() const { return GetBlockPointer()->AllocationEpoch(); }
 
   template <class... Ts>
   IndexRange GetBoundsI(Ts &&...args) const {
@@ -108,9 +115,12 @@ class MeshBlockData {
 
   /// Create copy of MeshBlockData, possibly with a subset of named fields,
   /// and possibly shallow.  Note when shallow=false, new storage is allocated
-  /// for non-OneCopy vars, but the data from src is not actually deep copied
+  /// for non-OneCopy vars, but the data from src is not actually deep copied.
+  /// With copy_on_write, non-OneCopy vars instead share the storage of src until
+  /// MakeWritable is called for them here or in src (not supported, and ignored, with
+  /// slab allocation since the vars of src would have to leave the slab)
   void Initialize(const MeshBlockData<T> *src, const std::vector<std::string> &names,
-                  const bool shallow);
+                  const bool shallow, const bool copy_on_write = false);
 
   //
   // Queries related to Variable objects
@@ -121,6 +131,29 @@ class MeshBlockData {
 
   const VariableVector<T> &GetVariableVector() const noexcept { return varVector_; }
 
+  // The memory holding the data of all dense variables of this block, in the order of
+  // GetVariableVector() with the start of every variable aligned to 128 bytes, if
+  // <parthenon/mesh>/slab_allocation is set.  Empty otherwise.
+  const Kokkos::View<T *, DevMemSpace> &GetSlab() const noexcept { return slab_; }
+  // Copy the slab to chunk, starting at offset, and rebind the variables in it, e.g.
+  // into the mesh wide storage of Mesh.  Clears the pack caches.
+  void MoveSlab(const std::shared_ptr<Kokkos::View<T *, DevMemSpace>> &chunk,
+                std::size_t offset);
+
+  // drop all cached packs, e.g. after the data of variables moved
+  void ClearCaches() {
+    varPackMap_.clear();
+    coarseVarPackMap_.clear();
+    varFluxPackMap_.clear();
+    sparse_pack_cache_.clear();
+  }
+
+  // Move the data of all Metadata::Evictable variables to host memory and free it on
+  // the device, or copy it back.  Evicted variables must not be used, e.g., in packs,
+  // before they are restored.  Returns the number of variables evicted or restored.
+  int EvictVariables();
+  int RestoreVariables();
+
   const MapToVars<T> &GetVariableMap() const noexcept { return varMap_; }
 
   std::shared_ptr<Variable<T>> GetVarPtr(const std::string &label) const {
@@ -414,17 +447,34 @@ class MeshBlockData {
 
   bool IsShallow() const { return is_shallow_; }
 
+  /// Give the variables selected by names (all if empty) or flags their own storage if
+  /// they share it with a copy-on-write copy, see DataCollection::AddCopyOnWrite.  This
+  /// must be called before writing to variables that may be shared, and is cheap if
+  /// none are.
+  void MakeWritable(const std::vector<std::string> &names = {});
+  void MakeWritable(const std::vector<MetadataFlag> &flags);
+  void MakeWritable(const Metadata::FlagCollection &flags);
+
  private:
+  // dense fields are allocated unless allocate is false
   void AddField(const std::string &base_name, const Metadata &metadata,
-                int sparse_id = InvalidSparseID);
+                int sparse_id = InvalidSparseID, bool allocate = true);
+  // allocate the data of all unallocated dense variables as one slab
+  void AllocateSlab_();
+  bool AnySharesData_() const {
+    return std::any_of(varVector_.begin(), varVector_.end(),
+                       [](const auto &v) { return v->SharesData(); });
+  }
+  void MakeWritable_(const VarList &vars);
 
   void Add(std::shared_ptr<Variable<T>> var) noexcept {
     varVector_.push_back(var);
     varMap_[var->label()] = var;
-    varUidMap_[var->GetUniqueID()] = var;
+    varUidMap_.Insert(var);
     for (const auto &flag : var->metadata().Flags()) {
       flagsToVars_[flag].insert(var);
     }
+    flag_query_cache_.clear();
   }
 
   std::shared_ptr<Variable<T>> AllocateSparse(std::string const &label,
@@ -470,10 +520,18 @@ class MeshBlockData {
   const std::string stage_name_;
 
   VariableVector<T> varVector_; ///< the saved variable array
-  std::map<Uid_t, std::shared_ptr<Variable<T>>> varUidMap_;
+  Kokkos::View<T *, DevMemSpace> slab_;
+  // owner of the memory of slab_, shared with the variables in it
+  std::shared_ptr<void> slab_chunk_;
+  UidToVars<T> varUidMap_;
 
   MapToVars<T> varMap_;
   MetadataFlagToVariableMap<T> flagsToVars_;
+  // Results of GetVariablesByFlag, before selecting sparse ids.  Which variables match
+  // only changes when variables are added, so this is cleared by Add and Initialize.
+  std::unordered_map<Metadata::FlagCollection, std::vector<VarPtr<T>>,
+                     Metadata::FlagCollection::Hash>
+      flag_query_cache_;
 
   // variable packing
   MapToVariablePack<T> varPackMap_;
@@ -29,6 +29,7 @@
 #include "prolong_restrict/pr_ops.hpp"
 #include "prolong_restrict/prolong_restrict.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/hash.hpp"
 
 /// The point of this macro is to generate code for each built-in flag using the
 /// `PARTHENON_INTERNAL_FOR_FLAG` macro. This is to accomplish the following goals:
@@ -114,8 +115,18 @@
   PARTHENON_INTERNAL_FOR_FLAG(GMGProlongate)                                             \
   /** the variable participate in GMG calculations */                                    \
   PARTHENON_INTERNAL_FOR_FLAG(GMGRestrict)                                               \
+  /** the coarse data sent to the next coarser GMG level is filled by the caller **/     \
+  PARTHENON_INTERNAL_FOR_FLAG(GMGUserRestrict)                                           \
   /** the variable must always be allocated for new blocks **/                           \
-  PARTHENON_INTERNAL_FOR_FLAG(ForceAllocOnNewBlocks)
+  PARTHENON_INTERNAL_FOR_FLAG(ForceAllocOnNewBlocks)                                     \
+  /** boundary buffers sent to other ranks are encoded, see SetCommEncoding **/          \
+  PARTHENON_INTERNAL_FOR_FLAG(CompressedCommunication)                                   \
+  /** all variables of a swarm share one allocation per data type **/                   \
+  PARTHENON_INTERNAL_FOR_FLAG(Contiguous)                                                \
+  /** the data may be evicted to host memory while not in use, see EvictVariables **/   \
+  PARTHENON_INTERNAL_FOR_FLAG(Evictable)                                                 \
+  /** the data is written before it is read and need not be zeroed when allocated **/  \
+  PARTHENON_INTERNAL_FOR_FLAG(WithoutInitialization)
 namespace parthenon {
 
 namespace internal {
@@ -301,6 +312,24 @@ class Metadata {
     const std::set<MetadataFlag> &GetIntersections() const { return intersections_; }
     const std::set<MetadataFlag> &GetExclusions() const { return exclusions_; }
 
+    bool operator==(const FlagCollection &other) const {
+      return unions_ == other.unions_ && intersections_ == other.intersections_ &&
+             exclusions_ == other.exclusions_;
+    }
+    // so that the results of flag queries can be memoized
+    struct Hash {
+      std::size_t operator()(const FlagCollection &fc) const {
+        std::size_t hash = 0;
+        for (const auto *flags : {&fc.unions_, &fc.intersections_, &fc.exclusions_}) {
+          hash = impl::hash_combine(hash, flags->size());
+          for (const auto &flag : *flags) {
+            hash = impl::hash_combine(hash, flag.InternalFlagValue());
+          }
+        }
+        return hash;
+      }
+    };
+
    private:
     std::set<MetadataFlag> unions_, intersections_, exclusions_;
   };
@@ -360,6 +389,29 @@ class Metadata {
   parthenon::Real GetAllocationThreshold() const { return allocation_threshold_; }
   parthenon::Real GetDefaultValue() const { return default_value_; }
 
+  // Encoding of the boundary buffers of this variable that are sent to other ranks.
+  // CommEncoding::quantized reproduces values to within error_bound, float32 and
+  // bfloat16 round them to reduced precision (see bvals/comms/comm_encoding.hpp).
+  void SetCommEncoding(CommEncoding encoding, parthenon::Real error_bound = 0.0) {
+    PARTHENON_REQUIRE_THROWS(error_bound >= 0.0, "Error bound must be non-negative");
+    comm_encoding_ = encoding;
+    comm_error_bound_ = error_bound;
+    DoBit(CompressedCommunication, encoding != CommEncoding::none);
+  }
+  CommEncoding GetCommEncoding() const {
+    return IsSet(CompressedCommunication) ? comm_encoding_ : CommEncoding::none;
+  }
+  parthenon::Real GetCommErrorBound() const { return comm_error_bound_; }
+
+  // Number of ghost layers of this variable that are communicated, if its stencils need
+  // fewer than Globals::nghost, or 0 for all of them.  This only has an effect on
+  // meshes without refinement, see GetCommGhostWidth.
+  void SetGhostWidth(int width) {
+    PARTHENON_REQUIRE_THROWS(width >= 0, "Ghost width must be non-negative");
+    ghost_width_ = width;
+  }
+  int GetGhostWidth() const { return ghost_width_; }
+
   // Individual flag setters, using these could result in an invalid set of flags, use
   // IsValid to check if the flags are valid
   // TODO(JMM): This is dangerous. See Issue #844.
@@ -618,6 +670,10 @@ class Metadata {
   parthenon::Real deallocation_threshold_;
   parthenon::Real default_value_;
 
+  CommEncoding comm_encoding_ = CommEncoding::none;
+  parthenon::Real comm_error_bound_ = 0.0;
+  int ghost_width_ = 0;
+
   /// if flag is true set bit, clears otherwise
   void DoBit(MetadataFlag bit, bool flag) {
     if (bit.flag_ >= bits_.size()) {
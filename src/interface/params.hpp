@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <typeindex>
+#include <type_traits>
 #include <typeinfo>
 #include <unordered_set>
 #include <utility>
@@ -70,7 +71,12 @@ class Params {
                              "Parameter " + key + " must be marked as mutable");
     PARTHENON_REQUIRE_THROWS(myTypes_.at(key) == std::type_index(typeid(T)),
                              "WRONG TYPE FOR KEY '" + key + "'");
-    myParams_[key] = std::unique_ptr<Params::base_t>(new object_t<T>(value));
+    // update in place where possible, so that handles and pointers stay valid
+    if constexpr (std::is_copy_assignable_v<T>) {
+      *GetTypedPointer_<T>(key)->pValue = value;
+    } else {
+      myParams_[key] = std::unique_ptr<Params::base_t>(new object_t<T>(value));
+    }
   }
 
   void reset() {
@@ -85,6 +91,31 @@ class Params {
     return *typed_ptr->pValue;
   }
 
+  // A handle resolves the key of a parameter once, so that reading the parameter through
+  // it, e.g., every stage from within a task, doesn't search the map.  It stays valid
+  // until the parameter is removed by reset(), or replaced by Update for types that
+  // can't be assigned to.
+  template <typename T>
+  class Handle {
+   public:
+    Handle() = default;
+
+    const T &operator*() const { return *ptr_; }
+    const T *operator->() const { return ptr_; }
+    const T &Get() const { return *ptr_; }
+    bool IsValid() const { return ptr_ != nullptr; }
+
+   private:
+    friend class Params;
+    explicit Handle(const T *ptr) : ptr_(ptr) {}
+    const T *ptr_ = nullptr;
+  };
+
+  template <typename T>
+  Handle<T> GetHandle(const std::string &key) const {
+    return Handle<T>(GetTypedPointer_<T>(key)->pValue.get());
+  }
+
   // Returning a pointer feels safer than returning a non-const reference.
   // Memory is managed by params so we don't want reference counting.
   // But we also don't want the reference completely re-assigned.
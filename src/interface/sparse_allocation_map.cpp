@@ -0,0 +1,51 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "interface/sparse_allocation_map.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "interface/meshblock_data.hpp"
+#include "interface/variable.hpp"
+#include "mesh/meshblock.hpp"
+
+namespace parthenon {
+
+void SparseAllocationMap::Resize(const int nblocks, const std::vector<Uid_t> &uids) {
+  columns_.clear();
+  for (const auto uid : uids) {
+    columns_.emplace(uid, columns_.size());
+  }
+  device_ = device_t("sparse allocation map", nblocks, columns_.size());
+  host_ = Kokkos::create_mirror_view(device_);
+  Kokkos::deep_copy(host_, false);
+  dirty_ = true;
+}
+
+void SparseAllocationMap::Rebuild(const std::vector<std::shared_ptr<MeshBlock>> &blocks) {
+  std::vector<Uid_t> uids;
+  if (blocks.size() > 0) {
+    for (const auto &v : blocks.front()->meshblock_data.Get()->GetVariableVector()) {
+      if (v->IsSparse()) uids.push_back(v->GetUniqueID());
+    }
+  }
+  Resize(blocks.size(), uids);
+  for (const auto &pmb : blocks) {
+    for (const auto &v : pmb->meshblock_data.Get()->GetVariableVector()) {
+      if (v->IsSparse()) Set(pmb->lid, v->GetUniqueID(), v->IsAllocated());
+    }
+  }
+}
+
+} // namespace parthenon
@@ -0,0 +1,89 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_SPARSE_ALLOCATION_MAP_HPP_
+#define INTERFACE_SPARSE_ALLOCATION_MAP_HPP_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "kokkos_abstraction.hpp"
+#include "utils/unique_id.hpp"
+
+namespace parthenon {
+
+class MeshBlock;
+
+// Allocation status of all sparse variables on all blocks of this rank, indexed by the
+// local id of the block and a column per sparse variable, on the host and on the
+// device.  MeshBlock::AllocateSparse and MeshBlock::DeallocateSparse keep it up to date,
+// so the status can be queried without going through the variables of a block, and
+// kernels can read it without a pack.  The device view is only uploaded when the
+// status changed since it was last requested.  Since local ids change with remeshing,
+// the map is rebuilt from the variables by Mesh::Initialize after every remesh, i.e.,
+// it is not meant to be read while blocks are being redistributed.
+class SparseAllocationMap {
+ public:
+  using device_t = Kokkos::View<bool **, DevMemSpace>;
+  using host_t = typename device_t::HostMirror;
+
+  // set up the map for nblocks blocks and the sparse variables with unique ids uids,
+  // with all of them unallocated
+  void Resize(int nblocks, const std::vector<Uid_t> &uids);
+  // set up the map for the blocks of this rank from the variables of their base
+  // MeshBlockData
+  void Rebuild(const std::vector<std::shared_ptr<MeshBlock>> &blocks);
+
+  int NumBlocks() const { return host_.extent_int(0); }
+  int NumColumns() const { return host_.extent_int(1); }
+  // column of the sparse variable with unique id uid, -1 if it is not in the map
+  int Column(const Uid_t uid) const {
+    const auto it = columns_.find(uid);
+    return it == columns_.end() ? -1 : it->second;
+  }
+
+  // Updates of blocks (or variables) the map was not set up for are ignored, they are
+  // picked up by the next Rebuild
+  void Set(const int lid, const Uid_t uid, const bool allocated) {
+    const int col = Column(uid);
+    if (col < 0 || lid < 0 || lid >= NumBlocks()) return;
+    if (host_(lid, col) == allocated) return;
+    host_(lid, col) = allocated;
+    dirty_ = true;
+  }
+
+  bool IsAllocated(const int lid, const Uid_t uid) const {
+    const int col = Column(uid);
+    return col >= 0 && lid >= 0 && lid < NumBlocks() && host_(lid, col);
+  }
+
+  const host_t &GetHostView() const { return host_; }
+  // (block lid, column), see Column
+  const device_t &GetDeviceView() {
+    if (dirty_) {
+      Kokkos::deep_copy(device_, host_);
+      dirty_ = false;
+    }
+    return device_;
+  }
+
+ private:
+  std::unordered_map<Uid_t, int> columns_;
+  device_t device_;
+  host_t host_;
+  bool dirty_ = false;
+};
+
+} // namespace parthenon
+
+#endif // INTERFACE_SPARSE_ALLOCATION_MAP_HPP_
@@ -168,7 +168,16 @@ class SparsePack : public SparsePackBase {
  public:
   SparsePack() = default;
 
-  explicit SparsePack(const SparsePackBase &spb) : SparsePackBase(spb) {}
+  explicit SparsePack(const SparsePackBase &spb) : SparsePackBase(spb) {
+    if constexpr (sizeof...(Ts) > 0) {
+      if (uniform_bounds_) {
+        for (std::size_t v = 0; v < sizeof...(Ts); ++v) {
+          uniform_lower_[v] = bounds_h_(0, 0, v);
+          uniform_upper_[v] = bounds_h_(1, 0, v);
+        }
+      }
+    }
+  }
 
   class Descriptor : public impl::PackDescriptor {
    public:
@@ -223,6 +232,12 @@ class SparsePack : public SparsePackBase {
   KOKKOS_INLINE_FUNCTION
   const Coordinates_t &GetCoordinates(const int b = 0) const { return coords_(b)(); }
 
+  // Whether all variables have the same bounds on every block, in which case the bounds
+  // of the types Ts... are members of the pack, i.e., kernel arguments, rather than read
+  // from memory by every thread
+  KOKKOS_FORCEINLINE_FUNCTION
+  bool HasUniformBounds() const { return uniform_bounds_; }
+
   // Bound overloads
   KOKKOS_INLINE_FUNCTION int GetLowerBound(const int b) const {
     return (flat_ && (b > 0)) ? (bounds_(1, b - 1, nvar_) + 1) : 0;
@@ -245,13 +260,13 @@ class SparsePack : public SparsePackBase {
   template <class TIn, REQUIRES(IncludesType<TIn, Ts...>::value)>
   KOKKOS_INLINE_FUNCTION int GetLowerBound(const int b, const TIn &) const {
     const int vidx = GetTypeIdx<TIn, Ts...>::value;
-    return bounds_(0, b, vidx);
+    return uniform_bounds_ ? uniform_lower_[vidx] : bounds_(0, b, vidx);
   }
 
   template <class TIn, REQUIRES(IncludesType<TIn, Ts...>::value)>
   KOKKOS_INLINE_FUNCTION int GetUpperBound(const int b, const TIn &) const {
     const int vidx = GetTypeIdx<TIn, Ts...>::value;
-    return bounds_(1, b, vidx);
+    return uniform_bounds_ ? uniform_upper_[vidx] : bounds_(1, b, vidx);
   }
 
   // Host Bound overloads
@@ -453,6 +468,11 @@ class SparsePack : public SparsePackBase {
                                       VTs... vts) const {
     return std::make_tuple(&(*this)(b, el, vts, k, j, i)...);
   }
+
+ private:
+  // the bounds of the types Ts... if uniform_bounds_
+  int uniform_lower_[sizeof...(Ts) > 0 ? sizeof...(Ts) : 1] = {};
+  int uniform_upper_[sizeof...(Ts) > 0 ? sizeof...(Ts) : 1] = {};
 };
 
 } // namespace parthenon
@@ -12,12 +12,14 @@
 //========================================================================================
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <regex>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -64,12 +66,126 @@ inline auto ForEachBlock(T *pmbd, const std::vector<bool> &include_block, F func
     -> decltype(T().GetBlockPointer(), void()) {
   if (include_block.size() == 0 || include_block[0]) func(0, pmbd);
 }
+
+// Pinned host buffer that packs are filled in before they are uploaded. Its elements
+// are views, so they are reset once the uploads are done to not keep the memory of the
+// variables alive.
+template <class T>
+class PackStaging {
+ public:
+  bool Fits(const std::size_t n) const { return used_ + n <= buffer_.extent(0); }
+
+  // n elements that are not part of an upload in flight, the buffer may only grow
+  // when nothing is in flight
+  T *Take(const std::size_t n) {
+    if (!Fits(n)) {
+      PARTHENON_REQUIRE(used_ == 0, "Pack staging buffer can't grow during uploads");
+      buffer_ = buffer_t("pack staging", std::max(n, 2 * buffer_.extent(0)));
+    }
+    T *ptr = buffer_.data() + used_;
+    used_ += n;
+    return ptr;
+  }
+
+  void Release() {
+    for (std::size_t i = 0; i < used_; ++i) {
+      buffer_(i) = T();
+    }
+    used_ = 0;
+  }
+
+ private:
+  using buffer_t = Kokkos::View<T *, Kokkos::SharedHostPinnedSpace>;
+  buffer_t buffer_;
+  std::size_t used_ = 0;
+};
+
+// Uploads of packs to the device, on an execution space instance of their own so that
+// they don't wait for (or hold up) the kernels in flight
+template <class PACK_ELEM, class COORDS_ELEM>
+class PackUploads {
+ public:
+  static PackUploads &Get() {
+    static std::unique_ptr<PackUploads> uploads;
+    if (!uploads) {
+      uploads = std::make_unique<PackUploads>();
+      // the instance and pinned memory must be freed before Kokkos is finalized
+      Kokkos::push_finalize_hook([]() { uploads.reset(); });
+    }
+    return *uploads;
+  }
+
+  PackUploads()
+      : space_(Kokkos::Experimental::partition_space(parthenon::DevExecSpace(), 1)[0]) {}
+
+  // Host views of n pack and ncoords coords elements to fill, waiting for the uploads
+  // in flight if the staging buffers are full
+  auto Stage(const int nt, const int nb, const int nv, const int ncoords) {
+    const std::size_t n = static_cast<std::size_t>(nt) * nb * nv;
+    if (!packs_.Fits(n) || !coords_.Fits(ncoords)) Fence();
+    return std::make_pair(host_pack_t(packs_.Take(n), nt, nb, nv),
+                          host_coords_t(coords_.Take(ncoords), ncoords));
+  }
+
+  template <class... Args>
+  void Upload(const Args &...dst_src) {
+    CopyPairs(dst_src...);
+    pending_ = true;
+  }
+
+  bool Pending() const { return pending_; }
+
+  void Fence() {
+    if (!pending_) return;
+    space_.fence();
+    packs_.Release();
+    coords_.Release();
+    pending_ = false;
+  }
+
+  using host_pack_t = Kokkos::View<PACK_ELEM ***, parthenon::LayoutWrapper,
+                                   Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+  using host_coords_t = Kokkos::View<COORDS_ELEM *, parthenon::LayoutWrapper,
+                                     Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+
+ private:
+  void CopyPairs() {}
+  template <class D, class S, class... Args>
+  void CopyPairs(const D &dst, const S &src, const Args &...rest) {
+    Kokkos::deep_copy(space_, dst, src);
+    CopyPairs(rest...);
+  }
+
+  parthenon::DevExecSpace space_;
+  PackStaging<PACK_ELEM> packs_;
+  PackStaging<COORDS_ELEM> coords_;
+  bool pending_ = false;
+};
 } // namespace
 
 namespace parthenon {
 
 using namespace impl;
 
+// Nothing needs to be staged if the device can read host memory
+constexpr bool stage_packs =
+    !Kokkos::SpaceAccessibility<Kokkos::HostSpace, DevMemSpace>::accessible;
+using pack_uploads_t =
+    PackUploads<ParArray3D<Real, VariableState>, ParArray0D<Coordinates_t>>;
+
+PackUploadBatch::~PackUploadBatch() {
+  if (--depth_ == 0) SparsePackBase::FenceUploads();
+}
+
+bool PackUploadBatch::UploadsPending() {
+  if constexpr (stage_packs) return pack_uploads_t::Get().Pending();
+  return false;
+}
+
+void SparsePackBase::FenceUploads() {
+  if constexpr (stage_packs) pack_uploads_t::Get().Fence();
+}
+
 SparsePackIdxMap SparsePackBase::GetIdxMap(const impl::PackDescriptor &desc) {
   SparsePackIdxMap map;
   std::size_t idx = 0;
@@ -80,38 +196,6 @@ SparsePackIdxMap SparsePackBase::GetIdxMap(const impl::PackDescriptor &desc) {
   return map;
 }
 
-template <class T>
-SparsePackBase::alloc_t
-SparsePackBase::GetAllocStatus(T *pmd, const PackDescriptor &desc,
-                               const std::vector<bool> &include_block) {
-  using mbd_t = MeshBlockData<Real>;
-
-  int nvar = desc.nvar_groups;
-
-  std::vector<int> astat;
-  ForEachBlock(pmd, include_block, [&](int b, mbd_t *pmbd) {
-    const auto &uid_map = pmbd->GetUidMap();
-    for (int i = 0; i < nvar; ++i) {
-      for (const auto &[var_name, uid] : desc.var_groups[i]) {
-        if (uid_map.count(uid) > 0) {
-          const auto pv = uid_map.at(uid);
-          astat.push_back(pv->GetAllocationStatus());
-        } else {
-          astat.push_back(-1);
-        }
-      }
-    }
-  });
-  return astat;
-}
-
-// Specialize for the only two types this should work for
-template SparsePackBase::alloc_t SparsePackBase::GetAllocStatus<MeshBlockData<Real>>(
-    MeshBlockData<Real> *, const PackDescriptor &, const std::vector<bool> &);
-template SparsePackBase::alloc_t
-SparsePackBase::GetAllocStatus<MeshData<Real>>(MeshData<Real> *, const PackDescriptor &,
-                                               const std::vector<bool> &);
-
 template <class T>
 SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
                                      const std::vector<bool> &include_block) {
@@ -163,7 +247,6 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
     leading_dim += 2;
   }
   pack.pack_ = pack_t("data_ptr", leading_dim, pack.nblocks_, max_size);
-  auto pack_h = Kokkos::create_mirror_view(pack.pack_);
 
   // For non-flat packs, shape of pack is type x block x var x k x j x i
   // where type here might be a flux.
@@ -175,7 +258,20 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
   pack.bounds_h_ = Kokkos::create_mirror_view(pack.bounds_);
 
   pack.coords_ = coords_t("coords", desc.flat ? max_size : nblocks);
-  auto coords_h = Kokkos::create_mirror_view(pack.coords_);
+
+  // The views are filled in place if the host can write them, otherwise in staging
+  // buffers they are uploaded from
+  typename pack_uploads_t::host_pack_t pack_h;
+  typename pack_uploads_t::host_coords_t coords_h;
+  if constexpr (stage_packs) {
+    std::tie(pack_h, coords_h) = pack_uploads_t::Get().Stage(
+        leading_dim, pack.nblocks_, max_size, pack.coords_.extent_int(0));
+  } else {
+    pack_h = typename pack_uploads_t::host_pack_t(pack.pack_.data(), leading_dim,
+                                                  pack.nblocks_, max_size);
+    coords_h = typename pack_uploads_t::host_coords_t(pack.coords_.data(),
+                                                      pack.coords_.extent_int(0));
+  }
 
   // Fill the views
   int idx = 0;
@@ -269,9 +365,18 @@ SparsePackBase SparsePackBase::Build(T *pmd, const PackDescriptor &desc,
     pack.bounds_h_(1, blidx, nvar) = idx - 1;
     blidx++;
   });
-  Kokkos::deep_copy(pack.pack_, pack_h);
-  Kokkos::deep_copy(pack.bounds_, pack.bounds_h_);
-  Kokkos::deep_copy(pack.coords_, coords_h);
+  pack.uniform_bounds_ = !desc.flat && blidx > 0;
+  for (int b = 1; b < blidx && pack.uniform_bounds_; ++b) {
+    for (int i = 0; i <= nvar; ++i) {
+      pack.uniform_bounds_ = pack.uniform_bounds_ &&
+                             pack.bounds_h_(0, b, i) == pack.bounds_h_(0, 0, i) &&
+                             pack.bounds_h_(1, b, i) == pack.bounds_h_(1, 0, i);
+    }
+  }
+  if constexpr (stage_packs) {
+    pack_uploads_t::Get().Upload(pack.pack_, pack_h, pack.bounds_, pack.bounds_h_,
+                                 pack.coords_, coords_h);
+  }
 
   return pack;
 }
@@ -284,27 +389,26 @@ template SparsePackBase SparsePackBase::Build<MeshData<Real>>(MeshData<Real> *,
                                                               const PackDescriptor &,
                                                               const std::vector<bool> &);
 
+namespace {
+// the allocation epoch of the blocks in a pack
+std::uint64_t PackAllocationEpoch(MeshData<Real> *pmd,
+                                  const std::vector<bool> &include_block) {
+  return pmd->AllocationEpoch(include_block);
+}
+std::uint64_t PackAllocationEpoch(MeshBlockData<Real> *pmbd, const std::vector<bool> &) {
+  return pmbd->AllocationEpoch();
+}
+} // namespace
+
 template <class T>
 SparsePackBase &SparsePackCache::Get(T *pmd, const PackDescriptor &desc,
                                      const std::vector<bool> &include_block) {
-  if (pack_map.count(desc.identifier) > 0) {
-    auto &cache_tuple = pack_map[desc.identifier];
-    auto &pack = std::get<0>(cache_tuple);
-    auto alloc_status_in = SparsePackBase::GetAllocStatus(pmd, desc, include_block);
-    auto &alloc_status = std::get<1>(cache_tuple);
-    if (alloc_status.size() != alloc_status_in.size())
-      return BuildAndAdd(pmd, desc, include_block);
-    for (int i = 0; i < alloc_status_in.size(); ++i) {
-      if (alloc_status[i] != alloc_status_in[i])
-        return BuildAndAdd(pmd, desc, include_block);
-    }
-    auto &include_status = std::get<2>(cache_tuple);
-    if (include_status.size() != include_block.size())
+  auto it = pack_map.find(desc);
+  if (it != pack_map.end()) {
+    auto &cache_tuple = it->second;
+    if (std::get<1>(cache_tuple) != PackAllocationEpoch(pmd, include_block) ||
+        std::get<2>(cache_tuple) != include_block)
       return BuildAndAdd(pmd, desc, include_block);
-    for (int i = 0; i < include_block.size(); ++i) {
-      if (include_status[i] != include_block[i])
-        return BuildAndAdd(pmd, desc, include_block);
-    }
     // Cached version is not stale, so just return a reference to it
     return std::get<0>(cache_tuple);
   }
@@ -320,11 +424,10 @@ SparsePackCache::Get<MeshBlockData<Real>>(MeshBlockData<Real> *, const PackDescr
 template <class T>
 SparsePackBase &SparsePackCache::BuildAndAdd(T *pmd, const PackDescriptor &desc,
                                              const std::vector<bool> &include_block) {
-  if (pack_map.count(desc.identifier) > 0) pack_map.erase(desc.identifier);
-  pack_map[desc.identifier] = {SparsePackBase::Build(pmd, desc, include_block),
-                               SparsePackBase::GetAllocStatus(pmd, desc, include_block),
-                               include_block};
-  return std::get<0>(pack_map[desc.identifier]);
+  auto &entry = pack_map[desc];
+  entry = {SparsePackBase::Build(pmd, desc, include_block),
+           PackAllocationEpoch(pmd, include_block), include_block};
+  return std::get<0>(entry);
 }
 template SparsePackBase &
 SparsePackCache::BuildAndAdd<MeshData<Real>>(MeshData<Real> *, const PackDescriptor &,
@@ -14,6 +14,7 @@
 #define INTERFACE_SPARSE_PACK_BASE_HPP_
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <map>
@@ -30,12 +31,13 @@
 #include "interface/state_descriptor.hpp"
 #include "interface/variable.hpp"
 #include "interface/variable_state.hpp"
+#include "utils/hash.hpp"
 #include "utils/utils.hpp"
 
 namespace parthenon {
 class SparsePackCache;
 namespace impl {
-class PackDescriptor;
+struct PackDescriptor;
 }
 
 // Map for going from variable names to sparse pack variable indices
@@ -45,6 +47,32 @@ class StateDescriptor;
 
 enum class PDOpt { WithFluxes, Coarse, Flatten };
 
+// Packs are filled in pinned host memory and uploaded to the device on an execution
+// space instance of their own.  Outside of a PackUploadBatch, GetPack waits for the
+// upload of the pack it returns.  While a batch is alive, uploads are only waited on
+// when the outermost batch ends, so that filling a pack on the host overlaps with
+// uploading the packs built before it, e.g.
+//   {
+//     PackUploadBatch batch;
+//     for (auto &md : partitions) desc.GetPack(md.get());
+//   } // all packs are on the device here
+// Packs obtained inside a batch must not be used on the device before it ends.
+class PackUploadBatch {
+ public:
+  PackUploadBatch() { ++depth_; }
+  ~PackUploadBatch();
+  PackUploadBatch(const PackUploadBatch &) = delete;
+  PackUploadBatch &operator=(const PackUploadBatch &) = delete;
+
+  static bool Active() { return depth_ > 0; }
+  // whether packs built in a batch are still being uploaded, which is never the case
+  // if the device can read host memory
+  static bool UploadsPending();
+
+ private:
+  inline static int depth_ = 0;
+};
+
 class SparsePackBase {
  public:
   SparsePackBase() = default;
@@ -52,8 +80,9 @@ class SparsePackBase {
 
  protected:
   friend class SparsePackCache;
+  friend class PackUploadBatch;
 
-  using alloc_t = std::vector<int>;
+  using epoch_t = std::uint64_t;
   using include_t = std::vector<bool>;
   using pack_t = ParArray3D<ParArray3D<Real, VariableState>>;
   using bounds_t = ParArray3D<int>;
@@ -66,21 +95,21 @@ class SparsePackBase {
   static SparsePackBase GetPack(T *pmd, const impl::PackDescriptor &desc,
                                 const std::vector<bool> &include_block) {
     auto &cache = pmd->GetSparsePackCache();
-    return cache.Get(pmd, desc, include_block);
+    auto &pack = cache.Get(pmd, desc, include_block);
+    if (!PackUploadBatch::Active()) FenceUploads();
+    return pack;
   }
 
+  // Wait for all pack uploads that are in flight
+  static void FenceUploads();
+
   // Return a map from variable names to pack variable indices
   static SparsePackIdxMap GetIdxMap(const impl::PackDescriptor &desc);
 
-  // Get a list of booleans of the allocation status of every variable in pmd matching the
-  // PackDescriptor desc
-  template <class T>
-  static alloc_t GetAllocStatus(T *pmd, const impl::PackDescriptor &desc,
-                                const std::vector<bool> &include_block);
-
   // Actually build a `SparsePackBase` (i.e. create a view of views, fill on host, and
-  // deep copy the view of views to device) from the variables specified in desc contained
-  // from the blocks contained in pmd (which can either be MeshBlockData/MeshData).
+  // start copying the view of views to device) from the variables specified in desc
+  // contained from the blocks contained in pmd (which can either be
+  // MeshBlockData/MeshData).
   template <class T>
   static SparsePackBase Build(T *pmd, const impl::PackDescriptor &desc,
                               const std::vector<bool> &include_block);
@@ -93,37 +122,13 @@ class SparsePackBase {
   bool with_fluxes_;
   bool coarse_;
   bool flat_;
+  // whether every variable has the same bounds on all blocks, e.g., for dense variables
+  bool uniform_bounds_ = false;
   int nblocks_;
   int nvar_;
   int size_;
 };
 
-// Object for cacheing sparse packs in MeshData and MeshBlockData objects. This
-// handles checking for a pre-existing pack and creating a new SparsePackBase if
-// a cached pack is unavailable. Essentially, this operates as a map from
-// `PackDescriptor` to `SparsePackBase`
-class SparsePackCache {
- public:
-  std::size_t size() const { return pack_map.size(); }
-
-  void clear() { pack_map.clear(); }
-
- protected:
-  template <class T>
-  SparsePackBase &Get(T *pmd, const impl::PackDescriptor &desc,
-                      const std::vector<bool> &include_block);
-
-  template <class T>
-  SparsePackBase &BuildAndAdd(T *pmd, const impl::PackDescriptor &desc,
-                              const std::vector<bool> &include_block);
-
-  std::unordered_map<std::string, std::tuple<SparsePackBase, SparsePackBase::alloc_t,
-                                             SparsePackBase::include_t>>
-      pack_map;
-
-  friend class SparsePackBase;
-};
-
 namespace impl {
 struct PackDescriptor {
   using VariableGroup_t = std::vector<std::pair<VarID, Uid_t>>;
@@ -135,7 +140,7 @@ struct PackDescriptor {
   // default constructor needed for certain use cases
   PackDescriptor()
       : nvar_groups(0), var_group_names({}), var_groups({}), with_fluxes(false),
-        coarse(false), flat(false), identifier("") {}
+        coarse(false), flat(false), identifier(0) {}
 
   template <class GROUP_t, class SELECTOR_t>
   PackDescriptor(StateDescriptor *psd, const std::vector<GROUP_t> &var_groups_in,
@@ -155,20 +160,36 @@ struct PackDescriptor {
   const bool with_fluxes;
   const bool coarse;
   const bool flat;
-  const std::string identifier;
+  // Hash of the unique ids of all variables, in their groups, and of the options.  Used
+  // to hash the keys of the pack caches, so equal descriptors share their packs.
+  const std::uint64_t identifier;
+
+  // Descriptors are equal if they pack the same variables in the same groups with the
+  // same options, which is what the pack caches compare keys with after hashing them
+  bool operator==(const PackDescriptor &other) const {
+    if (identifier != other.identifier || with_fluxes != other.with_fluxes ||
+        coarse != other.coarse || flat != other.flat ||
+        var_groups.size() != other.var_groups.size())
+      return false;
+    for (std::size_t i = 0; i < var_groups.size(); ++i) {
+      if (var_groups[i].size() != other.var_groups[i].size()) return false;
+      for (std::size_t v = 0; v < var_groups[i].size(); ++v) {
+        if (var_groups[i][v].second != other.var_groups[i][v].second) return false;
+      }
+    }
+    return true;
+  }
 
  private:
-  std::string GetIdentifier() {
-    std::string ident("");
+  std::uint64_t GetIdentifier() {
+    std::size_t ident = 0;
     for (const auto &vgroup : var_groups) {
+      ident = hash_combine(ident, vgroup.size());
       for (const auto &[vid, uid] : vgroup) {
-        ident += std::to_string(uid) + "_";
+        ident = hash_combine(ident, uid);
       }
-      ident += "|";
     }
-    ident += std::to_string(with_fluxes);
-    ident += std::to_string(coarse);
-    ident += std::to_string(flat);
+    ident = hash_combine(ident, 4 * with_fluxes + 2 * coarse + flat);
     return ident;
   }
   template <class FUNC_t>
@@ -217,8 +238,43 @@ struct PackDescriptor {
     return std::vector<std::string>();
   }
 };
+
+struct PackDescriptorHash {
+  std::size_t operator()(const PackDescriptor &desc) const { return desc.identifier; }
+};
 } // namespace impl
 
+// Object for cacheing sparse packs in MeshData and MeshBlockData objects. This
+// handles checking for a pre-existing pack and creating a new SparsePackBase if
+// a cached pack is unavailable. Essentially, this operates as a map from
+// `PackDescriptor` to `SparsePackBase`
+class SparsePackCache {
+ public:
+  std::size_t size() const { return pack_map.size(); }
+
+  void clear() { pack_map.clear(); }
+
+ protected:
+  template <class T>
+  SparsePackBase &Get(T *pmd, const impl::PackDescriptor &desc,
+                      const std::vector<bool> &include_block);
+
+  template <class T>
+  SparsePackBase &BuildAndAdd(T *pmd, const impl::PackDescriptor &desc,
+                              const std::vector<bool> &include_block);
+
+  // A pack is stale once a variable of one of its blocks was allocated, deallocated or
+  // moved after it was built, see MeshData::AllocationEpoch.  Containers clear their
+  // cache when their set of blocks or variables changes.
+  std::unordered_map<impl::PackDescriptor,
+                     std::tuple<SparsePackBase, SparsePackBase::epoch_t,
+                                SparsePackBase::include_t>,
+                     impl::PackDescriptorHash>
+      pack_map;
+
+  friend class SparsePackBase;
+};
+
 } // namespace parthenon
 
 #endif // INTERFACE_SPARSE_PACK_BASE_HPP_
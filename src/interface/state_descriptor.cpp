@@ -272,6 +272,7 @@ bool StateDescriptor::AddFieldImpl(const VarID &vid, const Metadata &m_in,
     return false; // this field has already been added
   } else {
     metadataMap_.insert({vid, m});
+    packDescriptorCache_.clear();
     refinementFuncMaps_.Register(m, vid.label());
     allocControllerReverseMap_.insert({vid, control_vid});
     // Add this variable to the set of unique IDs at the
@@ -293,6 +294,7 @@ bool StateDescriptor::AddSparsePoolImpl(const SparsePool &pool) {
   }
 
   sparsePoolMap_.insert({pool.base_name(), pool});
+  packDescriptorCache_.clear();
   refinementFuncMaps_.Register(pool.shared_metadata(), pool.base_name());
 
   std::string controller_base = pool.controller_base_name();
@@ -16,9 +16,12 @@
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <tuple>
+#include <typeindex>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -140,6 +143,12 @@ class StateDescriptor {
     return params_.Get<T>(key);
   }
 
+  // see Params::Handle
+  template <typename T>
+  Params::Handle<T> ParamHandle(const std::string &key) const {
+    return params_.GetHandle<T>(key);
+  }
+
   template <typename T>
   T *MutableParam(const std::string &key) const {
     return params_.GetMutable<T>(key);
@@ -378,6 +387,15 @@ class StateDescriptor {
   void FillDerived(MeshData<Real> *rc) const {
     if (FillDerivedMesh != nullptr) FillDerivedMesh(rc);
   }
+  void FillDerivedOnDemand(MeshBlockData<Real> *rc) const {
+    if (FillDerivedOnDemandBlock != nullptr) FillDerivedOnDemandBlock(rc);
+  }
+  void FillDerivedOnDemand(MeshData<Real> *rc) const {
+    if (FillDerivedOnDemandMesh != nullptr) FillDerivedOnDemandMesh(rc);
+  }
+  bool HasFillDerivedOnDemand() const {
+    return FillDerivedOnDemandBlock != nullptr || FillDerivedOnDemandMesh != nullptr;
+  }
 
   void PreStepDiagnostics(SimTime const &simtime, MeshData<Real> *rc) const {
     if (PreStepDiagnosticsMesh != nullptr) PreStepDiagnosticsMesh(simtime, rc);
@@ -399,6 +417,10 @@ class StateDescriptor {
     if (CheckRefinementBlock != nullptr) return CheckRefinementBlock(rc);
     return AmrTag::derefine;
   }
+  // raises delta_levels(b), on device, to the tag of block b of rc
+  void CheckRefinement(MeshData<Real> *rc, ParArray1D<AmrTag> &delta_levels) const {
+    if (CheckRefinementMesh != nullptr) return CheckRefinementMesh(rc, delta_levels);
+  }
 
   void InitNewlyAllocatedVars(MeshData<Real> *rc) const {
     if (InitNewlyAllocatedVarsMesh != nullptr) return InitNewlyAllocatedVarsMesh(rc);
@@ -422,6 +444,10 @@ class StateDescriptor {
   std::function<void(MeshData<Real> *rc)> PostFillDerivedMesh = nullptr;
   std::function<void(MeshBlockData<Real> *rc)> FillDerivedBlock = nullptr;
   std::function<void(MeshData<Real> *rc)> FillDerivedMesh = nullptr;
+  // fill derived fields that only outputs (including histories) or some tasks need,
+  // called through Mesh::FillDerivedOnDemand before outputs rather than every stage
+  std::function<void(MeshBlockData<Real> *rc)> FillDerivedOnDemandBlock = nullptr;
+  std::function<void(MeshData<Real> *rc)> FillDerivedOnDemandMesh = nullptr;
   std::function<void(Mesh *, ParameterInput *, SimTime &)> UserWorkBeforeLoopMesh =
       nullptr;
 
@@ -434,11 +460,19 @@ class StateDescriptor {
   std::function<Real(MeshData<Real> *rc)> EstimateTimestepMesh = nullptr;
 
   std::function<AmrTag(MeshBlockData<Real> *rc)> CheckRefinementBlock = nullptr;
+  std::function<void(MeshData<Real> *rc, ParArray1D<AmrTag> &delta_levels)>
+      CheckRefinementMesh = nullptr;
 
   std::function<void(MeshData<Real> *rc)> InitNewlyAllocatedVarsMesh = nullptr;
   std::function<void(MeshBlockData<Real> *rc)> InitNewlyAllocatedVarsBlock = nullptr;
 
   friend std::ostream &operator<<(std::ostream &os, const StateDescriptor &sd);
+
+  // The pack descriptors built from variable types only depend on the types, flags and
+  // options, so they are memoized per StateDescriptor.  The cache is cleared whenever a
+  // field is added, since the new field may match the types.
+  using PackDescriptorKey = std::tuple<std::type_index, std::vector<MetadataFlag>, int>;
+  auto &PackDescriptorCache() { return packDescriptorCache_; }
   std::array<std::vector<BValFunc>, BOUNDARY_NFACES> UserBoundaryFunctions;
 
  protected:
@@ -460,6 +494,9 @@ class StateDescriptor {
   Dictionary<Dictionary<Metadata>> swarmValueMetadataMap_;
 
   RefinementFunctionMaps refinementFuncMaps_;
+
+  // type based pack descriptors that have already been built, see MakePackDescriptor
+  std::map<PackDescriptorKey, std::shared_ptr<void>> packDescriptorCache_;
 };
 
 inline std::shared_ptr<StateDescriptor> ResolvePackages(Packages_t &packages) {
@@ -71,11 +71,13 @@ Swarm::Swarm(const std::string &label, const Metadata &metadata, const int nmax_
       recv_neighbor_index_("recv_neighbor_index_", nmax_pool_),
       recv_buffer_index_("recv_buffer_index_", nmax_pool_),
       num_particles_to_send_("num_particles_to_send_", NMAX_NEIGHBORS),
-      cell_sorted_("cell_sorted_", nmax_pool_), mpiStatus(true) {
+      cell_sorted_("cell_sorted_", nmax_pool_), num_claimed_("num_claimed_"),
+      mpiStatus(true) {
   PARTHENON_REQUIRE_THROWS(typeid(Coordinates_t) == typeid(UniformCartesian),
                            "SwarmDeviceContext only supports a uniform Cartesian mesh!");
 
   uid_ = get_uid_(label_);
+  contiguous_ = m_.IsSet(Metadata::Contiguous);
 
   Add("x", Metadata({Metadata::Real}));
   Add("y", Metadata({Metadata::Real}));
@@ -91,7 +93,6 @@ Swarm::Swarm(const std::string &label, const Metadata &metadata, const int nmax_
   for (int n = 0; n < nmax_pool_; n++) {
     mask_h(n) = false;
     marked_for_removal_h(n) = false;
-    free_indices_.push_back(n);
   }
 
   Kokkos::deep_copy(mask_, mask_h);
@@ -158,6 +159,38 @@ void Swarm::Add(const std::vector<std::string> &label_array, const Metadata &met
   }
 }
 
+// Move all variables of type T into one block of (component, particle) rows with room
+// for nmax_pool particles, keeping the values of the particles that fit.  The data of
+// each variable becomes an unmanaged view of its rows.
+template <class T>
+void Swarm::Repack_(const int nmax_pool) {
+  auto &vars = std::get<getType<T>()>(vectors_);
+  int ncomp = 0;
+  for (const auto &v : vars) {
+    ncomp += v->NumComponents();
+  }
+  ParArray2D<T> block(label_ + "_block", ncomp, nmax_pool);
+  int offset = 0;
+  for (auto &v : vars) {
+    auto &d = v->data;
+    const int nc = v->NumComponents();
+    const int nold = d.GetDim(1);
+    const T *old_data = d.data();
+    T *new_data = block.data() + static_cast<std::size_t>(offset) * nmax_pool;
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, nc - 1, 0,
+        std::min(nold, nmax_pool) - 1, KOKKOS_LAMBDA(const int c, const int n) {
+          new_data[c * nmax_pool + n] = old_data[c * nold + n];
+        });
+    d = ParArrayND<T>(typename ParArrayND<T>::base_t(new_data, d.GetDim(6), d.GetDim(5),
+                                                     d.GetDim(4), d.GetDim(3),
+                                                     d.GetDim(2), nmax_pool));
+    offset += nc;
+  }
+  // the previous block is only freed here, after its data has been copied
+  std::get<getType<T>()>(blocks_) = block;
+}
+
 std::shared_ptr<Swarm> Swarm::AllocateCopy(MeshBlock * /*pmb*/) {
   Metadata m = m_;
 
@@ -185,8 +218,10 @@ void Swarm::Add(const std::string &label, const Metadata &metadata) {
 
   if (newm.Type() == Metadata::Integer) {
     Add_<int>(label, newm);
+    if (contiguous_) Repack_<int>(nmax_pool_);
   } else if (newm.Type() == Metadata::Real) {
     Add_<Real>(label, newm);
+    if (contiguous_) Repack_<Real>(nmax_pool_);
   } else {
     throw std::invalid_argument("swarm variable " + label +
                                 " does not have a valid type during Add()");
@@ -246,19 +281,19 @@ void Swarm::Remove(const std::string &label) {
   if (found == false) {
     throw std::invalid_argument("swarm variable not found in Remove()");
   }
+
+  if (contiguous_) {
+    Repack_<int>(nmax_pool_);
+    Repack_<Real>(nmax_pool_);
+  }
 }
 
 void Swarm::setPoolMax(const std::int64_t nmax_pool) {
   PARTHENON_REQUIRE(nmax_pool > nmax_pool_, "Must request larger pool size!");
-  std::int64_t n_new_begin = nmax_pool_;
   std::int64_t n_new = nmax_pool - nmax_pool_;
 
   auto pmb = GetBlockPointer();
 
-  for (std::int64_t n = 0; n < n_new; n++) {
-    free_indices_.push_back(n + n_new_begin);
-  }
-
   // Rely on Kokkos setting the newly added values to false for these arrays
   Kokkos::resize(mask_, nmax_pool);
   Kokkos::resize(marked_for_removal_, nmax_pool);
@@ -277,54 +312,79 @@ void Swarm::setPoolMax(const std::int64_t nmax_pool) {
   auto &int_vector = std::get<getType<int>()>(vectors_);
   auto &real_vector = std::get<getType<Real>()>(vectors_);
 
+  if (contiguous_) {
+    // one copy per data type rather than one per variable
+    Repack_<int>(nmax_pool);
+    Repack_<Real>(nmax_pool);
+  }
+
   for (auto &d : int_vector) {
-    d->data.Resize(d->data.GetDim(6), d->data.GetDim(5), d->data.GetDim(4),
-                   d->data.GetDim(3), d->data.GetDim(2), nmax_pool);
+    if (!contiguous_) {
+      d->data.Resize(d->data.GetDim(6), d->data.GetDim(5), d->data.GetDim(4),
+                     d->data.GetDim(3), d->data.GetDim(2), nmax_pool);
+    }
     pmb->LogMemUsage(n_new * sizeof(int));
   }
 
   for (auto &d : real_vector) {
-    d->data.Resize(d->data.GetDim(6), d->data.GetDim(5), d->data.GetDim(4),
-                   d->data.GetDim(3), d->data.GetDim(2), nmax_pool);
+    if (!contiguous_) {
+      d->data.Resize(d->data.GetDim(6), d->data.GetDim(5), d->data.GetDim(4),
+                     d->data.GetDim(3), d->data.GetDim(2), nmax_pool);
+    }
     pmb->LogMemUsage(n_new * sizeof(Real));
   }
 
   nmax_pool_ = nmax_pool;
 }
 
+void Swarm::ReservePool_(const int num_free) {
+  if (nmax_pool_ - num_active_ < num_free) {
+    // grow at least geometrically so that repeated additions are amortized
+    setPoolMax(std::max<std::int64_t>(2 * nmax_pool_, num_active_ + num_free));
+  }
+}
+
+// Fill new_indices_ with the num lowest free slots, which a scan over the mask ranks,
+// and return the largest of them
+int Swarm::FindFreeSlots_(const int num) {
+  auto pmb = GetBlockPointer();
+  auto &mask = mask_;
+  auto &new_indices = new_indices_;
+  pmb->par_scan(
+      PARTHENON_AUTO_LABEL, 0, nmax_pool_ - 1,
+      KOKKOS_LAMBDA(const int n, int &free_rank, const bool final) {
+        if (mask(n)) return;
+        if (final && free_rank < num) new_indices(free_rank) = n;
+        free_rank++;
+      });
+  int last_index;
+  Kokkos::deep_copy(last_index, Kokkos::subview(new_indices.KokkosView(), num - 1));
+  return last_index;
+}
+
 NewParticlesContext Swarm::AddEmptyParticles(const int num_to_add) {
   PARTHENON_DEBUG_REQUIRE(num_to_add >= 0, "Cannot add negative numbers of particles!");
+  PARTHENON_DEBUG_REQUIRE(num_reserved_ == 0,
+                          "Cannot add particles while free slots are reserved!");
 
   if (num_to_add > 0) {
-    while (free_indices_.size() < num_to_add) {
-      increasePoolMax();
-    }
-
-    // TODO(BRR) Use par_scan on device rather than do this on host
-    auto mask_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mask_);
-
-    auto block_index_h = block_index_.GetHostMirrorAndCopy();
-
-    auto free_index = free_indices_.begin();
-
-    auto new_indices_h = new_indices_.GetHostMirror();
-
+    ReservePool_(num_to_add);
+    const int last_new_index = FindFreeSlots_(num_to_add);
+
+    auto pmb = GetBlockPointer();
+    auto &mask = mask_;
+    auto &block_index = block_index_;
+    auto &new_indices = new_indices_;
+    const int this_block = this_block_;
     // Don't bother sanitizing the memory
-    for (int n = 0; n < num_to_add; n++) {
-      mask_h(*free_index) = true;
-      block_index_h(*free_index) = this_block_;
-      max_active_index_ = std::max<int>(max_active_index_, *free_index);
-      new_indices_h(n) = *free_index;
-
-      free_index = free_indices_.erase(free_index);
-    }
-
-    new_indices_.DeepCopy(new_indices_h);
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, 0, num_to_add - 1, KOKKOS_LAMBDA(const int n) {
+          mask(new_indices(n)) = true;
+          block_index(new_indices(n)) = this_block;
+        });
+    max_active_index_ = std::max<int>(max_active_index_, last_new_index);
 
     num_active_ += num_to_add;
-
-    Kokkos::deep_copy(mask_, mask_h);
-    block_index_.DeepCopy(block_index_h);
     new_indices_max_idx_ = num_to_add - 1;
   } else {
     new_indices_max_idx_ = -1;
@@ -333,106 +393,144 @@ NewParticlesContext Swarm::AddEmptyParticles(const int num_to_add) {
   return NewParticlesContext(new_indices_max_idx_, new_indices_);
 }
 
+ParticleCreator Swarm::ReserveParticles(const int max_to_add) {
+  PARTHENON_REQUIRE(max_to_add >= 0, "Cannot reserve negative numbers of particles!");
+  PARTHENON_REQUIRE(num_reserved_ == 0, "Free slots are already reserved!");
+  if (max_to_add > 0) {
+    ReservePool_(max_to_add);
+    FindFreeSlots_(max_to_add);
+  }
+  num_reserved_ = max_to_add;
+  Kokkos::deep_copy(num_claimed_.KokkosView(), 0);
+  return ParticleCreator(num_reserved_, new_indices_, num_claimed_, mask_, block_index_,
+                         this_block_);
+}
+
+int Swarm::CommitReservedParticles() {
+  int num_claimed;
+  Kokkos::deep_copy(num_claimed, num_claimed_.KokkosView());
+  const int num_created = std::min(num_claimed, num_reserved_);
+  num_reserved_ = 0;
+  if (num_created == 0) return 0;
+
+  // slots are claimed in increasing order, so the last one is the largest
+  int last_new_index;
+  Kokkos::deep_copy(last_new_index,
+                    Kokkos::subview(new_indices_.KokkosView(), num_created - 1));
+  max_active_index_ = std::max<int>(max_active_index_, last_new_index);
+  num_active_ += num_created;
+  return num_created;
+}
+
 // No active particles: nmax_active_index = -1
 // No particles removed: nmax_active_index unchanged
 // Particles removed: nmax_active_index is new max active index
 void Swarm::RemoveMarkedParticles() {
-  // TODO(BRR) Use par_scan to do this on device rather than host
-  auto mask_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mask_);
-  auto marked_for_removal_h =
-      Kokkos::create_mirror_view_and_copy(HostMemSpace(), marked_for_removal_);
-
-  // loop backwards to keep free_indices_ updated correctly
-  for (int n = max_active_index_; n >= 0; n--) {
-    if (mask_h(n)) {
-      if (marked_for_removal_h(n)) {
-        mask_h(n) = false;
-        free_indices_.push_front(n);
-        num_active_ -= 1;
-        if (n == max_active_index_) {
-          max_active_index_ -= 1;
-        }
-        marked_for_removal_h(n) = false;
-      }
-    }
-  }
+  auto pmb = GetBlockPointer();
+  auto &mask = mask_;
+  auto &marked_for_removal = marked_for_removal_;
 
-  Kokkos::deep_copy(mask_, mask_h);
-  Kokkos::deep_copy(marked_for_removal_, marked_for_removal_h);
+  int num_removed = 0;
+  pmb->par_reduce(
+      PARTHENON_AUTO_LABEL, 0, max_active_index_,
+      KOKKOS_LAMBDA(const int n, int &lnum) {
+        if (mask(n) && marked_for_removal(n)) {
+          mask(n) = false;
+          marked_for_removal(n) = false;
+          lnum++;
+        }
+      },
+      Kokkos::Sum<int>(num_removed));
+  if (num_removed == 0) return;
+  num_active_ -= num_removed;
+
+  int max_active_index = -1;
+  pmb->par_reduce(
+      PARTHENON_AUTO_LABEL, 0, max_active_index_,
+      KOKKOS_LAMBDA(const int n, int &lmax) {
+        if (mask(n)) lmax = Kokkos::max(lmax, n);
+      },
+      Kokkos::Max<int>(max_active_index));
+  max_active_index_ = max_active_index;
 }
 
 void Swarm::Defrag() {
   if (GetNumActive() == 0) {
     return;
   }
-  // TODO(BRR) Could this algorithm be more efficient? Does it matter?
-  // Add 1 to convert max index to max number
-  std::int64_t num_free = (max_active_index_ + 1) - num_active_;
-  auto pmb = GetBlockPointer();
-
-  auto from_to_indices_h = from_to_indices_.GetHostMirror();
-
-  auto mask_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mask_);
-
-  for (int n = 0; n <= max_active_index_; n++) {
-    from_to_indices_h(n) = unset_index_;
-  }
-
-  std::list<int> new_free_indices;
-
-  free_indices_.sort();
-
-  int index = max_active_index_;
-  int num_to_move = std::min<int>(num_free, num_active_);
-  for (int n = 0; n < num_to_move; n++) {
-    while (mask_h(index) == false) {
-      index--;
-    }
-    int index_to_move_from = index;
-    index--;
-
-    // Below this number "moved" particles should actually stay in place
-    if (index_to_move_from < num_active_) {
-      break;
-    }
-    int index_to_move_to = free_indices_.front();
-    free_indices_.pop_front();
-    new_free_indices.push_back(index_to_move_from);
-    from_to_indices_h(index_to_move_from) = index_to_move_to;
+  // After defragmenting, the active particles are at indices 0 to num_active_ - 1.  The
+  // particles above that move into the free slots below it, the last particle into the
+  // first free slot, the second to last into the second, and so on.  Both ranks are
+  // given by scans over the mask.
+  const int num_active = num_active_;
+  const int num_to_move = num_active_ - CountActive_(0, num_active_ - 1);
+  if (num_to_move == 0) {
+    max_active_index_ = num_active_ - 1;
+    return;
   }
-
-  // TODO(BRR) Not all these sorts may be necessary
-  new_free_indices.sort();
-  free_indices_.merge(new_free_indices);
-
-  from_to_indices_.DeepCopy(from_to_indices_h);
-
+  auto pmb = GetBlockPointer();
+  auto &mask = mask_;
   auto from_to_indices = from_to_indices_;
+  const int unset_index = unset_index_;
+  ParArray1D<int> free_slots("free_slots", num_to_move);
+
+  pmb->par_scan(
+      PARTHENON_AUTO_LABEL, 0, num_active - 1,
+      KOKKOS_LAMBDA(const int n, int &free_rank, const bool final) {
+        if (mask(n)) return;
+        if (final) free_slots(free_rank) = n;
+        free_rank++;
+      });
+  pmb->par_scan(
+      PARTHENON_AUTO_LABEL, num_active, max_active_index_,
+      KOKKOS_LAMBDA(const int n, int &move_rank, const bool final) {
+        if (final) {
+          from_to_indices(n) =
+              mask(n) ? free_slots(num_to_move - 1 - move_rank) : unset_index;
+        }
+        if (mask(n)) move_rank++;
+      });
 
-  auto &mask = mask_;
   pmb->par_for(
-      PARTHENON_AUTO_LABEL, 0, max_active_index_, KOKKOS_LAMBDA(const int n) {
+      PARTHENON_AUTO_LABEL, num_active, max_active_index_, KOKKOS_LAMBDA(const int n) {
         if (from_to_indices(n) >= 0) {
           mask(from_to_indices(n)) = mask(n);
           mask(n) = false;
         }
       });
 
-  auto &int_vector = std::get<getType<int>()>(vectors_);
-  auto &real_vector = std::get<getType<Real>()>(vectors_);
+  if (contiguous_) {
+    // Each row of the blocks holds one component for all particles, so every moved
+    // value is read from and written to contiguous memory
+    auto real_block = std::get<getType<Real>()>(blocks_);
+    auto int_block = std::get<getType<int>()>(blocks_);
+    const int nreal = real_block.extent(0);
+    const int nint = int_block.extent(0);
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, 0, nreal - 1, num_active, max_active_index_,
+        KOKKOS_LAMBDA(const int c, const int n) {
+          const int to = from_to_indices(n);
+          if (to >= 0) real_block(c, to) = real_block(c, n);
+        });
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, 0, nint - 1, num_active, max_active_index_,
+        KOKKOS_LAMBDA(const int c, const int n) {
+          const int to = from_to_indices(n);
+          if (to >= 0) int_block(c, to) = int_block(c, n);
+        });
+    max_active_index_ = num_active_ - 1;
+    return;
+  }
+
   PackIndexMap real_imap;
   PackIndexMap int_imap;
   auto vreal = PackAllVariables_<Real>(real_imap);
   auto vint = PackAllVariables_<int>(int_imap);
-  int real_vars_size = real_vector.size();
-  int int_vars_size = int_vector.size();
-  auto real_map = real_imap.Map();
-  auto int_map = int_imap.Map();
   const int realPackDim = vreal.GetDim(2);
   const int intPackDim = vint.GetDim(2);
 
   pmb->par_for(
-      PARTHENON_AUTO_LABEL, 0, max_active_index_, KOKKOS_LAMBDA(const int n) {
+      PARTHENON_AUTO_LABEL, num_active, max_active_index_, KOKKOS_LAMBDA(const int n) {
         if (from_to_indices(n) >= 0) {
           for (int vidx = 0; vidx < realPackDim; vidx++) {
             vreal(vidx, from_to_indices(n)) = vreal(vidx, n);
@@ -447,6 +545,17 @@ void Swarm::Defrag() {
   max_active_index_ = num_active_ - 1;
 }
 
+// number of active particles at indices begin to end
+int Swarm::CountActive_(const int begin, const int end) const {
+  auto pmb = GetBlockPointer();
+  auto &mask = mask_;
+  int num = 0;
+  pmb->par_reduce(
+      PARTHENON_AUTO_LABEL, begin, end,
+      KOKKOS_LAMBDA(const int n, int &lnum) { lnum += mask(n); }, Kokkos::Sum<int>(num));
+  return num;
+}
+
 ///
 /// Routine to sort particles by cell. Updates internal swarm variables:
 ///  cell_sorted_: 1D Per-cell sorted array of swarm memory indices
@@ -468,7 +577,6 @@ void Swarm::SortParticlesByCell() {
 
   auto cell_sorted = cell_sorted_;
   int ncells = pmb->cellbounds.GetTotal(IndexDomain::entire);
-  int num_active = num_active_;
   int max_active_index = max_active_index_;
 
   // Allocate data if necessary
@@ -489,7 +597,18 @@ void Swarm::SortParticlesByCell() {
         cell_sorted(n) = SwarmKey(static_cast<int>(cell_idx_1d), n);
       });
 
-  sort(cell_sorted, SwarmKeyComparator(), 0, max_active_index);
+  // Particles outside of the block (which don't belong to any cell) are sorted to the
+  // end.  The counting sort also yields the number of particles in each cell and where
+  // they end in the sorted list.
+  Kokkos::View<int *, DevMemSpace> counts("cell_sorted counts", ncells + 1);
+  Kokkos::View<int *, DevMemSpace> ends("cell_sorted ends", ncells + 1);
+  counting_sort(
+      cell_sorted,
+      KOKKOS_LAMBDA(const SwarmKey &key) {
+        return (key.cell_idx_1d_ >= 0 && key.cell_idx_1d_ < ncells) ? key.cell_idx_1d_
+                                                                    : ncells;
+      },
+      ncells + 1, 0, max_active_index, counts, ends);
 
   // Update per-cell arrays for easier accessing later
   const IndexRange &ib = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
@@ -498,360 +617,332 @@ void Swarm::SortParticlesByCell() {
   pmb->par_for(
       PARTHENON_AUTO_LABEL, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int k, const int j, const int i) {
-        int cell_idx_1d = i + nx1 * (j + nx2 * k);
-        // Find starting index, first by guessing
-        int start_index =
-            static_cast<int>((cell_idx_1d * static_cast<Real>(num_active) / ncells));
-        int n = 0;
-        while (true) {
-          n++;
-          // Check if we left the list
-          if (start_index < 0 || start_index > max_active_index) {
-            start_index = -1;
-            break;
-          }
-
-          if (cell_sorted(start_index).cell_idx_1d_ == cell_idx_1d) {
-            if (start_index == 0) {
-              break;
-            } else if (cell_sorted(start_index - 1).cell_idx_1d_ != cell_idx_1d) {
-              break;
-            } else {
-              start_index--;
-              continue;
-            }
-          }
-          if (cell_sorted(start_index).cell_idx_1d_ >= cell_idx_1d) {
-            start_index--;
-            if (start_index < 0) {
-              start_index = -1;
-              break;
-            }
-            if (cell_sorted(start_index).cell_idx_1d_ < cell_idx_1d) {
-              start_index = -1;
-              break;
-            }
-            continue;
-          }
-          if (cell_sorted(start_index).cell_idx_1d_ < cell_idx_1d) {
-            start_index++;
-            if (start_index > max_active_index) {
-              start_index = -1;
-              break;
-            }
-            if (cell_sorted(start_index).cell_idx_1d_ > cell_idx_1d) {
-              start_index = -1;
-              break;
-            }
-            continue;
-          }
-        }
-        cell_sorted_begin(k, j, i) = start_index;
-        if (start_index == -1) {
-          cell_sorted_number(k, j, i) = 0;
-        } else {
-          int number = 0;
-          int current_index = start_index;
-          while (current_index <= max_active_index &&
-                 cell_sorted(current_index).cell_idx_1d_ == cell_idx_1d) {
-            current_index++;
-            number++;
-            cell_sorted_number(k, j, i) = number;
-          }
-        }
+        const int cell_idx_1d = i + nx1 * (j + nx2 * k);
+        const int number = counts(cell_idx_1d);
+        cell_sorted_number(k, j, i) = number;
+        cell_sorted_begin(k, j, i) = (number > 0) ? ends(cell_idx_1d) - number : -1;
       });
 }
 
-///
-/// Routine for precomputing neighbor indices to efficiently compute particle
-/// position in terms of neighbor blocks based on spatial position. See
-/// GetNeighborBlockIndex()
-///
-void Swarm::SetNeighborIndices1D_() {
-  auto pmb = GetBlockPointer();
-  const int ndim = pmb->pmy_mesh->ndim;
-  auto neighbor_indices_h = neighbor_indices_.GetHostMirror();
-
-  // Initialize array in event of zero neighbors
-  for (int k = 0; k < 4; k++) {
-    for (int j = 0; j < 4; j++) {
-      for (int i = 0; i < 4; i++) {
-        neighbor_indices_h(k, j, i) = no_block_;
-      }
-    }
+namespace {
+// The state of one swarm in the batched operations below, each of which handles every
+// swarm with one team of a single launch
+struct RemoveSegment {
+  ParArray1D<bool> mask;
+  ParArray1D<bool> marked_for_removal;
+  int max_active_index;
+};
+
+struct DefragSegment {
+  ParArray1D<bool> mask;
+  ParArray1D<int> from_to_indices;
+  ParArray1D<int> free_slots;
+  SwarmVariablePack<Real> vreal;
+  SwarmVariablePack<int> vint;
+  int num_active;
+  int max_active_index;
+};
+
+struct SortSegment {
+  ParArrayND<Real> x, y, z;
+  SwarmDeviceContext swarm_d;
+  ParArray1D<SwarmKey> cell_sorted;
+  ParArrayND<int> cell_sorted_begin;
+  ParArrayND<int> cell_sorted_number;
+  int nx1, nx2, ncells;
+  int max_active_index;
+  int offset; // of the keys of this swarm in the list they are sorted into
+
+  KOKKOS_INLINE_FUNCTION
+  int &Begin(const int cell_idx_1d) const {
+    return cell_sorted_begin(cell_idx_1d / (nx1 * nx2), (cell_idx_1d / nx1) % nx2,
+                             cell_idx_1d % nx1);
   }
-
-  // Indicate which neighbor regions correspond to this meshblock
-  const int kmin = 0;
-  const int kmax = 4;
-  const int jmin = 0;
-  const int jmax = 4;
-  const int imin = 1;
-  const int imax = 3;
-  for (int k = kmin; k < kmax; k++) {
-    for (int j = jmin; j < jmax; j++) {
-      for (int i = imin; i < imax; i++) {
-        neighbor_indices_h(k, j, i) = this_block_;
-      }
-    }
+  KOKKOS_INLINE_FUNCTION
+  int &Number(const int cell_idx_1d) const {
+    return cell_sorted_number(cell_idx_1d / (nx1 * nx2), (cell_idx_1d / nx1) % nx2,
+                              cell_idx_1d % nx1);
   }
-
-  auto mesh_bcs = pmb->pmy_mesh->mesh_bcs;
-  // Indicate which neighbor regions correspond to each neighbor meshblock
-  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
-    NeighborBlock &nb = pmb->pbval->neighbor[n];
-
-    const int i = nb.ni.ox1;
-
-    if (i == -1) {
-      neighbor_indices_h(0, 0, 0) = n;
-    } else if (i == 0) {
-      neighbor_indices_h(0, 0, 1) = n;
-      neighbor_indices_h(0, 0, 2) = n;
-    } else {
-      neighbor_indices_h(0, 0, 3) = n;
-    }
+};
+} // namespace
+
+void Swarm::RemoveMarkedParticles(const std::vector<Swarm *> &swarms) {
+  const int nswarms = swarms.size();
+  if (nswarms == 0) return;
+  ParArray1D<RemoveSegment> segments("RemoveMarkedParticles segments", nswarms);
+  auto segments_h = Kokkos::create_mirror_view(segments);
+  for (int b = 0; b < nswarms; b++) {
+    Swarm *s = swarms[b];
+    segments_h(b) = RemoveSegment{s->mask_, s->marked_for_removal_, s->max_active_index_};
   }
+  Kokkos::deep_copy(segments, segments_h);
+
+  // number of removed particles and new max active index of each swarm
+  ParArray2D<int> removed("RemoveMarkedParticles removed", nswarms, 2);
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, Kokkos::TeamPolicy<>(DevExecSpace(), nswarms, Kokkos::AUTO),
+      KOKKOS_LAMBDA(team_mbr_t team_member) {
+        const int b = team_member.league_rank();
+        const auto &seg = segments(b);
+        const int n = seg.max_active_index + 1;
+        int max_active_index = -1;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange<>(team_member, n),
+            [&](const int m, int &lmax) {
+              if (seg.mask(m) && !seg.marked_for_removal(m)) lmax = Kokkos::max(lmax, m);
+            },
+            Kokkos::Max<int, DevMemSpace>(max_active_index));
+        int num_removed = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange<>(team_member, n),
+            [&](const int m, int &lnum) {
+              if (seg.mask(m) && seg.marked_for_removal(m)) {
+                seg.mask(m) = false;
+                seg.marked_for_removal(m) = false;
+                lnum++;
+              }
+            },
+            Kokkos::Sum<int, DevMemSpace>(num_removed));
+        Kokkos::single(Kokkos::PerTeam(team_member), [&]() {
+          removed(b, 0) = num_removed;
+          removed(b, 1) = max_active_index;
+        });
+      });
 
-  neighbor_indices_.DeepCopy(neighbor_indices_h);
+  auto removed_h = removed.GetHostMirrorAndCopy();
+  for (int b = 0; b < nswarms; b++) {
+    // as in RemoveMarkedParticles(), the max active index only changes with removals
+    if (removed_h(b, 0) == 0) continue;
+    swarms[b]->num_active_ -= removed_h(b, 0);
+    swarms[b]->max_active_index_ = removed_h(b, 1);
+  }
 }
 
-void Swarm::SetNeighborIndices2D_() {
-  auto pmb = GetBlockPointer();
-  const int ndim = pmb->pmy_mesh->ndim;
-  auto neighbor_indices_h = neighbor_indices_.GetHostMirror();
-
-  // Initialize array in event of zero neighbors
-  for (int k = 0; k < 4; k++) {
-    for (int j = 0; j < 4; j++) {
-      for (int i = 0; i < 4; i++) {
-        neighbor_indices_h(k, j, i) = no_block_;
-      }
-    }
+void Swarm::Defrag(const std::vector<Swarm *> &swarms) {
+  std::vector<Swarm *> active;
+  for (Swarm *s : swarms) {
+    if (s->GetNumActive() > 0) active.push_back(s);
   }
-
-  // Indicate which neighbor regions correspond to this meshblock
-  const int kmin = 0;
-  const int kmax = 4;
-  const int jmin = 1;
-  const int jmax = 3;
-  const int imin = 1;
-  const int imax = 3;
-  for (int k = kmin; k < kmax; k++) {
-    for (int j = jmin; j < jmax; j++) {
-      for (int i = imin; i < imax; i++) {
-        neighbor_indices_h(k, j, i) = this_block_;
-      }
-    }
+  const int nswarms = active.size();
+  if (nswarms == 0) return;
+  ParArray1D<DefragSegment> segments("Defrag segments", nswarms);
+  auto segments_h = Kokkos::create_mirror_view(segments);
+  for (int b = 0; b < nswarms; b++) {
+    Swarm *s = active[b];
+    PARTHENON_DEBUG_REQUIRE(s->num_reserved_ == 0,
+                            "Cannot defragment while free slots are reserved!");
+    PackIndexMap real_imap;
+    PackIndexMap int_imap;
+    // The new particle indices don't survive moving the particles anyway, so their
+    // array holds the free slots
+    segments_h(b) = DefragSegment{s->mask_,
+                                  s->from_to_indices_,
+                                  s->new_indices_,
+                                  s->PackAllVariables_<Real>(real_imap),
+                                  s->PackAllVariables_<int>(int_imap),
+                                  s->num_active_,
+                                  s->max_active_index_};
   }
+  Kokkos::deep_copy(segments, segments_h);
+
+  // Same algorithm as Defrag(), see there
+  const int unset_index = unset_index_;
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, Kokkos::TeamPolicy<>(DevExecSpace(), nswarms, Kokkos::AUTO),
+      KOKKOS_LAMBDA(team_mbr_t team_member) {
+        const int b = team_member.league_rank();
+        const auto &seg = segments(b);
+        const int num_active = seg.num_active;
+        const int n = seg.max_active_index + 1;
+        int num_to_move = 0;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange<>(team_member, num_active),
+            [&](const int m, int &lnum) { lnum += !seg.mask(m); },
+            Kokkos::Sum<int, DevMemSpace>(num_to_move));
+        if (num_to_move == 0) return;
+
+        Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member, num_active),
+                              [&](const int m, int &free_rank, const bool final) {
+                                if (seg.mask(m)) return;
+                                if (final) seg.free_slots(free_rank) = m;
+                                free_rank++;
+                              });
+        team_member.team_barrier();
+        Kokkos::parallel_scan(
+            Kokkos::TeamThreadRange<>(team_member, num_active, n),
+            [&](const int m, int &move_rank, const bool final) {
+              if (final) {
+                seg.from_to_indices(m) =
+                    seg.mask(m) ? seg.free_slots(num_to_move - 1 - move_rank)
+                                : unset_index;
+              }
+              if (seg.mask(m)) move_rank++;
+            });
+        team_member.team_barrier();
+
+        const int nreal = seg.vreal.GetDim(2);
+        const int nint = seg.vint.GetDim(2);
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, num_active, n),
+                             [&](const int m) {
+                               const int to = seg.from_to_indices(m);
+                               if (to < 0) return;
+                               seg.mask(to) = true;
+                               seg.mask(m) = false;
+                               for (int vidx = 0; vidx < nreal; vidx++) {
+                                 seg.vreal(vidx, to) = seg.vreal(vidx, m);
+                               }
+                               for (int vidx = 0; vidx < nint; vidx++) {
+                                 seg.vint(vidx, to) = seg.vint(vidx, m);
+                               }
+                             });
+      });
 
-  // Indicate which neighbor regions correspond to each neighbor meshblock
-  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
-    NeighborBlock &nb = pmb->pbval->neighbor[n];
+  for (Swarm *s : active) {
+    s->max_active_index_ = s->num_active_ - 1;
+  }
+}
 
-    const int i = nb.ni.ox1;
-    const int j = nb.ni.ox2;
-
-    if (i == -1) {
-      if (j == -1) {
-        neighbor_indices_h(0, 0, 0) = n;
-      } else if (j == 0) {
-        neighbor_indices_h(0, 1, 0) = n;
-        neighbor_indices_h(0, 2, 0) = n;
-      } else if (j == 1) {
-        neighbor_indices_h(0, 3, 0) = n;
-      }
-    } else if (i == 0) {
-      if (j == -1) {
-        neighbor_indices_h(0, 0, 1) = n;
-        neighbor_indices_h(0, 0, 2) = n;
-      } else if (j == 1) {
-        neighbor_indices_h(0, 3, 1) = n;
-        neighbor_indices_h(0, 3, 2) = n;
-      }
-    } else if (i == 1) {
-      if (j == -1) {
-        neighbor_indices_h(0, 0, 3) = n;
-      } else if (j == 0) {
-        neighbor_indices_h(0, 1, 3) = n;
-        neighbor_indices_h(0, 2, 3) = n;
-      } else if (j == 1) {
-        neighbor_indices_h(0, 3, 3) = n;
-      }
+void Swarm::SortParticlesByCell(const std::vector<Swarm *> &swarms) {
+  const int nswarms = swarms.size();
+  if (nswarms == 0) return;
+  ParArray1D<SortSegment> segments("SortParticlesByCell segments", nswarms);
+  auto segments_h = Kokkos::create_mirror_view(segments);
+  int nkeys = 0;
+  for (int b = 0; b < nswarms; b++) {
+    Swarm *s = swarms[b];
+    auto pmb = s->GetBlockPointer();
+    const int nx1 = pmb->cellbounds.ncellsi(IndexDomain::entire);
+    const int nx2 = pmb->cellbounds.ncellsj(IndexDomain::entire);
+    const int nx3 = pmb->cellbounds.ncellsk(IndexDomain::entire);
+    PARTHENON_REQUIRE(nx1 * nx2 * nx3 < std::numeric_limits<int>::max(),
+                      "Too many cells for an int32 to store cell_idx_1d below!");
+    if (s->cell_sorted_begin_.GetDim(1) == 0) {
+      s->cell_sorted_begin_ = ParArrayND<int>("cell_sorted_begin_", nx3, nx2, nx1);
+      s->cell_sorted_number_ = ParArrayND<int>("cell_sorted_number_", nx3, nx2, nx1);
     }
+    segments_h(b) = SortSegment{s->Get<Real>("x").Get(),
+                                s->Get<Real>("y").Get(),
+                                s->Get<Real>("z").Get(),
+                                s->GetDeviceContext(),
+                                s->cell_sorted_,
+                                s->cell_sorted_begin_,
+                                s->cell_sorted_number_,
+                                nx1,
+                                nx2,
+                                nx1 * nx2 * nx3,
+                                s->max_active_index_,
+                                nkeys};
+    nkeys += s->max_active_index_ + 1;
   }
+  Kokkos::deep_copy(segments, segments_h);
+
+  // A counting sort of each swarm as in SortParticlesByCell(), with the per-cell arrays
+  // holding the counts and offsets.  Particles outside of the block are sorted to the
+  // end, counted by num_outside.
+  ParArray1D<SwarmKey> sorted("SortParticlesByCell sorted", std::max(1, nkeys));
+  ParArray1D<int> num_outside("SortParticlesByCell num_outside", nswarms);
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, Kokkos::TeamPolicy<>(DevExecSpace(), nswarms, Kokkos::AUTO),
+      KOKKOS_LAMBDA(team_mbr_t team_member) {
+        const int b = team_member.league_rank();
+        const auto &seg = segments(b);
+        const int ncells = seg.ncells;
+        const int n = seg.max_active_index + 1;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, ncells),
+                             [&](const int c) { seg.Number(c) = 0; });
+        team_member.team_barrier();
+
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, n), [&](const int m) {
+          int i, j, k;
+          seg.swarm_d.Xtoijk(seg.x(m), seg.y(m), seg.z(m), i, j, k);
+          const int64_t cell_idx_1d = i + seg.nx1 * (j + seg.nx2 * k);
+          seg.cell_sorted(m) = SwarmKey(static_cast<int>(cell_idx_1d), m);
+          if (cell_idx_1d >= 0 && cell_idx_1d < ncells) {
+            Kokkos::atomic_increment(&seg.Number(cell_idx_1d));
+          }
+        });
+        team_member.team_barrier();
+
+        Kokkos::parallel_scan(Kokkos::TeamThreadRange<>(team_member, ncells),
+                              [&](const int c, int &sum, const bool final) {
+                                if (final) seg.Begin(c) = sum;
+                                sum += seg.Number(c);
+                              });
+        team_member.team_barrier();
+
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, n), [&](const int m) {
+          const SwarmKey key = seg.cell_sorted(m);
+          const int c = key.cell_idx_1d_;
+          const int to = (c >= 0 && c < ncells)
+                             ? Kokkos::atomic_fetch_add(&seg.Begin(c), 1)
+                             : n - 1 - Kokkos::atomic_fetch_add(&num_outside(b), 1);
+          sorted(seg.offset + to) = key;
+        });
+        team_member.team_barrier();
 
-  neighbor_indices_.DeepCopy(neighbor_indices_h);
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, n), [&](const int m) {
+          seg.cell_sorted(m) = sorted(seg.offset + m);
+        });
+        // the offsets now point one past the last particle of each cell
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, ncells),
+                             [&](const int c) {
+                               const int number = seg.Number(c);
+                               seg.Begin(c) = (number > 0) ? seg.Begin(c) - number : -1;
+                             });
+      });
 }
 
-void Swarm::SetNeighborIndices3D_() {
-  auto pmb = GetBlockPointer();
+///
+/// Routine for precomputing neighbor indices to efficiently compute particle
+/// position in terms of neighbor blocks based on spatial position. See
+/// GetNeighborBlockIndex()
+///
+ParArrayND<int> Swarm::BuildNeighborIndices(MeshBlock *pmb) {
   const int ndim = pmb->pmy_mesh->ndim;
-  auto neighbor_indices_h = neighbor_indices_.GetHostMirror();
-
-  // Initialize array in event of zero neighbors
-  for (int k = 0; k < 4; k++) {
-    for (int j = 0; j < 4; j++) {
-      for (int i = 0; i < 4; i++) {
-        neighbor_indices_h(k, j, i) = no_block_;
-      }
-    }
-  }
-
-  // Indicate which neighbor regions correspond to this meshblock
-  const int kmin = 1;
-  const int kmax = 3;
-  const int jmin = 1;
-  const int jmax = 3;
-  const int imin = 1;
-  const int imax = 3;
-  for (int k = kmin; k < kmax; k++) {
-    for (int j = jmin; j < jmax; j++) {
-      for (int i = imin; i < imax; i++) {
-        neighbor_indices_h(k, j, i) = this_block_;
-      }
-    }
+  PARTHENON_REQUIRE(ndim >= 1 && ndim <= 3, "ndim must be 1, 2, or 3 for particles!");
+  const int nneighbor = pmb->pbval->nneighbor;
+  ParArrayND<int> offsets("neighbor offsets", std::max(1, 3 * nneighbor));
+  auto offsets_h = offsets.GetHostMirror();
+  for (int n = 0; n < nneighbor; n++) {
+    const NeighborBlock &nb = pmb->pbval->neighbor[n];
+    offsets_h(3 * n) = nb.ni.ox1;
+    offsets_h(3 * n + 1) = nb.ni.ox2;
+    offsets_h(3 * n + 2) = nb.ni.ox3;
   }
-
-  // Indicate which neighbor regions correspond to each neighbor meshblock
-  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
-    NeighborBlock &nb = pmb->pbval->neighbor[n];
-
-    const int i = nb.ni.ox1;
-    const int j = nb.ni.ox2;
-    const int k = nb.ni.ox3;
-
-    if (i == -1) {
-      if (j == -1) {
-        if (k == -1) {
-          neighbor_indices_h(0, 0, 0) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 0, 0) = n;
-          neighbor_indices_h(2, 0, 0) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 0, 0) = n;
-        }
-      } else if (j == 0) {
-        if (k == -1) {
-          neighbor_indices_h(0, 1, 0) = n;
-          neighbor_indices_h(0, 2, 0) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 1, 0) = n;
-          neighbor_indices_h(1, 2, 0) = n;
-          neighbor_indices_h(2, 1, 0) = n;
-          neighbor_indices_h(2, 2, 0) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 1, 0) = n;
-          neighbor_indices_h(3, 2, 0) = n;
-        }
-      } else if (j == 1) {
-        if (k == -1) {
-          neighbor_indices_h(0, 3, 0) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 3, 0) = n;
-          neighbor_indices_h(2, 3, 0) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 3, 0) = n;
-        }
-      }
-    } else if (i == 0) {
-      if (j == -1) {
-        if (k == -1) {
-          neighbor_indices_h(0, 0, 1) = n;
-          neighbor_indices_h(0, 0, 2) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 0, 1) = n;
-          neighbor_indices_h(1, 0, 2) = n;
-          neighbor_indices_h(2, 0, 1) = n;
-          neighbor_indices_h(2, 0, 2) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 0, 1) = n;
-          neighbor_indices_h(3, 0, 2) = n;
-        }
-      } else if (j == 0) {
-        if (k == -1) {
-          neighbor_indices_h(0, 1, 1) = n;
-          neighbor_indices_h(0, 1, 2) = n;
-          neighbor_indices_h(0, 2, 1) = n;
-          neighbor_indices_h(0, 2, 2) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 1, 1) = n;
-          neighbor_indices_h(3, 1, 2) = n;
-          neighbor_indices_h(3, 2, 1) = n;
-          neighbor_indices_h(3, 2, 2) = n;
-        }
-      } else if (j == 1) {
-        if (k == -1) {
-          neighbor_indices_h(0, 3, 1) = n;
-          neighbor_indices_h(0, 3, 2) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 3, 1) = n;
-          neighbor_indices_h(1, 3, 2) = n;
-          neighbor_indices_h(2, 3, 1) = n;
-          neighbor_indices_h(2, 3, 2) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 3, 1) = n;
-          neighbor_indices_h(3, 3, 2) = n;
-        }
-      }
-    } else if (i == 1) {
-      if (j == -1) {
-        if (k == -1) {
-          neighbor_indices_h(0, 0, 3) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 0, 3) = n;
-          neighbor_indices_h(2, 0, 3) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 0, 3) = n;
-        }
-      } else if (j == 0) {
-        if (k == -1) {
-          neighbor_indices_h(0, 1, 3) = n;
-          neighbor_indices_h(0, 2, 3) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 1, 3) = n;
-          neighbor_indices_h(1, 2, 3) = n;
-          neighbor_indices_h(2, 1, 3) = n;
-          neighbor_indices_h(2, 2, 3) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 1, 3) = n;
-          neighbor_indices_h(3, 2, 3) = n;
-        }
-      } else if (j == 1) {
-        if (k == -1) {
-          neighbor_indices_h(0, 3, 3) = n;
-        } else if (k == 0) {
-          neighbor_indices_h(1, 3, 3) = n;
-          neighbor_indices_h(2, 3, 3) = n;
-        } else if (k == 1) {
-          neighbor_indices_h(3, 3, 3) = n;
+  offsets.DeepCopy(offsets_h);
+
+  // Regions 1 and 2 of a direction are in this block and regions 0 and 3 in the
+  // neighbors below and above it.  In the directions the mesh doesn't have, all regions
+  // are treated as 1, but only region 0 is read.  Regions without a neighbor are
+  // no_block_, and where several (finer) neighbors share an offset the last one wins.
+  ParArrayND<int> neighbor_indices("neighbor_indices_", 4, 4, 4);
+  const int no_block = no_block_;
+  const int this_block = this_block_;
+  pmb->par_for(
+      PARTHENON_AUTO_LABEL, 0, 3, 0, 3, 0, 3,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        const int ox1 = (i == 0) ? -1 : (i == 3);
+        const int ox2 = (ndim < 2 || j == 1 || j == 2) ? 0 : (j == 0 ? -1 : 1);
+        const int ox3 = (ndim < 3 || k == 1 || k == 2) ? 0 : (k == 0 ? -1 : 1);
+        const bool own = (ox1 == 0 && ox2 == 0 && ox3 == 0);
+        int index = own ? this_block : no_block;
+        for (int n = 0; n < nneighbor && !own; n++) {
+          if (offsets(3 * n) == ox1 && offsets(3 * n + 1) == ox2 &&
+              offsets(3 * n + 2) == ox3) {
+            index = n;
+          }
         }
-      }
-    }
-  }
-
-  neighbor_indices_.DeepCopy(neighbor_indices_h);
+        neighbor_indices(k, j, i) = index;
+      });
+  return neighbor_indices;
 }
 
 void Swarm::SetupPersistentMPI() {
   auto pmb = GetBlockPointer();
   vbswarm->SetupPersistentMPI();
 
-  const int ndim = pmb->pmy_mesh->ndim;
-
   const int nbmax = vbswarm->bd_var_.nbmax;
 
-  // Build up convenience array of neighbor indices
-  if (ndim == 1) {
-    SetNeighborIndices1D_();
-  } else if (ndim == 2) {
-    SetNeighborIndices2D_();
-  } else if (ndim == 3) {
-    SetNeighborIndices3D_();
-  } else {
-    PARTHENON_FAIL("ndim must be 1, 2, or 3 for particles!");
-  }
-
   neighbor_received_particles_.resize(nbmax);
 
   // Build device array mapping neighbor index to neighbor bufid
@@ -867,76 +958,76 @@ void Swarm::SetupPersistentMPI() {
 }
 
 int Swarm::CountParticlesToSend_() {
-  auto block_index_h = block_index_.GetHostMirrorAndCopy();
-  auto mask_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mask_);
-  auto swarm_d = GetDeviceContext();
   auto pmb = GetBlockPointer();
   const int nbmax = vbswarm->bd_var_.nbmax;
-
-  // Fence to make sure particles aren't currently being transported locally
-  // TODO(BRR) do this operation on device.
-  pmb->exec_space.fence();
-  auto num_particles_to_send_h = num_particles_to_send_.GetHostMirror();
-  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
-    num_particles_to_send_h(n) = 0;
-  }
   const int particle_size = GetParticleDataSize();
   vbswarm->particle_size = particle_size;
 
-  int max_indices_size = 0;
+  // Count the particles to send to each neighbor on device, only the counts per
+  // neighbor come back to the host
+  auto &mask = mask_;
+  auto &block_index = block_index_;
+  auto num_particles_to_send = num_particles_to_send_;
+  const int no_block = no_block_;
+  Kokkos::deep_copy(num_particles_to_send.KokkosView(), 0);
   int total_noblock_particles = 0;
-  for (int n = 0; n <= max_active_index_; n++) {
-    if (mask_h(n)) {
-      // This particle should be sent
-      if (block_index_h(n) >= 0) {
-        num_particles_to_send_h(block_index_h(n))++;
-        if (max_indices_size < num_particles_to_send_h(block_index_h(n))) {
-          max_indices_size = num_particles_to_send_h(block_index_h(n));
+  pmb->par_reduce(
+      PARTHENON_AUTO_LABEL, 0, max_active_index_,
+      KOKKOS_LAMBDA(const int n, int &lnum) {
+        if (mask(n)) {
+          const int bid = block_index(n);
+          if (bid >= 0) {
+            Kokkos::atomic_increment(&num_particles_to_send(bid));
+          } else if (bid == no_block) {
+            lnum++;
+          }
         }
-      }
-      if (block_index_h(n) == no_block_) {
-        total_noblock_particles++;
-      }
-    }
+      },
+      Kokkos::Sum<int>(total_noblock_particles));
+  auto num_particles_to_send_h = num_particles_to_send_.GetHostMirrorAndCopy();
+
+  int max_indices_size = 0;
+  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+    max_indices_size = std::max<int>(max_indices_size, num_particles_to_send_h(n));
   }
   // Size-0 arrays not permitted but we don't want to short-circuit subsequent logic
   // that indicates completed communications
   max_indices_size = std::max<int>(1, max_indices_size);
 
+  // Only grow the index lists, their rows are read up to the number of particles sent
+  if (particle_indices_to_send_.GetDim(2) < nbmax ||
+      particle_indices_to_send_.GetDim(1) < max_indices_size) {
+    particle_indices_to_send_ =
+        ParArrayND<int>("Particle indices to send", nbmax, max_indices_size);
+  }
+  auto particle_indices_to_send = particle_indices_to_send_;
+  ParArray1D<int> num_indices("Number of indices to send", nbmax);
+  pmb->par_for(
+      PARTHENON_AUTO_LABEL, 0, max_active_index_, KOKKOS_LAMBDA(const int n) {
+        if (mask(n)) {
+          const int bid = block_index(n);
+          if (bid >= 0) {
+            const int idx = Kokkos::atomic_fetch_add(&num_indices(bid), 1);
+            particle_indices_to_send(bid, idx) = n;
+          }
+        }
+      });
+
   // Not a ragged-right array, just for convenience
   if (total_noblock_particles > 0) {
     auto noblock_indices =
         ParArray1D<int>("Particles with no block", total_noblock_particles);
-    auto noblock_indices_h = noblock_indices.GetHostMirror();
-    int counter = 0;
-    for (int n = 0; n <= max_active_index_; n++) {
-      if (mask_h(n)) {
-        if (block_index_h(n) == no_block_) {
-          noblock_indices_h(counter) = n;
-          counter++;
-        }
-      }
-    }
-    noblock_indices.DeepCopy(noblock_indices_h);
+    pmb->par_scan(
+        PARTHENON_AUTO_LABEL, 0, max_active_index_,
+        KOKKOS_LAMBDA(const int n, int &noblock_rank, const bool final) {
+          if (mask(n) && block_index(n) == no_block) {
+            if (final) noblock_indices(noblock_rank) = n;
+            noblock_rank++;
+          }
+        });
     ApplyBoundaries_(total_noblock_particles, noblock_indices);
   }
 
-  // TODO(BRR) don't allocate dynamically
-  particle_indices_to_send_ =
-      ParArrayND<int>("Particle indices to send", nbmax, max_indices_size);
-  auto particle_indices_to_send_h = particle_indices_to_send_.GetHostMirror();
-  std::vector<int> counter(nbmax, 0);
-  for (int n = 0; n <= max_active_index_; n++) {
-    if (mask_h(n)) {
-      if (block_index_h(n) >= 0) {
-        particle_indices_to_send_h(block_index_h(n), counter[block_index_h(n)]) = n;
-        counter[block_index_h(n)]++;
-      }
-    }
-  }
-  num_particles_to_send_.DeepCopy(num_particles_to_send_h);
-  particle_indices_to_send_.DeepCopy(particle_indices_to_send_h);
-
   num_particles_sent_ = 0;
   for (int n = 0; n < pmb->pbval->nneighbor; n++) {
     // Resize buffer if too small
@@ -976,22 +1067,20 @@ void Swarm::LoadBuffers_(const int max_indices_size) {
   auto particle_indices_to_send = particle_indices_to_send_;
   auto neighbor_buffer_index = neighbor_buffer_index_;
   pmb->par_for(
-      PARTHENON_AUTO_LABEL, 0, max_indices_size - 1,
-      KOKKOS_LAMBDA(const int n) {            // Max index
-        for (int m = 0; m < nneighbor; m++) { // Number of neighbors
+      PARTHENON_AUTO_LABEL, 0, nneighbor - 1, 0, max_indices_size - 1,
+      KOKKOS_LAMBDA(const int m, const int n) { // Neighbor, index into its list
+        if (n < num_particles_to_send(m)) {
           const int bufid = neighbor_buffer_index(m);
-          if (n < num_particles_to_send(m)) {
-            const int sidx = particle_indices_to_send(m, n);
-            int buffer_index = n * particle_size;
-            swarm_d.MarkParticleForRemoval(sidx);
-            for (int i = 0; i < realPackDim; i++) {
-              bdvar.send[bufid](buffer_index) = vreal(i, sidx);
-              buffer_index++;
-            }
-            for (int i = 0; i < intPackDim; i++) {
-              bdvar.send[bufid](buffer_index) = static_cast<Real>(vint(i, sidx));
-              buffer_index++;
-            }
+          const int sidx = particle_indices_to_send(m, n);
+          int buffer_index = n * particle_size;
+          swarm_d.MarkParticleForRemoval(sidx);
+          for (int i = 0; i < realPackDim; i++) {
+            bdvar.send[bufid](buffer_index) = vreal(i, sidx);
+            buffer_index++;
+          }
+          for (int i = 0; i < intPackDim; i++) {
+            bdvar.send[bufid](buffer_index) = static_cast<Real>(vint(i, sidx));
+            buffer_index++;
           }
         }
       });
@@ -1000,15 +1089,19 @@ void Swarm::LoadBuffers_(const int max_indices_size) {
 }
 
 void Swarm::Send(BoundaryCommSubset phase) {
+  if (LoadSendBuffers()) {
+    // Send buffer data
+    vbswarm->Send(phase);
+  }
+}
+
+bool Swarm::LoadSendBuffers() {
   auto pmb = GetBlockPointer();
   const int nneighbor = pmb->pbval->nneighbor;
   auto swarm_d = GetDeviceContext();
 
   if (nneighbor == 0) {
     // Process physical boundary conditions on "sent" particles
-    auto block_index_h = block_index_.GetHostMirrorAndCopy();
-    auto mask_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), mask_);
-
     int total_sent_particles = 0;
     pmb->par_reduce(
         PARTHENON_AUTO_LABEL, 0, max_active_index_,
@@ -1023,30 +1116,26 @@ void Swarm::Send(BoundaryCommSubset phase) {
 
     if (total_sent_particles > 0) {
       ParArray1D<int> new_indices("new indices", total_sent_particles);
-      auto new_indices_h = new_indices.GetHostMirrorAndCopy();
-      int sent_particle_index = 0;
-      for (int n = 0; n <= max_active_index_; n++) {
-        if (mask_h(n)) {
-          if (block_index_h(n) >= 0 || block_index_h(n) == no_block_) {
-            new_indices_h(sent_particle_index) = n;
-            sent_particle_index++;
-          }
-        }
-      }
-      new_indices.DeepCopy(new_indices_h);
+      pmb->par_scan(
+          PARTHENON_AUTO_LABEL, 0, max_active_index_,
+          KOKKOS_LAMBDA(const int n, int &sent_rank, const bool final) {
+            if (swarm_d.IsActive(n) && !swarm_d.IsOnCurrentMeshBlock(n)) {
+              if (final) new_indices(sent_rank) = n;
+              sent_rank++;
+            }
+          });
 
       ApplyBoundaries_(total_sent_particles, new_indices);
     }
-  } else {
-    // Query particles for those to be sent
-    int max_indices_size = CountParticlesToSend_();
+    return false;
+  }
 
-    // Prepare buffers for send operations
-    LoadBuffers_(max_indices_size);
+  // Query particles for those to be sent
+  int max_indices_size = CountParticlesToSend_();
 
-    // Send buffer data
-    vbswarm->Send(phase);
-  }
+  // Prepare buffers for send operations
+  LoadBuffers_(max_indices_size);
+  return true;
 }
 
 void Swarm::CountReceivedParticles_() {
@@ -1170,22 +1259,28 @@ bool Swarm::Receive(BoundaryCommSubset phase) {
     // Populate buffers
     vbswarm->Receive(phase);
 
-    // Transfer data from buffers to swarm memory pool
-    UnloadBuffers_();
-
-    auto &bdvar = vbswarm->bd_var_;
-    bool all_boundaries_received = true;
-    for (int n = 0; n < nneighbor; n++) {
-      NeighborBlock &nb = pmb->pbval->neighbor[n];
-      if (bdvar.flag[nb.bufid] == BoundaryStatus::arrived) {
-        bdvar.flag[nb.bufid] = BoundaryStatus::completed;
-      } else if (bdvar.flag[nb.bufid] == BoundaryStatus::waiting) {
-        all_boundaries_received = false;
-      }
-    }
+    return UnloadReceiveBuffers();
+  }
+}
 
-    return all_boundaries_received;
+bool Swarm::UnloadReceiveBuffers() {
+  auto pmb = GetBlockPointer();
+
+  // Transfer data from buffers to swarm memory pool
+  UnloadBuffers_();
+
+  auto &bdvar = vbswarm->bd_var_;
+  bool all_boundaries_received = true;
+  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+    NeighborBlock &nb = pmb->pbval->neighbor[n];
+    if (bdvar.flag[nb.bufid] == BoundaryStatus::arrived) {
+      bdvar.flag[nb.bufid] = BoundaryStatus::completed;
+    } else if (bdvar.flag[nb.bufid] == BoundaryStatus::waiting) {
+      all_boundaries_received = false;
+    }
   }
+
+  return all_boundaries_received;
 }
 
 void Swarm::ResetCommunication() {
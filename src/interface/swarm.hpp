@@ -19,7 +19,6 @@
 
 #include <array>
 #include <cstdint>
-#include <list>
 #include <map>
 #include <memory>
 #include <set>
@@ -72,6 +71,40 @@ class NewParticlesContext {
   ParArray1D<int> new_indices_;
 };
 
+// This class is returned by ReserveParticles. It is passed by copy into kernels that
+// create particles, each call to Create claiming one of the reserved free slots with an
+// atomic, so that particles can be created without knowing their number on the host
+// beforehand. The new particles are counted as active once CommitReservedParticles is
+// called.
+class ParticleCreator {
+ public:
+  ParticleCreator(const int num_reserved, const ParArray1D<int> free_slots,
+                  const ParArray0D<int> num_claimed, const ParArray1D<bool> mask,
+                  const ParArrayND<int> block_index, const int this_block)
+      : num_reserved_(num_reserved), free_slots_(free_slots), num_claimed_(num_claimed),
+        mask_(mask), block_index_(block_index), this_block_(this_block) {}
+
+  // Claim a free slot and return the swarm index of the new particle, or -1 if all
+  // reserved slots are taken.
+  KOKKOS_INLINE_FUNCTION
+  int Create() const {
+    const int k = Kokkos::atomic_fetch_add(&num_claimed_(), 1);
+    if (k >= num_reserved_) return -1;
+    const int n = free_slots_(k);
+    mask_(n) = true;
+    block_index_(n) = this_block_;
+    return n;
+  }
+
+ private:
+  const int num_reserved_;
+  ParArray1D<int> free_slots_;
+  ParArray0D<int> num_claimed_;
+  ParArray1D<bool> mask_;
+  ParArrayND<int> block_index_;
+  const int this_block_;
+};
+
 class MeshBlock;
 
 enum class PARTICLE_STATUS { UNALLOCATED, ALIVE, DEAD };
@@ -197,6 +230,13 @@ class Swarm {
   /// Open up memory for new empty particles, return a mask to these particles
   NewParticlesContext AddEmptyParticles(const int num_to_add);
 
+  /// Reserve free slots for up to max_to_add particles that device kernels create
+  /// through the returned ParticleCreator
+  ParticleCreator ReserveParticles(const int max_to_add);
+
+  /// Activate the particles created since ReserveParticles and return their number
+  int CommitReservedParticles();
+
   /// Defragment the list by moving active particles so they are contiguous in
   /// memory
   void Defrag();
@@ -205,8 +245,22 @@ class Swarm {
   /// index (i + nx*(j + ny*k))
   void SortParticlesByCell();
 
+  /// The same operations for a number of swarms, typically one swarm on each block of
+  /// a MeshData, with a single launch for all of them rather than several per swarm.
+  /// Each swarm is handled by one team, so these pay off for many small swarms.
+  static void RemoveMarkedParticles(const std::vector<Swarm *> &swarms);
+  static void Defrag(const std::vector<Swarm *> &swarms);
+  static void SortParticlesByCell(const std::vector<Swarm *> &swarms);
+
   // used in case of swarm boundary communication
   void SetupPersistentMPI();
+  // The index of the neighbor of pmb in each of the 4x4x4 regions a particle can be in,
+  // see GetNeighborBlockIndex(), computed on the device.  It only depends on the block,
+  // so SwarmContainer shares it between all of its swarms via SetNeighborIndices.
+  static ParArrayND<int> BuildNeighborIndices(MeshBlock *pmb);
+  void SetNeighborIndices(const ParArrayND<int> &neighbor_indices) {
+    neighbor_indices_ = neighbor_indices;
+  }
   std::shared_ptr<BoundarySwarm> vbswarm;
   void AllocateComms(std::weak_ptr<MeshBlock> wpmb);
 
@@ -228,6 +282,14 @@ class Swarm {
 
   bool Receive(BoundaryCommSubset phase);
 
+  /// The two halves of Send and Receive that don't communicate, for
+  /// SendSwarmAggregated and ReceiveSwarmAggregated. LoadSendBuffers fills the send
+  /// buffers, or applies the physical boundaries if the block has no neighbors, and
+  /// returns whether there is anything to send. UnloadReceiveBuffers adds the
+  /// particles in the receive buffers and returns whether all neighbors were received.
+  bool LoadSendBuffers();
+  bool UnloadReceiveBuffers();
+
   void ResetCommunication();
 
   bool FinalizeCommunicationIterative();
@@ -265,12 +327,13 @@ class Swarm {
   template <class BOutflow, class BPeriodic, int iFace>
   void AllocateBoundariesImpl_(MeshBlock *pmb);
 
-  void SetNeighborIndices1D_();
-  void SetNeighborIndices2D_();
-  void SetNeighborIndices3D_();
-
   int CountParticlesToSend_();
   void CountReceivedParticles_();
+  int CountActive_(const int begin, const int end) const;
+  template <class T>
+  void Repack_(const int nmax_pool);
+  void ReservePool_(const int num_free);
+  int FindFreeSlots_(const int num);
   void UpdateNeighborBufferReceiveIndices_(ParArray1D<int> &neighbor_index,
                                            ParArray1D<int> &buffer_index);
 
@@ -293,7 +356,6 @@ class Swarm {
 
   std::tuple<MapToParticle<int>, MapToParticle<Real>> maps_;
 
-  std::list<int> free_indices_;
   ParArray1D<bool> mask_;
   ParArray1D<bool> marked_for_removal_;
   ParArrayND<int> block_index_; // Neighbor index for each particle. -1 for current block.
@@ -328,6 +390,13 @@ class Swarm {
   ParArrayND<int>
       cell_sorted_number_; // Per-cell array of number of particles in each cell
 
+  // With Metadata::Contiguous, all variables of each type are rows of one block
+  bool contiguous_ = false;
+  std::tuple<ParArray2D<int>, ParArray2D<Real>> blocks_;
+
+  int num_reserved_ = 0;         // Number of free slots reserved by ReserveParticles
+  ParArray0D<int> num_claimed_; // Number of reserved slots claimed on device
+
  public:
   bool mpiStatus;
 };
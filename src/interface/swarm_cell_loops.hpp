@@ -0,0 +1,79 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_SWARM_CELL_LOOPS_HPP_
+#define INTERFACE_SWARM_CELL_LOOPS_HPP_
+
+#include <string>
+
+#include "basic_types.hpp"
+#include "interface/swarm.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/domain.hpp"
+#include "mesh/meshblock.hpp"
+
+namespace parthenon {
+
+// Loops over the particles of swarm cell by cell, with one team per cell (k, j, i) of
+// domain and the threads of the team spread over the active particles of the cell.  The
+// particles of a cell are consecutive in memory after Swarm::SortParticlesByCell, which
+// has to be called after the particles last moved.
+//
+// The team first fills the scratch array cell of length nvalues with
+// cell(v) = cell_value(v, k, j, i), e.g., the fields of the cell a collision or
+// deposition kernel needs, and then calls function(k, j, i, n, cell) for every active
+// particle n of the cell, so the cell data is read once rather than once per particle.
+// Writes to the particles are race free, writes to the cell need atomics or a reduction
+// over the team.
+template <class CellValue, class Function>
+void par_for_particles_by_cell(const std::string &name, Swarm *swarm,
+                               const IndexDomain domain, const int nvalues,
+                               const CellValue &cell_value, const Function &function) {
+  auto pmb = swarm->GetBlockPointer();
+  const IndexRange ib = pmb->cellbounds.GetBoundsI(domain);
+  const IndexRange jb = pmb->cellbounds.GetBoundsJ(domain);
+  const IndexRange kb = pmb->cellbounds.GetBoundsK(domain);
+  auto swarm_d = swarm->GetDeviceContext();
+  const int scratch_level = 0;
+  const std::size_t scratch_size = ScratchPad1D<Real>::shmem_size(nvalues);
+
+  par_for_outer(
+      DEFAULT_OUTER_LOOP_PATTERN, name, pmb->exec_space, scratch_size, scratch_level,
+      kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(team_mbr_t team_member, const int k, const int j, const int i) {
+        ScratchPad1D<Real> cell(team_member.team_scratch(scratch_level), nvalues);
+        par_for_inner(DEFAULT_INNER_LOOP_PATTERN, team_member, 0, nvalues - 1,
+                      [&](const int v) { cell(v) = cell_value(v, k, j, i); });
+        team_member.team_barrier();
+        const int npart = swarm_d.GetParticleCountPerCell(k, j, i);
+        par_for_inner(DEFAULT_INNER_LOOP_PATTERN, team_member, 0, npart - 1,
+                      [&](const int m) {
+                        const int n = swarm_d.GetFullIndex(k, j, i, m);
+                        if (swarm_d.IsActive(n)) function(k, j, i, n, cell);
+                      });
+      });
+}
+
+// Same as above for kernels that need no cell data, calling function(k, j, i, n)
+template <class Function>
+void par_for_particles_by_cell(const std::string &name, Swarm *swarm,
+                               const IndexDomain domain, const Function &function) {
+  par_for_particles_by_cell(
+      name, swarm, domain, 0,
+      KOKKOS_LAMBDA(const int, const int, const int, const int) { return Real(0.0); },
+      KOKKOS_LAMBDA(const int k, const int j, const int i, const int n,
+                    const ScratchPad1D<Real> &) { function(k, j, i, n); });
+}
+
+} // namespace parthenon
+
+#endif // INTERFACE_SWARM_CELL_LOOPS_HPP_
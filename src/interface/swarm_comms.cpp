@@ -0,0 +1,222 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "interface/swarm_comms.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bvals/bvals_interfaces.hpp"
+#include "globals.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/swarm.hpp"
+#include "interface/swarm_container.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/error_checking.hpp"
+#include "utils/instrument.hpp"
+
+namespace parthenon {
+
+namespace {
+// A neighbor buffer that is part of a message, identified on both ranks by the gid of
+// the receiving block and the index of the buffer on that block
+struct MessagePart {
+  int gid;
+  int bufid;
+  BoundarySwarm *bswarm;
+  int local_bufid; // index of the buffer on this rank
+};
+
+bool operator<(const MessagePart &a, const MessagePart &b) {
+  return std::tie(a.gid, a.bufid) < std::tie(b.gid, b.bufid);
+}
+
+AggregatedSwarmComms &GetComms(MeshData<Real> *md, const std::string &swarm_name) {
+  Mesh *pmesh = md->GetMeshPointer();
+  PARTHENON_REQUIRE(static_cast<std::size_t>(md->NumBlocks()) == pmesh->block_list.size(),
+                    "Aggregated swarm communication needs all blocks of the rank");
+  auto &comms = pmesh->aggregated_swarm_comms[swarm_name];
+  if (comms == nullptr) comms = std::make_shared<AggregatedSwarmComms>();
+  return *comms;
+}
+
+Swarm *GetSwarm(MeshData<Real> *md, const int b, const std::string &swarm_name) {
+  auto pmb = md->GetBlockData(b)->GetBlockPointer();
+  return pmb->swarm_data.Get()->Get(swarm_name).get();
+}
+
+#ifdef MPI_PARALLEL
+// The messages are sent on a communicator of their own, so that they cannot be matched
+// by the per-block swarm messages, which use tags starting at 0 on the swarm's
+// communicator
+constexpr int aggregated_swarm_tag = 0;
+
+MPI_Comm GetAggregatedComm(Mesh *pmesh, const std::string &swarm_name) {
+  return pmesh->GetMPIComm(swarm_name + Mesh::aggregated_swarm_comm_suffix);
+}
+#endif
+} // namespace
+
+TaskStatus SendSwarmAggregated(MeshData<Real> *md, const std::string &swarm_name) {
+  PARTHENON_INSTRUMENT
+  auto &comms = GetComms(md, swarm_name);
+  (void)comms; // only holds the messages to other ranks
+
+  // Fill the send buffers of all blocks, and deliver those for blocks on this rank
+  std::map<int, std::vector<MessagePart>> outgoing;
+  for (int b = 0; b < md->NumBlocks(); b++) {
+    auto swarm = GetSwarm(md, b, swarm_name);
+    if (!swarm->LoadSendBuffers()) continue;
+    auto pmb = swarm->GetBlockPointer();
+    auto bswarm = swarm->vbswarm.get();
+    bswarm->SendToSameRank();
+    for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+      NeighborBlock &nb = pmb->pbval->neighbor[n];
+      if (nb.snb.rank != Globals::my_rank) {
+        outgoing[nb.snb.rank].push_back(
+            MessagePart{nb.snb.gid, nb.targetid, bswarm, nb.bufid});
+      }
+    }
+  }
+
+#ifdef MPI_PARALLEL
+  Mesh *pmesh = md->GetMeshPointer();
+  MPI_Comm comm = GetAggregatedComm(pmesh, swarm_name);
+  for (auto &[rank, parts] : outgoing) {
+    std::sort(parts.begin(), parts.end());
+    const int nparts = static_cast<int>(parts.size());
+    int msg_size = nparts;
+    for (const auto &part : parts) {
+      msg_size += part.bswarm->send_size[part.local_bufid];
+    }
+
+    // the message of the previous exchange may still be in flight
+    auto req = comms.send_req.emplace(rank, MPI_REQUEST_NULL).first;
+    PARTHENON_MPI_CHECK(MPI_Wait(&(req->second), MPI_STATUS_IGNORE));
+    auto &msg = comms.send_msg[rank];
+    if (msg.extent_int(0) < msg_size) {
+      msg = BufArray1D<Real>("Aggregated swarm message", msg_size);
+    }
+
+    auto sizes = Kokkos::subview(msg, std::make_pair(0, nparts));
+    auto sizes_h = Kokkos::create_mirror_view(Kokkos::HostSpace(), sizes);
+    int offset = nparts;
+    for (int p = 0; p < nparts; p++) {
+      const auto &part = parts[p];
+      const int size = part.bswarm->send_size[part.local_bufid];
+      sizes_h(p) = size;
+      if (size > 0) {
+        Kokkos::deep_copy(
+            DevExecSpace(), Kokkos::subview(msg, std::make_pair(offset, offset + size)),
+            Kokkos::subview(part.bswarm->bd_var_.send[part.local_bufid],
+                            std::make_pair(0, size)));
+      }
+      offset += size;
+    }
+    Kokkos::deep_copy(sizes, sizes_h);
+    // Fence to make sure the message is complete before sending
+    Kokkos::fence();
+    PARTHENON_MPI_CHECK(MPI_Isend(msg.data(), msg_size, MPI_PARTHENON_REAL, rank,
+                                  aggregated_swarm_tag, comm, &(req->second)));
+  }
+#endif // MPI_PARALLEL
+
+  return TaskStatus::complete;
+}
+
+TaskStatus ReceiveSwarmAggregated(MeshData<Real> *md, const std::string &swarm_name) {
+  PARTHENON_INSTRUMENT
+  auto &comms = GetComms(md, swarm_name);
+  (void)comms;
+
+#ifdef MPI_PARALLEL
+  std::map<int, std::vector<MessagePart>> incoming;
+  for (int b = 0; b < md->NumBlocks(); b++) {
+    auto swarm = GetSwarm(md, b, swarm_name);
+    auto pmb = swarm->GetBlockPointer();
+    for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+      NeighborBlock &nb = pmb->pbval->neighbor[n];
+      if (nb.snb.rank != Globals::my_rank) {
+        incoming[nb.snb.rank].push_back(
+            MessagePart{pmb->gid, nb.bufid, swarm->vbswarm.get(), nb.bufid});
+      }
+    }
+  }
+
+  Mesh *pmesh = md->GetMeshPointer();
+  MPI_Comm comm = GetAggregatedComm(pmesh, swarm_name);
+  bool all_received = true;
+  for (auto &[rank, parts] : incoming) {
+    if (comms.received[rank]) continue;
+    int test;
+    MPI_Status status;
+    PARTHENON_MPI_CHECK(MPI_Iprobe(rank, aggregated_swarm_tag, comm, &test, &status));
+    if (!static_cast<bool>(test)) {
+      all_received = false;
+      continue;
+    }
+    int msg_size;
+    PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &msg_size));
+    auto &msg = comms.recv_msg[rank];
+    if (msg.extent_int(0) < msg_size) {
+      msg = BufArray1D<Real>("Aggregated swarm message", msg_size);
+    }
+    PARTHENON_MPI_CHECK(MPI_Recv(msg.data(), msg_size, MPI_PARTHENON_REAL, rank,
+                                 aggregated_swarm_tag, comm, MPI_STATUS_IGNORE));
+
+    // Scatter the message into the receive buffers of the blocks
+    std::sort(parts.begin(), parts.end());
+    const int nparts = static_cast<int>(parts.size());
+    auto sizes_h = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), Kokkos::subview(msg, std::make_pair(0, nparts)));
+    int offset = nparts;
+    for (int p = 0; p < nparts; p++) {
+      auto &bd = parts[p].bswarm->bd_var_;
+      const int bufid = parts[p].local_bufid;
+      const int size = static_cast<int>(sizes_h(p));
+      parts[p].bswarm->recv_size[bufid] = size;
+      if (size > 0) {
+        if (bd.recv[bufid].extent_int(0) < size) {
+          bd.recv[bufid] = BufArray1D<Real>("Buffer", size);
+        }
+        Kokkos::deep_copy(
+            DevExecSpace(), Kokkos::subview(bd.recv[bufid], std::make_pair(0, size)),
+            Kokkos::subview(msg, std::make_pair(offset, offset + size)));
+        bd.flag[bufid] = BoundaryStatus::arrived;
+      } else {
+        bd.flag[bufid] = BoundaryStatus::completed;
+      }
+      offset += size;
+    }
+    PARTHENON_REQUIRE(offset == msg_size, "Aggregated swarm message has the wrong size");
+    comms.received[rank] = true;
+  }
+  if (!all_received) return TaskStatus::incomplete;
+  comms.received.clear();
+#endif // MPI_PARALLEL
+
+  // All buffers have arrived, move the particles into the swarms
+  Kokkos::fence();
+  for (int b = 0; b < md->NumBlocks(); b++) {
+    GetSwarm(md, b, swarm_name)->UnloadReceiveBuffers();
+  }
+
+  return TaskStatus::complete;
+}
+
+} // namespace parthenon
@@ -0,0 +1,56 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_SWARM_COMMS_HPP_
+#define INTERFACE_SWARM_COMMS_HPP_
+
+#include <map>
+#include <string>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "parthenon_mpi.hpp"
+
+namespace parthenon {
+
+template <typename T>
+class MeshData;
+
+// Particle communication of a swarm across all blocks of this rank at once.  Instead of
+// one message per pair of neighboring blocks, the send buffers of all blocks for blocks
+// on another rank are gathered into one message per rank, and the buffers for blocks on
+// this rank are delivered by device copies.  Both functions take the MeshData of all
+// blocks of the rank and replace SwarmContainer::Send and SwarmContainer::Receive for the
+// swarm; SwarmContainer::ResetCommunication still has to be called before each exchange,
+// and the two kinds of communication must not be mixed within one exchange.
+// ReceiveSwarmAggregated returns TaskStatus::incomplete until the messages from all
+// neighboring ranks have arrived, and only then adds the received particles to the
+// swarms.
+TaskStatus SendSwarmAggregated(MeshData<Real> *md, const std::string &swarm_name);
+TaskStatus ReceiveSwarmAggregated(MeshData<Real> *md, const std::string &swarm_name);
+
+// Messages of the aggregated communication of one swarm, kept by the Mesh so that they
+// are reused between exchanges.  Each message starts with the number of Reals sent to
+// each receiving buffer, ordered by the gid of the receiving block and the buffer index,
+// followed by the contents of these buffers in the same order.
+struct AggregatedSwarmComms {
+  std::map<int, BufArray1D<Real>> send_msg, recv_msg;
+  // ranks whose message of the current exchange has been received
+  std::map<int, bool> received;
+#ifdef MPI_PARALLEL
+  std::map<int, MPI_Request> send_req;
+#endif
+};
+
+} // namespace parthenon
+
+#endif // INTERFACE_SWARM_COMMS_HPP_
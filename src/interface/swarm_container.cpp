@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "globals.hpp" // my_rank
+#include "interface/mesh_data.hpp"
 #include "mesh/mesh.hpp"
 #include "swarm_container.hpp"
 #include "utils/error_checking.hpp"
@@ -126,7 +127,20 @@ TaskStatus SwarmContainer::SortParticlesByCell() {
 void SwarmContainer::SendBoundaryBuffers() {}
 
 void SwarmContainer::SetupPersistentMPI() {
+  if (swarmVector_.empty()) return;
+  auto pmb = GetBlockPointer();
+  std::vector<int> offsets;
+  offsets.reserve(3 * pmb->pbval->nneighbor);
+  for (int n = 0; n < pmb->pbval->nneighbor; n++) {
+    const NeighborBlock &nb = pmb->pbval->neighbor[n];
+    offsets.insert(offsets.end(), {nb.ni.ox1, nb.ni.ox2, nb.ni.ox3});
+  }
+  if (!neighbor_indices_.IsAllocated() || offsets != neighbor_offsets_) {
+    neighbor_indices_ = Swarm::BuildNeighborIndices(pmb.get());
+    neighbor_offsets_ = std::move(offsets);
+  }
   for (auto &s : swarmVector_) {
+    s->SetNeighborIndices(neighbor_indices_);
     s->SetupPersistentMPI();
   }
 }
@@ -204,4 +218,50 @@ void SwarmContainer::Print() const {
   }
 }
 
+namespace {
+std::vector<Swarm *> AllSwarms(MeshData<Real> *md) {
+  std::vector<Swarm *> swarms;
+  for (int b = 0; b < md->NumBlocks(); b++) {
+    auto pmb = md->GetBlockData(b)->GetBlockPointer();
+    for (auto &s : pmb->swarm_data.Get()->allSwarms()) {
+      swarms.push_back(s.get());
+    }
+  }
+  return swarms;
+}
+} // namespace
+
+TaskStatus DefragSwarms(MeshData<Real> *md, double min_occupancy) {
+  PARTHENON_INSTRUMENT
+  PARTHENON_REQUIRE_THROWS(min_occupancy >= 0. && min_occupancy <= 1.,
+                           "Max fractional occupancy of swarm must be >= 0 and <= 1");
+  std::vector<Swarm *> swarms;
+  for (Swarm *s : AllSwarms(md)) {
+    if (s->GetNumActive() > 0 &&
+        s->GetNumActive() / (s->GetMaxActiveIndex() + 1.0) < min_occupancy) {
+      swarms.push_back(s);
+    }
+  }
+  Swarm::Defrag(swarms);
+  return TaskStatus::complete;
+}
+
+TaskStatus DefragAllSwarms(MeshData<Real> *md) {
+  PARTHENON_INSTRUMENT
+  Swarm::Defrag(AllSwarms(md));
+  return TaskStatus::complete;
+}
+
+TaskStatus SortSwarmsByCell(MeshData<Real> *md) {
+  PARTHENON_INSTRUMENT
+  Swarm::SortParticlesByCell(AllSwarms(md));
+  return TaskStatus::complete;
+}
+
+TaskStatus RemoveMarkedSwarmParticles(MeshData<Real> *md) {
+  PARTHENON_INSTRUMENT
+  Swarm::RemoveMarkedParticles(AllSwarms(md));
+  return TaskStatus::complete;
+}
+
 } // namespace parthenon
@@ -194,7 +194,22 @@ class SwarmContainer {
   SwarmVector swarmVector_ = {};
   SwarmMap swarmMap_ = {};
   SwarmMetadataMap swarmMetadataMap_ = {};
+
+  // neighbor lookup table shared by all swarms, rebuilt only when the offsets of the
+  // neighbors it was built from change
+  ParArrayND<int> neighbor_indices_;
+  std::vector<int> neighbor_offsets_;
 };
 
+template <typename T>
+class MeshData;
+
+// The SwarmContainer tasks for all swarms on all blocks of a MeshData, which only take a
+// single launch per operation, see the batched versions of the Swarm routines
+TaskStatus DefragSwarms(MeshData<Real> *md, double min_occupancy);
+TaskStatus DefragAllSwarms(MeshData<Real> *md);
+TaskStatus SortSwarmsByCell(MeshData<Real> *md);
+TaskStatus RemoveMarkedSwarmParticles(MeshData<Real> *md);
+
 } // namespace parthenon
 #endif // INTERFACE_SWARM_CONTAINER_HPP_
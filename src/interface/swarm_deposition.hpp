@@ -0,0 +1,144 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_SWARM_DEPOSITION_HPP_
+#define INTERFACE_SWARM_DEPOSITION_HPP_
+
+#include <string>
+
+#include "basic_types.hpp"
+#include "interface/swarm.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/domain.hpp"
+#include "mesh/meshblock.hpp"
+
+namespace parthenon {
+
+// Shape of the particles deposited onto the grid: nearest grid point, cloud in cell or
+// triangular shaped cloud, i.e., spread over 1, 2 or 3 cells per direction
+enum class DepositionShape { NGP, CIC, TSC };
+
+// DepositionStrategy::atomic loops over the particles and adds their contributions to
+// the cells with atomics.  DepositionStrategy::sorted loops over the cells and gathers
+// the contributions of the particles in the cell and its neighbors without any write
+// contention.  It requires the particles of the swarm to be sorted by cell, i.e.,
+// Swarm::SortParticlesByCell has to be called after the last time they moved.
+enum class DepositionStrategy { atomic, sorted };
+
+namespace deposition {
+
+// Weight of a particle for a cell, dist cell widths from the center of the cell
+KOKKOS_INLINE_FUNCTION Real ShapeWeight(const DepositionShape shape, const Real dist) {
+  const Real d = Kokkos::abs(dist);
+  if (shape == DepositionShape::NGP) return d <= 0.5 ? 1.0 : 0.0;
+  if (shape == DepositionShape::CIC) return Kokkos::max(Real(1.0) - d, Real(0.0));
+  if (d < 0.5) return 0.75 - d * d;
+  if (d < 1.5) return 0.5 * (1.5 - d) * (1.5 - d);
+  return 0.0;
+}
+
+// Number of neighboring cells on either side a particle contributes to
+inline int StencilWidth(const DepositionShape shape) {
+  return shape == DepositionShape::NGP ? 0 : 1;
+}
+
+} // namespace deposition
+
+// Deposit the swarm variable weight_name of all active particles of swarm onto the cell
+// field, which is indexed as field(k, j, i) and overwritten on the entire block,
+// including the ghost zones.  Contributions to cells outside of the block are dropped,
+// and those to the ghost zones are not communicated to the neighboring blocks.  Both
+// strategies give the same result up to the order of the summation.
+template <class Field>
+void DepositParticles(Swarm *swarm, const std::string &weight_name, const Field &field,
+                      const DepositionShape shape = DepositionShape::NGP,
+                      const DepositionStrategy strategy = DepositionStrategy::atomic) {
+  auto pmb = swarm->GetBlockPointer();
+  const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::entire);
+  const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::entire);
+  const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::entire);
+  const int ndim = pmb->pmy_mesh->ndim;
+  const int si = deposition::StencilWidth(shape);
+  const int sj = ndim > 1 ? si : 0;
+  const int sk = ndim > 2 ? si : 0;
+
+  const auto &x = swarm->Get<Real>("x").Get();
+  const auto &y = swarm->Get<Real>("y").Get();
+  const auto &z = swarm->Get<Real>("z").Get();
+  const auto &weight = swarm->Get<Real>(weight_name).Get();
+  auto swarm_d = swarm->GetDeviceContext();
+
+  if (strategy == DepositionStrategy::atomic) {
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int k, const int j, const int i) { field(k, j, i) = 0.0; });
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, 0, swarm->GetMaxActiveIndex(), KOKKOS_LAMBDA(const int n) {
+          if (!swarm_d.IsActive(n)) return;
+          int i, j, k;
+          Real fx, fy, fz;
+          swarm_d.Xtoijk(x(n), y(n), z(n), i, j, k, fx, fy, fz);
+          for (int dk = -sk; dk <= sk; ++dk) {
+            const Real wk =
+                ndim > 2 ? deposition::ShapeWeight(shape, fz - 0.5 - dk) : 1.0;
+            if (k + dk < kb.s || k + dk > kb.e || wk == 0.0) continue;
+            for (int dj = -sj; dj <= sj; ++dj) {
+              const Real wj =
+                  ndim > 1 ? deposition::ShapeWeight(shape, fy - 0.5 - dj) : 1.0;
+              const Real wjk = wk * wj;
+              if (j + dj < jb.s || j + dj > jb.e || wjk == 0.0) continue;
+              for (int di = -si; di <= si; ++di) {
+                const Real w = wjk * deposition::ShapeWeight(shape, fx - 0.5 - di);
+                if (i + di < ib.s || i + di > ib.e || w == 0.0) continue;
+                Kokkos::atomic_add(&field(k + dk, j + dj, i + di), w * weight(n));
+              }
+            }
+          }
+        });
+  } else {
+    pmb->par_for(
+        PARTHENON_AUTO_LABEL, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          Real sum = 0.0;
+          // particles in cell (k - dk, j - dj, i - di) contribute to this cell as their
+          // neighbor (dk, dj, di)
+          for (int dk = -sk; dk <= sk; ++dk) {
+            if (k - dk < kb.s || k - dk > kb.e) continue;
+            for (int dj = -sj; dj <= sj; ++dj) {
+              if (j - dj < jb.s || j - dj > jb.e) continue;
+              for (int di = -si; di <= si; ++di) {
+                if (i - di < ib.s || i - di > ib.e) continue;
+                const int npart = swarm_d.GetParticleCountPerCell(k - dk, j - dj, i - di);
+                for (int m = 0; m < npart; ++m) {
+                  const int n = swarm_d.GetFullIndex(k - dk, j - dj, i - di, m);
+                  if (!swarm_d.IsActive(n)) continue;
+                  int pi, pj, pk;
+                  Real fx, fy, fz;
+                  swarm_d.Xtoijk(x(n), y(n), z(n), pi, pj, pk, fx, fy, fz);
+                  const Real wk =
+                      ndim > 2 ? deposition::ShapeWeight(shape, fz - 0.5 - dk) : 1.0;
+                  const Real wj =
+                      ndim > 1 ? deposition::ShapeWeight(shape, fy - 0.5 - dj) : 1.0;
+                  sum += wk * wj * deposition::ShapeWeight(shape, fx - 0.5 - di) *
+                         weight(n);
+                }
+              }
+            }
+          }
+          field(k, j, i) = sum;
+        });
+  }
+}
+
+} // namespace parthenon
+
+#endif // INTERFACE_SWARM_DEPOSITION_HPP_
@@ -31,7 +31,7 @@ struct SwarmKey {
 
 struct SwarmKeyComparator {
   KOKKOS_INLINE_FUNCTION
-  bool operator()(const SwarmKey &s1, const SwarmKey &s2) {
+  bool operator()(const SwarmKey &s1, const SwarmKey &s2) const {
     return s1.cell_idx_1d_ < s2.cell_idx_1d_;
   }
 };
@@ -99,6 +99,33 @@ class SwarmDeviceContext {
                     : kb_s_;
   }
 
+  // Same as above, also returning the position within the cell in units of the cell
+  // width, in [0, 1)
+  KOKKOS_INLINE_FUNCTION
+  void Xtoijk(const Real &x, const Real &y, const Real &z, int &i, int &j, int &k,
+              Real &fx, Real &fy, Real &fz) const {
+    const Real sx = (x - x_min_) / coords_.Dxc<CoordinateDirection::X1DIR>();
+    i = static_cast<int>(std::floor(sx));
+    fx = sx - i;
+    i += ib_s_;
+    fy = 0.5;
+    j = jb_s_;
+    if (ndim_ > 1) {
+      const Real sy = (y - y_min_) / coords_.Dxc<CoordinateDirection::X2DIR>();
+      j = static_cast<int>(std::floor(sy));
+      fy = sy - j;
+      j += jb_s_;
+    }
+    fz = 0.5;
+    k = kb_s_;
+    if (ndim_ > 2) {
+      const Real sz = (z - z_min_) / coords_.Dxc<CoordinateDirection::X3DIR>();
+      k = static_cast<int>(std::floor(sz));
+      fz = sz - k;
+      k += kb_s_;
+    }
+  }
+
   KOKKOS_INLINE_FUNCTION
   int GetParticleCountPerCell(const int k, const int j, const int i) const {
     return cell_sorted_number_(k, j, i);
@@ -14,6 +14,9 @@
 #include "interface/update.hpp"
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "config.hpp"
 #include "coordinates/coordinates.hpp"
@@ -25,6 +28,7 @@
 #include "interface/variable_pack.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/meshblock.hpp"
+#include "utils/dispatch_ndim.hpp"
 
 #include "kokkos_abstraction.hpp"
 #include "mesh/meshblock_pack.hpp"
@@ -33,6 +37,124 @@ namespace parthenon {
 
 namespace Update {
 
+namespace impl {
+// Kernels of the MeshData tasks below for meshes with NDIM dimensions
+template <int NDIM>
+TaskStatus FluxDivergence(MeshData<Real> *in_obj, MeshData<Real> *dudt_obj) {
+  const IndexDomain interior = IndexDomain::interior;
+
+  std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
+  dudt_obj->MakeWritable(flags);
+  const auto &vin = in_obj->PackVariablesAndFluxes(flags);
+  auto dudt = dudt_obj->PackVariables(flags);
+  const IndexRange ib = in_obj->GetBoundsI(interior);
+  const IndexRange jb = in_obj->GetBoundsJ(interior);
+  const IndexRange kb = in_obj->GetBoundsK(interior);
+
+  if constexpr (simd_width > 1) {
+    // vectorize along i explicitly, which the compiler doesn't manage through the pack
+    parthenon::par_for_simd(
+        PARTHENON_AUTO_LABEL, dudt_obj->GetExecSpace(), 0, vin.GetDim(5) - 1, 0,
+        vin.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int m, const int l, const int k, const int j,
+                      const SimdLanes &lanes) {
+          if (dudt.IsAllocated(m, l) && vin.IsAllocated(m, l)) {
+            const auto &coords = vin.GetCoords(m);
+            const auto &v = vin(m);
+            lanes.Store(FluxDivHelper<NDIM>(lanes, l, k, j, coords, v),
+                        &dudt(m, l, k, j, lanes.i()));
+          }
+        });
+    return TaskStatus::complete;
+  }
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, dudt_obj->GetExecSpace(), 0,
+      vin.GetDim(5) - 1, 0, vin.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int m, const int l, const int k, const int j, const int i) {
+        if (dudt.IsAllocated(m, l) && vin.IsAllocated(m, l)) {
+          const auto &coords = vin.GetCoords(m);
+          const auto &v = vin(m);
+          dudt(m, l, k, j, i) = FluxDivHelper<NDIM>(l, k, j, i, coords, v);
+        }
+      });
+  return TaskStatus::complete;
+}
+
+template <int NDIM>
+TaskStatus UpdateWithFluxDivergence(MeshData<Real> *u0_data, MeshData<Real> *u1_data,
+                                    const Real gam0, const Real gam1,
+                                    const Real beta_dt) {
+  const IndexDomain interior = IndexDomain::interior;
+
+  std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
+  u0_data->MakeWritable(flags);
+  auto u0_pack = u0_data->PackVariablesAndFluxes(flags);
+  const auto &u1_pack = u1_data->PackVariables(flags);
+  const IndexRange ib = u0_data->GetBoundsI(interior);
+  const IndexRange jb = u0_data->GetBoundsJ(interior);
+  const IndexRange kb = u0_data->GetBoundsK(interior);
+
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, u0_data->GetExecSpace(), 0,
+      u0_pack.GetDim(5) - 1, 0, u0_pack.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int m, const int l, const int k, const int j, const int i) {
+        if (u0_pack.IsAllocated(m, l) && u1_pack.IsAllocated(m, l)) {
+          const auto &coords = u0_pack.GetCoords(m);
+          const auto &u0 = u0_pack(m);
+          u0_pack(m, l, k, j, i) = gam0 * u0(l, k, j, i) + gam1 * u1_pack(m, l, k, j, i) +
+                                   beta_dt * FluxDivHelper<NDIM>(l, k, j, i, coords, u0);
+        }
+      });
+  return TaskStatus::complete;
+}
+
+template <int NDIM>
+TaskStatus Update2SWithFluxDivergence(MeshData<Real> *s0_data, MeshData<Real> *s1_data,
+                                      const LowStorageIntegrator *pint, Real dt,
+                                      int stage, bool update_s1) {
+  auto pm = s0_data->GetMeshPointer();
+  const std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
+  auto desc =
+      MakePackDescriptor(pm->resolved_packages.get(), std::vector<std::string>{".*"},
+                         std::vector<bool>{true}, flags, {PDOpt::WithFluxes});
+  s0_data->MakeWritable(flags);
+  if (update_s1) s1_data->MakeWritable(flags);
+  decltype(desc.GetPack(s0_data)) s0, s1;
+  { // wait for the uploads of both packs at once
+    PackUploadBatch batch;
+    s0 = desc.GetPack(s0_data);
+    s1 = desc.GetPack(s1_data);
+  }
+  PARTHENON_REQUIRE(s0.GetNBlocks() == s1.GetNBlocks() &&
+                        s0.GetMaxNumberOfVars() == s1.GetMaxNumberOfVars(),
+                    "s0 and s1 must contain the same variables");
+
+  const IndexDomain interior = IndexDomain::interior;
+  const IndexRange ib = s0_data->GetBoundsI(interior);
+  const IndexRange jb = s0_data->GetBoundsJ(interior);
+  const IndexRange kb = s0_data->GetBoundsK(interior);
+
+  const Real delta = pint->delta[stage - 1];
+  const Real beta_dt = pint->beta[stage - 1] * dt;
+  const Real gam0 = pint->gam0[stage - 1];
+  const Real gam1 = pint->gam1[stage - 1];
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, s0_data->GetExecSpace(), 0,
+      s0.GetNBlocks() - 1, 0, s0.GetMaxNumberOfVars() - 1, kb.s, kb.e, jb.s, jb.e, ib.s,
+      ib.e,
+      KOKKOS_LAMBDA(const int b, const int v, const int k, const int j, const int i) {
+        if (v > s0.GetUpperBound(b)) return;
+        const auto &coords = s0.GetCoordinates(b);
+        const Real rhs = FluxDivHelper<NDIM>(b, v, k, j, i, coords, s0);
+        Real &u0 = s0(b, v, k, j, i);
+        Real &u1 = s1(b, v, k, j, i);
+        if (update_s1) u1 += delta * u0;
+        u0 = gam0 * u0 + gam1 * u1 + beta_dt * rhs;
+      });
+  return TaskStatus::complete;
+}
+} // namespace impl
+
 template <>
 TaskStatus FluxDivergence(MeshBlockData<Real> *in, MeshBlockData<Real> *dudt_cont) {
   MeshBlock *pmb = in->GetBlockPointer();
@@ -42,8 +164,10 @@ TaskStatus FluxDivergence(MeshBlockData<Real> *in, MeshBlockData<Real> *dudt_con
   const IndexRange jb = in->GetBoundsJ(interior);
   const IndexRange kb = in->GetBoundsK(interior);
 
-  const auto &vin = in->PackVariablesAndFluxes({Metadata::WithFluxes, Metadata::Cell});
-  auto dudt = dudt_cont->PackVariables({Metadata::WithFluxes, Metadata::Cell});
+  const Metadata::FlagCollection flags({Metadata::WithFluxes, Metadata::Cell});
+  dudt_cont->MakeWritable(flags);
+  const auto &vin = in->PackVariablesAndFluxes(flags);
+  auto dudt = dudt_cont->PackVariables(flags);
 
   const auto &coords = pmb->coords;
   const int ndim = pmb->pmy_mesh->ndim;
@@ -60,27 +184,9 @@ TaskStatus FluxDivergence(MeshBlockData<Real> *in, MeshBlockData<Real> *dudt_con
 
 template <>
 TaskStatus FluxDivergence(MeshData<Real> *in_obj, MeshData<Real> *dudt_obj) {
-  const IndexDomain interior = IndexDomain::interior;
-
-  std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
-  const auto &vin = in_obj->PackVariablesAndFluxes(flags);
-  auto dudt = dudt_obj->PackVariables(flags);
-  const IndexRange ib = in_obj->GetBoundsI(interior);
-  const IndexRange jb = in_obj->GetBoundsJ(interior);
-  const IndexRange kb = in_obj->GetBoundsK(interior);
-
-  const int ndim = vin.GetNdim();
-  parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, vin.GetDim(5) - 1, 0,
-      vin.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-      KOKKOS_LAMBDA(const int m, const int l, const int k, const int j, const int i) {
-        if (dudt.IsAllocated(m, l) && vin.IsAllocated(m, l)) {
-          const auto &coords = vin.GetCoords(m);
-          const auto &v = vin(m);
-          dudt(m, l, k, j, i) = FluxDivHelper(l, k, j, i, ndim, coords, v);
-        }
-      });
-  return TaskStatus::complete;
+  return DispatchNdim(in_obj->GetNDim(), [&](auto dim) {
+    return impl::FluxDivergence<decltype(dim)::value>(in_obj, dudt_obj);
+  });
 }
 
 template <>
@@ -94,8 +200,10 @@ TaskStatus UpdateWithFluxDivergence(MeshBlockData<Real> *u0_data,
   const IndexRange jb = u0_data->GetBoundsJ(interior);
   const IndexRange kb = u0_data->GetBoundsK(interior);
 
-  auto u0 = u0_data->PackVariablesAndFluxes({Metadata::WithFluxes, Metadata::Cell});
-  const auto &u1 = u1_data->PackVariables({Metadata::WithFluxes, Metadata::Cell});
+  const Metadata::FlagCollection flags({Metadata::WithFluxes, Metadata::Cell});
+  u0_data->MakeWritable(flags);
+  auto u0 = u0_data->PackVariablesAndFluxes(flags);
+  const auto &u1 = u1_data->PackVariables(flags);
 
   const auto &coords = pmb->coords;
   const int ndim = pmb->pmy_mesh->ndim;
@@ -115,28 +223,22 @@ template <>
 TaskStatus UpdateWithFluxDivergence(MeshData<Real> *u0_data, MeshData<Real> *u1_data,
                                     const Real gam0, const Real gam1,
                                     const Real beta_dt) {
-  const IndexDomain interior = IndexDomain::interior;
-
-  std::vector<MetadataFlag> flags({Metadata::WithFluxes, Metadata::Cell});
-  auto u0_pack = u0_data->PackVariablesAndFluxes(flags);
-  const auto &u1_pack = u1_data->PackVariables(flags);
-  const IndexRange ib = u0_data->GetBoundsI(interior);
-  const IndexRange jb = u0_data->GetBoundsJ(interior);
-  const IndexRange kb = u0_data->GetBoundsK(interior);
+  return DispatchNdim(u0_data->GetNDim(), [&](auto dim) {
+    return impl::UpdateWithFluxDivergence<decltype(dim)::value>(u0_data, u1_data, gam0,
+                                                                gam1, beta_dt);
+  });
+}
 
-  const int ndim = u0_pack.GetNdim();
-  parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0,
-      u0_pack.GetDim(5) - 1, 0, u0_pack.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-      KOKKOS_LAMBDA(const int m, const int l, const int k, const int j, const int i) {
-        if (u0_pack.IsAllocated(m, l) && u1_pack.IsAllocated(m, l)) {
-          const auto &coords = u0_pack.GetCoords(m);
-          const auto &u0 = u0_pack(m);
-          u0_pack(m, l, k, j, i) = gam0 * u0(l, k, j, i) + gam1 * u1_pack(m, l, k, j, i) +
-                                   beta_dt * FluxDivHelper(l, k, j, i, ndim, coords, u0);
-        }
-      });
-  return TaskStatus::complete;
+TaskStatus Update2SWithFluxDivergence(MeshData<Real> *s0_data, MeshData<Real> *s1_data,
+                                      const LowStorageIntegrator *pint, Real dt,
+                                      int stage, bool update_s1) {
+  PARTHENON_INSTRUMENT
+  PARTHENON_REQUIRE(pint->storage == LowStorageIntegrator::Storage::two_s,
+                    "Update2SWithFluxDivergence requires a method in 2S form");
+  return DispatchNdim(s0_data->GetNDim(), [&](auto dim) {
+    return impl::Update2SWithFluxDivergence<decltype(dim)::value>(
+        s0_data, s1_data, pint, dt, stage, update_s1);
+  });
 }
 
 TaskStatus SparseDealloc(MeshData<Real> *md) {
@@ -155,7 +257,12 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
   auto pack = desc.GetPack(md);
   auto packIdx = desc.GetMap();
 
-  ParArray2D<bool> is_zero("IsZero", pack.GetNBlocks(), pack.GetMaxNumberOfVars());
+  // One team per variable of every block, so that all of the partition is scanned by
+  // a single kernel with enough teams to fill the device
+  const int nblocks = pack.GetNBlocks();
+  const int nvars = pack.GetMaxNumberOfVars();
+  if (nblocks * nvars == 0) return TaskStatus::complete;
+  ParArray2D<bool> is_zero("IsZero", nblocks, nvars);
   const int Ni = ib.e + 1 - ib.s;
   const int Nj = jb.e + 1 - jb.s;
   const int Nk = kb.e + 1 - kb.s;
@@ -163,37 +270,33 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
   const int NkNjNi = Nk * NjNi;
   Kokkos::parallel_for(
       PARTHENON_AUTO_LABEL,
-      Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), pack.GetNBlocks(), Kokkos::AUTO),
+      Kokkos::TeamPolicy<>(md->GetExecSpace(), nblocks * nvars, Kokkos::AUTO),
       KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
-        const int b = team_member.league_rank();
-
-        const int lo = pack.GetLowerBound(b);
-        const int hi = pack.GetUpperBound(b);
-
-        for (int v = lo; v <= hi; ++v) {
-          const auto &var = pack(b, v);
-          const Real threshold = var.deallocation_threshold;
-          bool all_zero = true;
-          Kokkos::parallel_reduce(
-              Kokkos::TeamThreadRange<>(team_member, NkNjNi),
-              [&](const int idx, bool &lall_zero) {
-                const int k = kb.s + idx / NjNi;
-                const int j = jb.s + (idx % NjNi) / Ni;
-                const int i = ib.s + idx % Ni;
-                if (std::abs(var(k, j, i)) > threshold) {
-                  lall_zero = false;
-                  return;
-                }
-              },
-              Kokkos::LAnd<bool, DevMemSpace>(all_zero));
-          Kokkos::single(Kokkos::PerTeam(team_member),
-                         [&]() { is_zero(b, v) = all_zero; });
-        }
+        const int b = team_member.league_rank() / nvars;
+        const int v = team_member.league_rank() % nvars;
+        if (v < pack.GetLowerBound(b) || v > pack.GetUpperBound(b)) return;
+
+        const auto &var = pack(b, v);
+        const Real threshold = var.deallocation_threshold;
+        bool all_zero = true;
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange<>(team_member, NkNjNi),
+            [&](const int idx, bool &lall_zero) {
+              const int k = kb.s + idx / NjNi;
+              const int j = jb.s + (idx % NjNi) / Ni;
+              const int i = ib.s + idx % Ni;
+              lall_zero = lall_zero && (std::abs(var(k, j, i)) <= threshold);
+            },
+            Kokkos::LAnd<bool, DevMemSpace>(all_zero));
+        Kokkos::single(Kokkos::PerTeam(team_member), [&]() { is_zero(b, v) = all_zero; });
       });
 
   auto is_zero_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), is_zero);
 
-  for (int b = 0; b < pack.GetNBlocks(); ++b) {
+  // Deallocate only after all counters are updated, so that the pack and its host
+  // bounds stay valid while they are read
+  std::vector<std::pair<MeshBlock *, const std::string *>> to_deallocate;
+  for (int b = 0; b < nblocks; ++b) {
     for (auto &control_var : control_vars) {
       int lo = pack.GetLowerBoundHost(b, PackIdx(packIdx[control_var]));
       int hi = pack.GetUpperBoundHost(b, PackIdx(packIdx[control_var]));
@@ -211,12 +314,15 @@ TaskStatus SparseDealloc(MeshData<Real> *md) {
           // this variable has been flagged for deallocation deallocation_count times in
           // a row, now deallocate it
           counter = 0;
-          auto pmb = md->GetBlockData(b)->GetBlockPointer();
-          pmb->DeallocateSparse(control_var);
+          to_deallocate.emplace_back(md->GetBlockData(b)->GetBlockPointer(),
+                                     &control_var);
         }
       }
     }
   }
+  for (auto &[pmb, control_var] : to_deallocate) {
+    pmb->DeallocateSparse(*control_var);
+  }
 
   return TaskStatus::complete;
 }
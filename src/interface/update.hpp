@@ -33,28 +33,111 @@
 
 #include "kokkos_abstraction.hpp"
 #include "mesh/domain.hpp"
+#include "utils/simd_loops.hpp"
 
 namespace parthenon {
 
 namespace Update {
 
-// Calculate the flux divergence for a specific component l of a variable v
-KOKKOS_FORCEINLINE_FUNCTION
-Real FluxDivHelper(const int l, const int k, const int j, const int i, const int ndim,
-                   const Coordinates_t &coords, const VariableFluxPack<Real> &v) {
+// Calculate the flux divergence for a specific component l of a variable v on a mesh
+// with NDIM dimensions
+template <int NDIM>
+KOKKOS_FORCEINLINE_FUNCTION Real FluxDivHelper(const int l, const int k, const int j,
+                                               const int i, const Coordinates_t &coords,
+                                               const VariableFluxPack<Real> &v) {
   Real du = (coords.FaceArea<X1DIR>(k, j, i + 1) * v.flux(X1DIR, l, k, j, i + 1) -
              coords.FaceArea<X1DIR>(k, j, i) * v.flux(X1DIR, l, k, j, i));
-  if (ndim >= 2) {
+  if constexpr (NDIM >= 2) {
     du += (coords.FaceArea<X2DIR>(k, j + 1, i) * v.flux(X2DIR, l, k, j + 1, i) -
            coords.FaceArea<X2DIR>(k, j, i) * v.flux(X2DIR, l, k, j, i));
   }
-  if (ndim == 3) {
+  if constexpr (NDIM == 3) {
     du += (coords.FaceArea<X3DIR>(k + 1, j, i) * v.flux(X3DIR, l, k + 1, j, i) -
            coords.FaceArea<X3DIR>(k, j, i) * v.flux(X3DIR, l, k, j, i));
   }
   return -du / coords.CellVolume(k, j, i);
 }
 
+// Same as above with the number of dimensions known only at runtime
+KOKKOS_FORCEINLINE_FUNCTION
+Real FluxDivHelper(const int l, const int k, const int j, const int i, const int ndim,
+                   const Coordinates_t &coords, const VariableFluxPack<Real> &v) {
+  if (ndim == 3) return FluxDivHelper<3>(l, k, j, i, coords, v);
+  if (ndim == 2) return FluxDivHelper<2>(l, k, j, i, coords, v);
+  return FluxDivHelper<1>(l, k, j, i, coords, v);
+}
+
+// Same as above for variable v of block b of a SparsePack created WithFluxes
+template <int NDIM>
+KOKKOS_FORCEINLINE_FUNCTION Real FluxDivHelper(const int b, const int v, const int k,
+                                               const int j, const int i,
+                                               const Coordinates_t &coords,
+                                               const SparsePack<> &p) {
+  Real du = (coords.FaceArea<X1DIR>(k, j, i + 1) * p.flux(b, X1DIR, v, k, j, i + 1) -
+             coords.FaceArea<X1DIR>(k, j, i) * p.flux(b, X1DIR, v, k, j, i));
+  if constexpr (NDIM >= 2) {
+    du += (coords.FaceArea<X2DIR>(k, j + 1, i) * p.flux(b, X2DIR, v, k, j + 1, i) -
+           coords.FaceArea<X2DIR>(k, j, i) * p.flux(b, X2DIR, v, k, j, i));
+  }
+  if constexpr (NDIM == 3) {
+    du += (coords.FaceArea<X3DIR>(k + 1, j, i) * p.flux(b, X3DIR, v, k + 1, j, i) -
+           coords.FaceArea<X3DIR>(k, j, i) * p.flux(b, X3DIR, v, k, j, i));
+  }
+  return -du / coords.CellVolume(k, j, i);
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+Real FluxDivHelper(const int b, const int v, const int k, const int j, const int i,
+                   const int ndim, const Coordinates_t &coords, const SparsePack<> &p) {
+  if (ndim == 3) return FluxDivHelper<3>(b, v, k, j, i, coords, p);
+  if (ndim == 2) return FluxDivHelper<2>(b, v, k, j, i, coords, p);
+  return FluxDivHelper<1>(b, v, k, j, i, coords, p);
+}
+
+// Face areas in direction DIR of the cells of the lanes, shifted by di in i
+template <int DIR>
+KOKKOS_FORCEINLINE_FUNCTION SimdReal FaceAreas(const SimdLanes &lanes,
+                                               const Coordinates_t &coords, const int k,
+                                               const int j, const int di = 0) {
+  return lanes.Gather(
+      [&](const int i) { return coords.FaceArea<DIR>(k, j, i + di); });
+}
+
+// Same as the first one for the cells of the lanes of a par_for_simd
+template <int NDIM>
+KOKKOS_FORCEINLINE_FUNCTION SimdReal FluxDivHelper(const SimdLanes &lanes, const int l,
+                                                   const int k, const int j,
+                                                   const Coordinates_t &coords,
+                                                   const VariableFluxPack<Real> &v) {
+  const int i = lanes.i();
+  SimdReal du =
+      FaceAreas<X1DIR>(lanes, coords, k, j, 1) *
+          lanes.Load(&v.flux(X1DIR, l, k, j, i + 1)) -
+      FaceAreas<X1DIR>(lanes, coords, k, j) * lanes.Load(&v.flux(X1DIR, l, k, j, i));
+  if constexpr (NDIM >= 2) {
+    du += FaceAreas<X2DIR>(lanes, coords, k, j + 1) *
+              lanes.Load(&v.flux(X2DIR, l, k, j + 1, i)) -
+          FaceAreas<X2DIR>(lanes, coords, k, j) * lanes.Load(&v.flux(X2DIR, l, k, j, i));
+  }
+  if constexpr (NDIM == 3) {
+    du += FaceAreas<X3DIR>(lanes, coords, k + 1, j) *
+              lanes.Load(&v.flux(X3DIR, l, k + 1, j, i)) -
+          FaceAreas<X3DIR>(lanes, coords, k, j) * lanes.Load(&v.flux(X3DIR, l, k, j, i));
+  }
+  const SimdReal vol =
+      lanes.Gather([&](const int ii) { return coords.CellVolume(k, j, ii); });
+  return SimdReal(0.0) - du / vol;
+}
+
+KOKKOS_FORCEINLINE_FUNCTION
+SimdReal FluxDivHelper(const SimdLanes &lanes, const int l, const int k, const int j,
+                       const int ndim, const Coordinates_t &coords,
+                       const VariableFluxPack<Real> &v) {
+  if (ndim == 3) return FluxDivHelper<3>(lanes, l, k, j, coords, v);
+  if (ndim == 2) return FluxDivHelper<2>(lanes, l, k, j, coords, v);
+  return FluxDivHelper<1>(lanes, l, k, j, coords, v);
+}
+
 template <typename T>
 TaskStatus FluxDivergence(T *in, T *dudt_obj);
 
@@ -71,12 +154,13 @@ template <typename F, typename T>
 TaskStatus WeightedSumData(const F &flags, T *in1, T *in2, const Real w1, const Real w2,
                            T *out) {
   PARTHENON_INSTRUMENT
+  out->MakeWritable(flags);
   const auto &x = in1->PackVariables(flags);
   const auto &y = in2->PackVariables(flags);
   const auto &z = out->PackVariables(flags);
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, x.GetDim(5) - 1, 0,
-      x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0, x.GetDim(1) - 1,
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, out->GetExecSpace(), 0, x.GetDim(5) - 1,
+      0, x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0, x.GetDim(1) - 1,
       KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
         // TOOD(someone) This is potentially dangerous and/or not intended behavior
         // as we still may want to update (or populate) z if any of those vars are
@@ -96,10 +180,12 @@ TaskStatus CopyData(const F &flags, T *in, T *out) {
 template <typename F, typename T>
 TaskStatus SetDataToConstant(const F &flags, T *data, const Real val) {
   PARTHENON_INSTRUMENT
+  data->MakeWritable(flags);
   const auto &x = data->PackVariables(flags);
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, x.GetDim(5) - 1, 0,
-      x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0, x.GetDim(1) - 1,
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, data->GetExecSpace(), 0,
+      x.GetDim(5) - 1, 0, x.GetDim(4) - 1, 0, x.GetDim(3) - 1, 0, x.GetDim(2) - 1, 0,
+      x.GetDim(1) - 1,
       KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
         if (x.IsAllocated(b, l)) {
           x(b, l, k, j, i) = val;
@@ -147,6 +233,10 @@ TaskStatus Update2S(const F &flags, T *s0_data, T *s1_data, T *rhs_data,
                     const LowStorageIntegrator *pint, Real dt, int stage,
                     bool update_s1) {
   PARTHENON_INSTRUMENT
+  PARTHENON_REQUIRE(pint->storage == LowStorageIntegrator::Storage::two_s,
+                    "Update2S requires a method in 2S form, see Update2N");
+  s0_data->MakeWritable(flags);
+  if (update_s1) s1_data->MakeWritable(flags);
   const auto &s0 = s0_data->PackVariables(flags);
   const auto &s1 = s1_data->PackVariables(flags);
   const auto &rhs = rhs_data->PackVariables(flags);
@@ -161,8 +251,8 @@ TaskStatus Update2S(const F &flags, T *s0_data, T *s1_data, T *rhs_data,
   Real gam0 = pint->gam0[stage - 1];
   Real gam1 = pint->gam1[stage - 1];
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, s0.GetDim(5) - 1, 0,
-      s0.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, s0_data->GetExecSpace(), 0,
+      s0.GetDim(5) - 1, 0, s0.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
         if (s0.IsAllocated(b, l) && s1.IsAllocated(b, l) && rhs.IsAllocated(b, l)) {
           if (update_s1) {
@@ -182,42 +272,127 @@ TaskStatus Update2SIndependent(T *s0_data, T *s1_data, T *rhs_data,
                   rhs_data, pint, dt, stage, update_s1);
 }
 
-// For integration with Butcher tableaus
-// returns base + dt * sum_{j=0}^{k-1} a_{kj} S_j
-// for stages S_j
-// This can then be used to compute right-hand sides.
+// Williamson, JComp 35 (1980) 48-56
+// For the 2N methods of LowStorageIntegrator, s0 is the variable we are updating (base)
+// and rhs should be computed with respect to s0. s1 holds du, which doesn't need to be
+// set at the beginning of the cycle, since it is only read from the second stage on.
 template <typename F, typename T>
-TaskStatus SumButcher(const F &flags, std::shared_ptr<T> base_data,
-                      std::vector<std::shared_ptr<T>> stage_data,
-                      std::shared_ptr<T> out_data, const ButcherIntegrator *pint, Real dt,
-                      int stage) {
+TaskStatus Update2N(const F &flags, T *s0_data, T *s1_data, T *rhs_data,
+                    const LowStorageIntegrator *pint, Real dt, int stage) {
   PARTHENON_INSTRUMENT
+  PARTHENON_DEBUG_REQUIRE(pint->storage == LowStorageIntegrator::Storage::two_n,
+                          "Update2N requires a method in 2N form");
+  s0_data->MakeWritable(flags);
+  s1_data->MakeWritable(flags);
+  const auto &s0 = s0_data->PackVariables(flags);
+  const auto &s1 = s1_data->PackVariables(flags);
+  const auto &rhs = rhs_data->PackVariables(flags);
+
+  const IndexDomain interior = IndexDomain::interior;
+  const IndexRange ib = s0_data->GetBoundsI(interior);
+  const IndexRange jb = s0_data->GetBoundsJ(interior);
+  const IndexRange kb = s0_data->GetBoundsK(interior);
+
+  const Real a = pint->williamson_a[stage - 1];
+  const Real b = pint->williamson_b[stage - 1];
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, s0_data->GetExecSpace(), 0,
+      s0.GetDim(5) - 1, 0, s0.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int n, const int l, const int k, const int j, const int i) {
+        if (s0.IsAllocated(n, l) && s1.IsAllocated(n, l) && rhs.IsAllocated(n, l)) {
+          // don't read du in the first stage, in which it may be uninitialized
+          const Real du = (a == 0.0 ? 0.0 : a * s1(n, l, k, j, i)) +
+                          dt * rhs(n, l, k, j, i);
+          s1(n, l, k, j, i) = du;
+          s0(n, l, k, j, i) += b * du;
+        }
+      });
+  return TaskStatus::complete;
+}
+template <typename T>
+TaskStatus Update2NIndependent(T *s0_data, T *s1_data, T *rhs_data,
+                               const LowStorageIntegrator *pint, Real dt, int stage) {
+  return Update2N(std::vector<MetadataFlag>({Metadata::Independent}), s0_data, s1_data,
+                  rhs_data, pint, dt, stage);
+}
+
+// Update2S with rhs the flux divergence of the fluxes of s0, which is computed in the
+// same kernel instead of being written to and read back from a dUdt container. Like
+// FluxDivergence, this applies to all cell centered variables WithFluxes.
+TaskStatus Update2SWithFluxDivergence(MeshData<Real> *s0_data, MeshData<Real> *s1_data,
+                                      const LowStorageIntegrator *pint, Real dt,
+                                      int stage, bool update_s1);
+
+namespace impl {
+// Number of stages that are summed up by a single kernel in SumButcher and
+// UpdateButcher. The packs are passed to the kernel by value, so this bounds the size of
+// its arguments. All tableaux with up to this many stages write their output once.
+constexpr int max_fused_stages = 8;
+
+// out = base + sum_s weights[s] * stages[s], where base is out itself if base_data is
+// null. Stages with zero weight are skipped.
+template <typename F, typename T>
+void WeightedStageSum(const F &flags, const std::shared_ptr<T> &base_data,
+                      const std::vector<std::shared_ptr<T>> &stage_data,
+                      const std::vector<Real> &weights,
+                      const std::shared_ptr<T> &out_data) {
+  using pack_t = std::decay_t<decltype(out_data->PackVariables(flags))>;
+  out_data->MakeWritable(flags);
   const auto &out = out_data->PackVariables(flags);
-  const auto &in = base_data->PackVariables(flags);
   const IndexDomain interior = IndexDomain::interior;
   const IndexRange ib = out_data->GetBoundsI(interior);
   const IndexRange jb = out_data->GetBoundsJ(interior);
   const IndexRange kb = out_data->GetBoundsK(interior);
-  parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, out.GetDim(5) - 1, 0,
-      out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-      KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
-        if (out.IsAllocated(b, l) && in.IsAllocated(b, l)) {
-          out(b, l, k, j, i) = in(b, l, k, j, i);
-        }
-      });
-  for (int prev = 0; prev < stage; ++prev) {
-    Real a = pint->a[stage - 1][prev];
-    const auto &in = stage_data[stage]->PackVariables(flags);
+
+  std::vector<int> active;
+  for (int s = 0; s < static_cast<int>(weights.size()); ++s) {
+    if (weights[s] != 0.0) active.push_back(s);
+  }
+  if (base_data == nullptr && active.empty()) return;
+  // the first kernel reads base, any later ones accumulate into out
+  bool from_base = (base_data != nullptr);
+  std::size_t first = 0;
+  do {
+    const int nin = std::min<int>(max_fused_stages, active.size() - first);
+    Kokkos::Array<pack_t, max_fused_stages> in;
+    Kokkos::Array<Real, max_fused_stages> w;
+    for (int n = 0; n < nin; ++n) {
+      in[n] = stage_data[active[first + n]]->PackVariables(flags);
+      w[n] = weights[active[first + n]];
+    }
+    const pack_t base = from_base ? base_data->PackVariables(flags) : out;
     parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, out.GetDim(5) - 1,
-        0, out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, out_data->GetExecSpace(), 0,
+        out.GetDim(5) - 1, 0, out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
-          if (out.IsAllocated(b, l) && in.IsAllocated(b, l)) {
-            out(b, l, k, j, i) += dt * a * in(b, l, k, j, i);
+          if (!out.IsAllocated(b, l)) return;
+          Real sum = base.IsAllocated(b, l) ? base(b, l, k, j, i) : out(b, l, k, j, i);
+          for (int n = 0; n < nin; ++n) {
+            if (in[n].IsAllocated(b, l)) sum += w[n] * in[n](b, l, k, j, i);
           }
+          out(b, l, k, j, i) = sum;
         });
+    from_base = false;
+    first += nin;
+  } while (first < active.size());
+}
+} // namespace impl
+
+// For integration with Butcher tableaus
+// returns base + dt * sum_{j=0}^{k-1} a_{kj} S_j
+// for stages S_j
+// This can then be used to compute right-hand sides.
+template <typename F, typename T>
+TaskStatus SumButcher(const F &flags, std::shared_ptr<T> base_data,
+                      std::vector<std::shared_ptr<T>> stage_data,
+                      std::shared_ptr<T> out_data, const ButcherIntegrator *pint, Real dt,
+                      int stage) {
+  PARTHENON_INSTRUMENT
+  std::vector<Real> weights(stage);
+  for (int prev = 0; prev < stage; ++prev) {
+    weights[prev] = dt * pint->a[stage - 1][prev];
   }
+  impl::WeightedStageSum(flags, base_data, stage_data, weights, out_data);
   return TaskStatus::complete;
 }
 template <typename T>
@@ -235,34 +410,101 @@ TaskStatus UpdateButcher(const F &flags, std::vector<std::shared_ptr<T>> stage_d
                          std::shared_ptr<T> out_data, const ButcherIntegrator *pint,
                          Real dt) {
   PARTHENON_INSTRUMENT
+  std::vector<Real> weights(pint->nstages);
+  for (int stage = 0; stage < pint->nstages; ++stage) {
+    weights[stage] = dt * pint->b[stage];
+  }
+  impl::WeightedStageSum(flags, std::shared_ptr<T>(), stage_data, weights, out_data);
+  return TaskStatus::complete;
+}
+template <typename T>
+TaskStatus UpdateButcherIndependent(std::vector<std::shared_ptr<T>> stage_data,
+                                    std::shared_ptr<T> out_data,
+                                    const ButcherIntegrator *pint, Real dt) {
+  return UpdateButcher(std::vector<MetadataFlag>({Metadata::Independent}), stage_data,
+                       out_data, pint, dt);
+}
+
+// The update of the final stage, accumulated as the stages are computed, so that
+// stages can share registers, see ButcherIntegrator::stage_register. Adds
+// dt * b_{stage} S_{stage} to out, which should be set to a copy of base at the
+// beginning of the cycle and be copied to base after the final stage.
+template <typename F, typename T>
+TaskStatus AccumulateButcher(const F &flags, std::shared_ptr<T> stage_data,
+                             std::shared_ptr<T> out_data, const ButcherIntegrator *pint,
+                             Real dt, int stage) {
+  PARTHENON_INSTRUMENT
+  impl::WeightedStageSum(flags, std::shared_ptr<T>(), {stage_data},
+                         {dt * pint->b[stage - 1]}, out_data);
+  return TaskStatus::complete;
+}
+template <typename T>
+TaskStatus AccumulateButcherIndependent(std::shared_ptr<T> stage_data,
+                                        std::shared_ptr<T> out_data,
+                                        const ButcherIntegrator *pint, Real dt,
+                                        int stage) {
+  return AccumulateButcher(std::vector<MetadataFlag>({Metadata::Independent}),
+                           stage_data, out_data, pint, dt, stage);
+}
 
-  const auto &out = out_data->PackVariables(flags);
+// For integrators with an embedded method, after the update at the final stage.
+// Computes the error norm, max |dt * sum_j (b_j - bhat_j) S_j| / (atol + rtol * |u|),
+// of the new solution u in out_data and accumulates it into pint->error, which the
+// driver resets before every step and reduces over all ranks after it.
+template <typename F, typename T>
+TaskStatus EstimateButcherError(const F &flags,
+                                std::vector<std::shared_ptr<T>> stage_data,
+                                std::shared_ptr<T> out_data, ButcherIntegrator *pint,
+                                Real dt) {
+  PARTHENON_INSTRUMENT
+  PARTHENON_REQUIRE(pint->HasEmbeddedMethod(),
+                    "Integrator " + pint->GetName() + " has no embedded method");
+  using pack_t = std::decay_t<decltype(out_data->PackVariables(flags))>;
+  const auto &u = out_data->PackVariables(flags);
   const IndexDomain interior = IndexDomain::interior;
   const IndexRange ib = out_data->GetBoundsI(interior);
   const IndexRange jb = out_data->GetBoundsJ(interior);
   const IndexRange kb = out_data->GetBoundsK(interior);
 
-  const int nstages = pint->nstages;
-  for (int stage = 0; stage < nstages; ++stage) {
-    const Real butcher_b = pint->b[stage];
-    const auto &in = stage_data[stage]->PackVariables(flags);
-    parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, out.GetDim(5) - 1,
-        0, out.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i) {
-          if (out.IsAllocated(b, l) && in.IsAllocated(b, l)) {
-            out(b, l, k, j, i) += dt * b * in(b, l, k, j, i);
-          }
-        });
+  Kokkos::Array<pack_t, impl::max_fused_stages> in;
+  Kokkos::Array<Real, impl::max_fused_stages> w;
+  int nin = 0;
+  for (int s = 0; s < pint->nstages; ++s) {
+    const Real weight = dt * (pint->b[s] - pint->bhat[s]);
+    if (weight == 0.0) continue;
+    PARTHENON_REQUIRE(nin < impl::max_fused_stages,
+                      "Too many stages for the error estimate of " + pint->GetName());
+    in[nin] = stage_data[s]->PackVariables(flags);
+    w[nin] = weight;
+    ++nin;
   }
+  const Real rtol = pint->rtol;
+  const Real atol = pint->atol;
+  Real err = 0.0;
+  parthenon::par_reduce(
+      loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, out_data->GetExecSpace(), 0,
+      u.GetDim(5) - 1, 0, u.GetDim(4) - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int b, const int l, const int k, const int j, const int i,
+                    Real &lerr) {
+        if (!u.IsAllocated(b, l)) return;
+        Real e = 0.0;
+        for (int n = 0; n < nin; ++n) {
+          if (in[n].IsAllocated(b, l)) e += w[n] * in[n](b, l, k, j, i);
+        }
+        const Real scale = atol + rtol * Kokkos::abs(u(b, l, k, j, i));
+        const Real scaled = Kokkos::abs(e) / scale;
+        lerr = (scaled > lerr ? scaled : lerr);
+      },
+      Kokkos::Max<Real>(err));
+  pint->AccumulateError(err);
   return TaskStatus::complete;
 }
-template <typename F, typename T>
-TaskStatus UpdateButcherIndependent(std::vector<std::shared_ptr<T>> stage_data,
-                                    std::shared_ptr<T> out_data,
-                                    const ButcherIntegrator *pint, Real dt) {
-  return UpdateButcherIndependent(std::vector<MetadataFlag>({Metadata::Independent}),
-                                  stage_data, out_data, pint, dt);
+template <typename T>
+TaskStatus EstimateButcherErrorIndependent(std::vector<std::shared_ptr<T>> stage_data,
+                                           std::shared_ptr<T> out_data,
+                                           ButcherIntegrator *pint, Real dt) {
+  return EstimateButcherError(std::vector<MetadataFlag>({Metadata::Independent}),
+                              stage_data, out_data, pint, dt);
 }
 
 template <typename T>
@@ -312,6 +554,36 @@ TaskStatus FillDerived(T *rc) {
   return TaskStatus::complete;
 }
 
+// Fills the derived fields computed on demand, see StateDescriptor::FillDerivedOnDemand,
+// e.g., as the dependency of a task that uses them
+template <typename T>
+TaskStatus FillDerivedOnDemand(T *rc) {
+  PARTHENON_INSTRUMENT
+  auto pm = rc->GetParentPointer();
+  for (const auto &pkg : pm->packages.AllPackages()) {
+    pkg.second->FillDerivedOnDemand(rc);
+  }
+  return TaskStatus::complete;
+}
+
+// Move the Metadata::Evictable variables to host memory after their last use, e.g., in a
+// cycle, and start copying them back before their next use, see
+// MeshBlockData::EvictVariables.  The copy back is asynchronous on the default execution
+// space, so later kernels see the restored data.
+template <typename T>
+TaskStatus EvictVariables(T *rc) {
+  PARTHENON_INSTRUMENT
+  rc->EvictVariables();
+  return TaskStatus::complete;
+}
+
+template <typename T>
+TaskStatus PrefetchVariables(T *rc) {
+  PARTHENON_INSTRUMENT
+  rc->RestoreVariables();
+  return TaskStatus::complete;
+}
+
 template <typename T>
 TaskStatus InitNewlyAllocatedVars(T *rc) {
   PARTHENON_INSTRUMENT
@@ -335,7 +607,7 @@ TaskStatus InitNewlyAllocatedVars(T *rc) {
 
     Kokkos::parallel_for(
         PARTHENON_AUTO_LABEL,
-        Kokkos::TeamPolicy<>(parthenon::DevExecSpace(), v.GetNBlocks(), Kokkos::AUTO),
+        Kokkos::TeamPolicy<>(rc->GetExecSpace(), v.GetNBlocks(), Kokkos::AUTO),
         KOKKOS_LAMBDA(parthenon::team_mbr_t team_member) {
           const int b = team_member.league_rank();
           int lo = v.GetLowerBound(b, variable_names::any());
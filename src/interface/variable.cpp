@@ -16,6 +16,7 @@
 #include <iostream>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "interface/metadata.hpp"
@@ -24,6 +25,7 @@
 #include "parthenon_arrays.hpp"
 #include "utils/array_to_tuple.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/nan_payload_tag.hpp"
 
 namespace parthenon {
 
@@ -38,6 +40,7 @@ Variable<T>::Variable(const std::string &base_name, const Metadata &metadata,
   PARTHENON_REQUIRE_THROWS(IsSparse() == (sparse_id_ != InvalidSparseID),
                            "Mismatch between sparse flag and sparse ID");
   uid_ = get_uid_(label());
+  if (auto pmb = wpmb.lock()) alloc_epoch_ = pmb->alloc_epoch_;
 
   if (m_.getAssociated() == "") {
     m_.Associate(label());
@@ -75,29 +78,39 @@ void Variable<T>::CopyFluxesAndBdryVar(const Variable<T> *src) {
     // fluxes, coarse buffers, etc., are always a copy
     // Rely on reference counting and shallow copy of kokkos views
     flux_data_ = src->flux_data_; // reference counted
+    flux_chunk_ = src->flux_chunk_;
     int n_outer = 1 + (GetDim(2) > 1) * (1 + (GetDim(3) > 1));
     for (int i = X1DIR; i <= n_outer; i++) {
       flux[i] = src->flux[i]; // these are subviews
     }
   }
 
-  if (IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
-      IsSet(Metadata::ForceRemeshComm)) {
+  if (HasCoarseBuffer_()) {
     // no need to check mesh->multilevel, if false, we're just making a shallow copy of
     // an empty ParArrayND
     coarse_s = src->coarse_s;
+    coarse_chunk_ = src->coarse_chunk_;
   }
 }
 
 template <typename T>
-std::shared_ptr<Variable<T>> Variable<T>::AllocateCopy(std::weak_ptr<MeshBlock> wpmb) {
+std::shared_ptr<Variable<T>> Variable<T>::AllocateCopy(std::weak_ptr<MeshBlock> wpmb,
+                                                       bool copy_on_write) {
   // copy the Metadata
   Metadata m = m_;
 
   // make the new Variable
   auto cv = std::make_shared<Variable<T>>(base_name_, m, sparse_id_, wpmb);
 
-  if (is_allocated_) {
+  if (is_allocated_ && copy_on_write) {
+    if (!cow_token_) cow_token_ = std::make_shared<int>();
+    cv->data = data;
+    cv->data_chunk_ = data_chunk_;
+    cv->cow_token_ = cow_token_;
+    cv->owns_data_ = false;
+    ++cv->num_alloc_;
+    cv->is_allocated_ = true;
+  } else if (is_allocated_) {
     cv->AllocateData(wpmb);
   }
 
@@ -121,10 +134,11 @@ void Variable<T>::AllocateData(MeshBlock *pmb, bool flag_uninitialized) {
   PARTHENON_REQUIRE_THROWS(
       !is_allocated_,
       "Tried to allocate data for variable that's already allocated: " + label());
-  data = std::make_from_tuple<ParArrayND<T, VariableState>>(std::tuple_cat(
-      std::make_tuple(label(), MakeVariableState()), ArrayToReverseTuple(dims_)));
+  data = NewArray(pmb, label(), dims_, data_chunk_,
+                  !IsSet(Metadata::WithoutInitialization));
 
   ++num_alloc_;
+  ++*alloc_epoch_;
 
   data.initialized = !flag_uninitialized;
   is_allocated_ = true;
@@ -139,6 +153,117 @@ void Variable<T>::AllocateData(std::weak_ptr<MeshBlock> wpmb, bool flag_uninitia
   AllocateData(wpmb.lock().get(), flag_uninitialized);
 }
 
+template <typename T>
+void Variable<T>::AllocateDataAt(MeshBlock *pmb, std::shared_ptr<void> chunk, T *ptr) {
+  PARTHENON_REQUIRE_THROWS(
+      !is_allocated_,
+      "Tried to allocate data for variable that's already allocated: " + label());
+  data = ViewAt(ptr, dims_, MakeVariableState());
+  data_chunk_ = std::move(chunk);
+
+  ++num_alloc_;
+  ++*alloc_epoch_;
+
+  data.initialized = true;
+  is_allocated_ = true;
+
+  if (pmb != nullptr) {
+    pmb->LogMemUsage(data.size() * sizeof(T));
+  }
+}
+
+template <typename T>
+void Variable<T>::RebindData(std::shared_ptr<void> chunk, T *ptr) {
+  PARTHENON_REQUIRE_THROWS(is_allocated_,
+                           "Tried to rebind data of unallocated variable " + label());
+  data = ViewAt(ptr, dims_, data);
+  data_chunk_ = std::move(chunk);
+  ++*alloc_epoch_;
+}
+
+template <typename T>
+void Variable<T>::MakeWritable(MeshBlock *pmb) {
+  if (!is_allocated_ || !SharesData()) return;
+  auto shared = data;
+  // the shared memory stays alive through the other variables sharing it
+  data = NewArray(pmb, label(), dims_, data_chunk_, false);
+  data.initialized = shared.initialized;
+  data.DeepCopy(shared);
+  cow_token_.reset();
+  // packs holding views of the shared data have to be rebuilt
+  ++num_alloc_;
+  ++*alloc_epoch_;
+  if (pmb != nullptr && !owns_data_) pmb->LogMemUsage(data.size() * sizeof(T));
+  owns_data_ = true;
+}
+
+template <typename T>
+std::int64_t Variable<T>::Evict() {
+  // nothing to gain if the data is in host memory anyway, and shared data stays alive
+  // through the other variables sharing it
+  if constexpr (Kokkos::SpaceAccessibility<Kokkos::HostSpace, DevMemSpace>::accessible) {
+    return 0;
+  }
+  if (!is_allocated_ || evicted_ || SharesData()) return 0;
+  const std::size_t n = data.size();
+  if (host_data_.size() != n) {
+    host_data_ = Kokkos::View<T *, HostPinnedMemSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, label() + "::evicted"), n);
+  }
+  using unmanaged_t = Kokkos::View<T *, DevMemSpace, Kokkos::MemoryUnmanaged>;
+  Kokkos::deep_copy(host_data_, unmanaged_t(data.data(), n));
+  data.Reset();
+  data_chunk_.reset();
+  evicted_ = true;
+  ++*alloc_epoch_;
+  return n * sizeof(T);
+}
+
+template <typename T>
+void Variable<T>::Restore(MeshBlock *pmb) {
+  if (!evicted_) return;
+  const bool initialized = data.initialized;
+  data = NewArray(pmb, label(), dims_, data_chunk_, false);
+  data.initialized = initialized;
+  using unmanaged_t = Kokkos::View<T *, DevMemSpace, Kokkos::MemoryUnmanaged>;
+  Kokkos::deep_copy(DevExecSpace(), unmanaged_t(data.data(), data.size()), host_data_);
+  // the data may next be used on the execution space instance of another partition
+  DevExecSpace().fence();
+  evicted_ = false;
+  ++num_alloc_;
+  ++*alloc_epoch_;
+  if (pmb != nullptr) pmb->LogMemUsage(data.size() * sizeof(T));
+}
+
+template <typename T>
+ParArrayND<T, VariableState>
+Variable<T>::NewArray(MeshBlock *pmb, const std::string &label,
+                      const std::array<int, MAX_VARIABLE_DIMENSION> &dims,
+                      std::shared_ptr<void> &chunk, const bool initialize) const {
+  std::size_t n = 1;
+  for (const auto d : dims) {
+    n *= d;
+  }
+  if constexpr (std::is_same_v<T, Real>) {
+    if (pmb != nullptr && pmb->pmy_mesh != nullptr && pmb->pmy_mesh->variable_pool) {
+      auto handle = pmb->pmy_mesh->variable_pool->Get(n, initialize);
+      chunk = handle;
+      return ViewAt(handle->data(), dims, MakeVariableState());
+    }
+  }
+  if (!initialize) {
+    using chunk_t = Kokkos::View<T *, DevMemSpace>;
+    auto handle = std::make_shared<chunk_t>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, label), n);
+    FillUninitialized(*handle);
+    chunk = handle;
+    return ViewAt(handle->data(), dims, MakeVariableState());
+  }
+  chunk.reset();
+  return std::make_from_tuple<ParArrayND<T, VariableState>>(std::tuple_cat(
+      std::make_tuple(label, MakeVariableState()), ArrayToReverseTuple(dims)));
+}
+
 /// allocate communication space based on info in MeshBlock
 /// Initialize a 6D variable
 template <typename T>
@@ -160,9 +285,8 @@ void Variable<T>::AllocateFluxesAndCoarse(std::weak_ptr<MeshBlock> wpmb) {
     auto dims_flux = dims_;
     // A nodal field is the appropriate flux field for an edge variable
     dims_flux[MAX_VARIABLE_DIMENSION - 1] = n_outer;
-    flux_data_ = std::make_from_tuple<ParArrayND<T, VariableState>>(
-        std::tuple_cat(std::make_tuple(label() + ".flux_data", MakeVariableState()),
-                       ArrayToReverseTuple(dims_flux)));
+    flux_data_ =
+        NewArray(wpmb.lock().get(), label() + ".flux_data", dims_flux, flux_chunk_);
     // set up fluxes
     for (int d = X1DIR; d <= n_outer; ++d) {
       flux[d] = flux_data_.Get(std::make_pair(d - 1, d));
@@ -173,20 +297,46 @@ void Variable<T>::AllocateFluxesAndCoarse(std::weak_ptr<MeshBlock> wpmb) {
   }
 
   // Create the boundary object
-  if (IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
-      IsSet(Metadata::ForceRemeshComm)) {
+  if (HasCoarseBuffer_()) {
     if (wpmb.expired()) return;
     std::shared_ptr<MeshBlock> pmb = wpmb.lock();
 
-    if (pmb->pmy_mesh != nullptr && pmb->pmy_mesh->multilevel) {
-      coarse_s = std::make_from_tuple<ParArrayND<T, VariableState>>(
-          std::tuple_cat(std::make_tuple(label() + ".coarse", MakeVariableState()),
-                         ArrayToReverseTuple(coarse_dims_)));
+    if (pmb->pmy_mesh != nullptr && pmb->pmy_mesh->multilevel &&
+        pmb->HasCoarseBuffers()) {
+      coarse_s = NewArray(pmb.get(), label() + ".coarse", coarse_dims_, coarse_chunk_);
       pmb->LogMemUsage(coarse_s.size() * sizeof(T));
     }
   }
 }
 
+template <typename T>
+std::int64_t Variable<T>::SetCoarseBuffer(MeshBlock *pmb, const bool allocate) {
+  if (!IsAllocated() || !HasCoarseBuffer_() || allocate == coarse_s.IsAllocated())
+    return 0;
+  std::int64_t mem_size = 0;
+  if (allocate) {
+    coarse_s = NewArray(pmb, label() + ".coarse", coarse_dims_, coarse_chunk_);
+    mem_size = coarse_s.size() * sizeof(T);
+  } else {
+    mem_size = -static_cast<std::int64_t>(coarse_s.size() * sizeof(T));
+    coarse_s.Reset();
+    coarse_chunk_.reset();
+  }
+  // caches holding views of the coarse buffer have to be rebuilt
+  ++num_alloc_;
+  ++*alloc_epoch_;
+  return mem_size;
+}
+
+template <typename T>
+void Variable<T>::ShareCoarseBuffer(const Variable<T> *src) {
+  if (!HasCoarseBuffer_() || coarse_s.data() == src->coarse_s.data()) return;
+  coarse_s = src->coarse_s;
+  coarse_chunk_ = src->coarse_chunk_;
+  ++num_alloc_;
+  ++*alloc_epoch_;
+}
+
 template <typename T>
 std::int64_t Variable<T>::Deallocate() {
   std::int64_t mem_size = 0;
@@ -195,25 +345,32 @@ std::int64_t Variable<T>::Deallocate() {
     return 0;
   }
 
-  mem_size += data.size() * sizeof(T);
+  if (owns_data_) mem_size += data.size() * sizeof(T);
   data.Reset();
+  data_chunk_.reset();
+  host_data_ = Kokkos::View<T *, HostPinnedMemSpace>();
+  evicted_ = false;
+  cow_token_.reset();
+  owns_data_ = true;
 
   if (IsSet(Metadata::WithFluxes)) {
     mem_size += flux_data_.size() * sizeof(T);
     flux_data_.Reset();
+    flux_chunk_.reset();
     int n_outer = 1 + (GetDim(2) > 1) * (1 + (GetDim(3) > 1));
     for (int d = X1DIR; d <= n_outer; ++d) {
       flux[d].Reset();
     }
   }
 
-  if (IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
-      IsSet(Metadata::ForceRemeshComm)) {
+  if (HasCoarseBuffer_()) {
     mem_size += coarse_s.size() * sizeof(T);
     coarse_s.Reset();
+    coarse_chunk_.reset();
   }
 
   is_allocated_ = false;
+  ++*alloc_epoch_;
   return mem_size;
 #else
   PARTHENON_THROW("Variable<T>::Deallocate(): Sparse is compile-time disabled");
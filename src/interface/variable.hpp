@@ -32,6 +32,7 @@
 #include <memory>
 #include <regex>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -44,6 +45,7 @@
 #include "interface/var_id.hpp"
 #include "parthenon_arrays.hpp"
 #include "prolong_restrict/prolong_restrict.hpp"
+#include "utils/array_to_tuple.hpp"
 #include "utils/error_checking.hpp"
 #include "utils/unique_id.hpp"
 
@@ -68,8 +70,10 @@ class Variable {
   // copy fluxes and boundary variable from src Variable (shallow copy)
   void CopyFluxesAndBdryVar(const Variable<T> *src);
 
-  // make a new Variable based on an existing one
-  std::shared_ptr<Variable<T>> AllocateCopy(std::weak_ptr<MeshBlock> wpmb);
+  // make a new Variable based on an existing one.  With copy_on_write, the new Variable
+  // shares the data of this one until either of them is made writable.
+  std::shared_ptr<Variable<T>> AllocateCopy(std::weak_ptr<MeshBlock> wpmb,
+                                            bool copy_on_write = false);
 
   // accessors
   template <class... Args>
@@ -146,6 +150,16 @@ class Variable {
     return num_alloc_;
   }
 
+  // whether data is shared with a copy-on-write copy of this variable (or the variable
+  // this one is a copy-on-write copy of), see MakeWritable
+  bool SharesData() const { return cow_token_.use_count() > 1; }
+
+  // the array holding the fluxes in all directions, which flux[1], ... are views into
+  const ParArrayND<T> &FluxData() const { return flux_data_; }
+
+  // whether data has been moved to host memory by Evict and is empty until Restore
+  bool IsEvicted() const { return evicted_; }
+
   std::vector<TopologicalElement> GetTopologicalElements() const {
     using TE = TopologicalElement;
     if (IsSet(Metadata::Face)) return {TE::F1, TE::F2, TE::F3};
@@ -162,6 +176,18 @@ class Variable {
   // allocate data only
   void AllocateData(MeshBlock *pmb, bool flag_uninitialized = false);
   void AllocateData(std::weak_ptr<MeshBlock> wpmb, bool flag_uninitialized = false);
+  // allocate data as a view of the memory at ptr, which is owned by chunk, e.g. a slab
+  // holding the data of all dense variables of a block
+  void AllocateDataAt(MeshBlock *pmb, std::shared_ptr<void> chunk, T *ptr);
+  // move allocated data to the memory at ptr, owned by chunk, without copying it
+  void RebindData(std::shared_ptr<void> chunk, T *ptr);
+  // if data is shared, move this variable to its own copy of it
+  void MakeWritable(MeshBlock *pmb);
+  // copy data to host memory and free it on the device.  Returns the memory freed in
+  // bytes.  Fluxes and coarse buffers are kept.
+  std::int64_t Evict();
+  // reallocate the data of an evicted variable and (asynchronously) copy it back
+  void Restore(MeshBlock *pmb);
 
   // deallocate data, fluxes, and boundary variable
   std::int64_t Deallocate();
@@ -170,8 +196,38 @@ class Variable {
   /// (Metadata::FillGhost is set)
   void AllocateFluxesAndCoarse(std::weak_ptr<MeshBlock> wpmb);
 
+  // whether this variable has a coarse buffer on multilevel meshes
+  bool HasCoarseBuffer_() const {
+    return IsSet(Metadata::FillGhost) || IsSet(Metadata::Independent) ||
+           IsSet(Metadata::ForceRemeshComm);
+  }
+  // allocate or free the coarse buffer of an allocated variable on demand, see
+  // MeshBlock::SetCoarseBuffers.  Returns the change of the memory used in bytes.
+  std::int64_t SetCoarseBuffer(MeshBlock *pmb, bool allocate);
+  // use the coarse buffer of src, i.e., of this variable in another stage that it
+  // shared its coarse buffer with
+  void ShareCoarseBuffer(const Variable<T> *src);
+
   VariableState MakeVariableState() const { return VariableState(m_, sparse_id_, dims_); }
 
+  // An unmanaged array of shape dims at ptr
+  ParArrayND<T, VariableState>
+  ViewAt(T *ptr, const std::array<int, MAX_VARIABLE_DIMENSION> &dims,
+         const VariableState &state) const {
+    return ParArrayND<T, VariableState>(
+        std::make_from_tuple<device_view_t<T>>(
+            std::tuple_cat(std::make_tuple(ptr), ArrayToReverseTuple(dims))),
+        state);
+  }
+
+  // A new array of shape dims, taken from the Mesh::variable_pool of pmb if there is
+  // one, in which case chunk is set to the handle that owns its memory.  Unless
+  // initialize is set, the array is not zeroed, see FillUninitialized.
+  ParArrayND<T, VariableState>
+  NewArray(MeshBlock *pmb, const std::string &label,
+           const std::array<int, MAX_VARIABLE_DIMENSION> &dims,
+           std::shared_ptr<void> &chunk, const bool initialize = true) const;
+
   Metadata m_;
   const std::string base_name_;
   const int sparse_id_;
@@ -184,9 +240,24 @@ class Variable {
   // This generator needs to be global so that different instances of
   // variable have the same unique ID.
   inline static UniqueIDGenerator<std::string> get_uid_;
+  // the counter of MeshBlock::AllocationEpoch of the block this variable was created on
+  // (or of its own if there is none), which is incremented whenever the data of this
+  // variable is allocated, deallocated or moved
+  std::shared_ptr<std::uint64_t> alloc_epoch_ = std::make_shared<std::uint64_t>(0);
 
   bool is_allocated_ = false;
   ParArrayND<T> flux_data_; // unified par array for the fluxes
+  // owners of the pooled (or slab) memory of data, flux_data_ and coarse_s, see NewArray
+  std::shared_ptr<void> data_chunk_, flux_chunk_, coarse_chunk_;
+  // held by all variables that share data after a copy-on-write AllocateCopy
+  std::shared_ptr<int> cow_token_;
+  // false for copy-on-write copies, whose data is not part of the memory usage of the
+  // block until they are made writable
+  bool owns_data_ = true;
+  // the data while evicted, kept afterwards to be reused by the next eviction.  Pinned,
+  // so that copying it back in Restore is asynchronous.
+  Kokkos::View<T *, HostPinnedMemSpace> host_data_;
+  bool evicted_ = false;
 };
 
 template <typename T>
@@ -290,6 +361,31 @@ using VarPtr = std::shared_ptr<Variable<T>>;
 template <typename T>
 using MapToVars = std::map<std::string, std::shared_ptr<Variable<T>>>;
 
+// Variables indexed by their unique id.  Unique ids are handed out consecutively per
+// label (see UniqueIDGenerator), so a flat table is small and lookups don't search.
+template <typename T>
+class UidToVars {
+ public:
+  void Insert(const std::shared_ptr<Variable<T>> &var) {
+    const Uid_t uid = var->GetUniqueID();
+    if (uid >= vars_.size()) vars_.resize(uid + 1);
+    vars_[uid] = var;
+  }
+  void clear() { vars_.clear(); }
+  std::size_t count(const Uid_t uid) const {
+    return (uid < vars_.size() && vars_[uid] != nullptr) ? 1 : 0;
+  }
+  const std::shared_ptr<Variable<T>> &at(const Uid_t uid) const {
+    if (count(uid) == 0) {
+      throw std::out_of_range("No variable with unique id " + std::to_string(uid));
+    }
+    return vars_[uid];
+  }
+
+ private:
+  std::vector<std::shared_ptr<Variable<T>>> vars_;
+};
+
 template <typename T>
 using ParticleVarPtr = std::shared_ptr<ParticleVariable<T>>;
 template <typename T>
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <forward_list>
 #include <map>
 #include <memory>
@@ -35,6 +36,7 @@
 #include "kokkos_abstraction.hpp"
 #include "mesh/domain.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/hash.hpp"
 #include "utils/unique_id.hpp"
 
 namespace parthenon {
@@ -133,6 +135,21 @@ using VPackKey_t = std::vector<Uid_t>;
 // and order matters. So a pair forms the keys for the FluxPack cache.
 using StringPair = std::pair<std::vector<std::string>, std::vector<std::string>>;
 using UidVecPair = std::pair<std::vector<Uid_t>, std::vector<Uid_t>>;
+
+// Hash of the keys of the pack caches, so that looking up a pack does not have to
+// compare the keys lexicographically along a tree
+struct KeyHash {
+  std::size_t operator()(const VPackKey_t &key) const {
+    std::size_t hash = key.size();
+    for (const auto &uid : key) {
+      hash = impl::hash_combine(hash, uid);
+    }
+    return hash;
+  }
+  std::size_t operator()(const UidVecPair &key) const {
+    return impl::hash_combine((*this)(key.first), (*this)(key.second));
+  }
+};
 } // namespace vpack_types
 
 // helper class to make lists of variables with some kind of unique identifier per
@@ -486,19 +503,17 @@ class VariableFluxPack : public VariablePack<T> {
   const std::vector<int> *flux_alloc_status_;
 };
 
-// Using std::map, not std::unordered_map because the key
-// would require a custom hashing function. Note this is slower: O(log(N))
-// instead of O(1).
-// Unfortunately, std::pair doesn't work. So I have to roll my own.
-// It appears to be an interaction caused by a std::map<key,std::pair>
-// Possibly it's a compiler bug. gcc/7.4.0
-// ~JMM
+// A cached pack, together with the allocation status of its variables when it was
+// built.  alloc_epoch is the AllocationEpoch of the container at which that status was
+// last seen to be current: as long as no variable of its blocks has been (de)allocated
+// since, the pack is valid without comparing the status.
 template <typename PackType>
 struct PackAndIndexMap {
   PackType pack;
   PackIndexMap map;
   std::vector<int> alloc_status;
   std::vector<int> flux_alloc_status;
+  std::uint64_t alloc_epoch;
 };
 
 template <typename T>
@@ -508,11 +523,16 @@ using FluxPackIndxPair = PackAndIndexMap<VariableFluxPack<T>>;
 template <typename T>
 using SwarmPackIndxPair = PackAndIndexMap<SwarmVariablePack<T>>;
 template <typename T>
-using MapToVariablePack = std::map<std::vector<Uid_t>, PackIndxPair<T>>;
+using MapToVariablePack = std::unordered_map<vpack_types::VPackKey_t, PackIndxPair<T>,
+                                             vpack_types::KeyHash>;
 template <typename T>
-using MapToVariableFluxPack = std::map<vpack_types::UidVecPair, FluxPackIndxPair<T>>;
+using MapToVariableFluxPack =
+    std::unordered_map<vpack_types::UidVecPair, FluxPackIndxPair<T>,
+                       vpack_types::KeyHash>;
 template <typename T>
-using MapToSwarmVariablePack = std::map<std::vector<Uid_t>, SwarmPackIndxPair<T>>;
+using MapToSwarmVariablePack =
+    std::unordered_map<vpack_types::VPackKey_t, SwarmPackIndxPair<T>,
+                       vpack_types::KeyHash>;
 
 template <typename T>
 void AppendSparseBaseMap(const VariableVector<T> &vars, PackIndexMap *pvmap) {
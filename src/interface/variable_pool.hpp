@@ -0,0 +1,154 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef INTERFACE_VARIABLE_POOL_HPP_
+#define INTERFACE_VARIABLE_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "kokkos_abstraction.hpp"
+#include "utils/nan_payload_tag.hpp"
+
+namespace parthenon {
+
+// Recycles the device memory of the data, fluxes and coarse buffers of Variables, so
+// that the blocks created by remeshing reuse the memory of the blocks they replace
+// instead of going through the device allocator.  Chunks are keyed by their number of
+// elements, i.e., all arrays of the same size share a free list regardless of their
+// shape.  A chunk returns to the pool when the last copy of the handle returned by Get
+// is destroyed, and it is zeroed before being handed out again, just like a newly
+// allocated View.  Views into a chunk don't own it, so they must not be used after the
+// handle is gone.  If the pool is destroyed first, chunks are freed with their handle.
+//
+// Chunks whose data is overwritten right away can be taken with zero = false, which
+// skips zeroing them (and fills them with NaNs in debug builds, see FillUninitialized).
+//
+// While a Batch is alive, chunks are zeroed together by a single kernel when the
+// (outermost) batch ends rather than one by one, e.g., when many sparse variables are
+// allocated at once.  Chunks taken inside a batch must not be read before it ends.
+//
+// Chunks are zeroed on the default execution space instance, while the Variables using
+// them may be accessed on the instance of their partition (see Mesh::GetExecSpace).
+// Before a released chunk is reused all instances are fenced, so that no kernel still
+// accesses it, and the default instance is fenced after zeroing.
+template <typename T>
+class VariableMemoryPool : public std::enable_shared_from_this<VariableMemoryPool<T>> {
+ public:
+  using chunk_t = Kokkos::View<T *, DevMemSpace>;
+  using handle_t = std::shared_ptr<chunk_t>;
+
+  class Batch {
+   public:
+    explicit Batch(std::shared_ptr<VariableMemoryPool> pool) : pool_(std::move(pool)) {
+      if (pool_) ++pool_->batch_depth_;
+    }
+    ~Batch() {
+      if (pool_ && --pool_->batch_depth_ == 0) pool_->ZeroPending();
+    }
+    Batch(const Batch &) = delete;
+    Batch &operator=(const Batch &) = delete;
+
+   private:
+    std::shared_ptr<VariableMemoryPool> pool_;
+  };
+
+  // a zeroed chunk of n elements, or an uninitialized one if zero is false
+  handle_t Get(const std::size_t n, const bool zero = true) {
+    chunk_t chunk;
+    auto &free = free_[n];
+    if (free.empty()) {
+      chunk = chunk_t(Kokkos::view_alloc(Kokkos::WithoutInitializing, "pooled variable"),
+                      n);
+    } else {
+      chunk = std::move(free.back());
+      free.pop_back();
+      pooled_bytes_ -= n * sizeof(T);
+      if (released_since_fence_) {
+        Kokkos::fence("VariableMemoryPool::Get");
+        released_since_fence_ = false;
+      }
+    }
+    if (!zero) {
+      FillUninitialized(chunk);
+    } else if (batch_depth_ > 0) {
+      pending_.push_back(chunk);
+    } else {
+      Kokkos::deep_copy(DevExecSpace(), chunk, T());
+      DevExecSpace().fence();
+    }
+    std::weak_ptr<VariableMemoryPool> wpool = this->weak_from_this();
+    return handle_t(new chunk_t(std::move(chunk)), [wpool](chunk_t *c) {
+      if (auto pool = wpool.lock()) pool->Release(std::move(*c));
+      delete c;
+    });
+  }
+
+  // memory held by the pool that is not in use by any Variable
+  std::uint64_t SizeInBytes() const { return pooled_bytes_; }
+
+  // free all chunks that are not in use
+  void Clear() {
+    free_.clear();
+    pooled_bytes_ = 0;
+  }
+
+ private:
+  struct Span {
+    T *ptr;
+    std::size_t size;
+  };
+
+  void Release(chunk_t &&chunk) {
+    pooled_bytes_ += chunk.size() * sizeof(T);
+    free_[chunk.size()].push_back(std::move(chunk));
+    released_since_fence_ = true;
+  }
+
+  // zero all chunks taken during a batch, one team per chunk
+  void ZeroPending() {
+    const int nchunks = pending_.size();
+    if (nchunks == 0) return;
+    Kokkos::View<Span *, DevMemSpace> spans("pending chunks", nchunks);
+    auto spans_h = Kokkos::create_mirror_view(spans);
+    for (int c = 0; c < nchunks; ++c) {
+      spans_h(c) = Span{pending_[c].data(), pending_[c].size()};
+    }
+    Kokkos::deep_copy(DevExecSpace(), spans, spans_h);
+    Kokkos::parallel_for(
+        "VariableMemoryPool::ZeroPending",
+        Kokkos::TeamPolicy<>(DevExecSpace(), nchunks, Kokkos::AUTO),
+        KOKKOS_LAMBDA(team_mbr_t team_member) {
+          const Span span = spans(team_member.league_rank());
+          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, span.size),
+                               [&](const std::size_t i) { span.ptr[i] = T(); });
+        });
+    DevExecSpace().fence();
+    pending_.clear();
+  }
+
+  std::unordered_map<std::size_t, std::vector<chunk_t>> free_;
+  std::uint64_t pooled_bytes_ = 0;
+  int batch_depth_ = 0;
+  // whether a kernel on any instance may still access a chunk in free_
+  bool released_since_fence_ = false;
+  // chunks taken during a batch that still have to be zeroed
+  std::vector<chunk_t> pending_;
+};
+
+} // namespace parthenon
+
+#endif // INTERFACE_VARIABLE_POOL_HPP_
@@ -20,6 +20,8 @@
 #ifndef KOKKOS_ABSTRACTION_HPP_
 #define KOKKOS_ABSTRACTION_HPP_
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -30,6 +32,9 @@
 #include "parthenon_array_generic.hpp"
 #include "utils/error_checking.hpp"
 #include "utils/instrument.hpp"
+#include "utils/kernel_costs.hpp"
+#include "utils/launch_config.hpp"
+#include "utils/loop_autotune.hpp"
 #include "utils/object_pool.hpp"
 
 namespace parthenon {
@@ -61,6 +66,15 @@ using BufMemSpace = Kokkos::Experimental::HipHostPinnedSpace::memory_space;
 using BufMemSpace = Kokkos::DefaultExecutionSpace::memory_space;
 #endif
 
+// Host memory that the device can copy from and to asynchronously
+#if defined(KOKKOS_ENABLE_CUDA)
+using HostPinnedMemSpace = Kokkos::CudaHostPinnedSpace::memory_space;
+#elif defined(KOKKOS_ENABLE_HIP)
+using HostPinnedMemSpace = Kokkos::Experimental::HipHostPinnedSpace::memory_space;
+#else
+using HostPinnedMemSpace = Kokkos::HostSpace;
+#endif
+
 // MPI communication buffers
 template <typename T>
 using BufArray1D = Kokkos::View<T *, LayoutWrapper, BufMemSpace>;
@@ -138,22 +152,39 @@ static struct LoopPatternSimdFor {
 // care of the (hidden) 1D index to `n`, `k`, `j`, `i indices conversion
 static struct LoopPatternFlatRange {
 } loop_pattern_flatrange_tag;
+// The MDRange and TeamPolicy patterns take the Kokkos::LaunchBounds of their policy as
+// template parameters, e.g., LoopPatternMDRangeBounded<128, 2>() limits the threads
+// per block to let the compiler use more registers.  Tile sizes, team sizes and
+// vector lengths are set per kernel label at runtime, see LaunchConfigs.
+
 // Translates to a Kokkos multi dimensional  range (Kokkos::MDRangePolicy) with
 // a 1:1 indices matching
-static struct LoopPatternMDRange {
-} loop_pattern_mdrange_tag;
+template <unsigned int MaxThreads = 0, unsigned int MinBlocks = 0>
+struct LoopPatternMDRangeBounded {};
+using LoopPatternMDRange = LoopPatternMDRangeBounded<>;
+static LoopPatternMDRange loop_pattern_mdrange_tag;
 // Translates to a Kokkos::TeamPolicy with a single inner
 // Kokkos::TeamThreadRange
-static struct LoopPatternTPTTR {
-} loop_pattern_tpttr_tag;
+template <unsigned int MaxThreads = 0, unsigned int MinBlocks = 0>
+struct LoopPatternTPTTRBounded {};
+using LoopPatternTPTTR = LoopPatternTPTTRBounded<>;
+static LoopPatternTPTTR loop_pattern_tpttr_tag;
 // Translates to a Kokkos::TeamPolicy with a single inner
 // Kokkos::ThreadVectorRange
-static struct LoopPatternTPTVR {
-} loop_pattern_tptvr_tag;
+template <unsigned int MaxThreads = 0, unsigned int MinBlocks = 0>
+struct LoopPatternTPTVRBounded {};
+using LoopPatternTPTVR = LoopPatternTPTVRBounded<>;
+static LoopPatternTPTVR loop_pattern_tptvr_tag;
 // Translates to a Kokkos::TeamPolicy with a middle Kokkos::TeamThreadRange and
 // inner Kokkos::ThreadVectorRange
-static struct LoopPatternTPTTRTVR {
-} loop_pattern_tpttrtvr_tag;
+template <unsigned int MaxThreads = 0, unsigned int MinBlocks = 0>
+struct LoopPatternTPTTRTVRBounded {};
+using LoopPatternTPTTRTVR = LoopPatternTPTTRTVRBounded<>;
+static LoopPatternTPTTRTVR loop_pattern_tpttrtvr_tag;
+// Chooses one of the patterns above at runtime for every kernel name and loop extent,
+// see LoopAutotuner.  Only 3D and 4D loops are tuned.
+static struct LoopPatternAutotune {
+} loop_pattern_autotune_tag;
 // Used to catch undefined behavior as it results in throwing an error
 static struct LoopPatternUndefined {
 } loop_pattern_undefined_tag;
@@ -199,6 +230,45 @@ inline void kokkos_dispatch(ParallelScanDispatch, Args &&...args) {
   Kokkos::parallel_scan(std::forward<Args>(args)...);
 }
 
+// An MDRangePolicy over [lower, upper) with tiles of a single row in the innermost
+// dimension, unless the LaunchConfig of name sets other tile sizes
+template <int Rank, unsigned int MaxThreads, unsigned int MinBlocks>
+inline auto MakeMDRangePolicy(const std::string &name, DevExecSpace exec_space,
+                              const Kokkos::Array<int, Rank> &lower,
+                              const Kokkos::Array<int, Rank> &upper) {
+  using policy_t = Kokkos::MDRangePolicy<Kokkos::Rank<Rank>,
+                                         Kokkos::LaunchBounds<MaxThreads, MinBlocks>>;
+  typename policy_t::point_type lo, up;
+  typename policy_t::tile_type tile;
+  const LaunchConfig *config = LaunchConfigs::Find(name);
+  for (int d = 0; d < Rank; ++d) {
+    lo[d] = lower[d];
+    up[d] = upper[d];
+    const int default_size = d == Rank - 1 ? upper[d] - lower[d] : 1;
+    tile[d] = config ? config->Tile(Rank, d, default_size) : default_size;
+  }
+  return Kokkos::Experimental::require(
+      policy_t(exec_space, lo, up, tile),
+      Kokkos::Experimental::WorkItemProperty::HintLightWeight);
+}
+
+// A TeamPolicy with league_size teams, with the team size and vector length of the
+// LaunchConfig of name if set and Kokkos::AUTO otherwise
+template <unsigned int MaxThreads, unsigned int MinBlocks>
+inline auto MakeTeamPolicy(const std::string &name, DevExecSpace exec_space,
+                           const int league_size) {
+  using policy_t = Kokkos::TeamPolicy<Kokkos::LaunchBounds<MaxThreads, MinBlocks>>;
+  const LaunchConfig *config = LaunchConfigs::Find(name);
+  const int team_size = config ? config->team_size : 0;
+  const int vector_length = config ? config->vector_length : 0;
+  if (team_size > 0 && vector_length > 0)
+    return policy_t(exec_space, league_size, team_size, vector_length);
+  if (team_size > 0) return policy_t(exec_space, league_size, team_size, Kokkos::AUTO);
+  if (vector_length > 0)
+    return policy_t(exec_space, league_size, Kokkos::AUTO, vector_length);
+  return policy_t(exec_space, league_size, Kokkos::AUTO);
+}
+
 } // namespace dispatch_impl
 
 // 1D loop using RangePolicy loops
@@ -215,17 +285,16 @@ par_dispatch(LoopPatternFlatRange, const std::string &name, DevExecSpace exec_sp
 }
 
 // 2D loop using MDRange loops
-template <typename Tag, typename Function, class... Args>
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function, class... Args>
 inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
-par_dispatch(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
-             const int jl, const int ju, const int il, const int iu,
-             const Function &function, Args &&...args) {
+par_dispatch(LoopPatternMDRangeBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int jl, const int ju, const int il,
+             const int iu, const Function &function, Args &&...args) {
   Tag tag;
   kokkos_dispatch(tag, name,
-                  Kokkos::Experimental::require(
-                      Kokkos::MDRangePolicy<Kokkos::Rank<2>>(
-                          exec_space, {jl, il}, {ju + 1, iu + 1}, {1, iu + 1 - il}),
-                      Kokkos::Experimental::WorkItemProperty::HintLightWeight),
+                  dispatch_impl::MakeMDRangePolicy<2, MaxThreads, MinBlocks>(
+                      name, exec_space, {jl, il}, {ju + 1, iu + 1}),
                   function, std::forward<Args>(args)...);
 }
 
@@ -256,32 +325,32 @@ par_dispatch(LoopPatternFlatRange, const std::string &name, DevExecSpace exec_sp
 }
 
 // 3D loop using MDRange loops
-template <typename Tag, typename Function, class... Args>
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function, class... Args>
 inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
-par_dispatch(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
-             const int &kl, const int &ku, const int &jl, const int &ju, const int &il,
-             const int &iu, const Function &function, Args &&...args) {
+par_dispatch(LoopPatternMDRangeBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int &kl, const int &ku, const int &jl,
+             const int &ju, const int &il, const int &iu, const Function &function,
+             Args &&...args) {
   Tag tag;
   kokkos_dispatch(tag, name,
-                  Kokkos::Experimental::require(
-                      Kokkos::MDRangePolicy<Kokkos::Rank<3>>(exec_space, {kl, jl, il},
-                                                             {ku + 1, ju + 1, iu + 1},
-                                                             {1, 1, iu + 1 - il}),
-                      Kokkos::Experimental::WorkItemProperty::HintLightWeight),
+                  dispatch_impl::MakeMDRangePolicy<3, MaxThreads, MinBlocks>(
+                      name, exec_space, {kl, jl, il}, {ku + 1, ju + 1, iu + 1}),
                   function, std::forward<Args>(args)...);
 }
 
 // 3D loop using TeamPolicy with single inner TeamThreadRange
-template <typename Tag, typename Function>
-inline void par_dispatch(LoopPatternTPTTR, const std::string &name,
-                         DevExecSpace exec_space, const int &kl, const int &ku,
-                         const int &jl, const int &ju, const int &il, const int &iu,
-                         const Function &function) {
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function>
+inline void
+par_dispatch(LoopPatternTPTTRBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int &kl, const int &ku, const int &jl,
+             const int &ju, const int &il, const int &iu, const Function &function) {
   const int Nk = ku - kl + 1;
   const int Nj = ju - jl + 1;
   const int NkNj = Nk * Nj;
   Kokkos::parallel_for(
-      name, team_policy(exec_space, NkNj, Kokkos::AUTO),
+      name, dispatch_impl::MakeTeamPolicy<MaxThreads, MinBlocks>(name, exec_space, NkNj),
       KOKKOS_LAMBDA(team_mbr_t team_member) {
         const int k = team_member.league_rank() / Nj + kl;
         const int j = team_member.league_rank() % Nj + jl;
@@ -291,17 +360,18 @@ inline void par_dispatch(LoopPatternTPTTR, const std::string &name,
 }
 
 // 3D loop using TeamPolicy with single inner ThreadVectorRange
-template <typename Tag, typename Function>
-inline void par_dispatch(LoopPatternTPTVR, const std::string &name,
-                         DevExecSpace exec_space, const int &kl, const int &ku,
-                         const int &jl, const int &ju, const int &il, const int &iu,
-                         const Function &function) {
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function>
+inline void
+par_dispatch(LoopPatternTPTVRBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int &kl, const int &ku, const int &jl,
+             const int &ju, const int &il, const int &iu, const Function &function) {
   // TODO(pgrete) if exec space is Cuda,throw error
   const int Nk = ku - kl + 1;
   const int Nj = ju - jl + 1;
   const int NkNj = Nk * Nj;
   Kokkos::parallel_for(
-      name, team_policy(exec_space, NkNj, Kokkos::AUTO),
+      name, dispatch_impl::MakeTeamPolicy<MaxThreads, MinBlocks>(name, exec_space, NkNj),
       KOKKOS_LAMBDA(team_mbr_t team_member) {
         const int k = team_member.league_rank() / Nj + kl;
         const int j = team_member.league_rank() % Nj + jl;
@@ -311,14 +381,15 @@ inline void par_dispatch(LoopPatternTPTVR, const std::string &name,
 }
 
 // 3D loop using TeamPolicy with nested TeamThreadRange and ThreadVectorRange
-template <typename Tag, typename Function>
-inline void par_dispatch(LoopPatternTPTTRTVR, const std::string &name,
-                         DevExecSpace exec_space, const int &kl, const int &ku,
-                         const int &jl, const int &ju, const int &il, const int &iu,
-                         const Function &function) {
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function>
+inline void
+par_dispatch(LoopPatternTPTTRTVRBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int &kl, const int &ku, const int &jl,
+             const int &ju, const int &il, const int &iu, const Function &function) {
   const int Nk = ku - kl + 1;
   Kokkos::parallel_for(
-      name, team_policy(exec_space, Nk, Kokkos::AUTO),
+      name, dispatch_impl::MakeTeamPolicy<MaxThreads, MinBlocks>(name, exec_space, Nk),
       KOKKOS_LAMBDA(team_mbr_t team_member) {
         const int k = team_member.league_rank() + kl;
         Kokkos::parallel_for(
@@ -375,35 +446,37 @@ par_dispatch(LoopPatternFlatRange, const std::string &name, DevExecSpace exec_sp
 }
 
 // 4D loop using MDRange loops
-template <typename Tag, typename Function, class... Args>
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function, class... Args>
 inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
-par_dispatch(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
-             const int nl, const int nu, const int kl, const int ku, const int jl,
-             const int ju, const int il, const int iu, const Function &function,
-             Args &&...args) {
+par_dispatch(LoopPatternMDRangeBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int nl, const int nu, const int kl,
+             const int ku, const int jl, const int ju, const int il, const int iu,
+             const Function &function, Args &&...args) {
   Tag tag;
   kokkos_dispatch(tag, name,
-                  Kokkos::Experimental::require(
-                      Kokkos::MDRangePolicy<Kokkos::Rank<4>>(
-                          exec_space, {nl, kl, jl, il}, {nu + 1, ku + 1, ju + 1, iu + 1},
-                          {1, 1, 1, iu + 1 - il}),
-                      Kokkos::Experimental::WorkItemProperty::HintLightWeight),
+                  dispatch_impl::MakeMDRangePolicy<4, MaxThreads, MinBlocks>(
+                      name, exec_space, {nl, kl, jl, il},
+                      {nu + 1, ku + 1, ju + 1, iu + 1}),
                   function, std::forward<Args>(args)...);
 }
 
 // 4D loop using TeamPolicy loop with inner TeamThreadRange
-template <typename Tag, typename Function>
-inline void par_dispatch(LoopPatternTPTTR, const std::string &name,
-                         DevExecSpace exec_space, const int nl, const int nu,
-                         const int kl, const int ku, const int jl, const int ju,
-                         const int il, const int iu, const Function &function) {
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function>
+inline void
+par_dispatch(LoopPatternTPTTRBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int nl, const int nu, const int kl,
+             const int ku, const int jl, const int ju, const int il, const int iu,
+             const Function &function) {
   const int Nn = nu - nl + 1;
   const int Nk = ku - kl + 1;
   const int Nj = ju - jl + 1;
   const int NkNj = Nk * Nj;
   const int NnNkNj = Nn * Nk * Nj;
   Kokkos::parallel_for(
-      name, team_policy(exec_space, NnNkNj, Kokkos::AUTO),
+      name,
+      dispatch_impl::MakeTeamPolicy<MaxThreads, MinBlocks>(name, exec_space, NnNkNj),
       KOKKOS_LAMBDA(team_mbr_t team_member) {
         int n = team_member.league_rank() / NkNj;
         int k = (team_member.league_rank() - n * NkNj) / Nj;
@@ -416,11 +489,13 @@ inline void par_dispatch(LoopPatternTPTTR, const std::string &name,
 }
 
 // 4D loop using TeamPolicy loop with inner ThreadVectorRange
-template <typename Tag, typename Function>
-inline void par_dispatch(LoopPatternTPTVR, const std::string &name,
-                         DevExecSpace exec_space, const int nl, const int nu,
-                         const int kl, const int ku, const int jl, const int ju,
-                         const int il, const int iu, const Function &function) {
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function>
+inline void
+par_dispatch(LoopPatternTPTVRBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int nl, const int nu, const int kl,
+             const int ku, const int jl, const int ju, const int il, const int iu,
+             const Function &function) {
   // TODO(pgrete) if exec space is Cuda,throw error
   const int Nn = nu - nl + 1;
   const int Nk = ku - kl + 1;
@@ -428,7 +503,8 @@ inline void par_dispatch(LoopPatternTPTVR, const std::string &name,
   const int NkNj = Nk * Nj;
   const int NnNkNj = Nn * Nk * Nj;
   Kokkos::parallel_for(
-      name, team_policy(exec_space, NnNkNj, Kokkos::AUTO),
+      name,
+      dispatch_impl::MakeTeamPolicy<MaxThreads, MinBlocks>(name, exec_space, NnNkNj),
       KOKKOS_LAMBDA(team_mbr_t team_member) {
         int n = team_member.league_rank() / NkNj;
         int k = (team_member.league_rank() - n * NkNj) / Nj;
@@ -441,16 +517,18 @@ inline void par_dispatch(LoopPatternTPTVR, const std::string &name,
 }
 
 // 4D loop using TeamPolicy with nested TeamThreadRange and ThreadVectorRange
-template <typename Tag, typename Function>
-inline void par_dispatch(LoopPatternTPTTRTVR, const std::string &name,
-                         DevExecSpace exec_space, const int nl, const int nu,
-                         const int kl, const int ku, const int jl, const int ju,
-                         const int il, const int iu, const Function &function) {
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function>
+inline void
+par_dispatch(LoopPatternTPTTRTVRBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int nl, const int nu, const int kl,
+             const int ku, const int jl, const int ju, const int il, const int iu,
+             const Function &function) {
   const int Nn = nu - nl + 1;
   const int Nk = ku - kl + 1;
   const int NnNk = Nn * Nk;
   Kokkos::parallel_for(
-      name, team_policy(exec_space, NnNk, Kokkos::AUTO),
+      name, dispatch_impl::MakeTeamPolicy<MaxThreads, MinBlocks>(name, exec_space, NnNk),
       KOKKOS_LAMBDA(team_mbr_t team_member) {
         int n = team_member.league_rank() / Nk + nl;
         int k = team_member.league_rank() % Nk + kl;
@@ -478,21 +556,19 @@ inline void par_dispatch(LoopPatternSimdFor, const std::string &name,
 }
 
 // 5D loop using MDRange loops
-template <typename Tag, typename Function, class... Args>
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function, class... Args>
 inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
-par_dispatch(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
-             const int ml, const int mu, const int nl, const int nu, const int kl,
-             const int ku, const int jl, const int ju, const int il, const int iu,
-             const Function &function, Args &&...args) {
+par_dispatch(LoopPatternMDRangeBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int ml, const int mu, const int nl,
+             const int nu, const int kl, const int ku, const int jl, const int ju,
+             const int il, const int iu, const Function &function, Args &&...args) {
   Tag tag;
-  kokkos_dispatch(
-      tag, name,
-      Kokkos::Experimental::require(
-          Kokkos::MDRangePolicy<Kokkos::Rank<5>>(exec_space, {ml, nl, kl, jl, il},
-                                                 {mu + 1, nu + 1, ku + 1, ju + 1, iu + 1},
-                                                 {1, 1, 1, 1, iu + 1 - il}),
-          Kokkos::Experimental::WorkItemProperty::HintLightWeight),
-      function, std::forward<Args>(args)...);
+  kokkos_dispatch(tag, name,
+                  dispatch_impl::MakeMDRangePolicy<5, MaxThreads, MinBlocks>(
+                      name, exec_space, {ml, nl, kl, jl, il},
+                      {mu + 1, nu + 1, ku + 1, ju + 1, iu + 1}),
+                  function, std::forward<Args>(args)...);
 }
 
 // 5D loop using Kokkos 1D Range
@@ -546,20 +622,19 @@ inline void par_dispatch(LoopPatternSimdFor, const std::string &name,
 }
 
 // 6D loop using MDRange loops
-template <typename Tag, typename Function, class... Args>
+template <typename Tag, unsigned int MaxThreads, unsigned int MinBlocks,
+          typename Function, class... Args>
 inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
-par_dispatch(LoopPatternMDRange, const std::string &name, DevExecSpace exec_space,
-             const int ll, const int lu, const int ml, const int mu, const int nl,
-             const int nu, const int kl, const int ku, const int jl, const int ju,
-             const int il, const int iu, const Function &function, Args &&...args) {
+par_dispatch(LoopPatternMDRangeBounded<MaxThreads, MinBlocks>, const std::string &name,
+             DevExecSpace exec_space, const int ll, const int lu, const int ml,
+             const int mu, const int nl, const int nu, const int kl, const int ku,
+             const int jl, const int ju, const int il, const int iu,
+             const Function &function, Args &&...args) {
   Tag tag;
   kokkos_dispatch(tag, name,
-                  Kokkos::Experimental::require(
-                      Kokkos::MDRangePolicy<Kokkos::Rank<6>>(
-                          exec_space, {ll, ml, nl, kl, jl, il},
-                          {lu + 1, mu + 1, nu + 1, ku + 1, ju + 1, iu + 1},
-                          {1, 1, 1, 1, 1, iu + 1 - il}),
-                      Kokkos::Experimental::WorkItemProperty::HintLightWeight),
+                  dispatch_impl::MakeMDRangePolicy<6, MaxThreads, MinBlocks>(
+                      name, exec_space, {ll, ml, nl, kl, jl, il},
+                      {lu + 1, mu + 1, nu + 1, ku + 1, ju + 1, iu + 1}),
                   function, std::forward<Args>(args)...);
 }
 
@@ -618,19 +693,176 @@ inline void par_dispatch(LoopPatternSimdFor, const std::string &name,
               function(l, m, n, k, j, i);
 }
 
+namespace dispatch_impl {
+inline std::string AutotuneKey(const std::string &name, const int nn, const int nk,
+                               const int nj, const int ni) {
+  return name + " [" + (nn > 0 ? std::to_string(nn) + "x" : "") + std::to_string(nk) +
+         "x" + std::to_string(nj) + "x" + std::to_string(ni) + "]";
+}
+
+// Calls run with the tag of the pattern LoopAutotuner chooses for key.  The team
+// patterns only support par_for, and SimdFor only runs on the host.  MDRange comes
+// first, so it is used when tuning is disabled.
+template <typename Tag, typename Runner>
+inline void AutotunedDispatch(const std::string &key, const Runner &run) {
+  using LPC = LoopPatternChoice;
+  constexpr bool team_patterns = std::is_same<Tag, ParallelForDispatch>::value;
+  constexpr bool on_host =
+      Kokkos::SpaceAccessibility<DevExecSpace, Kokkos::HostSpace>::accessible;
+  static constexpr LPC reduce_candidates[] = {LPC::mdrange, LPC::flatrange};
+  static constexpr LPC device_candidates[] = {LPC::mdrange, LPC::flatrange, LPC::tpttr,
+                                              LPC::tpttrtvr};
+  static constexpr LPC host_candidates[] = {LPC::mdrange, LPC::flatrange, LPC::tpttr,
+                                            LPC::tptvr,   LPC::tpttrtvr,  LPC::simdfor};
+  auto &tuner = LoopAutotuner::Get();
+  LoopAutotuner::Trial trial;
+  if constexpr (!team_patterns) {
+    trial = tuner.Next(key, reduce_candidates, 2);
+  } else if constexpr (on_host) {
+    trial = tuner.Next(key, host_candidates, 6);
+  } else {
+    trial = tuner.Next(key, device_candidates, 4);
+  }
+  Kokkos::Timer timer;
+  if (trial.timed) {
+    Kokkos::fence();
+    timer.reset();
+  }
+  if (trial.pattern == LPC::flatrange) {
+    run(loop_pattern_flatrange_tag);
+  } else if constexpr (team_patterns) {
+    if (trial.pattern == LPC::tpttr) {
+      run(loop_pattern_tpttr_tag);
+    } else if (trial.pattern == LPC::tpttrtvr) {
+      run(loop_pattern_tpttrtvr_tag);
+    } else if constexpr (on_host) {
+      if (trial.pattern == LPC::tptvr) {
+        run(loop_pattern_tptvr_tag);
+      } else if (trial.pattern == LPC::simdfor) {
+        run(loop_pattern_simdfor_tag);
+      } else {
+        run(loop_pattern_mdrange_tag);
+      }
+    } else {
+      run(loop_pattern_mdrange_tag);
+    }
+  } else {
+    run(loop_pattern_mdrange_tag);
+  }
+  if (trial.timed) {
+    Kokkos::fence();
+    tuner.Record(key, trial.pattern, timer.seconds());
+  }
+}
+} // namespace dispatch_impl
+
+// 3D loop with the pattern chosen by LoopAutotuner
+template <typename Tag, typename Function, class... Args>
+inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
+par_dispatch(LoopPatternAutotune, const std::string &name, DevExecSpace exec_space,
+             const int kl, const int ku, const int jl, const int ju, const int il,
+             const int iu, const Function &function, Args &&...args) {
+  const auto key = dispatch_impl::AutotuneKey(name, 0, ku - kl + 1, ju - jl + 1,
+                                              iu - il + 1);
+  dispatch_impl::AutotunedDispatch<Tag>(key, [&](auto pattern) {
+    par_dispatch<Tag>(pattern, name, exec_space, kl, ku, jl, ju, il, iu, function,
+                      std::forward<Args>(args)...);
+  });
+}
+
+// 4D loop with the pattern chosen by LoopAutotuner
+template <typename Tag, typename Function, class... Args>
+inline typename std::enable_if<sizeof...(Args) <= 1, void>::type
+par_dispatch(LoopPatternAutotune, const std::string &name, DevExecSpace exec_space,
+             const int nl, const int nu, const int kl, const int ku, const int jl,
+             const int ju, const int il, const int iu, const Function &function,
+             Args &&...args) {
+  const auto key = dispatch_impl::AutotuneKey(name, nu - nl + 1, ku - kl + 1,
+                                              ju - jl + 1, iu - il + 1);
+  dispatch_impl::AutotunedDispatch<Tag>(key, [&](auto pattern) {
+    par_dispatch<Tag>(pattern, name, exec_space, nl, nu, kl, ku, jl, ju, il, iu,
+                      function, std::forward<Args>(args)...);
+  });
+}
+
+// Loops of other dimensions are not tuned, 1D loops (two bounds, the function and
+// possibly a reducer) use FlatRange and all others MDRange
+template <typename Tag, class... Args>
+inline void par_dispatch(LoopPatternAutotune, const std::string &name,
+                         DevExecSpace exec_space, Args &&...args) {
+  if constexpr (sizeof...(Args) <= 4) {
+    par_dispatch<Tag>(loop_pattern_flatrange_tag, name, exec_space,
+                      std::forward<Args>(args)...);
+  } else {
+    par_dispatch<Tag>(loop_pattern_mdrange_tag, name, exec_space,
+                      std::forward<Args>(args)...);
+  }
+}
+
+namespace dispatch_impl {
+// The label and number of iterations of a loop from the arguments of par_for, i.e., the
+// first string and the product of the extents of the first run of integer bounds
+template <class... Args>
+inline std::int64_t LoopLabelAndIterations(std::string &label, const Args &...args) {
+  bool have_label = false, in_bounds = false, past_bounds = false;
+  int nbounds = 0;
+  std::int64_t lower = 0, iterations = 1;
+  const auto visit = [&](const auto &arg) {
+    using T = std::decay_t<decltype(arg)>;
+    if constexpr (std::is_convertible<const T &, std::string>::value) {
+      if (!have_label) label = arg;
+      have_label = true;
+    } else if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+      if (past_bounds) return;
+      in_bounds = true;
+      if (nbounds++ % 2 == 0) {
+        lower = arg;
+      } else {
+        iterations *= std::max<std::int64_t>(0, arg - lower + 1);
+      }
+    } else {
+      past_bounds = in_bounds;
+    }
+  };
+  (visit(args), ...);
+  return iterations;
+}
+
+// Times the loop between fences if it has a KernelCost and KernelCosts are timed
+template <typename Tag, class... Args>
+inline void CostedDispatch(Args &&...args) {
+  if (KernelCosts::Timing()) {
+    std::string label;
+    const auto iterations = LoopLabelAndIterations(label, args...);
+    if (KernelCosts::Find(label) != nullptr) {
+      Kokkos::fence();
+      Kokkos::Timer timer;
+      par_dispatch<Tag>(std::forward<Args>(args)...);
+      Kokkos::fence();
+      KernelCosts::Record(label, iterations, timer.seconds());
+      return;
+    }
+  }
+  par_dispatch<Tag>(std::forward<Args>(args)...);
+}
+} // namespace dispatch_impl
+
 template <class... Args>
 inline void par_for(Args &&...args) {
-  par_dispatch<dispatch_impl::ParallelForDispatch>(std::forward<Args>(args)...);
+  dispatch_impl::CostedDispatch<dispatch_impl::ParallelForDispatch>(
+      std::forward<Args>(args)...);
 }
 
 template <class... Args>
 inline void par_reduce(Args &&...args) {
-  par_dispatch<dispatch_impl::ParallelReduceDispatch>(std::forward<Args>(args)...);
+  dispatch_impl::CostedDispatch<dispatch_impl::ParallelReduceDispatch>(
+      std::forward<Args>(args)...);
 }
 
 template <class... Args>
 inline void par_scan(Args &&...args) {
-  par_dispatch<dispatch_impl::ParallelScanDispatch>(std::forward<Args>(args)...);
+  dispatch_impl::CostedDispatch<dispatch_impl::ParallelScanDispatch>(
+      std::forward<Args>(args)...);
 }
 
 // 1D  outer parallel loop using Kokkos Teams
@@ -641,7 +873,7 @@ inline void par_for_outer(OuterLoopPatternTeams, const std::string &name,
                           const Function &function) {
   const int Nk = ku + 1 - kl;
 
-  team_policy policy(exec_space, Nk, Kokkos::AUTO);
+  auto policy = dispatch_impl::MakeTeamPolicy<0, 0>(name, exec_space, Nk);
 
   Kokkos::parallel_for(
       name,
@@ -662,7 +894,7 @@ inline void par_for_outer(OuterLoopPatternTeams, const std::string &name,
   const int Nj = ju + 1 - jl;
   const int NkNj = Nk * Nj;
 
-  team_policy policy(exec_space, NkNj, Kokkos::AUTO);
+  auto policy = dispatch_impl::MakeTeamPolicy<0, 0>(name, exec_space, NkNj);
 
   Kokkos::parallel_for(
       name,
@@ -687,7 +919,7 @@ inline void par_for_outer(OuterLoopPatternTeams, const std::string &name,
   const int NkNj = Nk * Nj;
   const int NnNkNj = Nn * Nk * Nj;
 
-  team_policy policy(exec_space, NnNkNj, Kokkos::AUTO);
+  auto policy = dispatch_impl::MakeTeamPolicy<0, 0>(name, exec_space, NnNkNj);
 
   Kokkos::parallel_for(
       name,
@@ -922,6 +1154,29 @@ struct SpaceInstance<Kokkos::Cuda> {
 };
 #endif
 
+#ifdef KOKKOS_ENABLE_HIP
+template <>
+struct SpaceInstance<Kokkos::HIP> {
+  static Kokkos::HIP create() {
+    hipStream_t stream;
+    (void)hipStreamCreate(&stream);
+    return Kokkos::HIP(stream);
+  }
+  static void destroy(Kokkos::HIP &space) {
+    hipStream_t stream = space.hip_stream();
+    (void)hipStreamDestroy(stream);
+  }
+  static bool overlap() {
+    bool value = true;
+    auto local_rank_str = std::getenv("HIP_LAUNCH_BLOCKING");
+    if (local_rank_str) {
+      value = (std::atoi(local_rank_str) == 0);
+    }
+    return value;
+  }
+};
+#endif
+
 // Design from "Runtime Polymorphism in Kokkos Applications", SAND2019-0279PE
 template <typename MS = DevMemSpace>
 struct DeviceDeleter {
@@ -22,6 +22,7 @@
 //  \brief implementation of Mesh::AdaptiveMeshRefinement() and related utilities
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <iostream>
 #include <numeric>
@@ -29,6 +30,7 @@
 #include <string>
 #include <tuple>
 #include <unordered_set>
+#include <vector>
 
 #include "parthenon_mpi.hpp"
 
@@ -42,22 +44,25 @@
 #include "mesh/meshblock_tree.hpp"
 #include "parthenon_arrays.hpp"
 #include "utils/buffer_utils.hpp"
+#include "utils/comm_counters.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/indexer.hpp"
 
 namespace parthenon {
 
 #ifdef MPI_PARALLEL
 //----------------------------------------------------------------------------------------
-//! \fn int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3)
+//! \fn int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3, int slot)
 //  \brief calculate an MPI tag for AMR block transfer
 // tag = local id of destination (remaining bits) + ox1(1 bit) + ox2(1 bit) + ox3(1 bit)
-//       + physics(5 bits)
+//       + slot of the variable in its communicator (5 bits)
 
 // See comments on BoundaryBase::CreateBvalsMPITag()
 
-int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3) {
-  // the trailing zero is used as "id" to indicate an AMR related tag
-  return (lid << 8) | (ox1 << 7) | (ox2 << 6) | (ox3 << 5) | 0;
+int CreateAMRMPITag(int lid, int ox1, int ox2, int ox3, int slot = 0) {
+  // the trailing bits are the slot of the variable in its communicator, see
+  // Mesh::GetMPICommSlot
+  return (lid << 8) | (ox1 << 7) | (ox2 << 6) | (ox3 << 5) | slot;
 }
 
 MPI_Request SendCoarseToFine(int lid_recv, int dest_rank, const LogicalLocation &fine_loc,
@@ -69,21 +74,59 @@ MPI_Request SendCoarseToFine(int lid_recv, int dest_rank, const LogicalLocation
   const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
   const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
 
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
+  int tag =
+      CreateAMRMPITag(lid_recv, ox1, ox2, ox3, pmesh->GetMPICommSlot(var->label()));
   if (var->IsAllocated()) {
     PARTHENON_MPI_CHECK(MPI_Isend(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
                                   dest_rank, tag, comm, &req));
+    CommCounters::CountSend(CommCounters::migration, var->data.size() * sizeof(Real));
   } else {
     PARTHENON_MPI_CHECK(
         MPI_Isend(var->data.data(), 0, MPI_PARTHENON_REAL, dest_rank, tag, comm, &req));
+    CommCounters::CountSend(CommCounters::migration, 0);
   }
   return req;
 }
 #endif
 
+// Copy of the part of a coarse block a fine block is refined from into the coarse buffer
+// of the fine block, see TryRecvCoarseToFine
+struct CoarseToFineCopy {
+  ParArrayND<Real, VariableState> src, dst;
+  // indices (t, u, v, k, j, i) in dst, which are shifted by (ks, js, is) in src
+  Indexer6D idxer;
+  int te, ks, js, is;
+};
+
+// Do the copies of all variables of all blocks refined on this rank with one kernel,
+// one team per copy
+void CopyCoarseToFine(const std::vector<CoarseToFineCopy> &copies) {
+  const int ncopies = copies.size();
+  if (ncopies == 0) return;
+  ParArray1D<CoarseToFineCopy> copies_d("coarse to fine copies", ncopies);
+  auto copies_h = Kokkos::create_mirror_view(copies_d);
+  for (int n = 0; n < ncopies; ++n) {
+    copies_h(n) = copies[n];
+  }
+  Kokkos::deep_copy(copies_d, copies_h);
+  Kokkos::parallel_for(
+      PARTHENON_AUTO_LABEL, Kokkos::TeamPolicy<>(DevExecSpace(), ncopies, Kokkos::AUTO),
+      KOKKOS_LAMBDA(team_mbr_t team_member) {
+        const auto &c = copies_d(team_member.league_rank());
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, c.idxer.size()),
+                             [&](const int idx) {
+                               const auto [t, u, v, k, j, i] = c.idxer(idx);
+                               c.dst(c.te, t, u, v, k, j, i) =
+                                   c.src(c.te, t, u, v, k + c.ks, j + c.js, i + c.is);
+                             });
+      });
+}
+
+// The copy into the coarse buffer of the fine block is only registered in copies, the
+// data it is copied from stays valid until RedistributeAndRefineMeshBlocks does them
 bool TryRecvCoarseToFine(int lid_recv, int send_rank, const LogicalLocation &fine_loc,
                          Variable<Real> *var_in, Variable<Real> *var, MeshBlock *pmb,
-                         Mesh *pmesh) {
+                         Mesh *pmesh, std::vector<CoarseToFineCopy> &copies) {
   const int ox1 = ((fine_loc.lx1() & 1LL) == 1LL);
   const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
   const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
@@ -91,7 +134,8 @@ bool TryRecvCoarseToFine(int lid_recv, int send_rank, const LogicalLocation &fin
   int test = 1;
 #ifdef MPI_PARALLEL
   MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
+  int tag =
+      CreateAMRMPITag(lid_recv, ox1, ox2, ox3, pmesh->GetMPICommSlot(var->label()));
   MPI_Status status;
   PARTHENON_MPI_CHECK(MPI_Iprobe(send_rank, tag, comm, &test, &status));
 #endif
@@ -99,6 +143,7 @@ bool TryRecvCoarseToFine(int lid_recv, int send_rank, const LogicalLocation &fin
     int size = var_in->IsAllocated();
 #ifdef MPI_PARALLEL
     PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
+    CommCounters::CountReceive(CommCounters::migration, size * sizeof(Real));
 #endif
     if (size > 0) {
       if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
@@ -126,13 +171,9 @@ bool TryRecvCoarseToFine(int lid_recv, int send_rank, const LogicalLocation &fin
         const int js = (ox2 == 0) ? 0 : (jb_int.e - jb_int.s + 1) / 2;
         const int is = (ox1 == 0) ? 0 : (ib_int.e - ib_int.s + 1) / 2;
         const int idx_te = static_cast<int>(te) % 3;
-        parthenon::par_for(
-            DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, nt, 0, nu, 0,
-            nv, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-            KOKKOS_LAMBDA(const int t, const int u, const int v, const int k, const int j,
-                          const int i) {
-              cb(idx_te, t, u, v, k, j, i) = fb(idx_te, t, u, v, k + ks, j + js, i + is);
-            });
+        Indexer6D idxer({0, nt}, {0, nu}, {0, nv}, {kb.s, kb.e}, {jb.s, jb.e},
+                        {ib.s, ib.e});
+        copies.push_back(CoarseToFineCopy{fb, cb, idxer, idx_te, ks, js, is});
       }
     } else {
       if (pmb->IsAllocated(var->label()) &&
@@ -158,13 +199,17 @@ MPI_Request SendFineToCoarse(int lid_recv, int dest_rank, const LogicalLocation
   const int ox2 = ((fine_loc.lx2() & 1LL) == 1LL);
   const int ox3 = ((fine_loc.lx3() & 1LL) == 1LL);
 
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
+  int tag =
+      CreateAMRMPITag(lid_recv, ox1, ox2, ox3, pmesh->GetMPICommSlot(var->label()));
   if (var->IsAllocated()) {
     PARTHENON_MPI_CHECK(MPI_Isend(var->coarse_s.data(), var->coarse_s.size(),
                                   MPI_PARTHENON_REAL, dest_rank, tag, comm, &req));
+    CommCounters::CountSend(CommCounters::migration,
+                            var->coarse_s.size() * sizeof(Real));
   } else {
     PARTHENON_MPI_CHECK(MPI_Isend(var->coarse_s.data(), 0, MPI_PARTHENON_REAL, dest_rank,
                                   tag, comm, &req));
+    CommCounters::CountSend(CommCounters::migration, 0);
   }
   return req;
 }
@@ -180,7 +225,8 @@ bool TryRecvFineToCoarse(int lid_recv, int send_rank, const LogicalLocation &fin
   int test = 1;
 #ifdef MPI_PARALLEL
   MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, ox1, ox2, ox3);
+  int tag =
+      CreateAMRMPITag(lid_recv, ox1, ox2, ox3, pmesh->GetMPICommSlot(var->label()));
   MPI_Status status;
   PARTHENON_MPI_CHECK(MPI_Iprobe(send_rank, tag, comm, &test, &status));
 #endif
@@ -188,6 +234,7 @@ bool TryRecvFineToCoarse(int lid_recv, int send_rank, const LogicalLocation &fin
     int size = var_in->IsAllocated();
 #ifdef MPI_PARALLEL
     PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
+    CommCounters::CountReceive(CommCounters::migration, size * sizeof(Real));
 #endif
     if (size > 0) {
       if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
@@ -247,7 +294,7 @@ MPI_Request SendSameToSame(int lid_recv, int dest_rank, Variable<Real> *var,
                            MeshBlock *pmb, Mesh *pmesh) {
   MPI_Request req;
   MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0);
+  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0, pmesh->GetMPICommSlot(var->label()));
   if (var->IsAllocated()) {
     // Metadata about this field also needs to be copied from this rank to the
     // receiving rank (namely the dereference count and the dealloc_count). Not
@@ -269,11 +316,14 @@ MPI_Request SendSameToSame(int lid_recv, int dest_rank, Variable<Real> *var,
 
     PARTHENON_MPI_CHECK(MPI_Isend(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
                                   dest_rank, tag, comm, &req));
+    CommCounters::CountSend(CommCounters::migration, var->data.size() * sizeof(Real));
   } else {
     var->com_state[0] = pmb->pmr->DereferenceCount();
     var->com_state[1] = var->dealloc_count;
     PARTHENON_MPI_CHECK(
         MPI_Isend(var->com_state, 2, MPI_INT, dest_rank, tag, comm, &req));
+    // only the counters of an unallocated variable, like a null message
+    CommCounters::CountSend(CommCounters::migration, 0);
   }
   return req;
 }
@@ -281,7 +331,7 @@ MPI_Request SendSameToSame(int lid_recv, int dest_rank, Variable<Real> *var,
 bool TryRecvSameToSame(int lid_recv, int send_rank, Variable<Real> *var, MeshBlock *pmb,
                        Mesh *pmesh) {
   MPI_Comm comm = pmesh->GetMPIComm(var->label());
-  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0);
+  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0, pmesh->GetMPICommSlot(var->label()));
 
   int test;
   MPI_Status status;
@@ -289,6 +339,8 @@ bool TryRecvSameToSame(int lid_recv, int send_rank, Variable<Real> *var, MeshBlo
   if (test) {
     int size;
     PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
+    CommCounters::CountReceive(CommCounters::migration,
+                               size > 2 ? size * sizeof(Real) : 0);
     if (size > 2) {
       if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
       PARTHENON_MPI_CHECK(MPI_Recv(var->data.data(), var->data.size(), MPI_PARTHENON_REAL,
@@ -310,6 +362,107 @@ bool TryRecvSameToSame(int lid_recv, int send_rank, Variable<Real> *var, MeshBlo
   }
   return test;
 }
+
+// A block that moves to another rank on the same level can also be sent in a single
+// message holding all of its variables. The message starts with a header holding the
+// dereference count of the block and, for every variable, whether it is allocated and
+// its dealloc_count. The data of the allocated variables follow.
+struct BlockMigration {
+  Kokkos::View<Real *, DevMemSpace> buf;
+  MPI_Request req = MPI_REQUEST_NULL;
+  bool receiving = false;
+};
+
+namespace {
+using UnmanagedDevView_t =
+    Kokkos::View<Real *, DevMemSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+int MigrationHeaderSize(MeshBlock *pmb) { return 1 + 2 * pmb->vars_cc_.size(); }
+} // namespace
+
+// Asynchronously pack all variables of pmb into a new buffer, i.e., the buffer can only
+// be sent after a fence
+BlockMigration PackBlockForMigration(MeshBlock *pmb) {
+  const int nheader = MigrationHeaderSize(pmb);
+  std::size_t size = nheader;
+  for (auto &var : pmb->vars_cc_) {
+    if (var->IsAllocated()) size += var->data.size();
+  }
+  BlockMigration out;
+  out.buf = Kokkos::View<Real *, DevMemSpace>(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "block migration"), size);
+
+  auto header = Kokkos::subview(out.buf, std::make_pair(0, nheader));
+  auto header_h = Kokkos::create_mirror_view(HostMemSpace(), header);
+  header_h(0) = pmb->pmr->DereferenceCount();
+  std::size_t offset = nheader;
+  for (int i = 0; i < pmb->vars_cc_.size(); ++i) {
+    auto &var = pmb->vars_cc_[i];
+    header_h(1 + 2 * i) = var->IsAllocated();
+    header_h(2 + 2 * i) = var->dealloc_count;
+    if (var->IsAllocated()) {
+      const std::size_t n = var->data.size();
+      Kokkos::deep_copy(DevExecSpace(),
+                        Kokkos::subview(out.buf, std::make_pair(offset, offset + n)),
+                        UnmanagedDevView_t(var->data.data(), n));
+      offset += n;
+    }
+  }
+  Kokkos::deep_copy(header, header_h);
+  return out;
+}
+
+void SendBlockForMigration(int lid_recv, int dest_rank, BlockMigration &m, Mesh *pmesh) {
+  MPI_Comm comm = pmesh->GetMPIComm(Mesh::migration_comm_label);
+  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0);
+  PARTHENON_MPI_CHECK(MPI_Isend(m.buf.data(), m.buf.size(), MPI_PARTHENON_REAL,
+                                dest_rank, tag, comm, &m.req));
+  CommCounters::CountSend(CommCounters::migration, m.buf.size() * sizeof(Real));
+}
+
+// Post the receive of the message for pmb once it has arrived, and asynchronously
+// unpack it once it has been received. Returns true once the message is unpacked.
+bool TryRecvBlockForMigration(int lid_recv, int send_rank, BlockMigration &m,
+                              MeshBlock *pmb, Mesh *pmesh) {
+  MPI_Comm comm = pmesh->GetMPIComm(Mesh::migration_comm_label);
+  int tag = CreateAMRMPITag(lid_recv, 0, 0, 0);
+  int test;
+  if (!m.receiving) {
+    MPI_Status status;
+    PARTHENON_MPI_CHECK(MPI_Iprobe(send_rank, tag, comm, &test, &status));
+    if (!test) return false;
+    int size;
+    PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPI_PARTHENON_REAL, &size));
+    CommCounters::CountReceive(CommCounters::migration, size * sizeof(Real));
+    m.buf = Kokkos::View<Real *, DevMemSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "block migration"), size);
+    PARTHENON_MPI_CHECK(MPI_Irecv(m.buf.data(), size, MPI_PARTHENON_REAL, send_rank, tag,
+                                  comm, &m.req));
+    m.receiving = true;
+  }
+  PARTHENON_MPI_CHECK(MPI_Test(&m.req, &test, MPI_STATUS_IGNORE));
+  if (!test) return false;
+
+  const int nheader = MigrationHeaderSize(pmb);
+  auto header_h = Kokkos::create_mirror_view_and_copy(
+      HostMemSpace(), Kokkos::subview(m.buf, std::make_pair(0, nheader)));
+  pmb->pmr->DereferenceCount() = header_h(0);
+  std::size_t offset = nheader;
+  for (int i = 0; i < pmb->vars_cc_.size(); ++i) {
+    auto &var = pmb->vars_cc_[i];
+    var->dealloc_count = header_h(2 + 2 * i);
+    if (header_h(1 + 2 * i)) {
+      if (!pmb->IsAllocated(var->label())) pmb->AllocateSparse(var->label());
+      const std::size_t n = var->data.size();
+      Kokkos::deep_copy(DevExecSpace(), UnmanagedDevView_t(var->data.data(), n),
+                        Kokkos::subview(m.buf, std::make_pair(offset, offset + n)));
+      offset += n;
+    } else if (pmb->IsAllocated(var->label()) &&
+               !var->metadata().IsSet(Metadata::ForceAllocOnNewBlocks)) {
+      pmb->DeallocateSparse(var->label());
+    }
+  }
+  return true;
+}
 #endif
 
 //----------------------------------------------------------------------------------------
@@ -317,32 +470,76 @@ bool TryRecvSameToSame(int lid_recv, int send_rank, Variable<Real> *var, MeshBlo
 // \brief Main function for adaptive mesh refinement
 
 void Mesh::LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin,
-                                                  ApplicationInput *app_in) {
+                                                  ApplicationInput *app_in,
+                                                  bool use_check_interval) {
   PARTHENON_INSTRUMENT
   int nnew = 0, ndel = 0;
+  Kokkos::Timer timer;
 
-  if (adaptive) {
+  const bool check =
+      adaptive && (!use_check_interval || ++cycles_since_check_ >= check_interval_);
+  if (check) {
     UpdateMeshBlockTree(nnew, ndel);
     nbnew += nnew;
     nbdel += ndel;
+    remesh_times.tree += timer.seconds();
   }
 
-  lb_flag_ |= lb_automatic_;
+  lb_flag_ |= lb_automatic_ || lb_particles_;
 
+  timer.reset();
   UpdateCostList();
+  remesh_times.costs += timer.seconds();
 
   modified = false;
   if (nnew != 0 || ndel != 0) { // at least one (de)refinement happened
-    GatherCostListAndCheckBalance();
+    timer.reset();
+    GatherCostList();
+    remesh_times.costs += timer.seconds();
     RedistributeAndRefineMeshBlocks(pin, app_in, nbtotal + nnew - ndel);
     modified = true;
+    remesh_count++;
   } else if (lb_flag_ && step_since_lb >= lb_interval_) {
-    if (!GatherCostListAndCheckBalance()) { // load imbalance detected
+    timer.reset();
+    const bool balanced = GatherCostListAndCheckBalance();
+    remesh_times.costs += timer.seconds();
+    if (!balanced) { // load imbalance detected
       RedistributeAndRefineMeshBlocks(pin, app_in, nbtotal);
       modified = true;
+      remesh_count++;
     }
     lb_flag_ = false;
   }
+
+  if (check && use_check_interval) {
+    cycles_since_check_ = 0;
+    if (adapt_check_interval_) AdaptRefinementCheckInterval(nnew != 0 || ndel != 0);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn void Mesh::AdaptRefinementCheckInterval(bool changed)
+// \brief double the interval between refinement checks while checks that don't change
+// the mesh take more than check_cost_fraction_ of the time between them, halve it once
+// blocks change again.  The decision is based on the slowest rank so that all ranks
+// agree on it.
+
+void Mesh::AdaptRefinementCheckInterval(bool changed) {
+  // tagging and the tree update are spent on every check, the rest only on remeshing
+  double times[2] = {remesh_times.tag + remesh_times.tree - check_times_.tag -
+                         check_times_.tree,
+                     check_timer_.seconds()};
+  check_times_ = remesh_times;
+  check_timer_.reset();
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(
+      MPI_Allreduce(MPI_IN_PLACE, times, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+#endif
+  if (changed) {
+    check_interval_ = std::max(1, check_interval_ / 2);
+  } else if (times[0] > check_cost_fraction_ * times[1]) {
+    check_interval_ = std::min(max_check_interval_, 2 * check_interval_);
+  }
 }
 
 // Private routines
@@ -354,7 +551,8 @@ namespace {
  * @param costlist (Input) A map of global block ID to a relative weight.
  * @param ranklist (Output) A map of global block ID to ranks.
  */
-void AssignBlocks(std::vector<double> const &costlist, std::vector<int> &ranklist) {
+void AssignBlocksGreedy(std::vector<double> const &costlist,
+                        std::vector<int> &ranklist) {
   ranklist.resize(costlist.size());
 
   double const total_cost = std::accumulate(costlist.begin(), costlist.end(), 0.0);
@@ -383,6 +581,133 @@ void AssignBlocks(std::vector<double> const &costlist, std::vector<int> &ranklis
   }
 }
 
+/**
+ * @brief Assigns blocks to ranks, from the last block backwards, giving each rank as
+ * many blocks as fit within max_cost. Every rank gets at least one block if there are
+ * enough blocks.
+ *
+ * @return false if max_cost requires more ranks than there are.
+ */
+bool AssignBlocksWithMaxCost(std::vector<double> const &costlist, const double max_cost,
+                             std::vector<int> &ranklist) {
+  int rank = Globals::nranks - 1;
+  double my_cost = 0.0;
+  int my_blocks = 0;
+  for (int block_id = costlist.size() - 1; block_id >= 0; block_id--) {
+    // leave at least one block for each of the remaining ranks
+    if (my_blocks > 0 && (my_cost + costlist[block_id] > max_cost || block_id < rank)) {
+      if (--rank < 0) return false;
+      my_cost = 0.0;
+      my_blocks = 0;
+    }
+    ranklist[block_id] = rank;
+    my_cost += costlist[block_id];
+    my_blocks++;
+  }
+  return true;
+}
+
+/**
+ * @brief This routine assigns index-contiguous blocks to ranks such that the largest
+ * total cost on any rank is as small as possible (the chains-on-chains partitioning
+ * problem), by bisecting for the smallest feasible maximum cost.
+ *
+ * @param costlist (Input) A map of global block ID to a relative weight.
+ * @param ranklist (Output) A map of global block ID to ranks.
+ */
+void AssignBlocksOptimal(std::vector<double> const &costlist,
+                         std::vector<int> &ranklist) {
+  ranklist.resize(costlist.size());
+  if (costlist.empty()) return;
+
+  double const total_cost = std::accumulate(costlist.begin(), costlist.end(), 0.0);
+  double const max_block_cost = *std::max_element(costlist.begin(), costlist.end());
+  // lo is a lower bound for the optimal maximum cost, hi is always feasible
+  double lo = std::max(max_block_cost, total_cost / Globals::nranks);
+  double hi = total_cost;
+  if (!AssignBlocksWithMaxCost(costlist, lo, ranklist)) {
+    for (int it = 0; it < 64 && hi - lo > 1.0e-12 * hi; ++it) {
+      const double mid = 0.5 * (lo + hi);
+      if (AssignBlocksWithMaxCost(costlist, mid, ranklist)) {
+        hi = mid;
+      } else {
+        lo = mid;
+      }
+    }
+    AssignBlocksWithMaxCost(costlist, hi, ranklist);
+  }
+}
+
+/**
+ * @brief This routine moves the boundaries between the block ranges of neighboring
+ * ranks from where they are in prev_ranklist towards where the optimal partition puts
+ * them, such that at most (about) max_moves blocks change rank.  Blocks thus only
+ * diffuse between ranks that are neighbors along the curve.
+ *
+ * @param costlist (Input) A map of global block ID to a relative weight.
+ * @param prev_ranklist (Input) A map of global block ID to the rank it is on now.
+ * @param max_moves (Input) The number of blocks allowed to change rank.
+ * @param ranklist (Output) A map of global block ID to ranks.
+ */
+void AssignBlocksDiffusive(std::vector<double> const &costlist,
+                           std::vector<int> const &prev_ranklist, const int max_moves,
+                           std::vector<int> &ranklist) {
+  const int nblocks = costlist.size();
+  const int nranks = Globals::nranks;
+  AssignBlocksOptimal(costlist, ranklist);
+  if (nblocks < nranks) return;
+
+  // first block of each rank, now and in the optimal partition
+  std::vector<int> prev_start(nranks + 1, nblocks), target_start(nranks + 1, nblocks);
+  for (int rank = 0; rank < nranks; ++rank) {
+    prev_start[rank] =
+        std::lower_bound(prev_ranklist.begin(), prev_ranklist.end(), rank) -
+        prev_ranklist.begin();
+    target_start[rank] =
+        std::lower_bound(ranklist.begin(), ranklist.end(), rank) - ranklist.begin();
+  }
+  int total_shift = 0;
+  for (int rank = 1; rank < nranks; ++rank)
+    total_shift += std::abs(target_start[rank] - prev_start[rank]);
+  if (total_shift <= max_moves) return;
+
+  // move every boundary the same fraction of the way, keeping all ranges non-empty
+  const double frac = static_cast<double>(max_moves) / static_cast<double>(total_shift);
+  std::vector<int> start(nranks + 1, nblocks);
+  start[0] = 0;
+  for (int rank = 1; rank < nranks; ++rank) {
+    const int shift = static_cast<int>(frac * (target_start[rank] - prev_start[rank]));
+    start[rank] = std::clamp(prev_start[rank] + shift, start[rank - 1] + 1,
+                             nblocks - (nranks - rank));
+  }
+  for (int rank = 0; rank < nranks; ++rank) {
+    for (int block_id = start[rank]; block_id < start[rank + 1]; ++block_id)
+      ranklist[block_id] = rank;
+  }
+}
+
+// the largest number of blocks any rank sends or receives
+int MaxBlocksMigrated(std::vector<int> const &prev_ranklist,
+                      std::vector<int> const &ranklist) {
+  std::vector<int> nmoved(Globals::nranks, 0);
+  for (int block_id = 0; block_id < ranklist.size(); ++block_id) {
+    if (ranklist[block_id] != prev_ranklist[block_id]) {
+      nmoved[ranklist[block_id]]++;
+      nmoved[prev_ranklist[block_id]]++;
+    }
+  }
+  return *std::max_element(nmoved.begin(), nmoved.end());
+}
+
+// the largest total cost of any rank
+double MaxRankCost(std::vector<double> const &costlist,
+                   std::vector<int> const &ranklist) {
+  std::vector<double> rank_cost(Globals::nranks, 0.0);
+  for (int block_id = 0; block_id < ranklist.size(); ++block_id)
+    rank_cost[ranklist[block_id]] += costlist[block_id];
+  return *std::max_element(rank_cost.begin(), rank_cost.end());
+}
+
 void UpdateBlockList(std::vector<int> const &ranklist, std::vector<int> &nslist,
                      std::vector<int> &nblist) {
   nslist.resize(Globals::nranks);
@@ -404,7 +729,8 @@ void UpdateBlockList(std::vector<int> const &ranklist, std::vector<int> &nslist,
 // \brief Calculate distribution of MeshBlocks based on the cost list
 void Mesh::CalculateLoadBalance(std::vector<double> const &costlist,
                                 std::vector<int> &ranklist, std::vector<int> &nslist,
-                                std::vector<int> &nblist) {
+                                std::vector<int> &nblist,
+                                std::vector<int> const *prev_ranklist) {
   PARTHENON_INSTRUMENT
   auto const total_blocks = costlist.size();
 
@@ -415,7 +741,7 @@ void Mesh::CalculateLoadBalance(std::vector<double> const &costlist,
   double const maxcost = min_max.second == costlist.begin() ? 0.0 : *min_max.second;
 
   // Assigns blocks to ranks on a rougly cost-equal basis.
-  AssignBlocks(costlist, ranklist);
+  AssignBlocksToRanks(costlist, ranklist, prev_ranklist);
 
   // Updates nslist with the ID of the starting block on each rank and the count of blocks
   // on each rank.
@@ -454,6 +780,42 @@ void Mesh::CalculateLoadBalance(std::vector<double> const &costlist,
   }
 }
 
+//----------------------------------------------------------------------------------------
+// \brief Assign blocks to ranks with the user supplied function or the partitioner
+// selected in the input file
+void Mesh::AssignBlocksToRanks(std::vector<double> const &costlist,
+                               std::vector<int> &ranklist,
+                               std::vector<int> const *prev_ranklist) {
+  auto const total_blocks = costlist.size();
+  if (AssignBlocks != nullptr) {
+    AssignBlocks(costlist, ranklist);
+    PARTHENON_REQUIRE_THROWS(ranklist.size() == total_blocks,
+                             "AssignBlocks must assign a rank to every block");
+    for (int block_id = 0; block_id < total_blocks; block_id++) {
+      const int step = ranklist[block_id] - (block_id > 0 ? ranklist[block_id - 1] : 0);
+      PARTHENON_REQUIRE_THROWS(
+          ranklist[block_id] < Globals::nranks && (step == 0 || step == 1),
+          "AssignBlocks must give each rank a non-empty range of consecutive blocks, "
+          "in the order of the ranks");
+    }
+    // the ranges have to start at rank 0 and reach the last rank, unless there are
+    // fewer blocks than ranks
+    const int last_rank = std::min<int>(Globals::nranks, total_blocks) - 1;
+    PARTHENON_REQUIRE_THROWS(
+        total_blocks == 0 || (ranklist.front() == 0 && ranklist.back() == last_rank),
+        "AssignBlocks must give each rank a non-empty range of consecutive blocks, "
+        "in the order of the ranks");
+  } else if (lb_partitioner_ == Partitioner::diffusive && prev_ranklist != nullptr) {
+    const int max_moves = std::ceil(lb_max_migration_ * total_blocks);
+    AssignBlocksDiffusive(costlist, *prev_ranklist, max_moves, ranklist);
+  } else if (lb_partitioner_ != Partitioner::greedy) {
+    // without a current assignment there is nothing to diffuse from
+    AssignBlocksOptimal(costlist, ranklist);
+  } else {
+    AssignBlocksGreedy(costlist, ranklist);
+  }
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Mesh::ResetLoadBalanceVariables()
 // \brief reset counters and flags for load balancing
@@ -475,9 +837,43 @@ void Mesh::ResetLoadBalanceVariables() {
 
 void Mesh::UpdateCostList() {
   if (lb_automatic_) {
+    // The costs are only measured where the task lists ask for it, see
+    // TaskList::SetCostMeter.  Whether any were is agreed on by all ranks, so that
+    // either all of them or none keep their previous costs.
+    bool measured = false;
+    for (auto &pmb : block_list) {
+      measured = measured || (pmb->cost_ > TINY_NUMBER);
+    }
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &measured, 1, MPI_CXX_BOOL, MPI_LOR,
+                                      MPI_COMM_WORLD));
+#endif
     double w = static_cast<double>(lb_interval_ - 1) / static_cast<double>(lb_interval_);
     for (auto &pmb : block_list) {
-      costlist[pmb->gid] = costlist[pmb->gid] * w + pmb->cost_;
+      if (measured) costlist[pmb->gid] = costlist[pmb->gid] * w + pmb->cost_;
+      // the cost of the next cycle is measured from scratch
+      pmb->ResetTimeMeasurement();
+    }
+    // nothing is measured before the first cycle, e.g., when rebalancing a restart
+    if (!measured && step_since_lb > 0 && !lb_unmeasured_warned_) {
+      lb_unmeasured_warned_ = true;
+      if (Globals::my_rank == 0) {
+        PARTHENON_WARN("balancer = automatic, but no block costs were measured, so the "
+                       "blocks are not balanced. Measure them with "
+                       "TaskList::SetCostMeter or MeshData::StartTimeMeasurement/"
+                       "StopTimeMeasurement.");
+      }
+    }
+  } else if (lb_particles_) {
+    for (auto &pmb : block_list) {
+      double cost = lb_block_cost_;
+      auto &sc = pmb->swarm_data.Get();
+      for (const auto &[swarm_name, particle_cost] : lb_particle_costs_) {
+        if (sc->Contains(swarm_name)) {
+          cost += particle_cost * sc->Get(swarm_name)->GetNumActive();
+        }
+      }
+      costlist[pmb->gid] = cost;
     }
   } else if (lb_flag_) {
     for (auto &pmb : block_list) {
@@ -496,160 +892,241 @@ void Mesh::UpdateMeshBlockTree(int &nnew, int &ndel) {
   int nleaf = 2;
   if (!mesh_size.symmetry(X2DIR)) nleaf = 4;
   if (!mesh_size.symmetry(X3DIR)) nleaf = 8;
-
-  // collect refinement flags from all the meshblocks
-  // count the number of the blocks to be (de)refined
-  nref[Globals::my_rank] = 0;
-  nderef[Globals::my_rank] = 0;
+  int lk = 0, lj = 0;
+  if (!mesh_size.symmetry(X2DIR)) lj = 1;
+  if (!mesh_size.symmetry(X3DIR)) lk = 1;
+
+  // Every rank holds the whole tree, so every rank has to learn about every change to
+  // it, but derefinement flags only matter for complete groups of siblings.  Siblings
+  // have consecutive gids, so a group can only be split between ranks that are
+  // neighbors along the curve.  Groups that are entirely local are resolved here and
+  // only their parent is sent; only the flags of groups that are split between ranks
+  // are sent as is, and flags of groups that can't be derefined are not sent at all.
+  std::vector<LogicalLocation> lref, lderef, lparent;
   for (auto const &pmb : block_list) {
-    if (pmb->pmr->refine_flag_ == 1) nref[Globals::my_rank]++;
-    if (pmb->pmr->refine_flag_ == -1) nderef[Globals::my_rank]++;
+    if (pmb->pmr->refine_flag_ == 1) lref.push_back(pmb->loc);
+    if (pmb->pmr->refine_flag_ != -1) continue;
+    const auto &loc = pmb->loc;
+    // position among its siblings, which are ordered with x1 running fastest
+    const int child = (loc.lx1() & 1LL) + 2 * (loc.lx2() & 1LL) + 4 * (loc.lx3() & 1LL);
+    const int first = pmb->gid - child;
+    if (first < 0 || first + nleaf > nbtotal) continue;
+    const auto parent = loc.GetParent();
+    bool leaves = true, local = true, flagged = true;
+    int gid = first;
+    for (int k = 0; k <= lk; k++) {
+      for (int j = 0; j <= lj; j++) {
+        for (int i = 0; i <= 1; i++, gid++) {
+          leaves = leaves && loclist[gid] == parent.GetDaughter(i, j, k);
+          local = local && ranklist[gid] == Globals::my_rank;
+          flagged = flagged && local && FindMeshBlock(gid)->pmr->refine_flag_ == -1;
+        }
+      }
+    }
+    if (!leaves) continue;
+    if (!local) {
+      lderef.push_back(loc);
+    } else if (flagged && pmb->gid == first) {
+      lparent.push_back(parent);
+    }
   }
+
+  // gather the number of refined blocks, of derefined blocks in split groups, and of
+  // derefined parents on each rank in one go
+  const int nranks = Globals::nranks;
+  std::vector<int> counts(3 * nranks);
+  counts[3 * Globals::my_rank] = lref.size();
+  counts[3 * Globals::my_rank + 1] = lderef.size();
+  counts[3 * Globals::my_rank + 2] = lparent.size();
 #ifdef MPI_PARALLEL
-  PARTHENON_MPI_CHECK(
-      MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nref.data(), 1, MPI_INT, MPI_COMM_WORLD));
-  PARTHENON_MPI_CHECK(
-      MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nderef.data(), 1, MPI_INT, MPI_COMM_WORLD));
+  PARTHENON_MPI_CHECK(MPI_Allgather(MPI_IN_PLACE, 3, MPI_INT, counts.data(), 3, MPI_INT,
+                                    MPI_COMM_WORLD));
 #endif
 
-  // count the number of the blocks to be (de)refined and displacement
-  int tnref = 0, tnderef = 0;
-  for (int n = 0; n < Globals::nranks; n++) {
-    tnref += nref[n];
-    tnderef += nderef[n];
+  int tnref = 0, tnderef = 0, tnparent = 0;
+  for (int n = 0; n < nranks; n++) {
+    tnref += counts[3 * n];
+    tnderef += counts[3 * n + 1];
+    tnparent += counts[3 * n + 2];
   }
-  if (tnref == 0 && tnderef < nleaf) { // nothing to do
+  if (tnref == 0 && tnparent == 0 && tnderef < 2) { // nothing to do
     return;
   }
 
-  int rd = 0, dd = 0;
-  for (int n = 0; n < Globals::nranks; n++) {
-    rdisp[n] = rd;
-    ddisp[n] = dd;
-    // technically could overflow, since sizeof() operator returns
-    // std::size_t = long unsigned int > int
-    // on many platforms (LP64). However, these are used below in MPI calls for
-    // integer arguments (recvcounts, displs). MPI does not support > 64-bit count ranges
-    bnref[n] = static_cast<int>(nref[n] * sizeof(LogicalLocation));
-    bnderef[n] = static_cast<int>(nderef[n] * sizeof(LogicalLocation));
-    brdisp[n] = static_cast<int>(rd * sizeof(LogicalLocation));
-    bddisp[n] = static_cast<int>(dd * sizeof(LogicalLocation));
-    rd += nref[n];
-    dd += nderef[n];
-  }
-
-  // allocate memory for the location arrays
-  LogicalLocation *lref{}, *lderef{}, *clderef{};
-  if (tnref > 0) lref = new LogicalLocation[tnref];
-  if (tnderef >= nleaf) {
-    lderef = new LogicalLocation[tnderef];
-    clderef = new LogicalLocation[tnderef / nleaf];
-  }
-
-  // collect the locations and costs
-  int iref = rdisp[Globals::my_rank], ideref = ddisp[Globals::my_rank];
-  for (auto const &pmb : block_list) {
-    if (pmb->pmr->refine_flag_ == 1) lref[iref++] = pmb->loc;
-    if (pmb->pmr->refine_flag_ == -1 && tnderef >= nleaf) lderef[ideref++] = pmb->loc;
-  }
+  // each rank contributes its refined blocks, then its derefined blocks, then its
+  // derefined parents
+  std::vector<LogicalLocation> locs(tnref + tnderef + tnparent);
 #ifdef MPI_PARALLEL
-  if (tnref > 0) {
-    PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, bnref[Globals::my_rank], MPI_BYTE,
-                                       lref, bnref.data(), brdisp.data(), MPI_BYTE,
-                                       MPI_COMM_WORLD));
+  // technically the byte counts could overflow, but MPI only takes int counts and
+  // displacements
+  std::vector<int> bcount(nranks), bdisp(nranks);
+  int disp = 0;
+  for (int n = 0; n < nranks; n++) {
+    const int count = counts[3 * n] + counts[3 * n + 1] + counts[3 * n + 2];
+    bcount[n] = static_cast<int>(count * sizeof(LogicalLocation));
+    bdisp[n] = static_cast<int>(disp * sizeof(LogicalLocation));
+    disp += count;
   }
-  if (tnderef >= nleaf) {
-    PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, bnderef[Globals::my_rank], MPI_BYTE,
-                                       lderef, bnderef.data(), bddisp.data(), MPI_BYTE,
-                                       MPI_COMM_WORLD));
+  auto mine = locs.begin() + bdisp[Globals::my_rank] / sizeof(LogicalLocation);
+#else
+  auto mine = locs.begin();
+#endif
+  for (auto *l : {&lref, &lderef, &lparent}) {
+    mine = std::copy(l->begin(), l->end(), mine);
   }
+#ifdef MPI_PARALLEL
+  PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, bcount[Globals::my_rank], MPI_BYTE,
+                                     locs.data(), bcount.data(), bdisp.data(), MPI_BYTE,
+                                     MPI_COMM_WORLD));
 #endif
+  lref.clear();
+  lderef.clear();
+  std::vector<LogicalLocation> clderef;
+  auto it = locs.begin();
+  for (int n = 0; n < nranks; n++) {
+    lref.insert(lref.end(), it, it + counts[3 * n]);
+    it += counts[3 * n];
+    lderef.insert(lderef.end(), it, it + counts[3 * n + 1]);
+    it += counts[3 * n + 1];
+    clderef.insert(clderef.end(), it, it + counts[3 * n + 2]);
+    it += counts[3 * n + 2];
+  }
 
-  // calculate the list of the newly derefined blocks
-  int ctnd = 0;
-  if (tnderef >= nleaf) {
-    int lk = 0, lj = 0;
-    if (!mesh_size.symmetry(X2DIR)) lj = 1;
-    if (!mesh_size.symmetry(X3DIR)) lk = 1;
-    for (int n = 0; n < tnderef; n++) {
-      if ((lderef[n].lx1() & 1LL) == 0LL && (lderef[n].lx2() & 1LL) == 0LL &&
-          (lderef[n].lx3() & 1LL) == 0LL) {
-        int r = n, rr = 0;
-        for (std::int64_t k = 0; k <= lk; k++) {
-          for (std::int64_t j = 0; j <= lj; j++) {
-            for (std::int64_t i = 0; i <= 1; i++) {
-              if (r < tnderef) {
-                if ((lderef[n].lx1() + i) == lderef[r].lx1() &&
-                    (lderef[n].lx2() + j) == lderef[r].lx2() &&
-                    (lderef[n].lx3() + k) == lderef[r].lx3() &&
-                    lderef[n].level() == lderef[r].level())
-                  rr++;
-                r++;
-              }
+  // complete the list of the newly derefined blocks with the groups split between ranks,
+  // whose flags are consecutive in lderef
+  for (int n = 0; n < tnderef; n++) {
+    if ((lderef[n].lx1() & 1LL) == 0LL && (lderef[n].lx2() & 1LL) == 0LL &&
+        (lderef[n].lx3() & 1LL) == 0LL) {
+      int r = n, rr = 0;
+      for (std::int64_t k = 0; k <= lk; k++) {
+        for (std::int64_t j = 0; j <= lj; j++) {
+          for (std::int64_t i = 0; i <= 1; i++) {
+            if (r < tnderef) {
+              if ((lderef[n].lx1() + i) == lderef[r].lx1() &&
+                  (lderef[n].lx2() + j) == lderef[r].lx2() &&
+                  (lderef[n].lx3() + k) == lderef[r].lx3() &&
+                  lderef[n].level() == lderef[r].level())
+                rr++;
+              r++;
             }
           }
         }
-        if (rr == nleaf) {
-          clderef[ctnd] = lderef[n].GetParent();
-          ctnd++;
-        }
       }
+      if (rr == nleaf) clderef.push_back(lderef[n].GetParent());
     }
   }
+  if (refinement_buffer_ > 0 && tnref > 0) BufferRefinement_(lref, clderef);
+
   // sort the lists by level
-  if (ctnd > 1) {
-    std::sort(clderef, &(clderef[ctnd - 1]),
-              [](const LogicalLocation &left, const LogicalLocation &right) {
-                return left.level() > right.level();
-              });
-  }
-  if (tnderef >= nleaf) delete[] lderef;
+  std::stable_sort(clderef.begin(), clderef.end(),
+                   [](const LogicalLocation &left, const LogicalLocation &right) {
+                     return left.level() > right.level();
+                   });
 
   // Now the lists of the blocks to be refined and derefined are completed
   // Start tree manipulation
   // Step 1. perform refinement
-  for (int n = 0; n < tnref; n++) {
-    MeshBlockTree *bt = tree.FindMeshBlock(lref[n]);
+  for (auto const &loc : lref) {
+    MeshBlockTree *bt = tree.FindMeshBlock(loc);
     bt->Refine(nnew);
   }
-  if (tnref != 0) delete[] lref;
 
   // Step 2. perform derefinement
-  for (int n = 0; n < ctnd; n++) {
-    MeshBlockTree *bt = tree.FindMeshBlock(clderef[n]);
+  for (auto const &loc : clderef) {
+    MeshBlockTree *bt = tree.FindMeshBlock(loc);
     bt->Derefine(ndel);
   }
-  if (tnderef >= nleaf) delete[] clderef;
+}
+
+void Mesh::BufferRefinement_(std::vector<LogicalLocation> &lref,
+                             std::vector<LogicalLocation> &lderef) {
+  const int s2 = (ndim >= 2) ? -1 : 0;
+  const int s3 = (ndim >= 3) ? -1 : 0;
+  // every rank has the same lref, so going through it in order keeps the tree the same
+  // on all ranks
+  std::unordered_set<LogicalLocation> refined(lref.begin(), lref.end());
+  std::vector<LogicalLocation> front = lref;
+  for (int n = 0; n < refinement_buffer_ && !front.empty(); n++) {
+    std::vector<LogicalLocation> next;
+    for (const auto &loc : front) {
+      for (int ox3 = s3; ox3 <= -s3; ox3++) {
+        for (int ox2 = s2; ox2 <= -s2; ox2++) {
+          for (int ox1 = -1; ox1 <= 1; ox1++) {
+            // same level or coarser leaves, finer neighbors return their parent
+            MeshBlockTree *bt = tree.FindNeighbor(loc, ox1, ox2, ox3, true);
+            if (bt == nullptr || !bt->IsLeaf()) continue;
+            const LogicalLocation nloc = bt->GetLocation();
+            if (nloc.level() >= max_level) continue;
+            if (refined.insert(nloc).second) next.push_back(nloc);
+          }
+        }
+      }
+    }
+    lref.insert(lref.end(), next.begin(), next.end());
+    front = std::move(next);
+  }
+  lderef.erase(std::remove_if(lderef.begin(), lderef.end(),
+                              [&refined](const LogicalLocation &parent) {
+                                for (const auto &child : parent.GetDaughters()) {
+                                  if (refined.count(child) > 0) return true;
+                                }
+                                return false;
+                              }),
+               lderef.end());
 }
 
 //----------------------------------------------------------------------------------------
-// \!fn bool Mesh::GatherCostListAndCheckBalance()
-// \brief collect the cost from MeshBlocks and check the load balance
+// \!fn void Mesh::GatherCostList()
+// \brief collect the cost of all MeshBlocks on all ranks
 
-bool Mesh::GatherCostListAndCheckBalance() {
-  if (lb_manual_ || lb_automatic_) {
+void Mesh::GatherCostList() {
 #ifdef MPI_PARALLEL
+  if (lb_manual_ || lb_automatic_ || lb_particles_) {
     PARTHENON_MPI_CHECK(MPI_Allgatherv(MPI_IN_PLACE, nblist[Globals::my_rank], MPI_DOUBLE,
                                        costlist.data(), nblist.data(), nslist.data(),
                                        MPI_DOUBLE, MPI_COMM_WORLD));
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn bool Mesh::GatherCostListAndCheckBalance()
+// \brief check the load balance and, only if it is off, collect the cost from MeshBlocks
+
+bool Mesh::GatherCostListAndCheckBalance() {
+  if (lb_manual_ || lb_automatic_ || lb_particles_) {
+    // the balance only needs the total cost of each rank, so the cost list is only
+    // gathered when the blocks are about to be redistributed
+    double rcost = 0.0;
+    for (auto const &pmb : block_list)
+      rcost += costlist[pmb->gid];
+    double maxcost = rcost, avecost = rcost;
+#ifdef MPI_PARALLEL
+    PARTHENON_MPI_CHECK(
+        MPI_Allreduce(MPI_IN_PLACE, &maxcost, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+    PARTHENON_MPI_CHECK(
+        MPI_Allreduce(MPI_IN_PLACE, &avecost, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
 #endif
-    double maxcost = 0.0, avecost = 0.0;
-    for (int rank = 0; rank < Globals::nranks; rank++) {
-      double rcost = 0.0;
-      int ns = nslist[rank];
-      int ne = ns + nblist[rank];
-      for (int n = ns; n < ne; ++n)
-        rcost += costlist[n];
-      maxcost = std::max(maxcost, rcost);
-      avecost += rcost;
-    }
     avecost /= Globals::nranks;
 
     if (adaptive)
       lb_tolerance_ =
           2.0 * static_cast<double>(Globals::nranks) / static_cast<double>(nbtotal);
 
-    if (maxcost > (1.0 + lb_tolerance_) * avecost) return false;
+    if (maxcost <= (1.0 + lb_tolerance_) * avecost) return true;
+    GatherCostList();
+
+    // only rebalance if the gain outweighs the cost of moving the blocks
+    if (lb_migration_cost_ > 0.0) {
+      std::vector<int> new_ranklist(costlist.size());
+      AssignBlocksToRanks(costlist, new_ranklist, &ranklist);
+      const double gain = maxcost - MaxRankCost(costlist, new_ranklist);
+      const double block_cost = avecost * Globals::nranks / costlist.size();
+      const double migration_cost =
+          lb_migration_cost_ * block_cost * MaxBlocksMigrated(ranklist, new_ranklist);
+      if (gain <= migration_cost) return true;
+    }
+    return false;
   }
   return true;
 }
@@ -661,6 +1138,10 @@ bool Mesh::GatherCostListAndCheckBalance() {
 void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput *app_in,
                                            int ntot) {
   PARTHENON_INSTRUMENT
+  Kokkos::Timer timer;
+  const double initialize_prev = remesh_times.initialize;
+  // evicted variables are prolongated, restricted, and sent like all others
+  RestoreEvictedVariables();
   // kill any cached packs
   mesh_data.PurgeNonBase();
   mesh_data.Get()->ClearCaches();
@@ -723,12 +1204,27 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     }
   } // Construct new list region
 
-  // Calculate new load balance
-  CalculateLoadBalance(newcost, newrank, nslist, nblist);
+  // Calculate new load balance, starting from the ranks the blocks (or their parents or
+  // children) are on now
+  std::vector<int> prevrank(ntot);
+  for (int n = 0; n < ntot; n++)
+    prevrank[n] = ranklist[newtoold[n]];
+  CalculateLoadBalance(newcost, newrank, nslist, nblist, &prevrank);
 
   int nbs = nslist[Globals::my_rank];
   int nbe = nbs + nblist[Globals::my_rank] - 1;
 
+  // Blocks that are derefined restrict into their coarse buffers, and blocks that are
+  // refined keep theirs until they are prolongated
+  remeshing_ = true;
+  if (coarse_buffers_on_demand) {
+    for (int on = onbs; on <= onbe; on++) {
+      if (newloc[oldtonew[on]].level() < loclist[on].level()) {
+        FindMeshBlock(on)->SetCoarseBuffers(true);
+      }
+    }
+  }
+
   // Restrict fine to coarse buffers
   ProResCache_t restriction_cache;
   int nrestrict = 0;
@@ -759,6 +1255,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
 #ifdef MPI_PARALLEL
   // Send data from old to new blocks
   std::vector<MPI_Request> send_reqs;
+  std::vector<BlockMigration> send_migrations;
+  std::vector<std::pair<int, int>> send_migration_dest;
   { // AMR Send region
     PARTHENON_INSTRUMENT
     for (int n = onbs; n <= onbe; n++) {
@@ -766,8 +1264,12 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
       LogicalLocation &oloc = loclist[n];
       LogicalLocation &nloc = newloc[nn];
       auto pb = FindMeshBlock(n);
-      if (nloc.level() == oloc.level() &&
-          newrank[nn] != Globals::my_rank) { // same level, different rank
+      if (nloc.level() == oloc.level() && newrank[nn] != Globals::my_rank &&
+          lb_aggregate_migration_) { // same level, different rank, single message
+        send_migrations.push_back(PackBlockForMigration(pb.get()));
+        send_migration_dest.emplace_back(nn - nslist[newrank[nn]], newrank[nn]);
+      } else if (nloc.level() == oloc.level() &&
+                 newrank[nn] != Globals::my_rank) { // same level, different rank
         for (auto &var : pb->vars_cc_)
           send_reqs.emplace_back(SendSameToSame(nn - nslist[newrank[nn]], newrank[nn],
                                                 var.get(), pb.get(), this));
@@ -786,6 +1288,13 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
                                                   oloc, var.get(), this));
       }
     }
+    // all blocks are packed before any is sent, so there is a single fence
+    if (send_migrations.size() > 0) Kokkos::fence();
+    for (int i = 0; i < send_migrations.size(); ++i) {
+      SendBlockForMigration(send_migration_dest[i].first, send_migration_dest[i].second,
+                            send_migrations[i], this);
+      send_reqs.push_back(send_migrations[i].req);
+    }
   }    // AMR Send region
 #endif // MPI_PARALLEL
 
@@ -793,6 +1302,7 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
   BlockList_t new_block_list(nbe - nbs + 1);
   { // AMR Construct new MeshBlockList region
     PARTHENON_INSTRUMENT
+    BlockCreationBatch_ creation_batch(this);
     RegionSize block_size = GetBlockSize();
 
     for (int n = nbs; n <= nbe; n++) {
@@ -835,6 +1345,11 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     PARTHENON_INSTRUMENT
     bool all_received;
     int niter = 0;
+#ifdef MPI_PARALLEL
+    // the buffers have to outlive the asynchronous unpacking, i.e., the fence below
+    std::vector<BlockMigration> recv_migrations(nbe - nbs + 1);
+#endif
+    std::vector<CoarseToFineCopy> c2f_copies;
     if (block_list.size() > 0) {
       // Create a vector for holding the status of all communications, it is sized to fit
       // the maximal number of calculations that this rank could receive: the number of
@@ -854,11 +1369,20 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
           if (oloc.level() == nloc.level() &&
               ranklist[on] != Globals::my_rank) { // same level, different rank
 #ifdef MPI_PARALLEL
-            for (auto &var : pb->vars_cc_) {
+            if (lb_aggregate_migration_) {
+              // unpacking is asynchronous, so a block that has arrived is unpacked while
+              // the messages of others are still in flight
               if (!finished[idx])
-                finished[idx] =
-                    TryRecvSameToSame(n - nbs, ranklist[on], var.get(), pb.get(), this);
+                finished[idx] = TryRecvBlockForMigration(
+                    n - nbs, ranklist[on], recv_migrations[n - nbs], pb.get(), this);
               all_received = finished[idx++] && all_received;
+            } else {
+              for (auto &var : pb->vars_cc_) {
+                if (!finished[idx])
+                  finished[idx] =
+                      TryRecvSameToSame(n - nbs, ranklist[on], var.get(), pb.get(), this);
+                all_received = finished[idx++] && all_received;
+              }
             }
 #endif
           } else if (oloc.level() > nloc.level()) { // f2c
@@ -883,8 +1407,9 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
                 auto pob = pb;
                 if (ranklist[on] == Globals::my_rank) pob = old_block_list[on - onbs];
                 auto var_in = pob->meshblock_data.Get()->GetVarPtr(var->label());
-                finished[idx] = TryRecvCoarseToFine(
-                    n - nbs, ranklist[on], nloc, var_in.get(), var.get(), pb.get(), this);
+                finished[idx] =
+                    TryRecvCoarseToFine(n - nbs, ranklist[on], nloc, var_in.get(),
+                                        var.get(), pb.get(), this, c2f_copies);
               }
               all_received = finished[idx++] && all_received;
             }
@@ -893,10 +1418,14 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
         // rb_idx is a running index, so we repeat the loop until all vals are true
       } while (!all_received && niter < 1e7);
       if (!all_received) PARTHENON_FAIL("AMR Receive failed");
+      CopyCoarseToFine(c2f_copies);
     }
     // Fence here to be careful that all communication is finished before moving
     // on to prolongation
     Kokkos::fence();
+    // Gather the received and the kept blocks in one array before any cache refers to
+    // their variables
+    BuildMeshWideStorage_();
 
     // Prolongate blocks that had a coarse buffer filled (i.e. c2f blocks)
     ProResCache_t prolongation_cache;
@@ -919,8 +1448,8 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
               var.get(), resolved_packages.get());
         }
       }
-      prolongation_cache.CopyToDevice();
     }
+    prolongation_cache.CopyToDevice();
     refinement::ProlongateShared(resolved_packages.get(), prolongation_cache,
                                  block_list[0]->cellbounds, block_list[0]->c_cellbounds);
 
@@ -953,7 +1482,9 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
     SetSameLevelNeighbors(block_list, leaf_grid_locs, this->GetRootGridInfo(), nbs, false,
                           0, newly_refined);
     BuildGMGHierarchy(nbs, pin, app_in);
+    Kokkos::Timer init_timer;
     Initialize(false, pin, app_in);
+    remesh_times.initialize += init_timer.seconds();
 
     // Internal refinement relies on the fine shared values, which are only consistent
     // after being updated with any previously fine versions
@@ -962,14 +1493,15 @@ void Mesh::RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput
                                    block_list[0]->c_cellbounds);
 
     // Rebuild just the ownership model, this time weighting the "new" fine blocks just
-    // like any other blocks at their level.
-    SetSameLevelNeighbors(block_list, leaf_grid_locs, this->GetRootGridInfo(), nbs,
-                          false);
-    for (auto &pmb : block_list) {
-      pmb->pbval->SearchAndSetNeighbors(this, tree, ranklist.data(), nslist.data());
-    }
+    // like any other blocks at their level. Only blocks next to a newly refined block
+    // are affected.
+    ResetNeighborOwnership(block_list, newly_refined);
   } // AMR Recv and unpack data
+  remeshing_ = false;
+  UpdateCoarseBuffers_(true);
 
   ResetLoadBalanceVariables();
+  remesh_times.redistribute +=
+      timer.seconds() - (remesh_times.initialize - initialize_prev);
 }
 } // namespace parthenon
@@ -191,7 +191,7 @@ std::vector<LogicalLocation> LogicalLocation::GetDaughters() const {
   return daughters;
 }
 
-std::unordered_set<LogicalLocation>
+PossibleNeighbors_t
 LogicalLocation::GetPossibleNeighbors(const RootGridInfo &rg_info) {
   const std::vector<int> irange{-1, 0, 1};
   const std::vector<int> jrange{-1, 0, 1};
@@ -204,7 +204,7 @@ LogicalLocation::GetPossibleNeighbors(const RootGridInfo &rg_info) {
                                   daughter_jrange, daughter_krange, rg_info);
 }
 
-std::unordered_set<LogicalLocation>
+PossibleNeighbors_t
 LogicalLocation::GetPossibleBlocksSurroundingTopologicalElement(
     int ox1, int ox2, int ox3, const RootGridInfo &rg_info) const {
   const auto irange =
@@ -224,12 +224,12 @@ LogicalLocation::GetPossibleBlocksSurroundingTopologicalElement(
                                   daughter_jrange, daughter_krange, rg_info);
 }
 
-std::unordered_set<LogicalLocation> LogicalLocation::GetPossibleNeighborsImpl(
+PossibleNeighbors_t LogicalLocation::GetPossibleNeighborsImpl(
     const std::vector<int> &irange, const std::vector<int> &jrange,
     const std::vector<int> &krange, const std::vector<int> &daughter_irange,
     const std::vector<int> &daughter_jrange, const std::vector<int> &daughter_krange,
     const RootGridInfo &rg_info) const {
-  std::vector<LogicalLocation> locs;
+  PossibleNeighbors_t locs;
 
   auto AddNeighbors = [&](const LogicalLocation &loc, bool include_parents) {
     const int n_per_root_block = 1 << std::max(loc.level() - rg_info.level, 0);
@@ -260,14 +260,14 @@ std::unordered_set<LogicalLocation> LogicalLocation::GetPossibleNeighborsImpl(
               const int s = loc.level() - level();
               if ((lx1 >> s) != this->lx1() || (lx2 >> s) != this->lx2() ||
                   (lx3 >> s) != this->lx3()) {
-                locs.emplace_back(loc.level(), lx1, lx2, lx3);
+                locs.emplace(loc.level(), lx1, lx2, lx3);
               }
             } else {
-              locs.emplace_back(loc.level(), lx1, lx2, lx3);
+              locs.emplace(loc.level(), lx1, lx2, lx3);
             }
             if (include_parents) {
-              auto parent = locs.back().GetParent();
-              if (IsNeighbor(parent, rg_info)) locs.push_back(parent);
+              auto parent = (locs.end() - 1)->GetParent();
+              if (IsNeighbor(parent, rg_info)) locs.insert(parent);
             }
           }
         }
@@ -286,16 +286,14 @@ std::unordered_set<LogicalLocation> LogicalLocation::GetPossibleNeighborsImpl(
       }
     }
   }
-  // The above procedure likely duplicated some blocks, so put them in a set
-  std::unordered_set<LogicalLocation> unique_locs;
-  for (auto &loc : locs)
-    unique_locs.emplace(std::move(loc));
-  return unique_locs;
+  // The above procedure likely duplicated some blocks
+  locs.Unique();
+  return locs;
 }
 
+template <class Locations>
 block_ownership_t
-DetermineOwnership(const LogicalLocation &main_block,
-                   const std::unordered_set<LogicalLocation> &allowed_neighbors,
+DetermineOwnership(const LogicalLocation &main_block, const Locations &allowed_neighbors,
                    const RootGridInfo &rg_info,
                    const std::unordered_set<LogicalLocation> &newly_refined) {
   block_ownership_t main_owns;
@@ -333,6 +331,13 @@ DetermineOwnership(const LogicalLocation &main_block,
   }
   return main_owns;
 }
+template block_ownership_t
+DetermineOwnership(const LogicalLocation &,
+                   const std::unordered_set<LogicalLocation> &, const RootGridInfo &,
+                   const std::unordered_set<LogicalLocation> &);
+template block_ownership_t
+DetermineOwnership(const LogicalLocation &, const PossibleNeighbors_t &,
+                   const RootGridInfo &, const std::unordered_set<LogicalLocation> &);
 
 // Given a topological element, ownership array of the sending block, and offset indices
 // defining the location of an index region within the block (i.e. the ghost zones passed
@@ -23,11 +23,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -38,7 +40,14 @@
 
 namespace parthenon {
 class LogicalLocation;
-}
+template <std::size_t N>
+class LogicalLocationSet;
+// Upper bound on the number of locations, including duplicates, that neighbor finding
+// visits: the 27 locations around a block and their parents, and the 27 locations
+// around each of its 8 daughters
+constexpr std::size_t max_possible_neighbors = 2 * 27 + 8 * 27;
+using PossibleNeighbors_t = LogicalLocationSet<max_possible_neighbors>;
+} // namespace parthenon
 
 // This must be declared before an unordered_set of LogicalLocation is used
 // below, but must be *implemented* after the class definition
@@ -156,10 +165,9 @@ class LogicalLocation { // aggregate and POD type
     return f;
   }
 
-  std::unordered_set<LogicalLocation>
-  GetPossibleNeighbors(const RootGridInfo &rg_info = RootGridInfo());
+  PossibleNeighbors_t GetPossibleNeighbors(const RootGridInfo &rg_info = RootGridInfo());
 
-  std::unordered_set<LogicalLocation> GetPossibleBlocksSurroundingTopologicalElement(
+  PossibleNeighbors_t GetPossibleBlocksSurroundingTopologicalElement(
       int ox1, int ox2, int ox3, const RootGridInfo &rg_info = RootGridInfo()) const;
 
  private:
@@ -167,7 +175,7 @@ class LogicalLocation { // aggregate and POD type
   bool NeighborFindingImpl(const LogicalLocation &in, const std::array<int, 3> &te_offset,
                            const RootGridInfo &rg_info = RootGridInfo()) const;
 
-  std::unordered_set<LogicalLocation> GetPossibleNeighborsImpl(
+  PossibleNeighbors_t GetPossibleNeighborsImpl(
       const std::vector<int> &irange, const std::vector<int> &jrange,
       const std::vector<int> &krange, const std::vector<int> &daughter_irange,
       const std::vector<int> &daughter_jrange, const std::vector<int> &daughter_krange,
@@ -189,6 +197,59 @@ inline bool operator==(const LogicalLocation &lhs, const LogicalLocation &rhs) {
           (lhs.lx2() == rhs.lx2()) && (lhs.lx3() == rhs.lx3()));
 }
 
+// A set of at most N locations stored inline, e.g., the candidate neighbors of a block,
+// so that neighbor finding on large meshes doesn't spend its time allocating hash sets.
+// insert appends and Unique sorts the locations and removes duplicates, which has to be
+// called before using count.  Storage is left uninitialized, since constructing N
+// locations would compute N Morton numbers.
+template <std::size_t N>
+class LogicalLocationSet {
+  static_assert(std::is_trivially_copyable<LogicalLocation>::value &&
+                    std::is_trivially_destructible<LogicalLocation>::value,
+                "LogicalLocations are kept in raw storage");
+
+ public:
+  LogicalLocationSet() = default;
+  LogicalLocationSet(const LogicalLocationSet &other) : size_(other.size_) {
+    std::copy(other.begin(), other.end(), begin());
+  }
+  LogicalLocationSet &operator=(const LogicalLocationSet &other) {
+    size_ = other.size_;
+    std::copy(other.begin(), other.end(), begin());
+    return *this;
+  }
+
+  template <class... Args>
+  void emplace(Args &&...args) {
+    PARTHENON_REQUIRE(size_ < N, "LogicalLocationSet is full");
+    new (data() + size_++) LogicalLocation(std::forward<Args>(args)...);
+  }
+  void insert(const LogicalLocation &loc) { emplace(loc); }
+  void Unique() {
+    std::sort(begin(), end());
+    size_ = std::unique(begin(), end()) - begin();
+  }
+  std::size_t count(const LogicalLocation &loc) const {
+    return std::binary_search(begin(), end(), loc);
+  }
+
+  LogicalLocation *begin() { return data(); }
+  LogicalLocation *end() { return data() + size_; }
+  const LogicalLocation *begin() const { return data(); }
+  const LogicalLocation *end() const { return data() + size_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  LogicalLocation *data() { return reinterpret_cast<LogicalLocation *>(storage_); }
+  const LogicalLocation *data() const {
+    return reinterpret_cast<const LogicalLocation *>(storage_);
+  }
+
+  alignas(LogicalLocation) unsigned char storage_[N * sizeof(LogicalLocation)];
+  std::size_t size_ = 0;
+};
+
 struct block_ownership_t {
  public:
   KOKKOS_FORCEINLINE_FUNCTION
@@ -220,9 +281,10 @@ struct block_ownership_t {
   bool ownership[3][3][3];
 };
 
+// Instantiated for allowed_neighbors an unordered_set or a PossibleNeighbors_t
+template <class Locations>
 block_ownership_t
-DetermineOwnership(const LogicalLocation &main_block,
-                   const std::unordered_set<LogicalLocation> &allowed_neighbors,
+DetermineOwnership(const LogicalLocation &main_block, const Locations &allowed_neighbors,
                    const RootGridInfo &rg_info = RootGridInfo(),
                    const std::unordered_set<LogicalLocation> &newly_refined = {});
 
@@ -0,0 +1,112 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "mesh/memory_report.hpp"
+
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "interface/meshblock_data.hpp"
+#include "interface/metadata.hpp"
+#include "interface/variable.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/meshblock.hpp"
+
+namespace parthenon {
+
+MemoryReport MemoryReport::Gather(Mesh *pmesh) {
+  MemoryReport report;
+
+  std::unordered_map<std::string, std::string> package_of;
+  for (const auto &[name, pkg] : pmesh->packages.AllPackages()) {
+    for (const auto &field : pkg->AllFields()) {
+      package_of[field.first.base_name] = name;
+    }
+    for (const auto &pool : pkg->AllSparsePools()) {
+      package_of[pool.first] = name;
+    }
+  }
+
+  for (auto &pmb : pmesh->block_list) {
+    const auto &stages = pmb->meshblock_data.Stages();
+    // the addresses of the arrays of this block counted so far
+    std::unordered_set<const void *> seen;
+    const auto count = [&seen](const auto &arr) -> std::uint64_t {
+      if (arr.size() == 0 || !seen.insert(arr.data()).second) return 0;
+      return arr.size() * sizeof(Real);
+    };
+    const auto add_stage = [&](const std::string &label,
+                               const std::shared_ptr<MeshBlockData<Real>> &stage) {
+      for (const auto &v : stage->GetVariableVector()) {
+        Bytes bytes;
+        bytes.data = count(v->data);
+        bytes.fluxes = count(v->FluxData());
+        bytes.coarse = count(v->coarse_s);
+        if (bytes.Total() == 0) continue;
+
+        report.variables[v->label()] += bytes;
+        const auto pkg = package_of.find(v->base_name());
+        report.packages[pkg == package_of.end() ? "unknown" : pkg->second] += bytes;
+        for (const auto &flag : v->metadata().Flags()) {
+          report.flags[flag.Name()] += bytes;
+        }
+        report.stages[label] += bytes;
+        if (v->IsSet(Metadata::OneCopy)) {
+          report.one_copy += bytes;
+        } else if (label != "base") {
+          report.stage_copies += bytes;
+        }
+        report.total += bytes;
+      }
+    };
+    add_stage("base", stages.at("base"));
+    for (const auto &[label, stage] : stages) {
+      if (label != "base") add_stage(label, stage);
+    }
+  }
+
+  report.comm_buffers = pmesh->GetBufferPoolSizeInBytes();
+  if (pmesh->variable_pool) report.variable_pool = pmesh->variable_pool->SizeInBytes();
+  return report;
+}
+
+void MemoryReport::Write(std::ostream &os) const {
+  const auto row = [&os](const std::string &label, const Bytes &bytes) {
+    os << "  " << std::left << std::setw(32) << label << std::right << std::setw(14)
+       << bytes.data << std::setw(14) << bytes.fluxes << std::setw(14) << bytes.coarse
+       << std::setw(14) << bytes.Total() << "\n";
+  };
+  const auto section = [&](const std::string &title,
+                           const std::map<std::string, Bytes> &entries) {
+    os << "# " << title << "\n";
+    for (const auto &[label, bytes] : entries) {
+      row(label, bytes);
+    }
+  };
+  os << "# bytes of device memory: data, fluxes, coarse buffers, total\n";
+  section("by variable", variables);
+  section("by package", packages);
+  section("by metadata flag", flags);
+  section("by stage", stages);
+  os << "# totals\n";
+  row("OneCopy variables", one_copy);
+  row("copies in other stages", stage_copies);
+  row("all variables", total);
+  os << "# communication buffers " << comm_buffers << "\n";
+  os << "# unused pooled variable memory " << variable_pool << "\n";
+}
+
+} // namespace parthenon
@@ -0,0 +1,57 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef MESH_MEMORY_REPORT_HPP_
+#define MESH_MEMORY_REPORT_HPP_
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace parthenon {
+
+class Mesh;
+
+// Device memory held by the variables and communication buffers of the blocks of this
+// rank.  Arrays that are shared by several stages of a block, i.e., OneCopy variables,
+// variables of shallow stages and the fluxes and coarse buffers of stage copies, are
+// counted once, for the first stage they are found in ("base" comes first).
+struct MemoryReport {
+  struct Bytes {
+    std::uint64_t data = 0, fluxes = 0, coarse = 0;
+    std::uint64_t Total() const { return data + fluxes + coarse; }
+    Bytes &operator+=(const Bytes &other) {
+      data += other.data;
+      fluxes += other.fluxes;
+      coarse += other.coarse;
+      return *this;
+    }
+  };
+
+  // keyed by variable label, by the package that registered the variable, by the
+  // Metadata flags set on the variable (so a variable shows up under each of its flags)
+  // and by the DataCollection stage owning the memory
+  std::map<std::string, Bytes> variables, packages, flags, stages;
+  // the OneCopy variables, and the copies of the other variables in stages other than
+  // "base", i.e., the memory added by multi-stage integrators
+  Bytes one_copy, stage_copies, total;
+  // buffers in Mesh::pool_map, and memory sitting in Mesh::variable_pool unused
+  std::uint64_t comm_buffers = 0, variable_pool = 0;
+
+  static MemoryReport Gather(Mesh *pmesh);
+  void Write(std::ostream &os) const;
+};
+
+} // namespace parthenon
+
+#endif // MESH_MEMORY_REPORT_HPP_
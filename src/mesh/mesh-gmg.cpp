@@ -24,7 +24,10 @@
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "parthenon_mpi.hpp"
 
@@ -128,10 +131,11 @@ void Mesh::SetSameLevelNeighbors(
       }
     }
     // Set neighbor block ownership
-    std::unordered_set<LogicalLocation> allowed_neighbors;
+    PossibleNeighbors_t allowed_neighbors;
     allowed_neighbors.insert(pmb->loc);
     for (auto &nb : *neighbor_list)
       allowed_neighbors.insert(nb.loc);
+    allowed_neighbors.Unique();
     for (auto &nb : *neighbor_list) {
       nb.ownership =
           DetermineOwnership(nb.loc, allowed_neighbors, root_grid, newly_refined);
@@ -140,6 +144,31 @@ void Mesh::SetSameLevelNeighbors(
   }
 }
 
+void Mesh::ResetNeighborOwnership(
+    BlockList_t &block_list, const std::unordered_set<LogicalLocation> &newly_refined) {
+  if (newly_refined.empty()) return;
+  const RootGridInfo root_grid = GetRootGridInfo();
+  for (auto &pmb : block_list) {
+    // Ownership only depends on the block and its neighbors, so it can only change if
+    // one of them is newly refined. The neighbor lists don't change at all.
+    bool changed = newly_refined.count(pmb->loc) > 0;
+    for (auto &nb : pmb->neighbors)
+      changed = changed || newly_refined.count(nb.loc) > 0;
+    if (!changed) continue;
+
+    PossibleNeighbors_t allowed_neighbors;
+    allowed_neighbors.insert(pmb->loc);
+    for (auto &nb : pmb->neighbors)
+      allowed_neighbors.insert(nb.loc);
+    allowed_neighbors.Unique();
+    for (auto &nb : pmb->neighbors) {
+      nb.ownership = DetermineOwnership(nb.loc, allowed_neighbors, root_grid);
+      nb.ownership.initialized = true;
+    }
+    pmb->pbval->SetNeighborOwnership();
+  }
+}
+
 void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app_in) {
   if (!multigrid) return;
   // Create GMG logical location lists, first just copy coarsest grid
@@ -155,17 +184,29 @@ void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app
   }
 
   const int gmg_min_level = root_level - gmg_level_offset;
+  const bool same_min_level = gmg_min_level == gmg_min_logical_level_;
   gmg_min_logical_level_ = gmg_min_level;
 
   const int gmg_levels = current_level - gmg_min_level + 1;
+
+  // When the hierarchy is rebuilt after a remesh, the internal nodes that are still
+  // internal nodes on this rank keep their MeshBlocks, so that only the part of the
+  // hierarchy above blocks that changed gets new blocks, and levels whose blocks are all
+  // unchanged keep their MeshData (see below)
+  std::unordered_map<LogicalLocation, std::shared_ptr<MeshBlock>> old_internal_blocks;
+  for (auto &blocks : gmg_block_lists) {
+    for (auto &pmb : blocks) {
+      if (pmb->lid < 0) old_internal_blocks[pmb->loc] = pmb;
+    }
+  }
+  const bool same_levels =
+      same_min_level && static_cast<int>(gmg_mesh_data.size()) == gmg_levels;
+  auto old_block_lists = std::move(gmg_block_lists);
+  auto old_mesh_data = std::move(gmg_mesh_data);
+
   gmg_grid_locs = std::vector<LogicalLocMap_t>(gmg_levels);
   gmg_block_lists = std::vector<BlockList_t>(gmg_levels);
 
-  // Create MeshData objects for GMG
-  gmg_mesh_data = std::vector<DataCollection<MeshData<Real>>>(gmg_levels);
-  for (auto &mdc : gmg_mesh_data)
-    mdc.SetMeshPointer(this);
-
   // Add leaf grid locations to GMG grid levels
   int gmg_gid = 0;
   for (auto loc : loclist) {
@@ -185,27 +226,81 @@ void Mesh::BuildGMGHierarchy(int nbs, ParameterInput *pin, ApplicationInput *app
     gmg_gid++;
   }
 
+  // Coarse GMG levels with few blocks are agglomerated onto the first
+  // gmg_agglomeration_ranks ranks, so that their smoothing and the communication on them
+  // stays within few ranks and most of the restriction and prolongation between levels
+  // is done in place rather than by many tiny messages across the machine
+  const int agglomeration_blocks =
+      pin->GetOrAddInteger("parthenon/mesh", "gmg_agglomeration_blocks", 0);
+  const int agglomeration_ranks = std::max(
+      1, std::min(Globals::nranks,
+                  pin->GetOrAddInteger("parthenon/mesh", "gmg_agglomeration_ranks", 1)));
+
   // Fill in internal nodes for GMG grid levels from levels on finer GMG grid
   for (int gmg_level = gmg_levels - 2; gmg_level >= 0; --gmg_level) {
     int grid_logical_level = gmg_level - gmg_levels + 1 + current_level;
+    // Internal nodes of this level with the rank of their first child
+    std::vector<std::pair<LogicalLocation, int>> parents;
     for (auto &[loc, gid_rank] : gmg_grid_locs[gmg_level + 1]) {
       if (loc.level() == grid_logical_level + 1) {
         auto parent = loc.GetParent();
         if (parent.morton() == loc.morton()) {
-          gmg_grid_locs[gmg_level].insert(
-              {parent, std::make_pair(gmg_gid, gid_rank.second)});
-          if (gid_rank.second == Globals::my_rank) {
-            BoundaryFlag block_bcs[6];
-            auto block_size = block_size_default;
-            SetBlockSizeAndBoundaries(parent, block_size, block_bcs);
-            gmg_block_lists[gmg_level].push_back(
-                MeshBlock::Make(gmg_gid, -1, parent, block_size, block_bcs, this, pin,
-                                app_in, packages, resolved_packages, gflag));
-          }
-          gmg_gid++;
+          parents.emplace_back(parent, gid_rank.second);
         }
       }
     }
+    const int nparents = parents.size();
+    int nblocks_level = nparents;
+    for (auto &[loc, gid_rank] : gmg_grid_locs[gmg_level]) {
+      if (loc.level() == grid_logical_level) nblocks_level++;
+    }
+    const bool agglomerate = nblocks_level <= agglomeration_blocks;
+    for (int n = 0; n < nparents; ++n) {
+      const auto &parent = parents[n].first;
+      // contiguous chunks in Morton order keep neighboring blocks on the same rank
+      const int rank = agglomerate
+                           ? static_cast<int>(static_cast<std::int64_t>(n) *
+                                              agglomeration_ranks / nparents)
+                           : parents[n].second;
+      gmg_grid_locs[gmg_level].insert({parent, std::make_pair(gmg_gid, rank)});
+      if (rank == Globals::my_rank) {
+        auto old_block = old_internal_blocks.find(parent);
+        if (old_block != old_internal_blocks.end()) {
+          old_block->second->gid = gmg_gid;
+          gmg_block_lists[gmg_level].push_back(old_block->second);
+        } else {
+          BoundaryFlag block_bcs[6];
+          auto block_size = block_size_default;
+          SetBlockSizeAndBoundaries(parent, block_size, block_bcs);
+          gmg_block_lists[gmg_level].push_back(
+              MeshBlock::Make(gmg_gid, -1, parent, block_size, block_bcs, this, pin,
+                              app_in, packages, resolved_packages, gflag));
+        }
+      }
+      gmg_gid++;
+    }
+  }
+
+  // A level keeps its MeshData, and with it the packs built for it by previous solves,
+  // if it consists of the same blocks as before.  Only the boundary buffer caches have
+  // to go, since the buffers are rebuilt after every remesh.
+  gmg_mesh_data = std::vector<DataCollection<MeshData<Real>>>(gmg_levels);
+  for (int gmg_level = 0; gmg_level < gmg_levels; ++gmg_level) {
+    if (same_levels && gmg_block_lists[gmg_level] == old_block_lists[gmg_level]) {
+      gmg_mesh_data[gmg_level] = std::move(old_mesh_data[gmg_level]);
+      for (auto &[label, md] : gmg_mesh_data[gmg_level].Stages())
+        md->ClearBoundaryCaches();
+    }
+    gmg_mesh_data[gmg_level].SetMeshPointer(this);
+  }
+
+  // The coarser and finer neighbors of blocks that were already part of the hierarchy
+  // are found again below
+  for (auto &blocks : gmg_block_lists) {
+    for (auto &pmb : blocks) {
+      pmb->gmg_coarser_neighbors.clear();
+      pmb->gmg_finer_neighbors.clear();
+    }
   }
 
   // Find same level neighbors on all GMG levels
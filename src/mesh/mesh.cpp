@@ -30,9 +30,11 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "amr_criteria/refinement_package.hpp"
 #include "basic_types.hpp"
 #include "bvals/comms/bvals_in_one.hpp"
 #include "parthenon_mpi.hpp"
@@ -171,6 +173,9 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
   if (app_in->PostStepDiagnosticsInLoop != nullptr) {
     PostStepUserDiagnosticsInLoop = app_in->PostStepDiagnosticsInLoop;
   }
+  if (app_in->AssignBlocks != nullptr) {
+    AssignBlocks = app_in->AssignBlocks;
+  }
   if (app_in->UserWorkAfterLoop != nullptr) {
     UserWorkAfterLoop = app_in->UserWorkAfterLoop;
   }
@@ -228,7 +233,6 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
   }
 
   // initialize user-enrollable functions
-  default_pack_size_ = pin->GetOrAddInteger("parthenon/mesh", "pack_size", -1);
 
   // calculate the logical root level and maximum level
   for (root_level = 0; (1 << root_level) < nbmax; root_level++) {
@@ -239,6 +243,23 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
 
   // Load balancing flag and parameters
   RegisterLoadBalancing_(pin);
+  CreateExecSpaces_(pin);
+  RegisterPackSize_(pin);
+  random_streams_ = RandomStreams(pin->GetOrAddInteger("parthenon/random", "seed", 0));
+
+  // Variables of new blocks reuse the memory of destroyed blocks
+  if (pin->GetOrAddBoolean("parthenon/mesh", "pool_variable_memory", false)) {
+    variable_pool = std::make_shared<VariableMemoryPool<Real>>();
+  }
+  mesh_wide_storage = pin->GetOrAddBoolean("parthenon/mesh", "mesh_wide_storage", false);
+  slab_allocation = pin->GetOrAddBoolean("parthenon/mesh", "slab_allocation", false) ||
+                    mesh_wide_storage;
+  slab_padding = pin->GetOrAddBoolean("parthenon/mesh", "slab_padding", false);
+  batch_allocation = pin->GetOrAddBoolean("parthenon/mesh", "batch_allocation", true);
+  // the geometric multigrid restricts into the coarse buffers of all leaf blocks
+  coarse_buffers_on_demand =
+      pin->GetOrAddBoolean("parthenon/mesh", "coarse_buffers_on_demand", false) &&
+      multilevel && !multigrid;
 
   // SMR / AMR:
   if (adaptive) {
@@ -341,15 +362,16 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
             if (l_region_max[dir - 1] % 2 == 0) l_region_max[dir - 1]++;
           }
         }
+        std::vector<LogicalLocation> nlocs;
         for (std::int64_t k = l_region_min[2]; k < l_region_max[2]; k += 2) {
           for (std::int64_t j = l_region_min[1]; j < l_region_max[1]; j += 2) {
             for (std::int64_t i = l_region_min[0]; i < l_region_max[0]; i += 2) {
-              LogicalLocation nloc(lrlev, i, j, k);
-              int nnew;
-              tree.AddMeshBlock(nloc, nnew);
+              nlocs.emplace_back(lrlev, i, j, k);
             }
           }
         }
+        int nnew;
+        tree.AddMeshBlocks(nlocs, nnew);
       }
       pib = pib->pnext;
     }
@@ -380,16 +402,6 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
 
   nslist = std::vector<int>(Globals::nranks);
   nblist = std::vector<int>(Globals::nranks);
-  if (adaptive) { // allocate arrays for AMR
-    nref = std::vector<int>(Globals::nranks);
-    nderef = std::vector<int>(Globals::nranks);
-    rdisp = std::vector<int>(Globals::nranks);
-    ddisp = std::vector<int>(Globals::nranks);
-    bnref = std::vector<int>(Globals::nranks);
-    bnderef = std::vector<int>(Globals::nranks);
-    brdisp = std::vector<int>(Globals::nranks);
-    bddisp = std::vector<int>(Globals::nranks);
-  }
 
   // initialize cost array with the simplest estimate; all the blocks are equal
   costlist = std::vector<double>(nbtotal, 1.0);
@@ -419,6 +431,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, Packages_t &packages,
   int nbs = nslist[Globals::my_rank];
   int nbe = nbs + nblist[Globals::my_rank] - 1;
   // create MeshBlock list for this process
+  BlockCreationBatch_ creation_batch(this);
   block_list.clear();
   block_list.resize(nbe - nbs + 1);
   for (int i = nbs; i <= nbe; i++) {
@@ -529,6 +542,9 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   if (app_in->PostStepDiagnosticsInLoop != nullptr) {
     PostStepUserDiagnosticsInLoop = app_in->PostStepDiagnosticsInLoop;
   }
+  if (app_in->AssignBlocks != nullptr) {
+    AssignBlocks = app_in->AssignBlocks;
+  }
   if (app_in->UserWorkAfterLoop != nullptr) {
     UserWorkAfterLoop = app_in->UserWorkAfterLoop;
   }
@@ -572,6 +588,23 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
 
   // Load balancing flag and parameters
   RegisterLoadBalancing_(pin);
+  CreateExecSpaces_(pin);
+  RegisterPackSize_(pin);
+  random_streams_ = RandomStreams(pin->GetOrAddInteger("parthenon/random", "seed", 0));
+
+  // Variables of new blocks reuse the memory of destroyed blocks
+  if (pin->GetOrAddBoolean("parthenon/mesh", "pool_variable_memory", false)) {
+    variable_pool = std::make_shared<VariableMemoryPool<Real>>();
+  }
+  mesh_wide_storage = pin->GetOrAddBoolean("parthenon/mesh", "mesh_wide_storage", false);
+  slab_allocation = pin->GetOrAddBoolean("parthenon/mesh", "slab_allocation", false) ||
+                    mesh_wide_storage;
+  slab_padding = pin->GetOrAddBoolean("parthenon/mesh", "slab_padding", false);
+  batch_allocation = pin->GetOrAddBoolean("parthenon/mesh", "batch_allocation", true);
+  // the geometric multigrid restricts into the coarse buffers of all leaf blocks
+  coarse_buffers_on_demand =
+      pin->GetOrAddBoolean("parthenon/mesh", "coarse_buffers_on_demand", false) &&
+      multilevel && !multigrid;
 
   // SMR / AMR
   if (adaptive) {
@@ -606,9 +639,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   // rebuild the Block Tree
   tree.CreateRootGrid();
 
-  for (int i = 0; i < nbtotal; i++) {
-    tree.AddMeshBlockWithoutRefine(loclist[i]);
-  }
+  tree.AddMeshBlocksWithoutRefine(loclist);
 
   int nnb;
   // check the tree structure, and assign GID
@@ -640,17 +671,6 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   nslist = std::vector<int>(Globals::nranks);
   nblist = std::vector<int>(Globals::nranks);
 
-  if (adaptive) { // allocate arrays for AMR
-    nref = std::vector<int>(Globals::nranks);
-    nderef = std::vector<int>(Globals::nranks);
-    rdisp = std::vector<int>(Globals::nranks);
-    ddisp = std::vector<int>(Globals::nranks);
-    bnref = std::vector<int>(Globals::nranks);
-    bnderef = std::vector<int>(Globals::nranks);
-    brdisp = std::vector<int>(Globals::nranks);
-    bddisp = std::vector<int>(Globals::nranks);
-  }
-
   CalculateLoadBalance(costlist, ranklist, nslist, nblist);
   PopulateLeafLocationMap();
 
@@ -676,6 +696,7 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
   SetupMPIComms();
 
   // Create MeshBlocks (parallel)
+  BlockCreationBatch_ creation_batch(this);
   block_list.clear();
   block_list.resize(nbe - nbs + 1);
   for (int i = nbs; i <= nbe; i++) {
@@ -700,10 +721,19 @@ Mesh::Mesh(ParameterInput *pin, ApplicationInput *app_in, RestartReader &rr,
 // destructor
 
 Mesh::~Mesh() {
+  Kokkos::fence();
+  for (auto &exec_space : exec_spaces_) {
+    SpaceInstance<DevExecSpace>::destroy(exec_space);
+  }
 #ifdef MPI_PARALLEL
-  // Cleanup MPI comms
+  // Cleanup MPI comms, which can be shared by several fields
+  std::vector<MPI_Comm> comms;
   for (auto &pair : mpi_comm_map_) {
-    PARTHENON_MPI_CHECK(MPI_Comm_free(&(pair.second)));
+    if (std::find(comms.begin(), comms.end(), pair.second) == comms.end())
+      comms.push_back(pair.second);
+  }
+  for (auto &comm : comms) {
+    PARTHENON_MPI_CHECK(MPI_Comm_free(&comm));
   }
   mpi_comm_map_.clear();
 #endif
@@ -862,14 +892,24 @@ void Mesh::EnrollBndryFncts_(ApplicationInput *app_in) {
       BoundaryFunction::ReflectInnerX1, BoundaryFunction::ReflectOuterX1,
       BoundaryFunction::ReflectInnerX2, BoundaryFunction::ReflectOuterX2,
       BoundaryFunction::ReflectInnerX3, BoundaryFunction::ReflectOuterX3};
+  static const MDBValFunc outflow_md[6] = {
+      BoundaryFunction::OutflowInnerX1MD, BoundaryFunction::OutflowOuterX1MD,
+      BoundaryFunction::OutflowInnerX2MD, BoundaryFunction::OutflowOuterX2MD,
+      BoundaryFunction::OutflowInnerX3MD, BoundaryFunction::OutflowOuterX3MD};
+  static const MDBValFunc reflect_md[6] = {
+      BoundaryFunction::ReflectInnerX1MD, BoundaryFunction::ReflectOuterX1MD,
+      BoundaryFunction::ReflectInnerX2MD, BoundaryFunction::ReflectOuterX2MD,
+      BoundaryFunction::ReflectInnerX3MD, BoundaryFunction::ReflectOuterX3MD};
 
   for (int f = 0; f < BOUNDARY_NFACES; f++) {
     switch (mesh_bcs[f]) {
     case BoundaryFlag::reflect:
       MeshBndryFnctn[f] = reflect[f];
+      MeshBndryFnctnMD[f] = reflect_md[f];
       break;
     case BoundaryFlag::outflow:
       MeshBndryFnctn[f] = outflow[f];
+      MeshBndryFnctnMD[f] = outflow_md[f];
       break;
     case BoundaryFlag::user:
       if (app_in->boundary_conditions[f] != nullptr) {
@@ -909,12 +949,63 @@ void Mesh::ApplyUserWorkBeforeOutput(ParameterInput *pin) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+// \!fn void Mesh::FillDerivedOnDemand()
+// \brief Call the FillDerivedOnDemand functions of all packages on the base data
+
+void Mesh::FillDerivedOnDemand() {
+  bool any = false;
+  for (const auto &pkg : packages.AllPackages()) {
+    any = any || pkg.second->HasFillDerivedOnDemand();
+  }
+  if (!any) return;
+  const int num_partitions = DefaultNumPartitions();
+  for (int i = 0; i < num_partitions; i++) {
+    auto &md = mesh_data.GetOrAdd("base", i);
+    Update::FillDerivedOnDemand(md.get());
+  }
+  for (auto &pmb : block_list) {
+    Update::FillDerivedOnDemand(pmb->meshblock_data.Get().get());
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn int Mesh::EvictVariables()
+// \brief Move the evictable variables of the base data of all blocks to host memory
+
+int Mesh::EvictVariables() {
+  int n = 0;
+  for (auto &pmb : block_list) {
+    n += pmb->meshblock_data.Get()->EvictVariables();
+  }
+  return n;
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn int Mesh::RestoreEvictedVariables()
+// \brief Copy the evicted variables of the base data of all blocks back to the device
+
+int Mesh::RestoreEvictedVariables() {
+  int n = 0;
+  for (auto &pmb : block_list) {
+    n += pmb->meshblock_data.Get()->RestoreVariables();
+  }
+  return n;
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Mesh::Initialize(bool init_problem, ParameterInput *pin)
 // \brief  initialization before the main loop as well as during remeshing
 
 void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *app_in) {
   PARTHENON_INSTRUMENT
+  BuildMeshWideStorage_();
+  if (auto_pack_size_) ResetPackSize_();
+  // local ids have been (re)assigned
+  sparse_allocation.Rebuild(block_list);
+  // while remeshing, blocks keep the coarse buffers used for prolongation and
+  // restriction until RedistributeAndRefineMeshBlocks is done
+  UpdateCoarseBuffers_(!remeshing_);
   bool init_done = true;
   const int nb_initial = nbtotal;
   do {
@@ -1034,6 +1125,7 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
         BuildGMGBoundaryBuffers(mdg);
       }
     }
+    CoalesceBoundaryBuffers(this);
 
     std::vector<bool> sent(num_partitions, false);
     bool all_sent;
@@ -1105,8 +1197,9 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
     }
 
     if (init_problem && adaptive) {
-      for (int i = 0; i < nmb; ++i) {
-        block_list[i]->pmr->CheckRefinementCondition();
+      for (int i = 0; i < num_partitions; i++) {
+        auto &md = mesh_data.GetOrAdd("base", i);
+        Refinement::Tag(md.get());
       }
     }
 
@@ -1136,6 +1229,19 @@ void Mesh::Initialize(bool init_problem, ParameterInput *pin, ApplicationInput *
 
   // Initialize the "base" MeshData object
   mesh_data.Get()->Set(block_list, this);
+
+  // A restart assigns each rank a contiguous range of blocks of equal size, so that
+  // every rank reads one contiguous piece of the file. Once their data is restored,
+  // e.g., the swarms that the particle balancer counts, the blocks are moved to
+  // match their cost.
+  if (!init_problem && !remeshing_ && lb_rebalance_on_restart_) {
+    lb_rebalance_on_restart_ = false;
+    UpdateCostList();
+    if (!GatherCostListAndCheckBalance()) {
+      RedistributeAndRefineMeshBlocks(pin, app_in, nbtotal);
+      remesh_count++;
+    }
+  }
 }
 
 /// Finds location of a block with ID `tgid`.
@@ -1247,28 +1353,253 @@ void Mesh::RegisterLoadBalancing_(ParameterInput *pin) {
 #ifdef MPI_PARALLEL // JMM: Not sure this ifdef is needed
   const std::string balancer =
       pin->GetOrAddString("parthenon/loadbalancing", "balancer", "default",
-                          std::vector<std::string>{"default", "automatic", "manual"});
+                          std::vector<std::string>{"default", "automatic", "manual",
+                                                   "particles"});
   if (balancer == "automatic") {
-    // JMM: I am disabling timing based load balancing, as it's not
-    // threaded through the infrastructure. I think some thought needs
-    // to go into doing this right with loops over meshdata rather
-    // than loops over data on a single meshblock.
-    PARTHENON_FAIL("Timing based load balancing is currently unavailable.");
+    // block costs are measured by the task lists with a cost meter, see
+    // TaskList::SetCostMeter, and by MeshData::StartTimeMeasurement/StopTimeMeasurement
     lb_automatic_ = true;
   } else if (balancer == "manual") {
     lb_manual_ = true;
+  } else if (balancer == "particles") {
+    lb_particles_ = true;
+    lb_block_cost_ = pin->GetOrAddReal("parthenon/loadbalancing", "block_cost", 1.0);
+    PARTHENON_REQUIRE_THROWS(lb_block_cost_ > 0.0, "block_cost must be positive");
   }
+  const std::string partitioner =
+      pin->GetOrAddString("parthenon/loadbalancing", "partitioner", "greedy",
+                          std::vector<std::string>{"greedy", "optimal", "diffusive"});
+  if (partitioner == "optimal") {
+    lb_partitioner_ = Partitioner::optimal;
+  } else if (partitioner == "diffusive") {
+    lb_partitioner_ = Partitioner::diffusive;
+  }
+  lb_max_migration_ =
+      pin->GetOrAddReal("parthenon/loadbalancing", "max_migration_fraction", 0.1);
+  lb_migration_cost_ =
+      pin->GetOrAddReal("parthenon/loadbalancing", "migration_cost", 0.0);
+  lb_aggregate_migration_ =
+      pin->GetOrAddBoolean("parthenon/loadbalancing", "aggregate_migration", false);
+  lb_rebalance_on_restart_ =
+      pin->GetOrAddBoolean("parthenon/loadbalancing", "rebalance_on_restart", false) &&
+      is_restart;
+  PARTHENON_REQUIRE_THROWS(lb_max_migration_ > 0.0 && lb_migration_cost_ >= 0.0,
+                           "max_migration_fraction must be positive and migration_cost "
+                           "must not be negative");
   lb_tolerance_ = pin->GetOrAddReal("parthenon/loadbalancing", "tolerance", 0.5);
   lb_interval_ = pin->GetOrAddInteger("parthenon/loadbalancing", "interval", 10);
 #endif // MPI_PARALLEL
+  check_interval_ =
+      pin->GetOrAddInteger("parthenon/mesh", "refinement_check_interval", 1);
+  adapt_check_interval_ =
+      pin->GetOrAddBoolean("parthenon/mesh", "adapt_check_interval", false);
+  max_check_interval_ = pin->GetOrAddInteger("parthenon/mesh", "max_check_interval", 16);
+  check_cost_fraction_ = pin->GetOrAddReal("parthenon/mesh", "check_cost_fraction", 0.01);
+  refinement_buffer_ = pin->GetOrAddInteger("parthenon/mesh", "refinement_buffer", 0);
+  PARTHENON_REQUIRE_THROWS(check_interval_ > 0 && max_check_interval_ > 0,
+                           "refinement_check_interval and max_check_interval must be "
+                           "positive");
+  PARTHENON_REQUIRE_THROWS(refinement_buffer_ >= 0,
+                           "refinement_buffer must not be negative");
+  if (adapt_check_interval_) {
+    check_interval_ = std::min(check_interval_, max_check_interval_);
+  }
+}
+
+void Mesh::CreateExecSpaces_(ParameterInput *pin) {
+  const int nstreams = pin->GetOrAddInteger("parthenon/mesh", "num_streams", 0);
+  PARTHENON_REQUIRE_THROWS(nstreams >= 0, "num_streams must not be negative");
+  // without a backend that can overlap work on different instances they would only
+  // add overhead
+  if (!SpaceInstance<DevExecSpace>::overlap()) return;
+  for (int s = 0; s < nstreams; s++) {
+    exec_spaces_.push_back(SpaceInstance<DevExecSpace>::create());
+  }
+}
+
+void Mesh::RegisterPackSize_(ParameterInput *pin) {
+  hilbert_partitions_ =
+      pin->GetOrAddString("parthenon/mesh", "partition_order", "tree",
+                          std::vector<std::string>{"tree", "hilbert"}) == "hilbert";
+  const std::string pack_size =
+      pin->GetOrAddString("parthenon/mesh", "pack_size", "-1");
+  auto_pack_size_ = pack_size == "auto";
+  if (!auto_pack_size_) {
+    default_pack_size_ = std::stoi(pack_size);
+    return;
+  }
+  pack_size_tune_cycles_ =
+      pin->GetOrAddInteger("parthenon/mesh", "pack_size_tune_cycles", 0);
+  PARTHENON_REQUIRE_THROWS(pack_size_tune_cycles_ >= 0,
+                           "pack_size_tune_cycles must not be negative");
+}
+
+// The smallest packs whose cells still keep all threads of the device (or of the host
+// backend) busy, since smaller packs overlap better with communication and stay in
+// cache, but at least one partition per execution space instance
+int Mesh::ChoosePackSize_() const {
+  const int nblocks = block_list.size();
+  if (nblocks == 0) return -1;
+  // on devices concurrency() is the number of resident threads, which should get a
+  // cell each, while host threads should get chunks of at least a small block
+  constexpr std::int64_t cells_per_thread =
+      std::is_same<DevExecSpace, HostExecSpace>::value ? 4096 : 1;
+  const std::int64_t cells = cells_per_thread * DevExecSpace().concurrency();
+  const std::int64_t block_cells = GetNumberOfMeshBlockCells();
+  int pack_size = (cells + block_cells - 1) / block_cells;
+  const int nspaces = std::max<int>(1, exec_spaces_.size());
+  pack_size = std::min(pack_size, partition::partition_impl::IntCeil(nblocks, nspaces));
+  return std::max(1, std::min(pack_size, nblocks));
+}
+
+void Mesh::ResetPackSize_() {
+  default_pack_size_ = ChoosePackSize_();
+  pack_size_candidates_.clear();
+  pack_size_times_.clear();
+  pack_size_candidate_ = 0;
+  pack_size_cycles_ = -1;
+  if (pack_size_tune_cycles_ == 0) return;
+  // always three candidates, also on ranks without blocks, which keep their default,
+  // so that all ranks take part in the same reductions
+  const int nblocks = block_list.size();
+  if (nblocks == 0) {
+    pack_size_candidates_.assign(3, default_pack_size_);
+  } else {
+    pack_size_candidates_ = {default_pack_size_, std::max(1, default_pack_size_ / 2),
+                             std::min(nblocks, 2 * default_pack_size_)};
+  }
+  pack_size_times_.assign(pack_size_candidates_.size(), 0.0);
+}
+
+bool Mesh::TunePackSize(const double step_seconds) {
+  const int ncandidates = pack_size_candidates_.size();
+  if (!auto_pack_size_ || pack_size_tune_cycles_ == 0 ||
+      pack_size_candidate_ >= ncandidates) {
+    return false;
+  }
+  if (pack_size_cycles_++ < 0) return false;
+  // ranks without blocks don't slow down the step of any candidate
+  if (!block_list.empty()) pack_size_times_[pack_size_candidate_] += step_seconds;
+  if (pack_size_cycles_ < pack_size_tune_cycles_) return false;
+#ifdef MPI_PARALLEL
+  // the step is as slow as the slowest rank
+  PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &pack_size_times_[pack_size_candidate_],
+                                    1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD));
+#endif
+  pack_size_cycles_ = -1;
+  int pack_size;
+  if (++pack_size_candidate_ < ncandidates) {
+    pack_size = pack_size_candidates_[pack_size_candidate_];
+  } else {
+    const auto fastest =
+        std::min_element(pack_size_times_.begin(), pack_size_times_.end());
+    pack_size = pack_size_candidates_[fastest - pack_size_times_.begin()];
+  }
+  int changed = (pack_size != default_pack_size_);
+#ifdef MPI_PARALLEL
+  // the boundary buffers are rebuilt by all ranks together
+  PARTHENON_MPI_CHECK(
+      MPI_Allreduce(MPI_IN_PLACE, &changed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD));
+#endif
+  if (!changed) return false;
+  default_pack_size_ = pack_size;
+  remesh_count++;
+  mesh_data.PurgeNonBase();
+  mesh_data.Get()->ClearCaches();
+  for (auto &gmg_data : gmg_mesh_data) {
+    gmg_data.PurgeNonBase();
+  }
+  return true;
+}
+
+Mesh::BlockCreationBatch_::BlockCreationBatch_(Mesh *pmesh) : pmesh_(pmesh) {
+  if (!pmesh_->batch_allocation) return;
+  if (!pmesh_->variable_pool) {
+    // chunks outliving the pool are freed with the last Variable using them
+    pmesh_->variable_pool = std::make_shared<VariableMemoryPool<Real>>();
+    temporary_pool_ = true;
+  }
+  batch_ = std::make_unique<VariableMemoryPool<Real>::Batch>(pmesh_->variable_pool);
+}
+
+Mesh::BlockCreationBatch_::~BlockCreationBatch_() {
+  batch_.reset();
+  if (temporary_pool_) pmesh_->variable_pool.reset();
+}
+
+void Mesh::BuildMeshWideStorage_() {
+  if (!mesh_wide_storage || block_list.empty()) return;
+  const std::size_t stride = block_list[0]->meshblock_data.Get()->GetSlab().size();
+  const std::size_t size = stride * block_list.size();
+  bool in_place = mesh_wide_chunk_ != nullptr && mesh_wide_chunk_->size() == size;
+  for (std::size_t b = 0; in_place && b < block_list.size(); b++) {
+    const auto &slab = block_list[b]->meshblock_data.Get()->GetSlab();
+    in_place = slab.data() == mesh_wide_chunk_->data() + b * stride;
+  }
+  if (in_place || size == 0) return;
+
+  using chunk_t = Kokkos::View<Real *, DevMemSpace>;
+  std::shared_ptr<chunk_t> chunk;
+  if (variable_pool) {
+    chunk = variable_pool->Get(size);
+  } else {
+    chunk = std::make_shared<chunk_t>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Mesh::mesh_wide_storage"), size);
+  }
+  for (std::size_t b = 0; b < block_list.size(); b++) {
+    auto &pmb = block_list[b];
+    PARTHENON_REQUIRE_THROWS(pmb->meshblock_data.Get()->GetSlab().size() == stride,
+                             "All blocks need slabs of the same size");
+    pmb->meshblock_data.Get()->MoveSlab(chunk, b * stride);
+    // stages sharing variables with the base stage have packs of the old data
+    for (auto &stage : pmb->meshblock_data.Stages()) {
+      stage.second->ClearCaches();
+    }
+  }
+  mesh_wide_chunk_ = chunk;
+  mesh_data.PurgeNonBase();
+  mesh_data.Get()->ClearCaches();
+}
+
+void Mesh::UpdateCoarseBuffers_(const bool release) {
+  if (!coarse_buffers_on_demand) return;
+  for (auto &pmb : block_list) {
+    // only blocks next to a coarser block restrict into or prolongate from their coarse
+    // buffers when communicating
+    const int level = pmb->loc.level();
+    const bool needed =
+        std::any_of(pmb->neighbors.begin(), pmb->neighbors.end(),
+                    [level](const NeighborBlock &nb) { return nb.snb.level < level; });
+    if (needed || release) pmb->SetCoarseBuffers(needed);
+  }
+}
+
+Mesh::mesh_wide_view_t Mesh::GetMeshWideData(const std::string &label) const {
+  PARTHENON_REQUIRE_THROWS(mesh_wide_chunk_ != nullptr,
+                           "Mesh wide storage is not enabled or not built yet");
+  const auto &mbd = block_list[0]->meshblock_data.Get();
+  const auto &v = mbd->GetVarPtr(label);
+  const auto &slab = mbd->GetSlab();
+  const Real *ptr = v->data.data();
+  PARTHENON_REQUIRE_THROWS(v->IsAllocated() && ptr >= slab.data() &&
+                               ptr < slab.data() + slab.size(),
+                           "Variable " + label + " is not in the mesh wide storage");
+  const int ni = v->GetDim(1), nj = v->GetDim(2), nk = v->GetDim(3);
+  const int ncomp = v->GetDim(4) * v->GetDim(5) * v->GetDim(6) * v->GetDim(7);
+  Kokkos::LayoutStride layout(block_list.size(), slab.size(), ncomp, nk * nj * ni, nk,
+                              nj * ni, nj, ni, ni, 1);
+  return mesh_wide_view_t(v->data.data(), layout);
 }
 
-// Create separate communicators for all variables. Needs to be done at the mesh
+// Create separate communicators for all variables (or for every fields_per_comm of
+// them, see parthenon/comms/fields_per_comm). Needs to be done at the mesh
 // level so that the communicators for each variable across all blocks is consistent.
 // As variables are identical across all blocks, we just use the info from the first.
 void Mesh::SetupMPIComms() {
-#ifdef MPI_PARALLEL
-
+  // Fields are grouped by label, so that every rank puts the same fields in the same
+  // slot of the same communicator
+  const int fields_per_comm = Globals::comm_config.fields_per_comm;
+  std::vector<std::string> labels;
   for (auto &pair : resolved_packages->AllFields()) {
     auto &metadata = pair.second;
     // Create both boundary and flux communicators for everything with either FillGhost
@@ -1277,26 +1608,59 @@ void Mesh::SetupMPIComms() {
         metadata.IsSet(Metadata::ForceRemeshComm) ||
         metadata.IsSet(Metadata::GMGProlongate) ||
         metadata.IsSet(Metadata::GMGRestrict)) {
-      MPI_Comm mpi_comm;
-      PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm));
-      const auto ret = mpi_comm_map_.insert({pair.first.label(), mpi_comm});
-      PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
+      labels.push_back(pair.first.label());
+    }
+  }
+  std::sort(labels.begin(), labels.end());
+  mpi_comm_slot_map_.clear();
+  if (fields_per_comm > 1) {
+    for (int n = 0; n < labels.size(); ++n) {
+      mpi_comm_slot_map_[labels[n]] = n % fields_per_comm;
+    }
+  }
+  tag_map.SetNumSlots(fields_per_comm);
 
+#ifdef MPI_PARALLEL
+  MPI_Comm field_comm, field_comm_flcor;
+  for (int n = 0; n < labels.size(); ++n) {
+    if (n % fields_per_comm == 0) {
+      PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &field_comm));
       if (multilevel) {
-        MPI_Comm mpi_comm_flcor;
-        PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm_flcor));
-        const auto ret =
-            mpi_comm_map_.insert({pair.first.label() + "_flcor", mpi_comm_flcor});
-        PARTHENON_REQUIRE_THROWS(ret.second,
-                                 "Flux corr. communicator with same name already in map");
+        PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &field_comm_flcor));
       }
     }
+    const auto ret = mpi_comm_map_.insert({labels[n], field_comm});
+    PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
+
+    if (multilevel) {
+      const auto ret = mpi_comm_map_.insert({labels[n] + "_flcor", field_comm_flcor});
+      PARTHENON_REQUIRE_THROWS(ret.second,
+                               "Flux corr. communicator with same name already in map");
+    }
+  }
+  if (Globals::comm_config.coalesce_messages || Globals::comm_config.rma_comm) {
+    MPI_Comm mpi_comm;
+    PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm));
+    const auto ret = mpi_comm_map_.insert({coalesced_comm_label, mpi_comm});
+    PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
+  }
+  if (lb_aggregate_migration_) {
+    MPI_Comm mpi_comm;
+    PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm));
+    const auto ret = mpi_comm_map_.insert({migration_comm_label, mpi_comm});
+    PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
   }
   for (auto &pair : resolved_packages->AllSwarms()) {
     MPI_Comm mpi_comm;
     PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm));
     const auto ret = mpi_comm_map_.insert({pair.first, mpi_comm});
     PARTHENON_REQUIRE_THROWS(ret.second, "Communicator with same name already in map");
+    MPI_Comm aggregated_comm;
+    PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &aggregated_comm));
+    const auto ret_agg = mpi_comm_map_.insert(
+        {pair.first + aggregated_swarm_comm_suffix, aggregated_comm});
+    PARTHENON_REQUIRE_THROWS(ret_agg.second,
+                             "Communicator with same name already in map");
   }
   // TODO(everying during a sync) we should discuss what to do with face vars as they
   // are currently not handled in pmb->meshblock_data.Get()->SetupPersistentMPI(); nor
@@ -43,7 +43,9 @@
 #include "domain.hpp"
 #include "interface/data_collection.hpp"
 #include "interface/mesh_data.hpp"
+#include "interface/sparse_allocation_map.hpp"
 #include "interface/state_descriptor.hpp"
+#include "interface/variable_pool.hpp"
 #include "kokkos_abstraction.hpp"
 #include "mesh/meshblock_pack.hpp"
 #include "mesh/meshblock_tree.hpp"
@@ -54,15 +56,19 @@
 #include "utils/hash.hpp"
 #include "utils/object_pool.hpp"
 #include "utils/partition_stl_containers.hpp"
+#include "utils/random.hpp"
 
 namespace parthenon {
 
 // Forward declarations
+struct AggregatedSwarmComms;
 class BoundaryValues;
 class MeshBlock;
 class MeshRefinement;
 class ParameterInput;
 class RestartReader;
+class RMAWindow;
+class SharedMemoryWindow;
 
 // Map from LogicalLocation to (gid, rank) pair of location
 using LogicalLocMap_t = std::map<LogicalLocation, std::pair<int, int>>;
@@ -102,6 +108,9 @@ class Mesh {
 
   // data
   bool modified;
+  // number of times remeshing changed the blocks (or TunePackSize the partitions),
+  // e.g., to key a KernelGraph
+  std::uint64_t remesh_count = 0;
   const bool is_restart;
   RegionSize mesh_size;
   RegionSize base_block_size;
@@ -114,6 +123,22 @@ class Mesh {
   int step_since_lb;
   int gflag;
 
+  // Wall clock time this rank has spent in each phase of remeshing since the start of
+  // the run.  tag is spent in Refinement::Tag, buffers is spent rebuilding the
+  // boundary buffers after the mesh changed (done by the driver), redistribute is the
+  // rest of RedistributeAndRefineMeshBlocks except for initializing the new blocks.
+  struct RemeshTimes {
+    double tag = 0.0, tree = 0.0, costs = 0.0, redistribute = 0.0, initialize = 0.0,
+           buffers = 0.0;
+  };
+  RemeshTimes remesh_times;
+  // Number of cycles between checks of the refinement flags in the main loop, see
+  // LoadBalancingAndAdaptiveMeshRefinement
+  int GetRefinementCheckInterval() const { return check_interval_; }
+  // True if the next call of LoadBalancingAndAdaptiveMeshRefinement from the main loop
+  // checks the refinement flags, e.g. to skip tagging in between
+  bool RefinementCheckDue() const { return cycles_since_check_ + 1 >= check_interval_; }
+
   BlockList_t block_list;
   Packages_t packages;
   std::shared_ptr<StateDescriptor> resolved_packages;
@@ -132,14 +157,37 @@ class Mesh {
   bool SetBlockSizeAndBoundaries(LogicalLocation loc, RegionSize &block_size,
                                  BoundaryFlag *block_bcs);
   void OutputCycleDiagnostics();
+  // The refinement flags are only checked every GetRefinementCheckInterval() calls
+  // with use_check_interval set, e.g. from the main loop, and on every other call
   void LoadBalancingAndAdaptiveMeshRefinement(ParameterInput *pin,
-                                              ApplicationInput *app_in);
+                                              ApplicationInput *app_in,
+                                              bool use_check_interval = false);
   int DefaultPackSize() {
     return default_pack_size_ < 1 ? block_list.size() : default_pack_size_;
   }
   int DefaultNumPartitions() {
     return partition::partition_impl::IntCeil(block_list.size(), DefaultPackSize());
   }
+  // With parthenon/mesh/partition_order = hilbert, the blocks are split into partitions
+  // along a Hilbert curve rather than in the order of block_list
+  bool HilbertPartitions() const { return hilbert_partitions_; }
+  // Counter-based random numbers seeded by parthenon/random/seed, see utils/random.hpp
+  const RandomStreams &GetRandomStreams() const { return random_streams_; }
+  // With parthenon/mesh/pack_size = auto and pack_size_tune_cycles > 0, compares the
+  // step times of the automatic pack size with those of half and twice that size, over
+  // pack_size_tune_cycles cycles each, and keeps the fastest.  Called by the driver
+  // with the wall time of every step.  Returns true if the pack size changed, in which
+  // case the MeshData partitions are purged and the boundary buffers must be rebuilt.
+  bool TunePackSize(const double step_seconds);
+  // Execution space instance the kernels of the MeshData of the given partition are
+  // launched on.  With parthenon/mesh/num_streams > 0 partitions are spread round robin
+  // over that many instances, so that the task lists of different partitions can
+  // overlap on the device.  Otherwise, this is the default instance.
+  DevExecSpace GetExecSpace(const int partition) const {
+    if (exec_spaces_.empty()) return DevExecSpace();
+    return exec_spaces_[partition % exec_spaces_.size()];
+  }
+  int NumExecSpaces() const { return exec_spaces_.size(); }
   // step 7: create new MeshBlock list (same MPI rank but diff level: create new block)
   // Moved here given Cuda/nvcc restriction:
   // "error: The enclosing parent function ("...")
@@ -152,9 +200,17 @@ class Mesh {
   std::shared_ptr<MeshBlock> FindMeshBlock(int tgid) const;
 
   void ApplyUserWorkBeforeOutput(ParameterInput *pin);
+  // fills the derived fields of the packages that compute them on demand
+  void FillDerivedOnDemand();
+  // evict or restore the Metadata::Evictable variables of the base data of all blocks,
+  // returning the number of variables evicted or restored on this rank
+  int EvictVariables();
+  int RestoreEvictedVariables();
 
   // Boundary Functions
   BValFunc MeshBndryFnctn[BOUNDARY_NFACES];
+  // the MeshData versions of the built-in boundary conditions, empty for user conditions
+  MDBValFunc MeshBndryFnctnMD[BOUNDARY_NFACES];
   SBValFunc SwarmBndryFnctn[BOUNDARY_NFACES];
   std::array<std::vector<BValFunc>, BOUNDARY_NFACES> UserBoundaryFunctions;
 
@@ -184,6 +240,22 @@ class Mesh {
   std::function<void(Mesh *, ParameterInput *, SimTime const &)>
       PostStepUserDiagnosticsInLoop = PostStepUserDiagnosticsInLoopDefault;
 
+  // user supplied assignment of blocks to ranks, see ApplicationInput::AssignBlocks
+  std::function<void(std::vector<double> const &, std::vector<int> &)> AssignBlocks =
+      nullptr;
+
+  // whether block costs are measured, see MeshBlock::MakeCostMeter
+  bool AutomaticLoadBalancing() const noexcept { return lb_automatic_; }
+
+  // With <parthenon/loadbalancing>/balancer = particles, the cost of a block is the
+  // block_cost option plus the number of active particles of each registered swarm
+  // times its cost per particle
+  void SetParticleCostForLoadBalancing(const std::string &swarm_name,
+                                       const double cost) {
+    PARTHENON_REQUIRE_THROWS(cost >= 0.0, "Particle costs must not be negative");
+    lb_particle_costs_[swarm_name] = cost;
+  }
+
   int GetRootLevel() const noexcept { return root_level; }
   RootGridInfo GetRootGridInfo() const noexcept {
     return RootGridInfo(
@@ -222,10 +294,30 @@ class Mesh {
       std::unordered_map<channel_key_t, comm_buf_t, tuple_hash<channel_key_t>>;
   comm_buf_map_t boundary_comm_map, boundary_comm_flxcor_map;
   TagMap tag_map;
+  // window holding the boundary messages between ranks on the same node, see
+  // parthenon/comms/shared_memory_comm.  Freeing it is collective over the node, so it
+  // is only released by CoalesceBoundaryBuffers and the destructor.
+  std::shared_ptr<SharedMemoryWindow> shared_memory_window;
+  // the same for the window of the one-sided boundary messages, which is collective
+  // over all ranks, see parthenon/comms/rma_comm
+  std::shared_ptr<RMAWindow> rma_window;
+  // communicator used for coalesced boundary messages and for setting up the RMA ones,
+  // see CoalesceBoundaryBuffers
+  static constexpr const char *coalesced_comm_label = "parthenon::coalesced_boundaries";
+  static constexpr const char *migration_comm_label = "parthenon::block_migration";
+  // appended to the name of a swarm for the communicator of its rank-aggregated
+  // messages, which must not match the messages between blocks, see SendSwarmAggregated
+  static constexpr const char *aggregated_swarm_comm_suffix = "_aggregated";
 
 #ifdef MPI_PARALLEL
   MPI_Comm GetMPIComm(const std::string &label) const { return mpi_comm_map_.at(label); }
 #endif
+  // Position of a field in the communicator it shares with other fields, which offsets
+  // its tags, see parthenon/comms/fields_per_comm.  0 for everything else.
+  int GetMPICommSlot(const std::string &label) const {
+    const auto it = mpi_comm_slot_map_.find(label);
+    return it == mpi_comm_slot_map_.end() ? 0 : it->second;
+  }
 
   void SetAllVariablesToInitialized() {
     for (auto &sp_mb : block_list) {
@@ -236,6 +328,37 @@ class Mesh {
     }
   }
 
+  // Recycles the memory of the Variables of destroyed blocks, e.g. those derefined by
+  // remeshing, for new blocks.  Only set if <parthenon/mesh>/pool_variable_memory is
+  // true.
+  std::shared_ptr<VariableMemoryPool<Real>> variable_pool;
+  // allocation status of the sparse variables of the blocks of this rank, see
+  // SparseAllocationMap
+  SparseAllocationMap sparse_allocation;
+  // messages of the rank-aggregated communication of each swarm, see
+  // SendSwarmAggregated
+  std::map<std::string, std::shared_ptr<AggregatedSwarmComms>> aggregated_swarm_comms;
+  // allocate the data of the dense variables of a block as one slab, see
+  // MeshBlockData::GetSlab
+  bool slab_allocation = false;
+  // pad the variables in a slab, and the slabs themselves, so that their sizes are not
+  // multiples of 4 KiB, see MeshBlockData::AllocateSlab_
+  bool slab_padding = false;
+  // keep the slabs of all blocks of this rank, in the order of block_list, in one array
+  // (implies slab_allocation), see GetMeshWideData
+  bool mesh_wide_storage = false;
+  // zero the variables of all blocks created at once (at startup and while remeshing)
+  // with a single kernel, see BlockCreationBatch_
+  bool batch_allocation = true;
+  // only keep the coarse buffers of blocks that have a coarser neighbor (or are being
+  // remeshed), see UpdateCoarseBuffers_
+  bool coarse_buffers_on_demand = false;
+  // A dense variable across all blocks of this rank, indexed as (block, component, k, j,
+  // i) where block is the index in block_list and component the flattened index of the
+  // remaining dimensions.  Valid until the next remesh.
+  using mesh_wide_view_t = Kokkos::View<Real *****, Kokkos::LayoutStride, DevMemSpace>;
+  mesh_wide_view_t GetMeshWideData(const std::string &label) const;
+
   uint64_t GetBufferPoolSizeInBytes() const {
     std::uint64_t buffer_memory = 0;
     for (auto &p : pool_map) {
@@ -262,15 +385,6 @@ class Mesh {
   std::vector<int> nblist;
   /// Maps global block ID to its cost
   std::vector<double> costlist;
-  // 8x arrays used exclusively for AMR (not SMR):
-  /// Count of blocks to refine on each rank
-  std::vector<int> nref;
-  /// Count of blocks to de-refine on each rank
-  std::vector<int> nderef;
-  std::vector<int> rdisp, ddisp;
-  std::vector<int> bnref, bnderef;
-  std::vector<int> brdisp, bddisp;
-  // the last 4x should be std::size_t, but are limited to int by MPI
 
   std::vector<LogicalLocation> loclist;
   MeshBlockTree tree;
@@ -283,11 +397,54 @@ class Mesh {
 
   // variables for load balancing control
   bool lb_flag_, lb_automatic_, lb_manual_;
+  // whether it was reported that the automatic balancer did not measure any cost
+  bool lb_unmeasured_warned_ = false;
+  // block costs from the number of particles, see SetParticleCostForLoadBalancing
+  bool lb_particles_ = false;
+  double lb_block_cost_ = 1.0;
+  std::map<std::string, double> lb_particle_costs_;
+  enum class Partitioner { greedy, optimal, diffusive };
+  Partitioner lb_partitioner_ = Partitioner::greedy;
+  // largest fraction of blocks the diffusive partitioner moves in one rebalance
+  double lb_max_migration_ = 0.1;
+  // cost of migrating one block, relative to the average cost of a block
+  double lb_migration_cost_ = 0.0;
+  // send all variables of a block that moves to another rank in a single message
+  bool lb_aggregate_migration_ = false;
+  // rebalance the blocks read from a restart file once their data is restored
+  bool lb_rebalance_on_restart_ = false;
   double lb_tolerance_;
   int lb_interval_;
 
+  // variables for the interval between refinement checks
+  int check_interval_ = 1, max_check_interval_ = 1, cycles_since_check_ = 0;
+  // grow the interval while checks cost more than this fraction of the time between
+  // them without changing any blocks, shrink it when blocks change
+  bool adapt_check_interval_ = false;
+  double check_cost_fraction_ = 0.01;
+  Kokkos::Timer check_timer_;
+  RemeshTimes check_times_;
+  void AdaptRefinementCheckInterval(bool changed);
+  // also refine the leaves within refinement_buffer_ blocks of the blocks in lref, in
+  // place, and drop the parents in lderef that would lose a refined child, so that
+  // features moving between checks stay on the finest level
+  int refinement_buffer_ = 0;
+  void BufferRefinement_(std::vector<LogicalLocation> &lref,
+                         std::vector<LogicalLocation> &lderef);
+
   // size of default MeshBlockPacks
-  int default_pack_size_;
+  int default_pack_size_ = -1;
+  bool hilbert_partitions_ = false;
+  RandomStreams random_streams_;
+  // choose default_pack_size_ whenever the blocks change, see TunePackSize
+  bool auto_pack_size_ = false;
+  int pack_size_tune_cycles_ = 0;
+  // the pack sizes compared by TunePackSize, their summed step times, the one that is
+  // being measured and the number of cycles it has been measured for (-1 while the
+  // caches of the new partitions are built)
+  std::vector<int> pack_size_candidates_;
+  std::vector<double> pack_size_times_;
+  int pack_size_candidate_ = 0, pack_size_cycles_ = 0;
 
   int gmg_min_logical_level_ = 0;
 
@@ -295,16 +452,23 @@ class Mesh {
   // Global map of MPI comms for separate variables
   std::unordered_map<std::string, MPI_Comm> mpi_comm_map_;
 #endif
+  std::unordered_map<std::string, int> mpi_comm_slot_map_;
 
   // functions
+  // prev_ranklist, if given, is the rank each block is currently on
   void CalculateLoadBalance(std::vector<double> const &costlist,
                             std::vector<int> &ranklist, std::vector<int> &nslist,
-                            std::vector<int> &nblist);
+                            std::vector<int> &nblist,
+                            std::vector<int> const *prev_ranklist = nullptr);
+  void AssignBlocksToRanks(std::vector<double> const &costlist,
+                           std::vector<int> &ranklist,
+                           std::vector<int> const *prev_ranklist);
   void ResetLoadBalanceVariables();
 
   // Mesh::LoadBalancingAndAdaptiveMeshRefinement() helper functions:
   void UpdateCostList();
   void UpdateMeshBlockTree(int &nnew, int &ndel);
+  void GatherCostList();
   bool GatherCostListAndCheckBalance();
   void RedistributeAndRefineMeshBlocks(ParameterInput *pin, ApplicationInput *app_in,
                                        int ntot);
@@ -314,6 +478,10 @@ class Mesh {
                         RootGridInfo root_grid, int nbs, bool gmg_neighbors,
                         int composite_logical_level = 0,
                         const std::unordered_set<LogicalLocation> &newly_refined = {});
+  // Recompute the ownership of shared elements with the regular precedence, after it
+  // was determined with precedence for the "old" fine blocks over newly_refined ones
+  void ResetNeighborOwnership(BlockList_t &block_list,
+                              const std::unordered_set<LogicalLocation> &newly_refined);
   // defined in either the prob file or default_pgen.cpp in ../pgen/
   static void InitUserMeshDataDefault(Mesh *mesh, ParameterInput *pin);
   std::function<void(Mesh *, ParameterInput *)> InitUserMeshData =
@@ -323,6 +491,37 @@ class Mesh {
 
   // Re-used functionality in constructor
   void RegisterLoadBalancing_(ParameterInput *pin);
+  void CreateExecSpaces_(ParameterInput *pin);
+  void RegisterPackSize_(ParameterInput *pin);
+  int ChoosePackSize_() const;
+  void ResetPackSize_();
+  // instances created for GetExecSpace, destroyed with the Mesh
+  std::vector<DevExecSpace> exec_spaces_;
+  // (re)build the mesh wide storage if the blocks changed, see mesh_wide_storage
+  void BuildMeshWideStorage_();
+  // allocate the coarse buffers of the blocks with a coarser neighbor and, if release is
+  // set, free those of all other blocks.  Does nothing unless coarse_buffers_on_demand.
+  void UpdateCoarseBuffers_(bool release);
+  // set while RedistributeAndRefineMeshBlocks is running, where blocks need their coarse
+  // buffers for prolongation and restriction regardless of their neighbors
+  bool remeshing_ = false;
+  // While alive, the Variables of new blocks are taken from variable_pool (or from a
+  // pool that only lives as long as the batch if there is none) inside a
+  // VariableMemoryPool::Batch, so they are zeroed together when the batch ends instead
+  // of by one kernel per allocation.  Does nothing unless batch_allocation is set.
+  class BlockCreationBatch_ {
+   public:
+    explicit BlockCreationBatch_(Mesh *pmesh);
+    ~BlockCreationBatch_();
+    BlockCreationBatch_(const BlockCreationBatch_ &) = delete;
+    BlockCreationBatch_ &operator=(const BlockCreationBatch_ &) = delete;
+
+   private:
+    Mesh *pmesh_;
+    bool temporary_pool_ = false;
+    std::unique_ptr<VariableMemoryPool<Real>::Batch> batch_;
+  };
+  std::shared_ptr<Kokkos::View<Real *, DevMemSpace>> mesh_wide_chunk_;
 
   void SetupMPIComms();
   void PopulateLeafLocationMap();
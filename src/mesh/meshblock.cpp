@@ -43,6 +43,7 @@
 #include "mesh/meshblock_tree.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
+#include "tasks/tasks.hpp"
 #include "utils/buffer_utils.hpp"
 
 namespace parthenon {
@@ -258,6 +259,35 @@ void MeshBlock::SetCostForLoadBalancing(double cost) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlock::AddMeasuredCost(double cost)
+//  \brief accumulate a measured cost in the MeshBlock cost for automatic load balancing
+
+void MeshBlock::AddMeasuredCost(double cost) {
+  if (pmy_mesh->lb_automatic_) cost_ += cost;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::shared_ptr<TaskCostMeter> MeshBlock::MakeCostMeter()
+//  \brief a meter charging the time of tasks to this block, waiting on its exec space
+
+std::shared_ptr<TaskCostMeter> MeshBlock::MakeCostMeter() {
+  class BlockCostMeter : public TaskCostMeter {
+   public:
+    explicit BlockCostMeter(std::weak_ptr<MeshBlock> pmb) : pmb_(pmb) {}
+    void Finish() override {
+      if (auto pmb = pmb_.lock()) pmb->exec_space.fence();
+    }
+    void Add(double seconds) override {
+      if (auto pmb = pmb_.lock()) pmb->AddMeasuredCost(seconds);
+    }
+
+   private:
+    std::weak_ptr<MeshBlock> pmb_;
+  };
+  return std::make_shared<BlockCostMeter>(weak_from_this());
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlock::ResetTimeMeasurement()
 //  \brief reset the MeshBlock cost for automatic load balancing
@@ -272,6 +302,7 @@ void MeshBlock::ResetTimeMeasurement() {
 
 void MeshBlock::StartTimeMeasurement() {
   if (pmy_mesh->lb_automatic_) {
+    exec_space.fence();
     lb_timer.reset();
   }
 }
@@ -282,6 +313,7 @@ void MeshBlock::StartTimeMeasurement() {
 
 void MeshBlock::StopTimeMeasurement() {
   if (pmy_mesh->lb_automatic_) {
+    exec_space.fence();
     cost_ += lb_timer.seconds();
   }
 }
@@ -291,12 +323,33 @@ void MeshBlock::RegisterMeshBlockData(std::shared_ptr<Variable<Real>> pvar_cc) {
   return;
 }
 
+void MeshBlock::SetCoarseBuffers(const bool allocate) {
+  if (allocate == has_coarse_buffers_) return;
+  has_coarse_buffers_ = allocate;
+  auto &base = meshblock_data.Get();
+  for (auto &v : base->GetVariableVector()) {
+    LogMemUsage(v->SetCoarseBuffer(this, allocate));
+  }
+  // the variables of the other stages share the coarse buffers of the base stage, see
+  // Variable::CopyFluxesAndBdryVar
+  for (auto &[name, stage] : meshblock_data.Stages()) {
+    if (stage == base) continue;
+    for (auto &v : stage->GetVariableVector()) {
+      if (!base->HasVariable(v->label())) continue;
+      auto base_var = base->GetVarPtr(v->label());
+      if (v != base_var) v->ShareCoarseBuffer(base_var.get());
+    }
+  }
+}
+
 void MeshBlock::AllocateSparse(std::string const &label, bool only_control,
                                bool flag_uninitialized) {
   auto &mbd = meshblock_data;
   auto AllocateVar = [this, flag_uninitialized, &mbd](const std::string &l) {
     // first allocate variable in base stage
     auto base_var = mbd.Get()->AllocateSparse(l, flag_uninitialized);
+    if (pmy_mesh != nullptr)
+      pmy_mesh->sparse_allocation.Set(lid, base_var->GetUniqueID(), true);
 
     // now allocate in all other stages
     for (auto stage : mbd.Stages()) {
@@ -343,12 +396,14 @@ void MeshBlock::AllocateSparse(std::string const &label, bool only_control,
 
 void MeshBlock::DeallocateSparse(std::string const &label) {
   auto &mbd = meshblock_data;
-  auto DeallocateVar = [&mbd](const std::string &l) {
+  auto DeallocateVar = [this, &mbd](const std::string &l) {
     for (auto stage : mbd.Stages()) {
       if (!stage.second->IsShallow() && stage.second->HasVariable(l)) {
         stage.second->DeallocateSparse(l);
       }
     }
+    if (pmy_mesh != nullptr)
+      pmy_mesh->sparse_allocation.Set(lid, Variable<Real>::GetUniqueID(l), false);
   };
 
   bool cont_set = false;
@@ -51,6 +51,7 @@ class MeshBlockTree;
 class MeshRefinement;
 class ParameterInput;
 class StateDescriptor;
+class TaskCostMeter;
 
 // Inner loop default pattern
 // - Defined outside of the MeshBlock class because it does not require an exec space
@@ -69,6 +70,8 @@ KOKKOS_FORCEINLINE_FUNCTION void par_for_inner(const team_mbr_t &team_member,
 class MeshBlock : public std::enable_shared_from_this<MeshBlock> {
   friend class RestartOutput;
   friend class Mesh;
+  template <typename T>
+  friend class Variable;
 
  public:
   MeshBlock() = default;
@@ -174,6 +177,17 @@ class MeshBlock : public std::enable_shared_from_this<MeshBlock> {
   // functions
   // Load balancing
   void SetCostForLoadBalancing(double cost);
+  // add the measured cost of work on this block for automatic load balancing, see
+  // MakeCostMeter and MeshData::StopTimeMeasurement
+  void AddMeasuredCost(double cost);
+  // A meter that charges the time of the tasks of a TaskList to this block for
+  // automatic load balancing, after waiting for their kernels on exec_space, see
+  // TaskList::SetCostMeter
+  std::shared_ptr<TaskCostMeter> MakeCostMeter();
+
+  // Changes whenever the data of a Variable of this block is allocated, deallocated or
+  // moved, so caches holding views of its variables can cheaply check if they are stale
+  std::uint64_t AllocationEpoch() const { return *alloc_epoch_; }
 
   // Memory usage
   // TODO(JMM): Currently swarm send/receive boundaries are not counted.
@@ -189,6 +203,13 @@ class MeshBlock : public std::enable_shared_from_this<MeshBlock> {
     Kokkos::deep_copy(exec_space, dst, src);
   }
 
+  // Whether the variables of this block have coarse buffers on a multilevel mesh.  New
+  // blocks have them, and with <parthenon/mesh>/coarse_buffers_on_demand the Mesh frees
+  // them on blocks that have no coarser neighbor once remeshing is done.  Changing this
+  // (de)allocates the coarse buffers in all stages of the block.
+  bool HasCoarseBuffers() const { return has_coarse_buffers_; }
+  void SetCoarseBuffers(bool allocate);
+
   void AllocateSparse(std::string const &label, bool only_control = false,
                       bool flag_uninitialized = false);
 
@@ -454,14 +475,17 @@ class MeshBlock : public std::enable_shared_from_this<MeshBlock> {
   // functions and variables for automatic load balancing based on timing
   Kokkos::Timer lb_timer;
   double cost_;
-  // JMM: these are private since the timing machinery only works
-  // per-meshblock nopt per-meshdata.
+  // These time work on a single block on exec_space. Work on MeshData is timed with
+  // MeshData::StartTimeMeasurement and StopTimeMeasurement instead.
   void ResetTimeMeasurement();
   void StartTimeMeasurement();
   void StopTimeMeasurement();
 
   // memory usage on a block
   std::uint64_t mem_usage_;
+  // shared with the variables of the block, which outlive it in some caches
+  std::shared_ptr<std::uint64_t> alloc_epoch_ = std::make_shared<std::uint64_t>(0);
+  bool has_coarse_buffers_ = true;
 };
 
 using BlockList_t = std::vector<std::shared_ptr<MeshBlock>>;
@@ -15,9 +15,9 @@
 
 #include <array>
 #include <functional>
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -100,10 +100,12 @@ using MeshBlockVarFluxPack = MeshBlockPack<VariableFluxPack<T>>;
 
 template <typename T>
 using MapToMeshBlockVarPack =
-    std::map<std::vector<std::size_t>, PackAndIndexMap<MeshBlockVarPack<T>>>;
+    std::unordered_map<vpack_types::VPackKey_t, PackAndIndexMap<MeshBlockVarPack<T>>,
+                       vpack_types::KeyHash>;
 template <typename T>
 using MapToMeshBlockVarFluxPack =
-    std::map<vpack_types::UidVecPair, PackAndIndexMap<MeshBlockVarFluxPack<T>>>;
+    std::unordered_map<vpack_types::UidVecPair, PackAndIndexMap<MeshBlockVarFluxPack<T>>,
+                       vpack_types::KeyHash>;
 
 } // namespace parthenon
 
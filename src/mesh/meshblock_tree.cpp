@@ -26,6 +26,8 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 #include "defs.hpp"
 #include "globals.hpp"
@@ -35,19 +37,14 @@
 
 namespace parthenon {
 
-// Define static member variables
-Mesh *pmesh_;
-MeshBlockTree *MeshBlockTree::proot_;
-int MeshBlockTree::nleaf_;
-
 //----------------------------------------------------------------------------------------
 //! \fn MeshBlockTree::MeshBlockTree()
 //  \brief constructor for the logical root
 
-MeshBlockTree::MeshBlockTree(Mesh *pmesh) : pleaf_(nullptr), gid_(-1) {
-  pmesh_ = pmesh;
-  proot_ = this;
+MeshBlockTree::MeshBlockTree(Mesh *pmesh)
+    : pleaf_(nullptr), gid_(-1), pmesh_(pmesh), proot_(this), nleaf_(0) {
   loc_ = LogicalLocation(0, 0, 0, 0);
+  nodes_[loc_] = this;
 }
 
 //----------------------------------------------------------------------------------------
@@ -55,8 +52,10 @@ MeshBlockTree::MeshBlockTree(Mesh *pmesh) : pleaf_(nullptr), gid_(-1) {
 //  \brief constructor for a leaf
 
 MeshBlockTree::MeshBlockTree(MeshBlockTree *parent, int ox1, int ox2, int ox3)
-    : pleaf_(nullptr), gid_(parent->gid_) {
+    : pleaf_(nullptr), gid_(parent->gid_), pmesh_(parent->pmesh_),
+      proot_(parent->proot_), nleaf_(parent->nleaf_) {
   loc_ = parent->loc_.GetDaughter(ox1, ox2, ox3);
+  proot_->nodes_[loc_] = this;
 }
 
 //----------------------------------------------------------------------------------------
@@ -69,6 +68,11 @@ MeshBlockTree::~MeshBlockTree() {
       delete pleaf_[i];
     delete[] pleaf_;
   }
+  // the root's own index is destroyed along with it
+  if (proot_ == this) return;
+  auto &nodes = proot_->nodes_;
+  auto it = nodes.find(loc_);
+  if (it != nodes.end() && it->second == this) nodes.erase(it);
 }
 
 //----------------------------------------------------------------------------------------
@@ -149,6 +153,28 @@ void MeshBlockTree::AddMeshBlockWithoutRefine(LogicalLocation rloc) {
   return;
 }
 
+MeshBlockTree *MeshBlockTree::FindDeepestNode_(LogicalLocation tloc) {
+  while (tloc.level() > 0) {
+    auto it = proot_->nodes_.find(tloc);
+    if (it != proot_->nodes_.end()) return it->second;
+    tloc = tloc.GetParent();
+  }
+  return proot_;
+}
+
+void MeshBlockTree::AddMeshBlocks(const std::vector<LogicalLocation> &rlocs, int &nnew) {
+  for (const auto &rloc : rlocs) {
+    FindDeepestNode_(rloc)->AddMeshBlock(rloc, nnew);
+  }
+}
+
+void MeshBlockTree::AddMeshBlocksWithoutRefine(
+    const std::vector<LogicalLocation> &rlocs) {
+  for (const auto &rloc : rlocs) {
+    FindDeepestNode_(rloc)->AddMeshBlockWithoutRefine(rloc);
+  }
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlockTree::Refine(int &nnew)
 //  \brief make finer leaves
@@ -228,7 +254,9 @@ void MeshBlockTree::Refine(int &nnew) {
           else
             lx1 = 0;
         }
-        proot_->AddMeshBlock(LogicalLocation(level, lx1, lx2, lx3), nnew);
+        // neighbors that exist already don't need the walk from the root
+        LogicalLocation nloc(level, lx1, lx2, lx3);
+        if (proot_->nodes_.count(nloc) == 0) proot_->AddMeshBlock(nloc, nnew);
       }
     }
   }
@@ -403,30 +431,20 @@ MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int o
   }
   if (ll < 1) return proot_; // single grid; return root
 
-  for (int level = 0; level < ll; level++) {
-    if (bt->pleaf_ == nullptr) { // leaf
-      if (level == ll - 1) {
-        return bt;
-      } else {
-        msg << "### FATAL ERROR in FindNeighbor" << std::endl
-            << "Neighbor search failed. The Block Tree is broken." << std::endl;
-        PARTHENON_FAIL(msg);
-        return nullptr;
-      }
-    }
-    // find a leaf in the next level
-    int sh = ll - level - 1;
-    ox = ((lx >> sh) & 1LL) == 1LL;
-    oy = ((ly >> sh) & 1LL) == 1LL;
-    oz = ((lz >> sh) & 1LL) == 1LL;
-    bt = bt->GetLeaf(ox, oy, oz);
-    if (bt == nullptr) {
+  const auto &nodes = proot_->nodes_;
+  auto it = nodes.find(LogicalLocation(ll, lx, ly, lz));
+  if (it == nodes.end()) {
+    // no block on the same level, so it has to be a coarser leaf
+    it = nodes.find(LogicalLocation(ll - 1, lx >> 1, ly >> 1, lz >> 1));
+    if (it == nodes.end() || it->second->pleaf_ != nullptr) {
       msg << "### FATAL ERROR in FindNeighbor" << std::endl
           << "Neighbor search failed. The Block Tree is broken." << std::endl;
       PARTHENON_FAIL(msg);
       return nullptr;
     }
+    return it->second;
   }
+  bt = it->second;
   if (bt->pleaf_ == nullptr) // leaf on the same level
     return bt;
   // one level finer: check if it is a leaf
@@ -450,14 +468,9 @@ MeshBlockTree *MeshBlockTree::FindNeighbor(LogicalLocation myloc, int ox1, int o
 
 MeshBlockTree *MeshBlockTree::FindMeshBlock(LogicalLocation tloc) {
   if (tloc.level() == loc_.level()) return this;
-  // get leaf indexes
-  int sh = tloc.level() - loc_.level() - 1;
-  int mx = (((tloc.lx1() >> sh) & 1LL) == 1LL);
-  int my = (((tloc.lx2() >> sh) & 1LL) == 1LL);
-  int mz = (((tloc.lx3() >> sh) & 1LL) == 1LL);
-  int n = mx + (my << 1) + (mz << 2);
-  if (pleaf_[n] == nullptr) return nullptr;
-  return pleaf_[n]->FindMeshBlock(tloc);
+  auto it = proot_->nodes_.find(tloc);
+  if (it == proot_->nodes_.end()) return nullptr;
+  return it->second;
 }
 
 } // namespace parthenon
@@ -20,8 +20,12 @@
 //  \brief defines the LogicalLocation structure and MeshBlockTree class
 //======================================================================================
 
+#include <unordered_map>
+#include <vector>
+
 #include "bvals/bvals.hpp"
 #include "defs.hpp"
+#include "mesh/logical_location.hpp"
 
 namespace parthenon {
 
@@ -50,6 +54,11 @@ class MeshBlockTree {
   void CreateRootGrid();
   void AddMeshBlock(LogicalLocation rloc, int &nnew);
   void AddMeshBlockWithoutRefine(LogicalLocation rloc);
+  // The same for many blocks at once, starting from the deepest node that already exists
+  // instead of from the root.  For locations in tree order (e.g., those of a restart
+  // file, or of a refined region) that is their parent for all but the first sibling.
+  void AddMeshBlocks(const std::vector<LogicalLocation> &rlocs, int &nnew);
+  void AddMeshBlocksWithoutRefine(const std::vector<LogicalLocation> &rlocs);
   void Refine(int &nnew);
   void Derefine(int &ndel);
   MeshBlockTree *FindMeshBlock(LogicalLocation tloc);
@@ -68,8 +77,16 @@ class MeshBlockTree {
   int gid_;
   LogicalLocation loc_;
 
-  static MeshBlockTree *proot_;
-  static int nleaf_;
+  // the mesh and root of the tree this node belongs to, so that the trees of several
+  // meshes (e.g., the members of an ensemble) can exist side by side
+  Mesh *pmesh_;
+  MeshBlockTree *proot_;
+  int nleaf_;
+  // every node of the tree by location, so that nodes are found without walking the
+  // tree from the root.  Only used on the root, reach it through proot_
+  std::unordered_map<LogicalLocation, MeshBlockTree *> nodes_;
+  // the deepest node that exists on the path from the root to tloc
+  MeshBlockTree *FindDeepestNode_(LogicalLocation tloc);
 };
 
 } // namespace parthenon
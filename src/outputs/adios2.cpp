@@ -0,0 +1,250 @@
+//========================================================================================
+// Parthenon performance portable AMR framework
+// Copyright(C) 2024 The Parthenon collaboration
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file adios2.cpp
+//  \brief Streams (or writes) outputs through ADIOS2, e.g., to analysis nodes via SST
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Parthenon headers
+#include "coordinates/coordinates.hpp"
+#include "defs.hpp"
+#include "globals.hpp"
+#include "interface/variable.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/output_utils.hpp"
+#include "outputs/outputs.hpp"
+#include "parameter_input.hpp"
+#include "parthenon_mpi.hpp"
+#include "utils/error_checking.hpp"
+#include "utils/instrument.hpp"
+#include "utils/string_utils.hpp"
+
+// ADIOS2 headers
+#ifdef PARTHENON_ENABLE_ADIOS2
+#include <adios2.h>
+#endif // ifdef PARTHENON_ENABLE_ADIOS2
+
+namespace parthenon {
+
+using namespace OutputUtils;
+
+#ifdef PARTHENON_ENABLE_ADIOS2
+struct ADIOS2Output::Session {
+#ifdef MPI_PARALLEL
+  Session() : adios(MPI_COMM_WORLD) {}
+#endif
+  adios2::ADIOS adios;
+  adios2::IO io;
+  // a single engine for the whole run, with one step per output
+  adios2::Engine engine;
+  ~Session() {
+    if (engine) engine.Close();
+  }
+};
+
+namespace {
+// Put the data of nlocal blocks starting at the block with index offset into the global
+// array name of nglobal blocks of shape block_shape each.  The variable is defined on
+// the first call, and its shape and selection are updated afterwards, since the number
+// of blocks changes with the mesh.  The data is copied by ADIOS2 before returning.
+template <typename T>
+void PutBlocks(adios2::IO &io, adios2::Engine &engine, const std::string &name,
+               const std::vector<std::size_t> &block_shape, const std::size_t offset,
+               const std::size_t nlocal, const std::size_t nglobal, const T *data) {
+  adios2::Dims shape{nglobal}, start{offset}, count{nlocal};
+  for (const auto n : block_shape) {
+    shape.push_back(n);
+    start.push_back(0);
+    count.push_back(n);
+  }
+  auto var = io.InquireVariable<T>(name);
+  if (var) {
+    var.SetShape(shape);
+    var.SetSelection({start, count});
+  } else {
+    var = io.DefineVariable<T>(name, shape, start, count);
+  }
+  if (nlocal > 0) engine.Put(var, data, adios2::Mode::Sync);
+}
+
+// Put a single value, written by rank 0
+template <typename T>
+void PutValue(adios2::IO &io, adios2::Engine &engine, const std::string &name,
+              const T &value) {
+  auto var = io.InquireVariable<T>(name);
+  if (!var) var = io.DefineVariable<T>(name);
+  if (Globals::my_rank == 0) engine.Put(var, value, adios2::Mode::Sync);
+}
+} // namespace
+#else
+struct ADIOS2Output::Session {};
+#endif // ifdef PARTHENON_ENABLE_ADIOS2
+
+ADIOS2Output::ADIOS2Output(const OutputParameters &oparams) : OutputType(oparams) {}
+
+// closes the engine, if one was opened
+ADIOS2Output::~ADIOS2Output() = default;
+
+//----------------------------------------------------------------------------------------
+//! \fn void ADIOS2Output:::WriteOutputFile(Mesh *pm)
+//  \brief Write the block metadata, coordinates and variables as one step of the stream
+void ADIOS2Output::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
+                                   const SignalHandler::OutputSignal signal) {
+#ifndef PARTHENON_ENABLE_ADIOS2
+  if (Globals::my_rank == 0) {
+    PARTHENON_WARN("ADIOS2 output requested by input file, but ADIOS2 support not "
+                   "compiled in. Skipping this output type.");
+  }
+#else
+  PARTHENON_INSTRUMENT
+  const std::string &block_name = output_params.block_name;
+
+  // The engine is opened on the first output and lives as long as this output, so that
+  // streaming engines keep their connection to the readers
+  if (session_ == nullptr) {
+    session_ = std::make_unique<Session>();
+    session_->io = session_->adios.DeclareIO(block_name);
+    session_->io.SetEngine(pin->GetOrAddString(block_name, "engine", "BP5"));
+    // engine parameters as a list of key=value pairs
+    for (const auto &param : pin->GetOrAddVector<std::string>(
+             block_name, "engine_parameters", std::vector<std::string>())) {
+      const auto equal = param.find('=');
+      PARTHENON_REQUIRE_THROWS(equal != std::string::npos,
+                               "ADIOS2 engine parameter '" + param +
+                                   "' is not of the form key=value");
+      session_->io.SetParameter(string_utils::trim(param.substr(0, equal)),
+                                string_utils::trim(param.substr(equal + 1)));
+    }
+    const std::string name =
+        output_params.file_basename + "." + output_params.file_id + ".bp";
+    session_->engine = session_->io.Open(name, adios2::Mode::Write);
+  }
+  auto &io = session_->io;
+  auto &engine = session_->engine;
+
+  const BlockList_t &blocks = pm->block_list;
+  const std::size_t num_blocks_local = blocks.size();
+  const std::size_t num_blocks_global = pm->nbtotal;
+  // every rank holds a contiguous range of gids
+  const std::size_t offset = blocks.front()->gid;
+  const bool do_ghosts = output_params.include_ghost_zones;
+  const IndexDomain domain = do_ghosts ? IndexDomain::entire : IndexDomain::interior;
+
+  engine.BeginStep();
+
+  // step info
+  PutValue(io, engine, "Info/Time", tm != nullptr ? tm->time : 0.0);
+  PutValue(io, engine, "Info/dt", tm != nullptr ? tm->dt : 0.0);
+  PutValue(io, engine, "Info/NCycle", tm != nullptr ? tm->ncycle : 0);
+  PutValue(io, engine, "Info/NumMeshBlocks", pm->nbtotal);
+  PutValue(io, engine, "Info/NDim", pm->ndim);
+
+  // block metadata, the same as in the /Blocks group of HDF5 outputs
+  const std::size_t ndim = pm->ndim;
+  const auto xmin = ComputeXminBlocks(pm, blocks);
+  PutBlocks(io, engine, "Blocks/xmin", {ndim}, offset, num_blocks_local,
+            num_blocks_global, xmin.data());
+  const auto locs = ComputeLocs(blocks);
+  PutBlocks(io, engine, "Blocks/loc.lx123", {3}, offset, num_blocks_local,
+            num_blocks_global, locs.data());
+  const auto ids = ComputeIDsAndFlags(blocks);
+  PutBlocks(io, engine, "Blocks/loc.level-gid-lid-cnghost-gflag", {5}, offset,
+            num_blocks_local, num_blocks_global, ids.data());
+
+  // coordinates of the faces and centers of the cells, as in HDF5 outputs
+  const IndexShape &cellbounds = pm->GetLeafBlockCellBounds();
+  const IndexRange ib = cellbounds.GetBoundsI(domain);
+  const IndexRange jb = cellbounds.GetBoundsJ(domain);
+  const IndexRange kb = cellbounds.GetBoundsK(domain);
+  for (const bool face : {true, false}) {
+    const std::string group = face ? "Locations/" : "VolumeLocations/";
+    std::vector<Real> x, y, z;
+    ComputeCoords(blocks, face, ib, jb, kb, x, y, z);
+    const std::size_t nx1 = ib.e - ib.s + 1 + face;
+    const std::size_t nx2 = jb.e - jb.s + 1 + face;
+    const std::size_t nx3 = kb.e - kb.s + 1 + face;
+    PutBlocks(io, engine, group + "x", {nx1}, offset, num_blocks_local,
+              num_blocks_global, x.data());
+    PutBlocks(io, engine, group + "y", {nx2}, offset, num_blocks_local,
+              num_blocks_global, y.data());
+    PutBlocks(io, engine, group + "z", {nx3}, offset, num_blocks_local,
+              num_blocks_global, z.data());
+  }
+
+  // variables, each gathered from all blocks into a device buffer by a single kernel and
+  // copied to the host once.  Sparse variables are zero where they aren't allocated.
+  auto &first_block = blocks.front();
+  std::vector<VarInfo> vars_info;
+  for (auto &v : GetAnyVariables(first_block->meshblock_data.Get()->GetVariableVector(),
+                                 output_params.variables)) {
+    vars_info.emplace_back(v);
+  }
+  std::sort(vars_info.begin(), vars_info.end(),
+            [](const VarInfo &a, const VarInfo &b) { return a.label < b.label; });
+  std::size_t var_size_max = 0;
+  for (auto &vinfo : vars_info) {
+    var_size_max = std::max(var_size_max, static_cast<std::size_t>(vinfo.Size()));
+  }
+  Kokkos::View<Real *, DevMemSpace> out_buf(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "adios2 output buffer"),
+      var_size_max * num_blocks_local);
+  auto out_buf_h = Kokkos::create_mirror_view(out_buf);
+  Kokkos::View<BlockDataPtr<const Real> *, DevMemSpace> block_ptrs("adios2 block data",
+                                                                   num_blocks_local);
+  auto block_ptrs_h = Kokkos::create_mirror_view(block_ptrs);
+  for (auto &vinfo : vars_info) {
+    Variable<Real> *shape_var = nullptr;
+    for (std::size_t b = 0; b < num_blocks_local; ++b) {
+      auto v = blocks[b]->meshblock_data.Get()->GetVarPtr(vinfo.label);
+      if (b == 0) shape_var = v.get();
+      block_ptrs_h(b).ptr = v->IsAllocated() ? v->data.data() : nullptr;
+    }
+    Kokkos::deep_copy(block_ptrs, block_ptrs_h);
+    const std::size_t size = PackVarOnDevice(first_block.get(), shape_var, do_ghosts,
+                                             block_ptrs, num_blocks_local, Real(0),
+                                             out_buf);
+    Kokkos::deep_copy(Kokkos::subview(out_buf_h, std::make_pair(std::size_t(0), size)),
+                      Kokkos::subview(out_buf, std::make_pair(std::size_t(0), size)));
+    const PackedVarShape shape(first_block.get(), shape_var, do_ghosts);
+    const std::vector<std::size_t> block_shape{
+        static_cast<std::size_t>(vinfo.nx6), static_cast<std::size_t>(vinfo.nx5),
+        static_cast<std::size_t>(vinfo.nx4), static_cast<std::size_t>(shape.nk),
+        static_cast<std::size_t>(shape.nj), static_cast<std::size_t>(shape.ni)};
+    PutBlocks(io, engine, vinfo.label, block_shape, offset, num_blocks_local,
+              num_blocks_global, out_buf_h.data());
+  }
+
+  engine.EndStep();
+#endif // ifndef PARTHENON_ENABLE_ADIOS2
+
+  // advance output parameters, only for the default time based data dumps
+  if (signal == SignalHandler::OutputSignal::none) {
+    output_params.file_number++;
+    output_params.next_time += output_params.dt;
+    pin->SetInteger(output_params.block_name, "file_number", output_params.file_number);
+    pin->SetReal(output_params.block_name, "next_time", output_params.next_time);
+  }
+}
+
+} // namespace parthenon
@@ -17,10 +17,12 @@
 //! \file ascent.cpp
 //  \brief Ascent situ visualization and analysis interop
 
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -47,6 +49,43 @@ namespace parthenon {
 
 using namespace OutputUtils;
 
+#ifdef PARTHENON_ENABLE_ASCENT
+namespace {
+// VTK-m backend of the execution space the published fields live in.  Fields are handed
+// to Conduit with set_external on the (device) data of Variables, so VTK-m has to run
+// where that data resides to consume it in place without a copy to the host.
+constexpr const char *DefaultVTKmBackend() {
+#if defined(KOKKOS_ENABLE_CUDA)
+  return "cuda";
+#elif defined(KOKKOS_ENABLE_HIP) || defined(KOKKOS_ENABLE_SYCL)
+  return "kokkos";
+#elif defined(KOKKOS_ENABLE_OPENMP)
+  return "openmp";
+#else
+  return "serial";
+#endif
+}
+} // namespace
+
+struct AscentOutput::Session {
+  ascent::Ascent ascent;
+  // blueprint tree of all blocks on this rank.  Fields point to the data of Variables
+  // (and the ghost mask), so only their pointers need to be refreshed on every output.
+  conduit::Node root;
+  bool built = false;
+  // Mesh::remesh_count of the mesh the tree was built for
+  std::uint64_t remesh_count = 0;
+  ~Session() { ascent.close(); }
+};
+#else
+struct AscentOutput::Session {};
+#endif // ifdef PARTHENON_ENABLE_ASCENT
+
+AscentOutput::AscentOutput(const OutputParameters &oparams) : OutputType(oparams) {}
+
+// closes the Ascent session, if one was opened
+AscentOutput::~AscentOutput() = default;
+
 //----------------------------------------------------------------------------------------
 //! \fn void AscentOutput:::WriteOutputFile(Mesh *pm)
 //  \brief  Expose mesh and all Cell variables for processing with Ascent
@@ -63,23 +102,40 @@ void AscentOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
 
   using conduit::Node;
 
-  // Ascent needs the MPI communicator we are using
-  ascent::Ascent ascent;
-  Node ascent_opts;
-  ascent_opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
-  ascent_opts["actions_file"] = pin->GetString(output_params.block_name, "actions_file");
-  // Only publish fields that are used within actions to reduce memory footprint.
-  // A user might need to override this, e.g., in a runtime ascent_options.yaml, if
-  // the required fields cannot be resolved by Ascent.
-  // See https://ascent.readthedocs.io/en/latest/AscentAPI.html#field-filtering
-  // TODO(some in mid 2023) Reenable this as this currently only works in develop of
-  // Ascent and not in published release (expected in 0.9.1), see
-  // https://github.com/Alpine-DAV/ascent/pull/1109
-  // ascent_opts["field_filtering"] = "true";
-  ascent.open(ascent_opts);
-
-  // create root node for the whole mesh
-  Node root;
+  // The Ascent instance is opened on the first output and lives as long as this output
+  if (session_ == nullptr) {
+    session_ = std::make_unique<Session>();
+    // Ascent needs the MPI communicator we are using
+    Node ascent_opts;
+    ascent_opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
+    ascent_opts["actions_file"] =
+        pin->GetString(output_params.block_name, "actions_file");
+    ascent_opts["runtime/type"] = "ascent";
+    ascent_opts["runtime/vtkm/backend"] = pin->GetOrAddString(
+        output_params.block_name, "vtkm_backend", DefaultVTKmBackend());
+#ifdef KOKKOS_ENABLE_CUDA
+    // Kokkos already picked the device of this rank
+    ascent_opts["cuda/init"] = "false";
+#endif
+    // Only publish fields that are used within actions to reduce memory footprint.
+    // A user might need to override this, e.g., in a runtime ascent_options.yaml, if
+    // the required fields cannot be resolved by Ascent.
+    // See https://ascent.readthedocs.io/en/latest/AscentAPI.html#field-filtering
+    // TODO(some in mid 2023) Reenable this as this currently only works in develop of
+    // Ascent and not in published release (expected in 0.9.1), see
+    // https://github.com/Alpine-DAV/ascent/pull/1109
+    // ascent_opts["field_filtering"] = "true";
+    session_->ascent.open(ascent_opts);
+  }
+
+  // the coordsets and topologies only change with the mesh
+  const bool rebuild = !session_->built || session_->remesh_count != pm->remesh_count;
+  Node &root = session_->root;
+  if (rebuild) {
+    root.reset();
+    session_->built = true;
+    session_->remesh_count = pm->remesh_count;
+  }
 
   for (auto &pmb : pm->block_list) {
     // create a unique id for this MeshBlock
@@ -87,7 +143,6 @@ void AscentOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
     Node &mesh = root[meshblock_name];
 
     // add basic state info
-    mesh["state/domain_id"] = pmb->gid;
     mesh["state/cycle"] = tm->ncycle;
     mesh["state/time"] = tm->time;
 
@@ -100,73 +155,79 @@ void AscentOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
     auto nk = kb.e - kb.s + 1;
     uint64_t ncells = ni * nj * nk;
 
-    auto ib_int = bounds.GetBoundsI(IndexDomain::interior);
-    auto jb_int = bounds.GetBoundsJ(IndexDomain::interior);
-    auto kb_int = bounds.GetBoundsK(IndexDomain::interior);
-
-    auto &coords = pmb->coords;
-    Real dx1 = coords.CellWidth<X1DIR>(ib.s, jb.s, kb.s);
-    Real dx2 = coords.CellWidth<X2DIR>(ib.s, jb.s, kb.s);
-    Real dx3 = coords.CellWidth<X3DIR>(ib.s, jb.s, kb.s);
-    std::array<Real, 3> corner = coords.GetXmin();
-
-    // create the coordinate set
-    mesh["coordsets/coords/type"] = "uniform";
-    PARTHENON_REQUIRE_THROWS(typeid(Coordinates_t) == typeid(UniformCartesian),
-                             "Ascent currently only supports Cartesian coordinates.");
-
-    mesh["coordsets/coords/dims/i"] = ni + 1;
-    mesh["coordsets/coords/dims/j"] = nj + 1;
-    if (nk > 1) {
-      mesh["coordsets/coords/dims/k"] = nk + 1;
-    }
+    if (rebuild) {
+      mesh["state/domain_id"] = pmb->gid;
 
-    // add origin and spacing to the coordset (optional)
-    mesh["coordsets/coords/origin/x"] = corner[0];
-    mesh["coordsets/coords/origin/y"] = corner[1];
-    if (nk > 1) {
-      mesh["coordsets/coords/origin/z"] = corner[2];
-    }
+      auto &coords = pmb->coords;
+      Real dx1 = coords.CellWidth<X1DIR>(ib.s, jb.s, kb.s);
+      Real dx2 = coords.CellWidth<X2DIR>(ib.s, jb.s, kb.s);
+      Real dx3 = coords.CellWidth<X3DIR>(ib.s, jb.s, kb.s);
+      std::array<Real, 3> corner = coords.GetXmin();
 
-    mesh["coordsets/coords/spacing/dx"] = dx1;
-    mesh["coordsets/coords/spacing/dy"] = dx2;
-    if (nk > 1) {
-      mesh["coordsets/coords/spacing/dz"] = dx3;
-    }
+      // create the coordinate set
+      mesh["coordsets/coords/type"] = "uniform";
+      PARTHENON_REQUIRE_THROWS(typeid(Coordinates_t) == typeid(UniformCartesian),
+                               "Ascent currently only supports Cartesian coordinates.");
+
+      mesh["coordsets/coords/dims/i"] = ni + 1;
+      mesh["coordsets/coords/dims/j"] = nj + 1;
+      if (nk > 1) {
+        mesh["coordsets/coords/dims/k"] = nk + 1;
+      }
+
+      // add origin and spacing to the coordset (optional)
+      mesh["coordsets/coords/origin/x"] = corner[0];
+      mesh["coordsets/coords/origin/y"] = corner[1];
+      if (nk > 1) {
+        mesh["coordsets/coords/origin/z"] = corner[2];
+      }
+
+      mesh["coordsets/coords/spacing/dx"] = dx1;
+      mesh["coordsets/coords/spacing/dy"] = dx2;
+      if (nk > 1) {
+        mesh["coordsets/coords/spacing/dz"] = dx3;
+      }
 
-    // add the topology
-    mesh["topologies/topo/type"] = "uniform";
-    mesh["topologies/topo/coordset"] = "coords";
-
-    // indicate ghost zones with ascent_ghosts set to 1
-    Node &n_field = mesh["fields/ascent_ghosts"];
-    n_field["association"] = "element";
-    n_field["topology"] = "topo";
-
-    // allocate ghost mask if not already done
-    if (ghost_mask_.data() == nullptr) {
-      ghost_mask_ = ParArray1D<Real>("Ascent ghost mask", ncells);
-
-      const int njni = nj * ni;
-      auto &ghost_mask = ghost_mask_; // redef to lambda capture class member
-      pmb->par_for(
-          PARTHENON_AUTO_LABEL, 0, ncells - 1, KOKKOS_LAMBDA(const int &idx) {
-            const int k = idx / (njni);
-            const int j = (idx - k * njni) / ni;
-            const int i = idx - k * njni - j * nj;
-
-            if ((i < ib_int.s) || (ib_int.e < i) || (j < jb_int.s) || (jb_int.e < j) ||
-                ((nk > 1) && ((k < kb_int.s) || (kb_int.e < k)))) {
-              ghost_mask(idx) = 1;
-            } else {
-              ghost_mask(idx) = 0;
-            }
-          });
+      // add the topology
+      mesh["topologies/topo/type"] = "uniform";
+      mesh["topologies/topo/coordset"] = "coords";
+
+      // indicate ghost zones with ascent_ghosts set to 1
+      Node &n_field = mesh["fields/ascent_ghosts"];
+      n_field["association"] = "element";
+      n_field["topology"] = "topo";
+
+      // allocate ghost mask if not already done, all blocks share the same shape
+      if (ghost_mask_.data() == nullptr) {
+        ghost_mask_ = ParArray1D<Real>("Ascent ghost mask", ncells);
+
+        auto ib_int = bounds.GetBoundsI(IndexDomain::interior);
+        auto jb_int = bounds.GetBoundsJ(IndexDomain::interior);
+        auto kb_int = bounds.GetBoundsK(IndexDomain::interior);
+        const int njni = nj * ni;
+        auto &ghost_mask = ghost_mask_; // redef to lambda capture class member
+        pmb->par_for(
+            PARTHENON_AUTO_LABEL, 0, ncells - 1, KOKKOS_LAMBDA(const int &idx) {
+              const int k = idx / (njni);
+              const int j = (idx - k * njni) / ni;
+              const int i = idx - k * njni - j * ni;
+
+              if ((i < ib_int.s) || (ib_int.e < i) || (j < jb_int.s) || (jb_int.e < j) ||
+                  ((nk > 1) && ((k < kb_int.s) || (kb_int.e < k)))) {
+                ghost_mask(idx) = 1;
+              } else {
+                ghost_mask(idx) = 0;
+              }
+            });
+      }
+      // Set ghost mask
+      n_field["values"].set_external(ghost_mask_.data(), ncells);
     }
-    // Set ghost mask
-    n_field["values"].set_external(ghost_mask_.data(), ncells);
 
-    // create a field for each component of each variable pack
+    // create a field for each component of each variable pack.  The data of sparse
+    // variables moves when they are (de)allocated, so the pointers are always refreshed.
+    // The values stay where Parthenon keeps them, i.e., in device memory on device
+    // builds, see DefaultVTKmBackend.
     auto &mbd = pmb->meshblock_data.Get();
 
     for (const auto &var : mbd->GetVariableVector()) {
@@ -189,23 +250,22 @@ void AscentOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
   }
 
   // make sure we conform:
-  Node verify_info;
-  if (!conduit::blueprint::mesh::verify(root, verify_info)) {
-    if (parthenon::Globals::my_rank == 0) {
-      PARTHENON_WARN("Ascent output: blueprint::mesh::verify failed!");
+  if (rebuild) {
+    Node verify_info;
+    if (!conduit::blueprint::mesh::verify(root, verify_info)) {
+      if (parthenon::Globals::my_rank == 0) {
+        PARTHENON_WARN("Ascent output: blueprint::mesh::verify failed!");
+      }
+      verify_info.print();
     }
-    verify_info.print();
   }
-  ascent.publish(root);
+  session_->ascent.publish(root);
 
   // Create dummy action as we need to "execute" to override the actions defined in the
   // yaml file.
   Node actions;
   // execute the actions
-  ascent.execute(actions);
-
-  // close ascent
-  ascent.close();
+  session_->ascent.execute(actions);
 #endif // ifndef PARTHENON_ENABLE_ASCENT
 
   // advance output parameters
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
@@ -207,8 +208,6 @@ Histogram::Histogram(ParameterInput *pin, const std::string &block_name,
   const auto nybins = ndim_ == 2 ? y_edges_.extent_int(0) - 1 : 1;
 
   result_ = ParArray2D<Real>(prefix + "result", nybins, nxbins);
-  scatter_result =
-      Kokkos::Experimental::ScatterView<Real **, LayoutWrapper>(result_.KokkosView());
 
   accumulate_ = pin->GetOrAddBoolean(block_name, prefix + "accumulate", false);
   weight_by_vol_ = pin->GetOrAddBoolean(block_name, prefix + "weight_by_volume", false);
@@ -225,209 +224,275 @@ Histogram::Histogram(ParameterInput *pin, const std::string &block_name,
   }
 }
 
-// Computes a 1D or 2D histogram with inclusive lower edges and inclusive rightmost edges.
-// Function could in principle be templated on dimension, but it's currently not expected
-// to be a performance concern (because it won't be called that often).
-void Histogram::CalcHist(Mesh *pm) {
-  Kokkos::Profiling::pushRegion("Calculate single histogram");
-  const auto x_var_component = x_var_component_;
-  const auto y_var_component = y_var_component_;
-  const auto binned_var_component = binned_var_component_;
-  const auto weight_var_component = weight_var_component_;
-  const auto x_var_type = x_var_type_;
-  const auto y_var_type = y_var_type_;
-  const auto x_edges = x_edges_;
-  const auto y_edges = y_edges_;
-  const auto x_edges_type = x_edges_type_;
-  const auto y_edges_type = y_edges_type_;
-  const auto x_edge_min = x_edge_min_;
-  const auto x_edge_dbin = x_edge_dbin_;
-  const auto y_edge_min = y_edge_min_;
-  const auto y_edge_dbin = y_edge_dbin_;
-  const auto hist_ndim = ndim_;
-  const auto weight_by_vol = weight_by_vol_;
-  const auto accumulate = accumulate_;
-  auto result = result_;
-  auto scatter = scatter_result;
+// Returns the bin of val for the edges [offset, offset + num_edges) of the flat array of
+// all edges using inclusive lower edges and an inclusive rightmost edge, or -1 if val is
+// outside the edges and not accumulated in the outermost bins.
+KOKKOS_INLINE_FUNCTION int FindBin(const Real val, const ParArray1D<Real> &edges,
+                                   const int offset, const int num_edges,
+                                   const EdgeType edges_type, const Real edge_min,
+                                   const Real edge_dbin, const bool accumulate) {
+  // First handle edge cases explicitly
+  if (val < edges(offset)) {
+    return accumulate ? 0 : -1;
+  } else if (val > edges(offset + num_edges - 1)) {
+    return accumulate ? num_edges - 2 : -1;
+    // if we're on the rightmost edge, directly set last bin
+  } else if (val == edges(offset + num_edges - 1)) {
+    return num_edges - 2;
+  }
+  // for lin and log directly pick index
+  if (edges_type == EdgeType::Lin) {
+    return static_cast<int>((val - edge_min) / edge_dbin);
+  } else if (edges_type == EdgeType::Log) {
+    return static_cast<int>((Kokkos::log10(val) - edge_min) / edge_dbin);
+  }
+  // otherwise search
+  const auto edges_hist =
+      Kokkos::subview(edges.KokkosView(), Kokkos::make_pair(offset, offset + num_edges));
+  return upper_bound(edges_hist, val) - 1;
+}
+
+// Returns the value used for binning, i.e., either a coordinate or a variable component
+template <typename Pack>
+KOKKOS_INLINE_FUNCTION Real BinValue(const VarType var_type, const int var_idx,
+                                     const Real x1, const Real x2, const Real x3,
+                                     const Real r, const Pack &pack, const int b,
+                                     const int k, const int j, const int i) {
+  if (var_type == VarType::X1) {
+    return x1;
+  } else if (var_type == VarType::X2) {
+    return x2;
+  } else if (var_type == VarType::X3) {
+    return x3;
+  } else if (var_type == VarType::R) {
+    return r;
+  }
+  return pack(b, var_idx, k, j, i);
+}
+
+} // namespace HistUtil
+
+//----------------------------------------------------------------------------------------
+//! \fn void HistogramOutput:::SetupHistograms(ParameterInput *pin)
+//  \brief Process parameter input to setup persistent histograms
+HistogramOutput::HistogramOutput(const OutputParameters &op, ParameterInput *pin)
+    : OutputType(op) {
+
+  hist_names_ = pin->GetVector<std::string>(op.block_name, "hist_names");
+
+  for (auto &hist_name : hist_names_) {
+    histograms_.emplace_back(pin, op.block_name, hist_name);
+  }
+
+  // Collect the edges of all histograms and the variables they use. The indices of the
+  // variables in the pack are set for each partition in CalcHistograms_.
+  const int nhist = histograms_.size();
+  params_ = ParArray1D<HistUtil::HistogramKernelParams>("histogram params", nhist);
+  params_h_ = params_.GetHostMirror();
+  std::vector<Real> edges_in;
+  int nresults = 0;
+  const auto add_var = [this](const std::string &var_name) {
+    if (std::find(var_names_.begin(), var_names_.end(), var_name) == var_names_.end()) {
+      var_names_.push_back(var_name);
+    }
+  };
+  for (int h = 0; h < nhist; h++) {
+    const auto &hist = histograms_[h];
+    auto &params = params_h_(h);
+    params.ndim = hist.ndim_;
+    params.x_var_type = hist.x_var_type_;
+    params.y_var_type = hist.y_var_type_;
+    params.x_var_idx = params.y_var_idx = -1;
+    params.binned_var_idx = params.weight_var_idx = -1;
+    if (hist.x_var_type_ == HistUtil::VarType::Var) add_var(hist.x_var_name_);
+    if (hist.y_var_type_ == HistUtil::VarType::Var) add_var(hist.y_var_name_);
+    if (hist.binned_var_component_ != -1) add_var(hist.binned_var_name_);
+    if (hist.weight_var_component_ != -1) add_var(hist.weight_var_name_);
+
+    params.x_edges_type = hist.x_edges_type_;
+    params.y_edges_type = hist.y_edges_type_;
+    params.x_edge_min = hist.x_edge_min_;
+    params.x_edge_dbin = hist.x_edge_dbin_;
+    params.y_edge_min = hist.y_edge_min_;
+    params.y_edge_dbin = hist.y_edge_dbin_;
+    const auto x_edges_h = hist.x_edges_.GetHostMirrorAndCopy();
+    params.x_edges_offset = edges_in.size();
+    params.x_num_edges = x_edges_h.extent_int(0);
+    edges_in.insert(edges_in.end(), x_edges_h.data(),
+                    x_edges_h.data() + x_edges_h.extent_int(0));
+    const auto y_edges_h = hist.y_edges_.GetHostMirrorAndCopy();
+    params.y_edges_offset = edges_in.size();
+    params.y_num_edges = y_edges_h.extent_int(0);
+    edges_in.insert(edges_in.end(), y_edges_h.data(),
+                    y_edges_h.data() + y_edges_h.extent_int(0));
+
+    params.accumulate = hist.accumulate_;
+    params.weight_by_vol = hist.weight_by_vol_;
+    params.result_offset = nresults;
+    nresults += hist.result_.size();
+  }
+
+  edges_ = ParArray1D<Real>("histogram edges", edges_in.size());
+  auto edges_h = edges_.GetHostMirror();
+  for (int i = 0; i < edges_in.size(); i++) {
+    edges_h(i) = edges_in[i];
+  }
+  Kokkos::deep_copy(edges_, edges_h);
+
+  results_ = ParArray1D<Real>("histogram results", nresults);
+
+  // The ScatterView duplicates the results per thread on host backends, which quickly
+  // becomes prohibitive for large (2D) histograms on many-core hosts. Atomics don't
+  // require any additional memory.
+  const auto accumulation = pin->GetOrAddString(op.block_name, "accumulation", "auto");
+  if (accumulation == "auto") {
+    const auto max_bytes =
+        pin->GetOrAddInteger(op.block_name, "accumulation_max_bytes", 134217728);
+    PARTHENON_REQUIRE_THROWS(max_bytes >= 0,
+                             "Histogram accumulation_max_bytes must be >= 0.");
+    const auto duplicated_bytes = static_cast<std::size_t>(DevExecSpace().concurrency()) *
+                                  nresults * sizeof(Real);
+    use_atomics_ = duplicated_bytes > static_cast<std::size_t>(max_bytes);
+  } else if (accumulation == "atomic") {
+    use_atomics_ = true;
+  } else if (accumulation == "scatter") {
+    use_atomics_ = false;
+  } else {
+    PARTHENON_THROW("Unknown histogram accumulation '" + accumulation +
+                    "'. Supported are auto, atomic, and scatter.")
+  }
+  if (!use_atomics_) {
+    scatter_results_ =
+        Kokkos::Experimental::ScatterView<Real *, LayoutWrapper>(results_.KokkosView());
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HistogramOutput:::CalcHistograms_(Mesh *pm)
+//  \brief Calculates all histograms in a single kernel per partition and reduces the
+//  results of all histograms over ranks at once.
+void HistogramOutput::CalcHistograms_(Mesh *pm) {
+  Kokkos::Profiling::pushRegion("Calculate all histograms");
+  const int nhist = histograms_.size();
+  auto params = params_;
+  auto edges = edges_;
+  auto results = results_;
+  auto scatter = scatter_results_;
+  const bool use_atomics = use_atomics_;
 
   // Reset ScatterView from previous output
-  scatter.reset();
-  // Also reset the histogram from previous call.
+  if (!use_atomics) scatter.reset();
+  // Also reset the histograms from previous call.
   // Currently still required for consistent results between host and device backends, see
   // https://github.com/kokkos/kokkos/issues/6363
-  Kokkos::deep_copy(result, 0);
+  Kokkos::deep_copy(results, 0);
 
   const int num_partitions = pm->DefaultNumPartitions();
 
   for (int p = 0; p < num_partitions; p++) {
     auto &md = pm->mesh_data.GetOrAdd("base", p);
 
-    const auto x_var_pack_string = x_var_type == VarType::Var
-                                       ? std::vector<std::string>{x_var_name_}
-                                       : std::vector<std::string>{};
-    const auto x_var = md->PackVariables(x_var_pack_string);
-
-    const auto y_var_pack_string = y_var_type == VarType::Var
-                                       ? std::vector<std::string>{y_var_name_}
-                                       : std::vector<std::string>{};
-    const auto y_var = md->PackVariables(y_var_pack_string);
-
-    const auto binned_var_pack_string = binned_var_component == -1
-                                            ? std::vector<std::string>{}
-                                            : std::vector<std::string>{binned_var_name_};
-    const auto binned_var = md->PackVariables(binned_var_pack_string);
-
-    const auto weight_var_pack_string = weight_var_component == -1
-                                            ? std::vector<std::string>{}
-                                            : std::vector<std::string>{weight_var_name_};
-    const auto weight_var = md->PackVariables(weight_var_pack_string);
+    PackIndexMap imap;
+    const auto pack = md->PackVariables(var_names_, imap);
+    const auto var_idx = [&imap](const std::string &var_name, const int component) {
+      return component == -1 ? -1 : imap.get(var_name).first + component;
+    };
+    for (int h = 0; h < nhist; h++) {
+      const auto &hist = histograms_[h];
+      auto &hist_params = params_h_(h);
+      if (hist.x_var_type_ == HistUtil::VarType::Var) {
+        hist_params.x_var_idx = var_idx(hist.x_var_name_, hist.x_var_component_);
+      }
+      if (hist.y_var_type_ == HistUtil::VarType::Var) {
+        hist_params.y_var_idx = var_idx(hist.y_var_name_, hist.y_var_component_);
+      }
+      hist_params.binned_var_idx =
+          var_idx(hist.binned_var_name_, hist.binned_var_component_);
+      hist_params.weight_var_idx =
+          var_idx(hist.weight_var_name_, hist.weight_var_component_);
+    }
+    Kokkos::deep_copy(params, params_h_);
 
     const auto ib = md->GetBoundsI(IndexDomain::interior);
     const auto jb = md->GetBoundsJ(IndexDomain::interior);
     const auto kb = md->GetBoundsK(IndexDomain::interior);
 
     parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, "CalcHist", DevExecSpace(), 0, md->NumBlocks() - 1, kb.s,
-        kb.e, jb.s, jb.e, ib.s, ib.e,
+        DEFAULT_LOOP_PATTERN, "CalcHistograms", DevExecSpace(), 0, md->NumBlocks() - 1,
+        kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
-          auto &coords = x_var.GetCoords(b);
-          auto x_val = std::numeric_limits<Real>::quiet_NaN();
-          if (x_var_type == VarType::X1) {
-            x_val = coords.Xc<1>(k, j, i);
-          } else if (x_var_type == VarType::X2) {
-            x_val = coords.Xc<2>(k, j, i);
-          } else if (x_var_type == VarType::X3) {
-            x_val = coords.Xc<3>(k, j, i);
-          } else if (x_var_type == VarType::R) {
-            x_val = Kokkos::sqrt(SQR(coords.Xc<1>(k, j, i)) + SQR(coords.Xc<2>(k, j, i)) +
-                                 SQR(coords.Xc<3>(k, j, i)));
-          } else {
-            x_val = x_var(b, x_var_component, k, j, i);
-          }
-
-          int x_bin = -1;
-          // First handle edge cases explicitly
-          if (x_val < x_edges(0)) {
-            if (accumulate) {
-              x_bin = 0;
-            } else {
-              return;
-            }
-          } else if (x_val > x_edges(x_edges.extent_int(0) - 1)) {
-            if (accumulate) {
-              x_bin = x_edges.extent_int(0) - 2;
-            } else {
-              return;
+          auto &coords = pack.GetCoords(b);
+          // coordinates and volume are shared by all histograms
+          const Real x1 = coords.Xc<1>(k, j, i);
+          const Real x2 = coords.Xc<2>(k, j, i);
+          const Real x3 = coords.Xc<3>(k, j, i);
+          const Real r = Kokkos::sqrt(SQR(x1) + SQR(x2) + SQR(x3));
+          const Real vol = coords.CellVolume(k, j, i);
+
+          for (int h = 0; h < nhist; h++) {
+            const auto &hp = params(h);
+            const Real x_val = HistUtil::BinValue(hp.x_var_type, hp.x_var_idx, x1, x2,
+                                                  x3, r, pack, b, k, j, i);
+            const int x_bin =
+                HistUtil::FindBin(x_val, edges, hp.x_edges_offset, hp.x_num_edges,
+                                  hp.x_edges_type, hp.x_edge_min, hp.x_edge_dbin,
+                                  hp.accumulate);
+            if (x_bin < 0) continue;
+
+            // needs to be zero as for the 1D histogram we need 0 as first index of the
+            // 2D result
+            int y_bin = 0;
+            if (hp.ndim == 2) {
+              const Real y_val = HistUtil::BinValue(hp.y_var_type, hp.y_var_idx, x1, x2,
+                                                    x3, r, pack, b, k, j, i);
+              y_bin = HistUtil::FindBin(y_val, edges, hp.y_edges_offset, hp.y_num_edges,
+                                        hp.y_edges_type, hp.y_edge_min, hp.y_edge_dbin,
+                                        hp.accumulate);
+              if (y_bin < 0) continue;
             }
-            // if we're on the rightmost edge, directly set last bin
-          } else if (x_val == x_edges(x_edges.extent_int(0) - 1)) {
-            x_bin = x_edges.extent_int(0) - 2;
-          } else {
-            // for lin and log directly pick index
-            if (x_edges_type == EdgeType::Lin) {
-              x_bin = static_cast<int>((x_val - x_edge_min) / x_edge_dbin);
-            } else if (x_edges_type == EdgeType::Log) {
-              x_bin = static_cast<int>((Kokkos::log10(x_val) - x_edge_min) / x_edge_dbin);
-              // otherwise search
+            const Real val_to_add =
+                hp.binned_var_idx == -1 ? 1.0 : pack(b, hp.binned_var_idx, k, j, i);
+            Real weight = hp.weight_by_vol ? vol : 1.0;
+            weight *= hp.weight_var_idx == -1 ? 1.0 : pack(b, hp.weight_var_idx, k, j, i);
+            const int idx = hp.result_offset + y_bin * (hp.x_num_edges - 1) + x_bin;
+            if (use_atomics) {
+              Kokkos::atomic_add(&results(idx), val_to_add * weight);
             } else {
-              x_bin = upper_bound(x_edges, x_val) - 1;
+              auto res = scatter.access();
+              res(idx) += val_to_add * weight;
             }
           }
-          PARTHENON_DEBUG_REQUIRE(x_bin >= 0, "Bin not found");
-
-          // needs to be zero as for the 1D histogram we need 0 as first index of the 2D
-          // result array
-          int y_bin = 0;
-          if (hist_ndim == 2) {
-            auto y_val = std::numeric_limits<Real>::quiet_NaN();
-            if (y_var_type == VarType::X1) {
-              y_val = coords.Xc<1>(k, j, i);
-            } else if (y_var_type == VarType::X2) {
-              y_val = coords.Xc<2>(k, j, i);
-            } else if (y_var_type == VarType::X3) {
-              y_val = coords.Xc<3>(k, j, i);
-            } else if (y_var_type == VarType::R) {
-              y_val =
-                  Kokkos::sqrt(SQR(coords.Xc<1>(k, j, i)) + SQR(coords.Xc<2>(k, j, i)) +
-                               SQR(coords.Xc<3>(k, j, i)));
-            } else {
-              y_val = y_var(b, y_var_component, k, j, i);
-            }
-
-            y_bin = -1; // reset to impossible value
-            // First handle edge cases explicitly
-            if (y_val < y_edges(0)) {
-              if (accumulate) {
-                y_bin = 0;
-              } else {
-                return;
-              }
-            } else if (y_val > y_edges(y_edges.extent_int(0) - 1)) {
-              if (accumulate) {
-                y_bin = y_edges.extent_int(0) - 2;
-              } else {
-                return;
-              }
-              // if we're on the rightmost edge, directly set last bin
-            } else if (y_val == y_edges(y_edges.extent_int(0) - 1)) {
-              y_bin = y_edges.extent_int(0) - 2;
-            } else {
-              // for lin and log directly pick index
-              if (y_edges_type == EdgeType::Lin) {
-                y_bin = static_cast<int>((y_val - y_edge_min) / y_edge_dbin);
-              } else if (y_edges_type == EdgeType::Log) {
-                y_bin =
-                    static_cast<int>((Kokkos::log10(y_val) - y_edge_min) / y_edge_dbin);
-                // otherwise search
-              } else {
-                y_bin = upper_bound(y_edges, y_val) - 1;
-              }
-            }
-            PARTHENON_DEBUG_REQUIRE(y_bin >= 0, "Bin not found");
-          }
-          auto res = scatter.access();
-          const auto val_to_add = binned_var_component == -1
-                                      ? 1
-                                      : binned_var(b, binned_var_component, k, j, i);
-          auto weight = weight_by_vol ? coords.CellVolume(k, j, i) : 1.0;
-          weight *= weight_var_component == -1
-                        ? 1.0
-                        : weight_var(b, weight_var_component, k, j, i);
-          res(y_bin, x_bin) += val_to_add * weight;
         });
-    // "reduce" results from scatter view to original view. May be a no-op depending on
-    // backend.
-    Kokkos::Experimental::contribute(result.KokkosView(), scatter);
   }
+  // "reduce" results from scatter view to original view. May be a no-op depending on
+  // backend.
+  if (!use_atomics) Kokkos::Experimental::contribute(results.KokkosView(), scatter);
   // Ensure all (implicit) reductions from contribute are done
   Kokkos::fence(); // May not be required
 
-  // Now reduce over ranks
+  // Now reduce the concatenated results of all histograms over ranks
 #ifdef MPI_PARALLEL
   if (Globals::my_rank == 0) {
-    PARTHENON_MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, result.data(), result.size(),
+    PARTHENON_MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, results.data(), results.size(),
                                    MPI_PARTHENON_REAL, MPI_SUM, 0, MPI_COMM_WORLD));
   } else {
-    PARTHENON_MPI_CHECK(MPI_Reduce(result.data(), result.data(), result.size(),
+    PARTHENON_MPI_CHECK(MPI_Reduce(results.data(), results.data(), results.size(),
                                    MPI_PARTHENON_REAL, MPI_SUM, 0, MPI_COMM_WORLD));
   }
 #endif
-  Kokkos::Profiling::popRegion(); // Calculate single histogram
-}
 
-} // namespace HistUtil
-
-//----------------------------------------------------------------------------------------
-//! \fn void HistogramOutput:::SetupHistograms(ParameterInput *pin)
-//  \brief Process parameter input to setup persistent histograms
-HistogramOutput::HistogramOutput(const OutputParameters &op, ParameterInput *pin)
-    : OutputType(op) {
-
-  hist_names_ = pin->GetVector<std::string>(op.block_name, "hist_names");
-
-  for (auto &hist_name : hist_names_) {
-    histograms_.emplace_back(pin, op.block_name, hist_name);
+  // unpack the flat results into the (nybins, nxbins) result of each histogram
+  for (int h = 0; h < nhist; h++) {
+    auto result = histograms_[h].result_;
+    const int offset = params_h_(h).result_offset;
+    const int nxbins = result.extent_int(1);
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, "CopyHistogram", DevExecSpace(), 0,
+        result.extent_int(0) - 1, 0, nxbins - 1, KOKKOS_LAMBDA(const int j, const int i) {
+          result(j, i) = results(offset + j * nxbins + i);
+        });
   }
+  Kokkos::Profiling::popRegion(); // Calculate all histograms
 }
 
 std::string HistogramOutput::GenerateFilename_(ParameterInput *pin, SimTime *tm,
@@ -460,16 +525,14 @@ std::string HistogramOutput::GenerateFilename_(ParameterInput *pin, SimTime *tm,
 //  \brief  Calculate histograms
 void HistogramOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
                                       const SignalHandler::OutputSignal signal) {
-  Kokkos::Profiling::pushRegion("Calculate all histograms");
-  for (auto &hist : histograms_) {
-    hist.CalcHist(pm);
-  }
-  Kokkos::Profiling::popRegion(); // Calculate all histograms
+  CalcHistograms_(pm);
 
   Kokkos::Profiling::pushRegion("Dump histograms");
   // Given the expect size of histograms, we'll use serial HDF
   if (Globals::my_rank == 0) {
     using namespace HDF5;
+    // an HDF5 output may still be written in the background
+    AsyncWriter::Wait();
     H5P const pl_xfer = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_XFER));
 
     // As we're reusing the interface from the existing hdf5 output, we have to define
@@ -27,12 +27,14 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "coordinates/coordinates.hpp"
 #include "defs.hpp"
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
+#include "outputs/inline_diagnostics.hpp"
 #include "outputs/outputs.hpp"
 #include "parthenon_arrays.hpp"
 #include "utils/error_checking.hpp"
@@ -51,60 +53,81 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
   }
   std::vector<std::string> all_labels = {};
   std::vector<Real> all_results = {};
+  std::vector<UserHistoryOperation> all_ops = {};
+
+  // Get "base" MeshData, which always exists but may not be populated yet
+  auto &md_base = pm->mesh_data.Get();
+  // Populated with all blocks
+  if (md_base->NumBlocks() == 0) {
+    md_base->Set(pm->block_list, pm);
+  } else if (md_base->NumBlocks() != pm->block_list.size()) {
+    PARTHENON_WARN(
+        "Resetting \"base\" MeshData to contain all blocks. This indicates that "
+        "the \"base\" MeshData container has been modified elsewhere. Double check "
+        "that the modification was intentional and is compatible with this reset.")
+    md_base->Set(pm->block_list, pm);
+  }
 
   // Loop over all packages of the application
   for (const auto &pkg : pm->packages.AllPackages()) {
     // Check if the package has enrolled functions which are stored in the
-    // Params under the `hist_param_key` name.
+    // Params under the `hist_param_key` and `hist_vec_param_key` names, and for
+    // inline diagnostics the `inline_diag_param_key`.
     const auto &params = pkg.second->AllParams();
-    if (!params.hasKey(hist_param_key)) {
-      continue;
+    if (params.hasKey(hist_param_key)) {
+      for (const auto &hist_var : params.Get<HstVar_list>(hist_param_key)) {
+        all_results.emplace_back(hist_var.hst_fun(md_base.get()));
+        all_labels.emplace_back(hist_var.label);
+        all_ops.emplace_back(hist_var.hst_op);
+      }
     }
-    const auto &hist_vars = params.Get<HstVar_list>(hist_param_key);
-
-    for (const auto &hist_var : hist_vars) {
-      // Get "base" MeshData, which always exists but may not be populated yet
-      auto &md_base = pm->mesh_data.Get();
-      // Populated with all blocks
-      if (md_base->NumBlocks() == 0) {
-        md_base->Set(pm->block_list, pm);
-      } else if (md_base->NumBlocks() != pm->block_list.size()) {
-        PARTHENON_WARN(
-            "Resetting \"base\" MeshData to contain all blocks. This indicates that "
-            "the \"base\" MeshData container has been modified elsewhere. Double check "
-            "that the modification was intentional and is compatible with this reset.")
-        md_base->Set(pm->block_list, pm);
+    if (params.hasKey(hist_vec_param_key)) {
+      for (const auto &hist_vec : params.Get<HstVec_list>(hist_vec_param_key)) {
+        const auto results = hist_vec.hst_vec_fun(md_base.get());
+        PARTHENON_REQUIRE_THROWS(results.size() == hist_vec.labels.size(),
+                                 "History function returned " +
+                                     std::to_string(results.size()) + " values for " +
+                                     std::to_string(hist_vec.labels.size()) + " labels");
+        all_results.insert(all_results.end(), results.begin(), results.end());
+        all_labels.insert(all_labels.end(), hist_vec.labels.begin(),
+                          hist_vec.labels.end());
+        all_ops.insert(all_ops.end(), results.size(), hist_vec.hst_op);
       }
-      auto result = hist_var.hst_fun(md_base.get());
+    }
+    if (params.hasKey(inline_diag_param_key)) {
+      params.Get<std::shared_ptr<InlineDiagnostics>>(inline_diag_param_key)
+          ->GetResults(all_labels, all_ops, all_results);
+    }
+  }
+
 #ifdef MPI_PARALLEL
-      // need fence so that the result is ready prior to the MPI call
-      Kokkos::fence();
-      // apply separate chosen operations to each user-defined history output
-      MPI_Op usr_op;
-      switch (hist_var.hst_op) {
-      case UserHistoryOperation::sum:
-        usr_op = MPI_SUM;
-        break;
-      case UserHistoryOperation::max:
-        usr_op = MPI_MAX;
-        break;
-      case UserHistoryOperation::min:
-        usr_op = MPI_MIN;
-        break;
-      }
-      if (Globals::my_rank == 0) {
-        PARTHENON_MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, &result, 1, MPI_PARTHENON_REAL,
-                                       usr_op, 0, MPI_COMM_WORLD));
-      } else {
-        PARTHENON_MPI_CHECK(MPI_Reduce(&result, &result, 1, MPI_PARTHENON_REAL, usr_op, 0,
-                                       MPI_COMM_WORLD));
+  // need fence so that the results are ready prior to the MPI calls
+  Kokkos::fence();
+  // gather the results by their operation and reduce each group with a single call
+  for (const auto &[op, usr_op] : {std::make_pair(UserHistoryOperation::sum, MPI_SUM),
+                                  std::make_pair(UserHistoryOperation::max, MPI_MAX),
+                                  std::make_pair(UserHistoryOperation::min, MPI_MIN)}) {
+    std::vector<std::size_t> idx;
+    std::vector<Real> results;
+    for (std::size_t n = 0; n < all_results.size(); ++n) {
+      if (all_ops[n] == op) {
+        idx.push_back(n);
+        results.push_back(all_results[n]);
       }
-#endif
-
-      all_results.emplace_back(result);
-      all_labels.emplace_back(hist_var.label);
+    }
+    if (results.empty()) continue;
+    if (Globals::my_rank == 0) {
+      PARTHENON_MPI_CHECK(MPI_Reduce(MPI_IN_PLACE, results.data(), results.size(),
+                                     MPI_PARTHENON_REAL, usr_op, 0, MPI_COMM_WORLD));
+    } else {
+      PARTHENON_MPI_CHECK(MPI_Reduce(results.data(), results.data(), results.size(),
+                                     MPI_PARTHENON_REAL, usr_op, 0, MPI_COMM_WORLD));
+    }
+    for (std::size_t n = 0; n < idx.size(); ++n) {
+      all_results[idx[n]] = results[n];
     }
   }
+#endif
 
   // only the master rank writes the file
   // create filename: "file_basename" + ".hst".  There is no file number.
@@ -0,0 +1,115 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file inline_diagnostics.cpp
+//  \brief statistics that are accumulated by kernels that already read the data
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "outputs/inline_diagnostics.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+namespace {
+int AddLabel(std::vector<std::string> &labels, const std::string &label,
+             const bool allocated) {
+  PARTHENON_REQUIRE_THROWS(!allocated, "Inline diagnostic " + label +
+                                           " added after the diagnostics were used");
+  labels.push_back(label);
+  return labels.size() - 1;
+}
+} // namespace
+
+InlineStat InlineDiagnostics::AddSum(const std::string &label) {
+  return InlineStat{AddLabel(sum_labels_, label, allocated_)};
+}
+
+InlineStat InlineDiagnostics::AddMax(const std::string &label) {
+  return InlineStat{AddLabel(max_labels_, label, allocated_)};
+}
+
+InlineStat InlineDiagnostics::AddMin(const std::string &label) {
+  return InlineStat{AddLabel(min_labels_, label, allocated_)};
+}
+
+InlineHistogram InlineDiagnostics::AddHistogram(const std::string &label,
+                                                const int nbins, const Real xmin,
+                                                const Real xmax) {
+  PARTHENON_REQUIRE_THROWS(nbins > 0 && xmax > xmin,
+                           "Inline histogram " + label +
+                               " needs nbins > 0 and xmax > xmin");
+  const int offset = sum_labels_.size();
+  for (int bin = 0; bin < nbins; ++bin) {
+    AddLabel(sum_labels_, label + "_" + std::to_string(bin), allocated_);
+  }
+  return InlineHistogram{offset, nbins, xmin, (xmax - xmin) / nbins};
+}
+
+void InlineDiagnostics::Allocate_() {
+  if (allocated_) return;
+  sum_ = decltype(sum_)("inline diagnostics sums", sum_labels_.size());
+  max_ = decltype(max_)("inline diagnostics maxima", max_labels_.size());
+  min_ = decltype(min_)("inline diagnostics minima", min_labels_.size());
+  acc_.sum_ = sum_t(sum_);
+  acc_.max_ = max_t(max_);
+  acc_.min_ = min_t(min_);
+  allocated_ = true;
+  Reset();
+}
+
+InlineDiagnostics::Accumulator InlineDiagnostics::GetAccumulator() {
+  Allocate_();
+  return acc_;
+}
+
+void InlineDiagnostics::Reset() {
+  if (!allocated_) return;
+  acc_.sum_.reset();
+  acc_.max_.reset();
+  acc_.min_.reset();
+  // the duplicates of the ScatterViews are contributed into the views, which have to
+  // be reset as well, see also HistogramOutput::CalcHistograms_
+  Kokkos::deep_copy(sum_, 0.0);
+  Kokkos::deep_copy(max_, std::numeric_limits<Real>::lowest());
+  Kokkos::deep_copy(min_, std::numeric_limits<Real>::max());
+  contributed_ = false;
+}
+
+void InlineDiagnostics::GetResults(std::vector<std::string> &labels,
+                                   std::vector<UserHistoryOperation> &ops,
+                                   std::vector<Real> &values) {
+  Allocate_();
+  if (!contributed_) {
+    Kokkos::Experimental::contribute(sum_, acc_.sum_);
+    Kokkos::Experimental::contribute(max_, acc_.max_);
+    Kokkos::Experimental::contribute(min_, acc_.min_);
+    contributed_ = true;
+  }
+  const auto append = [&](const std::vector<std::string> &new_labels,
+                          const UserHistoryOperation op, const auto &view) {
+    auto view_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), view);
+    for (std::size_t n = 0; n < new_labels.size(); ++n) {
+      labels.push_back(new_labels[n]);
+      ops.push_back(op);
+      values.push_back(view_h(n));
+    }
+  };
+  append(sum_labels_, UserHistoryOperation::sum, sum_);
+  append(max_labels_, UserHistoryOperation::max, max_);
+  append(min_labels_, UserHistoryOperation::min, min_);
+}
+
+} // namespace parthenon
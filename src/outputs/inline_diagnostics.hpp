@@ -0,0 +1,130 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef OUTPUTS_INLINE_DIAGNOSTICS_HPP_
+#define OUTPUTS_INLINE_DIAGNOSTICS_HPP_
+//! \file inline_diagnostics.hpp
+//  \brief statistics that are accumulated by kernels that already read the data
+
+#include <string>
+#include <vector>
+
+// ScatterView is not part of Kokkos core interface
+#include "Kokkos_ScatterView.hpp"
+
+#include "basic_types.hpp"
+#include "defs.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+
+// Handles of the quantities of an InlineDiagnostics object, which kernels capture by
+// value
+struct InlineStat {
+  int idx;
+};
+// nbins bins of width dx starting at xmin
+struct InlineHistogram {
+  int offset, nbins;
+  Real xmin, dx;
+};
+
+// Reduce-on-the-fly diagnostics, i.e., sums, extrema and histograms that are
+// accumulated by kernels that read the data anyway (e.g., the flux divergence or the
+// timestep estimate) rather than by kernels of their own, which is what history
+// functions and histogram outputs do.  A package registers its quantities when it is
+// initialized and enrolls the object under the inline_diag_param_key,
+//
+//   auto diag = std::make_shared<InlineDiagnostics>();
+//   const auto max_u = diag->AddMax("max u");
+//   pkg->AddParam<>(parthenon::inline_diag_param_key, diag);
+//
+// and its kernels accumulate into the Accumulator of the object,
+//
+//   auto acc = diag->GetAccumulator();
+//   par_for(..., KOKKOS_LAMBDA(...) { acc.Max(max_u, u(b, k, j, i)); });
+//
+// The quantities are reset at the start of every cycle by EvolutionDriver::Execute, so
+// kernels that run more than once per cycle (e.g., once per stage) should only
+// accumulate once.  History outputs write them, reduced over all ranks, as additional
+// columns, with one column per bin for histograms.
+class InlineDiagnostics {
+  template <typename Op>
+  using scatter_t =
+      Kokkos::Experimental::ScatterView<Real *, LayoutWrapper, DevExecSpace, Op>;
+  using sum_t = scatter_t<Kokkos::Experimental::ScatterSum>;
+  using max_t = scatter_t<Kokkos::Experimental::ScatterMax>;
+  using min_t = scatter_t<Kokkos::Experimental::ScatterMin>;
+
+ public:
+  class Accumulator {
+   public:
+    KOKKOS_INLINE_FUNCTION void Sum(const InlineStat &s, const Real val) const {
+      auto access = sum_.access();
+      access(s.idx) += val;
+    }
+    KOKKOS_INLINE_FUNCTION void Max(const InlineStat &s, const Real val) const {
+      auto access = max_.access();
+      access(s.idx).update(val);
+    }
+    KOKKOS_INLINE_FUNCTION void Min(const InlineStat &s, const Real val) const {
+      auto access = min_.access();
+      access(s.idx).update(val);
+    }
+    // adds weight to the bin of x, values outside of the bins (and NaNs) are ignored
+    KOKKOS_INLINE_FUNCTION void Bin(const InlineHistogram &h, const Real x,
+                                    const Real weight = 1.0) const {
+      const Real pos = (x - h.xmin) / h.dx;
+      if (!(pos >= 0.0 && pos < h.nbins)) return;
+      auto access = sum_.access();
+      access(h.offset + static_cast<int>(pos)) += weight;
+    }
+
+   private:
+    friend class InlineDiagnostics;
+    sum_t sum_;
+    max_t max_;
+    min_t min_;
+  };
+
+  InlineStat AddSum(const std::string &label);
+  InlineStat AddMax(const std::string &label);
+  InlineStat AddMin(const std::string &label);
+  // nbins linear bins in [xmin, xmax), written as columns label_0, label_1, ...
+  InlineHistogram AddHistogram(const std::string &label, const int nbins,
+                               const Real xmin, const Real xmax);
+
+  Accumulator GetAccumulator();
+  // sets all quantities to the identity of their reduction
+  void Reset();
+  // Labels, reduction operations and values on this rank of all quantities (bins
+  // included).  The values are those accumulated since the last Reset, and should
+  // only be gathered once per Reset.
+  void GetResults(std::vector<std::string> &labels,
+                  std::vector<UserHistoryOperation> &ops, std::vector<Real> &values);
+
+ private:
+  void Allocate_();
+
+  std::vector<std::string> sum_labels_, max_labels_, min_labels_;
+  Kokkos::View<Real *, LayoutWrapper, DevMemSpace> sum_, max_, min_;
+  Accumulator acc_;
+  bool allocated_ = false;
+  bool contributed_ = false;
+};
+
+// Hardcoded global entry to be used by each package to enroll its inline diagnostics
+const char inline_diag_param_key[] = "InlineDiagnostics";
+
+} // namespace parthenon
+
+#endif // OUTPUTS_INLINE_DIAGNOSTICS_HPP_
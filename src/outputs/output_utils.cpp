@@ -48,9 +48,17 @@ void SwarmInfo::AddOffsets(const SP_Swarm &swarm) {
 AllSwarmInfo::AllSwarmInfo(BlockList_t &block_list,
                            const std::map<std::string, std::set<std::string>> &swarmnames,
                            bool is_restart) {
+  // Defragment all swarms on all blocks in one go, so that the active particles of each
+  // block are the first GetNumActive() ones
+  std::vector<Swarm *> all_swarms;
+  for (auto &pmb : block_list) {
+    for (auto &swarm : pmb->swarm_data.Get()->allSwarms()) {
+      all_swarms.push_back(swarm.get());
+    }
+  }
+  Swarm::Defrag(all_swarms);
   for (auto &pmb : block_list) {
     auto &swarm_container = pmb->swarm_data.Get();
-    swarm_container->DefragAll(); // JMM: If we defrag, we don't need to mask?
     if (is_restart) {
       using FC = parthenon::Metadata::FlagCollection;
       auto flags =
@@ -102,8 +110,8 @@ AllSwarmInfo::AllSwarmInfo(BlockList_t &block_list,
 
 // Tools that can be shared accross Output types
 
-std::vector<Real> ComputeXminBlocks(Mesh *pm) {
-  return FlattenBlockInfo<Real>(pm, pm->ndim,
+std::vector<Real> ComputeXminBlocks(Mesh *pm, const BlockList_t &blocks) {
+  return FlattenBlockInfo<Real>(blocks, pm->ndim,
                                 [=](MeshBlock *pmb, std::vector<Real> &data, int &i) {
                                   auto xmin = pmb->coords.GetXmin();
                                   data[i++] = xmin[0];
@@ -116,17 +124,17 @@ std::vector<Real> ComputeXminBlocks(Mesh *pm) {
                                 });
 }
 
-std::vector<int64_t> ComputeLocs(Mesh *pm) {
+std::vector<int64_t> ComputeLocs(const BlockList_t &blocks) {
   return FlattenBlockInfo<int64_t>(
-      pm, 3, [=](MeshBlock *pmb, std::vector<int64_t> &locs, int &i) {
+      blocks, 3, [=](MeshBlock *pmb, std::vector<int64_t> &locs, int &i) {
         locs[i++] = pmb->loc.lx1();
         locs[i++] = pmb->loc.lx2();
         locs[i++] = pmb->loc.lx3();
       });
 }
 
-std::vector<int> ComputeIDsAndFlags(Mesh *pm) {
-  return FlattenBlockInfo<int>(pm, 5,
+std::vector<int> ComputeIDsAndFlags(const BlockList_t &blocks) {
+  return FlattenBlockInfo<int>(blocks, 5,
                                [=](MeshBlock *pmb, std::vector<int> &data, int &i) {
                                  data[i++] = pmb->loc.level();
                                  data[i++] = pmb->gid;
@@ -139,28 +147,40 @@ std::vector<int> ComputeIDsAndFlags(Mesh *pm) {
 // TODO(JMM): I could make this use the other loop
 // functionality/high-order functions.  but it was more code than this
 // for, I think, little benefit.
-void ComputeCoords(Mesh *pm, bool face, const IndexRange &ib, const IndexRange &jb,
-                   const IndexRange &kb, std::vector<Real> &x, std::vector<Real> &y,
-                   std::vector<Real> &z) {
-  const int nx1 = ib.e - ib.s + 1;
-  const int nx2 = jb.e - jb.s + 1;
-  const int nx3 = kb.e - kb.s + 1;
-  const int num_blocks = pm->block_list.size();
+void ComputeCoords(const BlockList_t &blocks, bool face, const IndexRange &ib,
+                   const IndexRange &jb, const IndexRange &kb, std::vector<Real> &x,
+                   std::vector<Real> &y, std::vector<Real> &z,
+                   const std::array<int, 3> &downsample) {
+  const auto [fi, fj, fk] = downsample;
+  const int nx1 = (ib.e - ib.s + 1) / fi;
+  const int nx2 = (jb.e - jb.s + 1) / fj;
+  const int nx3 = (kb.e - kb.s + 1) / fk;
+  const int num_blocks = blocks.size();
   x.resize((nx1 + face) * num_blocks);
   y.resize((nx2 + face) * num_blocks);
   z.resize((nx3 + face) * num_blocks);
   std::size_t idx_x = 0, idx_y = 0, idx_z = 0;
 
+  // the center of a combined cell is the center between its faces
+  auto coord = [face](const auto &coords, auto dir, const int i, const int f) {
+    constexpr int d = decltype(dir)::value;
+    if (face) return coords.template Xf<d>(i);
+    if (f == 1) return coords.template Xc<d>(i);
+    return 0.5 * (coords.template Xf<d>(i) + coords.template Xf<d>(i + f));
+  };
+  using Dir1 = std::integral_constant<int, 1>;
+  using Dir2 = std::integral_constant<int, 2>;
+  using Dir3 = std::integral_constant<int, 3>;
   // note relies on casting of bool to int
-  for (auto &pmb : pm->block_list) {
-    for (int i = ib.s; i <= ib.e + face; ++i) {
-      x[idx_x++] = face ? pmb->coords.Xf<1>(i) : pmb->coords.Xc<1>(i);
+  for (auto &pmb : blocks) {
+    for (int n = 0; n < nx1 + face; ++n) {
+      x[idx_x++] = coord(pmb->coords, Dir1(), ib.s + n * fi, fi);
     }
-    for (int j = jb.s; j <= jb.e + face; ++j) {
-      y[idx_y++] = face ? pmb->coords.Xf<2>(j) : pmb->coords.Xc<2>(j);
+    for (int n = 0; n < nx2 + face; ++n) {
+      y[idx_y++] = coord(pmb->coords, Dir2(), jb.s + n * fj, fj);
     }
-    for (int k = kb.s; k <= kb.e + face; ++k) {
-      z[idx_z++] = face ? pmb->coords.Xf<3>(k) : pmb->coords.Xc<3>(k);
+    for (int n = 0; n < nx3 + face; ++n) {
+      z[idx_z++] = coord(pmb->coords, Dir3(), kb.s + n * fk, fk);
     }
   }
 }
@@ -20,6 +20,8 @@
 
 // C++
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <set>
@@ -118,6 +120,13 @@ struct SwarmVarInfo {
     return n[d - 2];
   }
 };
+// The particles of a swarm variable on one block, see SwarmInfo::FillHostBuffer
+template <typename T>
+struct SwarmOutputSegment {
+  const T *data;
+  std::size_t npool, count, offset;
+};
+
 // Contains information about a particle swarm spanning
 // meshblocks. Everything needed for output
 struct SwarmInfo {
@@ -149,50 +158,55 @@ struct SwarmInfo {
     var_info[varname] = SwarmVarInfo(var->GetDim(6), var->GetDim(5), var->GetDim(4),
                                      var->GetDim(3), var->GetDim(2), rank, t, vector);
   }
-  // Copies swarmvar to host in prep for output
+  // Copies swarmvar to host in prep for output.  The swarms are defragmented, so the
+  // active particles of each block are the first counts[b].  They are gathered into one
+  // device buffer, component by component and block by block, by a single kernel and
+  // copied to the host in one go.
   template <typename T>
   std::vector<T> FillHostBuffer(const std::string vname,
                                 ParticleVariableVector<T> &swmvarvec) {
     const auto &vinfo = var_info.at(vname);
+    const int nblocks = swmvarvec.size();
+    PARTHENON_REQUIRE_THROWS(nblocks == static_cast<int>(counts.size()),
+                             "Swarm variable " + vname + " is not on every block");
     std::vector<T> host_data(count_on_rank * vinfo.nvar);
-    std::size_t ivec = 0;
-    for (int n6 = 0; n6 < vinfo.GetN(6); ++n6) {
-      for (int n5 = 0; n5 < vinfo.GetN(5); ++n5) {
-        for (int n4 = 0; n4 < vinfo.GetN(4); ++n4) {
-          for (int n3 = 0; n3 < vinfo.GetN(3); ++n3) {
-            for (int n2 = 0; n2 < vinfo.GetN(2); ++n2) {
-              std::size_t block_idx = 0;
-              for (auto &swmvar : swmvarvec) {
-                // Copied extra times. JMM: If we defrag, unneeded?
-                // auto mask_h = masks[block_idx].GetHostMirrorAndCopy();
-                // Prevents us from having to copy extra data for swarm vars
-                // with multiple components
-                auto v_h = swmvar->GetHostMirrorAndCopy(n6, n5, n4, n3, n2);
-                // DO NOT use GetDim, as it does not reflect particle count
-                std::size_t particles_to_add = counts[block_idx];
-                std::size_t particles_added = 0;
-                for (std::size_t i = 0; i < particles_to_add; ++i) {
-                  if (true) { //(mask_h(i)) {
-                    host_data[ivec++] = v_h(i);
-                    particles_added++;
-                  }
-                }
-                if (particles_added != particles_to_add) {
-                  std::string msg = StringPrintf(
-                      "Not all active particles output! "
-                      "var, n6, n5, n4, n3, n2, block, particles_added, counts = "
-                      "%s %d %d %d %d %d %d %d %d",
-                      vname.c_str(), n6, n5, n4, n3, n2, block_idx, particles_added,
-                      particles_to_add);
-                  PARTHENON_THROW(msg);
-                }
-                ++block_idx;
-              }
-            }
-          }
-        }
-      }
+    if (host_data.empty()) return host_data;
+
+    using Segment = SwarmOutputSegment<T>;
+    Kokkos::View<Segment *, DevMemSpace> segments("FillHostBuffer segments", nblocks);
+    auto segments_h = Kokkos::create_mirror_view(segments);
+    std::size_t offset = 0;
+    for (int b = 0; b < nblocks; ++b) {
+      const auto &data = swmvarvec[b]->data;
+      // DO NOT use GetDim(1) for the count, as it does not reflect particle count
+      segments_h(b) = Segment{data.data(), static_cast<std::size_t>(data.GetDim(1)),
+                              counts[b], offset};
+      offset += counts[b];
     }
+    Kokkos::deep_copy(segments, segments_h);
+
+    // In both layouts of swarm variables the particle index runs fastest, so component
+    // c of particle i is at c * npool + i
+    Kokkos::View<T *, DevMemSpace> staged(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "FillHostBuffer staged"),
+        host_data.size());
+    const std::size_t nparticles = count_on_rank;
+    const int nvar = vinfo.nvar;
+    Kokkos::parallel_for(
+        PARTHENON_AUTO_LABEL,
+        Kokkos::TeamPolicy<>(DevExecSpace(), nblocks * nvar, Kokkos::AUTO),
+        KOKKOS_LAMBDA(team_mbr_t team_member) {
+          const int b = team_member.league_rank() % nblocks;
+          const int c = team_member.league_rank() / nblocks;
+          const Segment seg = segments(b);
+          T *dst = staged.data() + c * nparticles + seg.offset;
+          const T *src = seg.data + c * seg.npool;
+          Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, seg.count),
+                               [&](const std::size_t i) { dst[i] = src[i]; });
+        });
+    Kokkos::View<T *, Kokkos::HostSpace, Kokkos::MemoryUnmanaged> host_view(
+        host_data.data(), host_data.size());
+    Kokkos::deep_copy(host_view, staged);
     return host_data; // move semantics
   }
 };
@@ -204,11 +218,11 @@ struct AllSwarmInfo {
 };
 
 template <typename T, typename Function_t>
-std::vector<T> FlattenBlockInfo(Mesh *pm, int shape, Function_t f) {
-  const int num_blocks_local = static_cast<int>(pm->block_list.size());
+std::vector<T> FlattenBlockInfo(const BlockList_t &blocks, int shape, Function_t f) {
+  const int num_blocks_local = static_cast<int>(blocks.size());
   std::vector<T> data(shape * num_blocks_local);
   int i = 0;
-  for (auto &pmb : pm->block_list) {
+  for (auto &pmb : blocks) {
     f(pmb.get(), data, i);
   }
   return data;
@@ -249,12 +263,182 @@ void PackOrUnpackVar(MeshBlock *pmb, Variable<Real> *pvar, bool do_ghosts, idx_t
   }
 }
 
-void ComputeCoords(Mesh *pm, bool face, const IndexRange &ib, const IndexRange &jb,
-                   const IndexRange &kb, std::vector<Real> &x, std::vector<Real> &y,
-                   std::vector<Real> &z);
-std::vector<Real> ComputeXminBlocks(Mesh *pm);
-std::vector<int64_t> ComputeLocs(Mesh *pm);
-std::vector<int> ComputeIDsAndFlags(Mesh *pm);
+// data of a variable on one block, see PackVarOnDevice
+template <typename T>
+struct BlockDataPtr {
+  T *ptr;
+};
+
+// The elements of a variable on a block in the order of PackOrUnpackVar, i.e., the
+// element n of a block is element Index(n) of the data of the variable on the block.
+// With a downsampling factor d > 1 (without ghost zones only), the cells of cell
+// variables are combined into cells of d cells in each (non-trivial) direction, with
+// Index(n) being the first and Offset(m) the offset of the m-th of the cells combined
+// into element n.
+struct PackedVarShape {
+  int N3, N2, N1;
+  IndexRange kb, jb, ib;
+  int fk = 1, fj = 1, fi = 1;
+  int nk, nj, ni;
+  std::size_t block_size;
+
+  PackedVarShape(MeshBlock *pmb, Variable<Real> *pvar, bool do_ghosts,
+                 const int downsample = 1)
+      : N3(pvar->GetDim(3)), N2(pvar->GetDim(2)), N1(pvar->GetDim(1)), kb{0, N3 - 1},
+        jb{0, N2 - 1}, ib{0, N1 - 1} {
+    const IndexDomain domain = (do_ghosts ? IndexDomain::entire : IndexDomain::interior);
+    if (pvar->metadata().Where() == MetadataFlag(Metadata::Cell)) {
+      kb = pmb->cellbounds.GetBoundsK(domain);
+      jb = pmb->cellbounds.GetBoundsJ(domain);
+      ib = pmb->cellbounds.GetBoundsI(domain);
+      PARTHENON_REQUIRE_THROWS(downsample == 1 || !do_ghosts,
+                               "Can't downsample with ghost zones");
+      fi = downsample;
+      fj = (jb.e > jb.s) ? downsample : 1;
+      fk = (kb.e > kb.s) ? downsample : 1;
+    }
+    nk = kb.e - kb.s + 1;
+    nj = jb.e - jb.s + 1;
+    ni = ib.e - ib.s + 1;
+    PARTHENON_REQUIRE_THROWS(nk % fk == 0 && nj % fj == 0 && ni % fi == 0,
+                             "Block size isn't divisible by the downsampling factor");
+    nk /= fk;
+    nj /= fj;
+    ni /= fi;
+    block_size = static_cast<std::size_t>(pvar->GetDim(6)) * pvar->GetDim(5) *
+                 pvar->GetDim(4) * nk * nj * ni;
+  }
+
+  int NumCombined() const { return fk * fj * fi; }
+
+  KOKKOS_INLINE_FUNCTION std::size_t Index(std::size_t n) const {
+    const int i = ib.s + (n % ni) * fi;
+    n /= ni;
+    const int j = jb.s + (n % nj) * fj;
+    n /= nj;
+    const int k = kb.s + (n % nk) * fk;
+    n /= nk; // the flattened t, u, v index
+    return ((n * N3 + k) * N2 + j) * N1 + i;
+  }
+
+  KOKKOS_INLINE_FUNCTION std::size_t Offset(const int m) const {
+    const int di = m % fi;
+    const int dj = (m / fi) % fj;
+    const int dk = m / (fi * fj);
+    return (static_cast<std::size_t>(dk) * N2 + dj) * N1 + di;
+  }
+};
+
+// Device counterpart of PackOrUnpackVar for writing output.  Gathers the data of a
+// variable on all nblocks blocks, without ghost zones unless do_ghosts, into the
+// contiguous device buffer out with a single kernel, converting to Data_t and in the same
+// order as PackOrUnpackVar.  blocks(b).ptr is the data of the variable on block b, or
+// nullptr where the variable isn't allocated, in which case the block is set to fill_val.
+// pvar and pmb provide the shape of the variable and the bounds of the blocks, which
+// are the same on all blocks.  With downsample > 1, cell variables are averaged over
+// downsample cells in each direction, see PackedVarShape.  Returns the number of
+// elements of out that were set.
+template <typename Data_t>
+std::size_t
+PackVarOnDevice(MeshBlock *pmb, Variable<Real> *pvar, bool do_ghosts,
+                const Kokkos::View<BlockDataPtr<const Real> *, DevMemSpace> &blocks,
+                const int nblocks, const Data_t fill_val,
+                const Kokkos::View<Data_t *, DevMemSpace> &out,
+                const int downsample = 1) {
+  const PackedVarShape shape(pmb, pvar, do_ghosts, downsample);
+  const int ncombined = shape.NumCombined();
+  const std::size_t block_size = shape.block_size;
+  const std::size_t size = block_size * nblocks;
+  PARTHENON_REQUIRE_THROWS(size <= out.extent(0), "Output buffer is too small");
+  Kokkos::parallel_for(
+      "OutputUtils::PackVarOnDevice",
+      Kokkos::RangePolicy<DevExecSpace>(DevExecSpace(), 0, size),
+      KOKKOS_LAMBDA(const std::size_t idx) {
+        const Real *data = blocks(idx / block_size).ptr;
+        if (data == nullptr) {
+          out(idx) = fill_val;
+        } else if (ncombined == 1) {
+          out(idx) = static_cast<Data_t>(data[shape.Index(idx % block_size)]);
+        } else {
+          const Real *first = data + shape.Index(idx % block_size);
+          Real sum = 0.0;
+          for (int m = 0; m < ncombined; ++m) {
+            sum += first[shape.Offset(m)];
+          }
+          out(idx) = static_cast<Data_t>(sum / ncombined);
+        }
+      });
+  return size;
+}
+
+// The reverse of PackVarOnDevice for reading restart files, scatters in into the blocks
+// where blocks(b).ptr isn't nullptr, on the execution space instance exec_space
+template <typename Data_t>
+void UnpackVarOnDevice(MeshBlock *pmb, Variable<Real> *pvar, bool do_ghosts,
+                       const Kokkos::View<BlockDataPtr<Real> *, DevMemSpace> &blocks,
+                       const int nblocks, const Kokkos::View<Data_t *, DevMemSpace> &in,
+                       const DevExecSpace &exec_space) {
+  const PackedVarShape shape(pmb, pvar, do_ghosts);
+  const std::size_t block_size = shape.block_size;
+  const std::size_t size = block_size * nblocks;
+  PARTHENON_REQUIRE_THROWS(size <= in.extent(0), "Input buffer is too small");
+  Kokkos::parallel_for(
+      "OutputUtils::UnpackVarOnDevice",
+      Kokkos::RangePolicy<DevExecSpace>(exec_space, 0, size),
+      KOKKOS_LAMBDA(const std::size_t idx) {
+        Real *data = blocks(idx / block_size).ptr;
+        if (data != nullptr) data[shape.Index(idx % block_size)] = in(idx);
+      });
+}
+
+KOKKOS_INLINE_FUNCTION std::uint64_t Mix64(std::uint64_t x) {
+  // splitmix64 finalizer
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Hash of the data of a variable on nblocks blocks that doesn't depend on which rank
+// holds which block, so the hashes of all ranks are combined by summing them.
+// blocks(b).ptr is the data of the variable on the block with global id gids(b), or
+// nullptr where the variable isn't allocated, and size the number of elements of the
+// data of the variable on a block.
+inline std::uint64_t
+HashVarOnDevice(const Kokkos::View<BlockDataPtr<const Real> *, DevMemSpace> &blocks,
+                const Kokkos::View<int *, DevMemSpace> &gids, const int nblocks,
+                const std::size_t size) {
+  std::uint64_t hash = 0;
+  Kokkos::parallel_reduce(
+      "OutputUtils::HashVarOnDevice",
+      Kokkos::RangePolicy<DevExecSpace>(DevExecSpace(), 0, size * nblocks),
+      KOKKOS_LAMBDA(const std::size_t idx, std::uint64_t &lhash) {
+        const int b = idx / size;
+        const std::size_t n = idx % size;
+        const std::uint64_t element = static_cast<std::uint64_t>(gids(b)) * size + n;
+        const Real *data = blocks(b).ptr;
+        if (data != nullptr) {
+          std::uint64_t bits = 0;
+          std::memcpy(&bits, &data[n], sizeof(Real));
+          lhash += Mix64(bits ^ Mix64(element));
+        } else if (n == 0) {
+          lhash += Mix64(~element);
+        }
+      },
+      Kokkos::Sum<std::uint64_t>(hash));
+  return hash;
+}
+
+// The coordinates of the (faces of the) cells of blocks, where with downsampling
+// factors (in i, j, k order) > 1, as many cells are combined into one, see
+// PackedVarShape
+void ComputeCoords(const BlockList_t &blocks, bool face, const IndexRange &ib,
+                   const IndexRange &jb, const IndexRange &kb, std::vector<Real> &x,
+                   std::vector<Real> &y, std::vector<Real> &z,
+                   const std::array<int, 3> &downsample = {1, 1, 1});
+std::vector<Real> ComputeXminBlocks(Mesh *pm, const BlockList_t &blocks);
+std::vector<int64_t> ComputeLocs(const BlockList_t &blocks);
+std::vector<int> ComputeIDsAndFlags(const BlockList_t &blocks);
 
 // TODO(JMM): Potentially unsafe if MPI_UNSIGNED_LONG_LONG isn't a size_t
 // however I think it's probably safe to assume we'll be on systems
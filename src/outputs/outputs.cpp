@@ -61,6 +61,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
 #include <iomanip>
 #include <iostream>
 #include <set>
@@ -73,8 +74,10 @@
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/meshblock.hpp"
+#include "outputs/parthenon_hdf5.hpp"
 #include "parameter_input.hpp"
 #include "parthenon_arrays.hpp"
+#include "parthenon_mpi.hpp"
 #include "utils/error_checking.hpp"
 
 namespace parthenon {
@@ -184,6 +187,14 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
           PARTHENON_THROW(err)
         }
 #endif
+        op.hdf5_compression_filter =
+            pin->GetOrAddString(op.block_name, "hdf5_compression_filter", "deflate");
+        const std::set<std::string> filters{"deflate", "shuffle_deflate", "blosc_lz4",
+                                            "lz4", "zfp"};
+        PARTHENON_REQUIRE_THROWS(filters.count(op.hdf5_compression_filter) > 0,
+                                 "Unknown hdf5_compression_filter " +
+                                     op.hdf5_compression_filter);
+        op.hdf5_zfp_accuracy = pin->GetOrAddReal(op.block_name, "hdf5_zfp_accuracy", 0.0);
       } else {
         op.hdf5_compression_level = 0;
 
@@ -246,6 +257,8 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
         pnew_type = new VTKOutput(op);
       } else if (op.file_type == "ascent") {
         pnew_type = new AscentOutput(op);
+      } else if (op.file_type == "adios2") {
+        pnew_type = new ADIOS2Output(op);
       } else if (op.file_type == "histogram") {
 #ifdef ENABLE_HDF5
         pnew_type = new HistogramOutput(op, pin);
@@ -264,6 +277,103 @@ Outputs::Outputs(Mesh *pm, ParameterInput *pin, SimTime *tm) {
         }
 #ifdef ENABLE_HDF5
         op.write_xdmf = pin->GetOrAddBoolean(op.block_name, "write_xdmf", true);
+        op.async_write = pin->GetOrAddBoolean(op.block_name, "async_write", false);
+        op.io_aggregators_per_node =
+            pin->GetOrAddInteger(op.block_name, "io_aggregators_per_node", 0);
+        PARTHENON_REQUIRE_THROWS(op.io_aggregators_per_node >= 0,
+                                 "io_aggregators_per_node must be >= 0");
+        op.subfiling = pin->GetOrAddBoolean(op.block_name, "subfiling", false);
+        op.mpi_io_hints = pin->GetOrAddString(op.block_name, "mpi_io_hints", "");
+        const int alignment = pin->GetOrAddInteger(op.block_name, "hdf5_alignment", 0);
+        const int alignment_threshold =
+            pin->GetOrAddInteger(op.block_name, "hdf5_alignment_threshold", 0);
+        const int meta_block_size =
+            pin->GetOrAddInteger(op.block_name, "hdf5_meta_block_size", 0);
+        PARTHENON_REQUIRE_THROWS(alignment >= 0 && alignment_threshold >= 0 &&
+                                     meta_block_size >= 0,
+                                 "hdf5_alignment, hdf5_alignment_threshold, and "
+                                 "hdf5_meta_block_size must be >= 0");
+        op.hdf5_alignment = alignment;
+        op.hdf5_alignment_threshold = alignment_threshold;
+        op.hdf5_meta_block_size = meta_block_size;
+        op.gpu_direct = pin->GetOrAddBoolean(op.block_name, "gpu_direct", false);
+        if (restart) {
+          op.incremental = pin->GetOrAddBoolean(op.block_name, "incremental", false);
+          op.incremental_full_every =
+              pin->GetOrAddInteger(op.block_name, "incremental_full_every", 0);
+          op.staging_dir = pin->GetOrAddString(op.block_name, "staging_dir", "");
+          op.keep_restarts = pin->GetOrAddInteger(op.block_name, "keep_restarts", 0);
+          PARTHENON_REQUIRE_THROWS(op.keep_restarts >= 0, "keep_restarts must be >= 0");
+          // incremental restart files link to files up to the last complete one
+          PARTHENON_REQUIRE_THROWS(!op.incremental || op.keep_restarts == 0 ||
+                                       (op.incremental_full_every > 0 &&
+                                        op.keep_restarts >= op.incremental_full_every),
+                                   "With incremental restarts, keep_restarts must be 0 "
+                                   "or at least incremental_full_every");
+          if (!op.staging_dir.empty()) {
+            if (Globals::my_rank == 0) {
+              std::filesystem::create_directories(op.staging_dir);
+            }
+#ifdef MPI_PARALLEL
+            PARTHENON_MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+#endif
+          }
+        } else {
+          // restart files always hold the full mesh
+          const char *dirs[3] = {"x1", "x2", "x3"};
+          for (int d = 0; d < 3; ++d) {
+            const std::string min_name = std::string("region_") + dirs[d] + "min";
+            const std::string max_name = std::string("region_") + dirs[d] + "max";
+            if (pin->DoesParameterExist(op.block_name, min_name)) {
+              op.region_min[d] = pin->GetReal(op.block_name, min_name);
+            }
+            if (pin->DoesParameterExist(op.block_name, max_name)) {
+              op.region_max[d] = pin->GetReal(op.block_name, max_name);
+            }
+            PARTHENON_REQUIRE_THROWS(op.region_min[d] <= op.region_max[d],
+                                     "region_" + std::string(dirs[d]) +
+                                         "min must not be larger than region_" +
+                                         dirs[d] + "max");
+          }
+          op.downsample = pin->GetOrAddInteger(op.block_name, "downsample", 1);
+          PARTHENON_REQUIRE_THROWS(op.downsample >= 1, "downsample must be >= 1");
+          PARTHENON_REQUIRE_THROWS(op.downsample == 1 || !op.include_ghost_zones,
+                                   "downsample can't be used with ghost zones");
+        }
+        if (op.subfiling) {
+          PARTHENON_REQUIRE_THROWS(!restart, "Restart outputs can't use subfiling, "
+                                             "restarting needs a single file");
+          PARTHENON_REQUIRE_THROWS(HDF5::SubfilingSupported(),
+                                   "subfiling requires HDF5 built with the subfiling "
+                                   "VFD and MPI_THREAD_MULTIPLE, see "
+                                   "PARTHENON_MPI_THREAD_MULTIPLE");
+          // the subfiling VFD doesn't support filters
+          if (op.hdf5_compression_level > 0) {
+            std::stringstream warn;
+            warn << "HDF5 compression can't be used with subfiling. Disabling it for "
+                    "output block '"
+                 << op.block_name << "'";
+            PARTHENON_WARN(warn);
+            op.hdf5_compression_level = 0;
+          }
+        }
+        if (op.gpu_direct) {
+          PARTHENON_REQUIRE_THROWS(HDF5::GPUDirectSupported(),
+                                   "gpu_direct requires Parthenon built with "
+                                   "PARTHENON_ENABLE_HDF5_GDS");
+          PARTHENON_REQUIRE_THROWS(!op.async_write,
+                                   "gpu_direct can't be combined with async_write, "
+                                   "which stages the data on the host");
+          // filters run on the host
+          if (op.hdf5_compression_level > 0) {
+            std::stringstream warn;
+            warn << "HDF5 compression can't be used with gpu_direct. Disabling it for "
+                    "output block '"
+                 << op.block_name << "'";
+            PARTHENON_WARN(warn);
+            op.hdf5_compression_level = 0;
+          }
+        }
         pnew_type = new PHDF5Output(op, restart);
 #else
         msg << "### FATAL ERROR in Outputs constructor" << std::endl
@@ -415,13 +525,20 @@ void OutputType::ClearOutputData() {
 void Outputs::MakeOutputs(Mesh *pm, ParameterInput *pin, SimTime *tm,
                           const SignalHandler::OutputSignal signal) {
   PARTHENON_INSTRUMENT
-  bool first = true;
+  bool first = true, first_any = true;
+  int num_restored = 0;
   OutputType *ptype = pfirst_type_;
   while (ptype != nullptr) {
     if ((tm == nullptr) ||
         ((ptype->output_params.dt >= 0.0) &&
          ((tm->ncycle == 0) || (tm->time >= ptype->output_params.next_time) ||
           (tm->time >= tm->tlim) || (signal != SignalHandler::OutputSignal::none)))) {
+      if (first_any) {
+        // outputs read the data of evicted variables on the device
+        num_restored = pm->RestoreEvictedVariables();
+        pm->FillDerivedOnDemand();
+        first_any = false;
+      }
       if (first && ptype->output_params.file_type != "hst") {
         pm->ApplyUserWorkBeforeOutput(pin);
         first = false;
@@ -430,6 +547,7 @@ void Outputs::MakeOutputs(Mesh *pm, ParameterInput *pin, SimTime *tm,
     }
     ptype = ptype->pnext_type; // move to next OutputType node in singly linked list
   }
+  if (num_restored > 0) pm->EvictVariables();
 }
 
 } // namespace parthenon
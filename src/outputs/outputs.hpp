@@ -19,10 +19,16 @@
 //! \file outputs.hpp
 //  \brief provides classes to handle ALL types of data output
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Kokkos_ScatterView.hpp"
@@ -64,13 +70,53 @@ struct OutputParameters {
   bool single_precision_output;
   bool sparse_seed_nans;
   int hdf5_compression_level;
+  // "deflate", "shuffle_deflate", "blosc_lz4", "lz4" or "zfp", and the default error
+  // bound of zfp (0 for lossless), see SetCompressionFilter in parthenon_hdf5.cpp
+  std::string hdf5_compression_filter;
+  Real hdf5_zfp_accuracy;
   bool write_xdmf;
+  // finish writing HDF5 outputs in the background, see HDF5::AsyncWriter
+  bool async_write;
+  // number of ranks per node that write to HDF5 files (0 lets MPI-IO decide), and
+  // whether files are written through the HDF5 subfiling VFD, see
+  // HDF5::GenerateFileAccessProps
+  int io_aggregators_per_node;
+  bool subfiling;
+  // MPI-IO hints ("key=value,...") and HDF5 alignment and metadata block size (in
+  // bytes, 0 for the HDF5 default) of the files, see HDF5::FileAccessTuning
+  std::string mpi_io_hints;
+  std::size_t hdf5_alignment, hdf5_alignment_threshold, hdf5_meta_block_size;
+  // variable data is written from device memory through the HDF5 GDS VFD, see
+  // HDF5::GPUDirectSupported
+  bool gpu_direct;
+  // restart files only contain the variables that changed since they were last
+  // written, with every incremental_full_every-th numbered restart file (if > 0) being
+  // complete, see PHDF5Output::last_written_
+  bool incremental;
+  int incremental_full_every;
+  // restart files are written to staging_dir (if not empty) first and then moved to
+  // their destination in the background, and only the last keep_restarts numbered
+  // restart files (if > 0) are kept, see PHDF5Output::FinishRestart_
+  std::string staging_dir;
+  int keep_restarts;
+  // only blocks overlapping [region_min, region_max] are written, and downsample^d
+  // cells are averaged into one, see PackVarOnDevice
+  std::array<Real, 3> region_min, region_max;
+  int downsample;
   // TODO(felker): some of the parameters in this class are not initialized in constructor
   OutputParameters()
       : block_number(0), next_time(0.0), dt(-1.0), file_number(0),
         include_ghost_zones(false), cartesian_vector(false),
         single_precision_output(false), sparse_seed_nans(false),
-        hdf5_compression_level(5), write_xdmf(false) {}
+        hdf5_compression_level(5), hdf5_compression_filter("deflate"),
+        hdf5_zfp_accuracy(0.0), write_xdmf(false), async_write(false),
+        io_aggregators_per_node(0), subfiling(false), hdf5_alignment(0),
+        hdf5_alignment_threshold(0), hdf5_meta_block_size(0), gpu_direct(false),
+        incremental(false),
+        incremental_full_every(0), keep_restarts(0), downsample(1) {
+    region_min.fill(std::numeric_limits<Real>::lowest());
+    region_max.fill(std::numeric_limits<Real>::max());
+  }
 };
 
 //----------------------------------------------------------------------------------------
@@ -151,6 +197,24 @@ using HstVar_list = std::vector<HistoryOutputVar>;
 // Hardcoded global entry to be used by each package to enroll user output functions
 const char hist_param_key[] = "HistoryFunctions";
 
+// Functions that compute several history quantities at once, e.g., with a single
+// multi-value reduction instead of one reduction per quantity.  They return one value
+// per label, all of which are reduced with the same operation.
+using HstVecFun_t = std::function<std::vector<Real>(MeshData<Real> *md)>;
+
+struct HistoryOutputVec {
+  UserHistoryOperation hst_op;     // Reduction operation
+  HstVecFun_t hst_vec_fun;         // Function to be called
+  std::vector<std::string> labels; // column labels in hst output file
+  HistoryOutputVec(const UserHistoryOperation &hst_op_, const HstVecFun_t &hst_vec_fun_,
+                   const std::vector<std::string> &labels_)
+      : hst_op(hst_op_), hst_vec_fun(hst_vec_fun_), labels(labels_) {}
+};
+
+using HstVec_list = std::vector<HistoryOutputVec>;
+// Hardcoded global entry to be used by each package to enroll vector output functions
+const char hist_vec_param_key[] = "HistoryVectorFunctions";
+
 //----------------------------------------------------------------------------------------
 //! \class HistoryFile
 //  \brief derived OutputType class for history dumps
@@ -169,9 +233,11 @@ class HistoryOutput : public OutputType {
 class VTKOutput : public OutputType {
  public:
   explicit VTKOutput(const OutputParameters &oparams) : OutputType(oparams) {}
-  void WriteContainer(SimTime &tm, Mesh *pm, ParameterInput *pin, bool flag) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
                        const SignalHandler::OutputSignal signal) override;
+
+ private:
+  std::string GenerateBasename_(const SignalHandler::OutputSignal signal) const;
 };
 
 //----------------------------------------------------------------------------------------
@@ -180,17 +246,43 @@ class VTKOutput : public OutputType {
 
 class AscentOutput : public OutputType {
  public:
-  explicit AscentOutput(const OutputParameters &oparams) : OutputType(oparams) {}
+  explicit AscentOutput(const OutputParameters &oparams);
+  ~AscentOutput();
   void WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
                        const SignalHandler::OutputSignal signal) override;
 
  private:
+  // The Ascent instance and the blueprint tree published to it.  Both are kept across
+  // outputs, and the tree is only rebuilt when the mesh changes.
+  struct Session;
+  std::unique_ptr<Session> session_;
   //  Ghost mask currently (Ascent 0.9) needs to be of float type on device as the
   //  automated conversion between int and float does not work
   ParArray1D<Real> ghost_mask_;
 };
 
+//----------------------------------------------------------------------------------------
+//! \class ADIOS2Output
+//  \brief derived OutputType class for writing or streaming data through ADIOS2
+
+class ADIOS2Output : public OutputType {
+ public:
+  explicit ADIOS2Output(const OutputParameters &oparams);
+  ~ADIOS2Output();
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
+                       const SignalHandler::OutputSignal signal) override;
+
+ private:
+  // The ADIOS2 IO and the engine, which is opened on the first output, see adios2.cpp
+  struct Session;
+  std::unique_ptr<Session> session_;
+};
+
 #ifdef ENABLE_HDF5
+namespace XDMF {
+struct GridCache;
+} // namespace XDMF
+
 //----------------------------------------------------------------------------------------
 //! \class PHDF5Output
 //  \brief derived OutputType class for Athena HDF5 files or restart dumps
@@ -209,18 +301,40 @@ class PHDF5Output : public OutputType {
  private:
   std::string GenerateFilename_(ParameterInput *pin, SimTime *tm,
                                 const SignalHandler::OutputSignal signal);
-  void WriteBlocksMetadata_(Mesh *pm, hid_t file, const HDF5::H5P &pl, hsize_t offset,
+  // blocks are the local blocks that are written, and selected_gid flags the written
+  // blocks of all ranks
+  void WriteBlocksMetadata_(Mesh *pm, const BlockList_t &blocks, hid_t file,
+                            const HDF5::H5P &pl, hsize_t offset,
                             hsize_t max_blocks_global) const;
-  void WriteCoordinates_(Mesh *pm, const IndexDomain &domain, hid_t file,
-                         const HDF5::H5P &pl, hsize_t offset,
+  void WriteCoordinates_(Mesh *pm, const BlockList_t &blocks, const IndexDomain &domain,
+                         hid_t file, const HDF5::H5P &pl, hsize_t offset,
                          hsize_t max_blocks_global) const;
-  void WriteLevelsAndLocs_(Mesh *pm, hid_t file, const HDF5::H5P &pl, hsize_t offset,
+  void WriteLevelsAndLocs_(Mesh *pm, const std::vector<bool> &selected_gid, hid_t file,
+                           const HDF5::H5P &pl, hsize_t offset,
                            hsize_t max_blocks_global) const;
-  void WriteSparseInfo_(Mesh *pm, hbool_t *sparse_allocated,
+  void WriteSparseInfo_(Mesh *pm, const BlockList_t &blocks, hbool_t *sparse_allocated,
                         const std::vector<std::string> &sparse_names, hsize_t num_sparse,
                         hid_t file, const HDF5::H5P &pl, size_t offset,
                         hsize_t max_blocks_global) const;
+  // the file the output is written to, which is in the staging directory if there is one
+  std::string StagingFilename_(const std::string &filename) const;
+  void FinishRestart_(const SignalHandler::OutputSignal signal);
   const bool restart_; // true if we write a restart file, false for regular output files
+  bool warned_async_ = false;
+  // For incremental restarts, the hash of each variable and the numbered restart file it
+  // was last written to.  Variables whose hash didn't change are stored as external
+  // links to that file.
+  struct WrittenVar {
+    std::uint64_t hash;
+    std::string filename;
+  };
+  std::unordered_map<std::string, WrittenVar> last_written_;
+  int num_numbered_restarts_ = 0;
+  // name of the last file written, and the numbered restart files that are kept
+  std::string last_filename_;
+  std::deque<std::string> kept_restarts_;
+  // the grids of the blocks in the XDMF files, see XDMF::GridCache
+  std::shared_ptr<XDMF::GridCache> xdmf_grids_;
 };
 
 //----------------------------------------------------------------------------------------
@@ -255,11 +369,23 @@ struct Histogram {
   int weight_var_component_;
   ParArray2D<Real> result_; // resulting histogram
 
-  // temp view for histogram reduction for better performance (switches
-  // between atomics and data duplication depending on the platform)
-  Kokkos::Experimental::ScatterView<Real **, LayoutWrapper> scatter_result;
   Histogram(ParameterInput *pin, const std::string &block_name, const std::string &name);
-  void CalcHist(Mesh *pm);
+};
+
+// Device side description of a histogram so that all histograms of an output can be
+// calculated in a single kernel. Edges and results are offsets into flat arrays that
+// hold the edges and results of all histograms.
+struct HistogramKernelParams {
+  int ndim;
+  VarType x_var_type, y_var_type;
+  // index of the bin variables, binned variable, and weight variable in the pack of
+  // all variables used by the histograms. -1 if unused.
+  int x_var_idx, y_var_idx, binned_var_idx, weight_var_idx;
+  EdgeType x_edges_type, y_edges_type;
+  int x_edges_offset, x_num_edges, y_edges_offset, y_num_edges;
+  Real x_edge_min, x_edge_dbin, y_edge_min, y_edge_dbin;
+  bool accumulate, weight_by_vol;
+  int result_offset; // first entry of the (nybins, nxbins) result in the flat array
 };
 
 } // namespace HistUtil
@@ -273,8 +399,21 @@ class HistogramOutput : public OutputType {
  private:
   std::string GenerateFilename_(ParameterInput *pin, SimTime *tm,
                                 const SignalHandler::OutputSignal signal);
+  void CalcHistograms_(Mesh *pm);
   std::vector<std::string> hist_names_; // names (used as id) for different histograms
   std::vector<HistUtil::Histogram> histograms_;
+
+  // All histograms are calculated in one sweep per partition and reduced over ranks at
+  // once, so their edges and results are also stored in flat arrays.
+  std::vector<std::string> var_names_; // variables used by any of the histograms
+  ParArray1D<HistUtil::HistogramKernelParams> params_;
+  ParArray1D<HistUtil::HistogramKernelParams>::HostMirror params_h_;
+  ParArray1D<Real> edges_;
+  ParArray1D<Real> results_;
+  bool use_atomics_; // accumulate results with atomics rather than the ScatterView
+  // temp view for histogram reduction for better performance (switches
+  // between atomics and data duplication depending on the platform)
+  Kokkos::Experimental::ScatterView<Real *, LayoutWrapper> scatter_results_;
 };
 #endif // ifdef ENABLE_HDF5
 
@@ -23,14 +23,27 @@
 // Only proceed if HDF5 output enabled
 #ifdef ENABLE_HDF5
 
+#ifdef ENABLE_HDF5_GDS
+#include <H5FDgds.h>
+#endif
+
 #include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <limits>
 #include <memory>
 #include <numeric>
 #include <set>
+#include <sstream>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "driver/driver.hpp"
 #include "interface/metadata.hpp"
@@ -40,18 +53,145 @@
 #include "outputs/outputs.hpp"
 #include "outputs/parthenon_hdf5.hpp"
 #include "outputs/parthenon_xdmf.hpp"
+#include "parthenon_mpi.hpp"
 #include "utils/string_utils.hpp"
 
 namespace parthenon {
 
+namespace {
+// The data of a variable, staged on the host, to be written by an AsyncWriter job
+template <typename OutT>
+struct StagedDataset {
+  std::string name;
+  int ndim;
+  std::array<hsize_t, HDF5::H5_NDIM> local_offset, local_count, global_count;
+  HDF5::H5P dcreate;
+  std::vector<OutT> data;
+};
+
+template <typename OutT>
+struct StagedOutputFile {
+  HDF5::H5F file;
+  HDF5::H5P xfer;
+  std::vector<StagedDataset<OutT>> datasets;
+};
+
+#ifndef PARTHENON_DISABLE_HDF5_COMPRESSION
+// IDs of the dynamically loaded filters registered with The HDF Group
+constexpr H5Z_filter_t blosc_filter_id = 32001;
+constexpr H5Z_filter_t lz4_filter_id = 32004;
+constexpr H5Z_filter_t zfp_filter_id = 32013;
+
+void SetFilter(hid_t dcreate, const H5Z_filter_t id, const std::string &filter,
+               const std::vector<unsigned int> &cd_values) {
+  PARTHENON_REQUIRE_THROWS(H5Zfilter_avail(id) > 0,
+                           "HDF5 filter plugin for " + filter +
+                               " compression not found, check HDF5_PLUGIN_PATH");
+  PARTHENON_HDF5_CHECK(H5Pset_filter(dcreate, id, H5Z_FLAG_MANDATORY, cd_values.size(),
+                                     cd_values.data()));
+}
+
+// Add the compression filter of an output (see the hdf5_compression_filter output
+// option) to the creation property list of a chunked dataset of variable var_name
+void SetCompressionFilter(hid_t dcreate, const OutputParameters &params,
+                          ParameterInput *pin, const std::string &var_name) {
+  const auto &filter = params.hdf5_compression_filter;
+  const unsigned int level = std::min(9, params.hdf5_compression_level);
+  if (filter == "deflate") {
+    PARTHENON_HDF5_CHECK(H5Pset_deflate(dcreate, level));
+  } else if (filter == "shuffle_deflate") {
+    PARTHENON_HDF5_CHECK(H5Pset_shuffle(dcreate));
+    PARTHENON_HDF5_CHECK(H5Pset_deflate(dcreate, level));
+  } else if (filter == "blosc_lz4") {
+    // the first four values are set by the filter, followed by the compression level,
+    // byte shuffle and the compressor, BLOSC_LZ4
+    SetFilter(dcreate, blosc_filter_id, filter, {0, 0, 0, 0, level, 1, 1});
+  } else if (filter == "lz4") {
+    PARTHENON_HDF5_CHECK(H5Pset_shuffle(dcreate));
+    // default block size
+    SetFilter(dcreate, lz4_filter_id, filter, {0});
+  } else if (filter == "zfp") {
+    const std::string var_key = "hdf5_zfp_accuracy_" + var_name;
+    const double accuracy = pin->DoesParameterExist(params.block_name, var_key)
+                                ? pin->GetReal(params.block_name, var_key)
+                                : params.hdf5_zfp_accuracy;
+    if (accuracy > 0.0) {
+      // fixed accuracy mode, with the bound as a double in the last two values
+      std::vector<unsigned int> cd_values{3, 0, 0, 0};
+      std::memcpy(&cd_values[2], &accuracy, sizeof(accuracy));
+      SetFilter(dcreate, zfp_filter_id, filter, cd_values);
+    } else {
+      // lossless (reversible) mode
+      SetFilter(dcreate, zfp_filter_id, filter, {5});
+    }
+  } else {
+    PARTHENON_THROW("Unknown HDF5 compression filter " + filter);
+  }
+}
+#endif
+} // namespace
+
 void PHDF5Output::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
                                   const SignalHandler::OutputSignal signal) {
   using namespace HDF5;
+  // the previous output may still be written in the background
+  AsyncWriter::Wait();
   if (output_params.single_precision_output) {
     this->template WriteOutputFileImpl<true>(pm, pin, tm, signal);
   } else {
     this->template WriteOutputFileImpl<false>(pm, pin, tm, signal);
   }
+  if (restart_ &&
+      (!output_params.staging_dir.empty() || output_params.keep_restarts > 0)) {
+    FinishRestart_(signal);
+  }
+}
+
+std::string PHDF5Output::StagingFilename_(const std::string &filename) const {
+  if (output_params.staging_dir.empty()) return filename;
+  return (std::filesystem::path(output_params.staging_dir) /
+          std::filesystem::path(filename).filename())
+      .string();
+}
+
+// Once the restart file is written (in the background), rank 0 moves it from the
+// staging directory to its destination, records it as the latest restart file in
+// <basename>.<file id>.latest and removes the numbered restart files beyond the last
+// keep_restarts ones
+void PHDF5Output::FinishRestart_(const SignalHandler::OutputSignal signal) {
+  if (Globals::my_rank != 0) return;
+  const std::string filename = last_filename_;
+  const std::string staged = StagingFilename_(filename);
+  std::vector<std::string> expired;
+  if (signal == SignalHandler::OutputSignal::none && output_params.keep_restarts > 0) {
+    kept_restarts_.push_back(filename);
+    const std::size_t keep = output_params.keep_restarts;
+    while (kept_restarts_.size() > keep) {
+      expired.push_back(kept_restarts_.front());
+      kept_restarts_.pop_front();
+    }
+  }
+  const std::string latest =
+      output_params.file_basename + "." + output_params.file_id + ".latest";
+  HDF5::AsyncWriter::Then([filename, staged, expired, latest]() {
+    namespace fs = std::filesystem;
+    if (staged != filename) {
+      // copy next to the destination first, so that a complete file appears at once
+      const std::string draining = filename + ".draining";
+      fs::copy_file(staged, draining, fs::copy_options::overwrite_existing);
+      fs::rename(draining, filename);
+      fs::remove(staged);
+    }
+    {
+      std::ofstream out(latest + ".tmp");
+      out << filename << std::endl;
+    }
+    fs::rename(latest + ".tmp", latest);
+    for (const auto &old : expired) {
+      fs::remove(old);
+      fs::remove(old + ".xdmf");
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------
@@ -74,8 +214,43 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   // HDF5 structures
   // Also writes companion xdmf file
 
-  const int max_blocks_global = pm->nbtotal;
-  const int num_blocks_local = static_cast<int>(pm->block_list.size());
+  // Only the blocks overlapping the region of the output are written.  selected_gid
+  // flags them for all ranks, blocks holds the selected blocks of this rank, and
+  // nblist the number of selected blocks of each rank.
+  std::vector<bool> selected_gid(pm->nbtotal, true);
+  std::vector<int> nblist = pm->GetNbList();
+  BlockList_t blocks = pm->block_list;
+  const auto &region_min = output_params.region_min;
+  const auto &region_max = output_params.region_max;
+  if (*std::max_element(region_min.begin(), region_min.end()) >
+          std::numeric_limits<Real>::lowest() ||
+      *std::min_element(region_max.begin(), region_max.end()) <
+          std::numeric_limits<Real>::max()) {
+    const auto loclist = pm->GetLocList();
+    // every rank holds a contiguous range of gids
+    int gid = 0;
+    for (auto &nb : nblist) {
+      const int gid_end = gid + nb;
+      for (nb = 0; gid < gid_end; ++gid) {
+        const RegionSize block_size = pm->GetBlockSize(loclist[gid]);
+        for (auto dir : {X1DIR, X2DIR, X3DIR}) {
+          selected_gid[gid] = selected_gid[gid] &&
+                              block_size.xmax(dir) >= region_min[dir - 1] &&
+                              block_size.xmin(dir) <= region_max[dir - 1];
+        }
+        nb += selected_gid[gid];
+      }
+    }
+    blocks.clear();
+    for (const auto &pmb : pm->block_list) {
+      if (selected_gid[pmb->gid]) blocks.push_back(pmb);
+    }
+  }
+  const int max_blocks_global = std::accumulate(nblist.begin(), nblist.end(), 0);
+  const int num_blocks_local = static_cast<int>(blocks.size());
+  PARTHENON_REQUIRE_THROWS(max_blocks_global > 0,
+                           "No blocks overlap the region of output block " +
+                               output_params.block_name);
 
   const IndexDomain theDomain =
       (output_params.include_ghost_zones ? IndexDomain::entire : IndexDomain::interior);
@@ -86,26 +261,37 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   const IndexRange out_jb = first_block.cellbounds.GetBoundsJ(theDomain);
   const IndexRange out_kb = first_block.cellbounds.GetBoundsK(theDomain);
 
-  auto const nx1 = out_ib.e - out_ib.s + 1;
-  auto const nx2 = out_jb.e - out_jb.s + 1;
-  auto const nx3 = out_kb.e - out_kb.s + 1;
+  // cells are only combined along the dimensions of the mesh
+  const int ds = output_params.downsample;
+  const std::array<int, 3> downsample{ds, pm->ndim > 1 ? ds : 1, pm->ndim > 2 ? ds : 1};
+  auto const nx1 = (out_ib.e - out_ib.s + 1) / downsample[0];
+  auto const nx2 = (out_jb.e - out_jb.s + 1) / downsample[1];
+  auto const nx3 = (out_kb.e - out_kb.s + 1) / downsample[2];
 
   const int rootLevel = pm->GetRootLevel();
   const int max_level = pm->GetCurrentLevel() - rootLevel;
-  const auto &nblist = pm->GetNbList();
 
   // open HDF5 file
   // Define output filename
   auto filename = GenerateFilename_(pin, tm, signal);
+  last_filename_ = filename;
 
   // set file access property list
-  H5P const acc_file = H5P::FromHIDCheck(HDF5::GenerateFileAccessProps());
+  HDF5::FileAccessTuning tuning;
+  tuning.mpi_io_hints = output_params.mpi_io_hints;
+  tuning.alignment = output_params.hdf5_alignment;
+  tuning.alignment_threshold = output_params.hdf5_alignment_threshold;
+  tuning.meta_block_size = output_params.hdf5_meta_block_size;
+  H5P acc_file = H5P::FromHIDCheck(HDF5::GenerateFileAccessProps(
+      output_params.io_aggregators_per_node, output_params.subfiling,
+      output_params.gpu_direct, tuning));
 
   // now create the file
   H5F file;
   try {
     file = H5F::FromHIDCheck(
-        H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, acc_file));
+        H5Fcreate(StagingFilename_(filename).c_str(), H5F_ACC_TRUNC, H5P_DEFAULT,
+                  acc_file));
   } catch (std::exception &ex) {
     std::stringstream err;
     err << "### ERROR: Failed to create HDF5 output file '" << filename
@@ -132,7 +318,7 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   }                                 // Input section
 
   // we'll need this again at the end
-  const H5G info_group = MakeGroup(file, "/Info");
+  H5G info_group = MakeGroup(file, "/Info");
   {
     Kokkos::Profiling::pushRegion("write Info");
     HDF5WriteAttribute("OutputFormatVersion", OUTPUT_VERSION_FORMAT, info_group);
@@ -145,7 +331,7 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
 
     HDF5WriteAttribute("WallTime", Driver::elapsed_main(), info_group);
     HDF5WriteAttribute("NumDims", pm->ndim, info_group);
-    HDF5WriteAttribute("NumMeshBlocks", pm->nbtotal, info_group);
+    HDF5WriteAttribute("NumMeshBlocks", max_blocks_global, info_group);
     HDF5WriteAttribute("MaxLevel", max_level, info_group);
     // write whether we include ghost cells or not
     HDF5WriteAttribute("IncludesGhost", output_params.include_ghost_zones ? 1 : 0,
@@ -217,8 +403,8 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
     my_offset += nblist[i];
   }
 
-  H5P const pl_xfer = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_XFER));
-  H5P const pl_dcreate = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_CREATE));
+  H5P pl_xfer = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_XFER));
+  H5P pl_dcreate = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_CREATE));
 
   // Never write fill values to the dataset
   PARTHENON_HDF5_CHECK(H5Pset_fill_time(pl_dcreate, H5D_FILL_TIME_NEVER));
@@ -227,9 +413,9 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   PARTHENON_HDF5_CHECK(H5Pset_dxpl_mpio(pl_xfer, H5FD_MPIO_COLLECTIVE));
 #endif
 
-  WriteBlocksMetadata_(pm, file, pl_xfer, my_offset, max_blocks_global);
-  WriteCoordinates_(pm, theDomain, file, pl_xfer, my_offset, max_blocks_global);
-  WriteLevelsAndLocs_(pm, file, pl_xfer, my_offset, max_blocks_global);
+  WriteBlocksMetadata_(pm, blocks, file, pl_xfer, my_offset, max_blocks_global);
+  WriteCoordinates_(pm, blocks, theDomain, file, pl_xfer, my_offset, max_blocks_global);
+  WriteLevelsAndLocs_(pm, selected_gid, file, pl_xfer, my_offset, max_blocks_global);
 
   // -------------------------------------------------------------------------------- //
   //   WRITING VARIABLES DATA                                                         //
@@ -290,6 +476,19 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   // can't use std::vector here because std::vector<hbool_t> is the same as
   // std::vector<bool> and it doesn't have .data() member
   std::unique_ptr<hbool_t[]> sparse_allocated(new hbool_t[num_blocks_local * num_sparse]);
+  {
+    std::vector<Uid_t> sparse_uids;
+    for (const auto &name : sparse_names) {
+      sparse_uids.push_back(Variable<Real>::GetUniqueID(name));
+    }
+    const auto &alloc = pm->sparse_allocation;
+    for (size_t b_idx = 0; b_idx < num_blocks_local; ++b_idx) {
+      for (size_t sparse_idx = 0; sparse_idx < num_sparse; ++sparse_idx) {
+        sparse_allocated[b_idx * num_sparse + sparse_idx] =
+            alloc.IsAllocated(blocks[b_idx]->lid, sparse_uids[sparse_idx]);
+      }
+    }
+  }
 
   // allocate space for largest size variable
   int varSize_max = 0;
@@ -299,13 +498,62 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   }
 
   using OutT = typename std::conditional<WRITE_SINGLE_PRECISION, float, Real>::type;
-  std::vector<OutT> tmpData(varSize_max * num_blocks_local);
+  std::vector<OutT> tmpData;
+
+  // With async_write, the data of each variable is staged in a buffer of its own, and
+  // the datasets are written in the background once everything else is written
+  std::unique_ptr<StagedOutputFile<OutT>> staged;
+  if (output_params.async_write) {
+    if (AsyncWriter::Supported()) {
+      staged = std::make_unique<StagedOutputFile<OutT>>();
+    } else if (Globals::my_rank == 0 && !warned_async_) {
+      PARTHENON_WARN("async_write requires MPI_THREAD_MULTIPLE, writing synchronously. "
+                     "Set PARTHENON_MPI_THREAD_MULTIPLE=1 in the environment to request "
+                     "it.");
+      warned_async_ = true;
+    }
+  }
+  // With gpu_direct, the variables are written straight from the device buffer through
+  // the GDS VFD, so there is no host buffer at all
+  const bool gpu_direct = output_params.gpu_direct;
+  if (!staged && !gpu_direct) tmpData.resize(varSize_max * num_blocks_local);
+
+  // device buffer the variables are packed into before they are copied to the host
+  Kokkos::View<OutT *, DevMemSpace> out_buf(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "output buffer"),
+      static_cast<std::size_t>(varSize_max) * num_blocks_local);
+  Kokkos::View<OutputUtils::BlockDataPtr<const Real> *, DevMemSpace> block_ptrs(
+      "output block data", num_blocks_local);
+  auto block_ptrs_h = Kokkos::create_mirror_view(block_ptrs);
+
+  // Incremental restart files link to the variables that didn't change since they were
+  // last written instead of writing them, unless this file has to be complete.  Only
+  // numbered files are linked to, since "now" and "final" files get overwritten.
+  const bool incremental = restart_ && output_params.incremental;
+  const bool numbered = (signal == SignalHandler::OutputSignal::none);
+  const int full_every = output_params.incremental_full_every;
+  const bool complete = !incremental || (numbered && full_every > 0 &&
+                                         num_numbered_restarts_ % full_every == 0);
+  if (incremental && numbered) ++num_numbered_restarts_;
+  // links are relative to the directory of the file
+  const std::string link_filename = filename.substr(filename.find_last_of('/') + 1);
+  std::vector<std::string> linked_vars, linked_files;
+  std::unordered_map<std::string, WrittenVar> written;
+  Kokkos::View<int *, DevMemSpace> gids("output block gids",
+                                        incremental ? num_blocks_local : 0);
+  if (incremental) {
+    auto gids_h = Kokkos::create_mirror_view(gids);
+    for (size_t b_idx = 0; b_idx < num_blocks_local; ++b_idx) {
+      gids_h(b_idx) = blocks[b_idx]->gid;
+    }
+    Kokkos::deep_copy(gids, gids_h);
+  }
 
   // for each variable we write
   for (auto &vinfo : all_vars_info) {
     Kokkos::Profiling::pushRegion("write variable loop");
-    // not really necessary, but doesn't hurt
-    memset(tmpData.data(), 0, tmpData.size() * sizeof(OutT));
+    // every element is set when the packed variable is copied back
+    if (staged) tmpData.resize(vinfo.Size() * num_blocks_local);
 
     const std::string var_name = vinfo.label;
     const hsize_t nx6 = vinfo.nx6;
@@ -372,79 +620,147 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
     }
 
 #ifndef PARTHENON_DISABLE_HDF5_COMPRESSION
-    PARTHENON_HDF5_CHECK(H5Pset_chunk(pl_dcreate, ndim, chunk_size.data()));
+    // chunks are assembled in the chunk cache on the host, so device data is only
+    // written to contiguous datasets
+    if (!gpu_direct) {
+      PARTHENON_HDF5_CHECK(H5Pset_chunk(pl_dcreate, ndim, chunk_size.data()));
+    }
+#endif
+    // the filters may depend on the variable
+    H5P pl_var = H5P::FromHIDCheck(H5Pcopy(pl_dcreate));
+#ifndef PARTHENON_DISABLE_HDF5_COMPRESSION
     // Do not run the pipeline if compression is soft disabled.
     // By default data would still be passed, which may result in slower output.
     if (output_params.hdf5_compression_level > 0) {
-      PARTHENON_HDF5_CHECK(
-          H5Pset_deflate(pl_dcreate, std::min(9, output_params.hdf5_compression_level)));
+      SetCompressionFilter(pl_var, output_params, pin, var_name);
     }
 #endif
 
     // load up data
-    hsize_t index = 0;
-
     Kokkos::Profiling::pushRegion("fill host output buffer");
-    // for each local mesh block
+    // collect the data of the variable on each local mesh block, the gather, the
+    // removal of ghost zones and the conversion to OutT are then done by a single kernel
+    // followed by a single copy to the host.  The shape is taken from the first block,
+    // since this rank may not write any block.
+    Variable<Real> *shape_var = nullptr;
+    for (auto &v : get_vars(pm->block_list.front())) {
+      if (var_name == v->label()) shape_var = v.get();
+    }
     for (size_t b_idx = 0; b_idx < num_blocks_local; ++b_idx) {
-      const auto &pmb = pm->block_list[b_idx];
+      const auto &pmb = blocks[b_idx];
       bool is_allocated = false;
+      block_ptrs_h(b_idx).ptr = nullptr;
 
       // for each variable that this local meshblock actually has
       const auto vars = get_vars(pmb);
       for (auto &v : vars) {
         // For reference, if we update the logic here, there's also
         // a similar block in parthenon_manager.cpp
-        if (v->IsAllocated() && (var_name == v->label())) {
-          auto v_h = v->data.GetHostMirrorAndCopy();
-          OutputUtils::PackOrUnpackVar(
-              pmb.get(), v.get(), output_params.include_ghost_zones, index, tmpData,
-              [&](auto index, int t, int u, int v, int k, int j, int i) {
-                tmpData[index] = static_cast<OutT>(v_h(t, u, v, k, j, i));
-              });
-
-          is_allocated = true;
+        if (var_name == v->label()) {
+          if (v->IsAllocated()) {
+            block_ptrs_h(b_idx).ptr = v->data.data();
+            is_allocated = true;
+          }
           break;
         }
       }
 
       if (vinfo.is_sparse) {
-        size_t sparse_idx = sparse_field_idx.at(vinfo.label);
-        sparse_allocated[b_idx * num_sparse + sparse_idx] = is_allocated;
+        PARTHENON_DEBUG_REQUIRE(
+            is_allocated == static_cast<bool>(
+                                sparse_allocated[b_idx * num_sparse +
+                                                 sparse_field_idx.at(vinfo.label)]),
+            "Sparse allocation map out of date for " + var_name);
+      } else if (!is_allocated) {
+        std::stringstream msg;
+        msg << "### ERROR: Unable to find dense variable " << var_name << std::endl;
+        PARTHENON_FAIL(msg);
       }
-
-      if (!is_allocated) {
-        if (vinfo.is_sparse) {
-          hsize_t varSize{};
-          if (vinfo.where == MetadataFlag(Metadata::Cell)) {
-            varSize = vinfo.nx6 * vinfo.nx5 * vinfo.nx4 * (out_kb.e - out_kb.s + 1) *
-                      (out_jb.e - out_jb.s + 1) * (out_ib.e - out_ib.s + 1);
-          } else {
-            varSize =
-                vinfo.nx6 * vinfo.nx5 * vinfo.nx4 * vinfo.nx3 * vinfo.nx2 * vinfo.nx1;
-          }
-          auto fill_val =
-              output_params.sparse_seed_nans ? std::numeric_limits<OutT>::quiet_NaN() : 0;
-          std::fill(tmpData.data() + index, tmpData.data() + index + varSize, fill_val);
-          index += varSize;
-        } else {
-          std::stringstream msg;
-          msg << "### ERROR: Unable to find dense variable " << var_name << std::endl;
-          PARTHENON_FAIL(msg);
-        }
+    }
+    // all blocks have all variables, allocated or not
+    PARTHENON_REQUIRE_THROWS(shape_var != nullptr, "Unable to find variable " + var_name);
+    Kokkos::deep_copy(block_ptrs, block_ptrs_h);
+    if (incremental) {
+      std::size_t size = 1;
+      for (int d = 1; d <= 6; ++d) {
+        size *= shape_var->GetDim(d);
       }
+      std::uint64_t hash =
+          OutputUtils::HashVarOnDevice(block_ptrs, gids, num_blocks_local, size);
+#ifdef MPI_PARALLEL
+      PARTHENON_MPI_CHECK(MPI_Allreduce(MPI_IN_PLACE, &hash, 1, MPI_UINT64_T, MPI_SUM,
+                                        MPI_COMM_WORLD));
+#endif
+      hash ^= OutputUtils::Mix64(pm->nbtotal);
+      const auto last = last_written_.find(var_name);
+      if (!complete && last != last_written_.end() && last->second.hash == hash) {
+        PARTHENON_HDF5_CHECK(H5Lcreate_external(last->second.filename.c_str(),
+                                                ("/" + var_name).c_str(), file,
+                                                var_name.c_str(), H5P_DEFAULT,
+                                                H5P_DEFAULT));
+        linked_vars.push_back(var_name);
+        linked_files.push_back(last->second.filename);
+        Kokkos::Profiling::popRegion(); // fill host output buffer
+        Kokkos::Profiling::popRegion(); // write variable loop
+        continue;
+      }
+      written[var_name] = WrittenVar{hash, link_filename};
+    }
+    const OutT fill_val =
+        output_params.sparse_seed_nans ? std::numeric_limits<OutT>::quiet_NaN() : 0;
+    const std::size_t size = OutputUtils::PackVarOnDevice(
+        pm->block_list.front().get(), shape_var, output_params.include_ghost_zones,
+        block_ptrs, num_blocks_local, fill_val, out_buf, output_params.downsample);
+    if (gpu_direct) {
+      Kokkos::fence();
+      Kokkos::Profiling::popRegion(); // fill host output buffer
+      Kokkos::Profiling::pushRegion("write variable data");
+      HDF5WriteND(file, var_name, out_buf.data(), ndim, &local_offset[0],
+                  &local_count[0], &global_count[0], pl_xfer, pl_var);
+      Kokkos::Profiling::popRegion(); // write variable data
+      Kokkos::Profiling::popRegion(); // write variable loop
+      continue;
     }
+    PARTHENON_REQUIRE_THROWS(size <= tmpData.size(), "Host output buffer is too small");
+    Kokkos::View<OutT *, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+        tmpData_h(tmpData.data(), size);
+    Kokkos::deep_copy(tmpData_h,
+                      Kokkos::subview(out_buf, std::make_pair(std::size_t(0), size)));
     Kokkos::Profiling::popRegion(); // fill host output buffer
 
-    Kokkos::Profiling::pushRegion("write variable data");
-    // write data to file
-    HDF5WriteND(file, var_name, tmpData.data(), ndim, &local_offset[0], &local_count[0],
-                &global_count[0], pl_xfer, pl_dcreate);
-    Kokkos::Profiling::popRegion(); // write variable data
+    if (staged) {
+      StagedDataset<OutT> dataset{var_name, ndim, {}, {}, {},
+                                  std::move(pl_var),
+                                  std::move(tmpData)};
+      std::copy_n(local_offset, H5_NDIM, dataset.local_offset.begin());
+      std::copy_n(local_count, H5_NDIM, dataset.local_count.begin());
+      std::copy_n(global_count, H5_NDIM, dataset.global_count.begin());
+      staged->datasets.push_back(std::move(dataset));
+    } else {
+      Kokkos::Profiling::pushRegion("write variable data");
+      // write data to file
+      HDF5WriteND(file, var_name, tmpData.data(), ndim, &local_offset[0],
+                  &local_count[0], &global_count[0], pl_xfer, pl_var);
+      Kokkos::Profiling::popRegion(); // write variable data
+    }
     Kokkos::Profiling::popRegion(); // write variable loop
   }
   Kokkos::Profiling::popRegion(); // write all variable data
 
+  if (incremental) {
+    // the manifest of the variables this file links to
+    HDF5WriteAttribute("IncrementalComplete", complete ? 1 : 0, info_group);
+    if (!linked_vars.empty()) {
+      HDF5WriteAttribute("IncrementalLinkedVariables", linked_vars, info_group);
+      HDF5WriteAttribute("IncrementalLinkedFiles", linked_files, info_group);
+    }
+    if (numbered) {
+      for (auto &[name, var] : written) {
+        last_written_[name] = var;
+      }
+    }
+  }
+
   // names of variables
   std::vector<std::string> var_names;
   var_names.reserve(all_vars_info.size());
@@ -476,8 +792,8 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   // write SparseInfo and SparseFields (we can't write a zero-size dataset, so only write
   // this if we have sparse fields)
   if (num_sparse > 0) {
-    WriteSparseInfo_(pm, sparse_allocated.get(), sparse_names, num_sparse, file, pl_xfer,
-                     my_offset, max_blocks_global);
+    WriteSparseInfo_(pm, blocks, sparse_allocated.get(), sparse_names, num_sparse, file,
+                     pl_xfer, my_offset, max_blocks_global);
   } // SparseInfo and SparseFields sections
 
   // -------------------------------------------------------------------------------- //
@@ -485,7 +801,7 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   // -------------------------------------------------------------------------------- //
 
   Kokkos::Profiling::pushRegion("write particle data");
-  AllSwarmInfo swarm_info(pm->block_list, output_params.swarms, restart_);
+  AllSwarmInfo swarm_info(blocks, output_params.swarms, restart_);
   for (auto &[swname, swinfo] : swarm_info.all_info) {
     const H5G g_swm = MakeGroup(file, swname);
     // offsets/counts are NOT the same here vs the grid data
@@ -550,10 +866,33 @@ void PHDF5Output::WriteOutputFileImpl(Mesh *pm, ParameterInput *pin, SimTime *tm
   if (output_params.write_xdmf) {
     Kokkos::Profiling::pushRegion("genXDMF");
     // generate XDMF companion file
-    XDMF::genXDMF(filename, pm, tm, nx1, nx2, nx3, all_vars_info, swarm_info);
+    if (xdmf_grids_ == nullptr) xdmf_grids_ = std::make_shared<XDMF::GridCache>();
+    XDMF::genXDMF(filename, pm, tm, max_blocks_global, nx1, nx2, nx3, all_vars_info,
+                  swarm_info, xdmf_grids_.get());
     Kokkos::Profiling::popRegion(); // genXDMF
   }
 
+  if (staged) {
+    // hand the file over to the background job, which must be the only one with open
+    // HDF5 objects
+    acc_file.Reset();
+    info_group.Reset();
+    pl_dcreate.Reset();
+    staged->file = std::move(file);
+    staged->xfer = std::move(pl_xfer);
+    std::shared_ptr<StagedOutputFile<OutT>> job(std::move(staged));
+    AsyncWriter::Launch([job]() {
+      for (const auto &d : job->datasets) {
+        HDF5WriteND(job->file, d.name, d.data.data(), d.ndim, d.local_offset.data(),
+                    d.local_count.data(), d.global_count.data(), job->xfer, d.dcreate);
+      }
+      // closes the file
+      job->datasets.clear();
+      job->xfer.Reset();
+      job->file.Reset();
+    });
+  }
+
   Kokkos::Profiling::popRegion(); // WriteOutputFile???Prec
 }
 // explicit template instantiation
@@ -597,12 +936,13 @@ std::string PHDF5Output::GenerateFilename_(ParameterInput *pin, SimTime *tm,
   return filename;
 }
 
-void PHDF5Output::WriteBlocksMetadata_(Mesh *pm, hid_t file, const HDF5::H5P &pl,
-                                       hsize_t offset, hsize_t max_blocks_global) const {
+void PHDF5Output::WriteBlocksMetadata_(Mesh *pm, const BlockList_t &blocks, hid_t file,
+                                       const HDF5::H5P &pl, hsize_t offset,
+                                       hsize_t max_blocks_global) const {
   using namespace HDF5;
   Kokkos::Profiling::pushRegion("I/O HDF5: write block metadata");
   const H5G gBlocks = MakeGroup(file, "/Blocks");
-  const hsize_t num_blocks_local = pm->block_list.size();
+  const hsize_t num_blocks_local = blocks.size();
   const hsize_t ndim = pm->ndim;
   const hsize_t loc_offset[2] = {offset, 0};
 
@@ -613,7 +953,7 @@ void PHDF5Output::WriteBlocksMetadata_(Mesh *pm, hid_t file, const HDF5::H5P &pl
     hsize_t loc_cnt[2] = {num_blocks_local, ndim};
     hsize_t glob_cnt[2] = {max_blocks_global, ndim};
 
-    std::vector<Real> tmpData = OutputUtils::ComputeXminBlocks(pm);
+    std::vector<Real> tmpData = OutputUtils::ComputeXminBlocks(pm, blocks);
     HDF5Write2D(gBlocks, "xmin", tmpData.data(), &loc_offset[0], &loc_cnt[0],
                 &glob_cnt[0], pl);
   }
@@ -622,7 +962,7 @@ void PHDF5Output::WriteBlocksMetadata_(Mesh *pm, hid_t file, const HDF5::H5P &pl
     // LOC.lx1,2,3
     hsize_t loc_cnt[2] = {num_blocks_local, 3};
     hsize_t glob_cnt[2] = {max_blocks_global, 3};
-    std::vector<int64_t> tmpLoc = OutputUtils::ComputeLocs(pm);
+    std::vector<int64_t> tmpLoc = OutputUtils::ComputeLocs(blocks);
     HDF5Write2D(gBlocks, "loc.lx123", tmpLoc.data(), &loc_offset[0], &loc_cnt[0],
                 &glob_cnt[0], pl);
   }
@@ -631,14 +971,15 @@ void PHDF5Output::WriteBlocksMetadata_(Mesh *pm, hid_t file, const HDF5::H5P &pl
     // (LOC.)level, GID, LID, cnghost, gflag
     hsize_t loc_cnt[2] = {num_blocks_local, 5};
     hsize_t glob_cnt[2] = {max_blocks_global, 5};
-    std::vector<int> tmpID = OutputUtils::ComputeIDsAndFlags(pm);
+    std::vector<int> tmpID = OutputUtils::ComputeIDsAndFlags(blocks);
     HDF5Write2D(gBlocks, "loc.level-gid-lid-cnghost-gflag", tmpID.data(), &loc_offset[0],
                 &loc_cnt[0], &glob_cnt[0], pl);
   }
   Kokkos::Profiling::popRegion(); // write block metadata
 }
 
-void PHDF5Output::WriteCoordinates_(Mesh *pm, const IndexDomain &domain, hid_t file,
+void PHDF5Output::WriteCoordinates_(Mesh *pm, const BlockList_t &blocks,
+                                    const IndexDomain &domain, hid_t file,
                                     const HDF5::H5P &pl, hsize_t offset,
                                     hsize_t max_blocks_global) const {
   using namespace HDF5;
@@ -647,8 +988,10 @@ void PHDF5Output::WriteCoordinates_(Mesh *pm, const IndexDomain &domain, hid_t f
   const IndexRange ib = shape.GetBoundsI(domain);
   const IndexRange jb = shape.GetBoundsJ(domain);
   const IndexRange kb = shape.GetBoundsK(domain);
+  const int ds = output_params.downsample;
+  const std::array<int, 3> downsample{ds, pm->ndim > 1 ? ds : 1, pm->ndim > 2 ? ds : 1};
 
-  const hsize_t num_blocks_local = pm->block_list.size();
+  const hsize_t num_blocks_local = blocks.size();
   const hsize_t loc_offset[2] = {offset, 0};
   hsize_t loc_cnt[2] = {num_blocks_local, 1};
   hsize_t glob_cnt[2] = {max_blocks_global, 1};
@@ -657,31 +1000,39 @@ void PHDF5Output::WriteCoordinates_(Mesh *pm, const IndexDomain &domain, hid_t f
     const H5G gLocations = MakeGroup(file, face ? "/Locations" : "/VolumeLocations");
 
     std::vector<Real> loc_x, loc_y, loc_z;
-    OutputUtils::ComputeCoords(pm, face, ib, jb, kb, loc_x, loc_y, loc_z);
+    OutputUtils::ComputeCoords(blocks, face, ib, jb, kb, loc_x, loc_y, loc_z,
+                               downsample);
 
-    loc_cnt[1] = glob_cnt[1] = (ib.e - ib.s + 1) + face;
+    loc_cnt[1] = glob_cnt[1] = (ib.e - ib.s + 1) / downsample[0] + face;
     HDF5Write2D(gLocations, "x", loc_x.data(), &loc_offset[0], &loc_cnt[0], &glob_cnt[0],
                 pl);
 
-    loc_cnt[1] = glob_cnt[1] = (jb.e - jb.s + 1) + face;
+    loc_cnt[1] = glob_cnt[1] = (jb.e - jb.s + 1) / downsample[1] + face;
     HDF5Write2D(gLocations, "y", loc_y.data(), &loc_offset[0], &loc_cnt[0], &glob_cnt[0],
                 pl);
 
-    loc_cnt[1] = glob_cnt[1] = (kb.e - kb.s + 1) + face;
+    loc_cnt[1] = glob_cnt[1] = (kb.e - kb.s + 1) / downsample[2] + face;
     HDF5Write2D(gLocations, "z", loc_z.data(), &loc_offset[0], &loc_cnt[0], &glob_cnt[0],
                 pl);
   }
   Kokkos::Profiling::popRegion(); // write mesh coords
 }
 
-void PHDF5Output::WriteLevelsAndLocs_(Mesh *pm, hid_t file, const HDF5::H5P &pl,
-                                      hsize_t offset, hsize_t max_blocks_global) const {
+void PHDF5Output::WriteLevelsAndLocs_(Mesh *pm, const std::vector<bool> &selected_gid,
+                                      hid_t file, const HDF5::H5P &pl, hsize_t offset,
+                                      hsize_t max_blocks_global) const {
   using namespace HDF5;
   Kokkos::Profiling::pushRegion("write levels and locations");
-  auto [levels, logicalLocations] = pm->GetLevelsAndLogicalLocationsFlat();
+  auto [all_levels, all_locations] = pm->GetLevelsAndLogicalLocationsFlat();
+  std::vector<std::int64_t> levels, logicalLocations;
+  for (std::size_t gid = 0; gid < selected_gid.size(); ++gid) {
+    if (!selected_gid[gid]) continue;
+    levels.push_back(all_levels[gid]);
+    logicalLocations.insert(logicalLocations.end(), all_locations.begin() + 3 * gid,
+                            all_locations.begin() + 3 * gid + 3);
+  }
 
   // Only write levels on rank 0 since it has data for all ranks
-  const hsize_t num_blocks_local = pm->block_list.size();
   const hsize_t loc_offset[2] = {offset, 0};
   const hsize_t loc_cnt[2] = {(Globals::my_rank == 0) ? max_blocks_global : 0, 3};
   const hsize_t glob_cnt[2] = {max_blocks_global, 3};
@@ -694,14 +1045,15 @@ void PHDF5Output::WriteLevelsAndLocs_(Mesh *pm, hid_t file, const HDF5::H5P &pl,
   Kokkos::Profiling::popRegion(); // write levels and locations
 }
 
-void PHDF5Output::WriteSparseInfo_(Mesh *pm, hbool_t *sparse_allocated,
+void PHDF5Output::WriteSparseInfo_(Mesh *pm, const BlockList_t &blocks,
+                                   hbool_t *sparse_allocated,
                                    const std::vector<std::string> &sparse_names,
                                    hsize_t num_sparse, hid_t file, const HDF5::H5P &pl,
                                    size_t offset, hsize_t max_blocks_global) const {
   using namespace HDF5;
   Kokkos::Profiling::pushRegion("write sparse info");
 
-  const hsize_t num_blocks_local = pm->block_list.size();
+  const hsize_t num_blocks_local = blocks.size();
   const hsize_t loc_offset[2] = {offset, 0};
   const hsize_t loc_cnt[2] = {num_blocks_local, num_sparse};
   const hsize_t glob_cnt[2] = {max_blocks_global, num_sparse};
@@ -816,7 +1168,66 @@ void HDF5ReadAttribute(hid_t location, const std::string &name, std::string &val
   val = vec[0];
 }
 
-hid_t GenerateFileAccessProps() {
+void AsyncWriter::Launch(std::function<void()> job) {
+  Wait();
+  pending_ = std::async(std::launch::async, std::move(job));
+}
+
+void AsyncWriter::Then(std::function<void()> job) {
+  std::future<void> previous = std::move(pending_);
+  pending_ = std::async(std::launch::async,
+                        [previous = std::move(previous), job = std::move(job)]() mutable {
+                          if (previous.valid()) previous.get();
+                          job();
+                        });
+}
+
+void AsyncWriter::Wait() {
+  if (pending_.valid()) pending_.get();
+}
+
+bool AsyncWriter::Supported() {
+#ifdef MPI_PARALLEL
+  int provided;
+  PARTHENON_MPI_CHECK(MPI_Query_thread(&provided));
+  return provided == MPI_THREAD_MULTIPLE;
+#else
+  return true;
+#endif
+}
+
+bool SubfilingSupported() {
+#if defined(MPI_PARALLEL) && defined(H5_HAVE_SUBFILING_VFD)
+  return AsyncWriter::Supported();
+#else
+  return false;
+#endif
+}
+
+bool GPUDirectSupported() {
+#ifdef ENABLE_HDF5_GDS
+  return true;
+#else
+  return false;
+#endif
+}
+
+hid_t GenerateFileAccessProps(int aggregators_per_node, bool subfiling, bool gpu_direct,
+                              const FileAccessTuning &tuning) {
+  if (gpu_direct) {
+#ifdef ENABLE_HDF5_GDS
+    hid_t acc_file = H5Pcreate(H5P_FILE_ACCESS);
+    // the default memory alignment, file block size, and size of the bounce buffer
+    // used for host memory of the VFD
+    constexpr std::size_t alignment = 4096, block_size = 4096;
+    constexpr std::size_t cbuf_size = 16 * 1024 * 1024;
+    PARTHENON_HDF5_CHECK(H5Pset_fapl_gds(acc_file, alignment, block_size, cbuf_size));
+    return acc_file;
+#else
+    PARTHENON_THROW("Parthenon was built without the HDF5 GDS VFD, see "
+                    "PARTHENON_ENABLE_HDF5_GDS");
+#endif
+  }
 #ifdef MPI_PARALLEL
   /* set the file access template for parallel IO access */
   hid_t acc_file = H5Pcreate(H5P_FILE_ACCESS);
@@ -853,8 +1264,10 @@ hid_t GenerateFileAccessProps() {
 
   // Sets the minimum metadata block size, in bytes.
   // Default: Disabled
-  hsize_t meta_block_size = Env::get<hsize_t>("H5_meta_block_size", 8 * MiB, exists);
-  if (exists) {
+  const bool meta_block_set = (tuning.meta_block_size > 0);
+  hsize_t meta_block_size = Env::get<hsize_t>(
+      "H5_meta_block_size", meta_block_set ? tuning.meta_block_size : 8 * MiB, exists);
+  if (exists || meta_block_set) {
     PARTHENON_HDF5_CHECK(H5Pset_meta_block_size(acc_file, meta_block_size));
   }
 
@@ -864,9 +1277,14 @@ hid_t GenerateFileAccessProps() {
   hsize_t threshold; // Threshold value. Setting to 0 forces everything to be aligned.
   hsize_t alignment; // Alignment value.
 
-  threshold = Env::get<hsize_t>("H5_alignment_threshold", 0, exists);
-  alignment = Env::get<hsize_t>("H5_alignment_alignment", 8 * MiB, exists2);
-  if (exists || exists2) {
+  // e.g., the stripe size of a Lustre file system, so that the (chunks of) block
+  // datasets larger than the threshold don't straddle stripes
+  const bool alignment_set = (tuning.alignment > 0);
+  threshold = Env::get<hsize_t>("H5_alignment_threshold", tuning.alignment_threshold,
+                                exists);
+  alignment = Env::get<hsize_t>("H5_alignment_alignment",
+                                alignment_set ? tuning.alignment : 8 * MiB, exists2);
+  if (exists || exists2 || alignment_set) {
     PARTHENON_HDF5_CHECK(H5Pset_alignment(acc_file, threshold, alignment));
   }
 
@@ -897,9 +1315,14 @@ hid_t GenerateFileAccessProps() {
     ~MPI_InfoDeleter() { MPI_Info_free(&info); }
   } delete_info{FILE_INFO_TEMPLATE};
 
+  // Hints set through environment variables, which the hints of the input don't
+  // override
+  std::set<std::string> env_hints;
+
   // Hint specifies the manner in which the file will be accessed until the file is closed
   const auto access_style =
       Env::get<std::string>("MPI_access_style", "write_once", exists);
+  if (exists) env_hints.insert("access_style");
   PARTHENON_MPI_CHECK(
       MPI_Info_set(FILE_INFO_TEMPLATE, "access_style", access_style.c_str()));
 
@@ -908,6 +1331,7 @@ hid_t GenerateFileAccessProps() {
   bool collective_buffering = Env::get<bool>("MPI_collective_buffering", false, exists);
   if (exists) {
     PARTHENON_MPI_CHECK(MPI_Info_set(FILE_INFO_TEMPLATE, "collective_buffering", "true"));
+    env_hints.insert({"collective_buffering", "cb_block_size", "cb_buffer_size"});
     // Specifies the block size to be used for collective buffering file acces
     const auto cb_block_size =
         Env::get<std::string>("MPI_cb_block_size", "1048576", exists);
@@ -921,6 +1345,62 @@ hid_t GenerateFileAccessProps() {
         MPI_Info_set(FILE_INFO_TEMPLATE, "cb_buffer_size", cb_buffer_size.c_str()));
   }
 
+  // Two-phase I/O, only aggregators_per_node ranks on each node write to the file and
+  // the other ranks send their data to them
+  if (aggregators_per_node > 0) {
+    MPI_Comm node_comm;
+    PARTHENON_MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                                            MPI_INFO_NULL, &node_comm));
+    int node_rank;
+    PARTHENON_MPI_CHECK(MPI_Comm_rank(node_comm, &node_rank));
+    PARTHENON_MPI_CHECK(MPI_Comm_free(&node_comm));
+    int num_nodes, is_first = (node_rank == 0);
+    PARTHENON_MPI_CHECK(
+        MPI_Allreduce(&is_first, &num_nodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD));
+    const auto cb_nodes = std::to_string(num_nodes * aggregators_per_node);
+    const auto cb_config_list = "*:" + std::to_string(aggregators_per_node);
+    PARTHENON_MPI_CHECK(MPI_Info_set(FILE_INFO_TEMPLATE, "romio_cb_write", "enable"));
+    PARTHENON_MPI_CHECK(MPI_Info_set(FILE_INFO_TEMPLATE, "cb_nodes", cb_nodes.c_str()));
+    PARTHENON_MPI_CHECK(
+        MPI_Info_set(FILE_INFO_TEMPLATE, "cb_config_list", cb_config_list.c_str()));
+  }
+
+  // Hints of the input, e.g., the striping_factor and striping_unit of new files on
+  // Lustre, which override those derived from aggregators_per_node
+  std::istringstream hints(tuning.mpi_io_hints);
+  for (std::string hint; std::getline(hints, hint, ',');) {
+    if (string_utils::trim(hint).empty()) continue;
+    const auto eq = hint.find('=');
+    PARTHENON_REQUIRE_THROWS(eq != std::string::npos,
+                             "MPI-IO hint '" + hint + "' is not of the form key=value");
+    const auto key = string_utils::trim(hint.substr(0, eq));
+    const auto value = string_utils::trim(hint.substr(eq + 1));
+    if (env_hints.count(key) == 0) {
+      PARTHENON_MPI_CHECK(MPI_Info_set(FILE_INFO_TEMPLATE, key.c_str(), value.c_str()));
+    }
+  }
+
+  if (subfiling) {
+#ifdef H5_HAVE_SUBFILING_VFD
+    PARTHENON_REQUIRE_THROWS(SubfilingSupported(),
+                             "Subfiling requires MPI_THREAD_MULTIPLE");
+    // the environment takes precedence, as for the HDF5 tuning parameters above
+    if (aggregators_per_node > 0) {
+      setenv(H5FD_SUBFILING_IOC_PER_NODE, std::to_string(aggregators_per_node).c_str(),
+             0);
+    }
+    PARTHENON_HDF5_CHECK(H5Pset_mpi_params(acc_file, MPI_COMM_WORLD, FILE_INFO_TEMPLATE));
+    // a default configuration, since none has been set on acc_file
+    H5FD_subfiling_config_t subfiling_config;
+    PARTHENON_HDF5_CHECK(H5Pget_fapl_subfiling(acc_file, &subfiling_config));
+    H5P ioc_fapl = H5P::FromHIDCheck(subfiling_config.ioc_fapl_id);
+    PARTHENON_HDF5_CHECK(H5Pset_fapl_subfiling(acc_file, &subfiling_config));
+    return acc_file;
+#else
+    PARTHENON_THROW("HDF5 was built without the subfiling VFD");
+#endif
+  }
+
   /* tell the HDF5 library that we want to use MPI-IO to do the writing */
   PARTHENON_HDF5_CHECK(H5Pset_fapl_mpio(acc_file, MPI_COMM_WORLD, FILE_INFO_TEMPLATE));
 #else
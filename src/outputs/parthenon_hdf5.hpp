@@ -28,6 +28,8 @@
 #include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -132,8 +134,33 @@ static H5T getHDF5Type(const char *const *) {
   return var_string_type;
 }
 
+// Tuning of the files of an output for a file system, which the corresponding
+// environment variables of the "Tuning HDF5 Performance" section of the documentation
+// override.  MPI-IO hints are given as comma separated key=value pairs, e.g.,
+// "striping_factor=16,striping_unit=4194304", and an alignment or meta_block_size of 0
+// keeps the HDF5 default.
+struct FileAccessTuning {
+  std::string mpi_io_hints;
+  hsize_t alignment = 0, alignment_threshold = 0, meta_block_size = 0;
+};
+
 //  Implemented in CPP file as it's complex
-hid_t GenerateFileAccessProps();
+//  With aggregators_per_node > 0, MPI-IO is asked to use two-phase I/O with that many
+//  ranks per node collecting the data of the others and writing it.  With subfiling,
+//  the file is written through the HDF5 subfiling VFD as one subfile per I/O
+//  concentrator (aggregators_per_node of them on each node, or the HDF5 default) that
+//  h5fuse can recombine into a single file, see SubfilingSupported.  With gpu_direct,
+//  the file is accessed through the HDF5 GDS VFD, which moves data in device memory
+//  directly to and from storage, see GPUDirectSupported.
+//  The tuning is applied on top, see FileAccessTuning.
+hid_t GenerateFileAccessProps(int aggregators_per_node = 0, bool subfiling = false,
+                              bool gpu_direct = false,
+                              const FileAccessTuning &tuning = FileAccessTuning());
+// whether HDF5 was built with the subfiling VFD and MPI provides MPI_THREAD_MULTIPLE,
+// which it requires
+bool SubfilingSupported();
+// whether Parthenon was built with the HDF5 GDS VFD, see PARTHENON_ENABLE_HDF5_GDS
+bool GPUDirectSupported();
 
 inline H5G MakeGroup(hid_t file, const std::string &name) {
   return H5G::FromHIDCheck(
@@ -339,6 +366,24 @@ void HDF5ReadAttribute(hid_t location, const std::string &name, std::vector<T> &
   vec = HDF5ReadAttributeVec<T>(location, name);
 }
 
+// Runs the remainder of writing an output file, i.e., a job that only touches HDF5
+// objects and host memory it owns, on a background thread (see the async_write output
+// option).  HDF5 is in general not thread safe, so at most one job is pending and
+// everything else calling into HDF5 must Wait for it first.  With MPI, this requires
+// MPI_THREAD_MULTIPLE since the job does collective writes, see Supported.
+class AsyncWriter {
+ public:
+  static void Launch(std::function<void()> job);
+  // run job in the background once the pending job, if any, is done
+  static void Then(std::function<void()> job);
+  // block until the pending job, if any, is done, rethrowing its exceptions
+  static void Wait();
+  static bool Supported();
+
+ private:
+  inline static std::future<void> pending_;
+};
+
 } // namespace HDF5
 } // namespace parthenon
 
@@ -3,7 +3,7 @@
 // Copyright(C) 2023 The Parthenon collaboration
 // Licensed under the 3-clause BSD License, see LICENSE file for details
 //========================================================================================
-// (C) (or copyright) 2020-2023. Triad National Security, LLC. All rights reserved.
+// (C) (or copyright) 2020-2024. Triad National Security, LLC. All rights reserved.
 //
 // This program was produced under U.S. Government contract 89233218CNA000001 for Los
 // Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
@@ -27,8 +27,12 @@
 #include <hdf5.h>
 
 // C++
+#include <cstdint>
 #include <iostream>
+#include <ostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 // Parthenon
 #include "basic_types.hpp"
@@ -51,13 +55,13 @@ static std::string stringXdmfArrayRef(const std::string &prefix,
                                       const std::string &label, const hsize_t *dims,
                                       const int &ndims, const std::string &theType,
                                       const int &precision);
-static void writeXdmfArrayRef(std::ofstream &fid, const std::string &prefix,
+static void writeXdmfArrayRef(std::ostream &fid, const std::string &prefix,
                               const std::string &hdfPath, const std::string &label,
                               const hsize_t *dims, const int &ndims,
                               const std::string &theType, const int &precision);
-static void writeXdmfSlabVariableRef(std::ofstream &fid, const std::string &name,
+static void writeXdmfSlabVariableRef(std::ostream &fid, const std::string &name,
                                      const std::vector<std::string> &component_labels,
-                                     std::string &hdfFile, int iblock,
+                                     const std::string &hdfFile, int iblock,
                                      const int &num_components, int &ndims, hsize_t *dims,
                                      const std::string &dims321, bool isVector);
 static std::string ParticleDatasetRef(const std::string &prefix,
@@ -69,10 +73,14 @@ static std::string ParticleDatasetRef(const std::string &prefix,
 static void ParticleVariableRef(std::ofstream &xdmf, const std::string &varname,
                                 const SwarmVarInfo &varinfo, const std::string &swmname,
                                 const std::string &hdffile, int particle_count);
+static void writeBlockGrids(std::ostream &xdmf, const std::string &hdfFile, int nblocks,
+                            int nx1, int nx2, int nx3,
+                            const std::vector<VarInfo> &var_list);
 } // namespace impl
 
-void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nx1, int nx2, int nx3,
-             const std::vector<VarInfo> &var_list, const AllSwarmInfo &all_swarm_info) {
+void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nblocks, int nx1, int nx2,
+             int nx3, const std::vector<VarInfo> &var_list,
+             const AllSwarmInfo &all_swarm_info, GridCache *cache) {
   using namespace HDF5;
   using namespace OutputUtils;
   using namespace impl;
@@ -85,7 +93,6 @@ void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nx1, int nx2, int n
   }
   std::string filename_aux = hdfFile + ".xdmf";
   std::ofstream xdmf;
-  hsize_t dims[H5_NDIM] = {0, 0, 0, 0, 0, 0, 0};
 
   // open file
   xdmf = std::ofstream(filename_aux.c_str(), std::ofstream::trunc);
@@ -103,6 +110,85 @@ void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nx1, int nx2, int n
     xdmf << R"(    <Time Value=")" << tm->time << R"("/>)" << std::endl;
   }
 
+  // The grids of the blocks, with the references to the HDF5 file in between the pieces
+  GridCache local_cache;
+  if (cache == nullptr) cache = &local_cache;
+  std::vector<std::int64_t> shape{nblocks, nx1, nx2, nx3};
+  std::vector<std::string> labels;
+  for (const auto &vinfo : var_list) {
+    shape.insert(shape.end(), {vinfo.nx6, vinfo.nx5, vinfo.nx4, vinfo.nx3, vinfo.nx2,
+                               vinfo.nx1, vinfo.tensor_rank, vinfo.is_vector,
+                               vinfo.where == MetadataFlag(Metadata::Cell)});
+    labels.push_back(vinfo.label);
+    labels.insert(labels.end(), vinfo.component_labels.begin(),
+                  vinfo.component_labels.end());
+  }
+  if (cache->pieces.empty() || cache->shape != shape || cache->labels != labels) {
+    // no file name can contain a null character
+    const std::string file_marker(1, '\0');
+    std::ostringstream grids;
+    writeBlockGrids(grids, file_marker, nblocks, nx1, nx2, nx3, var_list);
+    const std::string text = grids.str();
+    cache->pieces.clear();
+    std::size_t begin = 0;
+    for (std::size_t end = text.find(file_marker); end != std::string::npos;
+         end = text.find(file_marker, begin)) {
+      cache->pieces.push_back(text.substr(begin, end - begin));
+      begin = end + 1;
+    }
+    cache->pieces.push_back(text.substr(begin));
+    cache->shape = std::move(shape);
+    cache->labels = std::move(labels);
+  }
+  for (std::size_t n = 0; n < cache->pieces.size(); ++n) {
+    if (n > 0) xdmf << hdfFile;
+    xdmf << cache->pieces[n];
+  }
+
+  // Particles are defined as their own "mesh"
+#if PARTHENON_ENABLE_PARTICLE_XDMF
+  for (const auto &[swmname, swminfo] : all_swarm_info.all_info) {
+    xdmf << StringPrintf(
+        "    <Grid GridType=\"Uniform\" Name=\"%s\">\n"
+        "      <Topology TopologyType=\"Polyvertex\" Dimensions=\"%d\" "
+        "NodesPerElement=\"1\">\n"
+        "        <DataItem Format=\"HDF\" Dimensions=\"%d\" NumberType=\"Int\">\n"
+        "          %s:/%s/SwarmVars/id\n"
+        "        </DataItem>\n"
+        "      </Topology>\n"
+        "      <Geometry GeometryType=\"VXVYVZ\">\n",
+        swmname.c_str(), swminfo.global_count, swminfo.global_count, hdfFile.c_str(),
+        swmname.c_str());
+    xdmf << ParticleDatasetRef("        ", swmname, "x", hdfFile, "Float", "",
+                               swminfo.global_count);
+    xdmf << ParticleDatasetRef("        ", swmname, "y", hdfFile, "Float", "",
+                               swminfo.global_count);
+    xdmf << ParticleDatasetRef("        ", swmname, "z", hdfFile, "Float", "",
+                               swminfo.global_count);
+    xdmf << "      </Geometry>" << std::endl;
+    for (const auto &[varname, varinfo] : swminfo.var_info) {
+      if ((varname == "id") || (varname == "x") || (varname == "y") || (varname == "z")) {
+        continue; // We already did this one!
+      }
+      ParticleVariableRef(xdmf, varname, varinfo, swmname, hdfFile, swminfo.global_count);
+    }
+    xdmf << "    </Grid>" << std::endl;
+  }
+#endif
+
+  // Cleanup
+  xdmf << "    </Grid>" << std::endl;
+  xdmf << "  </Domain>" << std::endl;
+  xdmf << "</Xdmf>" << std::endl;
+  xdmf.close();
+}
+
+namespace impl {
+// The Grid of each block, referring to the arrays of hdfFile
+static void writeBlockGrids(std::ostream &xdmf, const std::string &hdfFile, int nblocks,
+                            int nx1, int nx2, int nx3,
+                            const std::vector<VarInfo> &var_list) {
+  hsize_t dims[H5_NDIM] = {0, 0, 0, 0, 0, 0, 0};
   std::string blockTopology =
       R"(      <Topology TopologyType="3DRectMesh" Dimensions=")" +
       std::to_string(nx3 + 1) + " " + std::to_string(nx2 + 1) + " " +
@@ -113,11 +199,11 @@ void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nx1, int nx2, int n
   const std::string slabTrailer = "</DataItem>";
 
   // Now write Grid for each block
-  dims[0] = pm->nbtotal;
+  dims[0] = nblocks;
   std::string dims321 =
       std::to_string(nx3) + " " + std::to_string(nx2) + " " + std::to_string(nx1);
 
-  for (int ib = 0; ib < pm->nbtotal; ib++) {
+  for (int ib = 0; ib < nblocks; ib++) {
     xdmf << "    <Grid GridType=\"Uniform\" Name=\"" << ib << "\">" << std::endl;
     xdmf << blockTopology;
     xdmf << R"(      <Geometry GeometryType="VXVYVZ">)" << std::endl;
@@ -173,45 +259,8 @@ void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nx1, int nx2, int n
     }
     xdmf << "    </Grid>" << std::endl;
   }
-  // Particles are defined as their own "mesh"
-#if PARTHENON_ENABLE_PARTICLE_XDMF
-  for (const auto &[swmname, swminfo] : all_swarm_info.all_info) {
-    xdmf << StringPrintf(
-        "    <Grid GridType=\"Uniform\" Name=\"%s\">\n"
-        "      <Topology TopologyType=\"Polyvertex\" Dimensions=\"%d\" "
-        "NodesPerElement=\"1\">\n"
-        "        <DataItem Format=\"HDF\" Dimensions=\"%d\" NumberType=\"Int\">\n"
-        "          %s:/%s/SwarmVars/id\n"
-        "        </DataItem>\n"
-        "      </Topology>\n"
-        "      <Geometry GeometryType=\"VXVYVZ\">\n",
-        swmname.c_str(), swminfo.global_count, swminfo.global_count, hdfFile.c_str(),
-        swmname.c_str());
-    xdmf << ParticleDatasetRef("        ", swmname, "x", hdfFile, "Float", "",
-                               swminfo.global_count);
-    xdmf << ParticleDatasetRef("        ", swmname, "y", hdfFile, "Float", "",
-                               swminfo.global_count);
-    xdmf << ParticleDatasetRef("        ", swmname, "z", hdfFile, "Float", "",
-                               swminfo.global_count);
-    xdmf << "      </Geometry>" << std::endl;
-    for (const auto &[varname, varinfo] : swminfo.var_info) {
-      if ((varname == "id") || (varname == "x") || (varname == "y") || (varname == "z")) {
-        continue; // We already did this one!
-      }
-      ParticleVariableRef(xdmf, varname, varinfo, swmname, hdfFile, swminfo.global_count);
-    }
-    xdmf << "    </Grid>" << std::endl;
-  }
-#endif
-
-  // Cleanup
-  xdmf << "    </Grid>" << std::endl;
-  xdmf << "  </Domain>" << std::endl;
-  xdmf << "</Xdmf>" << std::endl;
-  xdmf.close();
 }
 
-namespace impl {
 // XDMF subroutine to write a dataitem that refers to an HDF array
 static std::string stringXdmfArrayRef(const std::string &prefix,
                                       const std::string &hdfPath,
@@ -229,7 +278,7 @@ static std::string stringXdmfArrayRef(const std::string &prefix,
   return mystr;
 }
 
-static void writeXdmfArrayRef(std::ofstream &fid, const std::string &prefix,
+static void writeXdmfArrayRef(std::ostream &fid, const std::string &prefix,
                               const std::string &hdfPath, const std::string &label,
                               const hsize_t *dims, const int &ndims,
                               const std::string &theType, const int &precision) {
@@ -237,9 +286,9 @@ static void writeXdmfArrayRef(std::ofstream &fid, const std::string &prefix,
       << std::flush;
 }
 
-static void writeXdmfSlabVariableRef(std::ofstream &fid, const std::string &name,
+static void writeXdmfSlabVariableRef(std::ostream &fid, const std::string &name,
                                      const std::vector<std::string> &component_labels,
-                                     std::string &hdfFile, int iblock,
+                                     const std::string &hdfFile, int iblock,
                                      const int &num_components, int &ndims, hsize_t *dims,
                                      const std::string &dims321, bool isVector) {
   // writes a slab reference to file
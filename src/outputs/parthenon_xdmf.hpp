@@ -19,6 +19,7 @@
 #define OUTPUTS_PARTHENON_XDMF_HPP_
 
 // C++ includes
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -28,9 +29,20 @@
 namespace parthenon {
 // forward declarations
 namespace XDMF {
-void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nx1, int nx2, int nx3,
-             const std::vector<OutputUtils::VarInfo> &var_list,
-             const OutputUtils::AllSwarmInfo &all_swarm_info);
+// The grids of the blocks only depend on the number and size of the blocks and on the
+// variables that are written, apart from the name of the HDF5 file they refer to.  They
+// are kept as the pieces of text between the references to the file, and only
+// regenerated by genXDMF when the blocks or variables change.
+struct GridCache {
+  std::vector<std::int64_t> shape;
+  std::vector<std::string> labels;
+  std::vector<std::string> pieces;
+};
+
+void genXDMF(std::string hdfFile, Mesh *pm, SimTime *tm, int nblocks, int nx1, int nx2,
+             int nx3, const std::vector<OutputUtils::VarInfo> &var_list,
+             const OutputUtils::AllSwarmInfo &all_swarm_info,
+             GridCache *cache = nullptr);
 } // namespace XDMF
 } // namespace parthenon
 
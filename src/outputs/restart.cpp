@@ -69,6 +69,32 @@ int RestartReader::GetOutputFormatVersion() const {
 #endif // ENABLE_HDF5
 }
 
+void RestartReader::EnableGPUDirect() {
+#ifndef ENABLE_HDF5
+  PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
+#else  // HDF5 enabled
+  // HDF5 shares the handles of a file that is already open, including its VFD, so the
+  // file has to be closed first
+  block_datasets_.clear();
+  params_group_.Reset();
+  fh_.Reset();
+  const H5P acc_file = H5P::FromHIDCheck(HDF5::GenerateFileAccessProps(0, false, true));
+  fh_ = H5F::FromHIDCheck(H5Fopen(filename_.c_str(), H5F_ACC_RDONLY, acc_file));
+  params_group_ = H5G::FromHIDCheck(H5Oopen(fh_, "Params", H5P_DEFAULT));
+#endif // ENABLE_HDF5
+}
+
+bool RestartReader::IsContiguous(const std::string &name) const {
+#ifndef ENABLE_HDF5
+  PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
+#else  // HDF5 enabled
+  if (PARTHENON_HDF5_CHECK(H5Lexists(fh_, name.c_str(), H5P_DEFAULT)) <= 0) return false;
+  const H5D dataset = H5D::FromHIDCheck(H5Dopen2(fh_, name.c_str(), H5P_DEFAULT));
+  const H5P dcpl = H5P::FromHIDCheck(H5Dget_create_plist(dataset));
+  return H5Pget_layout(dcpl) == H5D_CONTIGUOUS;
+#endif // ENABLE_HDF5
+}
+
 RestartReader::SparseInfo RestartReader::GetSparseInfo() const {
 #ifndef ENABLE_HDF5
   PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
@@ -141,6 +167,66 @@ std::size_t RestartReader::GetSwarmCounts(const std::string &swarm,
 #endif // ENABLE_HDF5
 }
 
+#ifdef ENABLE_HDF5
+const std::vector<LogicalLocation> &RestartReader::BlockLocations_() const {
+  if (block_locs_.empty()) {
+    const auto levels = ReadDataset<std::int64_t>("Levels");
+    const auto lx123 = ReadDataset<std::int64_t>("LogicalLocations");
+    PARTHENON_REQUIRE_THROWS(lx123.size() == 3 * levels.size(),
+                             "Mismatch between Levels and LogicalLocations in " +
+                                 filename_);
+    block_locs_.reserve(levels.size());
+    for (std::size_t b = 0; b < levels.size(); ++b) {
+      block_locs_.emplace_back(levels[b], lx123[3 * b], lx123[3 * b + 1],
+                               lx123[3 * b + 2]);
+      block_index_[block_locs_.back()] = b;
+    }
+  }
+  return block_locs_;
+}
+#endif // ENABLE_HDF5
+
+int RestartReader::FindBlock(const LogicalLocation &loc) const {
+#ifndef ENABLE_HDF5
+  PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
+  return -1;
+#else  // HDF5 enabled
+  BlockLocations_();
+  const auto it = block_index_.find(loc);
+  return it == block_index_.end() ? -1 : it->second;
+#endif // ENABLE_HDF5
+}
+
+std::vector<int>
+RestartReader::FindBlocksInRegion(int level, const std::array<std::int64_t, 3> &lmin,
+                                  const std::array<std::int64_t, 3> &lmax) const {
+#ifndef ENABLE_HDF5
+  PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
+  return {};
+#else  // HDF5 enabled
+  std::vector<int> blocks;
+  const auto &locs = BlockLocations_();
+  for (int b = 0; b < static_cast<int>(locs.size()); ++b) {
+    const auto &loc = locs[b];
+    bool overlaps = true;
+    for (int d = 0; d < 3; ++d) {
+      // extent of the block in logical locations on level
+      std::int64_t s, e;
+      if (loc.level() <= level) {
+        const int shift = level - loc.level();
+        s = loc.l(d) << shift;
+        e = ((loc.l(d) + 1) << shift) - 1;
+      } else {
+        s = e = loc.l(d) >> (loc.level() - level);
+      }
+      overlaps = overlaps && s <= lmax[d] && e >= lmin[d];
+    }
+    if (overlaps) blocks.push_back(b);
+  }
+  return blocks;
+#endif // ENABLE_HDF5
+}
+
 void RestartReader::ReadParams(const std::string &name, Params &p) {
 #ifdef ENABLE_HDF5
   p.ReadFromRestart(name, params_group_);
@@ -19,9 +19,13 @@
 //! \file io_wrapper.hpp
 //  \brief defines a set of small wrapper functions for MPI versus Serial Output.
 
+#include <algorithm>
+#include <array>
 #include <cinttypes>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -47,6 +51,7 @@ using H5S = UnusedPlaceholder;
 #endif
 
 #include "mesh/domain.hpp"
+#include "mesh/logical_location.hpp"
 #include "utils/error_checking.hpp"
 
 namespace parthenon {
@@ -88,6 +93,13 @@ class RestartReader {
   // Return output format version number. Return -1 if not existent.
   int GetOutputFormatVersion() const;
 
+  // Reopens the file through the HDF5 GDS VFD, so that ReadBlocks can read contiguous
+  // datasets (see IsContiguous) straight into device memory
+  void EnableGPUDirect();
+
+  // Whether dataset name is stored contiguously, i.e., without chunks and filters
+  bool IsContiguous(const std::string &name) const;
+
  private:
   struct DatasetHandle {
     hid_t type;
@@ -99,21 +111,43 @@ class RestartReader {
   };
 
   // internal convenience function to open a dataset, perform some checks, and get
-  // dimensions
+  // dimensions, dapl is the dataset access property list (0 is H5P_DEFAULT)
   template <typename T>
-  DatasetHandle OpenDataset(const std::string &name) const {
+  DatasetHandle OpenDataset(const std::string &name, hid_t dapl = 0) const {
 #ifndef ENABLE_HDF5
     PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
 #else  // HDF5 enabled
     DatasetHandle handle;
 
+    // Variables of incremental restart files may be external links to the restart file
+    // they were last written to (see the incremental restart output option), which
+    // HDF5 follows transparently as long as that file is still around
+    H5L_info_t link_info;
+    if (H5Lexists(fh_, name.c_str(), H5P_DEFAULT) > 0 &&
+        H5Lget_info(fh_, name.c_str(), &link_info, H5P_DEFAULT) >= 0 &&
+        link_info.type == H5L_TYPE_EXTERNAL) {
+      std::vector<char> link_val(link_info.u.val_size);
+      PARTHENON_HDF5_CHECK(H5Lget_val(fh_, name.c_str(), link_val.data(),
+                                      link_val.size(), H5P_DEFAULT));
+      const char *target_file = nullptr, *target_obj = nullptr;
+      PARTHENON_HDF5_CHECK(H5Lunpack_elink_val(link_val.data(), link_val.size(), nullptr,
+                                               &target_file, &target_obj));
+      htri_t target_exists;
+      H5E_BEGIN_TRY { target_exists = H5Oexists_by_name(fh_, name.c_str(), H5P_DEFAULT); }
+      H5E_END_TRY;
+      PARTHENON_REQUIRE_THROWS(target_exists > 0,
+                               "Dataset '" + name + "' of incremental restart file " +
+                                   filename_ + " links to restart file " +
+                                   std::string(target_file) + ", which can't be read");
+    }
+
     // make sure dataset exists
     auto status = PARTHENON_HDF5_CHECK(H5Oexists_by_name(fh_, name.c_str(), H5P_DEFAULT));
     PARTHENON_REQUIRE_THROWS(
         status > 0, "Dataset '" + name + "' does not exist in HDF5 file " + filename_);
 
     // open dataset
-    handle.dataset = H5D::FromHIDCheck(H5Dopen2(fh_, name.c_str(), H5P_DEFAULT));
+    handle.dataset = H5D::FromHIDCheck(H5Dopen2(fh_, name.c_str(), dapl));
     handle.dataspace = H5S::FromHIDCheck(H5Dget_space(handle.dataset));
 
     // get the HDF5 type from the template parameter and make sure it matches the dataset
@@ -147,6 +181,15 @@ class RestartReader {
   void ReadBlocks(const std::string &name, IndexRange range, std::vector<T> &dataVec,
                   const std::vector<size_t> &bsize, int file_output_format_version,
                   MetadataFlag where, const std::vector<int> &shape = {}) const {
+    ReadBlocks(name, range, dataVec.data(), dataVec.size(), bsize,
+               file_output_format_version, where, shape);
+  }
+
+  // Same as above, but reading into the buffer data of size elements
+  template <typename T>
+  void ReadBlocks(const std::string &name, IndexRange range, T *data, std::size_t size,
+                  const std::vector<size_t> &bsize, int file_output_format_version,
+                  MetadataFlag where, const std::vector<int> &shape = {}) const {
 #ifndef ENABLE_HDF5
     PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
 #else  // HDF5 enabled
@@ -211,8 +254,8 @@ class RestartReader {
       total_count *= count[i];
     }
 
-    PARTHENON_REQUIRE_THROWS(dataVec.size() >= total_count,
-                             "Buffer (size " + std::to_string(dataVec.size()) +
+    PARTHENON_REQUIRE_THROWS(size >= total_count,
+                             "Buffer (size " + std::to_string(size) +
                                  ") is too small for dataset " + name + " (size " +
                                  std::to_string(total_count) + ")");
     PARTHENON_HDF5_CHECK(
@@ -224,7 +267,7 @@ class RestartReader {
 
     // Read data from file
     PARTHENON_HDF5_CHECK(H5Dread(hdl.dataset, hdl.type, memspace, hdl.dataspace,
-                                 H5P_DEFAULT, dataVec.data()));
+                                 H5P_DEFAULT, data));
 #endif // ENABLE_HDF5
   }
 
@@ -287,6 +330,71 @@ class RestartReader {
 #endif // ENABLE_HDF5
   }
 
+  // Block-indexed access to the datasets of an output, which only reads what is asked
+  // for.  Blocks are identified by their index along the first dimension of the block
+  // datasets, i.e., by their position in the Levels and LogicalLocations datasets.
+  // Levels are those stored in the file, i.e., relative to the root grid.
+
+  // Index of the block at loc, -1 if the file contains no such block
+  int FindBlock(const LogicalLocation &loc) const;
+
+  // Indices, in ascending order, of all blocks overlapping the region spanned by the
+  // logical locations lmin to lmax (inclusive) on level
+  std::vector<int> FindBlocksInRegion(int level, const std::array<std::int64_t, 3> &lmin,
+                                      const std::array<std::int64_t, 3> &lmax) const;
+
+  // Size of the chunk cache of the datasets read by ReadSelectedBlocks, which stay open
+  // until the reader is destroyed, so repeated reads of a dataset don't go back to the
+  // file (or decompress again) as long as its chunks fit.  Only applies to datasets
+  // that are not open yet.
+  void SetChunkCacheSize(std::size_t nbytes) { chunk_cache_bytes_ = nbytes; }
+
+  // Reads the data of the given blocks of dataset name as a 1D vector, in which the
+  // data of the blocks follow each other in ascending index order
+  template <typename T>
+  std::vector<T> ReadSelectedBlocks(const std::string &name,
+                                    std::vector<int> blocks) const {
+#ifndef ENABLE_HDF5
+    PARTHENON_FAIL("Restart functionality is not available because HDF5 is disabled");
+#else  // HDF5 enabled
+    auto &hdl = BlockDataset_<T>(name);
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+    if (blocks.empty()) return std::vector<T>();
+    PARTHENON_REQUIRE_THROWS(blocks.front() >= 0 &&
+                                 static_cast<hsize_t>(blocks.back()) < hdl.dims[0],
+                             "Invalid block index for dataset " + name);
+
+    // select runs of consecutive blocks at a time
+    std::vector<hsize_t> offset(hdl.rank, 0), count(hdl.dims);
+    PARTHENON_HDF5_CHECK(H5Sselect_none(hdl.dataspace));
+    for (std::size_t b = 0; b < blocks.size();) {
+      std::size_t e = b + 1;
+      while (e < blocks.size() && blocks[e] == blocks[e - 1] + 1) {
+        ++e;
+      }
+      offset[0] = blocks[b];
+      count[0] = e - b;
+      PARTHENON_HDF5_CHECK(H5Sselect_hyperslab(hdl.dataspace, H5S_SELECT_OR,
+                                               offset.data(), NULL, count.data(), NULL));
+      b = e;
+    }
+
+    const hsize_t nvals = blocks.size() * (hdl.count / hdl.dims[0]);
+    std::vector<T> data(nvals);
+    const H5S memspace = H5S::FromHIDCheck(H5Screate_simple(1, &nvals, NULL));
+    PARTHENON_HDF5_CHECK(H5Dread(hdl.dataset, hdl.type, memspace, hdl.dataspace,
+                                 H5P_DEFAULT, static_cast<void *>(data.data())));
+    return data;
+#endif // ENABLE_HDF5
+  }
+
+  // Reads the data of a single block of dataset name
+  template <typename T>
+  std::vector<T> ReadBlock(const std::string &name, int block) const {
+    return ReadSelectedBlocks<T>(name, std::vector<int>{block});
+  }
+
   template <typename T>
   std::vector<T> GetAttrVec(const std::string &location, const std::string &name) const {
 #ifndef ENABLE_HDF5
@@ -338,7 +446,32 @@ class RestartReader {
   // when that changes, this will be revisited
   H5F fh_;
   H5G params_group_;
+
+  // the dataset name, kept open for block-indexed reads
+  template <typename T>
+  DatasetHandle &BlockDataset_(const std::string &name) const {
+    auto it = block_datasets_.find(name);
+    if (it == block_datasets_.end()) {
+      const H5P dapl = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_ACCESS));
+      PARTHENON_HDF5_CHECK(H5Pset_chunk_cache(dapl, H5D_CHUNK_CACHE_NSLOTS_DEFAULT,
+                                              chunk_cache_bytes_,
+                                              H5D_CHUNK_CACHE_W0_DEFAULT));
+      it = block_datasets_.emplace(name, OpenDataset<T>(name, dapl)).first;
+    }
+    PARTHENON_REQUIRE_THROWS(it->second.rank > 0,
+                             "Dataset " + name + " has no block dimension");
+    return it->second;
+  }
+
+  // LogicalLocations of the blocks in the file, read on first use
+  const std::vector<LogicalLocation> &BlockLocations_() const;
+
+  mutable std::unordered_map<std::string, DatasetHandle> block_datasets_;
+  mutable std::vector<LogicalLocation> block_locs_;
+  mutable std::unordered_map<LogicalLocation, int> block_index_;
 #endif // ENABLE_HDF5
+  // 64 MiB by default, i.e., a few blocks of typical size
+  std::size_t chunk_cache_bytes_ = 64 * 1024 * 1024;
 };
 
 } // namespace parthenon
@@ -3,7 +3,7 @@
 // Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
 // Licensed under the 3-clause BSD License, see LICENSE file for details
 //========================================================================================
-// (C) (or copyright) 2020-2021. Triad National Security, LLC. All rights reserved.
+// (C) (or copyright) 2020-2024. Triad National Security, LLC. All rights reserved.
 //
 // This program was produced under U.S. Government contract 89233218CNA000001 for Los
 // Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
@@ -15,11 +15,12 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 //! \file vtk.cpp
-//  \brief writes output data in (legacy) vtk format.
-//  Data is written in RECTILINEAR_GRID geometry, in BINARY format, and in FLOAT type
-//  Writes one file per MeshBlock.
+//  \brief writes output data in (parallel) VTK XML format.
+//  Every rank writes its MeshBlocks as a single UnstructuredGrid piece (.vtu) in binary
+//  format with the data appended raw, and rank 0 writes the .pvtu file combining them.
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
@@ -27,20 +28,24 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "coordinates/coordinates.hpp"
 #include "defs.hpp"
+#include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "mesh/meshblock.hpp"
+#include "outputs/output_utils.hpp"
 #include "outputs/outputs.hpp"
 #include "parthenon_arrays.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/instrument.hpp"
 
 namespace parthenon {
 
 //----------------------------------------------------------------------------------------
-// Functions to detect big endian machine, and to byte-swap 32-bit words.  The vtk
-// legacy format requires data to be stored as big-endian.
+// Function to detect big endian machine.  Data is written in the native byte order,
+// which is recorded in the byte_order attribute of the files.
 
 int IsBigEndian() {
   std::int32_t n = 1;
@@ -50,191 +55,325 @@ int IsBigEndian() {
   return (*ep == 0); // Returns 1 (true) on a big endian machine
 }
 
-// namespace {
-// inline void Swap4Bytes(void *vdat) {
-//   char tmp, *dat = static_cast<char *>(vdat);
-//   tmp = dat[0];
-//   dat[0] = dat[3];
-//   dat[3] = tmp;
-//   tmp = dat[1];
-//   dat[1] = dat[2];
-//   dat[2] = tmp;
-// }
-// } // namespace
+namespace {
+// VTK cell types of the cells of 1D, 2D and 3D meshes, the corners of which are ordered
+// with i varying fastest, then j, then k
+constexpr std::uint8_t vtk_cell_type[3] = {3 /* line */, 8 /* pixel */, 11 /* voxel */};
+
+// An array of the appended data section, which holds the raw bytes of all arrays in the
+// order they are declared, each preceded by its size as UInt64
+struct AppendedArray {
+  std::string type;
+  std::string name;
+  int ncomponents;
+  std::uint64_t nbytes;
+};
+
+void WriteDataArray(std::ostream &os, const AppendedArray &array,
+                    const std::uint64_t offset) {
+  os << "<DataArray type=\"" << array.type << "\"";
+  if (!array.name.empty()) os << " Name=\"" << array.name << "\"";
+  if (array.ncomponents > 1) os << " NumberOfComponents=\"" << array.ncomponents << "\"";
+  os << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+}
+
+void WritePDataArray(std::ostream &os, const AppendedArray &array) {
+  os << "<PDataArray type=\"" << array.type << "\"";
+  if (!array.name.empty()) os << " Name=\"" << array.name << "\"";
+  if (array.ncomponents > 1) os << " NumberOfComponents=\"" << array.ncomponents << "\"";
+  os << "/>\n";
+}
+
+std::FILE *OpenOrFail(const std::string &fname) {
+  std::FILE *pfile = std::fopen(fname.c_str(), "wb");
+  if (pfile == nullptr) {
+    std::stringstream msg;
+    msg << "### FATAL ERROR in function [VTKOutput::WriteOutputFile]" << std::endl
+        << "Output file '" << fname << "' could not be opened" << std::endl;
+    PARTHENON_FAIL(msg);
+  }
+  return pfile;
+}
+} // namespace
 
 //----------------------------------------------------------------------------------------
 //! \fn void VTKOutput:::WriteOutputFile(Mesh *pm)
-//  \brief Cycles over all MeshBlocks and writes OutputData in (legacy) vtk format, one
-//         MeshBlock per file
-
-void VTKOutput::WriteContainer(SimTime &tm, Mesh *pm, ParameterInput *pin, bool flag) {
-  throw std::runtime_error(std::string(__func__) + " is not implemented");
-  /*
-  int big_end = IsBigEndian(); // =1 on big endian machine
-
-  // Loop over MeshBlocks
-  for (auto &pmb : pm->block_list) {
-    // set start/end array indices depending on whether ghost zones are included
-    IndexDomain domain = IndexDomain::interior;
-    if (output_params.include_ghost_zones) {
-      domain = IndexDomain::entire;
+//  \brief Writes the cell variables of all MeshBlocks of this rank into one .vtu file,
+//         and the .pvtu file referencing the files of all ranks on rank 0
+
+void VTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
+                                const SignalHandler::OutputSignal signal) {
+  PARTHENON_INSTRUMENT
+  using namespace OutputUtils;
+  using OutT = float;
+
+  const BlockList_t &blocks = pm->block_list;
+  const int num_blocks_local = blocks.size();
+  const int ndim = pm->ndim;
+  const bool do_ghosts = output_params.include_ghost_zones;
+  const IndexDomain domain = do_ghosts ? IndexDomain::entire : IndexDomain::interior;
+  auto &first_block = pm->block_list.front();
+  const IndexRange ib = first_block->cellbounds.GetBoundsI(domain);
+  const IndexRange jb = first_block->cellbounds.GetBoundsJ(domain);
+  const IndexRange kb = first_block->cellbounds.GetBoundsK(domain);
+  const int ni = ib.e - ib.s + 1;
+  const int nj = jb.e - jb.s + 1;
+  const int nk = kb.e - kb.s + 1;
+  // points are the corners of the cells in the dimensions of the mesh
+  const int pi = ni + 1;
+  const int pj = nj + (ndim > 1);
+  const int pk = nk + (ndim > 2);
+  const int ncorners = 1 << ndim;
+  const std::uint64_t ncells_block = static_cast<std::uint64_t>(nk) * nj * ni;
+  const std::uint64_t npoints_block = static_cast<std::uint64_t>(pk) * pj * pi;
+  const std::uint64_t ncells = ncells_block * num_blocks_local;
+  const std::uint64_t npoints = npoints_block * num_blocks_local;
+
+  // cell variables to write, the list is the same for all blocks
+  std::vector<VarInfo> vars_info;
+  for (auto &v : GetAnyVariables(first_block->meshblock_data.Get()->GetVariableVector(),
+                                 output_params.variables)) {
+    if (v->IsSet(Metadata::Cell)) vars_info.emplace_back(v);
+  }
+  std::sort(vars_info.begin(), vars_info.end(),
+            [](const VarInfo &a, const VarInfo &b) { return a.label < b.label; });
+
+  // the arrays in the order their data is appended
+  std::vector<AppendedArray> arrays;
+  arrays.push_back({"Float32", "", 3, 3 * npoints * sizeof(OutT)});
+  arrays.push_back(
+      {"Int64", "connectivity", 1, ncorners * ncells * sizeof(std::int64_t)});
+  arrays.push_back({"Int64", "offsets", 1, ncells * sizeof(std::int64_t)});
+  arrays.push_back({"UInt8", "types", 1, ncells * sizeof(std::uint8_t)});
+  const std::size_t first_cell_array = arrays.size();
+  arrays.push_back({"Int32", "gid", 1, ncells * sizeof(std::int32_t)});
+  arrays.push_back({"Int32", "level", 1, ncells * sizeof(std::int32_t)});
+  for (auto &vinfo : vars_info) {
+    for (auto &label : vinfo.component_labels) {
+      arrays.push_back({"Float32", label, 1, ncells * sizeof(OutT)});
     }
-    // build doubly linked list of OutputData nodes (setting data ptrs to appropriate
-    // quantity on MeshBlock for each node), then slice/sum as needed
-    // create filename: "file_basename"+ "."+"blockid"+"."+"file_id"+"."+XXXXX+".vtk",
-    // where XXXXX = 5-digit file_number
-    std::string fname;
-    char number[6];
-    std::snprintf(number, sizeof(number), "%05d", output_params.file_number);
-    char blockid[12];
-    std::snprintf(blockid, sizeof(blockid), "block%d", pmb->gid);
-
-    fname.assign(output_params.file_basename);
-    fname.append(".N.");
-    fname.append(blockid);
-    fname.append(".");
-    fname.append(output_params.file_id);
-    fname.append(".");
-    fname.append(number);
-    fname.append(".vtk");
-
-    // open file for output
-    FILE *pfile;
-    std::stringstream msg;
-    if ((pfile = std::fopen(fname.c_str(), "w")) == nullptr) {
-      msg << "### FATAL ERROR in function [VTKOutput::WriteOutputFile]" << std::endl
-          << "Output file '" << fname << "' could not be opened" << std::endl;
-      PARTHENON_FAIL(msg);
+  }
+
+  const std::string basename = GenerateBasename_(signal);
+  const std::string byte_order = IsBigEndian() ? "BigEndian" : "LittleEndian";
+  std::stringstream piece_name;
+  piece_name << basename << ".r" << std::setw(6) << std::setfill('0') << Globals::my_rank
+             << ".vtu";
+
+  // time and cycle as field data, which ParaView and VisIt pick up
+  std::stringstream field_data;
+  field_data << std::setprecision(17) << "<FieldData>\n"
+             << "<DataArray type=\"Float64\" Name=\"TIME\" NumberOfTuples=\"1\" "
+             << "format=\"ascii\">" << (tm != nullptr ? tm->time : 0.0)
+             << "</DataArray>\n"
+             << "<DataArray type=\"Int32\" Name=\"CYCLE\" NumberOfTuples=\"1\" "
+             << "format=\"ascii\">" << (tm != nullptr ? tm->ncycle : 0)
+             << "</DataArray>\n"
+             << "</FieldData>\n";
+
+  {
+    std::stringstream xml;
+    xml << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\""
+        << byte_order << "\" header_type=\"UInt64\">\n"
+        << "<UnstructuredGrid>\n"
+        << field_data.str() << "<Piece NumberOfPoints=\"" << npoints
+        << "\" NumberOfCells=\"" << ncells << "\">\n";
+    std::uint64_t offset = 0;
+    for (std::size_t a = 0; a < arrays.size(); ++a) {
+      if (a == 0) xml << "<Points>\n";
+      if (a == 1) xml << "</Points>\n<Cells>\n";
+      if (a == first_cell_array) xml << "</Cells>\n<CellData>\n";
+      WriteDataArray(xml, arrays[a], offset);
+      offset += sizeof(std::uint64_t) + arrays[a].nbytes;
     }
+    xml << "</CellData>\n</Piece>\n</UnstructuredGrid>\n"
+        << "<AppendedData encoding=\"raw\">\n_";
+
+    std::FILE *pfile = OpenOrFail(piece_name.str());
+    const std::string header = xml.str();
+    std::fwrite(header.data(), 1, header.size(), pfile);
+    std::size_t next_array = 0;
+    auto begin_array = [&]() {
+      std::fwrite(&arrays[next_array++].nbytes, sizeof(std::uint64_t), 1, pfile);
+    };
 
-    // There are five basic parts to the VTK "legacy" file format.
-    //  1. Write file version and identifier
-    std::fprintf(pfile, "# vtk DataFile Version 2.0\n");
-
-    //  2. Header
-    std::fprintf(pfile, "# Athena++ data at time=%e", tm.time);
-    std::fprintf(pfile, "  cycle=%d", tm.ncycle);
-    std::fprintf(pfile, "  variables=%s \n", output_params.variable.c_str());
-
-    //  3. File format
-    std::fprintf(pfile, "BINARY\n");
-
-    //  4. Dataset structure
-    int ncells1 = pmb->cellbounds.ncellsi(domain);
-    int ncells2 = pmb->cellbounds.ncellsj(domain);
-    int ncells3 = pmb->cellbounds.ncellsk(domain);
-    int ncoord1 = ncells1;
-    if (ncells1 > 1) ncoord1++;
-    int ncoord2 = ncells2;
-    if (ncells2 > 1) ncoord2++;
-    int ncoord3 = ncells3;
-    if (ncells3 > 1) ncoord3++;
-
-    float *data;
-    int ndata = std::max(ncoord1, ncoord2);
-    ndata = std::max(ndata, ncoord3);
-    data = new float[3 * ndata + 1];
-
-    // Specify the type of data, dimensions, and coordinates.  If N>1, then write N+1
-    // cell faces as binary floats.  If N=1, then write 1 cell center position.
-    std::fprintf(pfile, "DATASET RECTILINEAR_GRID\n");
-    std::fprintf(pfile, "DIMENSIONS %d %d %d\n", ncoord1, ncoord2, ncoord3);
-
-    IndexRange out_ib = pmb->cellbounds.GetBoundsI(domain);
-    IndexRange out_jb = pmb->cellbounds.GetBoundsJ(domain);
-    IndexRange out_kb = pmb->cellbounds.GetBoundsK(domain);
-    // write x1-coordinates as binary float in big endian order
-    std::fprintf(pfile, "X_COORDINATES %d float\n", ncoord1);
-    if (ncells1 == 1) {
-      data[0] = static_cast<float>(pmb->coords.Xc<1>(out_ib.s));
-    } else {
-      for (int i = out_ib.s; i <= out_ib.e + 1; ++i) {
-        data[i - out_ib.s] = static_cast<float>(pmb->coords.Xf<1>(i));
+    // points, all corners of the cells of each block
+    begin_array();
+    std::vector<Real> x, y, z;
+    ComputeCoords(blocks, true, ib, jb, kb, x, y, z);
+    std::vector<OutT> points(3 * npoints_block);
+    for (int b = 0; b < num_blocks_local; ++b) {
+      auto &coords = blocks[b]->coords;
+      // in the dimensions the mesh doesn't have, the points are at the cell centers
+      const OutT yc = coords.Xc<X2DIR>(jb.s);
+      const OutT zc = coords.Xc<X3DIR>(kb.s);
+      std::size_t n = 0;
+      for (int k = 0; k < pk; ++k) {
+        for (int j = 0; j < pj; ++j) {
+          for (int i = 0; i < pi; ++i) {
+            points[n++] = x[b * (ni + 1) + i];
+            points[n++] = (ndim > 1) ? static_cast<OutT>(y[b * (nj + 1) + j]) : yc;
+            points[n++] = (ndim > 2) ? static_cast<OutT>(z[b * (nk + 1) + k]) : zc;
+          }
+        }
       }
+      std::fwrite(points.data(), sizeof(OutT), points.size(), pfile);
     }
-    if (!big_end) {
-      for (int i = 0; i < ncoord1; ++i)
-        Swap4Bytes(&data[i]);
+
+    // connectivity, the same for all blocks up to the index of their first point
+    begin_array();
+    std::vector<std::int64_t> corners(ncorners * ncells_block);
+    for (int b = 0; b < num_blocks_local; ++b) {
+      const std::int64_t first_point = b * npoints_block;
+      std::size_t n = 0;
+      for (int k = 0; k < nk; ++k) {
+        for (int j = 0; j < nj; ++j) {
+          for (int i = 0; i < ni; ++i) {
+            for (int m = 0; m < ncorners; ++m) {
+              const int di = m & 1, dj = (m >> 1) & 1, dk = (m >> 2) & 1;
+              corners[n++] = first_point + ((k + dk) * pj + j + dj) * pi + i + di;
+            }
+          }
+        }
+      }
+      std::fwrite(corners.data(), sizeof(std::int64_t), corners.size(), pfile);
     }
-    std::fwrite(data, sizeof(float), static_cast<std::size_t>(ncoord1), pfile);
-
-    // write x2-coordinates as binary float in big endian order
-    std::fprintf(pfile, "\nY_COORDINATES %d float\n", ncoord2);
-    if (ncells2 == 1) {
-      data[0] = static_cast<float>(pmb->coords.Xc<2>(out_jb.s));
-    } else {
-      for (int j = out_jb.s; j <= out_jb.e + 1; ++j) {
-        data[j - out_jb.s] = static_cast<float>(pmb->coords.Xf<2>(j));
+
+    // offsets, the end of the corners of each cell in connectivity
+    begin_array();
+    std::vector<std::int64_t> offsets(ncells_block);
+    for (int b = 0; b < num_blocks_local; ++b) {
+      for (std::uint64_t c = 0; c < ncells_block; ++c) {
+        offsets[c] = (b * ncells_block + c + 1) * ncorners;
       }
+      std::fwrite(offsets.data(), sizeof(std::int64_t), offsets.size(), pfile);
     }
-    if (!big_end) {
-      for (int i = 0; i < ncoord2; ++i)
-        Swap4Bytes(&data[i]);
+
+    // types
+    begin_array();
+    const std::vector<std::uint8_t> types(ncells_block, vtk_cell_type[ndim - 1]);
+    for (int b = 0; b < num_blocks_local; ++b) {
+      std::fwrite(types.data(), sizeof(std::uint8_t), types.size(), pfile);
     }
-    std::fwrite(data, sizeof(float), static_cast<std::size_t>(ncoord2), pfile);
-
-    // write x3-coordinates as binary float in big endian order
-    std::fprintf(pfile, "\nZ_COORDINATES %d float\n", ncoord3);
-    if (ncells3 == 1) {
-      data[0] = static_cast<float>(pmb->coords.Xc<3>(out_kb.s));
-    } else {
-      for (int k = out_kb.s; k <= out_kb.e + 1; ++k) {
-        data[k - out_kb.s] = static_cast<float>(pmb->coords.Xf<3>(k));
+
+    // block ids and levels
+    std::vector<std::int32_t> block_info(ncells_block);
+    for (const bool level : {false, true}) {
+      begin_array();
+      for (auto &pmb : blocks) {
+        std::fill(block_info.begin(), block_info.end(),
+                  level ? pmb->loc.level() : pmb->gid);
+        std::fwrite(block_info.data(), sizeof(std::int32_t), block_info.size(), pfile);
       }
     }
-    if (!big_end) {
-      for (int i = 0; i < ncoord3; ++i)
-        Swap4Bytes(&data[i]);
+
+    // variables, each gathered from all blocks into a device buffer by a single kernel
+    // and written from its host copy one component at a time
+    std::size_t var_size_max = 0;
+    for (auto &vinfo : vars_info) {
+      var_size_max = std::max(var_size_max, static_cast<std::size_t>(vinfo.Size()));
     }
-    std::fwrite(data, sizeof(float), static_cast<std::size_t>(ncoord3), pfile);
-
-    //  5. Data.  An arbitrary number of scalars and vectors can be written (every node
-    //  in the OutputData doubly linked lists), all in binary floats format
-
-    std::fprintf(pfile, "\nCELL_DATA %d", pmb->cellbounds.GetTotal(domain));
-    // reset container iterator to point to current block data
-    auto ci =
-        MeshBlockDataIterator<Real>(pmb->meshblock_data.Get(), {Metadata::Graphics});
-    for (auto &v : ci.vars) {
-      if (!data) {
-        std::cout << "____________________SKIPPPING:" << v->label() << std::endl;
-        continue;
+    Kokkos::View<OutT *, DevMemSpace> out_buf(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "vtk output buffer"),
+        var_size_max * num_blocks_local);
+    auto out_buf_h = Kokkos::create_mirror_view(out_buf);
+    Kokkos::View<BlockDataPtr<const Real> *, DevMemSpace> block_ptrs("vtk block data",
+                                                                     num_blocks_local);
+    auto block_ptrs_h = Kokkos::create_mirror_view(block_ptrs);
+    for (auto &vinfo : vars_info) {
+      Variable<Real> *shape_var = nullptr;
+      for (int b = 0; b < num_blocks_local; ++b) {
+        auto v = blocks[b]->meshblock_data.Get()->GetVarPtr(vinfo.label);
+        if (b == 0) shape_var = v.get();
+        block_ptrs_h(b).ptr = v->IsAllocated() ? v->data.data() : nullptr;
       }
-      std::fprintf(pfile, "\nLOOKUP_TABLE default\n");
-      for (int k = out_kb.s; k <= out_kb.e; k++) {
-        for (int j = out_jb.s; j <= out_jb.e; j++) {
-          int index = 0;
-          for (int i = out_ib.s; i <= out_ib.e; i++, index++) {
-            data[(i - out_ib.s) + index] = (*v)(k, j, i);
-          }
-
-          // write data in big endian order
-          if (!big_end) {
-            for (int i = 0; i < (ncells1); ++i)
-              Swap4Bytes(&data[i]);
-          }
-          std::fwrite(data, sizeof(float), static_cast<std::size_t>(ncells1), pfile);
+      Kokkos::deep_copy(block_ptrs, block_ptrs_h);
+      const std::size_t size = PackVarOnDevice(first_block.get(), shape_var, do_ghosts,
+                                               block_ptrs, num_blocks_local, OutT(0),
+                                               out_buf);
+      const std::size_t block_size = size / num_blocks_local;
+      Kokkos::deep_copy(
+          Kokkos::subview(out_buf_h, std::make_pair(std::size_t(0), size)),
+          Kokkos::subview(out_buf, std::make_pair(std::size_t(0), size)));
+      for (int c = 0; c < vinfo.num_components; ++c) {
+        begin_array();
+        for (int b = 0; b < num_blocks_local; ++b) {
+          std::fwrite(out_buf_h.data() + b * block_size + c * ncells_block, sizeof(OutT),
+                      ncells_block, pfile);
         }
       }
     }
+    PARTHENON_REQUIRE_THROWS(next_array == arrays.size(),
+                             "Not all arrays of the VTK output were written");
 
-    // don't forget to close the output file and clean up ptrs to data in OutputData
+    const std::string footer = "\n</AppendedData>\n</VTKFile>\n";
+    std::fwrite(footer.data(), 1, footer.size(), pfile);
     std::fclose(pfile);
-    delete[] data;
-  } // end loop over MeshBlocks
+  }
 
-  // increment counters
-  output_params.file_number++;
-  output_params.next_time += output_params.dt;
-  pin->SetInteger(output_params.block_name, "file_number", output_params.file_number);
-  pin->SetReal(output_params.block_name, "next_time", output_params.next_time);
+  // the parallel file, with the pieces referenced relative to its directory
+  if (Globals::my_rank == 0) {
+    const std::string dirname_prefix = basename.substr(0, basename.find_last_of('/') + 1);
+    std::stringstream xml;
+    xml << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\""
+        << byte_order << "\" header_type=\"UInt64\">\n"
+        << "<PUnstructuredGrid GhostLevel=\"0\">\n"
+        << field_data.str() << "<PPoints>\n";
+    WritePDataArray(xml, arrays[0]);
+    xml << "</PPoints>\n<PCellData>\n";
+    for (std::size_t a = first_cell_array; a < arrays.size(); ++a) {
+      WritePDataArray(xml, arrays[a]);
+    }
+    xml << "</PCellData>\n";
+    for (int rank = 0; rank < Globals::nranks; ++rank) {
+      std::stringstream source;
+      source << basename.substr(dirname_prefix.size()) << ".r" << std::setw(6)
+             << std::setfill('0') << rank << ".vtu";
+      xml << "<Piece Source=\"" << source.str() << "\"/>\n";
+    }
+    xml << "</PUnstructuredGrid>\n</VTKFile>\n";
+
+    std::FILE *pfile = OpenOrFail(basename + ".pvtu");
+    const std::string text = xml.str();
+    std::fwrite(text.data(), 1, text.size(), pfile);
+    std::fclose(pfile);
+  }
 
-  return;
-  */
+  // advance output parameters, only for the default time based data dumps, so that
+  // writing "now" and "final" outputs does not change the output numbering
+  if (signal == SignalHandler::OutputSignal::none) {
+    output_params.file_number++;
+    output_params.next_time += output_params.dt;
+    pin->SetInteger(output_params.block_name, "file_number", output_params.file_number);
+    pin->SetReal(output_params.block_name, "next_time", output_params.next_time);
+  }
 }
-void VTKOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin, SimTime *tm,
-                                const SignalHandler::OutputSignal signal) {
-  throw std::runtime_error(std::string(__func__) + " is not implemented");
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string VTKOutput::GenerateBasename_(const SignalHandler::OutputSignal signal)
+//  \brief "file_basename.file_id.XXXXX", where XXXXX is the file number, "now" or
+//         "final", to which the files of the ranks and the parallel file append their
+//         suffixes
+
+std::string VTKOutput::GenerateBasename_(const SignalHandler::OutputSignal signal) const {
+  auto filename = std::string(output_params.file_basename);
+  filename.append(".");
+  filename.append(output_params.file_id);
+  filename.append(".");
+  if (signal == SignalHandler::OutputSignal::now) {
+    filename.append("now");
+  } else if (signal == SignalHandler::OutputSignal::final &&
+             output_params.file_label_final) {
+    filename.append("final");
+  } else {
+    std::stringstream file_number;
+    file_number << std::setw(output_params.file_number_width) << std::setfill('0')
+                << output_params.file_number;
+    filename.append(file_number.str());
+  }
+  return filename;
 }
 
 } // namespace parthenon
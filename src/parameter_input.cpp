@@ -259,16 +259,8 @@ void ParameterInput::LoadFromFile(IOWrapper &input) {
 //  \brief find or add specified InputBlock.  Returns pointer to block.
 
 InputBlock *ParameterInput::FindOrAddBlock(const std::string &name) {
-  InputBlock *pib, *plast;
-  plast = pfirst_block;
-  pib = pfirst_block;
-
-  // Search singly linked list of InputBlocks to see if name exists, return if found.
-  while (pib != nullptr) {
-    if (name.compare(pib->block_name) == 0) return pib;
-    plast = pib;
-    pib = pib->pnext;
-  }
+  InputBlock *pib = GetPtrToBlock(name);
+  if (pib != nullptr) return pib;
 
   // Create new block in list if not found above
   pib = new InputBlock;
@@ -280,8 +272,10 @@ InputBlock *ParameterInput::FindOrAddBlock(const std::string &name) {
   if (pfirst_block == nullptr) {
     pfirst_block = pib;
   } else {
-    plast->pnext = pib; // link new node into list
+    plast_block_->pnext = pib; // link new node into list
   }
+  plast_block_ = pib;
+  block_index_[name] = pib;
 
   return pib;
 }
@@ -351,20 +345,12 @@ bool ParameterInput::ParseLine(InputBlock *pib, std::string line, std::string &n
 
 void ParameterInput::AddParameter(InputBlock *pb, const std::string &name,
                                   const std::string &value, const std::string &comment) {
-  InputLine *pl, *plast;
-  // Search singly linked list of InputLines to see if name exists.  This also sets *plast
-  // to point to the tail node (but not storing a pointer to the tail node in InputBlock)
-  pl = pb->pline;
-  plast = pb->pline;
-  while (pl != nullptr) {
-    if (name.compare(pl->param_name) == 0) { // param name already exists
-      pl->param_value.assign(value);         // replace existing param value
-      pl->param_comment.assign(comment);     // replace exisiting param comment
-      if (value.length() > pb->max_len_parvalue) pb->max_len_parvalue = value.length();
-      return;
-    }
-    plast = pl;
-    pl = pl->pnext;
+  InputLine *pl = pb->GetPtrToLine(name);
+  if (pl != nullptr) {                 // param name already exists
+    pl->param_value.assign(value);     // replace existing param value
+    pl->param_comment.assign(comment); // replace exisiting param comment
+    if (value.length() > pb->max_len_parvalue) pb->max_len_parvalue = value.length();
+    return;
   }
 
   // Create new node in singly linked list if name does not already exist
@@ -380,10 +366,12 @@ void ParameterInput::AddParameter(InputBlock *pb, const std::string &name,
     pb->max_len_parname = name.length();
     pb->max_len_parvalue = value.length();
   } else {
-    plast->pnext = pl; // link new node into list
+    pb->plast_line->pnext = pl; // link new node into list
     if (name.length() > pb->max_len_parname) pb->max_len_parname = name.length();
     if (value.length() > pb->max_len_parvalue) pb->max_len_parvalue = value.length();
   }
+  pb->plast_line = pl;
+  pb->line_index[name] = pl;
 
   return;
 }
@@ -456,11 +444,8 @@ void ParameterInput::ModifyFromCmdline(int argc, char *argv[]) {
 //  \brief return pointer to specified InputBlock if it exists
 
 InputBlock *ParameterInput::GetPtrToBlock(const std::string &name) {
-  InputBlock *pb;
-  for (pb = pfirst_block; pb != nullptr; pb = pb->pnext) {
-    if (name.compare(pb->block_name) == 0) return pb;
-  }
-  return nullptr;
+  auto it = block_index_.find(name);
+  return it == block_index_.end() ? nullptr : it->second;
 }
 
 //----------------------------------------------------------------------------------------
@@ -991,14 +976,12 @@ void ParameterInput::ParameterDump(std::ostream &os) {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn InputLine* InputBlock::GetPtrToLine(std::string name)
+//! \fn InputLine* InputBlock::GetPtrToLine(const std::string &name)
 //  \brief return pointer to InputLine containing specified parameter if it exists
 
-InputLine *InputBlock::GetPtrToLine(std::string name) {
-  for (InputLine *pl = pline; pl != nullptr; pl = pl->pnext) {
-    if (name.compare(pl->param_name) == 0) return pl;
-  }
-  return nullptr;
+InputLine *InputBlock::GetPtrToLine(const std::string &name) {
+  auto it = line_index.find(name);
+  return it == line_index.end() ? nullptr : it->second;
 }
 
 } // namespace parthenon
@@ -26,6 +26,7 @@
 #include <cstddef>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "config.hpp"
@@ -62,10 +63,12 @@ class InputBlock {
   InputBlock *pnext; // pointer to the next node in InputBlock singly linked list
 
   InputLine *pline; // pointer to head node in nested singly linked list (in this block)
-  // (not storing a reference to the tail node)
+  InputLine *plast_line = nullptr; // pointer to tail node, for appending
+  // lines of the list by name, so that lookups don't walk the list
+  std::unordered_map<std::string, InputLine *> line_index;
 
   // functions
-  InputLine *GetPtrToLine(std::string name);
+  InputLine *GetPtrToLine(const std::string &name);
 };
 
 //----------------------------------------------------------------------------------------
@@ -147,6 +150,9 @@ class ParameterInput {
 
  private:
   std::string last_filename_; // last input file opened, to prevent duplicate reads
+  InputBlock *plast_block_ = nullptr; // tail node of the InputBlock list, for appending
+  // blocks of the list by name, so that lookups don't walk the list
+  std::unordered_map<std::string, InputBlock *> block_index_;
 
   InputBlock *FindOrAddBlock(const std::string &name);
   InputBlock *GetPtrToBlock(const std::string &name);
@@ -29,6 +29,7 @@
 #include <mesh/mesh.hpp>
 #include <mesh/meshblock.hpp>
 #include <mesh/meshblock_pack.hpp>
+#include <outputs/inline_diagnostics.hpp>
 #include <parameter_input.hpp>
 #include <parthenon_manager.hpp>
 #include <utils/index_split.hpp>
@@ -58,6 +59,7 @@ using ::parthenon::PackIndexMap;
 using ::parthenon::par_for;
 using ::parthenon::ParameterInput;
 using ::parthenon::Params;
+using ::parthenon::ShellBounds;
 using ::parthenon::SparsePack;
 using ::parthenon::SparsePool;
 using ::parthenon::StateDescriptor;
@@ -20,7 +20,10 @@
 #include <globals.hpp>
 #include <interface/mesh_data.hpp>
 #include <interface/meshblock_data.hpp>
+#include <interface/swarm_cell_loops.hpp>
+#include <interface/swarm_comms.hpp>
 #include <interface/swarm_container.hpp>
+#include <interface/swarm_deposition.hpp>
 #include <interface/variable.hpp>
 #include <mesh/domain.hpp>
 #include <mesh/mesh.hpp>
@@ -31,6 +34,9 @@
 namespace parthenon {
 namespace prelude {
 using ::parthenon::BoundaryCommSubset;
+using ::parthenon::DepositionShape;
+using ::parthenon::DepositionStrategy;
+using ::parthenon::DepositParticles;
 using ::parthenon::IndexDomain;
 using ::parthenon::IndexRange;
 using ::parthenon::KokkosTimer;
@@ -38,10 +44,13 @@ using ::parthenon::MeshBlock;
 using ::parthenon::MeshBlockData;
 using ::parthenon::MeshData;
 using ::parthenon::par_for_inner;
+using ::parthenon::par_for_particles_by_cell;
 using ::parthenon::ParArrayHost;
 using ::parthenon::ParArrayND;
 using ::parthenon::ParthenonStatus;
 using ::parthenon::Real;
+using ::parthenon::ReceiveSwarmAggregated;
+using ::parthenon::SendSwarmAggregated;
 using ::parthenon::Swarm;
 using ::parthenon::SwarmContainer;
 using ::parthenon::Variable;
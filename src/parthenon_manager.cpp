@@ -19,8 +19,10 @@
 
 #include <algorithm>
 #include <exception>
+#include <iostream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -36,6 +38,9 @@
 #include "outputs/output_utils.hpp"
 #include "outputs/parthenon_hdf5.hpp"
 #include "utils/error_checking.hpp"
+#include "utils/kernel_costs.hpp"
+#include "utils/launch_config.hpp"
+#include "utils/loop_autotune.hpp"
 #include "utils/utils.hpp"
 
 namespace parthenon {
@@ -48,7 +53,16 @@ ParthenonStatus ParthenonManager::ParthenonInitEnv(int argc, char *argv[]) {
 
   // initialize MPI
 #ifdef MPI_PARALLEL
-  if (MPI_SUCCESS != MPI_Init(&argc, &argv)) {
+  // HDF5 outputs with async_write need MPI_THREAD_MULTIPLE, which may slow down MPI, so
+  // it is only requested on demand
+  bool unused_env;
+  const int thread_level =
+      Env::get<bool>("PARTHENON_MPI_THREAD_MULTIPLE", false, unused_env)
+          ? MPI_THREAD_MULTIPLE
+          : MPI_THREAD_SINGLE;
+  int thread_level_provided;
+  if (MPI_SUCCESS !=
+      MPI_Init_thread(&argc, &argv, thread_level, &thread_level_provided)) {
     std::cout << "### FATAL ERROR in ParthenonInit" << std::endl
               << "MPI Initialization failed." << std::endl;
     return ParthenonStatus::error;
@@ -130,6 +144,81 @@ ParthenonStatus ParthenonManager::ParthenonInitEnv(int argc, char *argv[]) {
   Globals::sparse_config.deallocation_count = pinput->GetOrAddInteger(
       "parthenon/sparse", "dealloc_count", Globals::sparse_config.deallocation_count);
 
+  // set boundary communication config
+  Globals::comm_config.coalesce_messages = pinput->GetOrAddBoolean(
+      "parthenon/comms", "coalesce_messages", Globals::comm_config.coalesce_messages);
+  Globals::comm_config.compact_messages = pinput->GetOrAddBoolean(
+      "parthenon/comms", "compact_messages", Globals::comm_config.compact_messages);
+  Globals::comm_config.neighborhood_comm = pinput->GetOrAddBoolean(
+      "parthenon/comms", "neighborhood_comm", Globals::comm_config.neighborhood_comm);
+  Globals::comm_config.shared_memory_comm =
+      pinput->GetOrAddBoolean("parthenon/comms", "shared_memory_comm",
+                              Globals::comm_config.shared_memory_comm);
+  Globals::comm_config.rma_comm = pinput->GetOrAddBoolean("parthenon/comms", "rma_comm",
+                                                          Globals::comm_config.rma_comm);
+  // the messages are packed and unpacked by the host
+  if (!Kokkos::SpaceAccessibility<Kokkos::HostSpace, BufMemSpace>::accessible)
+    Globals::comm_config.shared_memory_comm = false;
+  Globals::comm_config.persistent_requests =
+      pinput->GetOrAddBoolean("parthenon/comms", "persistent_requests",
+                              Globals::comm_config.persistent_requests);
+  Globals::comm_config.fuse_restriction = pinput->GetOrAddBoolean(
+      "parthenon/comms", "fuse_restriction", Globals::comm_config.fuse_restriction);
+  Globals::comm_config.zero_copy_local = pinput->GetOrAddBoolean(
+      "parthenon/comms", "zero_copy_local", Globals::comm_config.zero_copy_local);
+  Globals::comm_config.host_staging = pinput->GetOrAddBoolean(
+      "parthenon/comms", "host_staging", Globals::comm_config.host_staging);
+  // there is nothing to stage if MPI can access the buffers from the host anyway
+  if (Kokkos::SpaceAccessibility<Kokkos::HostSpace, BufMemSpace>::accessible)
+    Globals::comm_config.host_staging = false;
+  Globals::comm_config.fields_per_comm = pinput->GetOrAddInteger(
+      "parthenon/comms", "fields_per_comm", Globals::comm_config.fields_per_comm);
+  PARTHENON_REQUIRE_THROWS(Globals::comm_config.fields_per_comm >= 1 &&
+                               Globals::comm_config.fields_per_comm <= 32,
+                           "parthenon/comms/fields_per_comm must be between 1 and 32");
+  const std::string buffer_order =
+      pinput->GetOrAddString("parthenon/comms", "buffer_order", "random");
+  if (buffer_order == "random") {
+    Globals::comm_config.buffer_order = Globals::BufferOrder::random;
+  } else if (buffer_order == "natural") {
+    Globals::comm_config.buffer_order = Globals::BufferOrder::natural;
+  } else if (buffer_order == "rank") {
+    Globals::comm_config.buffer_order = Globals::BufferOrder::rank;
+  } else if (buffer_order == "morton") {
+    Globals::comm_config.buffer_order = Globals::BufferOrder::morton;
+  } else {
+    PARTHENON_THROW("Unknown parthenon/comms/buffer_order " + buffer_order +
+                    ", use one of random, natural, rank or morton.");
+  }
+
+  // set up the choice of loop patterns with loop_pattern_autotune_tag
+  LoopAutotuner::Get().Configure(
+      pinput->GetOrAddBoolean("parthenon/autotune", "enable", true),
+      pinput->GetOrAddInteger("parthenon/autotune", "trials", 3),
+      pinput->GetOrAddString("parthenon/autotune", "cache_file", ""));
+
+  // set launch parameters of kernels by label
+  if (pinput->DoesBlockExist("parthenon/kernels")) {
+    for (const auto &label :
+         pinput->GetVector<std::string>("parthenon/kernels", "labels")) {
+      const std::string block = "parthenon/kernels/" + label;
+      LaunchConfig config;
+      if (pinput->DoesParameterExist(block, "tile"))
+        config.tile = pinput->GetVector<int>(block, "tile");
+      config.team_size = pinput->GetOrAddInteger(block, "team_size", 0);
+      config.vector_length = pinput->GetOrAddInteger(block, "vector_length", 0);
+      LaunchConfigs::Set(label, config);
+      if (pinput->DoesParameterExist(block, "bytes_per_iteration") ||
+          pinput->DoesParameterExist(block, "flops_per_iteration")) {
+        KernelCost cost;
+        cost.bytes = pinput->GetOrAddReal(block, "bytes_per_iteration", 0.0);
+        cost.flops = pinput->GetOrAddReal(block, "flops_per_iteration", 0.0);
+        KernelCosts::Set(label, cost);
+      }
+    }
+  }
+  KernelCosts::SetTiming(pinput->GetOrAddBoolean("parthenon/kernels", "roofline", false));
+
   // set timeout config
   Globals::receive_boundary_buffer_timeout =
       pinput->GetOrAddReal("parthenon/time", "recv_bdry_buf_timeout_sec", -1.0);
@@ -197,7 +286,16 @@ void ParthenonManager::ParthenonInitPackagesAndMesh() {
 }
 
 ParthenonStatus ParthenonManager::ParthenonFinalize() {
+#ifdef ENABLE_HDF5
+  // finish outputs that are still written in the background
+  HDF5::AsyncWriter::Wait();
+#endif
   pmesh.reset();
+  LoopAutotuner::Get().Save();
+  if (KernelCosts::Timing() && Globals::my_rank == 0) {
+    std::cout << "Kernel rooflines (rank 0):" << std::endl;
+    KernelCosts::Report(std::cout);
+  }
   Kokkos::finalize();
 #ifdef MPI_PARALLEL
   MPI_Finalize();
@@ -296,20 +394,70 @@ void ParthenonManager::RestartPackages(Mesh &rm, RestartReader &resfile) {
       num_sparse == sparse_info.num_sparse,
       "Mismatch between sparse fields in simulation and restart file");
 
-  std::vector<Real> tmp(static_cast<size_t>(nb) * nCells * max_vlen);
+  const std::size_t buf_size = static_cast<size_t>(nb) * nCells * max_vlen;
+  std::vector<Real> tmp;
+  // Unless the file is in the original format, each variable is read into one of two
+  // pinned host buffers, which is then copied to the device and unpacked into the
+  // blocks by a single kernel on an execution space instance of its own, while the
+  // next variable is read into the other buffer
+  const bool unpack_on_device = (file_output_format_ver != -1);
+  // With gpu_direct, variables stored contiguously are read straight into the device
+  // buffers through the HDF5 GDS VFD, skipping the host buffers
+  std::unordered_set<std::string> direct_vars;
+  if (unpack_on_device &&
+      pinput->GetOrAddBoolean("parthenon/restart", "gpu_direct", false)) {
+    resfile.EnableGPUDirect();
+    for (auto &v_info : indep_restart_vars) {
+      if (resfile.IsContiguous(v_info->label())) direct_vars.insert(v_info->label());
+    }
+  }
+  const bool host_buffers = (direct_vars.size() < indep_restart_vars.size());
+  struct ReadBuffer {
+    Kokkos::View<Real *, HostPinnedMemSpace> host;
+    Kokkos::View<Real *, DevMemSpace> device;
+    Kokkos::View<OutputUtils::BlockDataPtr<Real> *, DevMemSpace> blocks;
+    typename Kokkos::View<OutputUtils::BlockDataPtr<Real> *, DevMemSpace>::HostMirror
+        blocks_h;
+  };
+  std::vector<ReadBuffer> bufs;
+  std::vector<DevExecSpace> exec_spaces;
+  if (unpack_on_device) {
+    exec_spaces = Kokkos::Experimental::partition_space(DevExecSpace(), 1, 1);
+    for (int n = 0; n < 2; ++n) {
+      ReadBuffer buf;
+      if (host_buffers) {
+        buf.host = Kokkos::View<Real *, HostPinnedMemSpace>(
+            Kokkos::view_alloc(Kokkos::WithoutInitializing, "restart host buffer"),
+            buf_size);
+      }
+      buf.device = Kokkos::View<Real *, DevMemSpace>(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "restart buffer"), buf_size);
+      buf.blocks = Kokkos::View<OutputUtils::BlockDataPtr<Real> *, DevMemSpace>(
+          "restart block data", nb);
+      buf.blocks_h = Kokkos::create_mirror_view(buf.blocks);
+      bufs.push_back(buf);
+    }
+  } else {
+    tmp.resize(buf_size);
+  }
+  int nread = 0;
   for (auto &v_info : indep_restart_vars) {
     const auto vlen = v_info->NumComponents();
     const auto &label = v_info->label();
-    const auto &Nv = v_info->GetDim(4);
-    const auto &Nu = v_info->GetDim(5);
-    const auto &Nt = v_info->GetDim(6);
 
     if (Globals::my_rank == 0) {
       std::cout << "Var: " << label << ":" << vlen << std::endl;
     }
+    const int nbuf = nread % 2;
+    // the buffer is free once the previous variable read into it is unpacked
+    if (unpack_on_device) exec_spaces[nbuf].fence();
+    const bool direct = (direct_vars.count(label) > 0);
+    Real *data = direct             ? bufs[nbuf].device.data()
+                 : unpack_on_device ? bufs[nbuf].host.data()
+                                    : tmp.data();
     // Read relevant data from the hdf file, this works for dense and sparse variables
     try {
-      resfile.ReadBlocks(label, myBlocks, tmp, bsize, file_output_format_ver,
+      resfile.ReadBlocks(label, myBlocks, data, buf_size, bsize, file_output_format_ver,
                          v_info->metadata().Where(), v_info->metadata().Shape());
     } catch (std::exception &ex) {
       std::cout << "[" << Globals::my_rank << "] WARNING: Failed to read variable "
@@ -317,9 +465,12 @@ void ParthenonManager::RestartPackages(Mesh &rm, RestartReader &resfile) {
                 << ex.what() << std::endl;
       continue;
     }
+    ++nread;
 
     size_t index = 0;
-    for (auto &pmb : rm.block_list) {
+    for (int b = 0; b < nb; ++b) {
+      auto &pmb = rm.block_list[b];
+      if (unpack_on_device) bufs[nbuf].blocks_h(b).ptr = nullptr;
       if (v_info->IsSparse()) {
         // check if the sparse variable is allocated on this block
         if (sparse_info.IsAllocated(pmb->gid, sparse_idxs.at(label))) {
@@ -332,33 +483,51 @@ void ParthenonManager::RestartPackages(Mesh &rm, RestartReader &resfile) {
       }
 
       auto v = pmb->meshblock_data.Get()->GetVarPtr(label);
+      if (unpack_on_device) {
+        bufs[nbuf].blocks_h(b).ptr = v->data.data();
+        continue;
+      }
       auto v_h = v->data.GetHostMirror();
 
       // Double note that this also needs to be update in case
       // we update the HDF5 infrastructure!
-      if (file_output_format_ver == -1) {
-        PARTHENON_WARN("This file output format version is deprecrated and will be "
-                       "removed in a future release.");
-        for (int k = out_kb.s; k <= out_kb.e; ++k) {
-          for (int j = out_jb.s; j <= out_jb.e; ++j) {
-            for (int i = out_ib.s; i <= out_ib.e; ++i) {
-              for (int l = 0; l < vlen; ++l) {
-                v_h(l, k, j, i) = tmp[index++];
-              }
+      PARTHENON_WARN("This file output format version is deprecrated and will be "
+                     "removed in a future release.");
+      for (int k = out_kb.s; k <= out_kb.e; ++k) {
+        for (int j = out_jb.s; j <= out_jb.e; ++j) {
+          for (int i = out_ib.s; i <= out_ib.e; ++i) {
+            for (int l = 0; l < vlen; ++l) {
+              v_h(l, k, j, i) = tmp[index++];
             }
           }
         }
-      } else if (file_output_format_ver == 2 ||
-                 file_output_format_ver == HDF5::OUTPUT_VERSION_FORMAT) {
-        OutputUtils::PackOrUnpackVar(pmb.get(), v.get(), resfile.hasGhost, index, tmp,
-                                     [&](auto index, int t, int u, int v, int k, int j,
-                                         int i) { v_h(t, u, v, k, j, i) = tmp[index]; });
-      } else {
-        PARTHENON_THROW("Unknown output format version in restart file.")
       }
-
       v->data.DeepCopy(v_h);
     }
+
+    if (unpack_on_device) {
+      PARTHENON_REQUIRE_THROWS(file_output_format_ver == 2 ||
+                                   file_output_format_ver == HDF5::OUTPUT_VERSION_FORMAT,
+                               "Unknown output format version in restart file.");
+      auto &buf = bufs[nbuf];
+      const auto &exec_space = exec_spaces[nbuf];
+      // newly allocated sparse variables are zeroed on the default instance
+      DevExecSpace().fence();
+      auto v = mb.meshblock_data.Get()->GetVarPtr(label);
+      const auto range = std::make_pair(
+          std::size_t(0),
+          OutputUtils::PackedVarShape(&mb, v.get(), resfile.hasGhost).block_size * nb);
+      Kokkos::deep_copy(exec_space, buf.blocks, buf.blocks_h);
+      if (!direct) {
+        Kokkos::deep_copy(exec_space, Kokkos::subview(buf.device, range),
+                          Kokkos::subview(buf.host, range));
+      }
+      OutputUtils::UnpackVarOnDevice(&mb, v.get(), resfile.hasGhost, buf.blocks, nb,
+                                     buf.device, exec_space);
+    }
+  }
+  for (auto &exec_space : exec_spaces) {
+    exec_space.fence();
   }
 
   // Swarm data
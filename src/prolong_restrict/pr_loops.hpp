@@ -108,11 +108,57 @@ KOKKOS_INLINE_FUNCTION void IterateInnerProlongationRestrictionLoop(Args &&...ar
       ...);
 }
 
+// Apply Stencil to the region of buffer buf from within a team of an outer loop over
+// buffers. This is also used to fuse restriction into the kernel packing the buffers
+// (see SendBoundBufs), in which case the caller needs a team_barrier before reading the
+// result.
+template <int DIM, class Stencil>
+KOKKOS_INLINE_FUNCTION void
+TeamProlongationRestriction(team_mbr_t &team_member, std::size_t buf,
+                            const ProResInfoArr_t &info, const IndexRange &ckb,
+                            const IndexRange &cjb, const IndexRange &cib,
+                            const IndexRange &kb, const IndexRange &jb,
+                            const IndexRange &ib) {
+  using TE = TopologicalElement;
+  if (info(buf).fine.topological_type == TopologicalType::Cell)
+    IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::CC>(
+        team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
+  if (info(buf).fine.topological_type == TopologicalType::Face)
+    IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::F1, TE::F2, TE::F3>(
+        team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
+  if (info(buf).fine.topological_type == TopologicalType::Edge)
+    IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::E3, TE::E2, TE::E1>(
+        team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
+  if (info(buf).fine.topological_type == TopologicalType::Node)
+    IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::NN>(
+        team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
+}
+
+template <class Stencil>
+KOKKOS_INLINE_FUNCTION void
+TeamProlongationRestriction(const int dim, team_mbr_t &team_member, std::size_t buf,
+                            const ProResInfoArr_t &info, const IndexRange &ckb,
+                            const IndexRange &cjb, const IndexRange &cib,
+                            const IndexRange &kb, const IndexRange &jb,
+                            const IndexRange &ib) {
+  if (dim == 3) {
+    TeamProlongationRestriction<3, Stencil>(team_member, buf, info, ckb, cjb, cib, kb, jb,
+                                            ib);
+  } else if (dim == 2) {
+    TeamProlongationRestriction<2, Stencil>(team_member, buf, info, ckb, cjb, cib, kb, jb,
+                                            ib);
+  } else {
+    TeamProlongationRestriction<1, Stencil>(team_member, buf, info, ckb, cjb, cib, kb, jb,
+                                            ib);
+  }
+}
+
 template <int DIM, class Stencil>
 inline void
-ProlongationRestrictionLoop(const ProResInfoArr_t &info, const Idx_t &buffer_idxs,
-                            const IndexShape &cellbounds, const IndexShape &c_cellbounds,
-                            const RefinementOp_t op, const std::size_t nbuffers) {
+ProlongationRestrictionLoop(const DevExecSpace &exec_space, const ProResInfoArr_t &info,
+                            const Idx_t &buffer_idxs, const IndexShape &cellbounds,
+                            const IndexShape &c_cellbounds, const RefinementOp_t op,
+                            const std::size_t nbuffers) {
   PARTHENON_INSTRUMENT
   const IndexDomain interior = IndexDomain::interior;
   auto ckb = c_cellbounds.GetBoundsK(interior);
@@ -124,34 +170,22 @@ ProlongationRestrictionLoop(const ProResInfoArr_t &info, const Idx_t &buffer_idx
   const int scratch_level = 1; // 0 is actual scratch (tiny); 1 is HBM
   size_t scratch_size_in_bytes = 1;
   par_for_outer(
-      DEFAULT_OUTER_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(),
-      scratch_size_in_bytes, scratch_level, 0, nbuffers - 1,
+      DEFAULT_OUTER_LOOP_PATTERN, PARTHENON_AUTO_LABEL, exec_space, scratch_size_in_bytes,
+      scratch_level, 0, nbuffers - 1,
       KOKKOS_LAMBDA(team_mbr_t team_member, const int sub_idx) {
         const std::size_t buf = buffer_idxs(sub_idx);
         if (DoRefinementOp(info(buf), op)) {
-          using TE = TopologicalElement;
-          if (info(buf).fine.topological_type == TopologicalType::Cell)
-            IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::CC>(
-                team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
-          if (info(buf).fine.topological_type == TopologicalType::Face)
-            IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::F1, TE::F2, TE::F3>(
-                team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
-          if (info(buf).fine.topological_type == TopologicalType::Edge)
-            IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::E3, TE::E2, TE::E1>(
-                team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
-          if (info(buf).fine.topological_type == TopologicalType::Node)
-            IterateInnerProlongationRestrictionLoop<DIM, Stencil, TE::NN>(
-                team_member, buf, info, ckb, cjb, cib, kb, jb, ib);
+          TeamProlongationRestriction<DIM, Stencil>(team_member, buf, info, ckb, cjb, cib,
+                                                    kb, jb, ib);
         }
       });
 }
 
 template <int DIM, class Stencil, TopologicalElement FEL, TopologicalElement CEL>
-inline void
-InnerHostProlongationRestrictionLoop(std::size_t buf, const ProResInfoArrHost_t &info,
-                                     const IndexRange &ckb, const IndexRange &cjb,
-                                     const IndexRange &cib, const IndexRange &kb,
-                                     const IndexRange &jb, const IndexRange &ib) {
+inline void InnerHostProlongationRestrictionLoop(
+    const DevExecSpace &exec_space, std::size_t buf, const ProResInfoArrHost_t &info,
+    const IndexRange &ckb, const IndexRange &cjb, const IndexRange &cib,
+    const IndexRange &kb, const IndexRange &jb, const IndexRange &ib) {
   PARTHENON_INSTRUMENT
   const auto &idxer = info(buf).idxer[static_cast<int>(CEL)];
   auto coords = info(buf).coords;
@@ -159,7 +193,7 @@ InnerHostProlongationRestrictionLoop(std::size_t buf, const ProResInfoArrHost_t
   auto coarse = info(buf).coarse;
   auto fine = info(buf).fine;
   par_for(
-      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, DevExecSpace(), 0, 0, 0, 0, 0,
+      DEFAULT_LOOP_PATTERN, PARTHENON_AUTO_LABEL, exec_space, 0, 0, 0, 0, 0,
       idxer.size() - 1, KOKKOS_LAMBDA(const int, const int, const int ii) {
         const auto [t, u, v, k, j, i] = idxer(ii);
         if (idxer.IsActive(k, j, i)) {
@@ -203,7 +237,8 @@ inline void IterateInnerHostProlongationRestrictionLoop(Args &&...args) {
 
 template <int DIM, class Stencil>
 inline void
-ProlongationRestrictionLoop(const ProResInfoArrHost_t &info_h,
+ProlongationRestrictionLoop(const DevExecSpace &exec_space,
+                            const ProResInfoArrHost_t &info_h,
                             const IdxHost_t &buffer_idxs_h, const IndexShape &cellbounds,
                             const IndexShape &c_cellbounds, const RefinementOp_t op,
                             const std::size_t nbuffers) {
@@ -222,32 +257,95 @@ ProlongationRestrictionLoop(const ProResInfoArrHost_t &info_h,
       using TE = TopologicalElement;
       if (info_h(buf).fine.topological_type == TopologicalType::Cell)
         IterateInnerHostProlongationRestrictionLoop<DIM, Stencil, TE::CC>(
-            buf, info_h, ckb, cjb, cib, kb, jb, ib);
+            exec_space, buf, info_h, ckb, cjb, cib, kb, jb, ib);
       if (info_h(buf).fine.topological_type == TopologicalType::Face)
         IterateInnerHostProlongationRestrictionLoop<DIM, Stencil, TE::F1, TE::F2, TE::F3>(
-            buf, info_h, ckb, cjb, cib, kb, jb, ib);
+            exec_space, buf, info_h, ckb, cjb, cib, kb, jb, ib);
       if (info_h(buf).fine.topological_type == TopologicalType::Edge)
         IterateInnerHostProlongationRestrictionLoop<DIM, Stencil, TE::E3, TE::E2, TE::E1>(
-            buf, info_h, ckb, cjb, cib, kb, jb, ib);
+            exec_space, buf, info_h, ckb, cjb, cib, kb, jb, ib);
       if (info_h(buf).fine.topological_type == TopologicalType::Node)
         IterateInnerHostProlongationRestrictionLoop<DIM, Stencil, TE::NN>(
-            buf, info_h, ckb, cjb, cib, kb, jb, ib);
+            exec_space, buf, info_h, ckb, cjb, cib, kb, jb, ib);
     }
   }
 }
+// Cell-centered fields only need the CC to CC specialization of Stencil, so if every
+// buffer that is operated on is cell-centered, all of them are handled by a single flat
+// kernel over (buffer, cell) instead of by a team per buffer, or a kernel per buffer on
+// the host, and without dispatching on the topological type.  Consecutive threads work
+// on consecutive cells in i of a buffer, so accesses to the fields are coalesced.
+// max_size is the largest number of cells of any of the buffers.
 template <int DIM, class Stencil>
-inline void
-ProlongationRestrictionLoop(const ProResInfoArr_t &info,
-                            const ProResInfoArrHost_t &info_h, const Idx_t &buffer_idxs,
-                            const IdxHost_t &buffer_idxs_h, const IndexShape &cellbounds,
-                            const IndexShape &c_cellbounds, const RefinementOp_t op,
-                            const std::size_t nbuffers) {
+inline void CellProlongationRestrictionLoop(
+    const DevExecSpace &exec_space, const ProResInfoArr_t &info, const Idx_t &buffer_idxs,
+    const IndexShape &cellbounds, const IndexShape &c_cellbounds, const RefinementOp_t op,
+    const std::size_t nbuffers, const int max_size) {
+  PARTHENON_INSTRUMENT
+  using TE = TopologicalElement;
+  const IndexDomain interior = IndexDomain::interior;
+  auto ckb = c_cellbounds.GetBoundsK(interior);
+  auto cjb = c_cellbounds.GetBoundsJ(interior);
+  auto cib = c_cellbounds.GetBoundsI(interior);
+  auto kb = cellbounds.GetBoundsK(interior);
+  auto jb = cellbounds.GetBoundsJ(interior);
+  auto ib = cellbounds.GetBoundsI(interior);
+  par_for(
+      loop_pattern_mdrange_tag, PARTHENON_AUTO_LABEL, exec_space, 0,
+      static_cast<int>(nbuffers) - 1, 0, max_size - 1,
+      KOKKOS_LAMBDA(const int sub_idx, const int ii) {
+        const std::size_t buf = buffer_idxs(sub_idx);
+        if (!DoRefinementOp(info(buf), op)) return;
+        const auto &idxer = info(buf).idxer[static_cast<int>(TE::CC)];
+        if (ii >= static_cast<int>(idxer.size())) return;
+        const auto [t, u, v, k, j, i] = idxer(ii);
+        if (idxer.IsActive(k, j, i)) {
+          Stencil::template Do<DIM, TE::CC, TE::CC>(
+              t, u, v, k, j, i, ckb, cjb, cib, kb, jb, ib, info(buf).coords,
+              info(buf).coarse_coords, &(info(buf).coarse), &(info(buf).fine));
+        }
+      });
+}
+
+// The largest number of cells of the buffers operated on, or -1 if any of them is not
+// cell-centered
+inline int MaxCellBufferSize(const ProResInfoArrHost_t &info_h,
+                             const IdxHost_t &buffer_idxs_h, const RefinementOp_t op,
+                             const std::size_t nbuffers) {
+  int max_size = 0;
+  for (std::size_t sub_idx = 0; sub_idx < nbuffers; ++sub_idx) {
+    const auto &buf_info = info_h(buffer_idxs_h(sub_idx));
+    if (!DoRefinementOp(buf_info, op)) continue;
+    if (buf_info.fine.topological_type != TopologicalType::Cell) return -1;
+    const auto &idxer = buf_info.idxer[static_cast<int>(TopologicalElement::CC)];
+    max_size = std::max(max_size, static_cast<int>(idxer.size()));
+  }
+  return max_size;
+}
+
+template <int DIM, class Stencil>
+inline void ProlongationRestrictionLoop(
+    const DevExecSpace &exec_space, const ProResInfoArr_t &info,
+    const ProResInfoArrHost_t &info_h, const Idx_t &buffer_idxs,
+    const IdxHost_t &buffer_idxs_h, const IndexShape &cellbounds,
+    const IndexShape &c_cellbounds, const RefinementOp_t op, const std::size_t nbuffers) {
+  if constexpr (Stencil::OperationRequired(TopologicalElement::CC,
+                                           TopologicalElement::CC)) {
+    const int max_size = MaxCellBufferSize(info_h, buffer_idxs_h, op, nbuffers);
+    if (max_size == 0) return;
+    if (max_size > 0) {
+      CellProlongationRestrictionLoop<DIM, Stencil>(exec_space, info, buffer_idxs,
+                                                    cellbounds, c_cellbounds, op,
+                                                    nbuffers, max_size);
+      return;
+    }
+  }
   if (nbuffers > Globals::refinement::min_num_bufs) {
-    ProlongationRestrictionLoop<DIM, Stencil>(info, buffer_idxs, cellbounds, c_cellbounds,
-                                              op, nbuffers);
-  } else {
-    ProlongationRestrictionLoop<DIM, Stencil>(info_h, buffer_idxs_h, cellbounds,
+    ProlongationRestrictionLoop<DIM, Stencil>(exec_space, info, buffer_idxs, cellbounds,
                                               c_cellbounds, op, nbuffers);
+  } else {
+    ProlongationRestrictionLoop<DIM, Stencil>(exec_space, info_h, buffer_idxs_h,
+                                              cellbounds, c_cellbounds, op, nbuffers);
   }
 }
 
@@ -278,6 +278,117 @@ struct ProlongateSharedGeneral {
 using ProlongateSharedMinMod = ProlongateSharedGeneral<true>;
 using ProlongateSharedLinear = ProlongateSharedGeneral<false>;
 
+// Conservative, third order accurate prolongation for uniform meshes.  The fine values
+// are the averages over the children of a coarse cell of the tensor product of the
+// quadratics through the coarse values of the three cells around it in each direction,
+//   fc + sum_d s_d g_d / 8 + sum_{d<e} s_d s_e g_de / 64 + s_1 s_2 s_3 g_123 / 512,
+// where s_d is -1 (+1) for the lower (upper) child in direction d, g_d are the central
+// differences of the coarse values and g_de, g_123 the mixed ones.  The differences are
+// computed once per coarse cell and shared by all of its children.  If any child falls
+// outside the range of the coarse values of the stencil, all children of the cell get
+// the minmod limited slopes of ProlongateSharedMinMod instead, which are computed from
+// the same coarse values.  Note that the stencil includes the edge and corner neighbors
+// of the coarse cell.
+struct ProlongateSharedQuadratic {
+  static constexpr bool OperationRequired(TopologicalElement fel,
+                                          TopologicalElement cel) {
+    return fel == cel;
+  }
+
+  template <int DIM, TopologicalElement el = TopologicalElement::CC,
+            TopologicalElement /*cel*/ = TopologicalElement::CC>
+  KOKKOS_FORCEINLINE_FUNCTION static void
+  Do(const int l, const int m, const int n, const int k, const int j, const int i,
+     const IndexRange &ckb, const IndexRange &cjb, const IndexRange &cib,
+     const IndexRange &kb, const IndexRange &jb, const IndexRange &ib,
+     const Coordinates_t &coords, const Coordinates_t &coarse_coords,
+     const ParArrayND<Real, VariableState> *pcoarse,
+     const ParArrayND<Real, VariableState> *pfine) {
+    auto &coarse = *pcoarse;
+    auto &fine = *pfine;
+
+    constexpr int element_idx = static_cast<int>(el) % 3;
+
+    const int fi = (DIM > 0) ? (i - cib.s) * 2 + ib.s : ib.s;
+    const int fj = (DIM > 1) ? (j - cjb.s) * 2 + jb.s : jb.s;
+    const int fk = (DIM > 2) ? (k - ckb.s) * 2 + kb.s : kb.s;
+
+    constexpr int D1 =
+        (DIM > 0) && (el == TE::CC || el == TE::F2 || el == TE::F3 || el == TE::E1);
+    constexpr int D2 =
+        (DIM > 1) && (el == TE::CC || el == TE::F3 || el == TE::F1 || el == TE::E2);
+    constexpr int D3 =
+        (DIM > 2) && (el == TE::CC || el == TE::F1 || el == TE::F2 || el == TE::E3);
+
+    // Coarse values of the stencil, q[1][1][1] is the coarse cell.  In directions
+    // without children the stencil collapses onto the cell, so the differences in them
+    // vanish.
+    Real q[3][3][3];
+    Real qmin = coarse(element_idx, l, m, n, k, j, i);
+    Real qmax = qmin;
+    for (int ok = 0; ok < 3; ++ok) {
+      for (int oj = 0; oj < 3; ++oj) {
+        for (int oi = 0; oi < 3; ++oi) {
+          q[ok][oj][oi] = coarse(element_idx, l, m, n, k + D3 * (ok - 1),
+                                 j + D2 * (oj - 1), i + D1 * (oi - 1));
+          qmin = std::min(qmin, q[ok][oj][oi]);
+          qmax = std::max(qmax, q[ok][oj][oi]);
+        }
+      }
+    }
+    const Real fc = q[1][1][1];
+    const Real g1 = q[1][1][2] - q[1][1][0];
+    const Real g2 = q[1][2][1] - q[1][0][1];
+    const Real g3 = q[2][1][1] - q[0][1][1];
+    const Real g12 = (q[1][2][2] - q[1][2][0]) - (q[1][0][2] - q[1][0][0]);
+    const Real g13 = (q[2][1][2] - q[2][1][0]) - (q[0][1][2] - q[0][1][0]);
+    const Real g23 = (q[2][2][1] - q[2][0][1]) - (q[0][2][1] - q[0][0][1]);
+    const Real g123 = ((q[2][2][2] - q[2][2][0]) - (q[2][0][2] - q[2][0][0])) -
+                      ((q[0][2][2] - q[0][2][0]) - (q[0][0][2] - q[0][0][0]));
+
+    Real child[2][2][2];
+    bool bounded = true;
+    for (int ok = 0; ok < 1 + D3; ++ok) {
+      for (int oj = 0; oj < 1 + D2; ++oj) {
+        for (int oi = 0; oi < 1 + D1; ++oi) {
+          const Real s1 = 2 * oi - 1, s2 = 2 * oj - 1, s3 = 2 * ok - 1;
+          child[ok][oj][oi] =
+              fc + (s1 * g1 + s2 * g2 + s3 * g3) / 8.0 +
+              (s1 * s2 * g12 + s1 * s3 * g13 + s2 * s3 * g23) / 64.0 +
+              s1 * s2 * s3 * g123 / 512.0;
+          bounded = bounded && child[ok][oj][oi] >= qmin && child[ok][oj][oi] <= qmax;
+        }
+      }
+    }
+
+    if (!bounded) {
+      // minmod limited slopes per quarter coarse cell, i.e., per child offset
+      const auto minmod = [](const Real a, const Real b) {
+        return 0.5 * (SIGN(a) + SIGN(b)) * std::min(std::abs(a), std::abs(b));
+      };
+      const Real l1 = 0.25 * minmod(fc - q[1][1][0], q[1][1][2] - fc);
+      const Real l2 = 0.25 * minmod(fc - q[1][0][1], q[1][2][1] - fc);
+      const Real l3 = 0.25 * minmod(fc - q[0][1][1], q[2][1][1] - fc);
+      for (int ok = 0; ok < 1 + D3; ++ok) {
+        for (int oj = 0; oj < 1 + D2; ++oj) {
+          for (int oi = 0; oi < 1 + D1; ++oi) {
+            child[ok][oj][oi] =
+                fc + ((2 * oi - 1) * l1 + (2 * oj - 1) * l2 + (2 * ok - 1) * l3);
+          }
+        }
+      }
+    }
+
+    for (int ok = 0; ok < 1 + D3; ++ok) {
+      for (int oj = 0; oj < 1 + D2; ++oj) {
+        for (int oi = 0; oi < 1 + D1; ++oi) {
+          fine(element_idx, l, m, n, fk + ok, fj + oj, fi + oi) = child[ok][oj][oi];
+        }
+      }
+    }
+  }
+};
+
 struct ProlongateInternalAverage {
   static constexpr bool OperationRequired(TopologicalElement fel,
                                           TopologicalElement cel) {
@@ -43,8 +43,8 @@ void Restrict(const StateDescriptor *resolved_packages, const ProResCache_t &cac
     loops::Idx_t subset = Kokkos::subview(cache.buffer_subsets, idx, Kokkos::ALL());
     loops::IdxHost_t subset_h =
         Kokkos::subview(cache.buffer_subsets_h, idx, Kokkos::ALL());
-    restrictor(cache.prores_info, cache.prores_info_h, subset, subset_h, cellbnds,
-               c_cellbnds, cache.buffer_subset_sizes[idx]);
+    restrictor(cache.exec_space, cache.prores_info, cache.prores_info_h, subset,
+               subset_h, cellbnds, c_cellbnds, cache.buffer_subset_sizes[idx]);
   }
 }
 
@@ -58,8 +58,8 @@ void ProlongateShared(const StateDescriptor *resolved_packages,
     loops::Idx_t subset = Kokkos::subview(cache.buffer_subsets, idx, Kokkos::ALL());
     loops::IdxHost_t subset_h =
         Kokkos::subview(cache.buffer_subsets_h, idx, Kokkos::ALL());
-    prolongator(cache.prores_info, cache.prores_info_h, subset, subset_h, cellbnds,
-                c_cellbnds, cache.buffer_subset_sizes[idx]);
+    prolongator(cache.exec_space, cache.prores_info, cache.prores_info_h, subset,
+                subset_h, cellbnds, c_cellbnds, cache.buffer_subset_sizes[idx]);
   }
 }
 
@@ -74,10 +74,20 @@ void ProlongateInternal(const StateDescriptor *resolved_packages,
     loops::Idx_t subset = Kokkos::subview(cache.buffer_subsets, idx, Kokkos::ALL());
     loops::IdxHost_t subset_h =
         Kokkos::subview(cache.buffer_subsets_h, idx, Kokkos::ALL());
-    internal_prolongator(cache.prores_info, cache.prores_info_h, subset, subset_h,
-                         cellbnds, c_cellbnds, cache.buffer_subset_sizes[idx]);
+    internal_prolongator(cache.exec_space, cache.prores_info, cache.prores_info_h,
+                         subset, subset_h, cellbnds, c_cellbnds,
+                         cache.buffer_subset_sizes[idx]);
   }
 }
 
+bool RestrictsByAverage(const StateDescriptor *resolved_packages,
+                        const ProResCache_t &cache) {
+  const auto &ref_func_map = resolved_packages->RefinementFncsToIDs();
+  for (const auto &[func, idx] : ref_func_map) {
+    if (cache.buffer_subset_sizes[idx] > 0 && !func.restricts_by_average) return false;
+  }
+  return true;
+}
+
 } // namespace refinement
 } // namespace parthenon
@@ -21,11 +21,12 @@
 #define PROLONG_RESTRICT_PROLONG_RESTRICT_HPP_
 
 #include <algorithm>
-#include <functional> // std::function
-#include <string>     // std::string
-#include <tuple>      // std::tuple
-#include <typeinfo>   // typeid
-#include <utility>    // std::forward
+#include <functional>  // std::function
+#include <string>      // std::string
+#include <tuple>       // std::tuple
+#include <type_traits> // std::is_same
+#include <typeinfo>    // typeid
+#include <utility>     // std::forward
 #include <vector>
 
 #include "bvals/comms/bvals_in_one.hpp" // for buffercache_t
@@ -55,6 +56,11 @@ void ProlongateInternal(const StateDescriptor *resolved_packages,
                         const ProResCache_t &cache, const IndexShape &cellbnds,
                         const IndexShape &c_cellbnds);
 
+// True if every buffer in cache is restricted with refinement_ops::RestrictAverage,
+// which can then be applied by the kernel that packs the buffers instead of by Restrict
+bool RestrictsByAverage(const StateDescriptor *resolved_packages,
+                        const ProResCache_t &cache);
+
 // std::function closures for the top-level restriction functions The
 // existence of host/device overloads here allows us to avoid a
 // deep-copy in the per-meshblock
@@ -64,17 +70,19 @@ void ProlongateInternal(const StateDescriptor *resolved_packages,
 // machinery, the info_h only overload will go away.
 
 using Restrictor_t = std::function<void(
-    const ProResInfoArr_t &, const ProResInfoArrHost_t &, const loops::Idx_t &,
-    const loops::IdxHost_t &, const IndexShape &, const IndexShape &, const std::size_t)>;
-using RestrictorHost_t =
-    std::function<void(const ProResInfoArrHost_t &, const loops::IdxHost_t &,
-                       const IndexShape &, const IndexShape &, const std::size_t)>;
+    const DevExecSpace &, const ProResInfoArr_t &, const ProResInfoArrHost_t &,
+    const loops::Idx_t &, const loops::IdxHost_t &, const IndexShape &,
+    const IndexShape &, const std::size_t)>;
+using RestrictorHost_t = std::function<void(
+    const DevExecSpace &, const ProResInfoArrHost_t &, const loops::IdxHost_t &,
+    const IndexShape &, const IndexShape &, const std::size_t)>;
 using Prolongator_t = std::function<void(
-    const ProResInfoArr_t &, const ProResInfoArrHost_t &, const loops::Idx_t &,
-    const loops::IdxHost_t &, const IndexShape &, const IndexShape &, const std::size_t)>;
-using ProlongatorHost_t =
-    std::function<void(const ProResInfoArrHost_t &, const loops::IdxHost_t &,
-                       const IndexShape &, const IndexShape &, const std::size_t)>;
+    const DevExecSpace &, const ProResInfoArr_t &, const ProResInfoArrHost_t &,
+    const loops::Idx_t &, const loops::IdxHost_t &, const IndexShape &,
+    const IndexShape &, const std::size_t)>;
+using ProlongatorHost_t = std::function<void(
+    const DevExecSpace &, const ProResInfoArrHost_t &, const loops::IdxHost_t &,
+    const IndexShape &, const IndexShape &, const std::size_t)>;
 
 // Container struct owning refinement functions/closures.
 // this container needs to be uniquely hashable, and always the same
@@ -98,52 +106,56 @@ struct RefinementFunctions_t {
         std::string(typeid(InternalProlongationOp).name());
 
     RefinementFunctions_t funcs(label);
-    funcs.restrictor = [](const ProResInfoArr_t &info, const ProResInfoArrHost_t &info_h,
-                          const loops::Idx_t &idxs, const loops::IdxHost_t &idxs_h,
-                          const IndexShape &cellbnds, const IndexShape &c_cellbnds,
-                          const std::size_t nbuffers) {
+    funcs.restricts_by_average =
+        std::is_same<RestrictionOp, refinement_ops::RestrictAverage>::value;
+    funcs.restrictor = [](const DevExecSpace &exec_space, const ProResInfoArr_t &info,
+                          const ProResInfoArrHost_t &info_h, const loops::Idx_t &idxs,
+                          const loops::IdxHost_t &idxs_h, const IndexShape &cellbnds,
+                          const IndexShape &c_cellbnds, const std::size_t nbuffers) {
       loops::DoProlongationRestrictionOp<RestrictionOp>(
-          cellbnds, info, info_h, idxs, idxs_h, cellbnds, c_cellbnds,
+          cellbnds, exec_space, info, info_h, idxs, idxs_h, cellbnds, c_cellbnds,
           RefinementOp_t::Restriction, nbuffers);
     };
-    funcs.restrictor_host = [](const ProResInfoArrHost_t &info_h,
+    funcs.restrictor_host = [](const DevExecSpace &exec_space,
+                               const ProResInfoArrHost_t &info_h,
                                const loops::IdxHost_t &idxs_h, const IndexShape &cellbnds,
                                const IndexShape &c_cellbnds, const std::size_t nbuffers) {
       loops::DoProlongationRestrictionOp<RestrictionOp>(
-          cellbnds, info_h, idxs_h, cellbnds, c_cellbnds, RefinementOp_t::Restriction,
-          nbuffers);
+          cellbnds, exec_space, info_h, idxs_h, cellbnds, c_cellbnds,
+          RefinementOp_t::Restriction, nbuffers);
     };
-    funcs.prolongator = [](const ProResInfoArr_t &info, const ProResInfoArrHost_t &info_h,
-                           const loops::Idx_t &idxs, const loops::IdxHost_t &idxs_h,
-                           const IndexShape &cellbnds, const IndexShape &c_cellbnds,
-                           const std::size_t nbuffers) {
+    funcs.prolongator = [](const DevExecSpace &exec_space, const ProResInfoArr_t &info,
+                           const ProResInfoArrHost_t &info_h, const loops::Idx_t &idxs,
+                           const loops::IdxHost_t &idxs_h, const IndexShape &cellbnds,
+                           const IndexShape &c_cellbnds, const std::size_t nbuffers) {
       loops::DoProlongationRestrictionOp<ProlongationOp>(
-          cellbnds, info, info_h, idxs, idxs_h, cellbnds, c_cellbnds,
+          cellbnds, exec_space, info, info_h, idxs, idxs_h, cellbnds, c_cellbnds,
           RefinementOp_t::Prolongation, nbuffers);
     };
-    funcs.prolongator_host = [](const ProResInfoArrHost_t &info_h,
+    funcs.prolongator_host = [](const DevExecSpace &exec_space,
+                                const ProResInfoArrHost_t &info_h,
                                 const loops::IdxHost_t &idxs_h,
                                 const IndexShape &cellbnds, const IndexShape &c_cellbnds,
                                 const std::size_t nbuffers) {
       loops::DoProlongationRestrictionOp<ProlongationOp>(
-          cellbnds, info_h, idxs_h, cellbnds, c_cellbnds, RefinementOp_t::Prolongation,
-          nbuffers);
+          cellbnds, exec_space, info_h, idxs_h, cellbnds, c_cellbnds,
+          RefinementOp_t::Prolongation, nbuffers);
     };
     funcs.internal_prolongator =
-        [](const ProResInfoArr_t &info, const ProResInfoArrHost_t &info_h,
-           const loops::Idx_t &idxs, const loops::IdxHost_t &idxs_h,
-           const IndexShape &cellbnds, const IndexShape &c_cellbnds,
-           const std::size_t nbuffers) {
+        [](const DevExecSpace &exec_space, const ProResInfoArr_t &info,
+           const ProResInfoArrHost_t &info_h, const loops::Idx_t &idxs,
+           const loops::IdxHost_t &idxs_h, const IndexShape &cellbnds,
+           const IndexShape &c_cellbnds, const std::size_t nbuffers) {
           loops::DoProlongationRestrictionOp<InternalProlongationOp>(
-              cellbnds, info, info_h, idxs, idxs_h, cellbnds, c_cellbnds,
+              cellbnds, exec_space, info, info_h, idxs, idxs_h, cellbnds, c_cellbnds,
               RefinementOp_t::Prolongation, nbuffers);
         };
     funcs.internal_prolongator_host =
-        [](const ProResInfoArrHost_t &info_h, const loops::IdxHost_t &idxs_h,
-           const IndexShape &cellbnds, const IndexShape &c_cellbnds,
-           const std::size_t nbuffers) {
+        [](const DevExecSpace &exec_space, const ProResInfoArrHost_t &info_h,
+           const loops::IdxHost_t &idxs_h, const IndexShape &cellbnds,
+           const IndexShape &c_cellbnds, const std::size_t nbuffers) {
           loops::DoProlongationRestrictionOp<InternalProlongationOp>(
-              cellbnds, info_h, idxs_h, cellbnds, c_cellbnds,
+              cellbnds, exec_space, info_h, idxs_h, cellbnds, c_cellbnds,
               RefinementOp_t::Prolongation, nbuffers);
         };
     return funcs;
@@ -159,6 +171,7 @@ struct RefinementFunctions_t {
   ProlongatorHost_t prolongator_host;
   Prolongator_t internal_prolongator;
   ProlongatorHost_t internal_prolongator_host;
+  bool restricts_by_average = false;
 
  private:
   // TODO(JMM): This could be a type_info::hash instead of a string,
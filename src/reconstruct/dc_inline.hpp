@@ -74,6 +74,26 @@ DonorCellX3(parthenon::team_mbr_t const &member, const int k, const int j, const
                              [&](const int i) { ql(n, i) = qr(n, i) = q(n, k, j, i); });
   }
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::DonorCellPack()
+//  \brief reconstruct L/R surfaces along XDIR of all variables, and all of their
+//  components, of block b of a SparsePack in the cells il to iu of row (k, j), see
+//  PiecewiseLinearPack
+template <int XDIR, typename TPack>
+KOKKOS_FORCEINLINE_FUNCTION void
+DonorCellPack(parthenon::team_mbr_t const &member, const int b, const int k, const int j,
+              const int il, const int iu, const TPack &q, ScratchPad2D<Real> &ql,
+              ScratchPad2D<Real> &qr) {
+  const int nl = q.GetLowerBound(b);
+  const int nvar = q.GetUpperBound(b) - nl + 1;
+  constexpr int di = (XDIR == 1);
+  Kokkos::parallel_for(Kokkos::TeamThreadRange<>(member, nvar), [&](const int n) {
+    const auto &var = q(b, nl + n);
+    Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(member, il, iu + 1),
+                         [&](const int i) { ql(n, i + di) = qr(n, i) = var(k, j, i); });
+  });
+}
 } // namespace parthenon
 
 #endif // RECONSTRUCT_DC_INLINE_HPP_
@@ -29,6 +29,7 @@
 
 #include "coordinates/coordinates.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/simd_loops.hpp"
 
 namespace parthenon {
 
@@ -110,6 +111,31 @@ PiecewiseLinearX1(parthenon::team_mbr_t const &member, const int k, const int j,
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PiecewiseLinearX1()
+//  \brief Same as above for the cells of the lanes of a par_for_simd, with the uniform
+//  mesh limiter.  q, ql and qr point to the elements of cell lanes.i() of rows that are
+//  contiguous in i; ql is set at i + 1 and qr at i, as above.
+KOKKOS_INLINE_FUNCTION void PiecewiseLinearX1(const SimdLanes &lanes,
+                                              const Coordinates_t &coords, const Real *q,
+                                              Real *ql, Real *qr) {
+  const SimdReal qc = lanes.Load(q);
+  const SimdReal dql = qc - lanes.Load(q - 1);
+  const SimdReal dqr = lanes.Load(q + 1) - qc;
+
+  const SimdReal dq2 = dql * dqr;
+  SimdReal dqm = SimdReal(2.0) * dq2 / (dql + dqr);
+  Kokkos::Experimental::where(dq2 <= SimdReal(0.0), dqm) = SimdReal(0.0);
+
+  const SimdReal xc = lanes.Gather([&](const int i) { return coords.Xc<1>(i); });
+  const SimdReal xfl = lanes.Gather([&](const int i) { return coords.Xf<1>(i); });
+  const SimdReal xfr = lanes.Gather([&](const int i) { return coords.Xf<1>(i + 1); });
+  const SimdReal dxf = lanes.Gather([&](const int i) { return coords.Dxf<1>(i); });
+  // Mignone equation 30
+  lanes.Store(qc + ((xfr - xc) / dxf) * dqm, ql + 1);
+  lanes.Store(qc - ((xc - xfl) / dxf) * dqm, qr);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn Reconstruction::PiecewiseLinearX2()
 //  \brief
@@ -253,6 +279,78 @@ PiecewiseLinearX3(parthenon::team_mbr_t const &member, const int k, const int j,
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PiecewiseLinear()
+//  \brief reconstruction of variable n in cell (k, j, i) of a StencilTile along XDIR
+//  with the simplified van Leer limiter of PiecewiseLinearX1/2/3.  qm is set to the
+//  value at the lower face of the cell and qp to the one at its upper face, i.e., qr(i)
+//  and ql(i + 1) of PiecewiseLinearX1.  The tile needs a halo of at least one cell
+//  along XDIR, so that all directions can be reconstructed from a single load.
+template <int XDIR, typename Tile>
+KOKKOS_INLINE_FUNCTION void PiecewiseLinear(const Coordinates_t &coords, const Tile &q,
+                                            const int n, const int k, const int j,
+                                            const int i, Real &qm, Real &qp) {
+  const int dk = (XDIR == 3);
+  const int dj = (XDIR == 2);
+  const int di = (XDIR == 1);
+  const Real qc = q(n, k, j, i);
+  const Real dql = qc - q(n, k - dk, j - dj, i - di);
+  const Real dqr = q(n, k + dk, j + dj, i + di) - qc;
+  const Real dq2 = dql * dqr;
+  const Real dqm = dq2 <= 0.0 ? 0.0 : 2.0 * dq2 / (dql + dqr);
+  const int x = (XDIR == 1) ? i : ((XDIR == 2) ? j : k);
+  qp = qc + ((coords.Xf<XDIR>(x + 1) - coords.Xc<XDIR>(x)) / coords.Dxf<XDIR>(x)) * dqm;
+  qm = qc - ((coords.Xc<XDIR>(x) - coords.Xf<XDIR>(x)) / coords.Dxf<XDIR>(x)) * dqm;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PiecewiseLinearPack()
+//  \brief reconstruction along XDIR of all variables, and all of their components, of
+//  block b of a SparsePack in the cells il to iu of row (k, j), with the simplified van
+//  Leer limiter of PiecewiseLinearX1/2/3.  Component n of the block goes to row n of the
+//  scratch pads, which are set as by PiecewiseLinearX1/2/3, and the limited slopes are
+//  kept in dqm.  Each thread of the team handles whole variables, so the indexing into
+//  the pack is done once per variable and row, and no barriers are needed in between.
+//  The caller needs a team_barrier before reading the scratch pads.
+template <int XDIR, typename TPack>
+KOKKOS_INLINE_FUNCTION void
+PiecewiseLinearPack(parthenon::team_mbr_t const &member, const int b, const int k,
+                    const int j, const int il, const int iu, const TPack &q,
+                    ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr,
+                    ScratchPad2D<Real> &dqm) {
+  const int nl = q.GetLowerBound(b);
+  const int nvar = q.GetUpperBound(b) - nl + 1;
+  const auto &coords = q.GetCoordinates(b);
+  const int dk = (XDIR == 3);
+  const int dj = (XDIR == 2);
+  const int di = (XDIR == 1);
+  // the faces in j or k are the same for the whole row (and unused for XDIR == 1)
+  const int x = (XDIR == 2) ? j : k;
+  const Real dxp = (coords.Xf<XDIR>(x + 1) - coords.Xc<XDIR>(x)) / coords.Dxf<XDIR>(x);
+  const Real dxm = (coords.Xc<XDIR>(x) - coords.Xf<XDIR>(x)) / coords.Dxf<XDIR>(x);
+  Kokkos::parallel_for(Kokkos::TeamThreadRange<>(member, nvar), [&](const int n) {
+    const auto &var = q(b, nl + n);
+    Kokkos::parallel_for(
+        Kokkos::ThreadVectorRange<>(member, il, iu + 1), [&](const int i) {
+          const Real qc = var(k, j, i);
+          const Real dql = qc - var(k - dk, j - dj, i - di);
+          const Real dqr = var(k + dk, j + dj, i + di) - qc;
+          const Real dq2 = dql * dqr;
+          dqm(n, i) = dq2 <= 0.0 ? 0.0 : 2.0 * dq2 / (dql + dqr);
+          if constexpr (XDIR == 1) {
+            // Mignone equation 30
+            const Real dxf = coords.Dxf<1>(i);
+            const Real xc = coords.Xc<1>(i);
+            ql(n, i + 1) = qc + ((coords.Xf<1>(i + 1) - xc) / dxf) * dqm(n, i);
+            qr(n, i) = qc - ((xc - coords.Xf<1>(i)) / dxf) * dqm(n, i);
+          } else {
+            ql(n, i) = qc + dxp * dqm(n, i);
+            qr(n, i) = qc - dxm * dqm(n, i);
+          }
+        });
+  });
+}
+
 } // namespace parthenon
 
 #endif // RECONSTRUCT_PLM_INLINE_HPP_
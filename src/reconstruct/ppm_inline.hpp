@@ -0,0 +1,110 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file ppm_inline.hpp
+//  \brief piecewise parabolic reconstruction for uniform meshes
+
+// REFERENCES:
+// (CW) P. Colella, P. R. Woodward, "The Piecewise Parabolic Method (PPM) for
+// gas-dynamical simulations", JCP, 54, 174 (1984)
+//========================================================================================
+#ifndef RECONSTRUCT_PPM_INLINE_HPP_
+#define RECONSTRUCT_PPM_INLINE_HPP_
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PPM()
+//  \brief reconstruction of the cell of q2 from the stencil q0 to q4 centered on it.  qm
+//  is set to the value at the lower face of the cell and qp to the one at its upper
+//  face.  The face values are kept within the range of the two cells next to them and
+//  the parabola is made monotone in the cell.
+KOKKOS_FORCEINLINE_FUNCTION void PPM(const Real q0, const Real q1, const Real q2,
+                                     const Real q3, const Real q4, Real &qm, Real &qp) {
+  // fourth order face values (CW eq. 1.6 for uniform meshes)
+  qm = (7.0 * (q1 + q2) - (q0 + q3)) / 12.0;
+  qp = (7.0 * (q2 + q3) - (q1 + q4)) / 12.0;
+  qm = Kokkos::max(Kokkos::min(q1, q2), Kokkos::min(qm, Kokkos::max(q1, q2)));
+  qp = Kokkos::max(Kokkos::min(q2, q3), Kokkos::min(qp, Kokkos::max(q2, q3)));
+
+  // monotonicity constraints (CW eq. 1.10)
+  if ((qp - q2) * (q2 - qm) <= 0.0) {
+    qm = q2;
+    qp = q2;
+    return;
+  }
+  const Real dq = qp - qm;
+  const Real q6 = 6.0 * (q2 - 0.5 * (qm + qp));
+  if (dq * q6 > dq * dq) {
+    qm = 3.0 * q2 - 2.0 * qp;
+  } else if (dq * q6 < -dq * dq) {
+    qp = 3.0 * q2 - 2.0 * qm;
+  }
+}
+
+namespace recon_impl {
+template <int XDIR, typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+PPMRow(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+       const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  constexpr int dk = (XDIR == 3);
+  constexpr int dj = (XDIR == 2);
+  constexpr int di = (XDIR == 1);
+  const int nu = q.GetDim(4) - 1;
+  for (int n = 0; n <= nu; ++n) {
+    if (!q.IsAllocated(n)) continue;
+    parthenon::par_for_inner(member, il, iu, [&](const int i) {
+      PPM(q(n, k - 2 * dk, j - 2 * dj, i - 2 * di), q(n, k - dk, j - dj, i - di),
+          q(n, k, j, i), q(n, k + dk, j + dj, i + di),
+          q(n, k + 2 * dk, j + 2 * dj, i + 2 * di), qr(n, i), ql(n, i + di));
+    });
+  }
+}
+} // namespace recon_impl
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PPMX1()
+//  \brief reconstruct L/R surfaces of the i-th cells, with the same layout of ql and qr
+//  as PiecewiseLinearX1.  Needs two ghost cells beyond il and iu.
+template <typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+PPMX1(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+      const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  recon_impl::PPMRow<X1DIR>(member, k, j, il, iu, q, ql, qr);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PPMX2()
+//  \brief
+template <typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+PPMX2(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+      const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  recon_impl::PPMRow<X2DIR>(member, k, j, il, iu, q, ql, qr);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::PPMX3()
+//  \brief
+template <typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+PPMX3(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+      const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  recon_impl::PPMRow<X3DIR>(member, k, j, il, iu, q, ql, qr);
+}
+
+} // namespace parthenon
+
+#endif // RECONSTRUCT_PPM_INLINE_HPP_
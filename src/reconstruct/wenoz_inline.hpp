@@ -0,0 +1,124 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+//! \file wenoz_inline.hpp
+//  \brief fifth order WENO-Z reconstruction for uniform meshes
+
+// REFERENCES:
+// (Borges) R. Borges, M. Carmona, B. Costa, W. S. Don, "An improved weighted essentially
+// non-oscillatory scheme for hyperbolic conservation laws", JCP, 227, 3191 (2008)
+//========================================================================================
+#ifndef RECONSTRUCT_WENOZ_INLINE_HPP_
+#define RECONSTRUCT_WENOZ_INLINE_HPP_
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::WENO5Z()
+//  \brief reconstruction of the cell of q2 from the stencil q0 to q4 centered on it.  qm
+//  is set to the value at the lower face of the cell and qp to the one at its upper
+//  face.  The smoothness indicators of the three substencils are shared by both faces.
+KOKKOS_FORCEINLINE_FUNCTION void WENO5Z(const Real q0, const Real q1, const Real q2,
+                                        const Real q3, const Real q4, Real &qm,
+                                        Real &qp) {
+  constexpr Real eps = sizeof(Real) > sizeof(float) ? 1e-100 : 1e-30;
+  constexpr Real thirteen_twelfths = 13.0 / 12.0;
+
+  // smoothness indicators (Borges eq. 9) and their global counterpart (eq. 25)
+  Real a = q0 - 2.0 * q1 + q2;
+  Real b = q0 - 4.0 * q1 + 3.0 * q2;
+  const Real beta0 = thirteen_twelfths * a * a + 0.25 * b * b;
+  a = q1 - 2.0 * q2 + q3;
+  b = q1 - q3;
+  const Real beta1 = thirteen_twelfths * a * a + 0.25 * b * b;
+  a = q2 - 2.0 * q3 + q4;
+  b = 3.0 * q2 - 4.0 * q3 + q4;
+  const Real beta2 = thirteen_twelfths * a * a + 0.25 * b * b;
+  const Real tau5 = Kokkos::abs(beta0 - beta2);
+  const Real z0 = 1.0 + tau5 / (beta0 + eps);
+  const Real z1 = 1.0 + tau5 / (beta1 + eps);
+  const Real z2 = 1.0 + tau5 / (beta2 + eps);
+
+  // upper face, with the linear weights 1/10, 6/10 and 3/10 of the substencils
+  Real w0 = 0.1 * z0;
+  Real w1 = 0.6 * z1;
+  Real w2 = 0.3 * z2;
+  qp = (w0 * (2.0 * q0 - 7.0 * q1 + 11.0 * q2) + w1 * (-q1 + 5.0 * q2 + 2.0 * q3) +
+        w2 * (2.0 * q2 + 5.0 * q3 - q4)) /
+       (6.0 * (w0 + w1 + w2));
+
+  // lower face, mirrored
+  w0 = 0.3 * z0;
+  w1 = 0.6 * z1;
+  w2 = 0.1 * z2;
+  qm = (w0 * (-q0 + 5.0 * q1 + 2.0 * q2) + w1 * (2.0 * q1 + 5.0 * q2 - q3) +
+        w2 * (11.0 * q2 - 7.0 * q3 + 2.0 * q4)) /
+       (6.0 * (w0 + w1 + w2));
+}
+
+namespace recon_impl {
+template <int XDIR, typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+WENO5ZRow(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+          const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  constexpr int dk = (XDIR == 3);
+  constexpr int dj = (XDIR == 2);
+  constexpr int di = (XDIR == 1);
+  const int nu = q.GetDim(4) - 1;
+  for (int n = 0; n <= nu; ++n) {
+    if (!q.IsAllocated(n)) continue;
+    parthenon::par_for_inner(member, il, iu, [&](const int i) {
+      WENO5Z(q(n, k - 2 * dk, j - 2 * dj, i - 2 * di), q(n, k - dk, j - dj, i - di),
+             q(n, k, j, i), q(n, k + dk, j + dj, i + di),
+             q(n, k + 2 * dk, j + 2 * dj, i + 2 * di), qr(n, i), ql(n, i + di));
+    });
+  }
+}
+} // namespace recon_impl
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::WENO5ZX1()
+//  \brief reconstruct L/R surfaces of the i-th cells, with the same layout of ql and qr
+//  as PiecewiseLinearX1.  Needs two ghost cells beyond il and iu.
+template <typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+WENO5ZX1(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+         const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  recon_impl::WENO5ZRow<X1DIR>(member, k, j, il, iu, q, ql, qr);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::WENO5ZX2()
+//  \brief
+template <typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+WENO5ZX2(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+         const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  recon_impl::WENO5ZRow<X2DIR>(member, k, j, il, iu, q, ql, qr);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Reconstruction::WENO5ZX3()
+//  \brief
+template <typename T>
+KOKKOS_FORCEINLINE_FUNCTION void
+WENO5ZX3(parthenon::team_mbr_t const &member, const int k, const int j, const int il,
+         const int iu, const T &q, ScratchPad2D<Real> &ql, ScratchPad2D<Real> &qr) {
+  recon_impl::WENO5ZRow<X3DIR>(member, k, j, il, iu, q, ql, qr);
+}
+
+} // namespace parthenon
+
+#endif // RECONSTRUCT_WENOZ_INLINE_HPP_
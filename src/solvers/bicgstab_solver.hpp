@@ -13,6 +13,7 @@
 #ifndef SOLVERS_BICGSTAB_SOLVER_HPP_
 #define SOLVERS_BICGSTAB_SOLVER_HPP_
 
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -36,6 +37,15 @@ struct BiCGSTABParams {
   Real residual_tolerance = 1.e-12;
   Real restart_threshold = -1.0;
   bool precondition = true;
+  // Use the pipelined variant, see AddPipelinedTasks
+  bool pipelined = false;
+  // Parameters of the multigrid preconditioner, whose correction may be computed with
+  // reduced precision communication (see MGParams::comm_encoding) since the residuals
+  // of the outer iteration are computed in Real precision
+  MGParams mg_params;
+  // Record the residual history of every solve, and the time spent in the phases of
+  // the v-cycles of the preconditioner (see SolverTelemetry)
+  bool telemetry = false;
 };
 
 // The equations class must include a template method
@@ -45,6 +55,13 @@ struct BiCGSTABParams {
 //
 // that takes a field associated with x_t and applies
 // the matrix A to it and stores the result in y_t.
+//
+// With a vector valued x (and rhs), i.e., a non-empty shape, each component is the
+// solution of an independent system with the same A, e.g., an ensemble of right hand
+// sides.  The components are iterated together, sharing kernels, boundary exchanges and
+// reductions, but every component has its own Krylov coefficients.  The residual that
+// is checked against the tolerance is the rms over all components.  The pipelined
+// variant only supports a single component.
 template <class x, class rhs, class equations>
 class BiCGSTABSolver {
  public:
@@ -56,12 +73,21 @@ class BiCGSTABSolver {
   PARTHENON_INTERNALSOLVERVARIABLE(x, r);
   PARTHENON_INTERNALSOLVERVARIABLE(x, p);
   PARTHENON_INTERNALSOLVERVARIABLE(x, u);
+  PARTHENON_INTERNALSOLVERVARIABLE(x, w);
+  PARTHENON_INTERNALSOLVERVARIABLE(x, z);
+  PARTHENON_INTERNALSOLVERVARIABLE(x, q);
+  PARTHENON_INTERNALSOLVERVARIABLE(x, y);
 
   BiCGSTABSolver(StateDescriptor *pkg, BiCGSTABParams params_in,
                  equations eq_in = equations(), std::vector<int> shape = {})
-      : preconditioner(pkg, MGParams(), eq_in, shape), params_(params_in),
-        iter_counter(0), eqs_(eq_in) {
+      : preconditioner(pkg, PreconditionerParams(params_in), eq_in, shape),
+        params_(params_in),
+        iter_counter(0), ncomp_(NumComponents(shape)), eqs_(eq_in) {
     using namespace refinement_ops;
+    PARTHENON_REQUIRE_THROWS(!params_.pipelined || ncomp_ == 1,
+                             "Pipelined BiCGSTAB only supports a single component.");
+    for (auto *red : {&rhat0v, &rhat0r, &ts, &tt})
+      red->val.resize(ncomp_);
     auto mu = Metadata({Metadata::Cell, Metadata::Independent, Metadata::FillGhost,
                         Metadata::WithFluxes, Metadata::GMGRestrict},
                        shape);
@@ -76,13 +102,24 @@ class BiCGSTABSolver {
     pkg->AddField(t::name(), m_no_ghost);
     pkg->AddField(r::name(), m_no_ghost);
     pkg->AddField(p::name(), m_no_ghost);
+    if (params_.pipelined) {
+      pkg->AddField(w::name(), m_no_ghost);
+      pkg->AddField(z::name(), m_no_ghost);
+      pkg->AddField(q::name(), m_no_ghost);
+      pkg->AddField(y::name(), m_no_ghost);
+    }
   }
 
   TaskID AddTasks(TaskList &tl, TaskID dependence, Mesh *pmesh, const int partition) {
+    if (params_.pipelined) return AddPipelinedTasks(tl, dependence, pmesh, partition);
     using namespace utils;
     TaskID none;
     auto &md = pmesh->mesh_data.GetOrAdd("base", partition);
     iter_counter = 0;
+    preconditioner.ResetTelemetry(pmesh);
+    if (params_.precondition) {
+      dependence = preconditioner.AddSetupTasks(tl, dependence, partition, pmesh);
+    }
 
     // Initialization: x <- 0, r <- rhs, rhat0 <- rhs,
     // rhat0r_old <- (rhat0, r), p <- r, u <- 0
@@ -91,16 +128,12 @@ class BiCGSTABSolver {
     auto copy_r = tl.AddTask(dependence, CopyData<rhs, r>, md);
     auto copy_p = tl.AddTask(dependence, CopyData<rhs, p>, md);
     auto copy_rhat0 = tl.AddTask(dependence, CopyData<rhs, rhat0>, md);
-    auto get_rhat0r_init = DotProduct<rhat0, r>(dependence, tl, &rhat0r, md);
+    auto get_rhat0r_init = ComponentDotProduct<rhat0, r>(dependence, tl, &rhat0r, md);
     auto initialize = tl.AddTask(
         TaskQualifier::once_per_region | TaskQualifier::local_sync,
         zero_x | zero_u_init | copy_r | copy_p | copy_rhat0 | get_rhat0r_init,
         [](BiCGSTABSolver *solver) {
           solver->rhat0r_old = solver->rhat0r.val;
-          solver->rhat0r.val = 0.0;
-          solver->rhat0v.val = 0.0;
-          solver->ts.val = 0.0;
-          solver->tt.val = 0.0;
           solver->residual.val = 0.0;
           return TaskStatus::complete;
         },
@@ -130,14 +163,14 @@ class BiCGSTABSolver {
     auto get_v = eqs_.template Ax<u, v>(itl, comm, md);
 
     // 3. rhat0v <- (rhat0, v)
-    auto get_rhat0v = DotProduct<rhat0, v>(get_v, itl, &rhat0v, md);
+    auto get_rhat0v = ComponentDotProduct<rhat0, v>(get_v, itl, &rhat0v, md);
 
     // 4. h <- x + alpha u (alpha = rhat0r_old / rhat0v)
     auto correct_h = itl.AddTask(
         get_rhat0v,
         [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
-          Real alpha = solver->rhat0r_old / solver->rhat0v.val;
-          return AddFieldsAndStore<x, u, h>(md, 1.0, alpha);
+          return AddFieldsAndStoreComponents<x, u, h>(md, solver->Ones(),
+                                                      solver->Alpha(1.0));
         },
         this, md);
 
@@ -145,8 +178,8 @@ class BiCGSTABSolver {
     auto correct_s = itl.AddTask(
         get_rhat0v,
         [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
-          Real alpha = solver->rhat0r_old / solver->rhat0v.val;
-          return AddFieldsAndStore<r, v, s>(md, 1.0, -alpha);
+          return AddFieldsAndStoreComponents<r, v, s>(md, solver->Ones(),
+                                                      solver->Alpha(-1.0));
         },
         this, md);
 
@@ -179,15 +212,15 @@ class BiCGSTABSolver {
     auto get_t = eqs_.template Ax<u, t>(itl, pre_t_comm, md);
 
     // 8. omega <- (t,s) / (t,t)
-    auto get_ts = DotProduct<t, s>(get_t, itl, &ts, md);
-    auto get_tt = DotProduct<t, t>(get_t, itl, &tt, md);
+    auto get_ts = ComponentDotProduct<t, s>(get_t, itl, &ts, md);
+    auto get_tt = ComponentDotProduct<t, t>(get_t, itl, &tt, md);
 
     // 9. x <- h + omega u
     auto correct_x = itl.AddTask(
         TaskQualifier::local_sync, get_tt | get_ts,
         [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
-          Real omega = solver->ts.val / solver->tt.val;
-          return AddFieldsAndStore<h, u, x>(md, 1.0, omega);
+          return AddFieldsAndStoreComponents<h, u, x>(md, solver->Ones(),
+                                                      solver->Omega(1.0));
         },
         this, md);
 
@@ -195,8 +228,8 @@ class BiCGSTABSolver {
     auto correct_r = itl.AddTask(
         get_tt | get_ts,
         [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
-          Real omega = solver->ts.val / solver->tt.val;
-          return AddFieldsAndStore<s, t, r>(md, 1.0, -omega);
+          return AddFieldsAndStoreComponents<s, t, r>(md, solver->Ones(),
+                                                      solver->Omega(-1.0));
         },
         this, md);
 
@@ -214,19 +247,16 @@ class BiCGSTABSolver {
         this, pmesh);
 
     // 11. rhat0r <- (rhat0, r)
-    auto get_rhat0r = DotProduct<rhat0, r>(correct_r, itl, &rhat0r, md);
+    auto get_rhat0r = ComponentDotProduct<rhat0, r>(correct_r, itl, &rhat0r, md);
 
     // 12. beta <- rhat0r / rhat0r_old * alpha / omega
     // 13. p <- r + beta * (p - omega * v)
     auto update_p = itl.AddTask(
         TaskQualifier::local_sync, get_rhat0r | get_res2,
         [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
-          Real alpha = solver->rhat0r_old / solver->rhat0v.val;
-          Real omega = solver->ts.val / solver->tt.val;
-          Real beta = solver->rhat0r.val / solver->rhat0r_old * alpha / omega;
-          AddFieldsAndStore<p, v, p>(md, 1.0, -omega);
-          return AddFieldsAndStore<r, p, p>(md, 1.0, beta);
-          return TaskStatus::complete;
+          const auto ones = solver->Ones();
+          AddFieldsAndStoreComponents<p, v, p>(md, ones, solver->Omega(-1.0));
+          return AddFieldsAndStoreComponents<r, p, p>(md, ones, solver->Beta());
         },
         this, md);
 
@@ -240,14 +270,11 @@ class BiCGSTABSolver {
           Real rms_res = std::sqrt(solver->residual.val / pmesh->GetTotalCells());
           solver->final_residual = rms_res;
           solver->final_iteration = solver->iter_counter;
+          solver->preconditioner.MutableTelemetry()->AddIteration(rms_res);
           if (rms_res < res_tol) {
             return TaskStatus::complete;
           }
           solver->rhat0r_old = solver->rhat0r.val;
-          solver->rhat0r.val = 0.0;
-          solver->rhat0v.val = 0.0;
-          solver->ts.val = 0.0;
-          solver->tt.val = 0.0;
           solver->residual.val = 0.0;
           return TaskStatus::iterate;
         },
@@ -256,21 +283,239 @@ class BiCGSTABSolver {
     return solver_id;
   }
 
+  // Pipelined BiCGSTAB (p-BiCGStab, Cools & Vanroose 2017) for the right preconditioned
+  // system A M xhat = rhs, x = M xhat.  The six dot products of an iteration are
+  // gathered into two non-blocking reductions, each of which is overlapped with the
+  // application of A M (a v-cycle, a boundary exchange and Ax) that does not depend on
+  // it, instead of six reductions that each stall the iteration.  The price is four
+  // more vectors, a slightly less stable recurrence and one more v-cycle at the end to
+  // get x from xhat.  The preconditioner has to be the same linear operator in every
+  // iteration, i.e., the v-cycle is started from zero.
+  TaskID AddPipelinedTasks(TaskList &tl, TaskID dependence, Mesh *pmesh,
+                           const int partition) {
+    using namespace utils;
+    TaskID none;
+    auto &md = pmesh->mesh_data.GetOrAdd("base", partition);
+    iter_counter = 0;
+    preconditioner.ResetTelemetry(pmesh);
+    if (params_.precondition) {
+      dependence = preconditioner.AddSetupTasks(tl, dependence, partition, pmesh);
+    }
+
+    // Initialization: xhat <- 0, r <- rhs, rhat0 <- rhs, p, s, z, v <- 0, w <- A M r,
+    // t <- A M w, alpha <- (rhat0, r) / (rhat0, w)
+    auto zero_x = tl.AddTask(dependence, SetToZero<x>, md);
+    auto zero_p = tl.AddTask(dependence, SetToZero<p>, md);
+    auto zero_s = tl.AddTask(dependence, SetToZero<s>, md);
+    auto zero_z = tl.AddTask(dependence, SetToZero<z>, md);
+    auto zero_v = tl.AddTask(dependence, SetToZero<v>, md);
+    auto copy_r = tl.AddTask(dependence, CopyData<rhs, r>, md);
+    auto copy_rhat0 = tl.AddTask(dependence, CopyData<rhs, rhat0>, md);
+    auto get_w =
+        AddPreconditionedAxTasks<r, w>(tl, copy_r | copy_rhat0, pmesh, partition);
+    auto get_t = AddPreconditionedAxTasks<w, t>(tl, get_w, pmesh, partition);
+    auto get_dots_init = AddRhat0DotsTasks(tl, get_w | zero_s | zero_z, md);
+    auto initialize = tl.AddTask(
+        TaskQualifier::once_per_region | TaskQualifier::local_sync,
+        zero_x | zero_p | zero_s | zero_z | zero_v | get_t | get_dots_init,
+        [](BiCGSTABSolver *solver) {
+          const auto &dots = solver->rhat0_dots.val;
+          solver->rhat0r_old = {dots[0]};
+          solver->alpha_ = dots[0] / dots[1];
+          solver->beta_ = 0.0;
+          solver->omega_ = 0.0;
+          solver->residual.val = dots[4];
+          return TaskStatus::complete;
+        },
+        this);
+    tl.AddTask(TaskQualifier::once_per_region, dependence, [&]() {
+      if (Globals::my_rank == 0) printf("# [0] iteration\n# [1] rms-residual\n");
+      return TaskStatus::complete;
+    });
+
+    // BEGIN ITERATIVE TASKS
+    auto [itl, solver_id] = tl.AddSublist(initialize, {1, params_.max_iters});
+
+    // 1. p <- r + beta (p - omega s), s <- w + beta (s - omega z),
+    //    z <- t + beta (z - omega v)
+    auto update_psz = itl.AddTask(
+        none,
+        [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
+          const Real beta = solver->beta_;
+          const Real omega = solver->omega_;
+          AddFieldsAndStore<p, s, p>(md, 1.0, -omega);
+          AddFieldsAndStore<r, p, p>(md, 1.0, beta);
+          AddFieldsAndStore<s, z, s>(md, 1.0, -omega);
+          AddFieldsAndStore<w, s, s>(md, 1.0, beta);
+          AddFieldsAndStore<z, v, z>(md, 1.0, -omega);
+          return AddFieldsAndStore<t, z, z>(md, 1.0, beta);
+        },
+        this, md);
+
+    // 2. q <- r - alpha s, y <- w - alpha z
+    auto update_qy = itl.AddTask(
+        update_psz,
+        [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
+          AddFieldsAndStore<r, s, q>(md, 1.0, -solver->alpha_);
+          return AddFieldsAndStore<w, z, y>(md, 1.0, -solver->alpha_);
+        },
+        this, md);
+
+    // 3. start (q, y), (y, y) and meanwhile v <- A M z
+    auto get_qy_yy =
+        MultiDotProduct<DotPair<q, y>, DotPair<y, y>>(update_qy, itl, &qy_yy, md);
+    auto get_v = AddPreconditionedAxTasks<z, v>(itl, update_psz, pmesh, partition);
+
+    // 4. omega <- (q, y) / (y, y), xhat <- xhat + alpha p + omega q, r <- q - omega y
+    auto update_xr = itl.AddTask(
+        get_qy_yy,
+        [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
+          const Real omega = solver->qy_yy.val[0] / solver->qy_yy.val[1];
+          AddFieldsAndStore<x, p, x>(md, 1.0, solver->alpha_);
+          AddFieldsAndStore<x, q, x>(md, 1.0, omega);
+          return AddFieldsAndStore<q, y, r>(md, 1.0, -omega);
+        },
+        this, md);
+
+    // 5. w <- y - omega (t - alpha v)
+    auto update_w = itl.AddTask(
+        get_qy_yy | get_v,
+        [](BiCGSTABSolver *solver, std::shared_ptr<MeshData<Real>> &md) {
+          const Real omega = solver->qy_yy.val[0] / solver->qy_yy.val[1];
+          AddFieldsAndStore<t, v, t>(md, 1.0, -solver->alpha_);
+          return AddFieldsAndStore<y, t, w>(md, 1.0, -omega);
+        },
+        this, md);
+
+    // 6. start (rhat0, r), (rhat0, w), (rhat0, s), (rhat0, z), (r, r) and meanwhile
+    //    t <- A M w
+    auto get_rhat0_dots = AddRhat0DotsTasks(itl, update_xr | update_w, md);
+    auto get_t_iter = AddPreconditionedAxTasks<w, t>(itl, update_w, pmesh, partition);
+
+    // 7. beta <- alpha / omega (rhat0, r) / rhat0r_old,
+    //    alpha <- (rhat0, r) / ((rhat0, w) + beta (rhat0, s) - beta omega (rhat0, z))
+    auto check = itl.AddTask(
+        TaskQualifier::completion | TaskQualifier::once_per_region |
+            TaskQualifier::global_sync,
+        get_rhat0_dots | get_t_iter,
+        [](BiCGSTABSolver *solver, Mesh *pmesh, Real res_tol) {
+          solver->iter_counter++;
+          const auto &dots = solver->rhat0_dots.val;
+          solver->residual.val = dots[4];
+          Real rms_res = std::sqrt(dots[4] / pmesh->GetTotalCells());
+          if (Globals::my_rank == 0) printf("%i %e\n", solver->iter_counter, rms_res);
+          solver->final_residual = rms_res;
+          solver->final_iteration = solver->iter_counter;
+          solver->preconditioner.MutableTelemetry()->AddIteration(rms_res);
+          if (rms_res < res_tol) {
+            return TaskStatus::complete;
+          }
+          const Real omega = solver->qy_yy.val[0] / solver->qy_yy.val[1];
+          const Real beta = solver->alpha_ / omega * dots[0] / solver->rhat0r_old[0];
+          solver->alpha_ = dots[0] / (dots[1] + beta * (dots[2] - omega * dots[3]));
+          solver->beta_ = beta;
+          solver->omega_ = omega;
+          solver->rhat0r_old = {dots[0]};
+          return TaskStatus::iterate;
+        },
+        this, pmesh, params_.residual_tolerance);
+
+    // x <- M xhat
+    if (!params_.precondition) return solver_id;
+    auto set_rhs = tl.AddTask(solver_id, CopyData<x, rhs>, md);
+    auto zero_u = tl.AddTask(solver_id, SetToZero<u>, md);
+    auto precon =
+        preconditioner.AddLinearOperatorTasks(tl, set_rhs | zero_u, partition, pmesh);
+    return tl.AddTask(precon, CopyData<u, x>, md);
+  }
+
   Real GetSquaredResidualSum() const { return residual.val; }
   int GetCurrentIterations() const { return iter_counter; }
 
   Real GetFinalResidual() const { return final_residual; }
   int GetFinalIterations() const { return final_iteration; }
 
+  // The iterations of this solver and the v-cycles of its preconditioner
+  const SolverTelemetry &GetTelemetry() const { return preconditioner.GetTelemetry(); }
+
  protected:
   MGSolver<u, rhs, equations> preconditioner;
   BiCGSTABParams params_;
   int iter_counter;
-  AllReduce<Real> rtr, pAp, rhat0v, rhat0r, ts, tt, residual;
-  Real rhat0r_old;
+  AllReduce<Real> residual;
+  // per component reductions of the non-pipelined variant
+  int ncomp_;
+  AllReduce<std::vector<Real>> rhat0v, rhat0r, ts, tt;
+  std::vector<Real> rhat0r_old;
+  // reductions and coefficients of the pipelined variant
+  AllReduce<std::array<Real, 2>> qy_yy;
+  AllReduce<std::array<Real, 5>> rhat0_dots;
+  Real alpha_, beta_, omega_;
   equations eqs_;
   Real final_residual;
   int final_iteration;
+
+  static int NumComponents(const std::vector<int> &shape) {
+    int ncomp = 1;
+    for (const int n : shape)
+      ncomp *= n;
+    return ncomp;
+  }
+
+  // The coefficients of the non-pipelined variant, one per component, times sign
+  utils::ComponentWeights Ones() const { return utils::ComponentWeights(ncomp_, 1.0); }
+  utils::ComponentWeights Alpha(const Real sign) const {
+    std::vector<Real> alpha(ncomp_);
+    for (int c = 0; c < ncomp_; ++c)
+      alpha[c] = sign * rhat0r_old[c] / rhat0v.val[c];
+    return utils::ComponentWeights(alpha);
+  }
+  utils::ComponentWeights Omega(const Real sign) const {
+    std::vector<Real> omega(ncomp_);
+    for (int c = 0; c < ncomp_; ++c)
+      omega[c] = sign * ts.val[c] / tt.val[c];
+    return utils::ComponentWeights(omega);
+  }
+  utils::ComponentWeights Beta() const {
+    std::vector<Real> beta(ncomp_);
+    for (int c = 0; c < ncomp_; ++c)
+      beta[c] = rhat0r.val[c] / rhat0v.val[c] * tt.val[c] / ts.val[c];
+    return utils::ComponentWeights(beta);
+  }
+
+  static MGParams PreconditionerParams(const BiCGSTABParams &params) {
+    MGParams mg_params = params.mg_params;
+    mg_params.telemetry = mg_params.telemetry || params.telemetry;
+    return mg_params;
+  }
+
+  // (rhat0, r), (rhat0, w), (rhat0, s), (rhat0, z), (r, r) into rhat0_dots
+  TaskID AddRhat0DotsTasks(TaskList &tl, TaskID dependence,
+                           const std::shared_ptr<MeshData<Real>> &md) {
+    using namespace utils;
+    return MultiDotProduct<DotPair<rhat0, r>, DotPair<rhat0, w>, DotPair<rhat0, s>,
+                           DotPair<rhat0, z>, DotPair<r, r>>(dependence, tl, &rhat0_dots,
+                                                             md);
+  }
+
+  // out <- A M in, or out <- A in without preconditioning; u and rhs are overwritten
+  template <class in_t, class out_t>
+  TaskID AddPreconditionedAxTasks(TaskList &tl, TaskID dependence, Mesh *pmesh,
+                                  const int partition) {
+    using namespace utils;
+    auto &md = pmesh->mesh_data.GetOrAdd("base", partition);
+    auto precon = dependence;
+    if (params_.precondition) {
+      auto set_rhs = tl.AddTask(dependence, CopyData<in_t, rhs>, md);
+      auto zero_u = tl.AddTask(dependence, SetToZero<u>, md);
+      precon =
+          preconditioner.AddLinearOperatorTasks(tl, set_rhs | zero_u, partition, pmesh);
+    } else {
+      precon = tl.AddTask(dependence, CopyData<in_t, u>, md);
+    }
+    auto comm = AddBoundaryExchangeTasks<BoundaryType::any>(precon, tl, md, true);
+    return eqs_.template Ax<u, out_t>(tl, comm, md);
+  }
 };
 
 } // namespace solvers
@@ -13,6 +13,8 @@
 #ifndef SOLVERS_MG_SOLVER_HPP_
 #define SOLVERS_MG_SOLVER_HPP_
 
+#include <array>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
@@ -22,6 +24,7 @@
 #include "interface/meshblock_data.hpp"
 #include "interface/state_descriptor.hpp"
 #include "kokkos_abstraction.hpp"
+#include "solvers/solver_telemetry.hpp"
 #include "solvers/solver_utils.hpp"
 
 #include "tasks/tasks.hpp"
@@ -33,8 +36,29 @@ namespace solvers {
 struct MGParams {
   int max_iters = 10;
   Real residual_tolerance = 1.e-12;
+  // Only accept convergence every convergence_check_interval iterations, which skips the
+  // global reduction of the status of the convergence check in the other iterations.
+  // Not (yet) supported by BiCGSTABSolver, whose convergence check also updates the
+  // Krylov coefficients.
+  int convergence_check_interval = 1;
   bool do_FAS = true;
   std::string smoother = "SRJ2";
+  // Number of sweeps of the "Chebyshev" smoother and of power iterations used to estimate
+  // the largest eigenvalue of D^-1 A on each level
+  int chebyshev_degree = 3;
+  int eigenvalue_iterations = 5;
+  // Number of times the smoother is applied on the coarsest level, e.g., to solve the
+  // coarse problem more accurately once it is agglomerated onto few ranks (see
+  // parthenon/mesh/gmg_agglomeration_blocks)
+  int coarsest_iterations = 1;
+  // Encoding of the boundary buffers of res_err and temp sent to other ranks, e.g.,
+  // CommEncoding::float32 halves the volume of the halo exchanges of the smoothers and
+  // of restriction and prolongation.  The rounding only perturbs the correction, so it
+  // suits MGSolver as a preconditioner of an outer iteration with Real residuals.
+  CommEncoding comm_encoding = CommEncoding::none;
+  // Record the time spent in each phase of the v-cycles on each level, and the residual
+  // history, of every solve (see SolverTelemetry)
+  bool telemetry = false;
 };
 
 // The equations class must include a template method
@@ -51,6 +75,11 @@ struct MGParams {
 //
 // That stores the (possibly approximate) diagonal of matrix A in the field
 // associated with the type diag_t. This is used for Jacobi iteration.
+//
+// The "Chebyshev" smoother applies Chebyshev polynomials of D^-1 A that damp the
+// eigenvalues in [0.1, 1.1] lambda_max on each level, where lambda_max is estimated by
+// the tasks added by AddSetupTasks.  These have to run before the solve whenever A
+// changes; AddTasks includes them.
 template <class u, class rhs, class equations>
 class MGSolver {
  public:
@@ -59,34 +88,46 @@ class MGSolver {
   PARTHENON_INTERNALSOLVERVARIABLE(u, temp); // Temporary storage
   PARTHENON_INTERNALSOLVERVARIABLE(u, u0);   // Storage for initial solution during FAS
   PARTHENON_INTERNALSOLVERVARIABLE(u, D);    // Storage for (approximate) diagonal
+  PARTHENON_INTERNALSOLVERVARIABLE(u, cheby_d); // Chebyshev update direction
 
   MGSolver(StateDescriptor *pkg, MGParams params_in, equations eq_in = equations(),
            std::vector<int> shape = {})
       : params_(params_in), iter_counter(0), eqs_(eq_in) {
     using namespace parthenon::refinement_ops;
-    auto mres_err =
-        Metadata({Metadata::Cell, Metadata::Independent, Metadata::FillGhost,
-                  Metadata::GMGRestrict, Metadata::GMGProlongate, Metadata::OneCopy},
-                 shape);
+    // The residual is restricted as it is computed, see AddFieldsAndRestrict
+    auto mres_err = Metadata(
+        {Metadata::Cell, Metadata::Independent, Metadata::FillGhost,
+         Metadata::GMGRestrict, Metadata::GMGUserRestrict, Metadata::GMGProlongate,
+         Metadata::OneCopy},
+        shape);
     mres_err.RegisterRefinementOps<ProlongateSharedLinear, RestrictAverage>();
+    if (params_.comm_encoding != CommEncoding::none)
+      mres_err.SetCommEncoding(params_.comm_encoding);
     pkg->AddField(res_err::name(), mres_err);
 
     auto mtemp = Metadata({Metadata::Cell, Metadata::Independent, Metadata::FillGhost,
                            Metadata::WithFluxes, Metadata::OneCopy},
                           shape);
     mtemp.RegisterRefinementOps<ProlongateSharedLinear, RestrictAverage>();
+    if (params_.comm_encoding != CommEncoding::none)
+      mtemp.SetCommEncoding(params_.comm_encoding);
     pkg->AddField(temp::name(), mtemp);
 
     auto mu0 = Metadata({Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, shape);
     pkg->AddField(u0::name(), mu0);
     pkg->AddField(D::name(), mu0);
+    if (params_.smoother == "Chebyshev") pkg->AddField(cheby_d::name(), mu0);
+    telemetry_.Enable(params_.telemetry);
   }
 
   TaskID AddTasks(TaskList &tl, TaskID dependence, Mesh *pmesh, const int partition) {
     using namespace utils;
     TaskID none;
-    auto [itl, solve_id] = tl.AddSublist(dependence, {1, this->params_.max_iters});
+    auto setup = AddSetupTasks(tl, dependence, partition, pmesh);
+    auto [itl, solve_id] = tl.AddSublist(setup, {1, this->params_.max_iters},
+                                           this->params_.convergence_check_interval);
     iter_counter = 0;
+    ResetTelemetry(pmesh);
     itl.AddTask(
         TaskQualifier::once_per_region, none,
         [](int *iter_counter) {
@@ -113,6 +154,7 @@ class MGSolver {
           if (Globals::my_rank == 0) printf("%i %e\n", solver->iter_counter, rms_res);
           solver->final_residual = rms_res;
           solver->final_iteration = solver->iter_counter;
+          solver->telemetry_.AddIteration(rms_res);
           if (rms_res > solver->params_.residual_tolerance) return TaskStatus::iterate;
           return TaskStatus::complete;
         },
@@ -133,11 +175,63 @@ class MGSolver {
                                            min_level, max_level, pmesh);
   }
 
+  // Estimate the largest eigenvalue of D^-1 A on every level for the Chebyshev smoother
+  // by power iterations started from a checkerboard, which is close to the eigenvector
+  // of the largest eigenvalue for diffusion operators.  Nothing is done for the other
+  // smoothers.
+  TaskID AddSetupTasks(TaskList &tl, TaskID dependence, int partition, Mesh *pmesh) {
+    using namespace utils;
+    if (params_.smoother != "Chebyshev") return dependence;
+    const int min_level = 0;
+    const int max_level = pmesh->GetGMGMaxLevel();
+    if (lambda_max_.size() != static_cast<std::size_t>(max_level + 1)) {
+      lambda_max_ = std::vector<Real>(max_level + 1, 2.0);
+      eig_dots_ = std::vector<AllReduce<std::array<Real, 2>>>(max_level + 1);
+    }
+
+    TaskID setup;
+    for (int level = min_level; level <= max_level; ++level) {
+      const bool multilevel = (level != min_level);
+      auto &md = pmesh->gmg_mesh_data[level].GetOrAdd(level, "base", partition);
+      auto dep = tl.AddTask(dependence, &equations::template SetDiagonal<D>, &eqs_, md);
+      dep = tl.AddTask(dep, SetCheckerboard<temp>, md);
+      for (int n = 0; n < params_.eigenvalue_iterations; ++n) {
+        if (n > 0) dep = tl.AddTask(dep, CopyData<cheby_d, temp, false>, md);
+        auto comm = AddBoundaryExchangeTasks<BoundaryType::gmg_same>(dep, tl, md,
+                                                                     multilevel);
+        auto mat_mult = eqs_.template Ax<temp, cheby_d>(tl, comm, md);
+        dep = tl.AddTask(mat_mult, DivideByDiagonal<cheby_d, D>, md);
+      }
+      // lambda_max ~ |D^-1 A x| / |x| for the last iterate x
+      auto get_dots = MultiDotProduct<DotPair<cheby_d, cheby_d>, DotPair<temp, temp>>(
+          dep, tl, &eig_dots_[level], md);
+      auto store = tl.AddTask(
+          TaskQualifier::once_per_region | TaskQualifier::local_sync, get_dots,
+          [](MGSolver *solver, int level) {
+            const auto &dots = solver->eig_dots_[level].val;
+            if (dots[1] > 0.0) solver->lambda_max_[level] = std::sqrt(dots[0] / dots[1]);
+            return TaskStatus::complete;
+          },
+          this, level);
+      setup = setup | store;
+    }
+    return setup;
+  }
+
   Real GetSquaredResidualSum() const { return residual.val; }
   int GetCurrentIterations() const { return iter_counter; }
   Real GetFinalResidual() const { return final_residual; }
   int GetFinalIterations() const { return final_iteration; }
 
+  const SolverTelemetry &GetTelemetry() const { return telemetry_; }
+  // e.g., for an outer iteration that uses this solver as a preconditioner to record
+  // its iterations
+  SolverTelemetry *MutableTelemetry() { return &telemetry_; }
+  void ResetTelemetry(Mesh *pmesh) {
+    if (telemetry_.Enabled())
+      telemetry_.Reset(pmesh->GetGMGMaxLevel() + 1, pmesh->DefaultNumPartitions());
+  }
+
  protected:
   MGParams params_;
   int iter_counter;
@@ -145,6 +239,28 @@ class MGSolver {
   equations eqs_;
   Real final_residual;
   int final_iteration;
+  // estimates of the largest eigenvalue of D^-1 A per GMG level for the Chebyshev
+  // smoother
+  std::vector<Real> lambda_max_;
+  std::vector<AllReduce<std::array<Real, 2>>> eig_dots_;
+  SolverTelemetry telemetry_;
+
+  using Phase = SolverTelemetry::Phase;
+  // The tasks depending on the returned id up to the one passed to StopPhase are timed
+  // as phase of level
+  TaskID StartPhase(TaskList &tl, TaskID dependence, int partition, int level,
+                    Phase phase) {
+    if (!telemetry_.Enabled()) return dependence;
+    return tl.AddTask(dependence, &SolverTelemetry::Start, &telemetry_, partition, level,
+                      phase);
+  }
+  TaskID StopPhase(TaskList &tl, TaskID dependence, int partition, int level,
+                   Phase phase) {
+    if (!telemetry_.Enabled()) return dependence;
+    return tl.AddTask(dependence, &SolverTelemetry::Stop, &telemetry_, partition, level,
+                      phase);
+  }
+
   // These functions apparently have to be public to compile with cuda since
   // they contain device side lambdas
  public:
@@ -168,8 +284,8 @@ class MGSolver {
         parthenon::MakePackDescriptor<xold_t, xnew_t, Axold_t, rhs_t, D_t>(md.get());
     auto pack = desc.GetPack(md.get(), include_block);
     parthenon::par_for(
-        DEFAULT_LOOP_PATTERN, "CaclulateFluxes", DevExecSpace(), 0, pack.GetNBlocks() - 1,
-        kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        DEFAULT_LOOP_PATTERN, "CaclulateFluxes", md->GetExecSpace(), 0,
+        pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
           const auto &coords = pack.GetCoordinates(b);
           if ((i + j + k) % 2 == 1 && gs_type == GSType::red) return;
@@ -193,6 +309,116 @@ class MGSolver {
     return TaskStatus::complete;
   }
 
+  template <class var_t>
+  static TaskStatus SetCheckerboard(std::shared_ptr<MeshData<Real>> &md) {
+    using TE = parthenon::TopologicalElement;
+    TE te = TE::CC;
+    IndexRange ib = md->GetBoundsI(IndexDomain::interior, te);
+    IndexRange jb = md->GetBoundsJ(IndexDomain::interior, te);
+    IndexRange kb = md->GetBoundsK(IndexDomain::interior, te);
+
+    auto desc = parthenon::MakePackDescriptor<var_t>(md.get());
+    auto pack = desc.GetPack(md.get());
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, "SetCheckerboard", md->GetExecSpace(), 0,
+        pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          const int nvars =
+              pack.GetUpperBound(b, var_t()) - pack.GetLowerBound(b, var_t()) + 1;
+          for (int c = 0; c < nvars; ++c)
+            pack(b, te, var_t(c), k, j, i) = (i + j + k) % 2 == 0 ? 1.0 : -1.0;
+        });
+    return TaskStatus::complete;
+  }
+
+  template <class var_t, class D_t>
+  static TaskStatus DivideByDiagonal(std::shared_ptr<MeshData<Real>> &md) {
+    using TE = parthenon::TopologicalElement;
+    TE te = TE::CC;
+    IndexRange ib = md->GetBoundsI(IndexDomain::interior, te);
+    IndexRange jb = md->GetBoundsJ(IndexDomain::interior, te);
+    IndexRange kb = md->GetBoundsK(IndexDomain::interior, te);
+
+    auto desc = parthenon::MakePackDescriptor<var_t, D_t>(md.get());
+    auto pack = desc.GetPack(md.get());
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, "DivideByDiagonal", md->GetExecSpace(), 0,
+        pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          const int nvars =
+              pack.GetUpperBound(b, D_t()) - pack.GetLowerBound(b, D_t()) + 1;
+          for (int c = 0; c < nvars; ++c)
+            pack(b, te, var_t(c), k, j, i) /= pack(b, te, D_t(c), k, j, i);
+        });
+    return TaskStatus::complete;
+  }
+
+  // One step of Chebyshev iteration with the Jacobi preconditioner:
+  //   d <- wd d + wr D^-1 (rhs - A x),  x <- x + d
+  template <class rhs_t, class Ax_t, class D_t, class d_t, class x_t>
+  static TaskStatus ChebyshevStep(std::shared_ptr<MeshData<Real>> &md, Real wd,
+                                  Real wr) {
+    using TE = parthenon::TopologicalElement;
+    TE te = TE::CC;
+    IndexRange ib = md->GetBoundsI(IndexDomain::interior, te);
+    IndexRange jb = md->GetBoundsJ(IndexDomain::interior, te);
+    IndexRange kb = md->GetBoundsK(IndexDomain::interior, te);
+
+    auto desc = parthenon::MakePackDescriptor<rhs_t, Ax_t, D_t, d_t, x_t>(md.get());
+    auto pack = desc.GetPack(md.get());
+    parthenon::par_for(
+        DEFAULT_LOOP_PATTERN, "ChebyshevStep", md->GetExecSpace(), 0,
+        pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          const int nvars =
+              pack.GetUpperBound(b, D_t()) - pack.GetLowerBound(b, D_t()) + 1;
+          for (int c = 0; c < nvars; ++c) {
+            const Real res =
+                (pack(b, te, rhs_t(c), k, j, i) - pack(b, te, Ax_t(c), k, j, i)) /
+                pack(b, te, D_t(c), k, j, i);
+            const Real d =
+                (wd == 0.0 ? 0.0 : wd * pack(b, te, d_t(c), k, j, i)) + wr * res;
+            pack(b, te, d_t(c), k, j, i) = d;
+            pack(b, te, x_t(c), k, j, i) += d;
+          }
+        });
+    return TaskStatus::complete;
+  }
+
+  template <parthenon::BoundaryType comm_boundary, class TL_t>
+  TaskID AddChebyshevIteration(TL_t &tl, TaskID depends_on, int degree, bool multilevel,
+                               int level, std::shared_ptr<MeshData<Real>> &md) {
+    using namespace utils;
+    for (int n = 0; n < degree; ++n) {
+      auto comm = AddBoundaryExchangeTasks<comm_boundary>(depends_on, tl, md, multilevel);
+      auto mat_mult = eqs_.template Ax<u, temp>(tl, comm, md);
+      depends_on = tl.AddTask(
+          mat_mult,
+          [](MGSolver *solver, std::shared_ptr<MeshData<Real>> &md, int level, int n) {
+            // Target interval [a, b] of the spectrum of D^-1 A, and the coefficients
+            // rho_n = 1 / (2 sigma - rho_{n - 1}) of the recurrence
+            const Real b = 1.1 * solver->lambda_max_[level];
+            const Real a = 0.1 * solver->lambda_max_[level];
+            const Real theta = 0.5 * (b + a);
+            const Real delta = 0.5 * (b - a);
+            const Real sigma = theta / delta;
+            if (n == 0) {
+              return ChebyshevStep<rhs, temp, D, cheby_d, u>(md, 0.0, 1.0 / theta);
+            }
+            Real rho_old = 1.0 / sigma;
+            Real rho = rho_old;
+            for (int m = 1; m <= n; ++m) {
+              rho_old = rho;
+              rho = 1.0 / (2.0 * sigma - rho_old);
+            }
+            return ChebyshevStep<rhs, temp, D, cheby_d, u>(md, rho * rho_old,
+                                                           2.0 * rho / delta);
+          },
+          this, md, level, n);
+    }
+    return depends_on;
+  }
+
   template <parthenon::BoundaryType comm_boundary, class in_t, class out_t, class TL_t>
   TaskID AddJacobiIteration(TL_t &tl, TaskID depends_on, bool multilevel, Real omega,
                             std::shared_ptr<MeshData<Real>> &md) {
@@ -245,6 +471,7 @@ class MGSolver {
     auto smoother = params_.smoother;
     bool do_FAS = params_.do_FAS;
     int pre_stages, post_stages;
+    const bool chebyshev = (smoother == "Chebyshev");
     if (smoother == "none") {
       pre_stages = 0;
       post_stages = 0;
@@ -257,6 +484,9 @@ class MGSolver {
     } else if (smoother == "SRJ3") {
       pre_stages = 3;
       post_stages = 3;
+    } else if (chebyshev) {
+      pre_stages = params_.chebyshev_degree;
+      post_stages = params_.chebyshev_degree;
     } else {
       PARTHENON_FAIL("Unknown solver type.");
     }
@@ -269,8 +499,9 @@ class MGSolver {
     auto set_from_finer = dependence;
     if (level < max_level) {
       // Fill fields with restricted values
+      auto start = StartPhase(tl, dependence, partition, level, Phase::restriction);
       auto recv_from_finer =
-          tl.AddTask(dependence, ReceiveBoundBufs<BoundaryType::gmg_restrict_recv>, md);
+          tl.AddTask(start, ReceiveBoundBufs<BoundaryType::gmg_restrict_recv>, md);
       set_from_finer = tl.AddTask( // TaskQualifier::local_sync, // is this required?
           recv_from_finer, SetBounds<BoundaryType::gmg_restrict_recv>, md);
       // 1. Copy residual from dual purpose communication field to the rhs, should be
@@ -292,6 +523,8 @@ class MGSolver {
             1.0, 1.0, true);
         set_from_finer = set_from_finer | copy_u;
       }
+      set_from_finer =
+          StopPhase(tl, set_from_finer, partition, level, Phase::restriction);
     } else {
       set_from_finer = tl.AddTask(set_from_finer, CopyData<u, u0, true>, md);
     }
@@ -299,29 +532,43 @@ class MGSolver {
     // 2. Do pre-smooth and fill solution on this level
     set_from_finer =
         tl.AddTask(set_from_finer, &equations::template SetDiagonal<D>, &eqs_, md);
-    auto pre_smooth = AddSRJIteration<BoundaryType::gmg_same>(tl, set_from_finer,
-                                                              pre_stages, multilevel, md);
+    auto pre_smooth = StartPhase(tl, set_from_finer, partition, level, Phase::smooth);
+    const int nsmooth = (level == min_level) ? params_.coarsest_iterations : 1;
+    for (int n = 0; n < nsmooth; ++n) {
+      pre_smooth =
+          chebyshev ? AddChebyshevIteration<BoundaryType::gmg_same>(
+                          tl, pre_smooth, pre_stages, multilevel, level, md)
+                    : AddSRJIteration<BoundaryType::gmg_same>(tl, pre_smooth, pre_stages,
+                                                              multilevel, md);
+    }
+    pre_smooth = StopPhase(tl, pre_smooth, partition, level, Phase::smooth);
     // If we are finer than the coarsest level:
     auto post_smooth = pre_smooth;
     if (level > min_level) {
       // 3. Communicate same level boundaries so that u is up to date everywhere
-      auto comm_u = AddBoundaryExchangeTasks<BoundaryType::gmg_same>(pre_smooth, tl, md,
-                                                                     multilevel);
-
-      // 4. Caclulate residual and store in communication field
-      auto residual = eqs_.template Ax<u, temp>(tl, comm_u, md);
+      auto comm_u = AddBoundaryExchangeTasks<BoundaryType::gmg_same>(
+          StartPhase(tl, pre_smooth, partition, level, Phase::communication), tl, md,
+          multilevel);
+      comm_u = StopPhase(tl, comm_u, partition, level, Phase::communication);
+
+      // 4. Caclulate residual and restrict it into the coarse data of the communication
+      //    field, i.e., without storing it on this level
+      auto residual = eqs_.template Ax<u, temp>(
+          tl, StartPhase(tl, comm_u, partition, level, Phase::restriction), md);
       residual =
-          tl.AddTask(residual, AddFieldsAndStoreInteriorSelect<rhs, temp, res_err, true>,
-                     md, 1.0, -1.0, false);
+          tl.AddTask(residual, AddFieldsAndRestrict<rhs, temp, res_err>, md, 1.0, -1.0);
 
-      // 5. Restrict communication field and send to next level
+      // 5. Send the restricted communication field to the next level
       auto communicate_to_coarse =
           tl.AddTask(residual, SendBoundBufs<BoundaryType::gmg_restrict_send>, md);
+      communicate_to_coarse =
+          StopPhase(tl, communicate_to_coarse, partition, level, Phase::restriction);
 
       auto coarser = AddMultiGridTasksPartitionLevel(
           tl, communicate_to_coarse, partition, level - 1, min_level, max_level, pmesh);
 
       // 6. Receive error field into communication field and prolongate
+      coarser = StartPhase(tl, coarser, partition, level, Phase::prolongation);
       auto recv_from_coarser =
           tl.AddTask(coarser, ReceiveBoundBufs<BoundaryType::gmg_prolongate_recv>, md);
       auto set_from_coarser =
@@ -333,10 +580,16 @@ class MGSolver {
       //    communication field
       auto update_sol =
           tl.AddTask(prolongate, AddFieldsAndStore<u, res_err, u, true>, md, 1.0, 1.0);
+      update_sol = StopPhase(tl, update_sol, partition, level, Phase::prolongation);
 
       // 8. Post smooth using communication field and stored RHS
-      post_smooth = AddSRJIteration<BoundaryType::gmg_same>(tl, update_sol, post_stages,
-                                                            multilevel, md);
+      update_sol = StartPhase(tl, update_sol, partition, level, Phase::smooth);
+      post_smooth =
+          chebyshev ? AddChebyshevIteration<BoundaryType::gmg_same>(
+                          tl, update_sol, post_stages, multilevel, level, md)
+                    : AddSRJIteration<BoundaryType::gmg_same>(tl, update_sol, post_stages,
+                                                              multilevel, md);
+      post_smooth = StopPhase(tl, post_smooth, partition, level, Phase::smooth);
     } else {
       post_smooth = tl.AddTask(pre_smooth, CopyData<u, res_err, true>, md);
     }
@@ -345,21 +598,24 @@ class MGSolver {
     // level)
     TaskID last_task;
     if (level < max_level) {
-      auto copy_over = post_smooth;
+      auto copy_over = StartPhase(tl, post_smooth, partition, level, Phase::prolongation);
       if (!do_FAS) {
-        copy_over = tl.AddTask(post_smooth, CopyData<u, res_err, true>, md);
+        copy_over = tl.AddTask(copy_over, CopyData<u, res_err, true>, md);
       } else {
-        auto calc_err = tl.AddTask(post_smooth, AddFieldsAndStore<u, u0, res_err, true>,
-                                   md, 1.0, -1.0);
+        auto calc_err = tl.AddTask(copy_over, AddFieldsAndStore<u, u0, res_err, true>, md,
+                                   1.0, -1.0);
         copy_over = calc_err;
       }
       auto boundary =
           AddBoundaryExchangeTasks<BoundaryType::gmg_same>(copy_over, tl, md, multilevel);
       last_task =
           tl.AddTask(boundary, SendBoundBufs<BoundaryType::gmg_prolongate_send>, md);
+      last_task = StopPhase(tl, last_task, partition, level, Phase::prolongation);
     } else {
-      last_task = AddBoundaryExchangeTasks<BoundaryType::gmg_same>(post_smooth, tl, md,
-                                                                   multilevel);
+      last_task = AddBoundaryExchangeTasks<BoundaryType::gmg_same>(
+          StartPhase(tl, post_smooth, partition, level, Phase::communication), tl, md,
+          multilevel);
+      last_task = StopPhase(tl, last_task, partition, level, Phase::communication);
     }
     return last_task;
   }
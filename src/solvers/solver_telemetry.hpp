@@ -0,0 +1,135 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef SOLVERS_SOLVER_TELEMETRY_HPP_
+#define SOLVERS_SOLVER_TELEMETRY_HPP_
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+
+namespace solvers {
+
+// Statistics of the last solve of an MGSolver or BiCGSTABSolver, which are recorded if
+// the telemetry member of their parameters is set and are returned by their
+// GetTelemetry.  These are the number of iterations, the rms residual after each of them
+// and the wall time this rank spent in each phase of the v-cycles on each GMG level,
+// summed over its partitions.  A phase lasts from when its first task starts to when its
+// last task is done, including the time spent waiting for messages, and it ends with a
+// fence, so the recording slightly slows down the solve.
+class SolverTelemetry {
+ public:
+  enum class Phase { smooth, restriction, prolongation, communication };
+  static constexpr int nphases = 4;
+
+  static std::string PhaseName(const Phase phase) {
+    switch (phase) {
+    case Phase::smooth:
+      return "smooth";
+    case Phase::restriction:
+      return "restrict";
+    case Phase::prolongation:
+      return "prolongate";
+    default:
+      return "communicate";
+    }
+  }
+
+  bool Enabled() const { return enabled_; }
+  void Enable(const bool enabled) { enabled_ = enabled; }
+
+  // forget the previous solve; called when the tasks of a solve are added
+  void Reset(const int nlevels, const int npartitions) {
+    iterations_ = 0;
+    residuals_.clear();
+    times_.assign(npartitions, std::vector<Times_t>(nlevels, Times_t{}));
+    starts_ = times_;
+  }
+
+  int Iterations() const { return iterations_; }
+  const std::vector<Real> &Residuals() const { return residuals_; }
+  // The average factor by which an iteration reduced the residual
+  Real ConvergenceRate() const {
+    if (residuals_.size() < 2 || !(residuals_.front() > 0.0)) return 0.0;
+    return std::pow(residuals_.back() / residuals_.front(),
+                    1.0 / (residuals_.size() - 1));
+  }
+
+  int NumLevels() const { return times_.empty() ? 0 : times_[0].size(); }
+  double Time(const int level, const Phase phase) const {
+    double time = 0.0;
+    for (const auto &partition : times_)
+      time += partition[level][static_cast<int>(phase)];
+    return time;
+  }
+  double Time(const Phase phase) const {
+    double time = 0.0;
+    for (int level = 0; level < NumLevels(); ++level)
+      time += Time(level, phase);
+    return time;
+  }
+
+  // The columns of HistoryValues, e.g., for a HistoryOutputVec reduced with max
+  static std::vector<std::string> HistoryLabels(const std::string &prefix) {
+    std::vector<std::string> labels{prefix + "_iterations", prefix + "_convergence_rate"};
+    for (int p = 0; p < nphases; ++p)
+      labels.push_back(prefix + "_" + PhaseName(static_cast<Phase>(p)) + "_time");
+    return labels;
+  }
+  std::vector<Real> HistoryValues() const {
+    std::vector<Real> values{static_cast<Real>(iterations_), ConvergenceRate()};
+    for (int p = 0; p < nphases; ++p)
+      values.push_back(Time(static_cast<Phase>(p)));
+    return values;
+  }
+
+  // Tasks
+  TaskStatus AddIteration(const Real rms_residual) {
+    if (!enabled_) return TaskStatus::complete;
+    ++iterations_;
+    residuals_.push_back(rms_residual);
+    return TaskStatus::complete;
+  }
+  // Partitions only write to their own entries, so their task lists may run
+  // concurrently
+  TaskStatus Start(const int partition, const int level, const Phase phase) {
+    starts_[partition][level][static_cast<int>(phase)] = timer_.seconds();
+    return TaskStatus::complete;
+  }
+  TaskStatus Stop(const int partition, const int level, const Phase phase) {
+    Kokkos::fence();
+    const int p = static_cast<int>(phase);
+    times_[partition][level][p] += timer_.seconds() - starts_[partition][level][p];
+    return TaskStatus::complete;
+  }
+
+ private:
+  using Times_t = std::array<double, nphases>;
+  bool enabled_ = false;
+  int iterations_ = 0;
+  std::vector<Real> residuals_;
+  // seconds per partition, level and phase, and the start of the current phase
+  std::vector<std::vector<Times_t>> times_, starts_;
+  Kokkos::Timer timer_;
+};
+
+} // namespace solvers
+
+} // namespace parthenon
+
+#endif // SOLVERS_SOLVER_TELEMETRY_HPP_
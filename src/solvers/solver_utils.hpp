@@ -13,6 +13,8 @@
 #ifndef SOLVERS_SOLVER_UTILS_HPP_
 #define SOLVERS_SOLVER_UTILS_HPP_
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <utility>
@@ -145,6 +147,88 @@ struct Stencil {
   }
 };
 
+// Stencils whose offsets and weights are known at compile time, e.g., the Laplacians
+// below.  The loop over stencil points is unrolled by the compiler and the offsets and
+// weights become immediates, so MatVec and Jacobi don't read any arrays besides v.  The
+// weights are multiplied by a single runtime scale factor, e.g., 1/dx^2.  Desc is a
+// description of the stencil, i.e., a class with static constexpr members nstencil and
+// ndiag (the index of the diagonal) and static constexpr functions ioff(n), joff(n),
+// koff(n), and w(n) returning the offsets and weight of point n.  Stencil<T> remains the
+// choice for operators that are only known at runtime.
+template <class Desc>
+struct StaticStencil {
+  static constexpr int nstencil = Desc::nstencil;
+  static constexpr int ndiag = Desc::ndiag;
+  Real scale;
+
+  explicit StaticStencil(const Real scale = 1.0) : scale(scale) {}
+
+  template <typename PackType>
+  KOKKOS_FORCEINLINE_FUNCTION Real MatVec(const PackType &v, const int iv, const int b,
+                                          const int k, const int j, const int i) const {
+    return scale *
+           MatVec_(v, iv, b, k, j, i, std::make_integer_sequence<int, nstencil>());
+  }
+
+  template <typename PackType>
+  KOKKOS_FORCEINLINE_FUNCTION Real Jacobi(const PackType &v, const int iv, const int b,
+                                          const int k, const int j, const int i,
+                                          const Real rhs) const {
+    constexpr Real wdiag = Desc::w(ndiag);
+    const Real matvec = MatVec(v, iv, b, k, j, i);
+    return (rhs - matvec + scale * wdiag * v(b, iv, k, j, i)) / (scale * wdiag);
+  }
+
+ private:
+  template <typename PackType, int... n>
+  KOKKOS_FORCEINLINE_FUNCTION Real MatVec_(const PackType &v, const int iv, const int b,
+                                           const int k, const int j, const int i,
+                                           std::integer_sequence<int, n...>) const {
+    return ((Desc::w(n) *
+             v(b, iv, k + Desc::koff(n), j + Desc::joff(n), i + Desc::ioff(n))) +
+            ...);
+  }
+};
+
+// The standard 2 * NDIM + 1 point Laplacian, i.e., the 7 point Laplacian in 3D, without
+// the factor 1/dx^2.  The points are ordered like in the poisson example, so the first
+// 2 * NDIM + 1 weights of Stencil<T> with the same offsets describe the same operator.
+template <int NDIM>
+struct LaplacianStencil {
+  static_assert(NDIM >= 1 && NDIM <= 3, "LaplacianStencil requires 1 <= NDIM <= 3");
+  static constexpr int nstencil = 2 * NDIM + 1;
+  static constexpr int ndiag = 1;
+  KOKKOS_INLINE_FUNCTION static constexpr int ioff(const int n) {
+    return n == 0 ? -1 : (n == 2 ? 1 : 0);
+  }
+  KOKKOS_INLINE_FUNCTION static constexpr int joff(const int n) {
+    return n == 3 ? -1 : (n == 4 ? 1 : 0);
+  }
+  KOKKOS_INLINE_FUNCTION static constexpr int koff(const int n) {
+    return n == 5 ? -1 : (n == 6 ? 1 : 0);
+  }
+  KOKKOS_INLINE_FUNCTION static constexpr Real w(const int n) {
+    return n == ndiag ? -2.0 * NDIM : 1.0;
+  }
+};
+using Laplacian7Point = LaplacianStencil<3>;
+
+// The second order 27 point Laplacian in 3D with weights -128/30, 14/30, 3/30 and 1/30
+// for the center, faces, edges and corners of the cube of points, which has an isotropic
+// leading order error term.  Point n has offsets (n % 3 - 1, n / 3 % 3 - 1, n / 9 - 1).
+struct Laplacian27Point {
+  static constexpr int nstencil = 27;
+  static constexpr int ndiag = 13;
+  KOKKOS_INLINE_FUNCTION static constexpr int ioff(const int n) { return n % 3 - 1; }
+  KOKKOS_INLINE_FUNCTION static constexpr int joff(const int n) { return n / 3 % 3 - 1; }
+  KOKKOS_INLINE_FUNCTION static constexpr int koff(const int n) { return n / 9 - 1; }
+  KOKKOS_INLINE_FUNCTION static constexpr Real w(const int n) {
+    const int nnz = (ioff(n) != 0) + (joff(n) != 0) + (koff(n) != 0);
+    return nnz == 0 ? -128.0 / 30.0
+                    : (nnz == 1 ? 14.0 / 30.0 : (nnz == 2 ? 3.0 / 30.0 : 1.0 / 30.0));
+  }
+};
+
 namespace utils {
 template <class in, class out, bool only_fine_on_composite = true>
 TaskStatus CopyData(const std::shared_ptr<MeshData<Real>> &md) {
@@ -157,8 +241,8 @@ TaskStatus CopyData(const std::shared_ptr<MeshData<Real>> &md) {
   auto desc = parthenon::MakePackDescriptor<in, out>(md.get());
   auto pack = desc.GetPack(md.get(), {}, only_fine_on_composite);
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, "CopyData", DevExecSpace(), 0, pack.GetNBlocks() - 1, kb.s,
-      kb.e, jb.s, jb.e, ib.s, ib.e,
+      DEFAULT_LOOP_PATTERN, "CopyData", md->GetExecSpace(), 0, pack.GetNBlocks() - 1,
+      kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
         // TODO(LFR): If this becomes a bottleneck, exploit hierarchical parallelism and
         //            pull the loop over vars outside of the innermost loop to promote
@@ -191,8 +275,8 @@ TaskStatus AddFieldsAndStoreInteriorSelect(const std::shared_ptr<MeshData<Real>>
   auto desc = parthenon::MakePackDescriptor<a_t, b_t, out>(md.get());
   auto pack = desc.GetPack(md.get(), include_block, only_fine_on_composite);
   parthenon::par_for(
-      DEFAULT_LOOP_PATTERN, "AddFieldsAndStore", DevExecSpace(), 0, pack.GetNBlocks() - 1,
-      kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      DEFAULT_LOOP_PATTERN, "AddFieldsAndStore", md->GetExecSpace(), 0,
+      pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
         // TODO(LFR): If this becomes a bottleneck, exploit hierarchical parallelism and
         //            pull the loop over vars outside of the innermost loop to promote
@@ -213,6 +297,121 @@ TaskStatus AddFieldsAndStore(const std::shared_ptr<MeshData<Real>> &md, Real wa
       md, wa, wb, false);
 }
 
+// Per component weights of AddFieldsAndStoreComponents, e.g., the coefficients of a
+// Krylov method that solves the equations of every component of a vector valued field
+// independently.  They are copied into the kernel, so there is a maximum number of
+// components.
+struct ComponentWeights {
+  static constexpr int max_components = 64;
+  Kokkos::Array<Real, max_components> w;
+  ComponentWeights(const int ncomp, const Real val) {
+    PARTHENON_REQUIRE(ncomp <= max_components, "Too many components.");
+    for (int c = 0; c < ncomp; ++c)
+      w[c] = val;
+  }
+  explicit ComponentWeights(const std::vector<Real> &vals) {
+    const int ncomp = vals.size();
+    PARTHENON_REQUIRE(ncomp <= max_components, "Too many components.");
+    for (int c = 0; c < ncomp; ++c)
+      w[c] = vals[c];
+  }
+  KOKKOS_INLINE_FUNCTION Real operator[](const int c) const { return w[c]; }
+};
+
+// out(c) <- wa[c] * a(c) + wb[c] * b(c) for every component c
+template <class a_t, class b_t, class out, bool only_fine_on_composite = true>
+TaskStatus AddFieldsAndStoreComponents(const std::shared_ptr<MeshData<Real>> &md,
+                                       const ComponentWeights &wa,
+                                       const ComponentWeights &wb) {
+  using TE = parthenon::TopologicalElement;
+  TE te = TE::CC;
+  IndexRange ib = md->GetBoundsI(IndexDomain::entire, te);
+  IndexRange jb = md->GetBoundsJ(IndexDomain::entire, te);
+  IndexRange kb = md->GetBoundsK(IndexDomain::entire, te);
+
+  std::vector<bool> include_block(md->NumBlocks(), true);
+  auto desc = parthenon::MakePackDescriptor<a_t, b_t, out>(md.get());
+  auto pack = desc.GetPack(md.get(), include_block, only_fine_on_composite);
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, "AddFieldsAndStoreComponents", md->GetExecSpace(), 0,
+      pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+        const int nvars = pack.GetUpperBound(b, a_t()) - pack.GetLowerBound(b, a_t()) + 1;
+        for (int c = 0; c < nvars; ++c) {
+          pack(b, te, out(c), k, j, i) = wa[c] * pack(b, te, a_t(c), k, j, i) +
+                                         wb[c] * pack(b, te, b_t(c), k, j, i);
+        }
+      });
+  return TaskStatus::complete;
+}
+
+// Store the restriction of wa * a + wb * b in the coarse data of out, without storing
+// wa * a + wb * b in out first, on the blocks of md that send to a coarser GMG level.
+// With Metadata::GMGUserRestrict set for out, this replaces the restriction done by
+// SendBoundBufs<BoundaryType::gmg_restrict_send>, e.g., a v-cycle restricts the residual
+// as it is computed.  The restriction is the volume weighted average of RestrictAverage.
+template <class a_t, class b_t, class out>
+TaskStatus AddFieldsAndRestrict(const std::shared_ptr<MeshData<Real>> &md, Real wa = 1.0,
+                                Real wb = 1.0) {
+  using TE = parthenon::TopologicalElement;
+  TE te = TE::CC;
+  const int nblocks = md->NumBlocks();
+  if (nblocks == 0) return TaskStatus::complete;
+  std::vector<bool> include_block(nblocks);
+  for (int b = 0; b < nblocks; ++b)
+    include_block[b] =
+        !md->GetBlockData(b)->GetBlockPointer()->gmg_coarser_neighbors.empty();
+
+  auto desc = parthenon::MakePackDescriptor<a_t, b_t>(md.get());
+  auto desc_coarse =
+      parthenon::MakePackDescriptor<out>(md.get(), {}, {parthenon::PDOpt::Coarse});
+  decltype(desc.GetPack(md.get(), include_block)) pack;
+  decltype(desc_coarse.GetPack(md.get(), include_block)) pack_coarse;
+  { // wait for the uploads of both packs at once
+    parthenon::PackUploadBatch batch;
+    pack = desc.GetPack(md.get(), include_block);
+    pack_coarse = desc_coarse.GetPack(md.get(), include_block);
+  }
+  if (pack.GetNBlocks() == 0) return TaskStatus::complete;
+
+  auto pmb = md->GetBlockData(0)->GetBlockPointer();
+  const auto ckb = pmb->c_cellbounds.GetBoundsK(IndexDomain::interior, te);
+  const auto cjb = pmb->c_cellbounds.GetBoundsJ(IndexDomain::interior, te);
+  const auto cib = pmb->c_cellbounds.GetBoundsI(IndexDomain::interior, te);
+  const int ks = pmb->cellbounds.GetBoundsK(IndexDomain::interior, te).s;
+  const int js = pmb->cellbounds.GetBoundsJ(IndexDomain::interior, te).s;
+  const int is = pmb->cellbounds.GetBoundsI(IndexDomain::interior, te).s;
+  const int ndim = md->GetNDim();
+  const int nk = ndim > 2 ? 2 : 1;
+  const int nj = ndim > 1 ? 2 : 1;
+  parthenon::par_for(
+      DEFAULT_LOOP_PATTERN, "AddFieldsAndRestrict", md->GetExecSpace(), 0,
+      pack.GetNBlocks() - 1, ckb.s, ckb.e, cjb.s, cjb.e, cib.s, cib.e,
+      KOKKOS_LAMBDA(const int b, const int ck, const int cj, const int ci) {
+        const auto &coords = pack.GetCoordinates(b);
+        const int k0 = ks + nk * (ck - ckb.s);
+        const int j0 = js + nj * (cj - cjb.s);
+        const int i0 = is + 2 * (ci - cib.s);
+        const int nvars = pack.GetUpperBound(b, a_t()) - pack.GetLowerBound(b, a_t()) + 1;
+        for (int c = 0; c < nvars; ++c) {
+          Real sum = 0.0;
+          Real vol = 0.0;
+          for (int k = k0; k < k0 + nk; ++k) {
+            for (int j = j0; j < j0 + nj; ++j) {
+              for (int i = i0; i < i0 + 2; ++i) {
+                const Real dV = coords.CellVolume(k, j, i);
+                sum += dV * (wa * pack(b, te, a_t(c), k, j, i) +
+                             wb * pack(b, te, b_t(c), k, j, i));
+                vol += dV;
+              }
+            }
+          }
+          pack_coarse(b, te, out(c), ck, cj, ci) = sum / vol;
+        }
+      });
+  return TaskStatus::complete;
+}
+
 template <class var, bool only_fine_on_composite = true>
 TaskStatus SetToZero(const std::shared_ptr<MeshData<Real>> &md) {
   int nblocks = md->NumBlocks();
@@ -225,7 +424,7 @@ TaskStatus SetToZero(const std::shared_ptr<MeshData<Real>> &md) {
   const int scratch_level = 1;
   const int ng = parthenon::Globals::nghost;
   parthenon::par_for_outer(
-      DEFAULT_OUTER_LOOP_PATTERN, "SetFieldsToZero", DevExecSpace(),
+      DEFAULT_OUTER_LOOP_PATTERN, "SetFieldsToZero", md->GetExecSpace(),
       scratch_size_in_bytes, scratch_level, 0, pack.GetNBlocks() - 1,
       KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int b) {
         auto cb = GetIndexShape(pack(b, te, 0), ng);
@@ -257,7 +456,7 @@ TaskStatus DotProductLocal(const std::shared_ptr<MeshData<Real>> &md,
   auto pack = desc.GetPack(md.get());
   Real gsum(0);
   parthenon::par_reduce(
-      parthenon::loop_pattern_mdrange_tag, "DotProduct", DevExecSpace(), 0,
+      parthenon::loop_pattern_mdrange_tag, "DotProduct", md->GetExecSpace(), 0,
       pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
       KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &lsum) {
         const int nvars = pack.GetUpperBound(b, a_t()) - pack.GetLowerBound(b, a_t()) + 1;
@@ -293,10 +492,163 @@ TaskID DotProduct(TaskID dependency_in, TaskList &tl, AllReduce<Real> *adotb,
   return finish_global_adotb;
 }
 
+// Adds the local contributions to the dot products of every component c of a and b,
+// (a(c), b(c)), to adotb->val[c], for adotb->val.size() components
+template <class a_t, class b_t>
+TaskStatus ComponentDotProductLocal(const std::shared_ptr<MeshData<Real>> &md,
+                                    AllReduce<std::vector<Real>> *adotb) {
+  using TE = parthenon::TopologicalElement;
+  TE te = TE::CC;
+  IndexRange ib = md->GetBoundsI(IndexDomain::interior, te);
+  IndexRange jb = md->GetBoundsJ(IndexDomain::interior, te);
+  IndexRange kb = md->GetBoundsK(IndexDomain::interior, te);
+
+  auto desc = parthenon::MakePackDescriptor<a_t, b_t>(md.get());
+  auto pack = desc.GetPack(md.get());
+  const int ncomp = adotb->val.size();
+  for (int c = 0; c < ncomp; ++c) {
+    Real gsum(0);
+    parthenon::par_reduce(
+        parthenon::loop_pattern_mdrange_tag, "ComponentDotProduct", md->GetExecSpace(), 0,
+        pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, Real &lsum) {
+          lsum += pack(b, te, a_t(c), k, j, i) * pack(b, te, b_t(c), k, j, i);
+        },
+        Kokkos::Sum<Real>(gsum));
+    adotb->val[c] += gsum;
+  }
+  return TaskStatus::complete;
+}
+
+// The dot products of every component of a and b, summed over all ranks in a single
+// reduction.  adotb->val has to be sized to the number of components beforehand.
+template <class a_t, class b_t>
+TaskID ComponentDotProduct(TaskID dependency_in, TaskList &tl,
+                           AllReduce<std::vector<Real>> *adotb,
+                           const std::shared_ptr<MeshData<Real>> &md) {
+  using namespace impl;
+  using reduce_t = AllReduce<std::vector<Real>>;
+  auto zero_adotb = tl.AddTask(
+      TaskQualifier::once_per_region | TaskQualifier::local_sync, dependency_in,
+      [](reduce_t *r) {
+        std::fill(r->val.begin(), r->val.end(), 0.0);
+        return TaskStatus::complete;
+      },
+      adotb);
+  auto get_adotb = tl.AddTask(TaskQualifier::local_sync, zero_adotb,
+                              ComponentDotProductLocal<a_t, b_t>, md, adotb);
+  auto start_global_adotb = tl.AddTask(TaskQualifier::once_per_region, get_adotb,
+                                       &reduce_t::StartReduce, adotb, MPI_SUM);
+  auto finish_global_adotb =
+      tl.AddTask(TaskQualifier::once_per_region | TaskQualifier::local_sync,
+                 start_global_adotb, &reduce_t::CheckReduce, adotb);
+  return finish_global_adotb;
+}
+
+// The pair of fields (a, b) of a dot product in MultiDotProduct
+template <class a_t, class b_t>
+struct DotPair {
+  using a = a_t;
+  using b = b_t;
+};
+
+template <int N>
+struct DotProductSums {
+  Real val[N];
+  KOKKOS_INLINE_FUNCTION DotProductSums() {
+    for (int n = 0; n < N; ++n)
+      val[n] = 0.0;
+  }
+  KOKKOS_INLINE_FUNCTION DotProductSums &operator+=(const DotProductSums &other) {
+    for (int n = 0; n < N; ++n)
+      val[n] += other.val[n];
+    return *this;
+  }
+};
+
+template <class a_t, class b_t, class pack_t>
+KOKKOS_INLINE_FUNCTION void AddDotProduct(const pack_t &pack, const int b, const int k,
+                                          const int j, const int i, Real &sum) {
+  constexpr auto te = parthenon::TopologicalElement::CC;
+  const int nvars = pack.GetUpperBound(b, a_t()) - pack.GetLowerBound(b, a_t()) + 1;
+  for (int c = 0; c < nvars; ++c)
+    sum += pack(b, te, a_t(c), k, j, i) * pack(b, te, b_t(c), k, j, i);
+}
+
+// Adds the local contributions to the dot products of all DotPairs to adotb->val, in a
+// single pass over md
+template <class... Pairs>
+TaskStatus MultiDotProductLocal(const std::shared_ptr<MeshData<Real>> &md,
+                                AllReduce<std::array<Real, sizeof...(Pairs)>> *adotb) {
+  constexpr int npairs = sizeof...(Pairs);
+  using TE = parthenon::TopologicalElement;
+  TE te = TE::CC;
+  IndexRange ib = md->GetBoundsI(IndexDomain::interior, te);
+  IndexRange jb = md->GetBoundsJ(IndexDomain::interior, te);
+  IndexRange kb = md->GetBoundsK(IndexDomain::interior, te);
+
+  auto desc =
+      parthenon::MakePackDescriptor<typename Pairs::a..., typename Pairs::b...>(md.get());
+  auto pack = desc.GetPack(md.get());
+  DotProductSums<npairs> gsum;
+  parthenon::par_reduce(
+      parthenon::loop_pattern_mdrange_tag, "MultiDotProduct", md->GetExecSpace(), 0,
+      pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+      KOKKOS_LAMBDA(const int b, const int k, const int j, const int i,
+                    DotProductSums<npairs> &lsum) {
+        int n = 0;
+        (AddDotProduct<typename Pairs::a, typename Pairs::b>(pack, b, k, j, i,
+                                                             lsum.val[n++]),
+         ...);
+      },
+      Kokkos::Sum<DotProductSums<npairs>>(gsum));
+  for (int n = 0; n < npairs; ++n)
+    adotb->val[n] += gsum.val[n];
+  return TaskStatus::complete;
+}
+
+// The dot products of all DotPairs, e.g.
+//
+//   MultiDotProduct<DotPair<r, r>, DotPair<p, r>>(dependence, tl, &dots, md)
+//
+// for an AllReduce<std::array<Real, 2>> dots, computed in one kernel and summed over
+// all ranks in a single reduction
+template <class... Pairs>
+TaskID MultiDotProduct(TaskID dependency_in, TaskList &tl,
+                       AllReduce<std::array<Real, sizeof...(Pairs)>> *adotb,
+                       const std::shared_ptr<MeshData<Real>> &md) {
+  using namespace impl;
+  using reduce_t = AllReduce<std::array<Real, sizeof...(Pairs)>>;
+  auto zero_adotb = tl.AddTask(
+      TaskQualifier::once_per_region | TaskQualifier::local_sync, dependency_in,
+      [](reduce_t *r) {
+        r->val.fill(0.0);
+        return TaskStatus::complete;
+      },
+      adotb);
+  auto get_adotb = tl.AddTask(TaskQualifier::local_sync, zero_adotb,
+                              MultiDotProductLocal<Pairs...>, md, adotb);
+  auto start_global_adotb = tl.AddTask(TaskQualifier::once_per_region, get_adotb,
+                                       &reduce_t::StartReduce, adotb, MPI_SUM);
+  auto finish_global_adotb =
+      tl.AddTask(TaskQualifier::once_per_region | TaskQualifier::local_sync,
+                 start_global_adotb, &reduce_t::CheckReduce, adotb);
+  return finish_global_adotb;
+}
+
 } // namespace utils
 
 } // namespace solvers
 
 } // namespace parthenon
 
+namespace Kokkos {
+template <int N>
+struct reduction_identity<parthenon::solvers::utils::DotProductSums<N>> {
+  KOKKOS_FORCEINLINE_FUNCTION static parthenon::solvers::utils::DotProductSums<N> sum() {
+    return parthenon::solvers::utils::DotProductSums<N>();
+  }
+};
+} // namespace Kokkos
+
 #endif // SOLVERS_SOLVER_UTILS_HPP_
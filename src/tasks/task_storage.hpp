@@ -0,0 +1,174 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef TASKS_TASK_STORAGE_HPP_
+#define TASKS_TASK_STORAGE_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <basic_types.hpp>
+
+namespace parthenon {
+
+// A type erased, move-only callable returning a TaskStatus.  Unlike std::function, the
+// inline buffer is large enough to hold the lambdas TaskList::AddTask generates for
+// typical task signatures (a function pointer plus a handful of shared_ptr/int
+// arguments), so constructing a task does not normally touch the heap.
+class TaskFunction {
+ public:
+  static constexpr std::size_t buffer_size = 128;
+
+  TaskFunction() = default;
+  template <typename F, typename = std::enable_if_t<
+                            !std::is_same<std::decay_t<F>, TaskFunction>::value>>
+  TaskFunction(F &&func) { // NOLINT(runtime/explicit)
+    using func_t = std::decay_t<F>;
+    if constexpr (sizeof(func_t) <= buffer_size &&
+                  alignof(func_t) <= alignof(std::max_align_t) &&
+                  std::is_nothrow_move_constructible<func_t>::value) {
+      obj = new (&buffer) func_t(std::forward<F>(func));
+      destroy = [](void *o) { static_cast<func_t *>(o)->~func_t(); };
+      move = [](void *o, void *dst) -> void * {
+        return new (dst) func_t(std::move(*static_cast<func_t *>(o)));
+      };
+    } else {
+      obj = new func_t(std::forward<F>(func));
+      destroy = [](void *o) { delete static_cast<func_t *>(o); };
+    }
+    invoke = [](void *o) -> TaskStatus { return (*static_cast<func_t *>(o))(); };
+  }
+  TaskFunction(const TaskFunction &) = delete;
+  TaskFunction &operator=(const TaskFunction &) = delete;
+  TaskFunction(TaskFunction &&other) noexcept { MoveFrom(other); }
+  TaskFunction &operator=(TaskFunction &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+  ~TaskFunction() { Reset(); }
+
+  TaskStatus operator()() { return invoke(obj); }
+  explicit operator bool() const { return invoke != nullptr; }
+  bool OnHeap() const { return obj != nullptr && obj != &buffer; }
+
+ private:
+  void Reset() {
+    if (obj != nullptr) destroy(obj);
+    obj = nullptr;
+    invoke = nullptr;
+    destroy = nullptr;
+    move = nullptr;
+  }
+  // Callables on the heap are handed over, those in the buffer are move constructed
+  // into the buffer of this one.  other is left empty.
+  void MoveFrom(TaskFunction &other) {
+    if (other.OnHeap()) {
+      obj = other.obj;
+      other.obj = nullptr;
+    } else if (other.obj != nullptr) {
+      obj = other.move(other.obj, &buffer);
+    }
+    invoke = other.invoke;
+    destroy = other.destroy;
+    move = other.move;
+    other.Reset();
+  }
+
+  std::aligned_storage_t<buffer_size, alignof(std::max_align_t)> buffer;
+  void *obj = nullptr;
+  TaskStatus (*invoke)(void *) = nullptr;
+  void (*destroy)(void *) = nullptr;
+  void *(*move)(void *, void *) = nullptr;
+};
+
+// Contiguous, chunked storage for objects that must never move once constructed (e.g.
+// because other objects hold pointers to them).  Objects are placement constructed
+// into fixed size chunks, so there is one allocation per chunk rather than one per
+// object.  clear() destroys the objects but keeps the chunks around for reuse.
+template <typename T, std::size_t chunk_size = 64>
+class ChunkedArena {
+ public:
+  ChunkedArena() = default;
+  ChunkedArena(const ChunkedArena &) = delete;
+  ChunkedArena &operator=(const ChunkedArena &) = delete;
+  ~ChunkedArena() { clear(); }
+
+  template <class... Args>
+  T *emplace_back(Args &&...args) {
+    if (nobj == capacity()) chunks.emplace_back(std::make_unique<Chunk>());
+    T *t = new (Slot(nobj)) T(std::forward<Args>(args)...);
+    nobj++;
+    return t;
+  }
+
+  T *operator[](const std::size_t i) {
+    return std::launder(reinterpret_cast<T *>(Slot(i)));
+  }
+  T *back() { return (*this)[nobj - 1]; }
+  std::size_t size() const { return nobj; }
+  std::size_t capacity() const { return chunks.size() * chunk_size; }
+
+  template <typename F>
+  void ForEach(F &&f) {
+    for (std::size_t i = 0; i < nobj; i++) {
+      f((*this)[i]);
+    }
+  }
+
+  void clear() {
+    for (std::size_t i = 0; i < nobj; i++) {
+      (*this)[i]->~T();
+    }
+    nobj = 0;
+  }
+
+ private:
+  struct Chunk {
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage[chunk_size];
+  };
+  void *Slot(const std::size_t i) {
+    return &chunks[i / chunk_size]->storage[i % chunk_size];
+  }
+
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  std::size_t nobj = 0;
+};
+
+// A non-owning view of a contiguous range of T
+template <typename T>
+class ArrayView {
+ public:
+  ArrayView() = default;
+  ArrayView(T *first, T *last) : first_(first), last_(last) {}
+  explicit ArrayView(std::vector<std::remove_const_t<T>> &v)
+      : first_(v.data()), last_(v.data() + v.size()) {}
+  T *begin() const { return first_; }
+  T *end() const { return last_; }
+  std::size_t size() const { return last_ - first_; }
+  bool empty() const { return first_ == last_; }
+  T &operator[](const std::size_t i) const { return first_[i]; }
+
+ private:
+  T *first_ = nullptr;
+  T *last_ = nullptr;
+};
+
+} // namespace parthenon
+
+#endif // TASKS_TASK_STORAGE_HPP_
@@ -0,0 +1,140 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "globals.hpp"
+#include "tasks/task_timeline.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+std::vector<int> TaskTimeline::Region::CriticalPath() const {
+  std::vector<int> path;
+  if (events_.size() == 0) return path;
+  // the critical path is the chain of events that made each other ready, ending in the
+  // event that finished last
+  int ev = 0;
+  for (int i = 1; i < static_cast<int>(events_.size()); i++) {
+    if (events_[i].end > events_[ev].end) ev = i;
+  }
+  while (ev >= 0) {
+    path.push_back(ev);
+    ev = events_[ev].trigger;
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+namespace {
+const char *StatusName(const TaskStatus status) {
+  if (status == TaskStatus::complete) return "complete";
+  if (status == TaskStatus::incomplete) return "incomplete";
+  return "iterate";
+}
+// microseconds, the unit of the Chrome trace format
+double us(const double seconds) { return 1.0e6 * seconds; }
+// a label as a quoted JSON string, with quotes, backslashes and control characters
+// escaped
+std::string JsonString(const std::string &label) {
+  std::ostringstream ss;
+  ss << '"';
+  for (const char c : label) {
+    if (c == '"' || c == '\\') {
+      ss << '\\' << c;
+    } else if (c == '\n') {
+      ss << "\\n";
+    } else if (c == '\t') {
+      ss << "\\t";
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      ss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+         << static_cast<int>(c);
+    } else {
+      ss << c;
+    }
+  }
+  ss << '"';
+  return ss.str();
+}
+} // namespace
+
+void TaskTimeline::Write(const std::string &filename) {
+  std::ofstream out(filename);
+  PARTHENON_REQUIRE_THROWS(out.is_open(), "Could not open task timeline " + filename);
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n";
+  bool first = true;
+  for (auto &region : regions) {
+    const auto &events = region.events();
+    const auto path = region.CriticalPath();
+    std::vector<bool> critical(events.size(), false);
+    for (auto ev : path) {
+      critical[ev] = true;
+    }
+    // count how often each task was attempted, i.e. returned incomplete, before
+    std::unordered_map<std::string, int> attempts;
+    for (std::size_t i = 0; i < events.size(); i++) {
+      const auto &ev = events[i];
+      int &tries = attempts[ev.label];
+      if (!first) out << ",\n";
+      first = false;
+      out << "{\"name\": " << JsonString(ev.label) << ", \"cat\": \"task\", \"ph\": \"X\""
+          << ", \"ts\": " << us(ev.start) << ", \"dur\": " << us(ev.end - ev.start)
+          << ", \"pid\": " << Globals::my_rank << ", \"tid\": " << ev.thread
+          << ", \"args\": {\"region\": " << region.id() << ", \"status\": \""
+          << StatusName(ev.status) << "\", \"retries\": " << tries
+          << ", \"ready_wait_us\": " << us(ev.start - ev.ready)
+          << ", \"critical\": " << (critical[i] ? "true" : "false") << "}}";
+      tries = (ev.status == TaskStatus::incomplete ? tries + 1 : 0);
+    }
+  }
+  out << "\n],\n\"criticalPaths\": [\n";
+  first = true;
+  for (auto &region : regions) {
+    const auto &events = region.events();
+    if (events.size() == 0) continue;
+    const auto path = region.CriticalPath();
+    double begin = events[0].ready;
+    double incomplete = 0.0;
+    for (const auto &ev : events) {
+      begin = std::min(begin, ev.ready);
+      if (ev.status == TaskStatus::incomplete) incomplete += ev.end - ev.start;
+    }
+    double path_run = 0.0, path_wait = 0.0;
+    for (auto i : path) {
+      path_run += events[i].end - events[i].start;
+      path_wait += events[i].start - events[i].ready;
+    }
+    if (!first) out << ",\n";
+    first = false;
+    out << "{\"region\": " << region.id() << ", \"num_events\": " << events.size()
+        << ", \"span_us\": " << us(events[path.back()].end - begin)
+        << ", \"critical_path_run_us\": " << us(path_run)
+        << ", \"critical_path_ready_wait_us\": " << us(path_wait)
+        << ", \"incomplete_us\": " << us(incomplete) << ", \"critical_path\": [";
+    for (std::size_t n = 0; n < path.size(); n++) {
+      out << (n > 0 ? ", " : "") << JsonString(events[path[n]].label);
+    }
+    out << "]}";
+  }
+  out << "\n]}\n";
+}
+
+} // namespace parthenon
@@ -0,0 +1,91 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef TASKS_TASK_TIMELINE_HPP_
+#define TASKS_TASK_TIMELINE_HPP_
+
+#include <chrono>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <basic_types.hpp>
+
+namespace parthenon {
+
+// Records a per rank timeline of every task executed while recording is switched on,
+// and writes it in the Chrome trace event format (which can be loaded by
+// chrome://tracing or https://ui.perfetto.dev).  In addition to when and on which
+// thread a task ran, each event knows when the task became ready and which event made
+// it ready, which is used to reconstruct the critical path of each TaskRegion.
+class TaskTimeline {
+ public:
+  struct Event {
+    std::string label;
+    int thread;
+    TaskStatus status;
+    // seconds since the start of the timeline
+    double ready, start, end;
+    // the event of the task whose completion made this task ready, -1 if none
+    int trigger;
+  };
+
+  // the events of a single execution of a TaskRegion
+  class Region {
+   public:
+    explicit Region(const int id) : id_(id) {}
+    int Record(Event &&ev) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      events_.push_back(std::move(ev));
+      return events_.size() - 1;
+    }
+    int id() const { return id_; }
+    const std::vector<Event> &events() const { return events_; }
+    // indices of the events on the critical path, ordered from first to last
+    std::vector<int> CriticalPath() const;
+
+   private:
+    const int id_;
+    std::vector<Event> events_;
+    std::mutex mutex_;
+  };
+
+  static bool Recording() { return recording; }
+  // Recording should only be toggled between, not during, the execution of regions
+  static void SetRecording(const bool record) { recording = record; }
+  static double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  }
+  static Region *NewRegion() {
+    regions.emplace_back(regions.size());
+    return &regions.back();
+  }
+  static std::size_t NumRegions() { return regions.size(); }
+  static const Region &RegionAt(const int i) { return *std::next(regions.begin(), i); }
+  static void Clear() { regions.clear(); }
+  // write all recorded regions to filename as Chrome trace JSON
+  static void Write(const std::string &filename);
+
+ private:
+  inline static bool recording = false;
+  // a list so that regions don't move while tasks record into them
+  inline static std::list<Region> regions;
+  inline static const std::chrono::steady_clock::time_point t0 =
+      std::chrono::steady_clock::now();
+};
+
+} // namespace parthenon
+
+#endif // TASKS_TASK_TIMELINE_HPP_
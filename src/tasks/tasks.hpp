@@ -15,18 +15,25 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <basic_types.hpp>
 #include <parthenon_mpi.hpp>
 
+#include "task_storage.hpp"
+#include "task_timeline.hpp"
 #include "thread_pool.hpp"
 #include "utils/error_checking.hpp"
 
@@ -46,16 +53,29 @@ class TaskQualifier {
   static inline constexpr qualifier_t global_sync{1 << 1};
   static inline constexpr qualifier_t completion{1 << 2};
   static inline constexpr qualifier_t once_per_region{1 << 3};
+  static inline constexpr qualifier_t priority{1 << 4};
 
   bool LocalSync() const { return flags & local_sync; }
   bool GlobalSync() const { return flags & global_sync; }
   bool Completion() const { return flags & completion; }
   bool Once() const { return flags & once_per_region; }
+  bool Priority() const { return flags & priority; }
 
  private:
   qualifier_t flags;
 };
 
+// Measures the cost of the tasks of a TaskList, see TaskList::SetCostMeter, e.g., the
+// cost of a MeshBlock for automatic load balancing.  Finish is called right after each
+// task of the list, so that it can wait for the kernels the task launched, and then Add
+// with the seconds since the task started.
+class TaskCostMeter {
+ public:
+  virtual ~TaskCostMeter() = default;
+  virtual void Finish() {}
+  virtual void Add(double seconds) = 0;
+};
+
 // forward declare Task for TaskID
 class Task;
 class TaskID {
@@ -89,78 +109,170 @@ class TaskID {
 };
 
 class Task {
+  using TaskView = ArrayView<Task *const>;
+
  public:
   Task() = default;
-  template <typename TID>
-  Task(TID &&dep, const std::function<TaskStatus()> &func,
-       std::pair<int, int> limits = {1, 1})
-      : f(func), exec_limits(limits) {
+  template <typename TID, typename F>
+  Task(TID &&dep, F &&func, std::pair<int, int> limits = {1, 1})
+      : f(std::forward<F>(func)), exec_limits(limits) {
     if (dep.GetIDs().size() == 0 && dep.GetTask()) {
-      dependencies.insert(dep.GetTask());
+      AddDependency(dep.GetTask());
     } else {
       for (auto &d : dep.GetIDs()) {
-        dependencies.insert(d);
+        AddDependency(d);
       }
     }
     // always add "this" to repeat task if it's incomplete
-    dependent[static_cast<int>(TaskStatus::incomplete)].push_back(this);
+    AddDependent(this, TaskStatus::incomplete);
   }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
 
   TaskStatus operator()() {
     auto status = f();
     if (task_type == TaskType::completion) {
       // keep track of how many times it's been called
       num_calls += (status == TaskStatus::iterate || status == TaskStatus::complete);
-      // enforce minimum number of iterations
-      if (num_calls < exec_limits.first && status == TaskStatus::complete)
+      // enforce minimum number of iterations and only accept completion every
+      // check_interval iterations
+      if ((num_calls < exec_limits.first || num_calls % check_interval != 0) &&
+          status == TaskStatus::complete)
         status = TaskStatus::iterate;
       // enforce maximum number of iterations
       if (num_calls == exec_limits.second) status = TaskStatus::complete;
     }
+    num_polls = (status == TaskStatus::incomplete ? num_polls + 1 : 0);
     // save the status in the Task object
     SetStatus(status);
     return status;
   }
   TaskID GetID() { return this; }
-  bool ready() {
-    // check that no dependency is incomplete
-    bool go = true;
-    for (auto &dep : dependencies) {
-      go = go && (dep->GetStatus() != TaskStatus::incomplete);
+  // a task is ready when none of its dependencies are incomplete.  Rather than polling
+  // the dependencies, each task keeps a count of its incomplete dependencies that is
+  // updated whenever the status of one of them changes (see SetStatus)
+  bool ready() const { return num_incomplete_deps.load() == 0; }
+  // Claim the right to enqueue a ready task.  Only one of the possibly many tasks that
+  // find this task ready succeeds, so it ends up on the ready queue exactly once.
+  bool claim() { return !queued.exchange(true); }
+  void release() { queued.store(false); }
+  void AddDependency(Task *t) {
+    PARTHENON_DEBUG_REQUIRE(!finalized(), "Can't add dependencies to a finalized task");
+    auto &deps = edges[DEPENDENCIES];
+    if (std::find(deps.begin(), deps.end(), t) == deps.end()) {
+      deps.push_back(t);
+      t->edges[LISTENERS].push_back(this);
+      if (t->GetStatus() == TaskStatus::incomplete) num_incomplete_deps++;
     }
-    return go;
   }
-  void AddDependency(Task *t) { dependencies.insert(t); }
-  std::unordered_set<Task *> &GetDependencies() { return dependencies; }
+  TaskView GetDependencies() const { return GetEdges(DEPENDENCIES); }
   void AddDependent(Task *t, TaskStatus status) {
-    dependent[static_cast<int>(status)].push_back(t);
+    PARTHENON_DEBUG_REQUIRE(!finalized(), "Can't add dependents to a finalized task");
+    edges[DEPENDENT + static_cast<int>(status)].push_back(t);
   }
-  std::vector<Task *> &GetDependent(TaskStatus status = TaskStatus::complete) {
-    return dependent[static_cast<int>(status)];
+  TaskView GetDependent(TaskStatus status = TaskStatus::complete) const {
+    return GetEdges(DEPENDENT + static_cast<int>(status));
   }
   void SetType(TaskType type) { task_type = type; }
+  // priority tasks are run ahead of other ready tasks
+  void SetPriority(const bool p) { priority = p; }
+  bool Priority() const { return priority; }
   TaskType GetType() { return task_type; }
   void SetStatus(TaskStatus status) {
-    std::lock_guard<std::mutex> lock(mutex);
-    task_status = status;
-  }
-  TaskStatus GetStatus() {
-    std::lock_guard<std::mutex> lock(mutex);
-    return task_status;
+    const auto old_status = task_status.exchange(status);
+    const bool was_incomplete = (old_status == TaskStatus::incomplete);
+    const bool is_incomplete = (status == TaskStatus::incomplete);
+    if (was_incomplete == is_incomplete) return;
+    // tell every task that depends on this one that it has one more/less incomplete
+    // dependency
+    const int delta = (is_incomplete ? 1 : -1);
+    for (auto t : GetEdges(LISTENERS)) {
+      t->num_incomplete_deps += delta;
+    }
   }
+  TaskStatus GetStatus() const { return task_status.load(); }
   void reset_iteration() { num_calls = 0; }
+  void SetCheckInterval(const int interval) { check_interval = interval; }
+  // For a completion task, whether the status of its next call is set by the iteration
+  // limits and the check interval alone, i.e., it's the same on all ranks irrespective
+  // of what the task function returns
+  bool NextStatusFixed() const {
+    if (task_type != TaskType::completion) return false;
+    const int n = num_calls + 1;
+    return n < exec_limits.first || n == exec_limits.second || n % check_interval != 0;
+  }
+  // how many times in a row the task has returned incomplete
+  int NumPolls() const { return num_polls; }
+  // a human readable name used, e.g., in task timelines
+  void SetLabel(const std::string &name) { label = name; }
+  const std::string &GetLabel() const { return label; }
+  void SetCostMeter(TaskCostMeter *meter) { cost_meter = meter; }
+  TaskCostMeter *GetCostMeter() const { return cost_meter; }
+
+  // Once the graph is complete, the per task edge vectors are copied into a single
+  // compressed sparse row style array shared by all tasks of a TaskList.  This is done
+  // in two steps since csr may reallocate while edges are appended.
+  void AppendEdges(std::vector<Task *> &csr) {
+    for (int i = 0; i < NUM_EDGE_TYPES; i++) {
+      csr_offsets[i] = csr.size();
+      csr.insert(csr.end(), edges[i].begin(), edges[i].end());
+    }
+    csr_offsets[NUM_EDGE_TYPES] = csr.size();
+  }
+  void Finalize(Task *const *csr) {
+    csr_edges = csr;
+    for (auto &e : edges) {
+      std::vector<Task *>().swap(e);
+    }
+  }
+  bool finalized() const { return csr_edges != nullptr; }
 
  private:
-  std::function<TaskStatus()> f;
-  // store a list of tasks that might be available to
-  // run for each possible status this task returns
-  std::array<std::vector<Task *>, 3> dependent;
-  std::unordered_set<Task *> dependencies;
+  // the edges of the task graph touching this task: the tasks it depends on, the tasks
+  // that depend on it (the inverse of the dependencies), and the tasks that might be
+  // available to run for each possible status this task returns
+  enum { DEPENDENCIES = 0, LISTENERS = 1, DEPENDENT = 2, NUM_EDGE_TYPES = 5 };
+  TaskView GetEdges(const int type) const {
+    if (finalized())
+      return TaskView(csr_edges + csr_offsets[type], csr_edges + csr_offsets[type + 1]);
+    return TaskView(edges[type].data(), edges[type].data() + edges[type].size());
+  }
+
+  TaskFunction f;
+  std::string label;
+  TaskCostMeter *cost_meter = nullptr;
+  // edges while the graph is being built
+  std::array<std::vector<Task *>, NUM_EDGE_TYPES> edges;
+  // edges after finalization
+  Task *const *csr_edges = nullptr;
+  std::array<int, NUM_EDGE_TYPES + 1> csr_offsets;
+  std::atomic<int> num_incomplete_deps{0};
+  std::atomic<bool> queued{false};
   std::pair<int, int> exec_limits;
   TaskType task_type = TaskType::normal;
+  bool priority = false;
   int num_calls = 0;
-  TaskStatus task_status = TaskStatus::incomplete;
-  std::mutex mutex;
+  int check_interval = 1;
+  int num_polls = 0;
+  std::atomic<TaskStatus> task_status{TaskStatus::incomplete};
+};
+
+// Storage for all tasks of a TaskList along with the flattened graph edges.  This is
+// shared by copies of a TaskList, so tasks may safely refer to it.
+struct TaskStorage {
+  ChunkedArena<Task> tasks;
+  std::vector<Task *> csr_edges;
+  std::vector<Task *> completion_tasks;
+  std::vector<TaskStorage *> sublists;
+
+  // Reset all tasks of this list and its sublists.  Resetting the sublists as well
+  // guarantees that nothing is left over from a previous iteration or a previous
+  // execution of the graph.
+  void ResetStatus() {
+    tasks.ForEach([](Task *t) { t->SetStatus(TaskStatus::incomplete); });
+    for (auto sl : sublists)
+      sl->ResetStatus();
+  }
 };
 
 class TaskRegion;
@@ -169,20 +281,20 @@ class TaskList {
 
  public:
   TaskList() : TaskList(TaskID(), {1, 1}) {}
-  explicit TaskList(const TaskID &dep, std::pair<int, int> limits)
-      : dependency(dep), exec_limits(limits) {
+  explicit TaskList(const TaskID &dep, std::pair<int, int> limits,
+                    const int check_interval = 1)
+      : dependency(dep), exec_limits(limits), check_interval(check_interval) {
+    PARTHENON_REQUIRE_THROWS(check_interval >= 1, "Check interval must be >= 1");
     // make a trivial first_task after which others will get launched
     // simplifies logic for iteration and startup
-    tasks.push_back(std::make_shared<Task>(
+    storage->tasks.emplace_back(
         dependency,
-        [&tasks = tasks]() {
-          for (auto &t : tasks) {
-            t->SetStatus(TaskStatus::incomplete);
-          }
+        [&storage = *storage]() {
+          storage.ResetStatus();
           return TaskStatus::complete;
         },
-        exec_limits));
-    first_task = tasks.back().get();
+        exec_limits);
+    first_task = storage->tasks.back();
     // connect list dependencies to this list's first_task
     for (auto t : first_task->GetDependencies()) {
       t->AddDependent(first_task, TaskStatus::complete);
@@ -190,16 +302,16 @@ class TaskList {
 
     // make a trivial last_task that tasks dependent on this list's execution
     // can depend on.  Also simplifies exiting completed iterations
-    tasks.push_back(std::make_shared<Task>(
+    storage->tasks.emplace_back(
         TaskID(),
-        [&completion_tasks = completion_tasks]() {
+        [&completion_tasks = storage->completion_tasks]() {
           for (auto t : completion_tasks) {
             t->reset_iteration();
           }
           return TaskStatus::complete;
         },
-        exec_limits));
-    last_task = tasks.back().get();
+        exec_limits);
+    last_task = storage->tasks.back();
   }
 
   template <class... Args>
@@ -216,12 +328,13 @@ class TaskList {
     if (!tq.Once() || (tq.Once() && unique_id == 0)) {
       AddUserTask(dep, std::forward<Args>(args)...);
     } else {
-      tasks.push_back(std::make_shared<Task>(
-          dep, [=]() { return TaskStatus::complete; }, exec_limits));
+      storage->tasks.emplace_back(
+          dep, [=]() { return TaskStatus::complete; }, exec_limits);
     }
 
-    Task *my_task = tasks.back().get();
+    Task *my_task = storage->tasks.back();
     TaskID id(my_task);
+    my_task->SetPriority(tq.Priority());
 
     if (tq.LocalSync() || tq.GlobalSync() || tq.Once()) {
       regional_tasks.push_back(my_task);
@@ -249,11 +362,14 @@ class TaskList {
       // only call MPI once per region, on the list with unique_id = 0
       if (unique_id == 0 && do_mpi) {
 #ifdef MPI_PARALLEL
+        // the task that finishes the Iallreduce, which is the completion task for
+        // global_sync | completion tasks
+        auto finish_task = std::make_shared<Task *>(nullptr);
         // add a task that starts the Iallreduce on the task statuses
-        tasks.push_back(std::make_shared<Task>(
+        storage->tasks.emplace_back(
             id,
-            [my_task, &stat = *global_status.back(), &req = *global_request.back(),
-             &comm = *global_comm.back()]() {
+            [my_task, finish_task, &stat = *global_status.back(),
+             &req = *global_request.back(), &comm = *global_comm.back()]() {
               // jump through a couple hoops to figure out statuses of all instances of
               // my_task accross all lists in the enclosing TaskRegion
               auto dependent = my_task->GetDependent(TaskStatus::complete);
@@ -263,14 +379,20 @@ class TaskList {
               for (auto dep : mytask->GetDependencies()) {
                 stat = std::max(stat, static_cast<int>(dep->GetStatus()));
               }
+              // no need to agree on a status that the iteration limits and check
+              // interval determine anyway
+              if ((*finish_task)->NextStatusFixed()) {
+                req = MPI_REQUEST_NULL;
+                return TaskStatus::complete;
+              }
               PARTHENON_MPI_CHECK(
                   MPI_Iallreduce(MPI_IN_PLACE, &stat, 1, MPI_INT, MPI_MAX, comm, &req));
               return TaskStatus::complete;
             },
-            exec_limits));
-        start = TaskID(tasks.back().get());
+            exec_limits);
+        start = TaskID(storage->tasks.back());
         // add a task that tests for completion of the Iallreduces of statuses
-        tasks.push_back(std::make_shared<Task>(
+        storage->tasks.emplace_back(
             start,
             [&stat = *global_status.back(), &req = *global_request.back()]() {
               int check;
@@ -280,18 +402,19 @@ class TaskList {
               }
               return TaskStatus::incomplete;
             },
-            exec_limits));
+            exec_limits);
+        *finish_task = storage->tasks.back();
 #endif         // MPI_PARALLEL
       } else { // unique_id != 0
         // just add empty tasks
-        tasks.push_back(std::make_shared<Task>(
-            id, [&]() { return TaskStatus::complete; }, exec_limits));
-        start = TaskID(tasks.back().get());
-        tasks.push_back(std::make_shared<Task>(
-            start, [my_task]() { return my_task->GetStatus(); }, exec_limits));
+        storage->tasks.emplace_back(
+            id, [&]() { return TaskStatus::complete; }, exec_limits);
+        start = TaskID(storage->tasks.back());
+        storage->tasks.emplace_back(
+            start, [my_task]() { return my_task->GetStatus(); }, exec_limits);
       }
       // reset id so it now points at the task that finishes the Iallreduce
-      id = TaskID(tasks.back().get());
+      id = TaskID(storage->tasks.back());
       // make the task that starts the Iallreduce point at the one that finishes it
       start.GetTask()->AddDependent(id.GetTask(), TaskStatus::complete);
       // for any status != incomplete, my_task should point at the mpi reduction
@@ -305,8 +428,9 @@ class TaskList {
     if (tq.Completion()) {
       auto t = id.GetTask();
       t->SetType(TaskType::completion);
+      t->SetCheckInterval(check_interval);
       t->AddDependent(last_task, TaskStatus::complete);
-      completion_tasks.push_back(t);
+      storage->completion_tasks.push_back(t);
     }
 
     // make connections so tasks point to this task to run next
@@ -320,19 +444,40 @@ class TaskList {
     return id;
   }
 
+  // name a task in timelines/diagnostics
+  void SetLabel(TaskID id, const std::string &label) { id.GetTask()->SetLabel(label); }
+
+  // Charge the time spent in the tasks of this list (and of its sublists that don't
+  // have a meter of their own) to meter.  Must be called before the list is executed
+  // the first time.
+  void SetCostMeter(std::shared_ptr<TaskCostMeter> meter) {
+    cost_meter = std::move(meter);
+  }
+
+  // The completion tasks of the sublist only accept TaskStatus::complete every
+  // check_interval iterations, which also skips the reductions of the statuses of
+  // global_sync completion tasks in the other iterations.  Note that the iteration
+  // continues after a completion task returned complete in between, so any state it
+  // only updates when returning iterate must not be needed by the next iteration.
   template <typename TID>
-  std::pair<TaskList &, TaskID> AddSublist(TID &&dep, std::pair<int, int> minmax_iters) {
-    sublists.push_back(std::make_shared<TaskList>(dep, minmax_iters));
+  std::pair<TaskList &, TaskID> AddSublist(TID &&dep, std::pair<int, int> minmax_iters,
+                                           const int check_interval = 1) {
+    // like tasks, a sublist without dependencies starts after the list's first_task
+    TaskID sub_dep(dep);
+    if (sub_dep.empty()) sub_dep = TaskID(first_task);
+    sublists.push_back(std::make_shared<TaskList>(sub_dep, minmax_iters, check_interval));
     auto &tl = *sublists.back();
     tl.SetID(unique_id);
+    storage->sublists.push_back(tl.storage.get());
     return std::make_pair(std::ref(tl), TaskID(tl.last_task));
   }
 
  private:
   TaskID dependency;
   std::pair<int, int> exec_limits;
+  int check_interval;
   // put these in shared_ptrs so copying TaskList works as expected
-  std::vector<std::shared_ptr<Task>> tasks;
+  std::shared_ptr<TaskStorage> storage = std::make_shared<TaskStorage>();
   std::vector<std::shared_ptr<TaskList>> sublists;
 #ifdef MPI_PARALLEL
   std::vector<std::shared_ptr<int>> global_status;
@@ -342,12 +487,12 @@ class TaskList {
   // vectors are fine for these
   std::vector<Task *> regional_tasks;
   std::vector<Task *> global_tasks;
-  std::vector<Task *> completion_tasks;
   // special startup and takedown tasks auto added to lists
   Task *first_task;
   Task *last_task;
   // a unique id to support tasks that should only get executed once per region
   int unique_id;
+  std::shared_ptr<TaskCostMeter> cost_meter;
 
   Task *GetStartupTask() { return first_task; }
   size_t NumRegional() const { return regional_tasks.size(); }
@@ -355,6 +500,7 @@ class TaskList {
   void SetID(const int id) { unique_id = id; }
 
   void ConnectIteration() {
+    auto &completion_tasks = storage->completion_tasks;
     if (completion_tasks.size() != 0) {
       auto last = completion_tasks.back();
       last->AddDependent(first_task, TaskStatus::iterate);
@@ -363,25 +509,68 @@ class TaskList {
       tl->ConnectIteration();
   }
 
+  // flatten the edges of all tasks in this list (and its sublists) into contiguous
+  // storage. No edges can be added afterwards.  Tasks without a label are named after
+  // their position in the list.
+  void FinalizeGraph(const std::string &prefix) {
+    auto &csr = storage->csr_edges;
+    csr.clear();
+    int n = 0;
+    storage->tasks.ForEach([&](Task *t) {
+      t->AppendEdges(csr);
+      if (t->GetLabel().empty()) t->SetLabel(prefix + "task" + std::to_string(n));
+      t->SetCostMeter(cost_meter.get());
+      n++;
+    });
+    first_task->SetLabel(prefix + "first_task");
+    last_task->SetLabel(prefix + "last_task");
+    storage->tasks.ForEach([&csr](Task *t) { t->Finalize(csr.data()); });
+    for (int i = 0; i < sublists.size(); i++) {
+      if (sublists[i]->cost_meter == nullptr) sublists[i]->cost_meter = cost_meter;
+      sublists[i]->FinalizeGraph(prefix + "sublist" + std::to_string(i) + "/");
+    }
+  }
+
   template <class T, class U, class... Args1, class... Args2>
   void AddUserTask(TaskID &dep, TaskStatus (T::*func)(Args1...), U *obj,
                    Args2 &&...args) {
-    tasks.push_back(std::make_shared<Task>(
+    storage->tasks.emplace_back(
         dep,
         [=]() mutable -> TaskStatus {
           return (obj->*func)(std::forward<Args2>(args)...);
         },
-        exec_limits));
+        exec_limits);
   }
 
   template <class F, class... Args>
   void AddUserTask(TaskID &dep, F &&func, Args &&...args) {
-    tasks.push_back(std::make_shared<Task>(
+    storage->tasks.emplace_back(
         dep,
         [=, func = std::forward<F>(func)]() mutable -> TaskStatus {
           return func(std::forward<Args>(args)...);
         },
-        exec_limits));
+        exec_limits);
+  }
+};
+
+// What to do with tasks that keep returning TaskStatus::incomplete, which are typically
+// polling for messages.  Once a task has returned incomplete threshold times in a row
+// it is not requeued right away but deferred, first by initial_delay seconds and then
+// by twice as long after each further incomplete return, up to max_delay.  At most
+// max_polls_per_sweep deferred tasks are requeued at once.  Deferred tasks are requeued
+// whenever another task finishes, or, if there is nothing else to do, after sleeping
+// until the first of them is due.  A negative threshold disables the backoff.
+struct TaskBackoffPolicy {
+  int threshold = -1;
+  double initial_delay = 1.0e-6;
+  double max_delay = 1.0e-3;
+  int max_polls_per_sweep = std::numeric_limits<int>::max();
+
+  bool Enabled() const { return threshold >= 0; }
+  // the delay before the next attempt of a task that returned incomplete npolls times
+  double Delay(const int npolls) const {
+    const int n = std::min(npolls - threshold - 1, 30);
+    return std::min(initial_delay * static_cast<double>(1 << std::max(n, 0)), max_delay);
   }
 };
 
@@ -393,39 +582,148 @@ class TaskRegion {
       task_lists[i].SetID(i);
   }
 
-  TaskListStatus Execute(ThreadPool &pool) {
+  TaskListStatus Execute(ThreadPool &pool) { return Execute({this}, pool); }
+
+  // Execute several independent regions, e.g., of the members of an ensemble of
+  // simulations, together, so that the tasks of one can run while those of another are
+  // waiting, e.g., for messages or reductions.
+  static TaskListStatus Execute(const std::vector<TaskRegion *> &regions,
+                                ThreadPool &pool) {
     // for now, require a pool with one thread
     PARTHENON_REQUIRE_THROWS(pool.size() == 1,
                              "ThreadPool size != 1 is not currently supported.")
 
-    // first, if needed, finish building the graph
-    if (!graph_built) BuildGraph();
+    // first, if needed, finish building the graphs
+    for (auto region : regions) {
+      if (!region->graph_built) region->BuildGraph();
+    }
+
+    // if recording a timeline, remember when each task became ready and the event of
+    // the task that made it ready
+    TaskTimeline::Region *timeline =
+        (TaskTimeline::Recording() ? TaskTimeline::NewRegion() : nullptr);
+
+    // tasks that are backing off after repeatedly returning incomplete
+    using clock = std::chrono::steady_clock;
+    struct Deferred {
+      Task *task;
+      clock::time_point due;
+      int trigger;
+    };
+    const auto policy = backoff;
+    std::vector<Deferred> deferred;
+    std::mutex deferred_mutex;
+    std::atomic<int> ndeferred{0};
 
     // declare this so it can call itself
-    std::function<TaskStatus(Task *)> ProcessTask;
-    ProcessTask = [&pool, &ProcessTask](Task *task) -> TaskStatus {
+    std::function<TaskStatus(Task *, double, int)> ProcessTask;
+    // A priority task that returned incomplete is requeued with normal priority, since
+    // the priority queues are always drained first and it might be waiting for one of
+    // the normal tasks, e.g., a send waiting for the receives of a previous exchange.
+    auto Enqueue = [&pool, &ProcessTask](Task *t, const double ready, const int trigger) {
+      auto run = [=, &ProcessTask]() { return ProcessTask(t, ready, trigger); };
+      if (t->Priority() && t->NumPolls() == 0) {
+        pool.enqueue_priority(run);
+      } else {
+        pool.enqueue(run);
+      }
+    };
+    // requeue (some of) the deferred tasks that are due, returns when the earliest of
+    // the remaining ones is due
+    auto RequeueDeferred = [&]() {
+      std::lock_guard<std::mutex> lock(deferred_mutex);
+      std::sort(deferred.begin(), deferred.end(),
+                [](const Deferred &a, const Deferred &b) { return a.due < b.due; });
+      const auto now = clock::now();
+      int n = 0;
+      while (n < static_cast<int>(deferred.size()) && n < policy.max_polls_per_sweep &&
+             deferred[n].due <= now) {
+        Enqueue(deferred[n].task, timeline ? TaskTimeline::Now() : 0.0,
+                deferred[n].trigger);
+        n++;
+      }
+      deferred.erase(deferred.begin(), deferred.begin() + n);
+      ndeferred = deferred.size();
+      return (deferred.empty() ? now : deferred.front().due);
+    };
+    ProcessTask = [&](Task *task, const double ready, const int trigger) -> TaskStatus {
+      const double start = (timeline ? TaskTimeline::Now() : 0.0);
+      TaskCostMeter *meter = task->GetCostMeter();
+      const auto meter_start = (meter ? clock::now() : clock::time_point());
       auto status = task->operator()();
+      if (meter) {
+        meter->Finish();
+        meter->Add(std::chrono::duration<double>(clock::now() - meter_start).count());
+      }
+      task->release();
+      int event = -1;
+      if (timeline) {
+        event = timeline->Record({task->GetLabel(), pool.this_thread_id(), status, ready,
+                                  start, TaskTimeline::Now(), trigger});
+      }
+      if (status == TaskStatus::incomplete) incomplete_polls++;
+      const bool back_off =
+          (policy.Enabled() && status == TaskStatus::incomplete &&
+           task->NumPolls() > policy.threshold);
       auto next_up = task->GetDependent(status);
       for (auto t : next_up) {
-        if (t->ready()) {
-          pool.enqueue([t, &ProcessTask]() { return ProcessTask(t); });
+        if (t->ready() && t->claim()) {
+          if (back_off && t == task) {
+            const std::chrono::duration<double> delay(policy.Delay(task->NumPolls()));
+            std::lock_guard<std::mutex> lock(deferred_mutex);
+            deferred.push_back(
+                {t, clock::now() + std::chrono::duration_cast<clock::duration>(delay),
+                 event});
+            ndeferred++;
+          } else {
+            Enqueue(t, timeline ? TaskTimeline::Now() : 0.0, event);
+          }
         }
       }
+      if (ndeferred > 0) RequeueDeferred();
       return status;
     };
 
+    // Reset all lists before any of them starts.  Each list also resets itself in its
+    // first_task, but tasks that depend on the tasks of other lists, e.g. through
+    // regional dependencies, would otherwise see their status of a previous execution.
+    for (auto region : regions) {
+      for (auto &tl : region->task_lists) {
+        tl.storage->ResetStatus();
+      }
+    }
+
     // now enqueue the "first_task" for all task lists
-    for (auto &tl : task_lists) {
-      auto t = tl.GetStartupTask();
-      pool.enqueue([t, &ProcessTask]() { return ProcessTask(t); });
+    const double t_ready = (timeline ? TaskTimeline::Now() : 0.0);
+    for (auto region : regions) {
+      for (auto &tl : region->task_lists) {
+        auto t = tl.GetStartupTask();
+        t->claim();
+        Enqueue(t, t_ready, -1);
+      }
     }
 
-    // then wait until everything is done
+    // then wait until everything is done.  Once nothing else is running, deferred tasks
+    // are all that is left, so sleep until the next one is due.
     pool.wait();
+    while (ndeferred > 0) {
+      std::this_thread::sleep_until(RequeueDeferred());
+      RequeueDeferred();
+      pool.wait();
+    }
 
     return TaskListStatus::complete;
   }
 
+  // the backoff policy for tasks that repeatedly return incomplete, see
+  // TaskBackoffPolicy.  Takes effect for regions executed afterwards.
+  static void SetBackoffPolicy(const TaskBackoffPolicy &policy) { backoff = policy; }
+  static const TaskBackoffPolicy &GetBackoffPolicy() { return backoff; }
+  // the number of times any task returned incomplete, i.e. wasted polls, since the
+  // last reset
+  static std::uint64_t NumIncompletePolls() { return incomplete_polls; }
+  static void ResetIncompletePolls() { incomplete_polls = 0; }
+
   TaskList &operator[](const int i) { return task_lists[i]; }
 
   size_t size() const { return task_lists.size(); }
@@ -433,6 +731,8 @@ class TaskRegion {
  private:
   std::vector<TaskList> task_lists;
   bool graph_built = false;
+  inline static TaskBackoffPolicy backoff;
+  inline static std::atomic<std::uint64_t> incomplete_polls{0};
 
   void BuildGraph() {
     // first handle regional dependencies
@@ -466,6 +766,11 @@ class TaskRegion {
       tl.ConnectIteration();
     }
 
+    // and store the final graph compactly
+    for (int i = 0; i < num_lists; i++) {
+      task_lists[i].FinalizeGraph("list" + std::to_string(i) + "/");
+    }
+
     graph_built = true;
   }
 };
@@ -491,6 +796,30 @@ class TaskCollection {
     return TaskListStatus::complete;
   }
 
+  // Execute several independent collections together.  The n-th regions of all
+  // collections are executed at the same time (see TaskRegion::Execute), so the
+  // collections only synchronize in between regions.
+  static TaskListStatus Execute(const std::vector<TaskCollection *> &collections) {
+    ThreadPool pool(1);
+    return Execute(collections, pool);
+  }
+  static TaskListStatus Execute(const std::vector<TaskCollection *> &collections,
+                                ThreadPool &pool) {
+    std::vector<std::list<TaskRegion>::iterator> next;
+    for (auto tc : collections) {
+      next.push_back(tc->regions.begin());
+    }
+    while (true) {
+      std::vector<TaskRegion *> regions;
+      for (int i = 0; i < collections.size(); i++) {
+        if (next[i] != collections[i]->regions.end()) regions.push_back(&*(next[i]++));
+      }
+      if (regions.empty()) return TaskListStatus::complete;
+      const auto status = TaskRegion::Execute(regions, pool);
+      if (status != TaskListStatus::complete) return status;
+    }
+  }
+
  private:
   std::list<TaskRegion> regions;
 };
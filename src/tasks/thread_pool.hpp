@@ -14,124 +14,231 @@
 #ifndef TASKS_THREAD_POOL_HPP_
 #define TASKS_THREAD_POOL_HPP_
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
+#include <initializer_list>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
 #include <vector>
 
 namespace parthenon {
 
+// A double ended queue owned by a single worker thread.  The owner pushes at the back
+// and pops at the front (FIFO), so a task that requeues itself, e.g., while polling for
+// a message, goes behind the work that was already waiting and can't starve it.  Other
+// workers steal from the back.  Each queue has its own lock, so there is no pool-wide
+// serialization point on push or pop.
 template <typename T>
-class ThreadQueue {
+class WorkStealingQueue {
  public:
-  explicit ThreadQueue(const int num_workers) : nworkers(num_workers), nwaiting(0) {}
   void push(T q) {
     std::lock_guard<std::mutex> lock(mutex);
-    queue.push(q);
-    cv.notify_one();
+    queue.push_back(std::move(q));
   }
   bool pop(T &q) {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (queue.empty()) {
-      nwaiting++;
-      if (waiting && nwaiting == nworkers) {
-        complete = true;
-        complete_cv.notify_all();
-      }
-      cv.wait(lock, [this]() { return exit || !queue.empty(); });
-      nwaiting--;
-      if (exit) return true;
-    }
-    q = queue.front();
-    queue.pop();
-    return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queue.empty()) return false;
+    q = std::move(queue.front());
+    queue.pop_front();
+    return true;
   }
-  void signal_kill() {
+  bool steal(T &q) {
     std::lock_guard<std::mutex> lock(mutex);
-    std::queue<T>().swap(queue);
-    complete = true;
-    exit = true;
-    cv.notify_all();
+    if (queue.empty()) return false;
+    q = std::move(queue.back());
+    queue.pop_back();
+    return true;
   }
-  void signal_exit_when_finished() {
+  int clear() {
     std::lock_guard<std::mutex> lock(mutex);
-    exit = true;
-    complete = true;
-    cv.notify_all();
-  }
-  void wait_for_complete() {
-    std::unique_lock<std::mutex> lock(mutex);
-    waiting = true;
-    if (queue.empty() && nwaiting == nworkers) {
-      complete = false;
-      waiting = false;
-      return;
-    }
-    complete_cv.wait(lock, [this]() { return complete; });
-    complete = false;
-    waiting = false;
+    const int n = queue.size();
+    std::deque<T>().swap(queue);
+    return n;
   }
 
  private:
-  const int nworkers;
-  int nwaiting;
-  std::queue<T> queue;
+  std::deque<T> queue;
   std::mutex mutex;
-  std::condition_variable cv;
-  std::condition_variable complete_cv;
-  bool complete = false;
-  bool exit = false;
-  bool waiting = false;
 };
 
 class ThreadPool {
  public:
   explicit ThreadPool(const int numthreads = std::thread::hardware_concurrency())
-      : nthreads(numthreads), queue(nthreads) {
+      : nthreads(numthreads), queues(nthreads), priority_queues(nthreads) {
     for (int i = 0; i < nthreads; i++) {
-      auto worker = [&]() {
+      auto worker = [&, i]() {
+        current_pool = this;
+        thread_id = i;
         while (true) {
           std::function<void()> f;
-          auto stop = queue.pop(f);
+          auto stop = get_task(i, f);
           if (stop) break;
           if (f) f();
+          finish_task();
         }
       };
       threads.emplace_back(worker);
     }
   }
   ~ThreadPool() {
-    queue.signal_exit_when_finished();
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      exit = true;
+    }
+    sleep_cv.notify_all();
     for (auto &t : threads) {
       t.join();
     }
   }
 
-  void wait() { queue.wait_for_complete(); }
+  // block until every enqueued task, including tasks enqueued by running tasks, is done
+  void wait() {
+    std::unique_lock<std::mutex> lock(complete_mutex);
+    complete_cv.wait(lock, [this]() { return noutstanding == 0 || killed; });
+  }
 
-  void kill() { queue.signal_kill(); }
+  // drop all queued work and stop the workers as soon as their current task returns
+  void kill() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      killed = true;
+      exit = true;
+    }
+    for (auto *qs : {&priority_queues, &queues}) {
+      for (auto &q : *qs) {
+        const int n = q.clear();
+        nqueued -= n;
+        noutstanding -= n;
+      }
+    }
+    sleep_cv.notify_all();
+    std::lock_guard<std::mutex> lock(complete_mutex);
+    complete_cv.notify_all();
+  }
 
+  // Tasks enqueued from a worker of this pool go on that worker's own queue, otherwise
+  // they are distributed round-robin.  Idle workers steal, so placement is only a hint.
   template <typename F, class... Args>
   std::future<typename std::result_of<F(Args...)>::type> enqueue(F &&f, Args &&...args) {
-    using return_t = typename std::result_of<F(Args...)>::type;
-    auto task = std::make_shared<std::packaged_task<return_t()>>(
-        [=, func = std::forward<F>(f)] { return func(std::forward<Args>(args)...); });
-    std::future<return_t> result = task->get_future();
-    queue.push([task]() { (*task)(); });
-    return result;
+    return enqueue_on(-1, std::forward<F>(f), std::forward<Args>(args)...);
+  }
+
+  // Same as enqueue, but the task is placed on the queue of worker thread_preference
+  // (modulo the pool size). A negative thread_preference falls back to the default
+  // placement of enqueue.
+  template <typename F, class... Args>
+  std::future<typename std::result_of<F(Args...)>::type>
+  enqueue_on(const int thread_preference, F &&f, Args &&...args) {
+    return enqueue_impl(thread_preference, false, std::forward<F>(f),
+                        std::forward<Args>(args)...);
+  }
+
+  // Same as enqueue, but the task is run before any task enqueued without priority that
+  // has not started yet, e.g. to get messages on the wire as early as possible.
+  template <typename F, class... Args>
+  std::future<typename std::result_of<F(Args...)>::type>
+  enqueue_priority(F &&f, Args &&...args) {
+    return enqueue_impl(-1, true, std::forward<F>(f), std::forward<Args>(args)...);
   }
 
   int size() const { return nthreads; }
 
+  // index of the calling thread within this pool, or -1 if it is not one of its workers
+  int this_thread_id() const { return (current_pool == this ? thread_id : -1); }
+
  private:
   const int nthreads;
   std::vector<std::thread> threads;
-  ThreadQueue<std::function<void()>> queue;
+  std::vector<WorkStealingQueue<std::function<void()>>> queues;
+  std::vector<WorkStealingQueue<std::function<void()>>> priority_queues;
+  std::atomic<int> next_queue{0};
+  // tasks sitting in a queue, and tasks that are queued or running
+  std::atomic<int> nqueued{0};
+  std::atomic<int> noutstanding{0};
+  std::atomic<int> nsleeping{0};
+  std::mutex sleep_mutex;
+  std::condition_variable sleep_cv;
+  std::mutex complete_mutex;
+  std::condition_variable complete_cv;
+  bool exit = false;
+  std::atomic<bool> killed{false};
+
+  inline static thread_local const ThreadPool *current_pool = nullptr;
+  inline static thread_local int thread_id = -1;
+
+  template <typename F, class... Args>
+  std::future<typename std::result_of<F(Args...)>::type>
+  enqueue_impl(const int thread_preference, const bool priority, F &&f,
+               Args &&...args) {
+    using return_t = typename std::result_of<F(Args...)>::type;
+    auto task = std::make_shared<std::packaged_task<return_t()>>(
+        [=, func = std::forward<F>(f)]() mutable {
+          return func(std::forward<Args>(args)...);
+        });
+    std::future<return_t> result = task->get_future();
+    push(thread_preference, priority, [task]() { (*task)(); });
+    return result;
+  }
+
+  void push(const int thread_preference, const bool priority,
+            std::function<void()> &&f) {
+    int q = thread_preference;
+    if (q < 0) q = this_thread_id();
+    if (q < 0) q = next_queue++;
+    noutstanding++;
+    (priority ? priority_queues : queues)[q % nthreads].push(std::move(f));
+    nqueued++;
+    if (nsleeping > 0) {
+      // taking the lock guarantees a worker between its check of nqueued and going to
+      // sleep can't miss this notification
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      sleep_cv.notify_one();
+    }
+  }
+
+  // priority tasks anywhere in the pool are taken before any other task
+  bool try_get_task(const int id, std::function<void()> &f) {
+    if (nqueued == 0) return false;
+    for (auto *qs : {&priority_queues, &queues}) {
+      if ((*qs)[id].pop(f)) {
+        nqueued--;
+        return true;
+      }
+      for (int i = 1; i < nthreads; i++) {
+        if ((*qs)[(id + i) % nthreads].steal(f)) {
+          nqueued--;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // returns true if the worker should exit
+  bool get_task(const int id, std::function<void()> &f) {
+    while (true) {
+      if (killed) return true;
+      if (try_get_task(id, f)) return false;
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      nsleeping++;
+      sleep_cv.wait(lock, [this]() { return exit || nqueued > 0; });
+      nsleeping--;
+      // only leave when there is nothing left to do so the destructor drains the pool
+      if (exit && (killed || nqueued == 0)) return true;
+    }
+  }
+
+  void finish_task() {
+    if (--noutstanding == 0) {
+      std::lock_guard<std::mutex> lock(complete_mutex);
+      complete_cv.notify_all();
+    }
+  }
 };
 
 } // namespace parthenon
@@ -11,12 +11,16 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "basic_types.hpp"
 #include "parameter_input.hpp"
 #include "staged_integrator.hpp"
+#include "utils/error_checking.hpp"
 
 namespace parthenon {
 
@@ -49,6 +53,7 @@ ButcherIntegrator::ButcherIntegrator(const std::string &name) : StagedIntegrator
     a[0][0] = 0;
     b[0] = 1;
     c[0] = 0;
+    order = 1;
   } else if (name_ == "rk2") {
     // Heun's method. Should match minimal storage solution
     nstages = nbuffers = 2;
@@ -58,6 +63,7 @@ ButcherIntegrator::ButcherIntegrator(const std::string &name) : StagedIntegrator
     a[1] = {1, 0};
     b = {0, 1};
     c = {0, 1. / 3., 2. / 3.};
+    order = 2;
   } else if (name_ == "rk4") {
     // Classic RK4 because why not
     nstages = nbuffers = 4;
@@ -71,6 +77,47 @@ ButcherIntegrator::ButcherIntegrator(const std::string &name) : StagedIntegrator
     /* clang-format on */
     b = {1. / 6., 1. / 3., 1. / 3., 1. / 6.};
     c = {0, 0.5, 0.5, 1};
+    order = 4;
+  } else if (name_ == "bs3") {
+    // Bogacki & Shampine, Appl. Math. Lett. 2 (1989) 321-325
+    // Third order with an embedded second order method. The last stage is evaluated
+    // at the new solution, so it could be reused as the first stage of the next step.
+    nstages = nbuffers = 4;
+    Resize_(nstages);
+
+    /* clang-format off */
+    a[0] = {0,       0,       0,       0};
+    a[1] = {0.5,     0,       0,       0};
+    a[2] = {0,       0.75,    0,       0};
+    a[3] = {2. / 9., 1. / 3., 4. / 9., 0};
+    /* clang-format on */
+    b = {2. / 9., 1. / 3., 4. / 9., 0};
+    bhat = {7. / 24., 0.25, 1. / 3., 0.125};
+    c = {0, 0.5, 0.75, 1};
+    order = 3;
+    embedded_order = 2;
+  } else if (name_ == "dp5") {
+    // Dormand & Prince, J. Comput. Appl. Math. 6 (1980) 19-26
+    // Fifth order with an embedded fourth order method, as in DOPRI5 and MATLAB's ode45
+    nstages = nbuffers = 7;
+    Resize_(nstages);
+
+    /* clang-format off */
+    a[0] = {0, 0, 0, 0, 0, 0, 0};
+    a[1] = {1. / 5., 0, 0, 0, 0, 0, 0};
+    a[2] = {3. / 40., 9. / 40., 0, 0, 0, 0, 0};
+    a[3] = {44. / 45., -56. / 15., 32. / 9., 0, 0, 0, 0};
+    a[4] = {19372. / 6561., -25360. / 2187., 64448. / 6561., -212. / 729., 0, 0, 0};
+    a[5] = {9017. / 3168., -355. / 33., 46732. / 5247., 49. / 176., -5103. / 18656., 0,
+            0};
+    a[6] = {35. / 384., 0, 500. / 1113., 125. / 192., -2187. / 6784., 11. / 84., 0};
+    /* clang-format on */
+    b = {35. / 384., 0, 500. / 1113., 125. / 192., -2187. / 6784., 11. / 84., 0};
+    bhat = {5179. / 57600.,   0,           7571. / 16695., 393. / 640.,
+            -92097. / 339200., 187. / 2100., 1. / 40.};
+    c = {0, 0.2, 0.3, 0.8, 8. / 9., 1, 1};
+    order = 5;
+    embedded_order = 4;
   } else if (name_ == "rk10") {
     // Feagin's family of high-order embedded methods as introduced in
     // Feagin, Neural, Parallel, and Scientific Computations 20 (2012)
@@ -220,7 +267,11 @@ ButcherIntegrator::ButcherIntegrator(const std::string &name) : StagedIntegrator
     a[16][13] = -0.259111214548322744512977076191767379267783684543182428778156;
     a[16][14] = -0.342758159847189839942220553413850871742338734703958919937260;
     a[16][15] = -0.675000000000000000000000000000000000000000000000000000000000;
+    order = 10;
+  } else {
+    throw std::invalid_argument("Invalid selection for the time integrator: " + name_);
   }
+  AssignRegisters_();
 }
 
 //----------------------------------------------------------------------------------------
@@ -228,7 +279,39 @@ ButcherIntegrator::ButcherIntegrator(const std::string &name) : StagedIntegrator
 //! \brief Constructs a ButcherIntegrator instance given ParameterInput *pin
 
 ButcherIntegrator::ButcherIntegrator(ParameterInput *pin)
-    : ButcherIntegrator(pin->GetOrAddString("parthenon/time", "integrator", "rk2")) {}
+    : ButcherIntegrator(pin->GetOrAddString("parthenon/time", "integrator", "rk2")) {
+  adaptive = pin->GetOrAddBoolean("parthenon/time", "adaptive", false);
+  rtol = pin->GetOrAddReal("parthenon/time", "rtol", rtol);
+  atol = pin->GetOrAddReal("parthenon/time", "atol", atol);
+  safety = pin->GetOrAddReal("parthenon/time", "dt_safety", safety);
+  min_factor = pin->GetOrAddReal("parthenon/time", "dt_min_factor", min_factor);
+  max_factor = pin->GetOrAddReal("parthenon/time", "dt_max_factor", max_factor);
+  max_rejections =
+      pin->GetOrAddInteger("parthenon/time", "max_rejections", max_rejections);
+  PARTHENON_REQUIRE_THROWS(!adaptive || HasEmbeddedMethod(),
+                           "parthenon/time/adaptive requires an integrator with an "
+                           "embedded method, i.e., bs3 or dp5");
+  PARTHENON_REQUIRE_THROWS(rtol >= 0 && atol >= 0 && rtol + atol > 0,
+                           "parthenon/time/rtol and atol must not be negative and not "
+                           "both zero");
+  PARTHENON_REQUIRE_THROWS(0 < min_factor && min_factor < 1 && max_factor > 1,
+                           "parthenon/time/dt_min_factor must be in (0, 1) and "
+                           "dt_max_factor larger than one");
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  Real ButcherIntegrator::ProposeDt(const Real err, const Real dt) const
+//! \brief The timestep for which the error norm is expected to be safety, given the
+//!        error norm err of a step of size dt, limited to [min_factor, max_factor] * dt
+
+Real ButcherIntegrator::ProposeDt(const Real err, const Real dt) const {
+  // the error estimate is that of the embedded method
+  Real factor = max_factor;
+  if (err > 0) {
+    factor = safety * std::pow(err, -1.0 / (embedded_order + 1));
+  }
+  return dt * std::min(max_factor, std::max(min_factor, factor));
+}
 
 //----------------------------------------------------------------------------------------
 //! \fn  void ButcherIntegrator::Resize_(int nstages)
@@ -243,4 +326,35 @@ void ButcherIntegrator::Resize_(int nstages) {
   c.resize(nstages);
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  void ButcherIntegrator::AssignRegisters_()
+//! \brief Assigns the stages to as few registers as possible, see stage_register
+
+void ButcherIntegrator::AssignRegisters_() {
+  // the last stage whose stage sum needs each stage
+  std::vector<int> last_use(nstages);
+  for (int j = 0; j < nstages; ++j) {
+    last_use[j] = j;
+    for (int i = j + 1; i < nstages; ++i) {
+      if (a[i][j] != 0.0) last_use[j] = i;
+    }
+  }
+  // The stage sum of stage i is taken before stage i is computed, so stage i can take
+  // the register of a stage that is last used by stage i. Since stages are assigned in
+  // the order they are computed, taking the first free register is optimal.
+  std::vector<int> busy_until;
+  stage_register.resize(nstages);
+  for (int i = 0; i < nstages; ++i) {
+    const int nbusy = static_cast<int>(busy_until.size());
+    int r = 0;
+    while (r < nbusy && busy_until[r] > i) {
+      ++r;
+    }
+    if (r == nbusy) busy_until.push_back(0);
+    busy_until[r] = last_use[i];
+    stage_register[i] = r;
+  }
+  nregisters = static_cast<int>(busy_until.size());
+}
+
 } // namespace parthenon
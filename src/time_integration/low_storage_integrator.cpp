@@ -42,6 +42,12 @@ namespace parthenon {
  * The form is also described in Section 3.2.3 of the Athena++ paper:
  * Stone et al., ApJS (2020) 249:4
  * See equations 11 through 15.
+ *
+ * Methods in the 2N form of Williamson, JComp 35 (1980) 48-56, also need only two
+ * registers, u and du, for any number of stages:
+ * du := A_s du + dt F(u)
+ * u := u + B_s du
+ * These are not of the 2S form, so their stages are taken with Update::Update2N.
  */
 
 //----------------------------------------------------------------------------------------
@@ -153,6 +159,27 @@ LowStorageIntegrator::LowStorageIntegrator(const std::string &name)
     beta[4] = 0.433334235669763;
     gam0[4] = 0.770411587328417;
     gam1[4] = 0.229588412671583;
+  } else if (name_ == "rk3_2n") {
+    // Williamson's 3-stage 3rd order method in 2N form
+    // Williamson, JComp 35 (1980) 48-56
+    storage = Storage::two_n;
+    nstages = 3;
+    nbuffers = 2;
+    williamson_a = {0.0, -5.0 / 9.0, -153.0 / 128.0};
+    williamson_b = {1.0 / 3.0, 15.0 / 16.0, 8.0 / 15.0};
+  } else if (name_ == "rk4_2n") {
+    // 5-stage 4th order method in 2N form
+    // Carpenter & Kennedy, NASA TM-109112 (1994)
+    storage = Storage::two_n;
+    nstages = 5;
+    nbuffers = 2;
+    williamson_a = {0.0, -567301805773.0 / 1357537059087.0,
+                    -2404267990393.0 / 2016746695238.0,
+                    -3550918686646.0 / 2091501179385.0,
+                    -1275806237668.0 / 842570457699.0};
+    williamson_b = {1432997174477.0 / 9575080441755.0, 5161836677717.0 / 13612068292357.0,
+                    1720146321549.0 / 2090206949498.0, 3134564353537.0 / 4481467310338.0,
+                    2277821191437.0 / 14882151754819.0};
   } else {
     throw std::invalid_argument("Invalid selection for the time integrator: " + name_);
   }
@@ -14,6 +14,7 @@
 #ifndef TIME_INTEGRATION_STAGED_INTEGRATOR_HPP_
 #define TIME_INTEGRATION_STAGED_INTEGRATOR_HPP_
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -48,13 +49,23 @@ class StagedIntegrator {
 
 class LowStorageIntegrator : public StagedIntegrator {
  public:
+  // How the two registers of a method are updated in every stage, i.e., whether the
+  // stages are taken with Update::Update2S (Ketcheson's 2S and 2S* forms, rk1 through
+  // rk4 and vl2) or with Update::Update2N (Williamson's 2N form, rk3_2n and rk4_2n).
+  enum class Storage { two_s, two_n };
+
   LowStorageIntegrator() = default;
   explicit LowStorageIntegrator(const std::string &name);
   explicit LowStorageIntegrator(ParameterInput *pin);
+  Storage storage = Storage::two_s;
+  // coefficients of the 2S forms
   std::vector<Real> delta;
   std::vector<Real> beta;
   std::vector<Real> gam0;
   std::vector<Real> gam1;
+  // coefficients of the 2N form, du := A du + dt F(u) and u := u + B du
+  std::vector<Real> williamson_a;
+  std::vector<Real> williamson_b;
 };
 
 // TODO(JMM): Should this be named ButcherTableauIntegrator?
@@ -66,9 +77,43 @@ class ButcherIntegrator : public StagedIntegrator {
   // TODO(JMM): Should I do a flat array with indexing instead?
   std::vector<std::vector<Real>> a;
   std::vector<Real> b, c;
+  // Weights of the embedded lower order method of the tableaus that have one (bs3 and
+  // dp5), which are empty otherwise. The difference of the two updates estimates the
+  // error of a step.
+  std::vector<Real> bhat;
+  // order of the method and of its embedded method
+  int order = 0, embedded_order = 0;
+
+  // If the stages are accumulated into the new solution as they are computed, see
+  // Update::AccumulateButcher, stage j is only needed until the last stage i with
+  // a[i][j] != 0, so stages whose lifetimes don't overlap can share storage. Stage j is
+  // stored in register stage_register[j] out of nregisters, e.g., one for rk4 instead of
+  // four. Error estimates need all stages, so they can't use the registers.
+  std::vector<int> stage_register;
+  int nregisters = 0;
+
+  bool HasEmbeddedMethod() const { return !bhat.empty(); }
+
+  // Error control, see Hairer, Norsett & Wanner, Solving Ordinary Differential
+  // Equations I, Sec. II.4. If adaptive, MultiStageDriverGeneric retries steps whose
+  // error norm, i.e., the largest error relative to atol + rtol * |u| over all cells, is
+  // larger than one with a smaller dt, and proposes the timestep of the next cycle from
+  // the error norm of the accepted step.
+  bool adaptive = false;
+  Real rtol = 1.0e-6, atol = 1.0e-6;
+  Real safety = 0.9, min_factor = 0.2, max_factor = 5.0;
+  int max_rejections = 10;
+  // error norm of the current step on this rank, set by Update::EstimateButcherError.
+  // Negative while no estimate has been recorded
+  Real error = 0.0;
+
+  void AccumulateError(const Real err) { error = std::max(error, err); }
+  // timestep for a step with error norm err after a step of size dt
+  Real ProposeDt(const Real err, const Real dt) const;
 
  protected:
   void Resize_(int nstages);
+  void AssignRegisters_();
 };
 
 } // namespace parthenon
@@ -46,12 +46,54 @@ class AliasMethod {
   // distribution [0,1) that need to be provided.
   // This function can be called inside Kokkos loops on the device.
   KOKKOS_INLINE_FUNCTION int Sample(Real rand1, Real rand2) const {
-    int idx = static_cast<int>(rand1 * prob_table.size());
+    const int n = prob_table.size();
+    // rand1 * n can round up to n for rand1 just below 1
+    const int idx = Kokkos::min(static_cast<int>(rand1 * n), n - 1);
     if ((rand2 >= prob_table(idx)) && (alias_table(idx) != -1))
       return alias_table(idx);
     else
       return idx;
   }
+
+  // Same as above, drawing the two random numbers from a generator of a Kokkos random
+  // pool, e.g., from Kokkos::Random_XorShift64_Pool::get_state.
+  template <class Generator>
+  KOKKOS_INLINE_FUNCTION int Sample(Generator &gen) const {
+    const Real rand1 = gen.drand();
+    const Real rand2 = gen.drand();
+    return Sample(rand1, rand2);
+  }
+
+  // Draw samples.size() samples in a single kernel on the device, with random numbers
+  // from rng_pool. Each generator taken from the pool draws a batch of samples, so
+  // that the pool is not accessed for every sample.
+  template <class RandomPool>
+  void Sample(const Kokkos::View<int *> &samples, const RandomPool &rng_pool) const {
+    constexpr int samples_per_state = 64;
+    const int n = samples.size();
+    const int nbatches = (n + samples_per_state - 1) / samples_per_state;
+    const AliasMethod alias = *this;
+    par_for(
+        DEFAULT_LOOP_PATTERN, "AliasMethod::Sample", DevExecSpace(), 0, nbatches - 1,
+        KOKKOS_LAMBDA(const int b) {
+          auto gen = rng_pool.get_state();
+          const int end = Kokkos::min(n, (b + 1) * samples_per_state);
+          for (int i = b * samples_per_state; i < end; ++i) {
+            samples(i) = alias.Sample(gen);
+          }
+          rng_pool.free_state(gen);
+        });
+  }
+
+  // Same as above, returning n new samples
+  template <class RandomPool>
+  Kokkos::View<int *> Sample(const int n, const RandomPool &rng_pool) const {
+    Kokkos::View<int *> samples(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                                   "alias method samples"),
+                                n);
+    Sample(samples, rng_pool);
+    return samples;
+  }
 };
 
 } // namespace AliasMethod
@@ -0,0 +1,107 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_COMM_COUNTERS_HPP_
+#define UTILS_COMM_COUNTERS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "basic_types.hpp"
+
+namespace parthenon {
+
+// Number of messages and bytes this rank has sent to and received from other ranks
+// since the start of the run, by the kind of traffic.  The kinds are the BoundaryType of
+// the CommBuffer carrying the message (see CommBuffer::CountAs), plus the messages that
+// migrate blocks between ranks when remeshing or load balancing.  Messages of zero bytes
+// tell the receiver that a sparse variable is unallocated and are counted as null
+// messages.  Buffers that are coalesced into one message per rank pair are still
+// counted as individual messages.  Counting is thread-safe.
+namespace CommCounters {
+constexpr int migration = NUM_BNDRY_TYPES;
+constexpr int nkinds = NUM_BNDRY_TYPES + 1;
+
+inline const char *Name(const int kind) {
+  constexpr std::array<const char *, nkinds> names{"local",
+                                                   "nonlocal",
+                                                   "any",
+                                                   "flxcor_send",
+                                                   "flxcor_recv",
+                                                   "gmg_same",
+                                                   "gmg_restrict_send",
+                                                   "gmg_restrict_recv",
+                                                   "gmg_prolongate_send",
+                                                   "gmg_prolongate_recv",
+                                                   "migration"};
+  return names[kind];
+}
+
+struct Counts {
+  std::uint64_t send_msgs = 0, send_bytes = 0, send_null = 0;
+  std::uint64_t recv_msgs = 0, recv_bytes = 0, recv_null = 0;
+
+  Counts operator-(const Counts &other) const {
+    return Counts{send_msgs - other.send_msgs, send_bytes - other.send_bytes,
+                  send_null - other.send_null, recv_msgs - other.recv_msgs,
+                  recv_bytes - other.recv_bytes, recv_null - other.recv_null};
+  }
+  Counts &operator+=(const Counts &other) {
+    send_msgs += other.send_msgs;
+    send_bytes += other.send_bytes;
+    send_null += other.send_null;
+    recv_msgs += other.recv_msgs;
+    recv_bytes += other.recv_bytes;
+    recv_null += other.recv_null;
+    return *this;
+  }
+};
+
+namespace impl {
+enum Counter { send_msgs, send_bytes, send_null, recv_msgs, recv_bytes, recv_null, n };
+inline std::array<std::array<std::atomic<std::uint64_t>, n>, nkinds> counters{};
+inline void Count(const int kind, const Counter msgs, const Counter bytes,
+                  const Counter null, const std::size_t nbytes) {
+  auto &c = counters[kind];
+  c[msgs].fetch_add(1, std::memory_order_relaxed);
+  c[bytes].fetch_add(nbytes, std::memory_order_relaxed);
+  if (nbytes == 0) c[null].fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace impl
+
+inline void CountSend(const int kind, const std::size_t nbytes) {
+  impl::Count(kind, impl::send_msgs, impl::send_bytes, impl::send_null, nbytes);
+}
+inline void CountReceive(const int kind, const std::size_t nbytes) {
+  impl::Count(kind, impl::recv_msgs, impl::recv_bytes, impl::recv_null, nbytes);
+}
+
+inline Counts Get(const int kind) {
+  const auto &c = impl::counters[kind];
+  return Counts{c[impl::send_msgs], c[impl::send_bytes], c[impl::send_null],
+                c[impl::recv_msgs], c[impl::recv_bytes], c[impl::recv_null]};
+}
+inline std::vector<Counts> GetAll() {
+  std::vector<Counts> all;
+  for (int kind = 0; kind < nkinds; ++kind) {
+    all.push_back(Get(kind));
+  }
+  return all;
+}
+} // namespace CommCounters
+
+} // namespace parthenon
+
+#endif // UTILS_COMM_COUNTERS_HPP_
@@ -18,15 +18,20 @@
 #ifndef UTILS_COMMUNICATION_BUFFER_HPP_
 #define UTILS_COMMUNICATION_BUFFER_HPP_
 
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "basic_types.hpp"
 #include "globals.hpp"
+#include "kokkos_abstraction.hpp"
 #include "parthenon_mpi.hpp"
+#include "utils/comm_counters.hpp"
 #include "utils/mpi_types.hpp"
 
 namespace parthenon {
@@ -39,6 +44,34 @@ enum class BufferState { stale, sending, sending_null, received, received_null }
 
 enum class BuffCommType { sender, receiver, both, sparse_receiver };
 
+// Scratch space of CommBuffer::TryReceiveAll, which is kept between calls (e.g., in the
+// boundary cache of a MeshData) so that polling doesn't allocate
+struct CommReceiveBatch {
+#ifdef MPI_PARALLEL
+  std::vector<MPI_Request> requests;
+  std::vector<MPI_Status> statuses;
+#endif
+  // index of the buffer of each request and the requests that completed
+  std::vector<int> buffers;
+  std::vector<int> completed;
+};
+
+// A group of CommBuffers that are communicated with the same rank in a single MPI
+// message (see bvals/comms/coalesced_comm.hpp).  A CommBuffer that belongs to a group
+// does not post any MPI calls itself but leaves this to the group, which in turn sets
+// the state of all members once the message has been sent or received.
+class CommBufferGroup {
+ public:
+  virtual ~CommBufferGroup() = default;
+  // member has been filled (or is sending null) and can go out with the others
+  virtual void Send(int member) = 0;
+  // the message carrying the members is no longer in flight, so they may be rewritten
+  virtual bool SendComplete() = 0;
+  virtual void TryStartReceive() = 0;
+  // returns true once the message has arrived and been unpacked into the members
+  virtual bool TryReceive() = 0;
+};
+
 template <class T>
 class CommBuffer {
  private:
@@ -46,11 +79,52 @@ class CommBuffer {
   template <typename U>
   friend class CommBuffer;
 
-  std::shared_ptr<BufferState> state_;
-  std::shared_ptr<BuffCommType> comm_type_;
-  std::shared_ptr<bool> started_irecv_;
-  std::shared_ptr<int> nrecv_tries_;
-  std::shared_ptr<mpi_request_t> my_request_;
+  // State of a persistent request, which is stored in the request of the shared state
+  // and only needs to be initialized again when the memory (or size) of the message
+  // changes
+  struct PersistentRequest {
+    bool enabled = false;
+    void *data = nullptr;
+    int count = -1;
+    bool active = false;
+  };
+
+  // Everything that has to be seen by all shallow copies of a buffer, kept in a single
+  // allocation so that copying a buffer only touches one reference count
+  struct SharedState {
+    BufferState state = BufferState::stale;
+    BuffCommType comm_type = BuffCommType::both;
+    bool started_irecv = false;
+    int nrecv_tries = 0;
+#ifdef MPI_PARALLEL
+    mpi_request_t request = MPI_REQUEST_NULL;
+#else
+    mpi_request_t request = 0;
+#endif
+    PersistentRequest persistent;
+    std::function<T()> get_resource;
+  };
+  std::shared_ptr<SharedState> shared_;
+  std::shared_ptr<CommBufferGroup> group_;
+  int group_idx_ = -1;
+  // kind of traffic in CommCounters, or negative if not counted
+  int counter_kind_ = -1;
+
+  using buf_base_t = std::remove_pointer_t<decltype(std::declval<T>().data())>;
+
+  // Pinned host mirror of the buffer that messages are sent from and received into,
+  // for MPI libraries that can't access device memory (see UseHostStaging).  staged is
+  // the number of elements copied to the mirror for the next send, unstaged whether a
+  // received message still has to be copied back to the buffer.
+  struct HostStaging {
+    Kokkos::View<buf_base_t *, HostPinnedMemSpace> mirror;
+    int staged = -1;
+    int received = 0;
+    bool unstaged = true;
+  };
+  std::shared_ptr<HostStaging> staging_;
+  // pointer to the mirror of buf_ (grown as necessary) or to buf_ itself
+  buf_base_t *MessageData();
 
   int my_rank;
   int tag_;
@@ -58,23 +132,25 @@ class CommBuffer {
   int recv_rank_;
   mpi_comm_t comm_;
 
-  using buf_base_t = std::remove_pointer_t<decltype(std::declval<T>().data())>;
   buf_base_t null_buf_ = std::numeric_limits<buf_base_t>::signaling_NaN();
   bool active_ = false;
 
-  std::function<T()> get_resource_;
-
   T buf_;
 
- public:
-  CommBuffer()
-      : my_rank(0)
 #ifdef MPI_PARALLEL
-        ,
-        my_request_(std::make_shared<MPI_Request>(MPI_REQUEST_NULL))
+  // Post, test and wait on the request of the buffer, which is either created by
+  // MPI_Isend/MPI_Irecv or a persistent request that is restarted (see
+  // UsePersistentRequests)
+  void PostRequest(bool send, buf_base_t *data, int count);
+  bool RequestPending() const;
+  bool TestRequest(MPI_Status *status);
+  void WaitRequest();
+  // set the state of the buffer once its receive request has completed with status
+  void FinishReceive(MPI_Status *status);
 #endif
-  {
-  }
+
+ public:
+  CommBuffer() : my_rank(0) {}
 
   CommBuffer(int tag, int send_rank, int recv_rank, mpi_comm_t comm_,
              std::function<T()> get_resource, bool do_sparse_allocation = false);
@@ -95,7 +171,7 @@ class CommBuffer {
 
   void Allocate() {
     if (!active_) {
-      buf_ = get_resource_();
+      buf_ = shared_->get_resource();
       active_ = true;
     }
   }
@@ -107,19 +183,60 @@ class CommBuffer {
 
   bool IsActive() const { return active_; }
 
-  BufferState GetState() { return *state_; }
+  BufferState GetState() { return shared_->state; }
+  // only meant to be used by a CommBufferGroup
+  void SetState(BufferState state) { shared_->state = state; }
+  BuffCommType GetCommType() const { return shared_->comm_type; }
 
-  void Send() noexcept;
+  // communicate this buffer as member idx of group instead of in its own message
+  void SetGroup(std::shared_ptr<CommBufferGroup> group, int idx) {
+    group_ = group;
+    group_idx_ = idx;
+  }
+  bool InGroup() const { return group_ != nullptr; }
+
+  // Reuse a persistent MPI request (MPI_Send_init/MPI_Recv_init + MPI_Start) for the
+  // messages of this buffer instead of creating a new request for every message
+  void UsePersistentRequests() { shared_->persistent.enabled = true; }
+
+  // Send and receive the messages of this buffer through a mirror in pinned host memory
+  // instead of the buffer itself, for MPI libraries that can't access device memory.
+  // Outgoing data is copied to the mirror by StageForSend (or by Send itself, which then
+  // waits for the copy), and incoming data is copied back by Unstage.
+  void UseHostStaging() { staging_ = std::make_shared<HostStaging>(); }
+  bool UsesHostStaging() const { return staging_ != nullptr; }
+
+  // For buffers using host staging, start copying the first count elements (or all of
+  // them if count is negative) to the mirror on exec.  The copies of many buffers can be
+  // batched this way, and exec has to be fenced before they are sent.
+  template <class ExecSpace>
+  void StageForSend(const ExecSpace &exec, int count = -1);
+  // For buffers using host staging, copy a received message from the mirror to the
+  // buffer on exec, i.e., before any kernel on exec reads it
+  template <class ExecSpace>
+  void Unstage(const ExecSpace &exec);
+
+  // count the messages of this buffer to and from other ranks in CommCounters
+  void CountAs(BoundaryType type) { counter_kind_ = static_cast<int>(type); }
+
+  // Send the first count elements of the buffer, or all of it if count is negative.
+  // Buffers that are part of a group are always sent in full.
+  void Send(int count = -1) noexcept;
   void SendNull() noexcept;
 
   bool IsAvailableForWrite();
 
   void TryStartReceive() noexcept;
   bool TryReceive() noexcept;
+  // TryReceive on all of bufs, except that the requests of all buffers with a receive of
+  // their own in flight are tested at once by a single MPI_Testsome.  Returns true if
+  // all buffers have received.
+  static bool TryReceiveAll(const std::vector<CommBuffer *> &bufs,
+                            CommReceiveBatch *batch) noexcept;
   bool IsSafeToDelete() {
-    if (*comm_type_ == BuffCommType::sparse_receiver ||
-        *comm_type_ == BuffCommType::receiver) {
-      return *state_ == BufferState::stale;
+    if (shared_->comm_type == BuffCommType::sparse_receiver ||
+        shared_->comm_type == BuffCommType::receiver) {
+      return shared_->state == BufferState::stale;
     } else {
       return IsAvailableForWrite();
     }
@@ -132,24 +249,18 @@ class CommBuffer {
 template <class T>
 CommBuffer<T>::CommBuffer(int tag, int send_rank, int recv_rank, mpi_comm_t comm,
                           std::function<T()> get_resource, bool do_sparse_allocation)
-    : state_(std::make_shared<BufferState>(BufferState::stale)),
-      comm_type_(std::make_shared<BuffCommType>(BuffCommType::both)),
-      started_irecv_(std::make_shared<bool>(false)),
-      nrecv_tries_(std::make_shared<int>(0)),
-#ifdef MPI_PARALLEL
-      my_request_(std::make_shared<MPI_Request>(MPI_REQUEST_NULL)),
-#endif
-      tag_(tag), send_rank_(send_rank), recv_rank_(recv_rank), comm_(comm),
-      get_resource_(get_resource), buf_() {
+    : shared_(std::make_shared<SharedState>()), tag_(tag), send_rank_(send_rank),
+      recv_rank_(recv_rank), comm_(comm), buf_() {
   my_rank = Globals::my_rank;
+  shared_->get_resource = std::move(get_resource);
   if (send_rank == recv_rank) {
     assert(my_rank == send_rank);
-    *comm_type_ = BuffCommType::both;
+    shared_->comm_type = BuffCommType::both;
   } else if (my_rank == send_rank) {
-    *comm_type_ = BuffCommType::sender;
+    shared_->comm_type = BuffCommType::sender;
   } else if (my_rank == recv_rank) {
-    *comm_type_ = BuffCommType::receiver;
-    if (do_sparse_allocation) *comm_type_ = BuffCommType::sparse_receiver;
+    shared_->comm_type = BuffCommType::receiver;
+    if (do_sparse_allocation) shared_->comm_type = BuffCommType::sparse_receiver;
   } else {
     // This is an error
     std::cout << "CommBuffer initialization error" << std::endl;
@@ -159,30 +270,32 @@ CommBuffer<T>::CommBuffer(int tag, int send_rank, int recv_rank, mpi_comm_t comm
 template <class T>
 template <class U>
 CommBuffer<T>::CommBuffer(const CommBuffer<U> &in)
-    : buf_(in.buf_), state_(in.state_), comm_type_(in.comm_type_),
-      started_irecv_(in.started_irecv_), nrecv_tries_(in.nrecv_tries_),
-      my_request_(in.my_request_), tag_(in.tag_), send_rank_(in.send_rank_),
-      recv_rank_(in.recv_rank_), comm_(in.comm_), active_(in.active_) {
+    : buf_(in.buf_), shared_(in.shared_), group_(in.group_), group_idx_(in.group_idx_),
+      counter_kind_(in.counter_kind_), staging_(in.staging_), tag_(in.tag_),
+      send_rank_(in.send_rank_), recv_rank_(in.recv_rank_), comm_(in.comm_),
+      active_(in.active_) {
   my_rank = Globals::my_rank;
 }
 
 template <class T>
 CommBuffer<T>::~CommBuffer() {
 #ifdef MPI_PARALLEL
-  if (my_request_.use_count() == 1) { // This is the last shallow copy of this buffer
-    // Make sure that there are no MPI requests still flying around associated
-    // with this buffer before destroying it
-    int flag;
+  // Only the last shallow copy of a (non default constructed) buffer has to make sure
+  // that there are no MPI requests still flying around associated with this buffer
+  // before destroying it
+  if (shared_ && shared_.use_count() == 1) {
     MPI_Status status;
-    PARTHENON_MPI_CHECK(MPI_Test(my_request_.get(), &flag, &status));
-    if (!flag) {
-      if (*comm_type_ == BuffCommType::sender) {
-        PARTHENON_MPI_CHECK(MPI_Wait(my_request_.get(), MPI_STATUS_IGNORE));
+    if (!TestRequest(&status)) {
+      if (shared_->comm_type == BuffCommType::sender) {
+        WaitRequest();
       } else {
-        PARTHENON_MPI_CHECK(MPI_Cancel(my_request_.get()));
-        PARTHENON_MPI_CHECK(MPI_Wait(my_request_.get(), MPI_STATUS_IGNORE));
+        PARTHENON_MPI_CHECK(MPI_Cancel(&shared_->request));
+        WaitRequest();
       }
     }
+    // A completed persistent request stays allocated until it is freed
+    if (shared_->request != MPI_REQUEST_NULL)
+      PARTHENON_MPI_CHECK(MPI_Request_free(&shared_->request));
   }
 #endif
 }
@@ -191,11 +304,11 @@ template <class T>
 template <class U>
 CommBuffer<T> &CommBuffer<T>::operator=(const CommBuffer<U> &in) {
   buf_ = in.buf_;
-  state_ = in.state_;
-  comm_type_ = in.comm_type_;
-  started_irecv_ = in.started_irecv_;
-  nrecv_tries_ = in.nrecv_tries_;
-  my_request_ = in.my_request_;
+  shared_ = in.shared_;
+  group_ = in.group_;
+  group_idx_ = in.group_idx_;
+  counter_kind_ = in.counter_kind_;
+  staging_ = in.staging_;
   tag_ = in.tag_;
   send_rank_ = in.send_rank_;
   recv_rank_ = in.recv_rank_;
@@ -206,29 +319,45 @@ CommBuffer<T> &CommBuffer<T>::operator=(const CommBuffer<U> &in) {
 }
 
 template <class T>
-void CommBuffer<T>::Send() noexcept {
+void CommBuffer<T>::Send(int count) noexcept {
   if (!active_) {
     SendNull();
     return;
   }
 
-  PARTHENON_DEBUG_REQUIRE(*state_ == BufferState::stale,
+  PARTHENON_DEBUG_REQUIRE(shared_->state == BufferState::stale,
                           "Trying to send from buffer that hasn't been staled.");
-  *state_ = BufferState::sending;
-  if (*comm_type_ == BuffCommType::sender) {
+  shared_->state = BufferState::sending;
+  if (shared_->comm_type == BuffCommType::sender && group_) {
+    if (counter_kind_ >= 0)
+      CommCounters::CountSend(counter_kind_, buf_.size() * sizeof(buf_base_t));
+    group_->Send(group_idx_);
+  } else if (shared_->comm_type == BuffCommType::sender) {
 // Make sure that this request isn't still out,
 // this could be blocking
 #ifdef MPI_PARALLEL
+    if (count < 0) count = buf_.size();
     PARTHENON_REQUIRE(
-        buf_.size() > 0,
+        count > 0,
         "Trying to send zero size buffer, which will be interpreted as sending_null.");
-    PARTHENON_MPI_CHECK(MPI_Wait(my_request_.get(), MPI_STATUS_IGNORE));
-    PARTHENON_MPI_CHECK(MPI_Isend(buf_.data(), buf_.size(),
-                                  MPITypeMap<buf_base_t>::type(), recv_rank_, tag_, comm_,
-                                  my_request_.get()));
+    PARTHENON_REQUIRE(count <= buf_.size(), "Trying to send more than the buffer holds.");
+    WaitRequest();
+    if (staging_) {
+      // not staged by the caller, so copy (and wait for) it here
+      if (staging_->staged != count) {
+        StageForSend(DevExecSpace(), count);
+        DevExecSpace().fence();
+      }
+      staging_->staged = -1;
+      PostRequest(true, staging_->mirror.data(), count);
+    } else {
+      PostRequest(true, buf_.data(), count);
+    }
+    if (counter_kind_ >= 0)
+      CommCounters::CountSend(counter_kind_, count * sizeof(buf_base_t));
 #endif
   }
-  if (*comm_type_ == BuffCommType::receiver) {
+  if (shared_->comm_type == BuffCommType::receiver) {
     // This is an error
     PARTHENON_FAIL("Trying to send from a receiver");
   }
@@ -236,19 +365,24 @@ void CommBuffer<T>::Send() noexcept {
 
 template <class T>
 void CommBuffer<T>::SendNull() noexcept {
-  PARTHENON_DEBUG_REQUIRE(*state_ == BufferState::stale,
+  PARTHENON_DEBUG_REQUIRE(shared_->state == BufferState::stale,
                           "Trying to send_null from buffer that hasn't been staled.");
-  *state_ = BufferState::sending_null;
-  if (*comm_type_ == BuffCommType::sender) {
+  shared_->state = BufferState::sending_null;
+  // data staged for this message is not needed anymore
+  if (staging_) staging_->staged = -1;
+  if (shared_->comm_type == BuffCommType::sender && counter_kind_ >= 0)
+    CommCounters::CountSend(counter_kind_, 0);
+  if (shared_->comm_type == BuffCommType::sender && group_) {
+    group_->Send(group_idx_);
+  } else if (shared_->comm_type == BuffCommType::sender) {
 // Make sure that this request isn't still out,
 // this could be blocking
 #ifdef MPI_PARALLEL
-    PARTHENON_MPI_CHECK(MPI_Wait(my_request_.get(), MPI_STATUS_IGNORE));
-    PARTHENON_MPI_CHECK(MPI_Isend(&null_buf_, 0, MPITypeMap<buf_base_t>::type(),
-                                  recv_rank_, tag_, comm_, my_request_.get()));
+    WaitRequest();
+    PostRequest(true, &null_buf_, 0);
 #endif
   }
-  if (*comm_type_ == BuffCommType::receiver) {
+  if (shared_->comm_type == BuffCommType::receiver) {
     // This is an error
     PARTHENON_FAIL("Trying to send from a receiver");
   }
@@ -256,24 +390,25 @@ void CommBuffer<T>::SendNull() noexcept {
 
 template <class T>
 bool CommBuffer<T>::IsAvailableForWrite() {
-  if (*comm_type_ == BuffCommType::sender) {
+  if (shared_->comm_type == BuffCommType::sender) {
 #ifdef MPI_PARALLEL
     // We do not check stale status here since the receiving end should be the one
     // setting the buffer to stale, all we care about for a pure sender is wether
     // or not its last send message has been completed
-    if (*state_ == BufferState::stale) return true;
-    if (*my_request_ == MPI_REQUEST_NULL) return true;
-    int flag, test;
+    if (shared_->state == BufferState::stale) return true;
+    if (group_) return group_->SendComplete();
+    if (!RequestPending()) return true;
+    int test;
     PARTHENON_MPI_CHECK(MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &test,
                                    MPI_STATUS_IGNORE));
-    PARTHENON_MPI_CHECK(MPI_Test(my_request_.get(), &flag, MPI_STATUS_IGNORE));
-    if (flag) *state_ = BufferState::stale;
+    const bool flag = TestRequest(MPI_STATUS_IGNORE);
+    if (flag) shared_->state = BufferState::stale;
     return flag;
 #else
     PARTHENON_FAIL("Should not have a sending buffer when MPI is not enabled.");
 #endif
-  } else if (*comm_type_ == BuffCommType::both) {
-    return (*state_ == BufferState::stale);
+  } else if (shared_->comm_type == BuffCommType::both) {
+    return (shared_->state == BufferState::stale);
   } else {
     PARTHENON_FAIL("Receiving buffer is never available for write.");
   }
@@ -282,17 +417,18 @@ bool CommBuffer<T>::IsAvailableForWrite() {
 template <class T>
 void CommBuffer<T>::TryStartReceive() noexcept {
 #ifdef MPI_PARALLEL
-  if (*comm_type_ == BuffCommType::receiver && !*started_irecv_) {
+  if (group_) {
+    group_->TryStartReceive();
+  } else if (shared_->comm_type == BuffCommType::receiver && !shared_->started_irecv) {
     PARTHENON_REQUIRE(
-        *my_request_ == MPI_REQUEST_NULL,
+        !RequestPending(),
         "Cannot have another pending request in a buffer that is starting to receive.");
     if (!IsActive())
       Allocate(); // For early start of Irecv, always need storage space even if not used
-    PARTHENON_MPI_CHECK(MPI_Irecv(buf_.data(), buf_.size(),
-                                  MPITypeMap<buf_base_t>::type(), send_rank_, tag_, comm_,
-                                  my_request_.get()));
-    *started_irecv_ = true;
-  } else if (*comm_type_ == BuffCommType::sparse_receiver && !*started_irecv_) {
+    PostRequest(false, MessageData(), buf_.size());
+    shared_->started_irecv = true;
+  } else if (shared_->comm_type == BuffCommType::sparse_receiver &&
+             !shared_->started_irecv) {
     int test;
     MPI_Status status;
     // Check if our message is available so that we can use the correct buffer size
@@ -304,15 +440,12 @@ void CommBuffer<T>::TryStartReceive() noexcept {
       PARTHENON_MPI_CHECK(MPI_Get_count(&status, MPITypeMap<buf_base_t>::type(), &size));
       if (size > 0) {
         if (!active_) Allocate();
-        PARTHENON_MPI_CHECK(MPI_Irecv(buf_.data(), buf_.size(),
-                                      MPITypeMap<buf_base_t>::type(), send_rank_, tag_,
-                                      comm_, my_request_.get()));
+        PostRequest(false, MessageData(), buf_.size());
       } else {
         if (active_) Free();
-        PARTHENON_MPI_CHECK(MPI_Irecv(&null_buf_, 0, MPITypeMap<buf_base_t>::type(),
-                                      send_rank_, tag_, comm_, my_request_.get()));
+        PostRequest(false, &null_buf_, 0);
       }
-      *started_irecv_ = true;
+      shared_->started_irecv = true;
     }
   }
 #endif
@@ -320,19 +453,31 @@ void CommBuffer<T>::TryStartReceive() noexcept {
 
 template <class T>
 bool CommBuffer<T>::TryReceive() noexcept {
-  if (*state_ == BufferState::received || *state_ == BufferState::received_null)
+  if (shared_->state == BufferState::received ||
+      shared_->state == BufferState::received_null)
     return true;
 
-  if (*comm_type_ == BuffCommType::receiver ||
-      *comm_type_ == BuffCommType::sparse_receiver) {
+  if (shared_->comm_type == BuffCommType::receiver ||
+      shared_->comm_type == BuffCommType::sparse_receiver) {
 #ifdef MPI_PARALLEL
-    (*nrecv_tries_)++;
-    PARTHENON_REQUIRE(*nrecv_tries_ < 1e8,
+    shared_->nrecv_tries++;
+    PARTHENON_REQUIRE(shared_->nrecv_tries < 1e8,
                       "MPI probably hanging after 1e8 receive tries.");
 
+    if (group_) {
+      // the group sets the state of this buffer when the message is unpacked
+      if (!group_->TryReceive()) return false;
+      shared_->nrecv_tries = 0;
+      if (counter_kind_ >= 0)
+        CommCounters::CountReceive(counter_kind_, shared_->state == BufferState::received
+                                                      ? buf_.size() * sizeof(buf_base_t)
+                                                      : 0);
+      return true;
+    }
+
     TryStartReceive();
 
-    if (*started_irecv_) {
+    if (shared_->started_irecv) {
       MPI_Status status;
       int flag;
       // Comment from original Athena++ code about the MPI_Iprobe call:
@@ -362,24 +507,8 @@ bool CommBuffer<T>::TryReceive() noexcept {
       for (int i = 0; i < 1; ++i)
         PARTHENON_MPI_CHECK(MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag,
                                        MPI_STATUS_IGNORE));
-      PARTHENON_MPI_CHECK(MPI_Test(my_request_.get(), &flag, &status));
-      if (flag) {
-        // Check the size of the message, it will be zero if the sender wants you to use
-        // default buffer data
-        int size;
-        PARTHENON_MPI_CHECK(
-            MPI_Get_count(&status, MPITypeMap<buf_base_t>::type(), &size));
-
-        PARTHENON_REQUIRE(*my_request_ == MPI_REQUEST_NULL,
-                          "MPI request should be finished to get here.");
-        // Set flags based on a finished receive
-        *started_irecv_ = false;
-        *nrecv_tries_ = 0;
-        if (size > 0)
-          *state_ = BufferState::received;
-        else
-          *state_ = BufferState::received_null;
-
+      if (TestRequest(&status)) {
+        FinishReceive(&status);
         return true;
       }
     }
@@ -387,14 +516,14 @@ bool CommBuffer<T>::TryReceive() noexcept {
 #else
     PARTHENON_FAIL("Should not have a purely receiving buffer without MPI enabled.");
 #endif
-  } else if (*comm_type_ == BuffCommType::both) {
-    if (*state_ == BufferState::sending) {
-      *state_ = BufferState::received;
+  } else if (shared_->comm_type == BuffCommType::both) {
+    if (shared_->state == BufferState::sending) {
+      shared_->state = BufferState::received;
       // Memory should already be available, since both
       // send and receive rank point at the same memory
       return true;
-    } else if (*state_ == BufferState::sending_null) {
-      *state_ = BufferState::received_null;
+    } else if (shared_->state == BufferState::sending_null) {
+      shared_->state = BufferState::received_null;
       return true;
     }
     return false;
@@ -405,18 +534,198 @@ bool CommBuffer<T>::TryReceive() noexcept {
   return false;
 }
 
+template <class T>
+bool CommBuffer<T>::TryReceiveAll(const std::vector<CommBuffer *> &bufs,
+                                  CommReceiveBatch *batch) noexcept {
+#ifdef MPI_PARALLEL
+  bool all_received = true;
+  batch->requests.clear();
+  batch->buffers.clear();
+  for (int b = 0; b < bufs.size(); ++b) {
+    auto &buf = *bufs[b];
+    if (buf.shared_->state == BufferState::received ||
+        buf.shared_->state == BufferState::received_null)
+      continue;
+    const bool own_receive =
+        !buf.group_ && (buf.shared_->comm_type == BuffCommType::receiver ||
+                        buf.shared_->comm_type == BuffCommType::sparse_receiver);
+    if (!own_receive) {
+      all_received = buf.TryReceive() && all_received;
+      continue;
+    }
+    buf.shared_->nrecv_tries++;
+    PARTHENON_REQUIRE(buf.shared_->nrecv_tries < 1e8,
+                      "MPI probably hanging after 1e8 receive tries.");
+    buf.TryStartReceive();
+    if (buf.shared_->started_irecv) {
+      // request handles can be copied, the copy in the array is completed by MPI
+      batch->requests.push_back(buf.shared_->request);
+      batch->buffers.push_back(b);
+    } else {
+      // a sparse receiver whose message has not been probed yet
+      all_received = false;
+    }
+  }
+  const int nrequests = batch->requests.size();
+  if (nrequests == 0) return all_received;
+
+  // see TryReceive for why the MPI_Iprobe is here
+  int flag;
+  PARTHENON_MPI_CHECK(
+      MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE));
+  batch->completed.resize(nrequests);
+  batch->statuses.resize(nrequests);
+  int ncompleted;
+  PARTHENON_MPI_CHECK(MPI_Testsome(nrequests, batch->requests.data(), &ncompleted,
+                                   batch->completed.data(), batch->statuses.data()));
+  // only returned if none of the requests is active, which they all are
+  if (ncompleted == MPI_UNDEFINED) ncompleted = 0;
+  for (int c = 0; c < ncompleted; ++c) {
+    auto &buf = *bufs[batch->buffers[batch->completed[c]]];
+    // completed requests are set to MPI_REQUEST_NULL unless they are persistent
+    buf.shared_->request = batch->requests[batch->completed[c]];
+    if (buf.shared_->persistent.enabled) buf.shared_->persistent.active = false;
+    buf.FinishReceive(&batch->statuses[c]);
+  }
+  return all_received && ncompleted == nrequests;
+#else
+  bool all_received = true;
+  for (auto *pbuf : bufs) {
+    all_received = pbuf->TryReceive() && all_received;
+  }
+  return all_received;
+#endif
+}
+
 template <class T>
 void CommBuffer<T>::Stale() {
-  PARTHENON_REQUIRE(*comm_type_ != BuffCommType::sender, "Should never get here.");
+  PARTHENON_REQUIRE(shared_->comm_type != BuffCommType::sender, "Should never get here.");
 
-  if (!(*state_ == BufferState::received || *state_ == BufferState::received_null))
+  if (!(shared_->state == BufferState::received ||
+        shared_->state == BufferState::received_null))
     PARTHENON_DEBUG_WARN("Staling buffer not in the received state.");
 #ifdef MPI_PARALLEL
-  if (MPI_REQUEST_NULL != *my_request_)
+  if (RequestPending())
     PARTHENON_WARN("Staling buffer with pending request.");
 #endif
-  *state_ = BufferState::stale;
+  shared_->state = BufferState::stale;
+}
+
+template <class T>
+typename CommBuffer<T>::buf_base_t *CommBuffer<T>::MessageData() {
+  if (!staging_) return buf_.data();
+  // the mirror is only reallocated when no message is in flight, since sends and
+  // receives are only started on buffers that are not communicating
+  if (staging_->mirror.size() < buf_.size()) {
+    staging_->mirror = Kokkos::View<buf_base_t *, HostPinnedMemSpace>(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "host staged message"),
+        buf_.size());
+  }
+  return staging_->mirror.data();
+}
+
+template <class T>
+template <class ExecSpace>
+void CommBuffer<T>::StageForSend(const ExecSpace &exec, int count) {
+  if (!staging_ || !active_ || shared_->comm_type != BuffCommType::sender || group_)
+    return;
+  if (count < 0) count = buf_.size();
+  MessageData();
+  const auto range = std::make_pair(0, count);
+  Kokkos::deep_copy(exec, Kokkos::subview(staging_->mirror, range),
+                    Kokkos::subview(buf_, range));
+  staging_->staged = count;
+}
+
+template <class T>
+template <class ExecSpace>
+void CommBuffer<T>::Unstage(const ExecSpace &exec) {
+  if (!staging_ || staging_->unstaged || !active_) return;
+  if (shared_->state == BufferState::received) {
+    const auto range = std::make_pair(0, staging_->received);
+    Kokkos::deep_copy(exec, Kokkos::subview(buf_, range),
+                      Kokkos::subview(staging_->mirror, range));
+  }
+  staging_->unstaged = true;
+}
+
+#ifdef MPI_PARALLEL
+template <class T>
+void CommBuffer<T>::PostRequest(const bool send, buf_base_t *data, const int count) {
+  const auto type = MPITypeMap<buf_base_t>::type();
+  if (!shared_->persistent.enabled) {
+    if (send) {
+      PARTHENON_MPI_CHECK(
+          MPI_Isend(data, count, type, recv_rank_, tag_, comm_, &shared_->request));
+    } else {
+      PARTHENON_MPI_CHECK(
+          MPI_Irecv(data, count, type, send_rank_, tag_, comm_, &shared_->request));
+    }
+    return;
+  }
+  // A persistent request is bound to its memory, so it has to be recreated if the
+  // buffer was reallocated since it was initialized
+  if (shared_->persistent.data != data || shared_->persistent.count != count) {
+    if (shared_->request != MPI_REQUEST_NULL)
+      PARTHENON_MPI_CHECK(MPI_Request_free(&shared_->request));
+    if (send) {
+      PARTHENON_MPI_CHECK(
+          MPI_Send_init(data, count, type, recv_rank_, tag_, comm_, &shared_->request));
+    } else {
+      PARTHENON_MPI_CHECK(
+          MPI_Recv_init(data, count, type, send_rank_, tag_, comm_, &shared_->request));
+    }
+    shared_->persistent.data = data;
+    shared_->persistent.count = count;
+  }
+  PARTHENON_MPI_CHECK(MPI_Start(&shared_->request));
+  shared_->persistent.active = true;
+}
+
+template <class T>
+bool CommBuffer<T>::RequestPending() const {
+  // Completing a persistent request does not set it to MPI_REQUEST_NULL
+  if (shared_->persistent.enabled) return shared_->persistent.active;
+  return shared_->request != MPI_REQUEST_NULL;
+}
+
+template <class T>
+bool CommBuffer<T>::TestRequest(MPI_Status *status) {
+  int flag;
+  PARTHENON_MPI_CHECK(MPI_Test(&shared_->request, &flag, status));
+  if (flag && shared_->persistent.enabled) shared_->persistent.active = false;
+  return flag;
+}
+
+template <class T>
+void CommBuffer<T>::WaitRequest() {
+  PARTHENON_MPI_CHECK(MPI_Wait(&shared_->request, MPI_STATUS_IGNORE));
+  if (shared_->persistent.enabled) shared_->persistent.active = false;
 }
 
+template <class T>
+void CommBuffer<T>::FinishReceive(MPI_Status *status) {
+  // Check the size of the message, it will be zero if the sender wants you to use
+  // default buffer data
+  int size;
+  PARTHENON_MPI_CHECK(MPI_Get_count(status, MPITypeMap<buf_base_t>::type(), &size));
+
+  PARTHENON_REQUIRE(!RequestPending(), "MPI request should be finished to get here.");
+  // Set flags based on a finished receive
+  shared_->started_irecv = false;
+  shared_->nrecv_tries = 0;
+  if (size > 0)
+    shared_->state = BufferState::received;
+  else
+    shared_->state = BufferState::received_null;
+  if (staging_ && size > 0) {
+    staging_->received = size;
+    staging_->unstaged = false;
+  }
+  if (counter_kind_ >= 0)
+    CommCounters::CountReceive(counter_kind_, size * sizeof(buf_base_t));
+}
+#endif
+
 } // namespace parthenon
 #endif // UTILS_COMMUNICATION_BUFFER_HPP_
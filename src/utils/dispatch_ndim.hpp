@@ -0,0 +1,49 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_DISPATCH_NDIM_HPP_
+#define UTILS_DISPATCH_NDIM_HPP_
+
+#include <type_traits>
+#include <utility>
+
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+// Tag carrying the number of dimensions of the mesh as a compile time constant, so
+// that kernels templated on it can drop the branches and the loops over the trivial
+// k and j ranges of 1D and 2D meshes, e.g.,
+//
+//   DispatchNdim(md->GetNDim(), [&](auto dim) {
+//     return MyKernel<decltype(dim)::value>(md);
+//   });
+//
+// Since extended lambdas can't be defined in generic lambdas, the kernel itself has to
+// live in a function template called from f rather than in f.
+template <int NDIM>
+struct Dispatch : std::integral_constant<int, NDIM> {
+  static_assert(NDIM >= 1 && NDIM <= 3, "Meshes have one to three dimensions");
+};
+
+// Calls f(Dispatch<ndim>()) and returns its result
+template <class F>
+decltype(auto) DispatchNdim(const int ndim, F &&f) {
+  if (ndim == 3) return std::forward<F>(f)(Dispatch<3>());
+  if (ndim == 2) return std::forward<F>(f)(Dispatch<2>());
+  PARTHENON_REQUIRE(ndim == 1, "Meshes have one to three dimensions");
+  return std::forward<F>(f)(Dispatch<1>());
+}
+
+} // namespace parthenon
+
+#endif // UTILS_DISPATCH_NDIM_HPP_
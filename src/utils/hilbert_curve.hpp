@@ -0,0 +1,70 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_HILBERT_CURVE_HPP_
+#define UTILS_HILBERT_CURVE_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+// Position along the Hilbert curve through the 2^nbits cells per direction of an ndim
+// dimensional grid of the cell at x, following J. Skilling, "Programming the Hilbert
+// curve", AIP Conf. Proc. 707, 381 (2004).  Unlike the Morton order, consecutive cells
+// along the curve are always neighbors, and every aligned cube of 2^n cells per
+// direction is a contiguous range of it.  Only the first ndim entries of x are used.
+inline std::uint64_t HilbertIndex(const int ndim, const int nbits,
+                                  std::array<std::uint64_t, 3> x) {
+  PARTHENON_REQUIRE(ndim >= 1 && ndim <= 3 && nbits >= 0 && ndim * nbits <= 64,
+                    "Hilbert index does not fit into 64 bits");
+  if (nbits == 0) return 0;
+  const std::uint64_t m = static_cast<std::uint64_t>(1) << (nbits - 1);
+  // inverse undo excess work
+  for (std::uint64_t q = m; q > 1; q >>= 1) {
+    const std::uint64_t p = q - 1;
+    for (int i = 0; i < ndim; ++i) {
+      if (x[i] & q) {
+        x[0] ^= p;
+      } else {
+        const std::uint64_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  // Gray encode
+  for (int i = 1; i < ndim; ++i) {
+    x[i] ^= x[i - 1];
+  }
+  std::uint64_t t = 0;
+  for (std::uint64_t q = m; q > 1; q >>= 1) {
+    if (x[ndim - 1] & q) t ^= q - 1;
+  }
+  for (int i = 0; i < ndim; ++i) {
+    x[i] ^= t;
+  }
+  // interleave the bits of the transposed index, most significant first
+  std::uint64_t index = 0;
+  for (int b = nbits - 1; b >= 0; --b) {
+    for (int i = 0; i < ndim; ++i) {
+      index = (index << 1) | ((x[i] >> b) & 1);
+    }
+  }
+  return index;
+}
+
+} // namespace parthenon
+
+#endif // UTILS_HILBERT_CURVE_HPP_
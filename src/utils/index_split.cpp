@@ -12,6 +12,7 @@
 //========================================================================================
 
 #include <algorithm>
+#include <tuple>
 
 #include <Kokkos_Core.hpp>
 
@@ -24,6 +25,7 @@
 #include "kokkos_abstraction.hpp"
 #include "mesh/domain.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/error_checking.hpp"
 
 namespace parthenon {
 
@@ -55,6 +57,54 @@ IndexSplit::IndexSplit(MeshData<Real> *md, IndexDomain domain, const int nkp,
   ndim_ = md->GetNDim();
 }
 
+std::tuple<IndexRange, IndexRange, IndexRange>
+IndexSplit::GetCoreBounds(MeshData<Real> *md, const int width) {
+  const int ndim = md->GetNDim();
+  IndexRange bounds[3] = {md->GetBoundsK(IndexDomain::interior),
+                          md->GetBoundsJ(IndexDomain::interior),
+                          md->GetBoundsI(IndexDomain::interior)};
+  for (int d = 0; d < 3; ++d) {
+    // only active directions have ghost zones, k is the third one
+    if (3 - d > ndim) continue;
+    PARTHENON_REQUIRE_THROWS(bounds[d].e - bounds[d].s + 1 > 2 * width,
+                             "Blocks are too small for a core of this stencil width.");
+    bounds[d].s += width;
+    bounds[d].e -= width;
+  }
+  return std::make_tuple(bounds[0], bounds[1], bounds[2]);
+}
+
+IndexSplit IndexSplit::Core(MeshData<Real> *md, const int width, const int nkp,
+                            const int njp) {
+  const auto [kb, jb, ib] = GetCoreBounds(md, width);
+  return IndexSplit(md, kb, jb, ib, nkp, njp);
+}
+
+ShellBounds IndexSplit::GetShell(MeshData<Real> *md, const int width) {
+  const auto [ckb, cjb, cib] = GetCoreBounds(md, width);
+  const auto kb = md->GetBoundsK(IndexDomain::interior);
+  const auto jb = md->GetBoundsJ(IndexDomain::interior);
+  const auto ib = md->GetBoundsI(IndexDomain::interior);
+  ShellBounds shell;
+  auto add = [&](const IndexRange &k, const IndexRange &j, const IndexRange &i) {
+    if (k.e < k.s || j.e < j.s || i.e < i.s) return;
+    const int n = shell.nboxes++;
+    shell.kb[n] = k;
+    shell.jb[n] = j;
+    shell.ib[n] = i;
+    shell.first[n + 1] =
+        shell.first[n] + (k.e - k.s + 1) * (j.e - j.s + 1) * (i.e - i.s + 1);
+  };
+  // whole planes in k, then the rest of the planes in j and the rest of the lines in i
+  add({kb.s, ckb.s - 1}, jb, ib);
+  add({ckb.e + 1, kb.e}, jb, ib);
+  add(ckb, {jb.s, cjb.s - 1}, ib);
+  add(ckb, {cjb.e + 1, jb.e}, ib);
+  add(ckb, cjb, {ib.s, cib.s - 1});
+  add(ckb, cjb, {cib.e + 1, ib.e});
+  return shell;
+}
+
 void IndexSplit::Init(MeshData<Real> *md, const int kbe, const int jbe) {
   const int total_k = kbe - kbs_ + 1;
   const int total_j = jbe - jbs_ + 1;
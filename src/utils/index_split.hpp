@@ -14,6 +14,8 @@
 #ifndef UTILS_INDEX_SPLIT_HPP_
 #define UTILS_INDEX_SPLIT_HPP_
 
+#include <tuple>
+
 #include "basic_types.hpp"
 #include "defs.hpp"
 #include "globals.hpp"
@@ -25,6 +27,33 @@ namespace parthenon {
 template <typename T>
 class MeshData;
 
+// The interior cells of a block that are less than some width away from its ghost zones
+// (the "shell", see IndexSplit::GetShell), as up to six non-overlapping boxes, which
+// can be iterated over with one flat index
+struct ShellBounds {
+  static constexpr int max_boxes = 6;
+  int nboxes = 0;
+  IndexRange kb[max_boxes], jb[max_boxes], ib[max_boxes];
+  // flattened index of the first cell of each box, and the total number of cells last
+  int first[max_boxes + 1] = {0};
+
+  KOKKOS_INLINE_FUNCTION
+  int size() const { return first[nboxes]; }
+  KOKKOS_INLINE_FUNCTION
+  void GetIndices(const int idx, int &k, int &j, int &i) const {
+    int n = 0;
+    while (idx >= first[n + 1]) {
+      ++n;
+    }
+    const int ni = ib[n].e - ib[n].s + 1;
+    const int nj = jb[n].e - jb[n].s + 1;
+    const int local = idx - first[n];
+    i = ib[n].s + local % ni;
+    j = jb[n].s + (local / ni) % nj;
+    k = kb[n].s + local / (ni * nj);
+  }
+};
+
 class IndexSplit {
  public:
   static constexpr int all_outer = -100;
@@ -33,6 +62,17 @@ class IndexSplit {
              const IndexRange &ib, const int nkp, const int njp);
   IndexSplit(MeshData<Real> *md, IndexDomain domain, const int nkp, const int njp);
 
+  // The interior cells of the blocks of md that are at least width cells away from the
+  // ghost zones in all active directions (the "core"), i.e., those whose update with a
+  // stencil of that width doesn't read any ghost zones and can thus overlap with the
+  // boundary communication, and the remaining interior cells (the "shell"), which have
+  // to wait for the ghost zones.  Together they cover the interior exactly once.
+  static std::tuple<IndexRange, IndexRange, IndexRange>
+  GetCoreBounds(MeshData<Real> *md, const int width);
+  static IndexSplit Core(MeshData<Real> *md, const int width, const int nkp,
+                         const int njp);
+  static ShellBounds GetShell(MeshData<Real> *md, const int width);
+
   int outer_size() const { return nkp_ * njp_; }
   KOKKOS_INLINE_FUNCTION
   IndexRange GetBoundsK(const int p) const {
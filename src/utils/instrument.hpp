@@ -14,21 +14,52 @@
 #define UTILS_INSTRUMENT_HPP_
 
 #include <string>
+#include <string_view>
 
 #include <Kokkos_Core.hpp>
 
 #define __UNIQUE_INST_VAR2(x, y) x##y
 #define __UNIQUE_INST_VAR(x, y) __UNIQUE_INST_VAR2(x, y)
+#define __INST_STRINGIFY2(x) #x
+#define __INST_STRINGIFY(x) __INST_STRINGIFY2(x)
 #define PARTHENON_INSTRUMENT                                                             \
-  KokkosTimer __UNIQUE_INST_VAR(internal_inst, __LINE__)(__FILE__, __LINE__, __func__);
+  KokkosTimer __UNIQUE_INST_VAR(internal_inst, __LINE__)(PARTHENON_AUTO_LABEL);
 #define PARTHENON_INSTRUMENT_REGION(name)                                                \
   KokkosTimer __UNIQUE_INST_VAR(internal_inst_reg, __LINE__)(name);
 #define PARTHENON_INSTRUMENT_REGION_PUSH                                                 \
-  Kokkos::Profiling::pushRegion(build_auto_label(__FILE__, __LINE__, __func__));
+  if (Kokkos::Profiling::profileLibraryLoaded()) {                                       \
+    Kokkos::Profiling::pushRegion(PARTHENON_AUTO_LABEL);                                 \
+  }
 #define PARTHENON_INSTRUMENT_REGION_POP Kokkos::Profiling::popRegion();
-#define PARTHENON_AUTO_LABEL parthenon::build_auto_label(__FILE__, __LINE__, __func__)
+// The "file_name::line_number" part of the label is cut out of a string literal at
+// compile time.  __func__ is not a constant expression, so the function name is appended
+// the first time a call site is executed and the label is kept in a static string
+// local to the call site (every instantiation of a template has its own), i.e., later
+// executions only return a reference to it.
+#define PARTHENON_AUTO_LABEL                                                             \
+  ([](const char *func) -> const std::string & {                                         \
+    constexpr auto file_line =                                                           \
+        parthenon::impl::FileLineLabel(__FILE__ "::" __INST_STRINGIFY(__LINE__));        \
+    static const std::string label = parthenon::build_auto_label(file_line, func);       \
+    return label;                                                                        \
+  }(__func__))
 
 namespace parthenon {
+namespace impl {
+// strips the directories from "path/file_name::line_number"
+constexpr std::string_view FileLineLabel(const std::string_view file_line) {
+  const std::size_t pos = file_line.find_last_of("/\\");
+  return pos == std::string_view::npos ? file_line : file_line.substr(pos + 1);
+}
+} // namespace impl
+
+inline std::string build_auto_label(const std::string_view file_line,
+                                    const std::string_view name) {
+  std::string label;
+  label.reserve(file_line.size() + 2 + name.size());
+  label.append(file_line).append("::").append(name);
+  return label;
+}
 
 inline std::string build_auto_label(const std::string &fullpath, const int line,
                                     const std::string &name) {
@@ -37,15 +68,29 @@ inline std::string build_auto_label(const std::string &fullpath, const int line,
   return file + "::" + std::to_string(line) + "::" + name;
 }
 
+// Regions are only pushed (and the name is only converted to a std::string) if a
+// profiling tool is loaded
 struct KokkosTimer {
-  KokkosTimer(const std::string &file, const int line, const std::string &name) {
-    Push(build_auto_label(file, line, name));
+  KokkosTimer(const std::string &file, const int line, const std::string &name)
+      : pushed_(Kokkos::Profiling::profileLibraryLoaded()) {
+    if (pushed_) Kokkos::Profiling::pushRegion(build_auto_label(file, line, name));
+  }
+  explicit KokkosTimer(const std::string &name)
+      : pushed_(Kokkos::Profiling::profileLibraryLoaded()) {
+    if (pushed_) Kokkos::Profiling::pushRegion(name);
+  }
+  explicit KokkosTimer(const char *name)
+      : pushed_(Kokkos::Profiling::profileLibraryLoaded()) {
+    if (pushed_) Kokkos::Profiling::pushRegion(name);
+  }
+  ~KokkosTimer() {
+    if (pushed_) Kokkos::Profiling::popRegion();
   }
-  explicit KokkosTimer(const std::string &name) { Push(name); }
-  ~KokkosTimer() { Kokkos::Profiling::popRegion(); }
+  KokkosTimer(const KokkosTimer &) = delete;
+  KokkosTimer &operator=(const KokkosTimer &) = delete;
 
  private:
-  void Push(const std::string &name) { Kokkos::Profiling::pushRegion(name); }
+  bool pushed_;
 };
 
 } // namespace parthenon
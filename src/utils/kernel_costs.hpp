@@ -0,0 +1,91 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_KERNEL_COSTS_HPP_
+#define UTILS_KERNEL_COSTS_HPP_
+
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace parthenon {
+
+// Bytes moved from/to memory and floating point operations per loop iteration of the
+// kernels with a given label, as estimated by the developer for a roofline model
+struct KernelCost {
+  double bytes = 0.0;
+  double flops = 0.0;
+};
+
+// The KernelCosts of kernel labels, set from the <parthenon/kernels> input block or by
+// the code before the kernels are launched.  While timing is enabled, par_for and
+// par_reduce fence around every kernel that has a cost and record its time and number
+// of iterations, so that Report can give the achieved bandwidth and FLOP/s of each.
+// Kernels are not looked up at all while timing is disabled.
+class KernelCosts {
+ public:
+  static void Set(const std::string &label, const KernelCost &cost) {
+    Entries()[label].cost = cost;
+  }
+  static void Clear() { Entries().clear(); }
+  static void SetTiming(const bool timing) { timing_ = timing; }
+  static bool Timing() { return timing_; }
+
+  // nullptr if there is no cost for label
+  static const KernelCost *Find(const std::string &label) {
+    const auto &entries = Entries();
+    auto it = entries.find(label);
+    return it == entries.end() ? nullptr : &(it->second.cost);
+  }
+  static void Record(const std::string &label, const std::int64_t iterations,
+                     const double seconds) {
+    auto &entry = Entries()[label];
+    entry.launches++;
+    entry.iterations += iterations;
+    entry.seconds += seconds;
+  }
+
+  // one line per kernel that was launched, sorted by label
+  static void Report(std::ostream &os) {
+    std::map<std::string, Entry> sorted(Entries().begin(), Entries().end());
+    os << "# label launches seconds GB/s GFLOP/s flops/byte\n";
+    for (const auto &[label, e] : sorted) {
+      if (e.launches == 0) continue;
+      const double iters_per_sec = e.seconds > 0.0 ? e.iterations / e.seconds : 0.0;
+      os << label << " " << e.launches << std::scientific << std::setprecision(3) << " "
+         << e.seconds << " " << iters_per_sec * e.cost.bytes * 1.0e-9 << " "
+         << iters_per_sec * e.cost.flops * 1.0e-9 << " "
+         << (e.cost.bytes > 0.0 ? e.cost.flops / e.cost.bytes : 0.0)
+         << std::defaultfloat << "\n";
+    }
+  }
+
+ private:
+  struct Entry {
+    KernelCost cost;
+    std::int64_t launches = 0;
+    std::int64_t iterations = 0;
+    double seconds = 0.0;
+  };
+  static std::unordered_map<std::string, Entry> &Entries() {
+    static std::unordered_map<std::string, Entry> entries;
+    return entries;
+  }
+  static inline bool timing_ = false;
+};
+
+} // namespace parthenon
+
+#endif // UTILS_KERNEL_COSTS_HPP_
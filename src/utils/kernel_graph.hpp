@@ -0,0 +1,155 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_KERNEL_GRAPH_HPP_
+#define UTILS_KERNEL_GRAPH_HPP_
+
+#include <cstdint>
+
+#include "kokkos_abstraction.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+// Records the kernels launched by a function into a CUDA or HIP graph and replays the
+// graph on later calls with the same key, which launches all kernels for about the
+// cost of one, e.g., for the many small per-block kernels of a stage on 8^3 blocks.
+// The first call with a new key runs the function directly, so that Kokkos sets up
+// whatever it needs for the kernels outside of the capture, the second one records the
+// graph.  A key has to change whenever anything the kernels capture by value, like
+// the pointers in packs, bounds or coefficients, changes, e.g., Mesh::remesh_count.
+//
+// The graph is recorded on and replayed into the execution space instance passed to
+// Launch, e.g., MeshData::GetExecSpace(), and a different instance records a new
+// graph.  The function must only launch kernels on that instance and must not
+// synchronize with the host, i.e., no reductions into host values, deep copies to the
+// host, fences or MPI calls.  If the capture fails anyway, the function is run directly
+// from then on.  Without CUDA or HIP the function is always run directly.
+class KernelGraph {
+ public:
+  KernelGraph() = default;
+  ~KernelGraph() { Reset(); }
+  KernelGraph(const KernelGraph &) = delete;
+  KernelGraph &operator=(const KernelGraph &) = delete;
+
+  template <class Function>
+  void Launch(const DevExecSpace &exec_space, const std::uint64_t key,
+              const Function &function) {
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
+    if (failed_) return function();
+    if (calls_ > 0 && (key != key_ || Stream(exec_space) != stream_)) Reset();
+    key_ = key;
+    stream_ = Stream(exec_space);
+    if (calls_++ == 0) return function();
+    if (!recorded_ && !Record(function)) return function();
+    Replay();
+#else
+    function();
+#endif
+  }
+
+  // Drops the recorded graph
+  void Reset() {
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
+    if (recorded_) {
+      GraphExecDestroy(exec_);
+      GraphDestroy(graph_);
+    }
+#endif
+    recorded_ = false;
+    calls_ = 0;
+  }
+
+  bool Recorded() const { return recorded_; }
+
+ private:
+  bool recorded_ = false;
+  bool failed_ = false;
+  int calls_ = 0;
+  std::uint64_t key_ = 0;
+
+#if defined(KOKKOS_ENABLE_CUDA)
+  using graph_t = cudaGraph_t;
+  using graph_exec_t = cudaGraphExec_t;
+  using stream_t = cudaStream_t;
+  static stream_t Stream(const DevExecSpace &exec_space) {
+    return exec_space.cuda_stream();
+  }
+  bool BeginCapture() {
+    return cudaStreamBeginCapture(stream_, cudaStreamCaptureModeRelaxed) ==
+           cudaSuccess;
+  }
+  bool EndCapture(graph_t *graph) {
+    return cudaStreamEndCapture(stream_, graph) == cudaSuccess;
+  }
+  static bool Instantiate(graph_exec_t *exec, graph_t graph) {
+    return cudaGraphInstantiateWithFlags(exec, graph, 0) == cudaSuccess;
+  }
+  void GraphLaunch(graph_exec_t exec) { cudaGraphLaunch(exec, stream_); }
+  static void GraphDestroy(graph_t graph) { cudaGraphDestroy(graph); }
+  static void GraphExecDestroy(graph_exec_t exec) { cudaGraphExecDestroy(exec); }
+  static void ClearError() { cudaGetLastError(); }
+#elif defined(KOKKOS_ENABLE_HIP)
+  using graph_t = hipGraph_t;
+  using graph_exec_t = hipGraphExec_t;
+  using stream_t = hipStream_t;
+  static stream_t Stream(const DevExecSpace &exec_space) {
+    return exec_space.hip_stream();
+  }
+  bool BeginCapture() {
+    return hipStreamBeginCapture(stream_, hipStreamCaptureModeRelaxed) == hipSuccess;
+  }
+  bool EndCapture(graph_t *graph) {
+    return hipStreamEndCapture(stream_, graph) == hipSuccess;
+  }
+  static bool Instantiate(graph_exec_t *exec, graph_t graph) {
+    return hipGraphInstantiate(exec, graph, nullptr, nullptr, 0) == hipSuccess;
+  }
+  void GraphLaunch(graph_exec_t exec) { hipGraphLaunch(exec, stream_); }
+  static void GraphDestroy(graph_t graph) { hipGraphDestroy(graph); }
+  static void GraphExecDestroy(graph_exec_t exec) { hipGraphExecDestroy(exec); }
+  static void ClearError() { hipGetLastError(); }
+#endif
+
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
+  graph_t graph_;
+  graph_exec_t exec_;
+  stream_t stream_ = nullptr;
+
+  // Records the kernels of function without running them, false if that failed
+  template <class Function>
+  bool Record(const Function &function) {
+    bool ok = BeginCapture();
+    if (ok) {
+      function();
+      ok = EndCapture(&graph_);
+    }
+    if (ok) {
+      ok = Instantiate(&exec_, graph_);
+      if (!ok) GraphDestroy(graph_);
+    }
+    if (!ok) {
+      ClearError();
+      failed_ = true;
+      PARTHENON_WARN("KernelGraph: recording kernels failed, launching them directly.");
+    }
+    recorded_ = ok;
+    return ok;
+  }
+
+  void Replay() { GraphLaunch(exec_); }
+#endif
+};
+
+} // namespace parthenon
+
+#endif // UTILS_KERNEL_GRAPH_HPP_
@@ -0,0 +1,69 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_LAUNCH_CONFIG_HPP_
+#define UTILS_LAUNCH_CONFIG_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace parthenon {
+
+// Launch parameters of the kernels with a given label, e.g., to tune register use and
+// occupancy of hot kernels.  Zero keeps the default of the loop pattern.
+struct LaunchConfig {
+  // MDRange tile sizes of the innermost dimensions, e.g., {4, 32} for j and i
+  std::vector<int> tile;
+  // TeamPolicy team size and vector length
+  int team_size = 0;
+  int vector_length = 0;
+
+  // The tile size of dimension d of an MDRange loop over rank dimensions
+  int Tile(const int rank, const int d, const int default_size) const {
+    const int t = d - (rank - static_cast<int>(tile.size()));
+    return (t >= 0 && tile[t] > 0) ? tile[t] : default_size;
+  }
+};
+
+// The LaunchConfigs of kernel labels, set from the <parthenon/kernels> input block or
+// by the code before the kernels are launched.  Looking up a label is skipped entirely
+// as long as no config is set.
+class LaunchConfigs {
+ public:
+  static void Set(const std::string &label, const LaunchConfig &config) {
+    Configs()[label] = config;
+    any_ = true;
+  }
+  static void Clear() {
+    Configs().clear();
+    any_ = false;
+  }
+  // nullptr if there is no config for label
+  static const LaunchConfig *Find(const std::string &label) {
+    if (!any_) return nullptr;
+    const auto &configs = Configs();
+    auto it = configs.find(label);
+    return it == configs.end() ? nullptr : &(it->second);
+  }
+
+ private:
+  static std::unordered_map<std::string, LaunchConfig> &Configs() {
+    static std::unordered_map<std::string, LaunchConfig> configs;
+    return configs;
+  }
+  static inline bool any_ = false;
+};
+
+} // namespace parthenon
+
+#endif // UTILS_LAUNCH_CONFIG_HPP_
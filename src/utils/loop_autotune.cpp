@@ -0,0 +1,125 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include "utils/loop_autotune.hpp"
+
+#include FS_HEADER
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "globals.hpp"
+#include "utils/error_checking.hpp"
+
+namespace fs = FS_NAMESPACE;
+
+namespace parthenon {
+
+LoopAutotuner &LoopAutotuner::Get() {
+  static LoopAutotuner tuner;
+  return tuner;
+}
+
+const char *LoopAutotuner::Name(const LoopPatternChoice pattern) {
+  switch (pattern) {
+  case LoopPatternChoice::mdrange:
+    return "mdrange";
+  case LoopPatternChoice::flatrange:
+    return "flatrange";
+  case LoopPatternChoice::tpttr:
+    return "tpttr";
+  case LoopPatternChoice::tptvr:
+    return "tptvr";
+  case LoopPatternChoice::tpttrtvr:
+    return "tpttrtvr";
+  case LoopPatternChoice::simdfor:
+    return "simdfor";
+  }
+  return "undefined";
+}
+
+void LoopAutotuner::Configure(const bool enabled, const int trials,
+                              const std::string &cache_file) {
+  PARTHENON_REQUIRE_THROWS(trials > 0, "Need at least one timed trial per pattern.");
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = enabled;
+  trials_ = trials;
+  entries_.clear();
+  cache_file_.clear();
+  if (cache_file.empty()) return;
+  // the run directory may change after startup
+  cache_file_ = fs::absolute(cache_file).string();
+  std::ifstream in(cache_file_);
+  std::string line;
+  while (std::getline(in, line)) {
+    // every line is a pattern name followed by the key, which may contain spaces
+    const auto sep = line.find(' ');
+    if (sep == std::string::npos) continue;
+    const std::string name = line.substr(0, sep);
+    for (int p = 0; p < nchoices; ++p) {
+      const auto pattern = static_cast<LoopPatternChoice>(p);
+      if (name != Name(pattern)) continue;
+      auto &entry = entries_[line.substr(sep + 1)];
+      entry.chosen = true;
+      entry.best = pattern;
+    }
+  }
+}
+
+LoopAutotuner::Trial LoopAutotuner::Next(const std::string &key,
+                                         const LoopPatternChoice *candidates,
+                                         const int ncandidates) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_) return {candidates[0], false};
+  auto &entry = entries_[key];
+  if (entry.chosen) {
+    for (int c = 0; c < ncandidates; ++c)
+      if (candidates[c] == entry.best) return {entry.best, false};
+    // cached for a build with other candidates, tune again
+    entry = Entry();
+  }
+  if (entry.calls >= ncandidates * (trials_ + 1)) {
+    double best = std::numeric_limits<double>::max();
+    for (int c = 0; c < ncandidates; ++c) {
+      const double seconds = entry.seconds[static_cast<int>(candidates[c])];
+      if (seconds < best) {
+        best = seconds;
+        entry.best = candidates[c];
+      }
+    }
+    entry.chosen = true;
+    return {entry.best, false};
+  }
+  const Trial trial{candidates[entry.calls % ncandidates], entry.calls >= ncandidates};
+  entry.calls++;
+  return trial;
+}
+
+void LoopAutotuner::Record(const std::string &key, const LoopPatternChoice pattern,
+                           const double seconds) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key].seconds[static_cast<int>(pattern)] += seconds;
+}
+
+void LoopAutotuner::Save() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_ || cache_file_.empty() || Globals::my_rank != 0) return;
+  std::ofstream out(cache_file_);
+  PARTHENON_REQUIRE_THROWS(out.good(),
+                           "Cannot write the loop pattern cache " + cache_file_);
+  for (const auto &[key, entry] : entries_) {
+    if (entry.chosen) out << Name(entry.best) << " " << key << "\n";
+  }
+}
+
+} // namespace parthenon
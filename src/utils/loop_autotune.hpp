@@ -0,0 +1,72 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_LOOP_AUTOTUNE_HPP_
+#define UTILS_LOOP_AUTOTUNE_HPP_
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace parthenon {
+
+// The loop patterns loop_pattern_autotune_tag chooses from
+enum class LoopPatternChoice { mdrange, flatrange, tpttr, tptvr, tpttrtvr, simdfor };
+
+// Chooses the loop pattern of the par_for and par_reduce calls made with
+// loop_pattern_autotune_tag, separately for every kernel name and loop extent.  The
+// first calls of a kernel cycle through its candidate patterns, once untimed to warm up
+// and then `trials` times timed between fences, after which the fastest pattern is
+// used without fencing.  Choices are read from and written to the cache file, if one
+// is set, so later runs with the same kernels skip the tuning.
+class LoopAutotuner {
+ public:
+  struct Trial {
+    LoopPatternChoice pattern;
+    bool timed;
+  };
+
+  static LoopAutotuner &Get();
+
+  // Reads the choices of the cache file, if it exists
+  void Configure(bool enabled, int trials, const std::string &cache_file);
+
+  // The pattern to use for the next call of the kernel with key, one of candidates
+  Trial Next(const std::string &key, const LoopPatternChoice *candidates,
+             int ncandidates);
+  void Record(const std::string &key, LoopPatternChoice pattern, double seconds);
+
+  // Writes all choices made so far to the cache file on rank 0
+  void Save() const;
+
+  static const char *Name(LoopPatternChoice pattern);
+
+ private:
+  static constexpr int nchoices = 6;
+  struct Entry {
+    std::array<double, nchoices> seconds{};
+    int calls = 0;
+    bool chosen = false;
+    LoopPatternChoice best = LoopPatternChoice::mdrange;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  bool enabled_ = true;
+  int trials_ = 3;
+  std::string cache_file_;
+};
+
+} // namespace parthenon
+
+#endif // UTILS_LOOP_AUTOTUNE_HPP_
@@ -118,6 +118,23 @@ T GetNaNWithPayloadTag(uint8_t tag = 1) {
   return std::numeric_limits<T>::quiet_NaN();
 }
 
+// payload tag of the NaNs FillUninitialized writes
+constexpr uint8_t uninitialized_nan_tag = 2;
+
+// Memory allocated with Kokkos::WithoutInitializing holds whatever was there before.
+// In debug builds, fill it with NaNs tagged with uninitialized_nan_tag, so values that
+// are read before they are written are caught.
+template <class View>
+void FillUninitialized(const View &v) {
+#ifndef NDEBUG
+  using value_t = typename View::non_const_value_type;
+  if constexpr (std::numeric_limits<value_t>::is_iec559) {
+    Kokkos::deep_copy(DevExecSpace(), v,
+                      GetNaNWithPayloadTag<value_t>(uninitialized_nan_tag));
+  }
+#endif
+}
+
 } // namespace parthenon
 
 #endif // UTILS_NAN_PAYLOAD_TAG_HPP_
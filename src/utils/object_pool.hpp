@@ -22,7 +22,9 @@
 
 #include <cstdint>
 #include <iostream>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <type_traits>
 #include <unordered_map>
@@ -33,7 +35,10 @@
 namespace parthenon {
 
 // Object for managing a pool of Kokkos::Views that
-// have the same instantiation call signature
+// have the same instantiation call signature.
+// All member functions (and those of weak_t and owner_t that go through the pool) can be
+// called concurrently, e.g., from the threads of a TaskRegion.  The bookkeeping is
+// guarded by a mutex, which is not held while new resources are created.
 template <class T>
 class ObjectPool {
  public:
@@ -49,20 +54,50 @@ class ObjectPool {
   std::unordered_map<KEY_T, std::pair<weak_t, int>> inuse_;
   static const KEY_T default_key_ = KEY_T();
   KEY_T keyc_;
+  // number of objects handed out by Get that were taken from the free objects and that
+  // required a new resource
+  std::uint64_t nreused_ = 0, nallocated_ = 0;
+  mutable std::mutex mutex_;
 
  public:
   template <class... Ts>
   explicit ObjectPool(std::function<T(ObjectPool *)> get_resource)
       : get_resource_(get_resource), available_(), inuse_(), keyc_(default_key_) {}
 
+  // objects in use point back at their pool, so it can't be moved
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
   weak_t Get();
 
   void PrintStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     std::cout << available_.size() << " unused objects." << std::endl;
     std::cout << inuse_.size() << " used objects." << std::endl;
+    std::cout << SizeInBytes_() << " bytes." << std::endl;
+    std::cout << nreused_ << " objects reused, " << nallocated_
+              << " objects newly allocated." << std::endl;
   }
 
   std::uint64_t SizeInBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return SizeInBytes_();
+  }
+
+  // This should be used with care since it can't generically be
+  // checked that the input object has the same size as other objects
+  // in the pool
+  void AddFreeObjectToPool(const T &in) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_.push(in);
+  }
+  void AddFreeObjectToPool(T &&in) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_.emplace(in);
+  }
+
+ private:
+  std::uint64_t SizeInBytes_() const {
     constexpr std::uint64_t datum_size = sizeof(typename base_t::value_type);
     std::uint64_t object_size = 0;
     if (inuse_.size() > 0)
@@ -72,17 +107,14 @@ class ObjectPool {
     return datum_size * object_size * (inuse_.size() + available_.size());
   }
 
-  // This should be used with care since it can't generically be
-  // checked that the input object has the same size as other objects
-  // in the pool
-  void AddFreeObjectToPool(const T &in) { available_.push(in); }
-  void AddFreeObjectToPool(T &&in) { available_.emplace(in); }
-
- private:
-  bool IsValid(const weak_t &in) const { return inuse_.count(in.key_); }
+  bool IsValid(const weak_t &in) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inuse_.count(in.key_);
+  }
 
   void ReferenceCountedFree(const weak_t &in) {
-    if (!IsValid(in)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!inuse_.count(in.key_)) return;
     auto &pair = inuse_[in.key_];
     --pair.second;
     if (pair.second <= 0) {
@@ -92,13 +124,15 @@ class ObjectPool {
   }
 
   void Free(const weak_t &in) {
-    if (!IsValid(in)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!inuse_.count(in.key_)) return;
     available_.push(inuse_[in.key_].first);
     inuse_.erase(in.key_);
   }
 
   void AddCount(const weak_t &in) {
-    if (!IsValid(in)) throw 1;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!inuse_.count(in.key_)) throw 1;
     ++inuse_[in.key_].second;
   }
 };
@@ -228,11 +262,24 @@ class ObjectPool<T>::owner_t : public ObjectPool<T>::weak_t {
 template <class T>
 typename ObjectPool<T>::weak_t ObjectPool<T>::Get() {
   weak_t out;
-  if (available_.size() > 0) {
-    out = available_.top();
-    available_.pop();
+  bool reused = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (available_.size() > 0) {
+      out = available_.top();
+      available_.pop();
+      reused = true;
+    }
+  }
+  // the resource may add further free objects to the pool, so it is created without
+  // holding the lock
+  if (!reused) out = weak_t(get_resource_(this));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (reused) {
+    ++nreused_;
   } else {
-    out = weak_t(get_resource_(this));
+    ++nallocated_;
   }
   // Find an unused key that is not the default key
   while (inuse_.count(++keyc_) != 0 || keyc_ == default_key_) {
@@ -0,0 +1,111 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_PHASE_TIMES_HPP_
+#define UTILS_PHASE_TIMES_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+
+#include "globals.hpp"
+#include "parthenon_mpi.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+// Wall time this rank spends in the phases of a simulation, summed over the whole run
+// so that drivers can report a breakdown (see <parthenon/driver>/phase_report).  Phases
+// may nest, e.g., communication happens within the step, and time spent in tasks that
+// are executed concurrently by several threads is summed over the threads.
+namespace PhaseTimes {
+enum class Phase { step, communication, amr, output, timestep, count };
+
+inline const char *Name(const Phase phase) {
+  constexpr std::array<const char *, static_cast<int>(Phase::count)> names{
+      "step", "communication", "amr", "output", "timestep"};
+  return names[static_cast<int>(phase)];
+}
+
+// nanoseconds, so that threads can add to them without a lock
+inline std::array<std::atomic<std::int64_t>, static_cast<int>(Phase::count)> elapsed_ns{};
+
+inline void Add(const Phase phase, const double seconds) {
+  elapsed_ns[static_cast<int>(phase)] += static_cast<std::int64_t>(seconds * 1.0e9);
+}
+inline double Seconds(const Phase phase) {
+  return 1.0e-9 * elapsed_ns[static_cast<int>(phase)];
+}
+inline void Reset() {
+  for (auto &ns : elapsed_ns)
+    ns = 0;
+}
+// the seconds of all phases, e.g., to take differences between two points in time
+inline std::vector<double> AllSeconds() {
+  std::vector<double> seconds;
+  for (int p = 0; p < static_cast<int>(Phase::count); ++p) {
+    seconds.push_back(Seconds(static_cast<Phase>(p)));
+  }
+  return seconds;
+}
+
+// Adds the time until it goes out of scope to a phase
+class Scope {
+ public:
+  explicit Scope(const Phase phase) : phase_(phase) {}
+  ~Scope() { Add(phase_, timer_.seconds()); }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+ private:
+  Phase phase_;
+  Kokkos::Timer timer_;
+};
+
+// Minimum, maximum and mean over all ranks of values given by each rank, in two small
+// reductions.  Must be called by all ranks, the result is only valid on rank 0.
+struct RankStats {
+  std::vector<double> min, max, mean;
+};
+inline RankStats ReduceOverRanks(const std::vector<double> &vals) {
+  const int n = vals.size();
+  RankStats stats{vals, vals, vals};
+#ifdef MPI_PARALLEL
+  // the maximum is minus the minimum of the negated values
+  std::vector<double> both(2 * n);
+  for (int i = 0; i < n; ++i) {
+    both[i] = vals[i];
+    both[n + i] = -vals[i];
+  }
+  const bool root = Globals::my_rank == 0;
+  PARTHENON_MPI_CHECK(MPI_Reduce(root ? MPI_IN_PLACE : both.data(), both.data(), 2 * n,
+                                 MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD));
+  PARTHENON_MPI_CHECK(MPI_Reduce(root ? MPI_IN_PLACE : stats.mean.data(),
+                                 stats.mean.data(), n, MPI_DOUBLE, MPI_SUM, 0,
+                                 MPI_COMM_WORLD));
+  for (int i = 0; i < n; ++i) {
+    stats.min[i] = both[i];
+    stats.max[i] = -both[n + i];
+  }
+#endif
+  for (auto &mean : stats.mean)
+    mean /= Globals::nranks;
+  return stats;
+}
+} // namespace PhaseTimes
+
+} // namespace parthenon
+
+#endif // UTILS_PHASE_TIMES_HPP_
@@ -0,0 +1,124 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_RANDOM_HPP_
+#define UTILS_RANDOM_HPP_
+
+#include <cstdint>
+
+#include <Kokkos_Core.hpp>
+
+namespace parthenon {
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11), a
+// counter-based generator: the numbers are a pure function of a 128 bit counter and a
+// 64 bit key, so any thread can draw the numbers of any stream without a shared pool of
+// states, and without the results depending on which thread got which state.
+KOKKOS_INLINE_FUNCTION
+void Philox4x32(std::uint32_t ctr[4], std::uint32_t key0, std::uint32_t key1) {
+  constexpr std::uint32_t M0 = 0xD2511F53;
+  constexpr std::uint32_t M1 = 0xCD9E8D57;
+  constexpr std::uint32_t W0 = 0x9E3779B9;
+  constexpr std::uint32_t W1 = 0xBB67AE85;
+  for (int r = 0; r < 10; ++r) {
+    const std::uint64_t p0 = static_cast<std::uint64_t>(M0) * ctr[0];
+    const std::uint64_t p1 = static_cast<std::uint64_t>(M1) * ctr[2];
+    const std::uint32_t hi0 = p0 >> 32, lo0 = static_cast<std::uint32_t>(p0);
+    const std::uint32_t hi1 = p1 >> 32, lo1 = static_cast<std::uint32_t>(p1);
+    ctr[0] = hi1 ^ ctr[1] ^ key0;
+    ctr[1] = lo1;
+    ctr[2] = hi0 ^ ctr[3] ^ key1;
+    ctr[3] = lo0;
+    key0 += W0;
+    key1 += W1;
+  }
+}
+
+// A stream of random numbers keyed by the seed and three 32 bit words, typically the
+// gid of a block, the index of a cell (or particle) on it and the cycle.  The words
+// select the counter, the draws of the stream the fourth word of it, so each stream
+// has 2^32 blocks of four numbers.  It lives in registers, i.e., it is created inside
+// the kernel, one per thread, and is never shared.
+class RandomStream {
+ public:
+  KOKKOS_INLINE_FUNCTION
+  RandomStream(const std::uint64_t seed, const std::uint32_t w0, const std::uint32_t w1,
+               const std::uint32_t w2)
+      : key0_(static_cast<std::uint32_t>(seed)), key1_(seed >> 32), w_{w0, w1, w2} {}
+
+  // uniformly distributed 32 bit integer
+  KOKKOS_INLINE_FUNCTION
+  std::uint32_t urand() {
+    if (next_ == 4) {
+      ctr_[0] = w_[0];
+      ctr_[1] = w_[1];
+      ctr_[2] = w_[2];
+      ctr_[3] = block_++;
+      Philox4x32(ctr_, key0_, key1_);
+      next_ = 0;
+    }
+    return ctr_[next_++];
+  }
+
+  // uniformly distributed 64 bit integer
+  KOKKOS_INLINE_FUNCTION
+  std::uint64_t urand64() {
+    const std::uint64_t hi = urand();
+    return (hi << 32) | urand();
+  }
+
+  // uniformly distributed in [0, 1), with all 53 bits of a double
+  KOKKOS_INLINE_FUNCTION
+  double drand() { return (urand64() >> 11) * (1.0 / 9007199254740992.0); }
+
+  // uniformly distributed in [start, end)
+  KOKKOS_INLINE_FUNCTION
+  double drand(const double start, const double end) {
+    return start + (end - start) * drand();
+  }
+
+ private:
+  std::uint32_t key0_, key1_;
+  std::uint32_t w_[3];
+  std::uint32_t ctr_[4] = {0, 0, 0, 0};
+  std::uint32_t block_ = 0;
+  int next_ = 4;
+};
+
+// The framework's source of random numbers, see Mesh::GetRandomStreams.  It is copied
+// into kernels, where Stream returns the stream of, e.g., a cell on a block in a cycle.
+// Since the streams only depend on the seed and their keys, a run that is restarted
+// draws the same numbers as the original one, and results don't depend on the number
+// of threads or on the order they run in.
+class RandomStreams {
+ public:
+  RandomStreams() = default;
+  explicit RandomStreams(const std::uint64_t seed) : seed_(seed) {}
+
+  // Different parts of a code drawing for the same block, cell and cycle should pass
+  // different salts so that their numbers are independent
+  KOKKOS_INLINE_FUNCTION
+  RandomStream Stream(const int gid, const int index, const int cycle,
+                      const std::uint32_t salt = 0) const {
+    return RandomStream(seed_ ^ (static_cast<std::uint64_t>(salt) << 32), gid, index,
+                        cycle);
+  }
+
+  std::uint64_t Seed() const { return seed_; }
+
+ private:
+  std::uint64_t seed_ = 0;
+};
+
+} // namespace parthenon
+
+#endif // UTILS_RANDOM_HPP_
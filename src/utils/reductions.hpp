@@ -13,6 +13,7 @@
 #ifndef UTILS_REDUCTIONS_HPP_
 #define UTILS_REDUCTIONS_HPP_
 
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -55,6 +56,48 @@ MPI_Datatype GetContainerMPIType(const U &v) {
 }
 #endif
 
+// A single MPI_Iallreduce into which a ReductionBroker packs all reductions that were
+// added with the same operator and data type.
+class CoalescedReduction {
+ public:
+  // Returns true once the reduction has been started by ReductionBroker::Flush, is
+  // complete, and the results have been copied back into the values of the reductions.
+  bool Test() {
+    if (!started_) return false;
+#ifdef MPI_PARALLEL
+    if (!done_) {
+      int check = 1;
+      PARTHENON_MPI_CHECK(MPI_Test(&req_, &check, MPI_STATUS_IGNORE));
+      if (!check) return false;
+      std::size_t offset = 0;
+      for (auto &m : members_) {
+        std::memcpy(m.data, buffer_.data() + offset, m.bytes);
+        offset += m.bytes;
+      }
+    }
+#endif
+    done_ = true;
+    return true;
+  }
+
+ private:
+  friend class ReductionBroker;
+  MPI_Op op_;
+#ifdef MPI_PARALLEL
+  struct Member {
+    void *data;
+    std::size_t bytes;
+  };
+  MPI_Datatype type_;
+  std::vector<Member> members_;
+  int count_ = 0;
+  std::vector<char> buffer_;
+  MPI_Request req_;
+#endif
+  bool started_ = false;
+  bool done_ = false;
+};
+
 template <typename T>
 struct ReductionBase {
   T val;
@@ -63,6 +106,8 @@ struct ReductionBase {
   std::shared_ptr<MPI_Comm> pcomm;
 #endif
   bool active = false;
+  // set while the reduction is part of a coalesced reduction of a ReductionBroker
+  std::shared_ptr<CoalescedReduction> coalesced;
   ReductionBase() {
 #ifdef MPI_PARALLEL
     // Store the communicator in a shared_ptr, so that
@@ -76,9 +121,14 @@ struct ReductionBase {
   TaskStatus CheckReduce() {
     if (!active) return TaskStatus::complete;
     int check = 1;
+    if (coalesced) {
+      check = coalesced->Test();
+      if (check) coalesced.reset();
+    } else {
 #ifdef MPI_PARALLEL
-    PARTHENON_MPI_CHECK(MPI_Test(&req, &check, MPI_STATUS_IGNORE));
+      PARTHENON_MPI_CHECK(MPI_Test(&req, &check, MPI_STATUS_IGNORE));
 #endif
+    }
     if (check) {
       active = false;
       return TaskStatus::complete;
@@ -125,6 +175,89 @@ struct Reduce : public ReductionBase<T> {
   }
 };
 
+// Coalesces many small all-reductions, e.g., of different packages or solvers, into
+// one MPI_Iallreduce per operator and data type. Reductions are added with StartReduce
+// instead of AllReduce::StartReduce and are started by Flush, after which CheckReduce of
+// the reductions works as usual. CheckReduce never completes before Flush was called.
+// As for any collective, all ranks must add the same reductions in the same order
+// before calling Flush, e.g., by adding them in once_per_region tasks of the same
+// TaskRegion and calling Flush in a task that depends on all of them.
+class ReductionBroker {
+ public:
+  ReductionBroker() {
+#ifdef MPI_PARALLEL
+    pcomm_ = std::shared_ptr<MPI_Comm>(new MPI_Comm, MPI_Comm_disconnect);
+    PARTHENON_MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, pcomm_.get()));
+#endif
+  }
+
+  template <typename T>
+  TaskStatus StartReduce(AllReduce<T> *red, MPI_Op op) {
+    if (red->active) return TaskStatus::complete;
+#ifdef MPI_PARALLEL
+    const MPI_Datatype type = GetContainerMPIType(red->val);
+#endif
+    std::shared_ptr<CoalescedReduction> group;
+    for (auto &pending : pending_) {
+#ifdef MPI_PARALLEL
+      if (pending->op_ == op && pending->type_ == type) group = pending;
+#else
+      if (pending->op_ == op) group = pending;
+#endif
+    }
+    if (group == nullptr) {
+      group = std::make_shared<CoalescedReduction>();
+      group->op_ = op;
+#ifdef MPI_PARALLEL
+      group->type_ = type;
+#endif
+      pending_.push_back(group);
+    }
+#ifdef MPI_PARALLEL
+    const int count = contiguous_container::size(red->val);
+    group->members_.push_back({contiguous_container::data(red->val),
+                               count * sizeof(*contiguous_container::data(red->val))});
+    group->count_ += count;
+#endif
+    red->coalesced = group;
+    red->active = true;
+    return TaskStatus::complete;
+  }
+
+  // Starts one reduction for each operator and data type of the pending reductions
+  TaskStatus Flush() {
+    for (auto &group : pending_) {
+#ifdef MPI_PARALLEL
+      std::size_t bytes = 0;
+      for (auto &m : group->members_) {
+        bytes += m.bytes;
+      }
+      group->buffer_.resize(bytes);
+      std::size_t offset = 0;
+      for (auto &m : group->members_) {
+        std::memcpy(group->buffer_.data() + offset, m.data, m.bytes);
+        offset += m.bytes;
+      }
+      PARTHENON_MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, group->buffer_.data(),
+                                         group->count_, group->type_, group->op_,
+                                         *pcomm_, &(group->req_)));
+#endif
+      group->started_ = true;
+    }
+    pending_.clear();
+    return TaskStatus::complete;
+  }
+
+  // Number of reductions that Flush would start
+  int NumPending() const { return pending_.size(); }
+
+ private:
+  std::vector<std::shared_ptr<CoalescedReduction>> pending_;
+#ifdef MPI_PARALLEL
+  std::shared_ptr<MPI_Comm> pcomm_;
+#endif
+};
+
 } // namespace parthenon
 
 #endif // UTILS_REDUCTIONS_HPP_
@@ -22,6 +22,8 @@
 #include <unistd.h> // alarm() Unix OS utility; not in C standard --> no <cunistd>
 
 // first 2x macros and signal() are the only ISO C features; rest are POSIX C extensions
+#include <algorithm>
+#include <chrono>
 #include <csignal>
 #include <iostream>
 
@@ -36,6 +38,84 @@ namespace fs = FS_NAMESPACE;
 namespace parthenon {
 namespace SignalHandler {
 
+namespace {
+// see SetCheckOptions
+bool overlap_check = false;
+double poll_interval = 0.0;
+// when rank 0 last checked for the output_now file
+bool polled = false;
+std::chrono::steady_clock::time_point last_poll;
+// with overlap_check, an output_now trigger is on its way to the other ranks
+bool output_now_sent = false;
+#ifdef MPI_PARALLEL
+int flags_send[nsignal + 1], flags_recv[nsignal + 1];
+MPI_Request request = MPI_REQUEST_NULL;
+#endif
+
+void PollOutputNow() {
+  if (Globals::my_rank != 0) return;
+  const auto now = std::chrono::steady_clock::now();
+  if (polled && std::chrono::duration<double>(now - last_poll).count() < poll_interval) {
+    return;
+  }
+  polled = true;
+  last_poll = now;
+  // if file "output_now" exists
+  if (fs::exists("output_now")) {
+    signalflag[nsignal] = 1;
+  }
+}
+
+// Acts on the signal flags reduced over all ranks
+OutputSignal HandleFlags(const int *flags) {
+  for (int n = 0; n < nsignal; n++) {
+    if (flags[n] != 0) {
+      // so that GetSignalFlag reports it on all ranks
+      signalflag[n] = 1;
+      return OutputSignal::final;
+    }
+  }
+  if (flags[nsignal] != 0) {
+    // reset signalflag and cleanup trigger file
+    signalflag[nsignal] = 0;
+    output_now_sent = false;
+    if (Globals::my_rank == 0) {
+      // Cleanup trigger file.
+      // Fail hard in case there's an issue as otherwise this could lead to
+      // excessive file system load by writing dumps triggered every single cycle.
+      PARTHENON_REQUIRE_THROWS(
+          remove("output_now") == 0,
+          "Could not remove 'output_now' file that triggered output.");
+    }
+    return OutputSignal::now;
+  }
+  return OutputSignal::none;
+}
+
+#ifdef MPI_PARALLEL
+OutputSignal CheckSignalFlagsOverlapped() {
+  // the flags reduced by the previous call, if any
+  int flags[nsignal + 1] = {0};
+  if (request != MPI_REQUEST_NULL) {
+    PARTHENON_MPI_CHECK(MPI_Wait(&request, MPI_STATUS_IGNORE));
+    std::copy(flags_recv, flags_recv + nsignal + 1, flags);
+  }
+  // the file is only removed once the other ranks know about it
+  if (!output_now_sent) PollOutputNow();
+  sigprocmask(SIG_BLOCK, &mask, nullptr);
+  for (int n = 0; n < nsignal + 1; n++) {
+    flags_send[n] = signalflag[n];
+  }
+  signalflag[nsignal] = 0;
+  sigprocmask(SIG_UNBLOCK, &mask, nullptr);
+  if (flags_send[nsignal] != 0) output_now_sent = true;
+  PARTHENON_MPI_CHECK(MPI_Iallreduce(flags_send, flags_recv, nsignal + 1, MPI_INT,
+                                     MPI_MAX, MPI_COMM_WORLD, &request));
+  return HandleFlags(flags);
+}
+#endif
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn void SignalHandlerInit()
 //  \brief install handlers for selected signals
@@ -58,17 +138,24 @@ void SignalHandlerInit() {
   sigaddset(&mask, SIGALRM);
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void SetCheckOptions(bool overlap, double output_now_interval)
+//  \brief Set how CheckSignalFlags synchronizes the signal flags
+
+void SetCheckOptions(bool overlap, double output_now_interval) {
+  overlap_check = overlap;
+  poll_interval = output_now_interval;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn int CheckSignalFlags()
 //  \brief Synchronize and check signal flags and return true if any of them is caught
 
 OutputSignal CheckSignalFlags() {
-  if (Globals::my_rank == 0) {
-    // if file "output_now" exists
-    if (fs::exists("output_now")) {
-      signalflag[nsignal] = 1;
-    }
-  }
+#ifdef MPI_PARALLEL
+  if (overlap_check) return CheckSignalFlagsOverlapped();
+#endif
+  PollOutputNow();
   // Currently, only checking for nonzero return code at the end of each timestep in
   // main.cpp; i.e. if an issue prevents a process from reaching the end of a cycle, the
   // signals will never be handled by that process / the solver may hang
@@ -79,25 +166,27 @@ OutputSignal CheckSignalFlags() {
       nsignal + 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD));
 #endif
   sigprocmask(SIG_UNBLOCK, &mask, nullptr);
-  for (int n = 0; n < nsignal; n++) {
-    if (signalflag[n] != 0) {
-      return OutputSignal::final;
-    }
+  int flags[nsignal + 1];
+  for (int n = 0; n < nsignal + 1; n++) {
+    flags[n] = signalflag[n];
   }
-  if (signalflag[nsignal] != 0) {
-    // reset signalflag and cleanup trigger file
-    signalflag[nsignal] = 0;
-    if (Globals::my_rank == 0) {
-      // Cleanup trigger file.
-      // Fail hard in case there's an issue as otherwise this could lead to
-      // excessive file system load by writing dumps triggered every single cycle.
-      PARTHENON_REQUIRE_THROWS(
-          remove("output_now") == 0,
-          "Could not remove 'output_now' file that triggered output.");
+  return HandleFlags(flags);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void FinishSignalCheck()
+//  \brief Complete the reduction started by an overlapped CheckSignalFlags, keeping
+//         the signals it found for Report
+
+void FinishSignalCheck() {
+#ifdef MPI_PARALLEL
+  if (request != MPI_REQUEST_NULL) {
+    PARTHENON_MPI_CHECK(MPI_Wait(&request, MPI_STATUS_IGNORE));
+    for (int n = 0; n < nsignal; n++) {
+      if (flags_recv[n] != 0) signalflag[n] = 1;
     }
-    return OutputSignal::now;
   }
-  return OutputSignal::none;
+#endif
 }
 
 //----------------------------------------------------------------------------------------
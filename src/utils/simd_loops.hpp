@@ -0,0 +1,158 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_SIMD_LOOPS_HPP_
+#define UTILS_SIMD_LOOPS_HPP_
+
+#include <cstddef>
+#include <string>
+
+#include <Kokkos_SIMD.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+
+namespace parthenon {
+
+// Loops whose functions operate on SIMD vectors of consecutive cells in i, via
+// Kokkos::Experimental::simd, so that host kernels vectorize even if the compiler can't
+// see through the indirection of packs.  On the host the vectors have the native width
+// Kokkos picks for the target (e.g. 8 doubles with AVX-512), on devices, and for
+// targets without a native SIMD ABI, they have a single lane, so the same kernels run
+// everywhere.
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP) ||                       \
+    defined(KOKKOS_ENABLE_SYCL)
+using SimdAbi = Kokkos::Experimental::simd_abi::scalar;
+#else
+using SimdAbi = Kokkos::Experimental::simd_abi::native<Real>;
+#endif
+using SimdReal = Kokkos::Experimental::simd<Real, SimdAbi>;
+using SimdMask = typename SimdReal::mask_type;
+constexpr int simd_width = SimdReal::size();
+
+// The lanes of one call of a par_for_simd function: cells i() to i() + size() - 1 of
+// a row.  size() is simd_width except for the last, masked, vector of a row.  Loads and
+// stores take a pointer to the element of cell i(), e.g. &pack(b, v, k, j, lanes.i()),
+// and leave inactive lanes untouched, so they never access memory past the row.
+class SimdLanes {
+ public:
+  KOKKOS_FORCEINLINE_FUNCTION SimdLanes(const int i, const int n) : i_(i), n_(n) {}
+
+  KOKKOS_FORCEINLINE_FUNCTION int i() const { return i_; }
+  KOKKOS_FORCEINLINE_FUNCTION int size() const { return n_; }
+  KOKKOS_FORCEINLINE_FUNCTION bool Full() const { return n_ == simd_width; }
+
+  KOKKOS_FORCEINLINE_FUNCTION SimdMask Mask() const {
+    const SimdReal lane([](const std::size_t l) { return static_cast<Real>(l); });
+    return lane < SimdReal(static_cast<Real>(n_));
+  }
+
+  KOKKOS_FORCEINLINE_FUNCTION SimdReal Load(const Real *ptr) const {
+    SimdReal val(0.0);
+    if (Full()) {
+      val.copy_from(ptr, Kokkos::Experimental::element_aligned_tag());
+    } else {
+      Kokkos::Experimental::where(Mask(), val)
+          .copy_from(ptr, Kokkos::Experimental::element_aligned_tag());
+    }
+    return val;
+  }
+
+  KOKKOS_FORCEINLINE_FUNCTION void Store(const SimdReal &val, Real *ptr) const {
+    if (Full()) {
+      val.copy_to(ptr, Kokkos::Experimental::element_aligned_tag());
+    } else {
+      Kokkos::Experimental::where(Mask(), val)
+          .copy_to(ptr, Kokkos::Experimental::element_aligned_tag());
+    }
+  }
+
+  // The vector of f(i) for the cells of the lanes, e.g. for metric terms of the
+  // coordinates.  Inactive lanes repeat the last active cell.
+  template <typename F>
+  KOKKOS_FORCEINLINE_FUNCTION SimdReal Gather(const F &f) const {
+    const int i0 = i_;
+    const int last = n_ - 1;
+    return SimdReal([&](const std::size_t l) {
+      return f(i0 + (static_cast<int>(l) < last ? static_cast<int>(l) : last));
+    });
+  }
+
+ private:
+  int i_;
+  int n_;
+};
+
+namespace simd_impl {
+KOKKOS_FORCEINLINE_FUNCTION SimdLanes MakeLanes(const int il, const int iu,
+                                                const int chunk) {
+  const int i = il + chunk * simd_width;
+  const int n = iu + 1 - i;
+  return SimdLanes(i, n < simd_width ? n : simd_width);
+}
+KOKKOS_FORCEINLINE_FUNCTION int NumChunks(const int il, const int iu) {
+  return (iu - il + simd_width) / simd_width;
+}
+} // namespace simd_impl
+
+// function(k, j, lanes) for all rows (k, j) and all vectors of lanes covering il to iu
+template <typename Function>
+inline void par_for_simd(const std::string &name, DevExecSpace exec_space, const int kl,
+                         const int ku, const int jl, const int ju, const int il,
+                         const int iu, const Function &function) {
+  if (ku < kl || ju < jl || iu < il) return;
+  Kokkos::parallel_for(
+      name,
+      dispatch_impl::MakeMDRangePolicy<3, 0, 0>(
+          name, exec_space, {kl, jl, 0}, {ku + 1, ju + 1, simd_impl::NumChunks(il, iu)}),
+      KOKKOS_LAMBDA(const int k, const int j, const int c) {
+        function(k, j, simd_impl::MakeLanes(il, iu, c));
+      });
+}
+
+// function(n, k, j, lanes)
+template <typename Function>
+inline void par_for_simd(const std::string &name, DevExecSpace exec_space, const int nl,
+                         const int nu, const int kl, const int ku, const int jl,
+                         const int ju, const int il, const int iu,
+                         const Function &function) {
+  if (nu < nl || ku < kl || ju < jl || iu < il) return;
+  Kokkos::parallel_for(
+      name,
+      dispatch_impl::MakeMDRangePolicy<4, 0, 0>(
+          name, exec_space, {nl, kl, jl, 0},
+          {nu + 1, ku + 1, ju + 1, simd_impl::NumChunks(il, iu)}),
+      KOKKOS_LAMBDA(const int n, const int k, const int j, const int c) {
+        function(n, k, j, simd_impl::MakeLanes(il, iu, c));
+      });
+}
+
+// function(m, n, k, j, lanes), e.g. for the blocks and variables of a pack
+template <typename Function>
+inline void par_for_simd(const std::string &name, DevExecSpace exec_space, const int ml,
+                         const int mu, const int nl, const int nu, const int kl,
+                         const int ku, const int jl, const int ju, const int il,
+                         const int iu, const Function &function) {
+  if (mu < ml || nu < nl || ku < kl || ju < jl || iu < il) return;
+  Kokkos::parallel_for(
+      name,
+      dispatch_impl::MakeMDRangePolicy<5, 0, 0>(
+          name, exec_space, {ml, nl, kl, jl, 0},
+          {mu + 1, nu + 1, ku + 1, ju + 1, simd_impl::NumChunks(il, iu)}),
+      KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int c) {
+        function(m, n, k, j, simd_impl::MakeLanes(il, iu, c));
+      });
+}
+
+} // namespace parthenon
+
+#endif // UTILS_SIMD_LOOPS_HPP_
@@ -28,6 +28,7 @@
 #endif
 
 #include <algorithm>
+#include <utility>
 
 namespace parthenon {
 
@@ -78,9 +79,13 @@ void sort(ParArray1D<Key> data, KeyComparator comparator, size_t min_idx,
   if (std::is_same<DevExecSpace, HostExecSpace>::value) {
     std::sort(data.data() + min_idx, data.data() + max_idx + 1, comparator);
   } else {
-    PARTHENON_FAIL("sort is not supported outside of CPU or NVIDIA GPU. If you need sort "
-                   "support on other devices, e.g., AMD or Intel GPUs, please get in "
-                   "touch by opening an issue on the Parthenon GitHub.");
+#if KOKKOS_VERSION >= 40200
+    auto sub = Kokkos::subview(data.KokkosView(), std::make_pair(min_idx, max_idx + 1));
+    Kokkos::sort(DevExecSpace(), sub, comparator);
+#else
+    PARTHENON_FAIL("sort outside of CPU or NVIDIA GPU requires Kokkos 4.2 or later, "
+                   "or use counting_sort for integer keys.");
+#endif
   }
 #endif // KOKKOS_ENABLE_CUDA
 }
@@ -106,13 +111,70 @@ void sort(ParArray1D<Key> data, size_t min_idx, size_t max_idx) {
   if (std::is_same<DevExecSpace, HostExecSpace>::value) {
     std::sort(data.data() + min_idx, data.data() + max_idx + 1);
   } else {
-    PARTHENON_FAIL("sort is not supported outside of CPU or NVIDIA GPU. If you need sort "
-                   "support on other devices, e.g., AMD or Intel GPUs, please get in "
-                   "touch by opening an issue on the Parthenon GitHub.");
+#if KOKKOS_VERSION >= 40200
+    auto sub = Kokkos::subview(data.KokkosView(), std::make_pair(min_idx, max_idx + 1));
+    Kokkos::sort(DevExecSpace(), sub);
+#else
+    PARTHENON_FAIL("sort outside of CPU or NVIDIA GPU requires Kokkos 4.2 or later, "
+                   "or use counting_sort for integer keys.");
+#endif
   }
 #endif // KOKKOS_ENABLE_CUDA
 }
 
+// Sorts data(min_idx) to data(max_idx) by the integer key(data(n)), which has to be in
+// [0, num_keys), with a counting sort, i.e., a radix sort with a single digit that covers
+// all keys.  It runs on all backends and only takes a pass over the data to count the
+// keys, a scan over the counts and a pass to scatter the data.  Elements with the same
+// key end up in no particular order.  On return, counts(k) is the number of elements
+// with key k and ends(k) is one past the index (relative to min_idx) of the last of them,
+// so they are at ends(k) - counts(k) to ends(k) - 1.
+template <class Value, class KeyFunction>
+void counting_sort(ParArray1D<Value> data, KeyFunction key, const int num_keys,
+                   size_t min_idx, size_t max_idx,
+                   Kokkos::View<int *, DevMemSpace> counts,
+                   Kokkos::View<int *, DevMemSpace> ends) {
+  PARTHENON_DEBUG_REQUIRE(min_idx < data.extent(0), "Invalid minimum sort index!");
+  PARTHENON_DEBUG_REQUIRE(max_idx < data.extent(0), "Invalid maximum sort index!");
+  PARTHENON_REQUIRE(counts.extent_int(0) >= num_keys && ends.extent_int(0) >= num_keys,
+                    "Key counts are too small");
+  const int n = max_idx - min_idx + 1;
+  Kokkos::deep_copy(DevExecSpace(), counts, 0);
+  auto offsets = ends;
+  Kokkos::View<Value *, DevMemSpace> sorted(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "counting_sort sorted"), n);
+  Kokkos::parallel_for(
+      "counting_sort count", Kokkos::RangePolicy<>(DevExecSpace(), 0, n),
+      KOKKOS_LAMBDA(const int m) {
+        const int k = key(data(min_idx + m));
+        PARTHENON_DEBUG_REQUIRE(k >= 0 && k < num_keys, "Key out of range!");
+        Kokkos::atomic_increment(&counts(k));
+      });
+  Kokkos::parallel_scan(
+      "counting_sort scan", Kokkos::RangePolicy<>(DevExecSpace(), 0, num_keys),
+      KOKKOS_LAMBDA(const int k, int &sum, const bool final) {
+        if (final) offsets(k) = sum;
+        sum += counts(k);
+      });
+  Kokkos::parallel_for(
+      "counting_sort scatter", Kokkos::RangePolicy<>(DevExecSpace(), 0, n),
+      KOKKOS_LAMBDA(const int m) {
+        const Value v = data(min_idx + m);
+        sorted(Kokkos::atomic_fetch_add(&offsets(key(v)), 1)) = v;
+      });
+  Kokkos::parallel_for(
+      "counting_sort copy", Kokkos::RangePolicy<>(DevExecSpace(), 0, n),
+      KOKKOS_LAMBDA(const int m) { data(min_idx + m) = sorted(m); });
+}
+
+template <class Value, class KeyFunction>
+void counting_sort(ParArray1D<Value> data, KeyFunction key, const int num_keys,
+                   size_t min_idx, size_t max_idx) {
+  Kokkos::View<int *, DevMemSpace> counts("counting_sort counts", num_keys);
+  Kokkos::View<int *, DevMemSpace> ends("counting_sort ends", num_keys);
+  counting_sort(data, key, num_keys, min_idx, max_idx, counts, ends);
+}
+
 template <class Key, class KeyComparator>
 void sort(ParArray1D<Key> data, KeyComparator comparator) {
   sort(data, comparator, 0, data.extent(0) - 1);
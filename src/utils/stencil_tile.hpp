@@ -0,0 +1,178 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_STENCIL_TILE_HPP_
+#define UTILS_STENCIL_TILE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/domain.hpp"
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+// Extents of the tiles of par_for_tiles, in cells, and the number of ghost cells around
+// them that are staged as well.  If a tile extent is larger than the range it tiles,
+// the range is covered by a single tile in that direction.
+struct TileShape {
+  int nk = 1, nj = 4, ni = 32;
+  int halo_k = 0, halo_j = 0, halo_i = 0;
+
+  TileShape() = default;
+  // tiles of nk x nj x ni cells with halo ghost cells in the first ndim directions
+  TileShape(const int nk_, const int nj_, const int ni_, const int halo, const int ndim)
+      : nk(nk_), nj(nj_), ni(ni_), halo_k(ndim > 2 ? halo : 0),
+        halo_j(ndim > 1 ? halo : 0), halo_i(halo) {}
+};
+
+// One tile, plus halo, of nvar variables in team scratch memory.  It is indexed with
+// the indices of the cells of the block, i.e., tile(n, k, j, i) for k in
+// [KS() - halo_k, KE() + halo_k] etc., where KS() and KE() are the first and last
+// cell of the tile itself.  The first variables are typically loaded from global
+// memory once with Load, the remaining ones can hold the results of one pass of a
+// stencil for the next one, so that none of them go through global memory.
+template <typename T = Real>
+class StencilTile {
+ public:
+  using view_t = ScratchPad4D<T>;
+
+  KOKKOS_INLINE_FUNCTION
+  StencilTile(const team_mbr_t &team_member, const int scratch_level, const int nvar,
+              const TileShape &shape, const int ks, const int ke, const int js,
+              const int je, const int is, const int ie)
+      : data_(team_member.team_scratch(scratch_level), nvar, shape.nk + 2 * shape.halo_k,
+              shape.nj + 2 * shape.halo_j, shape.ni + 2 * shape.halo_i),
+        ks_(ks), ke_(ke), js_(js), je_(je), is_(is), ie_(ie), hk_(shape.halo_k),
+        hj_(shape.halo_j), hi_(shape.halo_i) {}
+
+  // scratch memory a tile takes, for the scratch size of par_for_tiles
+  static std::size_t ScratchSize(const int nvar, const TileShape &shape) {
+    return view_t::shmem_size(nvar, shape.nk + 2 * shape.halo_k,
+                              shape.nj + 2 * shape.halo_j, shape.ni + 2 * shape.halo_i);
+  }
+
+  KOKKOS_FORCEINLINE_FUNCTION
+  T &operator()(const int n, const int k, const int j, const int i) const {
+    return data_(n, k - ks_ + hk_, j - js_ + hj_, i - is_ + hi_);
+  }
+
+  KOKKOS_FORCEINLINE_FUNCTION int NumVars() const { return data_.extent_int(0); }
+  KOKKOS_FORCEINLINE_FUNCTION int KS() const { return ks_; }
+  KOKKOS_FORCEINLINE_FUNCTION int KE() const { return ke_; }
+  KOKKOS_FORCEINLINE_FUNCTION int JS() const { return js_; }
+  KOKKOS_FORCEINLINE_FUNCTION int JE() const { return je_; }
+  KOKKOS_FORCEINLINE_FUNCTION int IS() const { return is_; }
+  KOKKOS_FORCEINLINE_FUNCTION int IE() const { return ie_; }
+
+  // Calls function(k, j, i) for all cells of the tile, grown by the given number of
+  // ghost cells in each direction (at most the halo), from all threads of the team
+  template <typename Function>
+  KOKKOS_INLINE_FUNCTION void ForEach(const team_mbr_t &team_member,
+                                      const Function &function, const int gk = 0,
+                                      const int gj = 0, const int gi = 0) const {
+    const int kl = ks_ - gk;
+    const int jl = js_ - gj;
+    const int il = is_ - gi;
+    const int Nj = je_ + gj - jl + 1;
+    const int Ni = ie_ + gi - il + 1;
+    const int NkNj = (ke_ + gk - kl + 1) * Nj;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(team_member, NkNj), [&](const int kj) {
+      const int k = kl + kj / Nj;
+      const int j = jl + kj % Nj;
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange<>(team_member, Ni),
+                           [&](const int m) { function(k, j, il + m); });
+    });
+  }
+
+  // Loads variables nl to nu of the tile and its halo with source(n, k, j, i) and waits
+  // for the whole team to finish
+  template <typename Source>
+  KOKKOS_INLINE_FUNCTION void Load(const team_mbr_t &team_member, const Source &source,
+                                   const int nl, const int nu) const {
+    for (int n = nl; n <= nu; ++n) {
+      ForEach(
+          team_member,
+          [&](const int k, const int j, const int i) {
+            (*this)(n, k, j, i) = source(n, k, j, i);
+          },
+          hk_, hj_, hi_);
+    }
+    team_member.team_barrier();
+  }
+  template <typename Source>
+  KOKKOS_INLINE_FUNCTION void Load(const team_mbr_t &team_member,
+                                   const Source &source) const {
+    Load(team_member, source, 0, NumVars() - 1);
+  }
+
+ private:
+  view_t data_;
+  int ks_, ke_, js_, je_, is_, ie_;
+  int hk_, hj_, hi_;
+};
+
+// Outer loop over the tiles of the cells kb x jb x ib of blocks bl to bu, with one team
+// per tile.  function(team_member, b, tile) gets the still empty StencilTile of nvar
+// variables of its tile of block b, which it fills with tile.Load and then runs one or
+// more passes over with tile.ForEach, separated by team_member.team_barrier().  The halo
+// of the shape has to be within the ghost cells of the data that is loaded.
+template <typename Function>
+inline void par_for_tiles(const std::string &name, DevExecSpace exec_space,
+                          const int scratch_level, const int nvar, const TileShape &shape,
+                          const int bl, const int bu, const IndexRange &kb,
+                          const IndexRange &jb, const IndexRange &ib,
+                          const Function &function) {
+  const int nblocks = bu - bl + 1;
+  if (nblocks <= 0 || nvar <= 0 || kb.e < kb.s || jb.e < jb.s || ib.e < ib.s) return;
+  PARTHENON_REQUIRE(shape.nk > 0 && shape.nj > 0 && shape.ni > 0,
+                    "Tiles must contain at least one cell");
+  const int nk = std::min(shape.nk, kb.e - kb.s + 1);
+  const int nj = std::min(shape.nj, jb.e - jb.s + 1);
+  const int ni = std::min(shape.ni, ib.e - ib.s + 1);
+  TileShape tile_shape = shape;
+  tile_shape.nk = nk;
+  tile_shape.nj = nj;
+  tile_shape.ni = ni;
+  const int Tk = (kb.e - kb.s + nk) / nk;
+  const int Tj = (jb.e - jb.s + nj) / nj;
+  const int Ti = (ib.e - ib.s + ni) / ni;
+  const int ntiles = Tk * Tj * Ti;
+
+  auto policy = dispatch_impl::MakeTeamPolicy<0, 0>(name, exec_space, nblocks * ntiles);
+  const std::size_t scratch_size = StencilTile<Real>::ScratchSize(nvar, tile_shape);
+  Kokkos::parallel_for(
+      name, policy.set_scratch_size(scratch_level, Kokkos::PerTeam(scratch_size)),
+      KOKKOS_LAMBDA(team_mbr_t team_member) {
+        const int b = bl + team_member.league_rank() / ntiles;
+        int t = team_member.league_rank() % ntiles;
+        const int tk = t / (Tj * Ti);
+        t -= tk * Tj * Ti;
+        const int tj = t / Ti;
+        const int ti = t - tj * Ti;
+        const int ks = kb.s + tk * nk;
+        const int js = jb.s + tj * nj;
+        const int is = ib.s + ti * ni;
+        StencilTile<Real> tile(team_member, scratch_level, nvar, tile_shape, ks,
+                               Kokkos::min(ks + nk - 1, kb.e), js,
+                               Kokkos::min(js + nj - 1, jb.e), is,
+                               Kokkos::min(is + ni - 1, ib.e));
+        function(team_member, b, tile);
+      });
+}
+
+} // namespace parthenon
+
+#endif // UTILS_STENCIL_TILE_HPP_
@@ -0,0 +1,93 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "utils/telemetry.hpp"
+
+#include "utils/error_checking.hpp"
+
+namespace parthenon {
+
+TelemetryWriter::TelemetryWriter(const std::string &filename)
+    : csv_(filename.size() >= 4 && filename.substr(filename.size() - 4) == ".csv") {
+  // append, e.g., to the records of the run a restart continues
+  write_header_ = csv_ && !std::ifstream(filename).good();
+  out_.open(filename, std::ios::app);
+  PARTHENON_REQUIRE_THROWS(out_.good(), "Could not open telemetry file " + filename);
+}
+
+TelemetryWriter::~TelemetryWriter() {
+  if (pending_.valid()) pending_.wait();
+}
+
+void TelemetryWriter::Write(const Record &record) {
+  // formatting is cheap, only the writing goes to the background
+  std::string lines;
+  if (write_header_) lines = Header(record) + "\n";
+  write_header_ = false;
+  lines += Format(record, csv_) + "\n";
+  Wait();
+  pending_ = std::async(std::launch::async, [this, lines]() {
+    out_ << lines << std::flush;
+    PARTHENON_REQUIRE_THROWS(out_.good(), "Writing telemetry failed");
+  });
+}
+
+void TelemetryWriter::Wait() {
+  if (pending_.valid()) pending_.get();
+}
+
+std::string TelemetryWriter::Header(const Record &record) {
+  std::string header;
+  for (const auto &[name, vals] : record) {
+    header += (header.empty() ? "" : ",") + name;
+  }
+  return header;
+}
+
+std::string TelemetryWriter::Format(const Record &record, const bool csv) {
+  std::ostringstream os;
+  // integers, e.g. byte counts, up to 10^15 are exact
+  os << std::setprecision(std::numeric_limits<double>::digits10);
+  auto number = [&](const double val) {
+    // json has no NaN or infinity
+    if (!csv && !std::isfinite(val)) {
+      os << "null";
+    } else {
+      os << val;
+    }
+  };
+  if (!csv) os << "{";
+  for (std::size_t n = 0; n < record.size(); ++n) {
+    const auto &[name, vals] = record[n];
+    if (n > 0) os << (csv ? "," : ", ");
+    if (!csv) os << "\"" << name << "\": ";
+    const bool array = !csv && vals.size() != 1;
+    if (array) os << "[";
+    for (std::size_t i = 0; i < vals.size(); ++i) {
+      if (i > 0) os << (csv ? ";" : ", ");
+      number(vals[i]);
+    }
+    if (array) os << "]";
+  }
+  if (!csv) os << "}";
+  return os.str();
+}
+
+} // namespace parthenon
@@ -0,0 +1,59 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#ifndef UTILS_TELEMETRY_HPP_
+#define UTILS_TELEMETRY_HPP_
+
+#include <fstream>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace parthenon {
+
+// Appends records of named values, e.g., the performance counters of a cycle, to a file
+// that monitoring tools can ingest: one json object per line, or a CSV file if the
+// filename ends in ".csv".  Each value is a number or a list of numbers, which is a json
+// array or joined by ';' in a CSV column.  A CSV file gets a header with the names of
+// the first record if it is new, so all records written to it must have the same names.
+// The lines are written on a background thread, one record at a time, so that a slow
+// file system doesn't hold up the caller.
+class TelemetryWriter {
+ public:
+  using Record = std::vector<std::pair<std::string, std::vector<double>>>;
+
+  explicit TelemetryWriter(const std::string &filename);
+  ~TelemetryWriter();
+  TelemetryWriter(const TelemetryWriter &) = delete;
+  TelemetryWriter &operator=(const TelemetryWriter &) = delete;
+
+  // queue record once the previous one is written
+  void Write(const Record &record);
+  // block until all records are written, rethrowing errors of the background thread
+  void Wait();
+
+  bool IsCSV() const { return csv_; }
+  // the line the record is written as, without the newline, and the CSV header
+  static std::string Format(const Record &record, bool csv);
+  static std::string Header(const Record &record);
+
+ private:
+  std::ofstream out_;
+  bool csv_;
+  bool write_header_;
+  std::future<void> pending_;
+};
+
+} // namespace parthenon
+
+#endif // UTILS_TELEMETRY_HPP_
@@ -77,7 +77,13 @@ static volatile int signalflag[nsignal + 1];
 const int ITERM = 0, IINT = 1, IALRM = 2;
 static sigset_t mask;
 void SignalHandlerInit();
+// With overlap, CheckSignalFlags only starts the reduction of the signal flags over all
+// ranks and acts on the result of the previous call, so that it doesn't block.  Rank 0
+// checks for the output_now file at most every output_now_interval seconds.
+void SetCheckOptions(bool overlap, double output_now_interval);
 OutputSignal CheckSignalFlags();
+// completes a reduction still in flight, e.g., at the end of the main loop
+void FinishSignalCheck();
 int GetSignalFlag(int s);
 void SetSignalFlag(int s);
 void SetWallTimeAlarm(int t);
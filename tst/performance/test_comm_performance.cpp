@@ -0,0 +1,135 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "bvals/comms/bnd_info.hpp"
+#include "globals.hpp"
+#include "interface/meshblock_data.hpp"
+#include "interface/metadata.hpp"
+#include "interface/state_descriptor.hpp"
+#include "interface/variable.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/domain.hpp"
+#include "mesh/meshblock.hpp"
+
+// TODO(jcd): can't call the MeshBlock constructor without mesh_refinement.hpp???
+#include "mesh/mesh_refinement.hpp"
+
+using parthenon::BndInfo;
+using parthenon::BndInfoArr_t;
+using parthenon::IndexDomain;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::ParArray1D;
+using parthenon::Real;
+using parthenon::StateDescriptor;
+using parthenon::team_mbr_t;
+
+// Loading the buffers of the boundaries of face and edge fields, with their rows (runs
+// of cells in the i direction) handled element by element, as SendBoundBufs used to, or
+// all at once
+TEST_CASE("Loading boundary buffers of face and edge fields", "[BndInfo][performance]") {
+  constexpr int N = 32;
+  constexpr int NDIM = 3;
+  constexpr int NBOUNDS = 64;
+
+  auto pkg = std::make_shared<StateDescriptor>("Test package");
+  pkg->AddField("face", Metadata({Metadata::Face, Metadata::Independent}));
+  pkg->AddField("edge", Metadata({Metadata::Edge, Metadata::Independent}));
+  auto pmb = std::make_shared<MeshBlock>(N, NDIM);
+  pmb->meshblock_data.Get()->Initialize(pkg, pmb);
+
+  // the ghost layers of the x3 boundary, the same slab for all boundaries
+  const int ng = parthenon::Globals::nghost;
+  BndInfoArr_t bnd_info("bnd_info", NBOUNDS);
+  auto bnd_info_h = Kokkos::create_mirror_view(bnd_info);
+  std::size_t size = 0;
+  for (int b = 0; b < NBOUNDS; ++b) {
+    auto v = pmb->meshblock_data.Get()->GetVarPtr(b % 2 == 0 ? "face" : "edge");
+    BndInfo &info = bnd_info_h(b);
+    info.var = v->data;
+    const auto elements = v->GetTopologicalElements();
+    info.ntopological_elements = elements.size();
+    parthenon::block_ownership_t owns(true);
+    std::size_t info_size = 0;
+    for (int iel = 0; iel < elements.size(); ++iel) {
+      const auto el = elements[iel];
+      const auto kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior, el);
+      const auto jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior, el);
+      const auto ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior, el);
+      info.idxer[iel] = parthenon::SpatiallyMaskedIndexer6D(
+          owns, {0, info.var.GetDim(6) - 1}, {0, info.var.GetDim(5) - 1},
+          {0, info.var.GetDim(4) - 1}, {kb.s, kb.s + ng - 1}, {jb.s, jb.e},
+          {ib.s, ib.e});
+      info_size += info.idxer[iel].size();
+    }
+    size = std::max(size, info_size);
+  }
+  Kokkos::deep_copy(bnd_info, bnd_info_h);
+  ParArray1D<Real> bufs("bufs", NBOUNDS * size);
+
+  BENCHMARK("BndInfo: load face and edge buffers element by element") {
+    Kokkos::parallel_for(
+        "per element", Kokkos::TeamPolicy<>(NBOUNDS, Kokkos::AUTO),
+        KOKKOS_LAMBDA(team_mbr_t team_member) {
+          const int b = team_member.league_rank();
+          Real *buf = &bufs(b * size);
+          int offset = 0;
+          for (int iel = 0; iel < bnd_info(b).ntopological_elements; ++iel) {
+            auto &idxer = bnd_info(b).idxer[iel];
+            const int Ni = bnd_info(b).RowLength(iel);
+            Kokkos::parallel_for(
+                Kokkos::TeamThreadRange<>(team_member, idxer.size() / Ni),
+                [&](const int idx) {
+                  const auto [t, u, v, k, j, i] = idxer(idx * Ni);
+                  Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
+                  Kokkos::parallel_for(
+                      Kokkos::ThreadVectorRange<>(team_member, Ni),
+                      [&](int m) { buf[idx * Ni + offset + m] = var[m]; });
+                });
+            offset += idxer.size();
+          }
+        });
+    Kokkos::fence();
+    return size;
+  };
+
+  BENCHMARK("BndInfo: load face and edge buffers by rows of all elements") {
+    Kokkos::parallel_for(
+        "fused rows", Kokkos::TeamPolicy<>(NBOUNDS, Kokkos::AUTO),
+        KOKKOS_LAMBDA(team_mbr_t team_member) {
+          const int b = team_member.league_rank();
+          Real *buf = &bufs(b * size);
+          Kokkos::parallel_for(
+              Kokkos::TeamThreadRange<>(team_member, bnd_info(b).NumRows()),
+              [&](const int row) {
+                int iel, idx, offset;
+                bnd_info(b).FindRow(row, iel, idx, offset);
+                const int Ni = bnd_info(b).RowLength(iel);
+                const auto [t, u, v, k, j, i] = bnd_info(b).idxer[iel](idx * Ni);
+                Real *var = &bnd_info(b).var(iel, t, u, v, k, j, i);
+                Kokkos::parallel_for(
+                    Kokkos::ThreadVectorRange<>(team_member, Ni),
+                    [&](int m) { buf[idx * Ni + offset + m] = var[m]; });
+              });
+        });
+    Kokkos::fence();
+    return size;
+  };
+}
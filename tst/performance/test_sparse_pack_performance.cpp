@@ -0,0 +1,88 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "interface/make_pack_descriptor.hpp"
+#include "interface/mesh_data.hpp"
+#include "interface/meshblock_data.hpp"
+#include "interface/metadata.hpp"
+#include "interface/sparse_pack.hpp"
+#include "interface/state_descriptor.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/meshblock.hpp"
+
+// TODO(jcd): can't call the MeshBlock constructor without mesh_refinement.hpp???
+#include "mesh/mesh_refinement.hpp"
+
+using parthenon::BlockList_t;
+using parthenon::MeshBlock;
+using parthenon::MeshData;
+using parthenon::Metadata;
+using parthenon::Real;
+using parthenon::StateDescriptor;
+
+TEST_CASE("SparsePack construction and caching", "[SparsePack][performance]") {
+  constexpr int N = 16;
+  constexpr int NDIM = 3;
+  constexpr int NBLOCKS = 64;
+  constexpr int NVARS = 8;
+
+  auto pkg = std::make_shared<StateDescriptor>("Test package");
+  std::vector<std::string> names;
+  for (int n = 0; n < NVARS; ++n) {
+    names.push_back("v" + std::to_string(n));
+    pkg->AddField(names.back(), Metadata({Metadata::Independent, Metadata::WithFluxes},
+                                         std::vector<int>{N, N, N}));
+  }
+  BlockList_t block_list;
+  for (int b = 0; b < NBLOCKS; ++b) {
+    auto pmb = std::make_shared<MeshBlock>(N, NDIM);
+    pmb->meshblock_data.Get()->Initialize(pkg, pmb);
+    block_list.push_back(pmb);
+  }
+  MeshData<Real> mesh_data("base");
+  mesh_data.Set(block_list, nullptr);
+
+  auto desc = parthenon::MakePackDescriptor(pkg.get(), names, {Metadata::WithFluxes});
+
+  // A pack that has to be built from scratch, including the upload of its views
+  BENCHMARK_ADVANCED("SparsePack: build")(Catch::Benchmark::Chronometer meter) {
+    meter.measure([&]() {
+      mesh_data.GetSparsePackCache().clear();
+      auto pack = desc.GetPack(&mesh_data);
+      Kokkos::fence();
+      return pack.GetNBlocks();
+    });
+  };
+
+  // The common case in a task list, the pack is taken from the cache of the MeshData
+  BENCHMARK_ADVANCED("SparsePack: cache hit")(Catch::Benchmark::Chronometer meter) {
+    desc.GetPack(&mesh_data);
+    Kokkos::fence();
+    meter.measure([&]() { return desc.GetPack(&mesh_data).GetNBlocks(); });
+  };
+
+  // Packs of a single block go through the cache of the MeshBlockData
+  auto *mbd = block_list[0]->meshblock_data.Get().get();
+  BENCHMARK_ADVANCED("SparsePack: block cache hit")
+  (Catch::Benchmark::Chronometer meter) {
+    desc.GetPack(mbd);
+    Kokkos::fence();
+    meter.measure([&]() { return desc.GetPack(mbd).GetNBlocks(); });
+  };
+}
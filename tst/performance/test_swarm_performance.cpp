@@ -0,0 +1,104 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <memory>
+#include <sstream>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "coordinates/coordinates.hpp"
+#include "interface/swarm.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/mesh.hpp"
+#include "mesh/meshblock.hpp"
+
+#include <parthenon/driver.hpp>
+#include <parthenon/package.hpp>
+
+using parthenon::ApplicationInput;
+using parthenon::Mesh;
+using parthenon::MeshBlock;
+using parthenon::Metadata;
+using parthenon::Packages_t;
+using parthenon::ParameterInput;
+using parthenon::Real;
+using parthenon::Swarm;
+
+namespace {
+constexpr int N = 16;
+constexpr int NPARTICLES = 1 << 18;
+
+// Fill the particles just added to the swarm with positions scattered over the block
+void PlaceNewParticles(Swarm &swarm, const parthenon::NewParticlesContext &newp,
+                       const int seed) {
+  auto &x = swarm.Get<Real>("x").Get();
+  auto &y = swarm.Get<Real>("y").Get();
+  auto &z = swarm.Get<Real>("z").Get();
+  swarm.GetBlockPointer()->par_for(
+      "PlaceNewParticles", 0, newp.GetNewParticlesMaxIndex(), KOKKOS_LAMBDA(const int n) {
+        const int m = newp.GetNewParticleIndex(n);
+        // cheap integer hash, good enough to scatter the particles over the cells
+        unsigned int h = (m + seed) * 2654435761u;
+        x(m) = ((h & 1023u) + 0.5) / 1024.0 - 0.5;
+        y(m) = (((h >> 10) & 1023u) + 0.5) / 1024.0 - 0.5;
+        z(m) = (((h >> 20) & 1023u) + 0.5) / 1024.0 - 0.5;
+      });
+}
+} // namespace
+
+TEST_CASE("Swarm defragmentation and sorting", "[Swarm][performance]") {
+  std::stringstream is;
+  is << "<parthenon/mesh>\n";
+  is << "x1min = -0.5\nx2min = -0.5\nx3min = -0.5\n";
+  is << "x1max = 0.5\nx2max = 0.5\nx3max = 0.5\n";
+  is << "nx1 = " << N << "\nnx2 = " << N << "\nnx3 = " << N << "\n";
+  auto pin = std::make_shared<ParameterInput>();
+  pin->LoadFromStream(is);
+  auto app_in = std::make_shared<ApplicationInput>();
+  Packages_t packages;
+  auto mesh = std::make_shared<Mesh>(pin.get(), app_in.get(), packages, 1);
+  auto meshblock = std::make_shared<MeshBlock>(N, 3);
+  meshblock->pmy_mesh = mesh.get();
+  meshblock->coords = parthenon::Coordinates_t(
+      parthenon::RegionSize({-0.5, -0.5, -0.5}, {0.5, 0.5, 0.5}, {1.0, 1.0, 1.0},
+                            {N, N, N}),
+      nullptr);
+
+  auto swarm = std::make_shared<Swarm>("bench swarm", Metadata(), NPARTICLES);
+  swarm->SetBlockPointer(meshblock);
+  PlaceNewParticles(*swarm, swarm->AddEmptyParticles(NPARTICLES), 0);
+  Kokkos::fence();
+
+  // Steady state of a swarm that loses half of its particles per cycle, e.g., to
+  // neighbors, and gets as many new ones
+  int cycle = 0;
+  BENCHMARK("Swarm: remove half, Defrag, refill") {
+    auto swarm_d = swarm->GetDeviceContext();
+    meshblock->par_for(
+        "MarkHalf", 0, swarm->GetMaxActiveIndex(), KOKKOS_LAMBDA(const int n) {
+          if (swarm_d.IsActive(n) && n % 2 == 1) swarm_d.MarkParticleForRemoval(n);
+        });
+    swarm->RemoveMarkedParticles();
+    swarm->Defrag();
+    const int nremoved = NPARTICLES - swarm->GetNumActive();
+    PlaceNewParticles(*swarm, swarm->AddEmptyParticles(nremoved), ++cycle);
+    Kokkos::fence();
+    return swarm->GetNumActive();
+  };
+
+  BENCHMARK("Swarm: SortParticlesByCell") {
+    swarm->SortParticlesByCell();
+    Kokkos::fence();
+    return swarm->GetNumActive();
+  };
+}
@@ -0,0 +1,67 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+#include <functional>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "tasks/tasks.hpp"
+#include "tasks/thread_pool.hpp"
+
+using parthenon::TaskCollection;
+using parthenon::TaskID;
+using parthenon::TaskStatus;
+using parthenon::ThreadPool;
+
+namespace {
+TaskStatus Increment(int &count) {
+  ++count;
+  return TaskStatus::complete;
+}
+} // namespace
+
+// The overhead of the task graph itself, every task does (next to) nothing
+TEST_CASE("Task graph execution overhead", "[TaskCollection][performance]") {
+  constexpr int NLISTS = 16;
+  constexpr int NTASKS = 64;
+
+  std::vector<int> counts(NLISTS, 0);
+  TaskCollection chains;
+  {
+    auto &region = chains.AddRegion(NLISTS);
+    for (int l = 0; l < NLISTS; ++l) {
+      TaskID dep;
+      for (int t = 0; t < NTASKS; ++t) {
+        dep = region[l].AddTask(dep, Increment, std::ref(counts[l]));
+      }
+    }
+  }
+  TaskCollection fans;
+  {
+    auto &region = fans.AddRegion(NLISTS);
+    for (int l = 0; l < NLISTS; ++l) {
+      TaskID none;
+      TaskID all;
+      for (int t = 0; t < NTASKS; ++t) {
+        all = all | region[l].AddTask(none, Increment, std::ref(counts[l]));
+      }
+      region[l].AddTask(all, Increment, std::ref(counts[l]));
+    }
+  }
+
+  BENCHMARK("Tasks: dependent chains") { return chains.Execute(); };
+  BENCHMARK("Tasks: independent tasks joined by one") { return fans.Execute(); };
+
+  ThreadPool pool(4);
+  BENCHMARK("Tasks: dependent chains, 4 threads") { return chains.Execute(pool); };
+}
@@ -0,0 +1,75 @@
+# ========================================================================================
+# Parthenon performance portable AMR framework
+# Copyright(C) 2021 The Parthenon collaboration
+# Licensed under the 3-clause BSD License, see LICENSE file for details
+# ========================================================================================
+# (C) (or copyright) 2021. Triad National Security, LLC. All rights reserved.
+#
+# This program was produced under U.S. Government contract 89233218CNA000001 for Los
+# Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+# for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+# in the program are reserved by Triad National Security, LLC, and the U.S. Department
+# of Energy/National Nuclear Security Administration. The Government is granted for
+# itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+# license in this material to reproduce, prepare derivative works, distribute copies to
+# the public, perform publicly and display publicly, and to permit others to do so.
+# ========================================================================================
+
+# Modules
+import sys
+import utils.test_case
+
+""" To prevent littering up imported folders with .pyc files or __pycache_ folder"""
+sys.dont_write_bytecode = True
+
+# The communication options with a path of their own, each run in a step of its own
+# after a first step with the default settings, see parthenon/comms in inputs.rst
+comm_options = [
+    ("default", []),
+    ("neighborhood", ["parthenon/comms/neighborhood_comm=true"]),
+    ("shared_memory", ["parthenon/comms/shared_memory_comm=true"]),
+    ("rma", ["parthenon/comms/rma_comm=true"]),
+    ("host_staging", ["parthenon/comms/host_staging=true"]),
+    ("fields_per_comm", ["parthenon/comms/fields_per_comm=2"]),
+]
+
+
+class TestCase(utils.test_case.TestCaseAbs):
+    def Prepare(self, parameters, step):
+        name, args = comm_options[step - 1]
+        parameters.driver_cmd_line_args = args + ["parthenon/output0/id=" + name]
+        if parameters.sparse_disabled:
+            parameters.driver_cmd_line_args.append(
+                "parthenon/sparse/enable_sparse=false"
+            )
+        parameters.coverage_status = "both"
+        return parameters
+
+    def Analyse(self, parameters):
+
+        sys.path.insert(
+            1,
+            parameters.parthenon_path
+            + "/scripts/python/packages/parthenon_tools/parthenon_tools",
+        )
+
+        try:
+            from phdf_diff import compare
+        except ModuleNotFoundError:
+            print("Couldn't find module to compare Parthenon hdf5 files.")
+            return False
+
+        all_pass = True
+        # the ghost zones (and everything else) have to match the default bit for bit
+        for name, _ in comm_options[1:]:
+            res = compare(
+                ["sparse.default.final.phdf", "sparse." + name + ".final.phdf"],
+                one=True,
+                tol=0.0,
+                check_metadata=False,
+            )
+            if res != 0:
+                print("Communication with " + name + " differs from the default.")
+                all_pass = False
+
+        return all_pass
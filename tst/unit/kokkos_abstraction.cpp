@@ -210,11 +210,17 @@ TEST_CASE("par_for loops", "[wrapper]") {
   SECTION("1D loops") {
     REQUIRE(test_wrapper_1d(parthenon::loop_pattern_flatrange_tag, default_exec_space) ==
             true);
+
+    REQUIRE(test_wrapper_1d(parthenon::loop_pattern_autotune_tag, default_exec_space) ==
+            true);
   }
 
   SECTION("2D loops") {
     REQUIRE(test_wrapper_2d(parthenon::loop_pattern_mdrange_tag, default_exec_space) ==
             true);
+
+    REQUIRE(test_wrapper_2d(parthenon::loop_pattern_autotune_tag, default_exec_space) ==
+            true);
   }
 
   SECTION("3D loops") {
@@ -238,6 +244,11 @@ TEST_CASE("par_for loops", "[wrapper]") {
       REQUIRE(test_wrapper_3d(parthenon::loop_pattern_simdfor_tag, default_exec_space) ==
               true);
     }
+
+    // enough calls to time every pattern and then use the fastest
+    for (int n = 0; n < 32; ++n)
+      REQUIRE(test_wrapper_3d(parthenon::loop_pattern_autotune_tag, default_exec_space) ==
+              true);
   }
 
   SECTION("4D loops") {
@@ -261,7 +272,88 @@ TEST_CASE("par_for loops", "[wrapper]") {
       REQUIRE(test_wrapper_4d(parthenon::loop_pattern_simdfor_tag, default_exec_space) ==
               true);
     }
+
+    // enough calls to time every pattern and then use the fastest
+    for (int n = 0; n < 32; ++n)
+      REQUIRE(test_wrapper_4d(parthenon::loop_pattern_autotune_tag, default_exec_space) ==
+              true);
+  }
+}
+
+TEST_CASE("par_for loops with launch parameters", "[wrapper]") {
+  auto default_exec_space = DevExecSpace();
+
+  SECTION("Launch bounds") {
+    REQUIRE(test_wrapper_3d(parthenon::LoopPatternMDRangeBounded<128, 1>(),
+                            default_exec_space) == true);
+    REQUIRE(test_wrapper_3d(parthenon::LoopPatternTPTTRBounded<128, 1>(),
+                            default_exec_space) == true);
+    REQUIRE(test_wrapper_4d(parthenon::LoopPatternMDRangeBounded<128, 1>(),
+                            default_exec_space) == true);
+    REQUIRE(test_wrapper_4d(parthenon::LoopPatternTPTTRTVRBounded<128, 1>(),
+                            default_exec_space) == true);
+  }
+
+  SECTION("Tile sizes and vector lengths by label") {
+    parthenon::LaunchConfig config;
+    config.tile = {2, 4};
+    config.vector_length = 1;
+    parthenon::LaunchConfigs::Set("unit test 3D", config);
+    parthenon::LaunchConfigs::Set("unit test 4D", config);
+    REQUIRE(parthenon::LaunchConfigs::Find("unit test 3D")->Tile(3, 0, 7) == 7);
+    REQUIRE(parthenon::LaunchConfigs::Find("unit test 3D")->Tile(3, 2, 7) == 4);
+    REQUIRE(test_wrapper_3d(parthenon::loop_pattern_mdrange_tag, default_exec_space) ==
+            true);
+    REQUIRE(test_wrapper_3d(parthenon::loop_pattern_tpttrtvr_tag, default_exec_space) ==
+            true);
+    REQUIRE(test_wrapper_4d(parthenon::loop_pattern_mdrange_tag, default_exec_space) ==
+            true);
+    REQUIRE(test_wrapper_4d(parthenon::loop_pattern_tpttr_tag, default_exec_space) ==
+            true);
+    parthenon::LaunchConfigs::Clear();
+    REQUIRE(parthenon::LaunchConfigs::Find("unit test 3D") == nullptr);
+  }
+}
+
+TEST_CASE("LoopAutotuner", "[wrapper]") {
+  using parthenon::LoopPatternChoice;
+  auto &tuner = parthenon::LoopAutotuner::Get();
+  tuner.Configure(true, 2, "");
+  const LoopPatternChoice candidates[] = {LoopPatternChoice::mdrange,
+                                          LoopPatternChoice::flatrange};
+
+  SECTION("Every candidate is warmed up and then timed") {
+    for (int c = 0; c < 2; ++c) {
+      auto trial = tuner.Next("kernel", candidates, 2);
+      REQUIRE(trial.pattern == candidates[c]);
+      REQUIRE(!trial.timed);
+    }
+    for (int n = 0; n < 2; ++n) {
+      for (int c = 0; c < 2; ++c) {
+        auto trial = tuner.Next("kernel", candidates, 2);
+        REQUIRE(trial.pattern == candidates[c]);
+        REQUIRE(trial.timed);
+        tuner.Record("kernel", trial.pattern, c == 1 ? 1.0 : 2.0);
+      }
+    }
+    THEN("The fastest candidate is used from then on") {
+      for (int n = 0; n < 3; ++n) {
+        auto trial = tuner.Next("kernel", candidates, 2);
+        REQUIRE(trial.pattern == LoopPatternChoice::flatrange);
+        REQUIRE(!trial.timed);
+      }
+    }
+  }
+
+  SECTION("A disabled tuner always uses the first candidate") {
+    tuner.Configure(false, 2, "");
+    for (int n = 0; n < 8; ++n) {
+      auto trial = tuner.Next("kernel", candidates, 2);
+      REQUIRE(trial.pattern == LoopPatternChoice::mdrange);
+      REQUIRE(!trial.timed);
+    }
   }
+  tuner.Configure(true, 3, "");
 }
 
 template <class OuterLoopPattern, class InnerLoopPattern>
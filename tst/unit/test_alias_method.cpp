@@ -0,0 +1,69 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <limits>
+#include <vector>
+
+#include <Kokkos_Random.hpp>
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/alias_method.hpp"
+
+using parthenon::Real;
+using parthenon::AliasMethod::AliasMethod;
+
+TEST_CASE("AliasMethod samples on device", "[AliasMethod]") {
+  GIVEN("An alias table for the weights 1 and 3") {
+    AliasMethod alias(std::vector<Real>{1.0, 3.0});
+    Kokkos::Random_XorShift64_Pool<> rng_pool(4321);
+    const int n = 100000;
+
+    WHEN("Samples are drawn in a batch") {
+      auto samples = alias.Sample(n, rng_pool);
+      THEN("They are valid indices with the given frequencies") {
+        int nbad = 0;
+        Kokkos::parallel_reduce(
+            "count invalid samples", n,
+            KOKKOS_LAMBDA(const int i, int &lbad) {
+              lbad += (samples(i) < 0 || samples(i) > 1);
+            },
+            nbad);
+        int nones = 0;
+        Kokkos::parallel_reduce(
+            "count samples", n,
+            KOKKOS_LAMBDA(const int i, int &lones) { lones += (samples(i) == 1); },
+            nones);
+        REQUIRE(nbad == 0);
+        REQUIRE(static_cast<Real>(nones) / n == Approx(0.75).margin(0.01));
+      }
+    }
+
+    WHEN("Random numbers at the ends of [0,1) are used") {
+      // the largest Real below 1
+      const Real almost_one = 1.0 - 0.5 * std::numeric_limits<Real>::epsilon();
+      int nbad = 0;
+      Kokkos::parallel_reduce(
+          "edge samples", 4,
+          KOKKOS_LAMBDA(const int m, int &lbad) {
+            const Real r1 = (m % 2 == 0) ? 0.0 : almost_one;
+            const Real r2 = (m / 2 == 0) ? 0.0 : almost_one;
+            const int idx = alias.Sample(r1, r2);
+            lbad += (idx < 0 || idx > 1);
+          },
+          nbad);
+      THEN("The samples are valid indices") { REQUIRE(nbad == 0); }
+    }
+  }
+}
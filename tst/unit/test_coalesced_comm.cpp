@@ -0,0 +1,49 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "bvals/comms/coalesced_comm.hpp"
+
+using parthenon::BoundaryType;
+using parthenon::ExchangeCoversGroupMembers;
+
+TEST_CASE("Exchanges over coalesced messages must cover all members",
+          "[CoalescedBoundaryMessage]") {
+  GIVEN("MeshData whose blocks have all the variables of base") {
+    const int nbase_vars = 5;
+    THEN("The ghost zone and flux correction exchanges send every member") {
+      for (auto bt : {BoundaryType::any, BoundaryType::nonlocal,
+                      BoundaryType::flxcor_send, BoundaryType::flxcor_recv}) {
+        REQUIRE(ExchangeCoversGroupMembers(bt, nbase_vars, nbase_vars));
+      }
+    }
+    THEN("Other boundary types don't") {
+      for (auto bt : {BoundaryType::gmg_same, BoundaryType::gmg_restrict_send,
+                      BoundaryType::gmg_prolongate_send}) {
+        REQUIRE_FALSE(ExchangeCoversGroupMembers(bt, nbase_vars, nbase_vars));
+      }
+    }
+  }
+  GIVEN("MeshData whose blocks only have a subset of the variables of base") {
+    const int nbase_vars = 5;
+    const int nvars = 2;
+    THEN("No exchange sends every member") {
+      for (auto bt : {BoundaryType::any, BoundaryType::nonlocal,
+                      BoundaryType::flxcor_send, BoundaryType::flxcor_recv}) {
+        REQUIRE_FALSE(ExchangeCoversGroupMembers(bt, nvars, nbase_vars));
+      }
+    }
+  }
+}
@@ -0,0 +1,90 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cmath>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "coordinates/tabulated_cartesian.hpp"
+#include "coordinates/uniform_cartesian.hpp"
+#include "defs.hpp"
+#include "globals.hpp"
+#include "kokkos_abstraction.hpp"
+
+using parthenon::IndexRange;
+using parthenon::Real;
+using parthenon::RegionSize;
+using parthenon::TabulatedCartesian;
+using parthenon::UniformCartesian;
+using parthenon::X1DIR;
+using parthenon::X2DIR;
+using parthenon::X3DIR;
+
+TEST_CASE("TabulatedCartesian coordinates", "[coordinates]") {
+  constexpr int nghost = 2;
+  parthenon::Globals::nghost = nghost;
+  constexpr int N = 8;
+  GIVEN("A region without stretching") {
+    RegionSize rs({-1.0, 0.0, 0.0}, {1.0, 2.0, 0.5}, {1.0, 1.0, 1.0}, {N, N, N});
+    UniformCartesian uniform(rs, nullptr);
+    TabulatedCartesian tabulated(rs, nullptr);
+    THEN("The tables match the uniform coordinates, including ghost zones") {
+      for (int n = 0; n < N + 2 * nghost; ++n) {
+        REQUIRE(tabulated.Xf<X1DIR>(n) == Approx(uniform.Xf<X1DIR>(n)));
+        REQUIRE(tabulated.Xc<X2DIR>(n) == Approx(uniform.Xc<X2DIR>(n)));
+        REQUIRE(tabulated.Dxc<X3DIR>(n) == Approx(uniform.Dxc<X3DIR>()));
+        REQUIRE(tabulated.FaceArea<X2DIR>(n, n, n) == Approx(uniform.FaceArea<X2DIR>()));
+        REQUIRE(tabulated.CellVolume(n, n, n) == Approx(uniform.CellVolume()));
+      }
+      REQUIRE(tabulated.Xf<X1DIR>(N + 2 * nghost) ==
+              Approx(uniform.Xf<X1DIR>(N + 2 * nghost)));
+    }
+  }
+
+  GIVEN("A region stretched in x1") {
+    constexpr Real ratio = 1.1;
+    RegionSize rs({0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}, {ratio, 1.0, 1.0}, {N, N, N});
+    TabulatedCartesian coords(rs, nullptr);
+    const IndexRange ib{nghost, nghost + N - 1};
+    THEN("Neighboring cells differ in width by the ratio and cover the region") {
+      REQUIRE(coords.Xf<X1DIR>(ib.s) == Approx(0.0).margin(1.0e-14));
+      REQUIRE(coords.Xf<X1DIR>(ib.e + 1) == Approx(1.0));
+      for (int i = ib.s + 1; i <= ib.e; ++i) {
+        REQUIRE(coords.CellWidth<X1DIR>(0, 0, i) ==
+                Approx(ratio * coords.CellWidth<X1DIR>(0, 0, i - 1)));
+        REQUIRE(coords.Dxc<X1DIR>(i) ==
+                Approx(coords.Xc<X1DIR>(i) - coords.Xc<X1DIR>(i - 1)));
+      }
+    }
+    THEN("The faces of the coarse coordinates are every other fine face") {
+      TabulatedCartesian coarse(coords, 2);
+      for (int i = 0; i <= N / 2; ++i) {
+        REQUIRE(coarse.Xf<X1DIR>(nghost + i) ==
+                Approx(coords.Xf<X1DIR>(nghost + 2 * i)).margin(1.0e-14));
+      }
+    }
+    THEN("The tables can be read in kernels") {
+      Real volume = 0.0;
+      parthenon::par_reduce(
+          parthenon::loop_pattern_mdrange_tag, "sum volume", parthenon::DevExecSpace(),
+          ib.s, ib.e, ib.s, ib.e, ib.s, ib.e,
+          KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lvol) {
+            lvol += coords.CellVolume(k, j, i);
+          },
+          volume);
+      REQUIRE(volume == Approx(1.0));
+    }
+  }
+  parthenon::Globals::nghost = 0;
+}
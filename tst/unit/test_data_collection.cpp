@@ -118,3 +118,92 @@ TEST_CASE("Adding MeshBlockData objects to a DataCollection", "[DataCollection]"
     }
   }
 }
+
+TEST_CASE("Adding copy-on-write MeshBlockData objects to a DataCollection",
+          "[DataCollection]") {
+  GIVEN("An DataCollection with a base MeshBlockData with some variables") {
+    DataCollection<MeshBlockData<Real>> d;
+    auto pmb = std::make_shared<MeshBlock>();
+
+    std::vector<int> size(6, 1);
+    Metadata m_ind({Metadata::Independent}, size);
+    Metadata m_one({Metadata::OneCopy}, size);
+
+    auto pgk = std::make_shared<StateDescriptor>("DataCollection test");
+    pgk->AddField("var1", m_ind);
+    pgk->AddField("var2", m_one);
+    pgk->AddField("var3", m_ind);
+
+    auto &mbd = d.Get();
+    mbd->Initialize(pgk, pmb);
+
+    auto &v1 = mbd->Get("var1").data;
+    auto &v3 = mbd->Get("var3").data;
+    par_for(
+        loop_pattern_flatrange_tag, "init vars", DevExecSpace(), 0, 0,
+        KOKKOS_LAMBDA(const int i) {
+          v1(0) = 111;
+          v3(0) = 333;
+        });
+    WHEN("We add a copy-on-write MeshBlockData to the container") {
+      auto x = d.AddCopyOnWrite("cow", mbd);
+      THEN("Its variables share the storage of base") {
+        REQUIRE(x->Get("var1").data.data() == v1.data());
+        REQUIRE(x->Get("var3").data.data() == v3.data());
+        REQUIRE(x->Get("var1").SharesData());
+        REQUIRE(mbd->Get("var1").SharesData());
+        REQUIRE(!x->Get("var2").SharesData());
+      }
+      AND_WHEN("One of them is made writable and written to") {
+        x->MakeWritable(std::vector<std::string>{"var1"});
+        auto &xv1 = x->Get("var1").data;
+        const Real copied = xv1.GetHostMirrorAndCopy()(0);
+        par_for(
+            loop_pattern_flatrange_tag, "set var", DevExecSpace(), 0, 0,
+            KOKKOS_LAMBDA(const int i) { xv1(0) = 11; });
+        auto hv1 = v1.GetHostMirrorAndCopy();
+        auto hxv1 = xv1.GetHostMirrorAndCopy();
+        THEN("It has its own storage, which started out as a copy") {
+          REQUIRE(xv1.data() != v1.data());
+          REQUIRE(!x->Get("var1").SharesData());
+          REQUIRE(!mbd->Get("var1").SharesData());
+          REQUIRE(copied == 111);
+          REQUIRE(hxv1(0) == 11);
+          REQUIRE(hv1(0) == 111);
+        }
+        AND_THEN("The other variables still share storage") {
+          REQUIRE(x->Get("var3").data.data() == v3.data());
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Stage MeshBlockData objects share the fluxes of base", "[DataCollection]") {
+  GIVEN("An DataCollection with a base MeshBlockData with a variable with fluxes") {
+    DataCollection<MeshBlockData<Real>> d;
+    auto pmb = std::make_shared<MeshBlock>();
+
+    std::vector<int> size(6, 1);
+    Metadata m_flx({Metadata::Independent, Metadata::WithFluxes}, size);
+
+    auto pgk = std::make_shared<StateDescriptor>("DataCollection test");
+    pgk->AddField("var1", m_flx);
+
+    auto &mbd = d.Get();
+    mbd->Initialize(pgk, pmb);
+    const Real *flux_data = mbd->Get("var1").FluxData().data();
+    REQUIRE(flux_data != nullptr);
+
+    WHEN("We add stages to the container") {
+      auto x = d.Add("stage1", mbd);
+      auto y = d.AddCopyOnWrite("stage2", x);
+      THEN("They have their own data but use the fluxes of base") {
+        REQUIRE(x->Get("var1").data.data() != mbd->Get("var1").data.data());
+        REQUIRE(x->Get("var1").FluxData().data() == flux_data);
+        REQUIRE(y->Get("var1").FluxData().data() == flux_data);
+        REQUIRE(x->Get("var1").flux[1].data() == mbd->Get("var1").flux[1].data());
+      }
+    }
+  }
+}
@@ -12,6 +12,7 @@
 //========================================================================================
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <catch2/catch.hpp>
@@ -277,5 +278,57 @@ TEST_CASE("IndexSplit", "[IndexSplit]") {
         REQUIRE(total_work == N * N * N);
       }
     }
+
+    WHEN("We split the interior into a core and a shell") {
+      constexpr int WIDTH = 2;
+      // no structured bindings, since they can't be captured by the lambdas below
+      parthenon::IndexRange kb, jb, ib;
+      std::tie(kb, jb, ib) = IndexSplit::GetCoreBounds(&mesh_data, WIDTH);
+      const auto shell = IndexSplit::GetShell(&mesh_data, WIDTH);
+      THEN("The core is the interior without the shell") {
+        const auto kbi = mesh_data.GetBoundsK(IndexDomain::interior);
+        REQUIRE(kb.s == kbi.s + WIDTH);
+        REQUIRE(kb.e == kbi.e - WIDTH);
+        REQUIRE(shell.nboxes == 6);
+        REQUIRE(shell.size() == N * N * N - (N - 2 * WIDTH) * (N - 2 * WIDTH) *
+                                                  (N - 2 * WIDTH));
+      }
+      THEN("Core and shell cover each interior cell exactly once") {
+        const auto kbe = mesh_data.GetBoundsK(IndexDomain::entire);
+        const auto jbe = mesh_data.GetBoundsJ(IndexDomain::entire);
+        const auto ibe = mesh_data.GetBoundsI(IndexDomain::entire);
+        using atomic_view = Kokkos::MemoryTraits<Kokkos::Atomic>;
+        Kokkos::View<int ****, atomic_view> count("count", NBLOCKS, kbe.e + 1, jbe.e + 1,
+                                                  ibe.e + 1);
+        par_for(
+            parthenon::loop_pattern_mdrange_tag, "Test core", DevExecSpace(), 0,
+            NBLOCKS - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+              count(b, k, j, i) += 1;
+            });
+        par_for(
+            parthenon::loop_pattern_mdrange_tag, "Test shell", DevExecSpace(), 0,
+            NBLOCKS - 1, 0, shell.size() - 1,
+            KOKKOS_LAMBDA(const int b, const int idx) {
+              int k, j, i;
+              shell.GetIndices(idx, k, j, i);
+              count(b, k, j, i) += 1;
+            });
+        const auto kbi = mesh_data.GetBoundsK(IndexDomain::interior);
+        const auto jbi = mesh_data.GetBoundsJ(IndexDomain::interior);
+        const auto ibi = mesh_data.GetBoundsI(IndexDomain::interior);
+        int nwrong = 0;
+        parthenon::par_reduce(
+            parthenon::loop_pattern_mdrange_tag, "Check core and shell", DevExecSpace(),
+            0, NBLOCKS - 1, kbe.s, kbe.e, jbe.s, jbe.e, ibe.s, ibe.e,
+            KOKKOS_LAMBDA(const int b, const int k, const int j, const int i, int &n) {
+              const bool interior = kbi.s <= k && k <= kbi.e && jbi.s <= j &&
+                                    j <= jbi.e && ibi.s <= i && i <= ibi.e;
+              if (count(b, k, j, i) != (interior ? 1 : 0)) n += 1;
+            },
+            Kokkos::Sum<int>(nwrong));
+        REQUIRE(nwrong == 0);
+      }
+    }
   }
 }
@@ -0,0 +1,84 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "defs.hpp"
+#include "kokkos_abstraction.hpp"
+#include "outputs/inline_diagnostics.hpp"
+
+using parthenon::DevExecSpace;
+using parthenon::InlineDiagnostics;
+using parthenon::Real;
+using parthenon::UserHistoryOperation;
+
+TEST_CASE("InlineDiagnostics accumulate inside a kernel", "[InlineDiagnostics]") {
+  GIVEN("Diagnostics with a sum, extrema and a histogram") {
+    InlineDiagnostics diag;
+    const auto sum = diag.AddSum("sum");
+    const auto vmax = diag.AddMax("max");
+    const auto vmin = diag.AddMin("min");
+    const auto hist = diag.AddHistogram("hist", 4, 0.0, 4.0);
+    const int n = 100;
+
+    WHEN("A kernel accumulates the values 0, 0.1, ..., 9.9") {
+      auto acc = diag.GetAccumulator();
+      parthenon::par_for(
+          parthenon::loop_pattern_flatrange_tag, "accumulate", DevExecSpace(), 0, n - 1,
+          KOKKOS_LAMBDA(const int i) {
+            const Real x = 0.1 * i;
+            acc.Sum(sum, x);
+            acc.Max(vmax, x);
+            acc.Min(vmin, x);
+            acc.Bin(hist, x);
+          });
+      std::vector<std::string> labels;
+      std::vector<UserHistoryOperation> ops;
+      std::vector<Real> values;
+      diag.GetResults(labels, ops, values);
+
+      THEN("The results hold all quantities in order") {
+        REQUIRE(labels == std::vector<std::string>{"sum", "hist_0", "hist_1", "hist_2",
+                                                   "hist_3", "max", "min"});
+        REQUIRE(ops[0] == UserHistoryOperation::sum);
+        REQUIRE(ops[4] == UserHistoryOperation::sum);
+        REQUIRE(ops[5] == UserHistoryOperation::max);
+        REQUIRE(ops[6] == UserHistoryOperation::min);
+        REQUIRE(values[0] == Approx(495.0));
+        for (int bin = 0; bin < 4; ++bin) {
+          REQUIRE(values[1 + bin] == 10.0);
+        }
+        REQUIRE(values[5] == Approx(9.9));
+        REQUIRE(values[6] == 0.0);
+      }
+      THEN("Reset sets the quantities to the identities of their reductions") {
+        diag.Reset();
+        labels.clear();
+        ops.clear();
+        values.clear();
+        diag.GetResults(labels, ops, values);
+        REQUIRE(values[0] == 0.0);
+        REQUIRE(values[5] == std::numeric_limits<Real>::lowest());
+        REQUIRE(values[6] == std::numeric_limits<Real>::max());
+      }
+      THEN("No quantities can be added anymore") {
+        REQUIRE_THROWS(diag.AddSum("late"));
+      }
+    }
+  }
+}
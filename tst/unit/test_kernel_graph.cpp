@@ -0,0 +1,67 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/kernel_graph.hpp"
+
+using parthenon::DevExecSpace;
+using parthenon::ParArray1D;
+using parthenon::Real;
+
+TEST_CASE("KernelGraph replays the kernels of a function", "[KernelGraph]") {
+  GIVEN("A function launching two kernels") {
+    const int n = 64;
+    ParArray1D<Real> a("a", n), b("b", n);
+    auto increment = [=]() {
+      parthenon::par_for(
+          parthenon::loop_pattern_flatrange_tag, "increment a", DevExecSpace(), 0, n - 1,
+          KOKKOS_LAMBDA(const int i) { a(i) += 1.0; });
+      parthenon::par_for(
+          parthenon::loop_pattern_flatrange_tag, "copy a to b", DevExecSpace(), 0, n - 1,
+          KOKKOS_LAMBDA(const int i) { b(i) = a(i); });
+    };
+    auto sum_b = [=]() {
+      Real sum = 0.0;
+      Kokkos::parallel_reduce(
+          "sum", n, KOKKOS_LAMBDA(const int i, Real &lsum) { lsum += b(i); }, sum);
+      return sum;
+    };
+    parthenon::KernelGraph graph;
+
+    WHEN("It is launched repeatedly with the same key") {
+      for (int c = 0; c < 5; ++c)
+        graph.Launch(DevExecSpace(), 0, increment);
+      THEN("Every launch runs both kernels") { REQUIRE(sum_b() == 5.0 * n); }
+    }
+
+    WHEN("The key changes in between") {
+      for (int c = 0; c < 3; ++c)
+        graph.Launch(DevExecSpace(), 0, increment);
+      for (int c = 0; c < 3; ++c)
+        graph.Launch(DevExecSpace(), 1, increment);
+      THEN("Every launch runs both kernels") { REQUIRE(sum_b() == 6.0 * n); }
+    }
+
+    WHEN("It is reset in between") {
+      graph.Launch(DevExecSpace(), 0, increment);
+      graph.Launch(DevExecSpace(), 0, increment);
+      graph.Reset();
+      REQUIRE(!graph.Recorded());
+      graph.Launch(DevExecSpace(), 0, increment);
+      THEN("Every launch runs both kernels") { REQUIRE(sum_b() == 3.0 * n); }
+    }
+  }
+}
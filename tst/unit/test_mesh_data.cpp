@@ -82,6 +82,28 @@ TEST_CASE("MeshData works as expected for simple packs", "[MeshData]") {
 
     THEN("The number of blocks is correct") { REQUIRE(mesh_data.NumBlocks() == NBLOCKS); }
 
+    THEN("Kernels can be launched on the execution space instance of the MeshData") {
+      auto exec_space = parthenon::SpaceInstance<DevExecSpace>::create();
+      mesh_data.SetExecSpace(exec_space);
+      auto pack = mesh_data.PackVariables(std::vector<std::string>{"v1"});
+      par_for(
+          loop_pattern_mdrange_tag, "set v1", mesh_data.GetExecSpace(), 0,
+          pack.GetDim(5) - 1, 0, N - 1, 0, N - 1, 0, N - 1,
+          KOKKOS_LAMBDA(int b, int k, int j, int i) { pack(b, 0, k, j, i) = b; });
+      mesh_data.GetExecSpace().fence();
+      int nwrong = 0;
+      par_reduce(
+          loop_pattern_mdrange_tag, "check v1", DevExecSpace(), 0, pack.GetDim(5) - 1, 0,
+          N - 1, 0, N - 1, 0, N - 1,
+          KOKKOS_LAMBDA(int b, int k, int j, int i, int &ltot) {
+            if (pack(b, 0, k, j, i) != b) ltot += 1;
+          },
+          nwrong);
+      REQUIRE(nwrong == 0);
+      mesh_data.SetExecSpace(DevExecSpace());
+      parthenon::SpaceInstance<DevExecSpace>::destroy(exec_space);
+    }
+
     WHEN("We initialize the independent variables by hand") {
       auto ib = block_list[0]->cellbounds.GetBoundsI(IndexDomain::entire);
       auto jb = block_list[0]->cellbounds.GetBoundsJ(IndexDomain::entire);
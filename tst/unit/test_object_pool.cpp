@@ -0,0 +1,59 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <atomic>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "tasks/thread_pool.hpp"
+#include "utils/object_pool.hpp"
+
+using parthenon::ThreadPool;
+using pool_t = parthenon::ObjectPool<std::vector<int>>;
+
+TEST_CASE("ObjectPool can be used from several threads", "[ObjectPool]") {
+  GIVEN("A pool of small vectors that allocates them one at a time") {
+    const int n = 4;
+    pool_t pool([n](pool_t *) { return std::vector<int>(n, -1); });
+
+    WHEN("Many tasks take objects from it, share them, and give them back") {
+      ThreadPool threads(4);
+      const int ntasks = 1000;
+      std::atomic<int> nshared{0};
+      for (int t = 0; t < ntasks; t++) {
+        threads.enqueue([&pool, &nshared, t]() {
+          pool_t::owner_t obj(pool.Get());
+          obj[0] = t;
+          {
+            pool_t::owner_t copy(obj);
+            copy[1] = t;
+          }
+          // nobody else got the object in the meantime
+          if (obj[0] != t || obj[1] != t) nshared++;
+        });
+      }
+      threads.wait();
+      THEN("An object is never held by two tasks at once") { REQUIRE(nshared == 0); }
+      THEN("All objects are back and there is at most one per thread") {
+        const int nobjects = pool.SizeInBytes() / (n * sizeof(int));
+        REQUIRE(nobjects > 0);
+        REQUIRE(nobjects <= threads.size());
+        auto obj = pool.Get();
+        REQUIRE(obj.size() == n);
+        obj.Free();
+        REQUIRE(pool.SizeInBytes() == nobjects * n * sizeof(int));
+      }
+    }
+  }
+}
@@ -15,12 +15,19 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
 #include <list>
+#include <map>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <catch2/catch.hpp>
 
+#include "utils/hilbert_curve.hpp"
 #include "utils/partition_stl_containers.hpp"
 
 using parthenon::partition::Partition_t;
@@ -180,3 +187,40 @@ TEST_CASE("Check that partitioning a container works", "[Partition]") {
     }
   }
 }
+
+TEST_CASE("The Hilbert curve visits neighboring cells in order", "[HilbertIndex]") {
+  for (int ndim = 1; ndim <= 3; ++ndim) {
+    for (int nbits = 1; nbits <= 3; ++nbits) {
+      GIVEN("The Hilbert indices of all cells of a " + std::to_string(ndim) +
+            "D grid with " + std::to_string(nbits) + " bits per direction") {
+        using cell_t = std::array<std::uint64_t, 3>;
+        const std::uint64_t n = 1 << nbits;
+        std::map<std::uint64_t, cell_t> cells;
+        for (std::uint64_t k = 0; k < (ndim > 2 ? n : 1); ++k) {
+          for (std::uint64_t j = 0; j < (ndim > 1 ? n : 1); ++j) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+              cells[parthenon::HilbertIndex(ndim, nbits, {i, j, k})] = {i, j, k};
+            }
+          }
+        }
+        THEN("Every index is taken once") {
+          REQUIRE(cells.size() == std::uint64_t(1) << (ndim * nbits));
+          REQUIRE(cells.rbegin()->first == cells.size() - 1);
+        }
+        THEN("Consecutive cells share a face") {
+          int n_incorrect = 0;
+          for (auto it = std::next(cells.begin()); it != cells.end(); ++it) {
+            const cell_t &a = std::prev(it)->second;
+            const cell_t &b = it->second;
+            int distance = 0;
+            for (int d = 0; d < 3; ++d) {
+              distance += std::abs(static_cast<int>(a[d]) - static_cast<int>(b[d]));
+            }
+            if (distance != 1) n_incorrect++;
+          }
+          REQUIRE(n_incorrect == 0);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,81 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cstdint>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/random.hpp"
+
+using parthenon::RandomStreams;
+using parthenon::Real;
+
+// two numbers from the stream of each of n cells of block 7 in the given cycle
+auto Draw(const RandomStreams &rng, const int n, const int cycle) {
+  parthenon::ParArray2D<Real> r("random numbers", n, 2);
+  parthenon::par_for(
+      parthenon::loop_pattern_flatrange_tag, "draw", parthenon::DevExecSpace(), 0, n - 1,
+      KOKKOS_LAMBDA(const int i) {
+        auto stream = rng.Stream(7, i, cycle);
+        r(i, 0) = stream.drand();
+        r(i, 1) = stream.drand();
+      });
+  return r.GetHostMirrorAndCopy();
+}
+
+TEST_CASE("Philox4x32-10 matches the reference", "[RandomStreams]") {
+  // known answers of the Random123 distribution
+  std::uint32_t ctr[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  parthenon::Philox4x32(ctr, 0xa4093822, 0x299f31d0);
+  REQUIRE(ctr[0] == 0xd16cfe09);
+  REQUIRE(ctr[1] == 0x94fdcceb);
+  REQUIRE(ctr[2] == 0x5001e420);
+  REQUIRE(ctr[3] == 0x24126ea1);
+}
+
+TEST_CASE("RandomStreams draw reproducible numbers on device", "[RandomStreams]") {
+  GIVEN("Streams for a block with 1000 cells") {
+    RandomStreams rng(1234);
+    const int n = 1000;
+    auto r = Draw(rng, n, 0);
+    THEN("They are in [0, 1) with mean 1/2") {
+      Real sum = 0.0;
+      bool in_range = true;
+      for (int i = 0; i < n; ++i) {
+        for (int d = 0; d < 2; ++d) {
+          in_range = in_range && r(i, d) >= 0.0 && r(i, d) < 1.0;
+          sum += r(i, d);
+        }
+      }
+      REQUIRE(in_range);
+      REQUIRE(sum / (2 * n) == Approx(0.5).margin(0.03));
+    }
+    THEN("The same keys give the same numbers") {
+      auto again = Draw(rng, n, 0);
+      for (int i = 0; i < n; ++i) {
+        REQUIRE(again(i, 0) == r(i, 0));
+        REQUIRE(again(i, 1) == r(i, 1));
+      }
+    }
+    THEN("Other cycles and successive draws give different numbers") {
+      auto next = Draw(rng, n, 1);
+      int nsame = 0;
+      for (int i = 0; i < n; ++i) {
+        nsame += (next(i, 0) == r(i, 0)) + (r(i, 1) == r(i, 0));
+      }
+      REQUIRE(nsame == 0);
+    }
+  }
+}
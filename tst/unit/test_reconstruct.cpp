@@ -0,0 +1,78 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cmath>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "reconstruct/ppm_inline.hpp"
+#include "reconstruct/wenoz_inline.hpp"
+
+using parthenon::Real;
+
+namespace {
+template <typename F>
+void CheckFivePoint(const F &recon) {
+  Real qm, qp;
+  // face values of a linear function are exact
+  recon(1.0, 3.0, 5.0, 7.0, 9.0, qm, qp);
+  REQUIRE(qm == Approx(4.0));
+  REQUIRE(qp == Approx(6.0));
+  // and so are those of a constant
+  recon(2.0, 2.0, 2.0, 2.0, 2.0, qm, qp);
+  REQUIRE(qm == 2.0);
+  REQUIRE(qp == 2.0);
+  // a step next to the cell doesn't cause overshoots
+  recon(0.0, 0.0, 0.0, 1.0, 1.0, qm, qp);
+  REQUIRE(qm >= -1e-12);
+  REQUIRE(qp >= -1e-12);
+  REQUIRE(qm <= 1.0);
+  REQUIRE(qp < 0.1);
+}
+} // namespace
+
+TEST_CASE("WENO5Z reconstruction", "[reconstruct]") {
+  GIVEN("Linear, constant and discontinuous stencils") {
+    CheckFivePoint(parthenon::WENO5Z);
+  }
+
+  GIVEN("A smooth stencil") {
+    // cell averages of sin(x) on cells of width h centered on -2 h to 2 h around x0
+    const Real h = 0.05, x0 = 0.3;
+    Real q[5];
+    for (int c = 0; c < 5; ++c) {
+      const Real x = x0 + (c - 2) * h;
+      q[c] = (std::cos(x - 0.5 * h) - std::cos(x + 0.5 * h)) / h;
+    }
+    Real qm, qp;
+    parthenon::WENO5Z(q[0], q[1], q[2], q[3], q[4], qm, qp);
+    THEN("The face values are fifth order accurate") {
+      REQUIRE(std::abs(qm - std::sin(x0 - 0.5 * h)) < 1e-7);
+      REQUIRE(std::abs(qp - std::sin(x0 + 0.5 * h)) < 1e-7);
+    }
+  }
+}
+
+TEST_CASE("PPM reconstruction", "[reconstruct]") {
+  GIVEN("Linear, constant and discontinuous stencils") { CheckFivePoint(parthenon::PPM); }
+
+  GIVEN("A local maximum") {
+    Real qm, qp;
+    parthenon::PPM(0.0, 1.0, 2.0, 1.0, 0.0, qm, qp);
+    THEN("The cell is flattened") {
+      REQUIRE(qm == 2.0);
+      REQUIRE(qp == 2.0);
+    }
+  }
+}
@@ -0,0 +1,121 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "coordinates/coordinates.hpp"
+#include "interface/variable_state.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/domain.hpp"
+#include "prolong_restrict/pr_ops.hpp"
+
+using parthenon::Coordinates_t;
+using parthenon::DevExecSpace;
+using parthenon::IndexRange;
+using parthenon::ParArrayND;
+using parthenon::Real;
+using parthenon::VariableState;
+using parthenon::refinement_ops::ProlongateSharedQuadratic;
+
+namespace {
+// average of x^2 over a cell of width h centered on x
+KOKKOS_INLINE_FUNCTION Real AvgSquare(const Real x, const Real h) {
+  return x * x + h * h / 12.0;
+}
+
+// the average over a cell of width h centered on (x, y, z) of x^2 + 2 y^2 - z^2 + x y z
+KOKKOS_INLINE_FUNCTION Real Avg(const Real x, const Real y, const Real z, const Real h) {
+  return AvgSquare(x, h) + 2.0 * AvgSquare(y, h) - AvgSquare(z, h) + x * y * z;
+}
+
+template <class F>
+void Prolongate(const F &f, ParArrayND<Real, VariableState> &fine) {
+  // six interior coarse cells of width 1 per direction, with one ghost cell, prolongated
+  // onto twelve fine cells
+  const int nc = 6;
+  ParArrayND<Real, VariableState> coarse("coarse", nc + 2, nc + 2, nc + 2);
+  fine = ParArrayND<Real, VariableState>("fine", 2 * nc, 2 * nc, 2 * nc);
+  parthenon::par_for(
+      parthenon::loop_pattern_mdrange_tag, "fill coarse", DevExecSpace(), 0, nc + 1, 0,
+      nc + 1, 0, nc + 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        coarse(k, j, i) = f(k, j, i);
+      });
+  const IndexRange cb{1, nc}, fb{0, 2 * nc - 1};
+  const Coordinates_t coords;
+  parthenon::par_for(
+      parthenon::loop_pattern_mdrange_tag, "prolongate", DevExecSpace(), 1, nc, 1, nc, 1,
+      nc, KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        ProlongateSharedQuadratic::Do<3>(0, 0, 0, k, j, i, cb, cb, cb, fb, fb, fb, coords,
+                                         coords, &coarse, &fine);
+      });
+}
+} // namespace
+
+TEST_CASE("ProlongateSharedQuadratic", "[refinement_ops]") {
+  GIVEN("Coarse averages of a smooth function that is quadratic in each direction") {
+    ParArrayND<Real, VariableState> fine;
+    // coarse cell k, j, i is centered on (i + 1, j + 2, k + 3), away from extrema
+    Prolongate(
+        KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          return Avg(i + 1.0, j + 2.0, k + 3.0, 1.0);
+        },
+        fine);
+    THEN("The fine values are its exact averages") {
+      Real err = 0.0;
+      parthenon::par_reduce(
+          parthenon::loop_pattern_mdrange_tag, "error", DevExecSpace(), 0, 11, 0, 11, 0,
+          11,
+          KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lerr) {
+            // fine cell i is centered on x = 1.75 + 0.5 i
+            const Real exact = Avg(1.75 + 0.5 * i, 2.75 + 0.5 * j, 3.75 + 0.5 * k, 0.5);
+            lerr = Kokkos::max(lerr, Kokkos::abs(fine(k, j, i) - exact));
+          },
+          Kokkos::Max<Real>(err));
+      REQUIRE(err < 1e-10);
+    }
+  }
+
+  GIVEN("Coarse values of a step") {
+    ParArrayND<Real, VariableState> fine;
+    Prolongate(
+        KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          return (i + j + k > 10) ? 1.0 : 0.0;
+        },
+        fine);
+    THEN("The fine values are conservative and stay within the range of the step") {
+      Real err = 0.0;
+      parthenon::par_reduce(
+          parthenon::loop_pattern_mdrange_tag, "conservation", DevExecSpace(), 1, 6, 1,
+          6, 1, 6,
+          KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lerr) {
+            const int fk = 2 * (k - 1), fj = 2 * (j - 1), fi = 2 * (i - 1);
+            Real sum = 0.0;
+            for (int ok = 0; ok < 2; ++ok) {
+              for (int oj = 0; oj < 2; ++oj) {
+                for (int oi = 0; oi < 2; ++oi) {
+                  const Real val = fine(fk + ok, fj + oj, fi + oi);
+                  lerr = Kokkos::max(lerr, Kokkos::max(-val, val - 1.0));
+                  sum += val;
+                }
+              }
+            }
+            const Real coarse = (i + j + k > 10) ? 1.0 : 0.0;
+            lerr = Kokkos::max(lerr, Kokkos::abs(sum / 8.0 - coarse));
+          },
+          Kokkos::Max<Real>(err));
+      REQUIRE(err < 1e-12);
+    }
+  }
+}
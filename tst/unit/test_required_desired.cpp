@@ -101,3 +101,44 @@ TEST_CASE("Test required/desired checking from inputs", "[ParameterInput]") {
     }
   }
 }
+
+TEST_CASE("Test lookup of parameters from inputs", "[ParameterInput]") {
+  GIVEN("An input deck with a repeated block and a repeated parameter") {
+    ParameterInput in;
+    std::stringstream ss;
+    ss << "<block1>" << std::endl
+       << "var1 = 0" << std::endl
+       << "<block2>" << std::endl
+       << "var1 = 1" << std::endl
+       << "<block1>" << std::endl
+       << "var2 = 2" << std::endl
+       << "var1 = 3" << std::endl;
+    std::istringstream s(ss.str());
+    in.LoadFromStream(s);
+
+    THEN("The last value of a parameter wins") {
+      REQUIRE(in.GetInteger("block1", "var1") == 3);
+      REQUIRE(in.GetInteger("block1", "var2") == 2);
+      REQUIRE(in.GetInteger("block2", "var1") == 1);
+    }
+    THEN("Blocks and parameters stay in the order they first appeared") {
+      auto *pb = in.pfirst_block;
+      REQUIRE(pb->block_name == "block1");
+      REQUIRE(pb->pline->param_name == "var1");
+      REQUIRE(pb->pline->pnext->param_name == "var2");
+      REQUIRE(pb->pline->pnext->pnext == nullptr);
+      REQUIRE(pb->pnext->block_name == "block2");
+      REQUIRE(pb->pnext->pnext == nullptr);
+    }
+    WHEN("Parameters and blocks are added at run time") {
+      REQUIRE(in.GetOrAddInteger("block2", "var2", 4) == 4);
+      REQUIRE(in.GetOrAddInteger("block3", "var1", 5) == 5);
+      THEN("They can be found afterwards") {
+        REQUIRE(in.DoesParameterExist("block2", "var2"));
+        REQUIRE(in.GetInteger("block3", "var1") == 5);
+        REQUIRE(in.pfirst_block->pnext->pline->pnext->param_name == "var2");
+        REQUIRE(in.pfirst_block->pnext->pnext->block_name == "block3");
+      }
+    }
+  }
+}
@@ -0,0 +1,106 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "config.hpp"
+#include "mesh/logical_location.hpp"
+#include "outputs/restart.hpp"
+
+#ifdef ENABLE_HDF5
+
+#include "outputs/parthenon_hdf5.hpp"
+
+using parthenon::LogicalLocation;
+using parthenon::Real;
+using parthenon::RestartReader;
+
+TEST_CASE("Blocks can be read selectively from an output", "[RestartReader][output]") {
+  GIVEN("A file with two root blocks, the second of which is refined once in x1") {
+    const std::string filename = "restart_reader_test.h5";
+    // three blocks with 2x4 values each, value 100 * block + index
+    const int nblocks = 3, nvals = 8;
+    const std::vector<std::int64_t> levels = {0, 1, 1};
+    const std::vector<std::int64_t> locs = {0, 0, 0, 2, 0, 0, 3, 0, 0};
+    std::vector<Real> var(nblocks * nvals);
+    for (int i = 0; i < var.size(); ++i) {
+      var[i] = 100 * (i / nvals) + i % nvals;
+    }
+    {
+      using namespace parthenon::HDF5;
+      H5F file = H5F::FromHIDCheck(
+          H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT));
+      const H5P pl_xfer = H5P::FromHIDCheck(H5Pcreate(H5P_DATASET_XFER));
+      MakeGroup(file, "Params");
+      const H5G info = MakeGroup(file, "Info");
+      const int includes_ghost = 0;
+      HDF5WriteAttribute("IncludesGhost", 1, &includes_ghost, info);
+
+      const hsize_t offset[3] = {0, 0, 0};
+      const hsize_t count_levels[1] = {nblocks};
+      const hsize_t count_locs[2] = {nblocks, 3};
+      const hsize_t count_var[3] = {nblocks, 2, 4};
+      HDF5Write1D(file, "Levels", levels.data(), offset, count_levels, count_levels,
+                  pl_xfer);
+      HDF5Write2D(file, "LogicalLocations", locs.data(), offset, count_locs, count_locs,
+                  pl_xfer);
+      HDF5WriteND(file, "var", var.data(), 3, offset, count_var, count_var, pl_xfer,
+                  H5P_DEFAULT);
+    }
+
+    RestartReader rr(filename.c_str());
+    THEN("Blocks are found by their logical location") {
+      REQUIRE(rr.FindBlock(LogicalLocation(0, 0, 0, 0)) == 0);
+      REQUIRE(rr.FindBlock(LogicalLocation(1, 3, 0, 0)) == 2);
+      REQUIRE(rr.FindBlock(LogicalLocation(0, 1, 0, 0)) == -1);
+      REQUIRE(rr.FindBlock(LogicalLocation(1, 0, 0, 0)) == -1);
+    }
+    THEN("Blocks are found by the region they overlap on any level") {
+      using loc_t = std::array<std::int64_t, 3>;
+      REQUIRE(rr.FindBlocksInRegion(1, loc_t{1, 0, 0}, loc_t{2, 0, 0}) ==
+              std::vector<int>{0, 1});
+      REQUIRE(rr.FindBlocksInRegion(0, loc_t{1, 0, 0}, loc_t{1, 0, 0}) ==
+              std::vector<int>{1, 2});
+      REQUIRE(rr.FindBlocksInRegion(2, loc_t{7, 0, 0}, loc_t{7, 0, 0}) ==
+              std::vector<int>{2});
+      REQUIRE(rr.FindBlocksInRegion(0, loc_t{0, 1, 0}, loc_t{1, 1, 0}).empty());
+    }
+    THEN("The data of single blocks can be read") {
+      const auto data = rr.ReadBlock<Real>("var", 1);
+      REQUIRE(data.size() == nvals);
+      for (int i = 0; i < nvals; ++i) {
+        REQUIRE(data[i] == 100 + i);
+      }
+    }
+    THEN("The data of several blocks is read in ascending block order") {
+      const auto data = rr.ReadSelectedBlocks<Real>("var", {2, 0, 2});
+      REQUIRE(data.size() == 2 * nvals);
+      for (int i = 0; i < nvals; ++i) {
+        REQUIRE(data[i] == i);
+        REQUIRE(data[nvals + i] == 200 + i);
+      }
+      AND_THEN("Reading again from the open dataset gives the same result") {
+        REQUIRE(rr.ReadSelectedBlocks<Real>("var", {0, 2}) == data);
+      }
+    }
+  }
+}
+
+#endif // ENABLE_HDF5
@@ -0,0 +1,89 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "utils/simd_loops.hpp"
+
+using parthenon::DevExecSpace;
+using parthenon::ParArray3D;
+using parthenon::ParArray4D;
+using parthenon::Real;
+using parthenon::SimdLanes;
+using parthenon::SimdReal;
+
+TEST_CASE("par_for_simd covers rows with a masked remainder", "[par_for_simd]") {
+  GIVEN("Rows whose length is not a multiple of the SIMD width") {
+    const int nk = 3, nj = 4, ni = 2 * parthenon::simd_width + 3;
+    // one extra cell on each side of the range in i that must not be touched
+    ParArray3D<Real> a("a", nk, nj, ni + 2);
+    ParArray3D<Real> b("b", nk, nj, ni + 2);
+    parthenon::par_for(
+        parthenon::loop_pattern_mdrange_tag, "fill a", DevExecSpace(), 0, nk - 1, 0,
+        nj - 1, 0, ni + 1, KOKKOS_LAMBDA(const int k, const int j, const int i) {
+          a(k, j, i) = i + 10 * j + 100 * k;
+          b(k, j, i) = -1.0;
+        });
+
+    WHEN("b = 2 a + i is computed on vectors of lanes") {
+      parthenon::par_for_simd(
+          "simd axpy", DevExecSpace(), 0, nk - 1, 0, nj - 1, 1, ni,
+          KOKKOS_LAMBDA(const int k, const int j, const SimdLanes &lanes) {
+            const SimdReal i = lanes.Gather([](const int ii) { return Real(ii); });
+            lanes.Store(SimdReal(2.0) * lanes.Load(&a(k, j, lanes.i())) + i,
+                        &b(k, j, lanes.i()));
+          });
+
+      THEN("Every cell of the range is set and the cells next to it are not") {
+        int nwrong = 0;
+        parthenon::par_reduce(
+            parthenon::loop_pattern_mdrange_tag, "check b", DevExecSpace(), 0, nk - 1, 0,
+            nj - 1, 0, ni + 1,
+            KOKKOS_LAMBDA(const int k, const int j, const int i, int &lwrong) {
+              const Real expected =
+                  (i == 0 || i == ni + 1) ? -1.0 : 2.0 * a(k, j, i) + i;
+              lwrong += (b(k, j, i) != expected);
+            },
+            Kokkos::Sum<int>(nwrong));
+        REQUIRE(nwrong == 0);
+      }
+    }
+
+    WHEN("The lanes of a 4D loop are counted") {
+      ParArray4D<Real> count("count", 2, nk, nj, ni + 2);
+      parthenon::par_for_simd(
+          "simd count", DevExecSpace(), 0, 1, 0, nk - 1, 0, nj - 1, 1, ni,
+          KOKKOS_LAMBDA(const int n, const int k, const int j, const SimdLanes &lanes) {
+            for (int l = 0; l < lanes.size(); ++l) {
+              count(n, k, j, lanes.i() + l) += 1.0;
+            }
+          });
+
+      THEN("Every cell of the range belongs to exactly one vector") {
+        int nwrong = 0;
+        parthenon::par_reduce(
+            parthenon::loop_pattern_mdrange_tag, "check count", DevExecSpace(), 0, 1, 0,
+            nk - 1, 0, nj - 1, 0, ni + 1,
+            KOKKOS_LAMBDA(const int n, const int k, const int j, const int i,
+                          int &lwrong) {
+              const Real expected = (i == 0 || i == ni + 1) ? 0.0 : 1.0;
+              lwrong += (count(n, k, j, i) != expected);
+            },
+            Kokkos::Sum<int>(nwrong));
+        REQUIRE(nwrong == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,78 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "interface/sparse_allocation_map.hpp"
+#include "kokkos_abstraction.hpp"
+
+using parthenon::SparseAllocationMap;
+using parthenon::Uid_t;
+
+TEST_CASE("SparseAllocationMap tracks allocation status", "[SparseAllocationMap]") {
+  GIVEN("A map for three blocks and two sparse variables") {
+    SparseAllocationMap map;
+    const std::vector<Uid_t> uids{7, 3};
+    map.Resize(3, uids);
+    REQUIRE(map.NumBlocks() == 3);
+    REQUIRE(map.NumColumns() == 2);
+    REQUIRE(map.Column(7) == 0);
+    REQUIRE(map.Column(3) == 1);
+    REQUIRE(map.Column(5) == -1);
+
+    THEN("Nothing is allocated") {
+      for (int b = 0; b < 3; ++b) {
+        for (const auto uid : uids) {
+          REQUIRE_FALSE(map.IsAllocated(b, uid));
+        }
+      }
+    }
+
+    WHEN("Some variables are allocated") {
+      map.Set(0, 7, true);
+      map.Set(2, 3, true);
+      map.Set(2, 7, true);
+      map.Set(2, 7, false);
+      THEN("The host status is updated") {
+        REQUIRE(map.IsAllocated(0, 7));
+        REQUIRE_FALSE(map.IsAllocated(0, 3));
+        REQUIRE(map.IsAllocated(2, 3));
+        REQUIRE_FALSE(map.IsAllocated(2, 7));
+      }
+      THEN("Unknown blocks and variables are ignored") {
+        map.Set(3, 7, true);
+        map.Set(-1, 7, true);
+        map.Set(1, 5, true);
+        REQUIRE_FALSE(map.IsAllocated(3, 7));
+        REQUIRE_FALSE(map.IsAllocated(1, 5));
+      }
+      THEN("The device view matches") {
+        auto view = map.GetDeviceView();
+        int nallocated = 0;
+        Kokkos::parallel_reduce(
+            "count", 6,
+            KOKKOS_LAMBDA(const int n, int &lsum) { lsum += view(n / 2, n % 2); },
+            nallocated);
+        REQUIRE(nallocated == 2);
+        const int col = map.Column(3);
+        int on_block2 = 0;
+        Kokkos::parallel_reduce(
+            "check", 1, KOKKOS_LAMBDA(const int, int &lsum) { lsum += view(2, col); },
+            on_block2);
+        REQUIRE(on_block2 == 1);
+      }
+    }
+  }
+}
@@ -25,6 +25,8 @@
 #include "interface/sparse_pack.hpp"
 #include "kokkos_abstraction.hpp"
 #include "mesh/meshblock.hpp"
+#include "reconstruct/dc_inline.hpp"
+#include "reconstruct/plm_inline.hpp"
 
 // TODO(jcd): can't call the MeshBlock constructor without mesh_refinement.hpp???
 #include "mesh/mesh_refinement.hpp"
@@ -41,6 +43,9 @@ using parthenon::PackIndexMap;
 using parthenon::par_for;
 using parthenon::Real;
 using parthenon::StateDescriptor;
+using parthenon::X1DIR;
+using parthenon::X2DIR;
+using parthenon::X3DIR;
 
 namespace {
 BlockList_t MakeBlockList(const std::shared_ptr<StateDescriptor> pkg, const int NBLOCKS,
@@ -204,6 +209,28 @@ TEST_CASE("Test behavior of sparse packs", "[SparsePack]") {
         REQUIRE(hi == 0); // hi is scalar. Only one value.
       }
 
+      THEN("Only packs of variables allocated on all blocks have uniform bounds") {
+        auto desc = parthenon::MakePackDescriptor<v1, v5>(pkg.get());
+        auto pack = desc.GetPack(&mesh_data);
+        REQUIRE(pack.HasUniformBounds());
+        REQUIRE(!parthenon::MakePackDescriptor<v1, v3, v5>(pkg.get())
+                     .GetPack(&mesh_data)
+                     .HasUniformBounds());
+
+        const int v = 2; // v5 is the third variable in the loop above
+        int nwrong = 0;
+        par_reduce(
+            loop_pattern_mdrange_tag, "check uniform", DevExecSpace(), 0,
+            pack.GetNBlocks() - 1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA(int b, int k, int j, int i, int &ltot) {
+              Real n = i + 1e1 * j + 1e2 * k + 1e5 * v + 1e3 * b;
+              if (pack.GetLowerBound(b, v5()) != 1) ltot += 1;
+              if (n != pack(b, v5(), k, j, i)) ltot += 1;
+            },
+            nwrong);
+        REQUIRE(nwrong == 0);
+      }
+
       THEN("A sparse pack correctly loads this data and can report existence and "
            "nonexistence for variables on different blocks.") {
         auto desc = parthenon::MakePackDescriptor<v1, v3, v5>(pkg.get());
@@ -376,3 +403,198 @@ TEST_CASE("Test behavior of sparse packs", "[SparsePack]") {
     }
   }
 }
+
+TEST_CASE("Uploads of packs built in a batch", "[SparsePack]") {
+  constexpr int N = 6;
+  constexpr int NDIM = 3;
+  constexpr int NBLOCKS = 4;
+
+  GIVEN("A scalar variable on two partitions of a mesh") {
+    Metadata m({Metadata::Independent}, std::vector<int>{N, N, N});
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField<v1>(m);
+    BlockList_t block_list = MakeBlockList(pkg, NBLOCKS, N, NDIM);
+    BlockList_t first(block_list.begin(), block_list.begin() + NBLOCKS / 2);
+    BlockList_t second(block_list.begin() + NBLOCKS / 2, block_list.end());
+    MeshData<Real> md_first("base"), md_second("base");
+    md_first.Set(first, nullptr);
+    md_second.Set(second, nullptr);
+    auto desc = parthenon::MakePackDescriptor<v1>(pkg.get());
+    // packs are only staged and uploaded when the device can't read host memory
+    constexpr bool staged =
+        !Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                                    parthenon::DevMemSpace>::accessible;
+
+    THEN("Without a batch GetPack waits for the upload of its pack") {
+      REQUIRE(!parthenon::PackUploadBatch::Active());
+      auto pack = desc.GetPack(&md_first);
+      REQUIRE(pack.GetNBlocks() == NBLOCKS / 2);
+      REQUIRE(!parthenon::PackUploadBatch::UploadsPending());
+    }
+
+    THEN("Inside a batch the uploads are only waited on when the batch ends") {
+      {
+        parthenon::PackUploadBatch batch;
+        REQUIRE(parthenon::PackUploadBatch::Active());
+        {
+          parthenon::PackUploadBatch inner;
+          desc.GetPack(&md_first);
+        }
+        // only the outermost batch waits for the uploads
+        REQUIRE(parthenon::PackUploadBatch::UploadsPending() == staged);
+        desc.GetPack(&md_second);
+        REQUIRE(parthenon::PackUploadBatch::UploadsPending() == staged);
+      }
+      REQUIRE(!parthenon::PackUploadBatch::Active());
+      REQUIRE(!parthenon::PackUploadBatch::UploadsPending());
+
+      AND_THEN("The packs built in the batch can be used on the device") {
+        auto pack_first = desc.GetPack(&md_first);
+        auto pack_second = desc.GetPack(&md_second);
+        REQUIRE(pack_first.GetNBlocks() == NBLOCKS / 2);
+        REQUIRE(pack_second.GetNBlocks() == NBLOCKS / 2);
+        auto ib = block_list[0]->cellbounds.GetBoundsI(IndexDomain::entire);
+        auto jb = block_list[0]->cellbounds.GetBoundsJ(IndexDomain::entire);
+        auto kb = block_list[0]->cellbounds.GetBoundsK(IndexDomain::entire);
+        par_for(
+            loop_pattern_mdrange_tag, "set v1", DevExecSpace(), 0, NBLOCKS / 2 - 1,
+            kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA(int b, int k, int j, int i) {
+              pack_first(b, v1(), k, j, i) = b;
+              pack_second(b, v1(), k, j, i) = b + NBLOCKS / 2;
+            });
+        int nwrong = 0;
+        for (int b = 0; b < NBLOCKS; ++b) {
+          auto &pmbd = block_list[b]->meshblock_data.Get();
+          auto v = pmbd->Get("v1").data.GetHostMirrorAndCopy();
+          for (int k = kb.s; k <= kb.e; ++k) {
+            for (int j = jb.s; j <= jb.e; ++j) {
+              for (int i = ib.s; i <= ib.e; ++i) {
+                nwrong += (v(k, j, i) != b);
+              }
+            }
+          }
+        }
+        REQUIRE(nwrong == 0);
+      }
+    }
+  }
+}
+
+TEST_CASE("Reconstruction of all components of a sparse pack", "[SparsePack]") {
+  constexpr int N = 6;
+  constexpr int NDIM = 3;
+  constexpr int NBLOCKS = 2;
+
+  GIVEN("A scalar and a vector variable that are linear in space") {
+    Metadata m({Metadata::Independent}, std::vector<int>{N, N, N});
+    Metadata m_vector({Metadata::Independent, Metadata::Vector},
+                      std::vector<int>{N, N, N, 3});
+    auto pkg = std::make_shared<StateDescriptor>("Test package");
+    pkg->AddField<v1>(m);
+    pkg->AddField<v3>(m_vector);
+    BlockList_t block_list = MakeBlockList(pkg, NBLOCKS, N, NDIM);
+    for (auto &pmb : block_list) {
+      pmb->coords = parthenon::Coordinates_t(
+          parthenon::RegionSize({0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}, {1.0, 1.0, 1.0},
+                                {N, N, N}),
+          nullptr);
+    }
+    MeshData<Real> mesh_data("base");
+    mesh_data.Set(block_list, nullptr);
+
+    auto desc = parthenon::MakePackDescriptor<v1, v3>(pkg.get());
+    auto pack = desc.GetPack(&mesh_data);
+    const int nvar = pack.GetMaxNumberOfVars();
+    REQUIRE(nvar == 4);
+    auto ib = block_list[0]->cellbounds.GetBoundsI(IndexDomain::entire);
+    auto jb = block_list[0]->cellbounds.GetBoundsJ(IndexDomain::entire);
+    auto kb = block_list[0]->cellbounds.GetBoundsK(IndexDomain::entire);
+    // the slope of component n is n + 1 in i, 2 (n + 1) in j and 3 (n + 1) in k
+    par_for(
+        loop_pattern_mdrange_tag, "initialize", DevExecSpace(), 0, NBLOCKS - 1, kb.s,
+        kb.e, jb.s, jb.e, ib.s, ib.e, KOKKOS_LAMBDA(int b, int k, int j, int i) {
+          for (int n = 0; n < nvar; ++n) {
+            pack(b, n, k, j, i) = (n + 1) * (i + 2 * j + 3 * k) + b;
+          }
+        });
+
+    auto interior_ib = block_list[0]->cellbounds.GetBoundsI(IndexDomain::interior);
+    auto interior_jb = block_list[0]->cellbounds.GetBoundsJ(IndexDomain::interior);
+    auto interior_kb = block_list[0]->cellbounds.GetBoundsK(IndexDomain::interior);
+    const int il = interior_ib.s, iu = interior_ib.e;
+    const int nx1 = ib.e + 1;
+    const int scratch_level = 0;
+    const std::size_t scratch_size =
+        3 * parthenon::ScratchPad2D<Real>::shmem_size(nvar, nx1);
+
+    THEN("PiecewiseLinearPack and DonorCellPack reconstruct every component") {
+      parthenon::ParArray3D<int> nwrong_row("nwrong", NBLOCKS, kb.e + 1, jb.e + 1);
+      parthenon::par_for_outer(
+          DEFAULT_OUTER_LOOP_PATTERN, "reconstruct", DevExecSpace(), scratch_size,
+          scratch_level, 0, NBLOCKS - 1, interior_kb.s, interior_kb.e, interior_jb.s,
+          interior_jb.e,
+          KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int b, const int k,
+                        const int j) {
+            parthenon::ScratchPad2D<Real> ql(member.team_scratch(scratch_level), nvar,
+                                             nx1);
+            parthenon::ScratchPad2D<Real> qr(member.team_scratch(scratch_level), nvar,
+                                             nx1);
+            parthenon::ScratchPad2D<Real> dqm(member.team_scratch(scratch_level), nvar,
+                                              nx1);
+            const auto differs = [](const Real a, const Real b) {
+              return Kokkos::abs(a - b) > 1e-10;
+            };
+            int nwrong = 0;
+            parthenon::PiecewiseLinearPack<X1DIR>(member, b, k, j, il, iu, pack, ql, qr,
+                                                  dqm);
+            member.team_barrier();
+            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+              for (int n = 0; n < nvar; ++n) {
+                for (int i = il; i <= iu; ++i) {
+                  const Real q = pack(b, n, k, j, i);
+                  nwrong += differs(dqm(n, i), n + 1);
+                  nwrong += differs(ql(n, i + 1), q + 0.5 * (n + 1));
+                  nwrong += differs(qr(n, i), q - 0.5 * (n + 1));
+                }
+              }
+            });
+            member.team_barrier();
+            parthenon::PiecewiseLinearPack<X2DIR>(member, b, k, j, il, iu, pack, ql, qr,
+                                                  dqm);
+            member.team_barrier();
+            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+              for (int n = 0; n < nvar; ++n) {
+                for (int i = il; i <= iu; ++i) {
+                  const Real q = pack(b, n, k, j, i);
+                  nwrong += differs(dqm(n, i), 2 * (n + 1));
+                  nwrong += differs(ql(n, i), q + (n + 1));
+                  nwrong += differs(qr(n, i), q - (n + 1));
+                }
+              }
+            });
+            member.team_barrier();
+            parthenon::DonorCellPack<X3DIR>(member, b, k, j, il, iu, pack, ql, qr);
+            member.team_barrier();
+            Kokkos::single(Kokkos::PerTeam(member), [&]() {
+              for (int n = 0; n < nvar; ++n) {
+                for (int i = il; i <= iu; ++i) {
+                  const Real q = pack(b, n, k, j, i);
+                  nwrong += differs(ql(n, i), q) + differs(qr(n, i), q);
+                }
+              }
+              nwrong_row(b, k, j) = nwrong;
+            });
+          });
+      int nwrong = 0;
+      parthenon::par_reduce(
+          loop_pattern_mdrange_tag, "count wrong", DevExecSpace(), 0, NBLOCKS - 1, 0,
+          kb.e, 0, jb.e,
+          KOKKOS_LAMBDA(const int b, const int k, const int j, int &ltot) {
+            ltot += nwrong_row(b, k, j);
+          },
+          nwrong);
+      REQUIRE(nwrong == 0);
+    }
+  }
+}
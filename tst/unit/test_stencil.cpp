@@ -0,0 +1,76 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "solvers/solver_utils.hpp"
+
+using parthenon::ParArray5D;
+using parthenon::Real;
+using namespace parthenon::solvers;
+
+TEST_CASE("StaticStencil", "[StaticStencil]") {
+  const int n = 6;
+  ParArray5D<Real> v("v", 1, 1, n, n, n);
+  // a quadratic, whose Laplacian both stencils reproduce exactly
+  parthenon::par_for(
+      parthenon::loop_pattern_mdrange_tag, "Fill", parthenon::DevExecSpace(), 0, n - 1,
+      0, n - 1, 0, n - 1, KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        v(0, 0, k, j, i) = i * i + 2.0 * j * j + 3.0 * k * k;
+      });
+
+  GIVEN("The 7 point Laplacian as runtime and compile time stencils") {
+    const std::vector<std::vector<int>> offsets(
+        {{-1, 0, 1, 0, 0, 0, 0}, {0, 0, 0, -1, 1, 0, 0}, {0, 0, 0, 0, 0, -1, 1}});
+    const Real scale = 0.5;
+    const Stencil<Real> stencil("stencil", 7,
+                                {scale, -6.0 * scale, scale, scale, scale, scale, scale},
+                                offsets);
+    const StaticStencil<Laplacian7Point> static_stencil(scale);
+    STATIC_REQUIRE(static_stencil.nstencil == 7);
+    THEN("MatVec and Jacobi agree") {
+      Real err = 0.0;
+      parthenon::par_reduce(
+          parthenon::loop_pattern_mdrange_tag, "Compare", parthenon::DevExecSpace(), 1,
+          n - 2, 1, n - 2, 1, n - 2,
+          KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lerr) {
+            lerr += Kokkos::abs(stencil.MatVec(v, 0, 0, k, j, i) - 6.0) +
+                    Kokkos::abs(static_stencil.MatVec(v, 0, 0, k, j, i) - 6.0) +
+                    Kokkos::abs(stencil.Jacobi(v, 0, 0, k, j, i, 1.0) -
+                                static_stencil.Jacobi(v, 0, 0, k, j, i, 1.0));
+          },
+          Kokkos::Sum<Real>(err));
+      REQUIRE(err < 1.e-10);
+    }
+  }
+
+  GIVEN("The 27 point Laplacian") {
+    const StaticStencil<Laplacian27Point> stencil;
+    STATIC_REQUIRE(Laplacian27Point::w(Laplacian27Point::ndiag) == -128.0 / 30.0);
+    THEN("It reproduces the Laplacian of a quadratic") {
+      Real err = 0.0;
+      parthenon::par_reduce(
+          parthenon::loop_pattern_mdrange_tag, "Check", parthenon::DevExecSpace(), 1,
+          n - 2, 1, n - 2, 1, n - 2,
+          KOKKOS_LAMBDA(const int k, const int j, const int i, Real &lerr) {
+            lerr += Kokkos::abs(stencil.MatVec(v, 0, 0, k, j, i) - 12.0);
+          },
+          Kokkos::Sum<Real>(err));
+      REQUIRE(err < 1.e-10);
+    }
+  }
+}
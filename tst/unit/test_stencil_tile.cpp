@@ -0,0 +1,83 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "kokkos_abstraction.hpp"
+#include "mesh/domain.hpp"
+#include "utils/stencil_tile.hpp"
+
+using parthenon::DevExecSpace;
+using parthenon::IndexRange;
+using parthenon::ParArray4D;
+using parthenon::Real;
+using parthenon::StencilTile;
+using parthenon::team_mbr_t;
+using parthenon::TileShape;
+
+TEST_CASE("par_for_tiles stages tiles with their halo in scratch", "[StencilTile]") {
+  GIVEN("Two blocks of a quadratic function with one ghost cell") {
+    const int nblocks = 2;
+    const int nk = 5, nj = 7, ni = 10;
+    ParArray4D<Real> q("q", nblocks, nk + 2, nj + 2, ni + 2);
+    ParArray4D<Real> out("out", nblocks, nk + 2, nj + 2, ni + 2);
+    parthenon::par_for(
+        parthenon::loop_pattern_mdrange_tag, "fill q", DevExecSpace(), 0, nblocks - 1, 0,
+        nk + 1, 0, nj + 1, 0, ni + 1,
+        KOKKOS_LAMBDA(const int b, const int k, const int j, const int i) {
+          q(b, k, j, i) = i * i + 2 * j * j + 3 * k * k + b;
+        });
+    const IndexRange kb{1, nk}, jb{1, nj}, ib{1, ni};
+
+    WHEN("Two passes over tiles that don't divide the block read from scratch") {
+      // the first pass stores the difference in i in the second variable of the tile,
+      // the second one adds the differences in j and k of the first variable
+      const TileShape shape(2, 3, 4, 1, 3);
+      parthenon::par_for_tiles(
+          "two passes", DevExecSpace(), 0, 2, shape, 0, nblocks - 1, kb, jb, ib,
+          KOKKOS_LAMBDA(team_mbr_t member, const int b, StencilTile<Real> &tile) {
+            tile.Load(
+                member,
+                [&](const int, const int k, const int j, const int i) {
+                  return q(b, k, j, i);
+                },
+                0, 0);
+            tile.ForEach(member, [&](const int k, const int j, const int i) {
+              tile(1, k, j, i) = tile(0, k, j, i + 1) - tile(0, k, j, i - 1);
+            });
+            member.team_barrier();
+            tile.ForEach(member, [&](const int k, const int j, const int i) {
+              out(b, k, j, i) = tile(1, k, j, i) + tile(0, k, j + 1, i) -
+                                tile(0, k, j - 1, i) + tile(0, k + 1, j, i) -
+                                tile(0, k - 1, j, i);
+            });
+          });
+      THEN("Every cell of both blocks gets the sum of the central differences") {
+        int nwrong = 0;
+        parthenon::par_reduce(
+            parthenon::loop_pattern_mdrange_tag, "check out", DevExecSpace(), 0,
+            nblocks - 1, 0, nk + 1, 0, nj + 1, 0, ni + 1,
+            KOKKOS_LAMBDA(const int b, const int k, const int j, const int i,
+                          int &lwrong) {
+              const bool interior =
+                  k >= 1 && k <= nk && j >= 1 && j <= nj && i >= 1 && i <= ni;
+              const Real expected = interior ? 4 * i + 8 * j + 12 * k : 0.0;
+              if (out(b, k, j, i) != expected) lwrong += 1;
+            },
+            nwrong);
+        REQUIRE(nwrong == 0);
+      }
+    }
+  }
+}
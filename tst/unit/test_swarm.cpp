@@ -19,13 +19,16 @@
 
 #include <cmath>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
 #include "bvals/bvals_interfaces.hpp"
 #include "interface/swarm.hpp"
+#include "interface/swarm_cell_loops.hpp"
 #include "kokkos_abstraction.hpp"
 #include "mesh/mesh.hpp"
 
@@ -35,16 +38,21 @@
 using Real = double;
 using parthenon::ApplicationInput;
 using parthenon::BoundaryFlag;
+using parthenon::Coordinates_t;
 using parthenon::DeviceAllocate;
 using parthenon::DeviceDeleter;
+using parthenon::IndexDomain;
 using parthenon::Mesh;
 using parthenon::MeshBlock;
 using parthenon::Metadata;
 using parthenon::Packages_t;
 using parthenon::ParameterInput;
 using parthenon::ParArray1D;
+using parthenon::ParArray3D;
 using parthenon::ParArrayND;
 using parthenon::ParticleBound;
+using parthenon::RegionSize;
+using parthenon::ScratchPad1D;
 using parthenon::Swarm;
 using parthenon::SwarmDeviceContext;
 using std::endl;
@@ -231,4 +239,240 @@ TEST_CASE("Swarm memory management", "[Swarm]") {
       });
   failures_h = failures_d.GetHostMirrorAndCopy();
   REQUIRE(failures_h(0) == 0);
+
+  // Create particles on device, with more attempts than reserved slots and more
+  // reserved slots than the pool holds
+  const int num_active = swarm->GetNumActive();
+  const int num_reserved = 2 * NUMINIT;
+  auto creator = swarm->ReserveParticles(num_reserved);
+  auto x_new = swarm->Get<Real>("x").Get();
+  meshblock->par_for(
+      "Create particles", 0, num_reserved + 4, KOKKOS_LAMBDA(const int n) {
+        const int idx = creator.Create();
+        if (idx >= 0) x_new(idx) = 0.25;
+      });
+  REQUIRE(swarm->CommitReservedParticles() == num_reserved);
+  REQUIRE(swarm->GetNumActive() == num_active + num_reserved);
+  swarm_d = swarm->GetDeviceContext();
+  int num_created = 0;
+  meshblock->par_reduce(
+      "Count created", 0, swarm->GetMaxActiveIndex(),
+      KOKKOS_LAMBDA(const int n, int &lnum) {
+        lnum += (swarm_d.IsActive(n) && x_new(n) == 0.25);
+      },
+      Kokkos::Sum<int>(num_created));
+  REQUIRE(num_created == num_reserved);
+}
+
+TEST_CASE("Contiguous swarm memory management", "[Swarm]") {
+  std::stringstream is;
+  is << "<parthenon/mesh>" << endl;
+  is << "x1min = -0.5" << endl;
+  is << "x2min = -0.5" << endl;
+  is << "x3min = -0.5" << endl;
+  is << "x1max = 0.5" << endl;
+  is << "x2max = 0.5" << endl;
+  is << "x3max = 0.5" << endl;
+  is << "nx1 = 4" << endl;
+  is << "nx2 = 4" << endl;
+  is << "nx3 = 4" << endl;
+  auto pin = std::make_shared<ParameterInput>();
+  pin->LoadFromStream(is);
+  auto app_in = std::make_shared<ApplicationInput>();
+  Packages_t packages;
+  auto meshblock = std::make_shared<MeshBlock>(1, 1);
+  auto mesh = std::make_shared<Mesh>(pin.get(), app_in.get(), packages, 1);
+  meshblock->pmy_mesh = mesh.get();
+  auto swarm = std::make_shared<Swarm>("test swarm", Metadata({Metadata::Contiguous}),
+                                       NUMINIT);
+  swarm->SetBlockPointer(meshblock);
+  swarm->Add("i", Metadata({Metadata::Integer, Metadata::Particle}));
+
+  // Fill the pool and grow it, x and i hold the index of each particle
+  swarm->AddEmptyParticles(NUMINIT + 2);
+  auto x = swarm->Get<Real>("x").Get();
+  auto i = swarm->Get<int>("i").Get();
+  meshblock->par_for(
+      "Set data", 0, NUMINIT + 1, KOKKOS_LAMBDA(const int n) {
+        x(n) = n;
+        i(n) = n;
+      });
+  swarm->AddEmptyParticles(NUMINIT);
+  REQUIRE(swarm->GetNumActive() == 2 * NUMINIT + 2);
+  // views of the variables of a contiguous swarm don't survive a resize of the pool
+  x = swarm->Get<Real>("x").Get();
+  i = swarm->Get<int>("i").Get();
+
+  // Remove particles 1 and 3 and defragment
+  auto swarm_d = swarm->GetDeviceContext();
+  meshblock->par_for(
+      "Remove particles", 0, 0, KOKKOS_LAMBDA(const int n) {
+        swarm_d.MarkParticleForRemoval(1);
+        swarm_d.MarkParticleForRemoval(3);
+      });
+  swarm->RemoveMarkedParticles();
+  meshblock->par_for(
+      "Mark moved particles", 0, 0, KOKKOS_LAMBDA(const int n) {
+        x(2 * NUMINIT + 1) = -1.0;
+        i(2 * NUMINIT) = -2;
+      });
+  swarm->Defrag();
+  REQUIRE(swarm->GetMaxActiveIndex() == 2 * NUMINIT - 1);
+
+  // Data of the particles that stayed is intact, the last particle moved into the first
+  // free slot and the second to last into the second
+  auto x_h = swarm->Get<Real>("x").GetHostMirrorAndCopy();
+  auto i_h = swarm->Get<int>("i").GetHostMirrorAndCopy();
+  REQUIRE(x_h(0) == 0.0);
+  REQUIRE(i_h(NUMINIT + 1) == NUMINIT + 1);
+  REQUIRE(x_h(1) == -1.0);
+  REQUIRE(i_h(3) == -2);
+}
+
+TEST_CASE("Batched swarm operations", "[Swarm]") {
+  std::stringstream is;
+  is << "<parthenon/mesh>" << endl;
+  is << "nx1 = 4" << endl;
+  is << "nx2 = 4" << endl;
+  is << "nx3 = 4" << endl;
+  auto pin = std::make_shared<ParameterInput>();
+  pin->LoadFromStream(is);
+  auto app_in = std::make_shared<ApplicationInput>();
+  Packages_t packages;
+  auto meshblock = std::make_shared<MeshBlock>(1, 1);
+  auto mesh = std::make_shared<Mesh>(pin.get(), app_in.get(), packages, 1);
+  meshblock->pmy_mesh = mesh.get();
+  // one plain and one contiguous swarm, with particles 1 and 3 removed from the first
+  // and 0 from the second
+  std::vector<std::shared_ptr<Swarm>> swarms = {
+      std::make_shared<Swarm>("a", Metadata(), NUMINIT),
+      std::make_shared<Swarm>("b", Metadata({Metadata::Contiguous}), NUMINIT)};
+  std::vector<Swarm *> swarm_ptrs;
+  for (auto &swarm : swarms) {
+    swarm->SetBlockPointer(meshblock);
+    swarm->AddEmptyParticles(NUMINIT);
+    auto x = swarm->Get<Real>("x").Get();
+    meshblock->par_for(
+        "Set data", 0, NUMINIT - 1, KOKKOS_LAMBDA(const int n) { x(n) = n; });
+    swarm_ptrs.push_back(swarm.get());
+  }
+  auto a_d = swarms[0]->GetDeviceContext();
+  auto b_d = swarms[1]->GetDeviceContext();
+  meshblock->par_for(
+      "Remove particles", 0, 0, KOKKOS_LAMBDA(const int n) {
+        a_d.MarkParticleForRemoval(1);
+        a_d.MarkParticleForRemoval(3);
+        b_d.MarkParticleForRemoval(0);
+      });
+
+  Swarm::RemoveMarkedParticles(swarm_ptrs);
+  REQUIRE(swarms[0]->GetNumActive() == NUMINIT - 2);
+  REQUIRE(swarms[1]->GetNumActive() == NUMINIT - 1);
+  REQUIRE(swarms[0]->GetMaxActiveIndex() == NUMINIT - 1);
+
+  // as in Defrag, the last particles move into the first free slots
+  Swarm::Defrag(swarm_ptrs);
+  REQUIRE(swarms[0]->GetMaxActiveIndex() == NUMINIT - 3);
+  REQUIRE(swarms[1]->GetMaxActiveIndex() == NUMINIT - 2);
+  auto a_h = swarms[0]->Get<Real>("x").GetHostMirrorAndCopy();
+  auto b_h = swarms[1]->Get<Real>("x").GetHostMirrorAndCopy();
+  REQUIRE(a_h(0) == 0.0);
+  REQUIRE(a_h(1) == NUMINIT - 1);
+  REQUIRE(a_h(3) == NUMINIT - 2);
+  REQUIRE(b_h(0) == NUMINIT - 1);
+  REQUIRE(b_h(1) == 1.0);
+}
+
+TEST_CASE("Looping over particles by cell", "[Swarm]") {
+  std::stringstream is;
+  is << "<parthenon/mesh>" << endl;
+  is << "x1min = -0.5" << endl;
+  is << "x2min = -0.5" << endl;
+  is << "x3min = -0.5" << endl;
+  is << "x1max = 0.5" << endl;
+  is << "x2max = 0.5" << endl;
+  is << "x3max = 0.5" << endl;
+  is << "nx1 = 4" << endl;
+  is << "nx2 = 4" << endl;
+  is << "nx3 = 4" << endl;
+  auto pin = std::make_shared<ParameterInput>();
+  pin->LoadFromStream(is);
+  auto app_in = std::make_shared<ApplicationInput>();
+  Packages_t packages;
+  constexpr int N = 4;
+  auto meshblock = std::make_shared<MeshBlock>(N, 3);
+  auto mesh = std::make_shared<Mesh>(pin.get(), app_in.get(), packages, 1);
+  meshblock->pmy_mesh = mesh.get();
+  meshblock->coords = Coordinates_t(
+      RegionSize({-0.5, -0.5, -0.5}, {0.5, 0.5, 0.5}, {1.0, 1.0, 1.0}, {N, N, N}),
+      pin.get());
+  auto swarm = std::make_shared<Swarm>("test swarm", Metadata(), NUMINIT);
+  swarm->SetBlockPointer(meshblock);
+  swarm->Add("visits", Metadata({Metadata::Integer, Metadata::Particle}));
+
+  // Particle n sits in interior cell n % N^3, so the first cells hold two particles and
+  // the others one.  Particle 0 is removed again, but stays in its cell's list.
+  const int nparticles = N * N * N + N * N;
+  swarm->AddEmptyParticles(nparticles);
+  auto x = swarm->Get<Real>("x").Get();
+  auto y = swarm->Get<Real>("y").Get();
+  auto z = swarm->Get<Real>("z").Get();
+  auto visits = swarm->Get<int>("visits").Get();
+  const Real dx = 1.0 / N;
+  meshblock->par_for(
+      "Place particles", 0, nparticles - 1, KOKKOS_LAMBDA(const int n) {
+        const int c = n % (N * N * N);
+        const Real offset = (n < N * N * N) ? 0.25 : 0.75;
+        x(n) = -0.5 + (c % N + offset) * dx;
+        y(n) = -0.5 + ((c / N) % N + offset) * dx;
+        z(n) = -0.5 + (c / (N * N) + offset) * dx;
+        visits(n) = 0;
+      });
+  auto swarm_d = swarm->GetDeviceContext();
+  meshblock->par_for(
+      "Remove particle", 0, 0,
+      KOKKOS_LAMBDA(const int n) { swarm_d.MarkParticleForRemoval(0); });
+  swarm->RemoveMarkedParticles();
+  swarm->SortParticlesByCell();
+
+  // A value per cell that the loop gathers into the scratch array of each cell
+  const auto &cb = meshblock->cellbounds;
+  ParArray3D<Real> field("field", cb.ncellsk(IndexDomain::entire),
+                         cb.ncellsj(IndexDomain::entire),
+                         cb.ncellsi(IndexDomain::entire));
+  meshblock->par_for(
+      "Set field", 0, cb.ncellsk(IndexDomain::entire) - 1, 0,
+      cb.ncellsj(IndexDomain::entire) - 1, 0, cb.ncellsi(IndexDomain::entire) - 1,
+      KOKKOS_LAMBDA(const int k, const int j, const int i) {
+        field(k, j, i) = i + 10 * j + 100 * k;
+      });
+
+  ParArrayND<int> failures_d("Number of failures", 1);
+  swarm_d = swarm->GetDeviceContext();
+  par_for_particles_by_cell(
+      "Visit particles", swarm.get(), IndexDomain::interior, 2,
+      KOKKOS_LAMBDA(const int v, const int k, const int j, const int i) {
+        return (v + 1) * field(k, j, i);
+      },
+      KOKKOS_LAMBDA(const int k, const int j, const int i, const int n,
+                    const ScratchPad1D<Real> &cell) {
+        Kokkos::atomic_add(&visits(n), 1);
+        int ip, jp, kp;
+        swarm_d.Xtoijk(x(n), y(n), z(n), ip, jp, kp);
+        if (ip != i || jp != j || kp != k || cell(0) != field(k, j, i) ||
+            cell(1) != 2 * field(k, j, i)) {
+          Kokkos::atomic_add(&failures_d(0), 1);
+        }
+      });
+
+  // Every active particle is visited once, in its cell and with its cell's data
+  auto failures_h = failures_d.GetHostMirrorAndCopy();
+  REQUIRE(failures_h(0) == 0);
+  auto visits_h = swarm->Get<int>("visits").GetHostMirrorAndCopy();
+  REQUIRE(visits_h(0) == 0);
+  int num_visited_once = 0;
+  for (int n = 1; n < nparticles; n++) {
+    num_visited_once += (visits_h(n) == 1);
+  }
+  REQUIRE(num_visited_once == nparticles - 1);
 }
@@ -12,7 +12,14 @@
 //========================================================================================
 
 // STL Includes
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 // Third Party Includes
 #include <catch2/catch.hpp>
@@ -48,3 +55,510 @@ TEST_CASE("Task Object Lifecycle", "[TaskList][AddTask]") {
     REQUIRE(track_destruction.expired());
   }
 }
+
+TEST_CASE("Task execution respects dependencies", "[TaskList][Execute]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskQualifier;
+  GIVEN("A TaskRegion with dependent tasks, an iterative sublist, and a local sync") {
+    const int nlists = 3;
+    TaskCollection tc;
+    auto &tr = tc.AddRegion(nlists);
+    std::vector<std::vector<int>> order(nlists);
+    std::vector<int> iters(nlists, 0);
+    std::vector<int> tries(nlists, 0);
+    TaskID none;
+    for (int i = 0; i < nlists; i++) {
+      auto &o = order[i];
+      // returns incomplete a few times before completing
+      auto a = tr[i].AddTask(none, [&o, &t = tries[i]]() {
+        if (t++ < 2) return TaskStatus::incomplete;
+        o.push_back(0);
+        return TaskStatus::complete;
+      });
+      auto b = tr[i].AddTask(none, [&o]() {
+        o.push_back(1);
+        return TaskStatus::complete;
+      });
+      auto [sub, sub_id] = tr[i].AddSublist(a | b, {1, 10});
+      auto s1 = sub.AddTask(none, [&o]() {
+        o.push_back(2);
+        return TaskStatus::complete;
+      });
+      sub.AddTask(TaskQualifier::completion, s1, [&it = iters[i]]() {
+        return (++it < 4 ? TaskStatus::iterate : TaskStatus::complete);
+      });
+      auto sync = tr[i].AddTask(TaskQualifier::local_sync, sub_id, [&o]() {
+        o.push_back(3);
+        return TaskStatus::complete;
+      });
+      tr[i].AddTask(sync, [&o, &order]() {
+        // every list must have reached the local_sync task
+        for (auto &other : order) {
+          REQUIRE(other.back() >= 3);
+        }
+        o.push_back(4);
+        return TaskStatus::complete;
+      });
+    }
+    tc.Execute();
+    THEN("Every task ran in dependency order the expected number of times") {
+      for (int i = 0; i < nlists; i++) {
+        REQUIRE(tries[i] == 3);
+        REQUIRE(iters[i] == 4);
+        auto &o = order[i];
+        REQUIRE(o.size() == 8);
+        REQUIRE(std::count(o.begin(), o.end(), 2) == 4);
+        REQUIRE(std::find(o.begin(), o.end(), 2) - o.begin() == 2);
+        REQUIRE(o[6] == 3);
+        REQUIRE(o[7] == 4);
+      }
+    }
+  }
+}
+
+TEST_CASE("Task storage", "[TaskList][TaskFunction][ChunkedArena]") {
+  using parthenon::ChunkedArena;
+  using parthenon::TaskFunction;
+  GIVEN("A small and a large callable") {
+    auto obj = std::make_shared<int>(1);
+    TaskFunction small([obj]() { return TaskStatus::complete; });
+    std::array<double, 64> big_capture{};
+    TaskFunction large([big_capture]() {
+      return big_capture[0] == 0.0 ? TaskStatus::iterate : TaskStatus::complete;
+    });
+    THEN("Only the large one is stored on the heap and both can be called") {
+      REQUIRE(!small.OnHeap());
+      REQUIRE(large.OnHeap());
+      REQUIRE(small() == TaskStatus::complete);
+      REQUIRE(large() == TaskStatus::iterate);
+      REQUIRE(obj.use_count() == 2);
+    }
+    WHEN("They are moved") {
+      TaskFunction small_moved(std::move(small));
+      TaskFunction large_moved;
+      large_moved = std::move(large);
+      THEN("The callables and their captures go with them") {
+        REQUIRE(!small);
+        REQUIRE(!large);
+        REQUIRE(!small_moved.OnHeap());
+        REQUIRE(large_moved.OnHeap());
+        REQUIRE(small_moved() == TaskStatus::complete);
+        REQUIRE(large_moved() == TaskStatus::iterate);
+        REQUIRE(obj.use_count() == 2);
+      }
+      AND_WHEN("The moved to one is replaced") {
+        small_moved = TaskFunction([]() { return TaskStatus::incomplete; });
+        THEN("The previous callable is destroyed") {
+          REQUIRE(obj.use_count() == 1);
+          REQUIRE(small_moved() == TaskStatus::incomplete);
+        }
+      }
+    }
+  }
+  GIVEN("A ChunkedArena with more objects than fit in one chunk") {
+    ChunkedArena<int, 4> arena;
+    std::vector<int *> ptrs;
+    for (int i = 0; i < 10; i++) {
+      ptrs.push_back(arena.emplace_back(i));
+    }
+    THEN("Objects keep their address and value") {
+      REQUIRE(arena.size() == 10);
+      REQUIRE(arena.capacity() == 12);
+      for (int i = 0; i < 10; i++) {
+        REQUIRE(arena[i] == ptrs[i]);
+        REQUIRE(*arena[i] == i);
+      }
+    }
+    WHEN("It is cleared") {
+      arena.clear();
+      THEN("The memory is kept for reuse") {
+        REQUIRE(arena.size() == 0);
+        REQUIRE(arena.capacity() == 12);
+        REQUIRE(arena.emplace_back(42) == ptrs[0]);
+      }
+    }
+  }
+}
+
+TEST_CASE("TaskCollections can be executed repeatedly", "[TaskCollection][Execute]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskQualifier;
+  GIVEN("A TaskCollection with an iterative sublist and a by-reference argument") {
+    TaskCollection tc;
+    auto &tr = tc.AddRegion(2);
+    double scale = 1.0;
+    std::vector<double> sums(2, 0.0);
+    std::vector<int> iters(2, 0);
+    TaskID none;
+    for (int i = 0; i < 2; i++) {
+      auto first = tr[i].AddTask(
+          none, [](double &sum, const double s) {
+            sum += s;
+            return TaskStatus::complete;
+          },
+          std::ref(sums[i]), std::cref(scale));
+      auto [sub, sub_id] = tr[i].AddSublist(first, {1, 3});
+      sub.AddTask(TaskQualifier::completion, none, [&it = iters[i]]() {
+        it++;
+        return TaskStatus::iterate;
+      });
+      tr[i].AddTask(sub_id, [&sum = sums[i], &scale]() {
+        sum += 10.0 * scale;
+        return TaskStatus::complete;
+      });
+    }
+    WHEN("It is replayed with a different argument value") {
+      for (int n = 0; n < 3; n++) {
+        scale = n + 1;
+        tc.Execute();
+      }
+      THEN("Each execution runs the whole graph with the current value") {
+        for (int i = 0; i < 2; i++) {
+          REQUIRE(iters[i] == 9);
+          REQUIRE(sums[i] == Approx(11.0 * (1.0 + 2.0 + 3.0)));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Sublists only complete every check interval", "[TaskList][Execute]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskQualifier;
+  GIVEN("A sublist with a check interval of 3 that converges after two iterations") {
+    TaskCollection tc;
+    auto &tl = tc.AddRegion(1)[0];
+    int iters = 0;
+    auto [sub, sub_id] = tl.AddSublist(TaskID(), {1, 10}, 3);
+    sub.AddTask(TaskQualifier::completion, TaskID(), [&iters]() {
+      return (++iters < 2 ? TaskStatus::iterate : TaskStatus::complete);
+    });
+    tc.Execute();
+    THEN("It completes at the first check after convergence") { REQUIRE(iters == 3); }
+    WHEN("It is executed again") {
+      iters = 0;
+      tc.Execute();
+      THEN("The iterations are counted from the start") { REQUIRE(iters == 3); }
+    }
+  }
+  GIVEN("A sublist with a check interval of 3 that never converges") {
+    TaskCollection tc;
+    auto &tl = tc.AddRegion(1)[0];
+    int iters = 0;
+    auto [sub, sub_id] = tl.AddSublist(TaskID(), {1, 5}, 3);
+    sub.AddTask(TaskQualifier::completion, TaskID(), [&iters]() {
+      iters++;
+      return TaskStatus::iterate;
+    });
+    tc.Execute();
+    THEN("It stops at the maximum number of iterations") { REQUIRE(iters == 5); }
+  }
+}
+
+TEST_CASE("TaskCollections can be executed together", "[TaskCollection][Execute]") {
+  using parthenon::TaskCollection;
+  GIVEN("Two collections where a task of the first one waits for the second one") {
+    TaskCollection first, second;
+    TaskID none;
+    bool second_ran = false;
+    bool waited = false;
+    int polls = 0;
+    first.AddRegion(1)[0].AddTask(none, [&]() {
+      if (second_ran) {
+        waited = true;
+        return TaskStatus::complete;
+      }
+      // give up rather than hang if the collections are executed one after another
+      return (++polls < 1000 ? TaskStatus::incomplete : TaskStatus::complete);
+    });
+    int later = 0;
+    first.AddRegion(2)[1].AddTask(none, [&later]() {
+      later++;
+      return TaskStatus::complete;
+    });
+    second.AddRegion(1)[0].AddTask(none, [&second_ran]() {
+      second_ran = true;
+      return TaskStatus::complete;
+    });
+    TaskCollection::Execute({&first, &second});
+    THEN("The regions of both are executed at the same time") {
+      REQUIRE(waited);
+      REQUIRE(later == 1);
+    }
+  }
+}
+
+TEST_CASE("Task timelines", "[TaskCollection][TaskTimeline]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskTimeline;
+  GIVEN("A TaskCollection with a chain of tasks joined by an independent task") {
+    TaskCollection tc;
+    auto &tl = tc.AddRegion(1)[0];
+    TaskID none;
+    auto work = []() { return TaskStatus::complete; };
+    auto a = tl.AddTask(none, work);
+    auto b = tl.AddTask(a, work);
+    auto d = tl.AddTask(none, work);
+    auto c = tl.AddTask(b | d, work);
+    tl.SetLabel(c, "join");
+    tl.SetLabel(d, "a \"quoted\" \\ label\n");
+    WHEN("It is executed while recording a timeline") {
+      TaskTimeline::Clear();
+      TaskTimeline::SetRecording(true);
+      tc.Execute();
+      TaskTimeline::SetRecording(false);
+      THEN("Every task is recorded once and the critical path ends at the join") {
+        REQUIRE(TaskTimeline::NumRegions() == 1);
+        const auto &region = TaskTimeline::RegionAt(0);
+        const auto &events = region.events();
+        // four tasks plus the first task of the list
+        REQUIRE(events.size() == 5);
+        for (const auto &ev : events) {
+          REQUIRE(ev.status == TaskStatus::complete);
+          REQUIRE(ev.ready <= ev.start);
+          REQUIRE(ev.start <= ev.end);
+        }
+        const auto path = region.CriticalPath();
+        // either through a and b, or through d, depending on which finished last
+        REQUIRE((path.size() == 3 || path.size() == 4));
+        REQUIRE(events[path.front()].label == "list0/first_task");
+        REQUIRE(events[path.back()].label == "join");
+        for (int i = 1; i < path.size(); i++) {
+          REQUIRE(events[path[i]].trigger == path[i - 1]);
+          REQUIRE(events[path[i - 1]].end <= events[path[i]].ready);
+        }
+      }
+      THEN("Labels are escaped in the written timeline") {
+        const std::string filename = "test_task_timeline.json";
+        TaskTimeline::Write(filename);
+        std::ifstream in(filename);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        in.close();
+        std::remove(filename.c_str());
+        REQUIRE(contents.str().find("\"a \\\"quoted\\\" \\\\ label\\n\"") !=
+                std::string::npos);
+        REQUIRE(contents.str().find("label\n") == std::string::npos);
+      }
+      TaskTimeline::Clear();
+    }
+  }
+}
+
+TEST_CASE("Incomplete tasks back off", "[TaskRegion][Execute]") {
+  using parthenon::TaskBackoffPolicy;
+  using parthenon::TaskCollection;
+  using parthenon::TaskRegion;
+  GIVEN("Two lists with a task that polls a number of times before completing") {
+    TaskCollection tc;
+    auto &tr = tc.AddRegion(2);
+    TaskID none;
+    std::vector<int> polls(2, 0);
+    std::vector<bool> done(2, false);
+    for (int i = 0; i < 2; i++) {
+      auto recv = tr[i].AddTask(none, [&n = polls[i]]() {
+        return (++n < 10 ? TaskStatus::incomplete : TaskStatus::complete);
+      });
+      tr[i].AddTask(recv, [&done, i]() {
+        done[i] = true;
+        return TaskStatus::complete;
+      });
+    }
+    WHEN("It is executed with backoff after the first incomplete return") {
+      const auto old_policy = TaskRegion::GetBackoffPolicy();
+      TaskBackoffPolicy policy;
+      policy.threshold = 1;
+      policy.initial_delay = 1.0e-5;
+      policy.max_delay = 1.0e-4;
+      policy.max_polls_per_sweep = 1;
+      TaskRegion::SetBackoffPolicy(policy);
+      TaskRegion::ResetIncompletePolls();
+      tc.Execute();
+      TaskRegion::SetBackoffPolicy(old_policy);
+      THEN("The polling tasks eventually complete and the wasted polls are counted") {
+        for (int i = 0; i < 2; i++) {
+          REQUIRE(polls[i] == 10);
+          REQUIRE(done[i]);
+        }
+        REQUIRE(TaskRegion::NumIncompletePolls() == 18);
+      }
+    }
+    THEN("The delay grows exponentially up to the maximum") {
+      TaskBackoffPolicy policy;
+      policy.threshold = 2;
+      policy.initial_delay = 1.0;
+      policy.max_delay = 5.0;
+      REQUIRE(policy.Delay(3) == 1.0);
+      REQUIRE(policy.Delay(4) == 2.0);
+      REQUIRE(policy.Delay(5) == 4.0);
+      REQUIRE(policy.Delay(6) == 5.0);
+      REQUIRE(policy.Delay(100) == 5.0);
+    }
+  }
+}
+
+TEST_CASE("Priority tasks run first", "[TaskList][TaskQualifier]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskQualifier;
+  GIVEN("A list where local work and a priority send become ready at the same time") {
+    TaskCollection tc;
+    auto &tl = tc.AddRegion(1)[0];
+    TaskID none;
+    std::vector<int> order;
+    auto start = tl.AddTask(none, []() { return TaskStatus::complete; });
+    tl.AddTask(TaskQualifier::priority, start, [&order]() {
+      order.push_back(-1);
+      return TaskStatus::complete;
+    });
+    for (int i = 0; i < 3; i++) {
+      tl.AddTask(start, [&order, i]() {
+        order.push_back(i);
+        return TaskStatus::complete;
+      });
+    }
+    WHEN("It is executed") {
+      tc.Execute();
+      THEN("The priority task runs before the others") {
+        REQUIRE(order.size() == 4);
+        REQUIRE(order.front() == -1);
+      }
+    }
+  }
+}
+
+TEST_CASE("Polling tasks don't starve other lists", "[TaskRegion][Execute]") {
+  using parthenon::TaskCollection;
+  GIVEN("A region where each list receives what the previous list sends") {
+    TaskCollection tc;
+    const int nlists = 3;
+    auto &tr = tc.AddRegion(nlists);
+    TaskID none;
+    std::vector<bool> sent(nlists, false);
+    std::vector<bool> received(nlists, false);
+    std::vector<int> polls(nlists, 0);
+    for (int i = 0; i < nlists; i++) {
+      auto send = tr[i].AddTask(none, [&sent, i]() {
+        sent[i] = true;
+        return TaskStatus::complete;
+      });
+      tr[i].AddTask(send, [&, i]() {
+        // give up rather than hang if the other lists never get to send
+        if (!sent[(i + nlists - 1) % nlists] && ++polls[i] < 1000)
+          return TaskStatus::incomplete;
+        received[i] = sent[(i + nlists - 1) % nlists];
+        return TaskStatus::complete;
+      });
+    }
+    WHEN("It is executed without backoff") {
+      tc.Execute();
+      THEN("Every list gets to send while the others are polling") {
+        for (int i = 0; i < nlists; i++) {
+          REQUIRE(received[i]);
+          REQUIRE(polls[i] < 1000);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Incomplete priority tasks don't starve other tasks",
+          "[TaskList][TaskQualifier]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskQualifier;
+  GIVEN("A priority task that waits for a task without priority") {
+    TaskCollection tc;
+    auto &tl = tc.AddRegion(1)[0];
+    TaskID none;
+    bool received = false;
+    int polls = 0;
+    tl.AddTask(TaskQualifier::priority, none, [&]() {
+      // give up rather than hang if the other task never runs
+      if (!received && ++polls < 1000) return TaskStatus::incomplete;
+      return TaskStatus::complete;
+    });
+    tl.AddTask(none, [&received]() {
+      received = true;
+      return TaskStatus::complete;
+    });
+    WHEN("It is executed") {
+      tc.Execute();
+      THEN("The other task gets to run while the priority task is polling") {
+        REQUIRE(received);
+        REQUIRE(polls < 1000);
+      }
+    }
+  }
+}
+
+TEST_CASE("Regional dependencies hold when replaying", "[TaskCollection][Execute]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskQualifier;
+  const auto sync = GENERATE(TaskQualifier::local_sync, TaskQualifier::global_sync);
+  GIVEN("A region with a synchronized task that the first list reaches early") {
+    TaskCollection tc;
+    const int nlists = 2;
+    auto &tr = tc.AddRegion(nlists);
+    TaskID none;
+    std::vector<int> runs(nlists, 0);
+    bool synchronized = true;
+    for (int i = 0; i < nlists; i++) {
+      // priority lets the task of the first list run before the other lists start
+      const auto tq = (i == 0 ? sync | TaskQualifier::priority : sync);
+      auto sync_task = tr[i].AddTask(tq, none, [&runs, i]() {
+        runs[i]++;
+        return TaskStatus::complete;
+      });
+      tr[i].AddTask(sync_task, [&]() {
+        synchronized = synchronized && (runs[0] == runs[1]);
+        return TaskStatus::complete;
+      });
+    }
+    WHEN("It is executed repeatedly") {
+      for (int n = 0; n < 3; n++) {
+        tc.Execute();
+      }
+      THEN("The tasks after it wait for all lists in every execution") {
+        REQUIRE(runs[0] == 3);
+        REQUIRE(runs[1] == 3);
+        REQUIRE(synchronized);
+      }
+    }
+  }
+}
+
+TEST_CASE("Cost meters measure the tasks of their list", "[TaskList][Execute]") {
+  using parthenon::TaskCollection;
+  using parthenon::TaskCostMeter;
+  struct Meter : public TaskCostMeter {
+    int finished = 0;
+    double seconds = 0.0;
+    void Finish() override { finished++; }
+    void Add(double s) override { seconds += s; }
+  };
+  GIVEN("Two lists of which one has a sublist, and a meter for the first list") {
+    TaskCollection tc;
+    auto &tr = tc.AddRegion(2);
+    TaskID none;
+    auto meter = std::make_shared<Meter>();
+    tr[0].SetCostMeter(meter);
+    auto sleep = []() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      return TaskStatus::complete;
+    };
+    auto first = tr[0].AddTask(none, sleep);
+    auto [sublist, sub_done] = tr[0].AddSublist(first, {1, 1});
+    sublist.AddTask(none, sleep);
+    tr[1].AddTask(none, sleep);
+    tr[1].AddTask(none, sleep);
+    WHEN("It is executed") {
+      tc.Execute();
+      THEN("Only the time of the tasks of the first list and its sublist is measured") {
+        // the two sleeping tasks and some of the internal ones
+        REQUIRE(meter->finished >= 2);
+        REQUIRE(meter->seconds >= 0.04);
+        // and not the 0.04 s of the tasks of the other list
+        REQUIRE(meter->seconds < 0.08);
+      }
+    }
+  }
+}
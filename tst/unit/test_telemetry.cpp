@@ -0,0 +1,71 @@
+//========================================================================================
+// (C) (or copyright) 2024. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "utils/telemetry.hpp"
+
+using parthenon::TelemetryWriter;
+
+TEST_CASE("TelemetryWriter", "[telemetry]") {
+  const TelemetryWriter::Record record{
+      {"cycle", {10}},
+      {"bytes", {1234567890123.0}},
+      {"blocks_per_level", {8, 16}},
+      {"ratio", {std::numeric_limits<double>::infinity()}}};
+
+  GIVEN("A record") {
+    THEN("It is written as a json object with arrays for lists of values") {
+      REQUIRE(TelemetryWriter::Format(record, false) ==
+              "{\"cycle\": 10, \"bytes\": 1234567890123, \"blocks_per_level\": [8, 16], "
+              "\"ratio\": null}");
+    }
+    THEN("It is written as a CSV row with lists of values joined by semicolons") {
+      REQUIRE(TelemetryWriter::Header(record) == "cycle,bytes,blocks_per_level,ratio");
+      REQUIRE(TelemetryWriter::Format(record, true) == "10,1234567890123,8;16,inf");
+    }
+  }
+
+  GIVEN("A CSV file written by two writers") {
+    const std::string filename = "test_telemetry.csv";
+    std::remove(filename.c_str());
+    {
+      TelemetryWriter writer(filename);
+      REQUIRE(writer.IsCSV());
+      writer.Write(record);
+      writer.Write(record);
+    }
+    {
+      TelemetryWriter writer(filename);
+      writer.Write(record);
+      writer.Wait();
+    }
+    THEN("The records are appended after a single header") {
+      std::ifstream in(filename);
+      std::string line;
+      int nlines = 0;
+      while (std::getline(in, line)) {
+        REQUIRE(line == (nlines == 0 ? TelemetryWriter::Header(record)
+                                     : TelemetryWriter::Format(record, true)));
+        nlines++;
+      }
+      REQUIRE(nlines == 4);
+    }
+    std::remove(filename.c_str());
+  }
+}
@@ -0,0 +1,117 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "tasks/thread_pool.hpp"
+
+using parthenon::ThreadPool;
+
+TEST_CASE("ThreadPool executes all work", "[ThreadPool]") {
+  GIVEN("A ThreadPool with several threads") {
+    ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+    REQUIRE(pool.this_thread_id() == -1);
+
+    WHEN("Many independent tasks are enqueued") {
+      std::atomic<int> count{0};
+      const int ntasks = 1000;
+      for (int i = 0; i < ntasks; i++) {
+        pool.enqueue([&count]() { count++; });
+      }
+      pool.wait();
+      THEN("Every task ran exactly once") { REQUIRE(count == ntasks); }
+    }
+
+    WHEN("Tasks enqueue more tasks") {
+      std::atomic<int> count{0};
+      const int nparents = 64;
+      const int nchildren = 16;
+      for (int i = 0; i < nparents; i++) {
+        pool.enqueue([&]() {
+          for (int j = 0; j < nchildren; j++) {
+            pool.enqueue([&count]() { count++; });
+          }
+        });
+      }
+      pool.wait();
+      THEN("wait covers the children as well") { REQUIRE(count == nparents * nchildren); }
+    }
+
+    WHEN("Tasks are enqueued with a thread preference") {
+      std::vector<int> ran_on(40, -1);
+      for (int i = 0; i < static_cast<int>(ran_on.size()); i++) {
+        pool.enqueue_on(i % pool.size(), [&, i]() { ran_on[i] = pool.this_thread_id(); });
+      }
+      pool.wait();
+      THEN("They run on some worker of the pool") {
+        for (auto t : ran_on) {
+          REQUIRE(t >= 0);
+          REQUIRE(t < pool.size());
+        }
+      }
+    }
+
+    WHEN("Results are returned through futures") {
+      auto f = pool.enqueue([](int a, int b) { return a + b; }, 2, 3);
+      THEN("The future holds the result") { REQUIRE(f.get() == 5); }
+    }
+  }
+}
+
+TEST_CASE("ThreadPool runs priority work first", "[ThreadPool]") {
+  GIVEN("A ThreadPool with a single, busy thread") {
+    ThreadPool pool(1);
+    std::promise<void> go;
+    pool.enqueue([f = go.get_future().share()]() { f.wait(); });
+    WHEN("Normal and priority work is enqueued while the thread is busy") {
+      std::vector<int> order;
+      for (int i = 0; i < 3; i++) {
+        pool.enqueue([&order, i]() { order.push_back(i); });
+      }
+      pool.enqueue_priority([&order]() { order.push_back(-1); });
+      go.set_value();
+      pool.wait();
+      THEN("The priority work runs before all of the normal work") {
+        REQUIRE(order.size() == 4);
+        REQUIRE(order.front() == -1);
+      }
+    }
+  }
+}
+
+TEST_CASE("ThreadPool does not starve waiting work", "[ThreadPool]") {
+  GIVEN("A ThreadPool with a single thread") {
+    ThreadPool pool(1);
+    WHEN("A task polls for a flag set by a task that was enqueued before it") {
+      std::atomic<bool> flag{false};
+      std::atomic<int> polls{0};
+      std::function<void()> poll = [&]() {
+        // give up rather than hang if the flag is never set
+        if (!flag && ++polls < 1000) pool.enqueue(poll);
+      };
+      pool.enqueue([&flag]() { flag = true; });
+      pool.enqueue(poll);
+      pool.wait();
+      THEN("The requeued poll runs after the waiting task") {
+        REQUIRE(flag);
+        REQUIRE(polls < 1000);
+      }
+    }
+  }
+}
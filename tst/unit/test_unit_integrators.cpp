@@ -15,6 +15,7 @@
 // the public, perform publicly and display publicly, and to permit others to do so.
 //========================================================================================
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -98,7 +99,47 @@ void Step2SStar(const LowStorageIntegrator &integrator, Real dt, State_t &u) {
   }
 }
 
-void StepButcher(const ButcherIntegrator &integrator, Real dt, State_t &u) {
+// See Update::Update2N
+void Step2N(const LowStorageIntegrator &integrator, Real dt, State_t &u) {
+  State_t du;
+  for (int stage = 0; stage < integrator.nstages; stage++) {
+    State_t rhs;
+    GetRHS(u, rhs);
+    const Real a = integrator.williamson_a[stage];
+    const Real b = integrator.williamson_b[stage];
+    for (int v = 0; v < NVARS; ++v) {
+      du[v] = (stage == 0 ? 0 : a * du[v]) + dt * rhs[v];
+      u[v] += b * du[v];
+    }
+  }
+}
+
+// StepButcher with the stages stored in ButcherIntegrator::stage_register and
+// accumulated into the new solution as they are computed
+void StepButcherRegisters(const ButcherIntegrator &integrator, Real dt, State_t &u) {
+  std::vector<State_t> registers(integrator.nregisters);
+  State_t unew = u;
+  for (int stage = 0; stage < integrator.nstages; ++stage) {
+    State_t scratch = u;
+    for (int prev = 0; prev < stage; ++prev) {
+      if (integrator.a[stage][prev] == 0.0) continue;
+      const State_t &S = registers[integrator.stage_register[prev]];
+      for (int v = 0; v < NVARS; ++v) {
+        scratch[v] += dt * integrator.a[stage][prev] * S[v];
+      }
+    }
+    State_t &S = registers[integrator.stage_register[stage]];
+    GetRHS(scratch, S);
+    for (int v = 0; v < NVARS; ++v) {
+      unew[v] += dt * integrator.b[stage] * S[v];
+    }
+  }
+  u = unew;
+}
+
+// Returns the error norm of the step if the integrator has an embedded method, as
+// computed by Update::EstimateButcherError
+Real StepButcher(const ButcherIntegrator &integrator, Real dt, State_t &u) {
   const int nstages = integrator.nstages;
   std::vector<State_t> K(nstages);
   for (int stage = 0; stage < nstages; ++stage) {
@@ -113,11 +154,48 @@ void StepButcher(const ButcherIntegrator &integrator, Real dt, State_t &u) {
     }
     GetRHS(scratch, K[stage]);
   }
+  State_t err = {0};
   for (int stage = 0; stage < nstages; ++stage) {
     for (int v = 0; v < NVARS; ++v) {
       u[v] += dt * integrator.b[stage] * K[stage][v];
+      if (integrator.HasEmbeddedMethod()) {
+        err[v] += dt * (integrator.b[stage] - integrator.bhat[stage]) * K[stage][v];
+      }
+    }
+  }
+  Real norm = 0;
+  for (int v = 0; v < NVARS; ++v) {
+    norm = std::max(norm, std::abs(err[v]) /
+                              (integrator.atol + integrator.rtol * std::abs(u[v])));
+  }
+  return norm;
+}
+
+// Integrate to exactly tf like MultiStageDriverGeneric does with error control, i.e.,
+// retry rejected steps with a smaller dt and take the dt proposed by the last accepted
+// step. Returns the number of accepted and rejected steps.
+std::array<int, 2> IntegrateAdaptive(const ButcherIntegrator &integrator, const Real tf,
+                                     Real dt, State_t &u) {
+  std::array<int, 2> nsteps = {0, 0};
+  Real t = 0;
+  while (t < tf) {
+    dt = std::min(dt, tf - t);
+    for (int attempt = 0;; ++attempt) {
+      State_t unew = u;
+      const Real err = StepButcher(integrator, dt, unew);
+      if (err <= 1.0) {
+        u = unew;
+        t += dt;
+        dt = integrator.ProposeDt(err, dt);
+        ++nsteps[0];
+        break;
+      }
+      REQUIRE(attempt < integrator.max_rejections);
+      dt = integrator.ProposeDt(err, dt);
+      ++nsteps[1];
     }
   }
+  return nsteps;
 }
 
 template <typename Integrator, typename Stepper>
@@ -201,6 +279,29 @@ TEST_CASE("Low storage integrator", "[StagedIntegrator]") {
         REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-2);
       }
     }
+    WHEN("We integrate with LowStorage rk3_2n") {
+      constexpr Real dt = 1e-3;
+      auto integrator = MakeIntegrator<LowStorageIntegrator>("rk3_2n");
+      State_t u;
+      GetInitialData(u);
+      Integrate(integrator, Step2N, tf, dt, u);
+      THEN("The final state doesn't differ too much from the true solution") {
+        REQUIRE(integrator.storage == LowStorageIntegrator::Storage::two_n);
+        REQUIRE(std::abs(u[0] - ufinal[0]) <= 1e-4);
+        REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-4);
+      }
+    }
+    WHEN("We integrate with LowStorage rk4_2n") {
+      constexpr Real dt = 1e-2;
+      auto integrator = MakeIntegrator<LowStorageIntegrator>("rk4_2n");
+      State_t u;
+      GetInitialData(u);
+      Integrate(integrator, Step2N, tf, dt, u);
+      THEN("The final state doesn't differ too much from the true solution") {
+        REQUIRE(std::abs(u[0] - ufinal[0]) <= 1e-4);
+        REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-4);
+      }
+    }
     WHEN("We integrate with butcher rk1") {
       constexpr Real dt = 1e-5;
       auto integrator = MakeIntegrator<ButcherIntegrator>("rk1");
@@ -235,6 +336,28 @@ TEST_CASE("Low storage integrator", "[StagedIntegrator]") {
         REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-4);
       }
     }
+    WHEN("We integrate with butcher bs3") {
+      constexpr Real dt = 1e-3;
+      auto integrator = MakeIntegrator<ButcherIntegrator>("bs3");
+      State_t u;
+      GetInitialData(u);
+      Integrate(integrator, StepButcher, tf, dt, u);
+      THEN("The final state doesn't differ too much from the true solution") {
+        REQUIRE(std::abs(u[0] - ufinal[0]) <= 1e-4);
+        REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-4);
+      }
+    }
+    WHEN("We integrate with butcher dp5") {
+      constexpr Real dt = 1e-2;
+      auto integrator = MakeIntegrator<ButcherIntegrator>("dp5");
+      State_t u;
+      GetInitialData(u);
+      Integrate(integrator, StepButcher, tf, dt, u);
+      THEN("The final state doesn't differ too much from the true solution") {
+        REQUIRE(std::abs(u[0] - ufinal[0]) <= 1e-6);
+        REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-6);
+      }
+    }
     WHEN("We integrate with butcher rk10") {
       constexpr Real dt = 5e-2; // appears to be largest stable timestep
       auto integrator = MakeIntegrator<ButcherIntegrator>("rk10");
@@ -248,3 +371,88 @@ TEST_CASE("Low storage integrator", "[StagedIntegrator]") {
     }
   }
 }
+
+TEST_CASE("Butcher integrators with embedded methods", "[StagedIntegrator]") {
+  for (const std::string name : {"bs3", "dp5"}) {
+    GIVEN("The " + name + " integrator") {
+      auto integrator = MakeIntegrator<ButcherIntegrator>(name);
+      THEN("Both sets of weights are consistent") {
+        REQUIRE(integrator.HasEmbeddedMethod());
+        REQUIRE(integrator.embedded_order == integrator.order - 1);
+        Real sum_b = 0, sum_bhat = 0;
+        for (int s = 0; s < integrator.nstages; ++s) {
+          sum_b += integrator.b[s];
+          sum_bhat += integrator.bhat[s];
+          Real sum_a = 0;
+          for (int j = 0; j < s; ++j) {
+            sum_a += integrator.a[s][j];
+          }
+          REQUIRE(sum_a == Approx(integrator.c[s]).margin(1e-14));
+        }
+        REQUIRE(sum_b == Approx(1.0));
+        REQUIRE(sum_bhat == Approx(1.0));
+      }
+      WHEN("We integrate with error control from a much too large timestep") {
+        const Real tf = 1.15;
+        integrator.rtol = integrator.atol = 1e-8;
+        State_t u, ufinal;
+        GetInitialData(u);
+        GetTrueSolution(tf, ufinal);
+        const auto nsteps = IntegrateAdaptive(integrator, tf, 0.5, u);
+        THEN("Steps are rejected until the error is small enough") {
+          REQUIRE(nsteps[1] > 0);
+          REQUIRE(std::abs(u[0] - ufinal[0]) <= 1e-5);
+          REQUIRE(std::abs(u[1] - ufinal[1]) <= 1e-5);
+        }
+      }
+    }
+  }
+  GIVEN("An integrator without an embedded method") {
+    THEN("Error control can't be enabled") {
+      ParameterInput in;
+      in.SetString("parthenon/time", "integrator", "rk4");
+      in.SetBoolean("parthenon/time", "adaptive", true);
+      REQUIRE_THROWS(ButcherIntegrator(&in));
+    }
+  }
+}
+
+TEST_CASE("Butcher integrators with shared stage registers", "[StagedIntegrator]") {
+  GIVEN("The classic rk4 integrator") {
+    auto integrator = MakeIntegrator<ButcherIntegrator>("rk4");
+    THEN("Each stage only needs the previous one, so all stages share a register") {
+      REQUIRE(integrator.nregisters == 1);
+    }
+  }
+  for (const std::string name : {"rk1", "rk2", "rk4", "bs3", "dp5", "rk10"}) {
+    GIVEN("The " + name + " integrator") {
+      auto integrator = MakeIntegrator<ButcherIntegrator>(name);
+      THEN("A stage keeps its register as long as later stages need it") {
+        REQUIRE(integrator.nregisters <= integrator.nstages);
+        for (int i = 0; i < integrator.nstages; ++i) {
+          for (int j = 0; j < i; ++j) {
+            // the register of stage j may only be reused by stage i if no stage from
+            // i + 1 on reads stage j
+            if (integrator.stage_register[i] != integrator.stage_register[j]) continue;
+            for (int k = i + 1; k < integrator.nstages; ++k) {
+              REQUIRE(integrator.a[k][j] == 0.0);
+            }
+          }
+        }
+      }
+      WHEN("We take steps with the stages stored in registers") {
+        State_t u, u_registers;
+        GetInitialData(u);
+        GetInitialData(u_registers);
+        for (int n = 0; n < 10; ++n) {
+          StepButcher(integrator, 1e-2, u);
+          StepButcherRegisters(integrator, 1e-2, u_registers);
+        }
+        THEN("The solution is the same as with a container per stage") {
+          REQUIRE(u_registers[0] == Approx(u[0]).epsilon(1e-12));
+          REQUIRE(u_registers[1] == Approx(u[1]).epsilon(1e-12));
+        }
+      }
+    }
+  }
+}
@@ -107,6 +107,30 @@ TEST_CASE("Add, Get, and Update are called", "[Add,Get,Update]") {
   }
 }
 
+TEST_CASE("Handles to params are used", "[GetHandle]") {
+  GIVEN("A mutable param and a handle to it") {
+    Params params;
+    std::string key = "test_key";
+    params.Add(key, -2.0, true);
+    auto handle = params.GetHandle<double>(key);
+    REQUIRE(handle.IsValid());
+    REQUIRE(*handle == Approx(-2.0));
+    WHEN("the param is updated") {
+      params.Update<double>(key, 3.0);
+      THEN("the handle reflects the new value") { REQUIRE(handle.Get() == Approx(3.0)); }
+    }
+    WHEN("the param is modified through GetMutable") {
+      *params.GetMutable<double>(key) = 4.0;
+      THEN("the handle reflects the new value") { REQUIRE(*handle == Approx(4.0)); }
+    }
+    WHEN("a handle of the wrong type is requested") {
+      THEN("an error is thrown") {
+        REQUIRE_THROWS_AS(params.GetHandle<int>(key), std::runtime_error);
+      }
+    }
+  }
+}
+
 TEST_CASE("reset is called", "[reset]") {
   GIVEN("A key is added") {
     Params params;
@@ -17,6 +17,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -40,7 +41,7 @@ struct Key {
 };
 struct KeyComparator {
   KOKKOS_INLINE_FUNCTION
-  bool operator()(const Key &s1, const Key &s2) { return s1.key_ < s2.key_; }
+  bool operator()(const Key &s1, const Key &s2) const { return s1.key_ < s2.key_; }
 };
 
 TEST_CASE("Sorting", "[sort]") {
@@ -94,4 +95,39 @@ TEST_CASE("Sorting", "[sort]") {
     REQUIRE(data_h(4).value_ == 5);
   }
 #endif // !defined(KOKKOS_ENABLE_HIP)
+
+  GIVEN("An unordered list of key-value pairs with repeated, bounded keys") {
+    ParArray1D<Key> data("Data to sort", N);
+    const int num_keys = 7;
+
+    parthenon::par_for(
+        parthenon::loop_pattern_flatrange_tag, "initial data", parthenon::DevExecSpace(),
+        0, N - 1, KOKKOS_LAMBDA(const int n) { data(n) = Key((3 * n) % num_keys, n); });
+
+    WHEN("The middle of the list is sorted by key") {
+      const int min_idx = 10, max_idx = N - 11;
+      parthenon::counting_sort(
+          data, KOKKOS_LAMBDA(const Key &k) { return k.key_; }, num_keys, min_idx,
+          max_idx);
+
+      auto data_h = Kokkos::create_mirror_view(data);
+      Kokkos::deep_copy(data_h, data);
+
+      THEN("The range is sorted, holds the same pairs, and the rest is unchanged") {
+        std::vector<int> seen(N, 0);
+        for (int n = 0; n < N; n++) {
+          REQUIRE(data_h(n).key_ == (3 * data_h(n).value_) % num_keys);
+          seen[data_h(n).value_]++;
+          if (n < min_idx || n > max_idx) {
+            REQUIRE(data_h(n).value_ == n);
+          } else if (n > min_idx) {
+            REQUIRE(data_h(n - 1).key_ <= data_h(n).key_);
+          }
+        }
+        for (int n = 0; n < N; n++) {
+          REQUIRE(seen[n] == 1);
+        }
+      }
+    }
+  }
 }
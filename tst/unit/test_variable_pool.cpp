@@ -0,0 +1,102 @@
+//========================================================================================
+// (C) (or copyright) 2023. Triad National Security, LLC. All rights reserved.
+//
+// This program was produced under U.S. Government contract 89233218CNA000001 for Los
+// Alamos National Laboratory (LANL), which is operated by Triad National Security, LLC
+// for the U.S. Department of Energy/National Nuclear Security Administration. All rights
+// in the program are reserved by Triad National Security, LLC, and the U.S. Department
+// of Energy/National Nuclear Security Administration. The Government is granted for
+// itself and others acting on its behalf a nonexclusive, paid-up, irrevocable worldwide
+// license in this material to reproduce, prepare derivative works, distribute copies to
+// the public, perform publicly and display publicly, and to permit others to do so.
+//========================================================================================
+
+#include <memory>
+
+#include <catch2/catch.hpp>
+
+#include "basic_types.hpp"
+#include "interface/variable_pool.hpp"
+#include "kokkos_abstraction.hpp"
+
+using parthenon::Real;
+using pool_t = parthenon::VariableMemoryPool<Real>;
+
+TEST_CASE("VariableMemoryPool recycles chunks", "[VariableMemoryPool]") {
+  GIVEN("A pool and a chunk taken from it") {
+    auto pool = std::make_shared<pool_t>();
+    const int n = 64;
+    auto chunk = pool->Get(n);
+    REQUIRE(chunk->size() == n);
+    REQUIRE(pool->SizeInBytes() == 0);
+    const Real *ptr = chunk->data();
+
+    WHEN("The chunk is filled and released") {
+      Kokkos::deep_copy(*chunk, 1.0);
+      chunk.reset();
+      THEN("The pool holds its memory") {
+        REQUIRE(pool->SizeInBytes() == n * sizeof(Real));
+      }
+      THEN("A chunk of the same size reuses the memory and is zeroed") {
+        auto again = pool->Get(n);
+        REQUIRE(again->data() == ptr);
+        REQUIRE(pool->SizeInBytes() == 0);
+        auto view = *again;
+        Real sum = 0.0;
+        Kokkos::parallel_reduce(
+            "sum", n, KOKKOS_LAMBDA(const int i, Real &lsum) { lsum += view(i); }, sum);
+        REQUIRE(sum == 0.0);
+      }
+      THEN("A chunk taken without zeroing reuses the memory as is") {
+        auto again = pool->Get(n, false);
+        REQUIRE(again->data() == ptr);
+        REQUIRE(pool->SizeInBytes() == 0);
+#ifdef NDEBUG
+        auto again_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), *again);
+        REQUIRE(again_h(0) == 1.0);
+#endif
+      }
+      THEN("A chunk of a different size does not") {
+        auto other = pool->Get(n + 1);
+        REQUIRE(other->data() != ptr);
+        REQUIRE(pool->SizeInBytes() == n * sizeof(Real));
+      }
+      THEN("Clear frees the pooled memory") {
+        pool->Clear();
+        REQUIRE(pool->SizeInBytes() == 0);
+      }
+    }
+
+    WHEN("The chunk is filled, released, and taken again in a batch") {
+      Kokkos::deep_copy(*chunk, 1.0);
+      chunk.reset();
+      pool_t::handle_t again, other;
+      {
+        pool_t::Batch batch(pool);
+        again = pool->Get(n);
+        other = pool->Get(2 * n);
+      }
+      THEN("Both chunks are zeroed once the batch ends") {
+        REQUIRE(again->data() == ptr);
+        auto view = *again;
+        auto view2 = *other;
+        Real sum = 0.0;
+        Kokkos::parallel_reduce(
+            "sum", 2 * n,
+            KOKKOS_LAMBDA(const int i, Real &lsum) {
+              lsum += view2(i) + (i < n ? view(i) : 0.0);
+            },
+            sum);
+        REQUIRE(sum == 0.0);
+      }
+    }
+
+    WHEN("The pool is destroyed before the chunk") {
+      pool.reset();
+      THEN("The chunk stays valid and can be released") {
+        REQUIRE(chunk->data() == ptr);
+        chunk.reset();
+      }
+    }
+  }
+}